@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cell-parallel-batch.h"
+#include "simulator.h"
+#include "assert.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "cell-parallel-simulator-impl.h"
+#endif
+
+#include <mutex>
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::CellParallelBatch.
+ */
+
+namespace ns3 {
+
+thread_local CellParallelBatch::AtBarrierFunction CellParallelBatch::t_atBarrier = 0;
+thread_local uint32_t CellParallelBatch::t_position = 0;
+uint32_t CellParallelBatch::g_batchSize = 0;
+bool CellParallelBatch::g_threaded = false;
+
+/**
+ * \ingroup simulator
+ * \return the lock of the trace sinks
+ */
+static std::recursive_mutex &
+GetTraceSinkMutex (void)
+{
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+void
+CellParallelBatch::ScheduleAtBarrier (EventImpl *event)
+{
+  NS_ASSERT_MSG (IsRunning (), "not in a parallel batch");
+  t_atBarrier (event);
+}
+
+void
+CellParallelBatch::SetRunning (AtBarrierFunction atBarrier, uint32_t position)
+{
+  t_atBarrier = atBarrier;
+  t_position = position;
+}
+
+std::vector<CellParallelBatch::Counter *> &
+CellParallelBatch::GetCounters (void)
+{
+  static std::vector<Counter *> counters;
+  return counters;
+}
+
+void
+CellParallelBatch::StartBatch (uint32_t size)
+{
+  g_batchSize = size;
+  std::vector<Counter *> &counters = GetCounters ();
+  for (std::vector<Counter *>::iterator it = counters.begin (); it != counters.end (); ++it)
+    {
+      (*it)->m_taken.assign (size, 0);
+    }
+}
+
+void
+CellParallelBatch::EndBatch (void)
+{
+  std::vector<Counter *> &counters = GetCounters ();
+  for (std::vector<Counter *>::iterator it = counters.begin (); it != counters.end (); ++it)
+    {
+      Counter *counter = *it;
+      if (counter->m_taken.empty ())
+        {
+          continue;
+        }
+      uint32_t busiest = *std::max_element (counter->m_taken.begin (), counter->m_taken.end ());
+      counter->m_next += static_cast<uint64_t> (busiest) * g_batchSize;
+      counter->m_taken.clear ();
+    }
+  g_batchSize = 0;
+}
+
+CellParallelBatch::Counter::Counter (uint64_t first)
+  : m_next (first)
+{
+  NS_ASSERT_MSG (!IsRunning (), "counter created in a parallel batch");
+  GetCounters ().push_back (this);
+}
+
+CellParallelBatch::Counter::~Counter ()
+{
+  std::vector<Counter *> &counters = GetCounters ();
+  counters.erase (std::remove (counters.begin (), counters.end (), this), counters.end ());
+}
+
+void
+CellParallelBatch::Counter::Reset (uint64_t next)
+{
+  NS_ASSERT_MSG (!IsRunning (), "counter reset in a parallel batch");
+  m_next = next;
+}
+
+uint64_t
+CellParallelBatch::Counter::NextInBatch (void)
+{
+  NS_ASSERT (t_position < m_taken.size ());
+  uint64_t k = m_taken[t_position]++;
+  return m_next + t_position + k * g_batchSize;
+}
+
+void
+CellParallelBatch::SetThreaded (bool threaded)
+{
+  NS_ASSERT_MSG (!IsRunning (), "threading changed in a parallel batch");
+  g_threaded = threaded;
+}
+
+void
+CellParallelBatch::AddParallelContext (uint32_t context)
+{
+#ifdef HAVE_PTHREAD_H
+  Ptr<CellParallelSimulatorImpl> impl = DynamicCast<CellParallelSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      impl->AddParallelContext (context);
+    }
+#endif
+}
+
+void
+CellParallelBatch::TraceSinkGuard::Lock (void)
+{
+  GetTraceSinkMutex ().lock ();
+}
+
+void
+CellParallelBatch::TraceSinkGuard::Unlock (void)
+{
+  GetTraceSinkMutex ().unlock ();
+}
+
+} // namespace ns3
@@ -0,0 +1,293 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CELL_PARALLEL_BATCH_H
+#define CELL_PARALLEL_BATCH_H
+
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::CellParallelBatch.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * Access to the batches of parallel events of the CellParallelSimulatorImpl
+ * from the code shared by the cells, e.g. the channels and the trace sinks.
+ *
+ * This class is built with or without threading support: without the
+ * CellParallelSimulatorImpl, IsRunning() is always false.
+ */
+class CellParallelBatch
+{
+public:
+  /**
+   * Function buffering an event to run at the end of the batch.
+   *
+   * \param event the event
+   */
+  typedef void (* AtBarrierFunction)(EventImpl *event);
+
+  /**
+   * \return true if the calling thread runs an event of a parallel batch
+   */
+  static bool IsRunning (void)
+  {
+    return t_atBarrier != 0;
+  }
+
+  /**
+   * Run an event once all the events of the batch completed, on the main
+   * thread, as if it ran at the end of the calling event: the events it
+   * schedules are ordered as if the calling event scheduled them.
+   *
+   * The objects shared by the cells, such as the channels, use it so
+   * that they are only ever used by one thread, in the order of the
+   * batch. The event sees the state of the cells at the end of the batch.
+   * May only be called if IsRunning().
+   *
+   * \param event the event
+   */
+  static void ScheduleAtBarrier (EventImpl *event);
+
+  /**
+   * Mark the calling thread as running an event of the batch, or as not
+   * running batch events any more.
+   *
+   * \param atBarrier the function buffering the events of ScheduleAtBarrier,
+   *        0 at the end of the batch
+   * \param position the position of the event in the batch
+   */
+  static void SetRunning (AtBarrierFunction atBarrier, uint32_t position);
+
+  /**
+   * Start numbering the values of the counters for a batch.
+   *
+   * \param size the number of events of the batch
+   */
+  static void StartBatch (uint32_t size);
+
+  /**
+   * Resume the sequential numbering of the counters after the values
+   * taken by the batch. Called once all the events of the batch ran.
+   */
+  static void EndBatch (void);
+
+  /**
+   * Tell the reference counts and the trace sink guards whether batch
+   * events run on several threads at once. Called by the
+   * CellParallelSimulatorImpl, outside of a batch, before it wakes up its
+   * workers and after they completed the batch.
+   *
+   * \param threaded true while the events of a batch run on workers
+   */
+  static void SetThreaded (bool threaded);
+
+  /**
+   * Allow the events of a cell to run in parallel with the other cells,
+   * if the simulator is a CellParallelSimulatorImpl. Called by the
+   * helpers for each base station they install.
+   *
+   * \param context the context of the cell, i.e. the id of its node
+   */
+  static void AddParallelContext (uint32_t context);
+
+  /**
+   * Serializes the trace sinks called from a parallel batch, which are
+   * commonly shared by all the cells (statistics, output files). Does
+   * nothing outside of a batch.
+   */
+  class TraceSinkGuard
+  {
+  public:
+    /** Take the lock of the trace sinks if batch events run on several threads. */
+    TraceSinkGuard ()
+      : m_locked (g_threaded && IsRunning ())
+    {
+      if (m_locked)
+        {
+          Lock ();
+        }
+    }
+    /** Release the lock of the trace sinks. */
+    ~TraceSinkGuard ()
+    {
+      if (m_locked)
+        {
+          Unlock ();
+        }
+    }
+
+  private:
+    /** Take the (recursive) lock of the trace sinks. */
+    static void Lock (void);
+    /** Release the lock of the trace sinks. */
+    static void Unlock (void);
+
+    bool m_locked;  ///< the lock was taken
+  };
+
+  /**
+   * Counter numbering objects throughout the simulation, such as the
+   * packet uids and the random stream indices, so that the numbers do
+   * not depend on the threads running a batch.
+   *
+   * Outside of a batch the values follow each other. In a batch of N
+   * events, the k-th value taken by the event at position i in the batch
+   * is first + i + k * N, where first is the next value before the batch,
+   * and the numbering resumes after the values taken by the busiest
+   * event. The counters must outlive the batches, e.g. be static.
+   */
+  class Counter
+  {
+  public:
+    /**
+     * Constructor.
+     *
+     * \param first the first value
+     */
+    Counter (uint64_t first = 0);
+    /** Destructor. */
+    ~Counter ();
+    /**
+     * Set the next value. May not be called in a batch.
+     *
+     * \param next the next value
+     */
+    void Reset (uint64_t next);
+    /** \return the next value */
+    uint64_t Next (void)
+    {
+      if (t_atBarrier == 0)
+        {
+          return m_next++;
+        }
+      return NextInBatch ();
+    }
+
+  private:
+    friend class CellParallelBatch;
+    /** \return the next value of the event run by the calling thread */
+    uint64_t NextInBatch (void);
+
+    uint64_t m_next;               ///< next value outside of a batch
+    std::vector<uint32_t> m_taken; ///< values taken by each event of the batch
+  };
+
+  /**
+   * Reference count of the objects shared by the cells (Ptr, packet
+   * buffers, tags and metadata).
+   *
+   * The count is only updated with atomic read-modify-write operations
+   * while a batch runs on several threads (see SetThreaded); otherwise
+   * it is a plain load and store, as cheap as a uint32_t.
+   */
+  class RefCount
+  {
+  public:
+    /**
+     * Constructor.
+     *
+     * \param count the initial count
+     */
+    RefCount (uint32_t count = 0)
+      : m_count (count)
+    {
+    }
+    /** \return the count */
+    operator uint32_t (void) const
+    {
+      return m_count.load (std::memory_order_relaxed);
+    }
+    /**
+     * Set the count, e.g. of a new object.
+     *
+     * \param count the count
+     * \return this count
+     */
+    RefCount & operator = (uint32_t count)
+    {
+      m_count.store (count, std::memory_order_relaxed);
+      return *this;
+    }
+    /** \return the count after the increment */
+    uint32_t operator ++ (void)
+    {
+      if (g_threaded)
+        {
+          return m_count.fetch_add (1, std::memory_order_relaxed) + 1;
+        }
+      uint32_t count = m_count.load (std::memory_order_relaxed) + 1;
+      m_count.store (count, std::memory_order_relaxed);
+      return count;
+    }
+    /** \return the count after the decrement */
+    uint32_t operator -- (void)
+    {
+      if (g_threaded)
+        {
+          return m_count.fetch_sub (1, std::memory_order_acq_rel) - 1;
+        }
+      uint32_t count = m_count.load (std::memory_order_relaxed) - 1;
+      m_count.store (count, std::memory_order_relaxed);
+      return count;
+    }
+    /** \return the count before the increment */
+    uint32_t operator ++ (int)
+    {
+      return ++*this - 1;
+    }
+    /** \return the count before the decrement */
+    uint32_t operator -- (int)
+    {
+      return --*this + 1;
+    }
+
+  private:
+    RefCount (const RefCount &);
+    RefCount & operator = (const RefCount &);
+
+    std::atomic<uint32_t> m_count;  ///< the count
+  };
+
+private:
+  /**
+   * \return the counters, see Counter
+   */
+  static std::vector<Counter *> & GetCounters (void);
+
+  /** Function buffering the events at the barrier, 0 outside of a batch. */
+  static thread_local AtBarrierFunction t_atBarrier;
+  /** Position in the batch of the event run by the calling thread. */
+  static thread_local uint32_t t_position;
+  /** Number of events of the current batch. */
+  static uint32_t g_batchSize;
+  /** Batch events run on several threads, see SetThreaded. */
+  static bool g_threaded;
+};
+
+} // namespace ns3
+
+#endif /* CELL_PARALLEL_BATCH_H */
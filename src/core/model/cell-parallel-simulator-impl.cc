@@ -0,0 +1,868 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator.h"
+#include "cell-parallel-simulator-impl.h"
+#include "cell-parallel-batch.h"
+#include "scheduler.h"
+#include "event-impl.h"
+
+#include "ptr.h"
+#include "pointer.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+
+#include <algorithm>
+
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::CellParallelSimulatorImpl.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided, as in the default
+// simulator implementation, and because the batch events log from
+// several threads
+NS_LOG_COMPONENT_DEFINE ("CellParallelSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (CellParallelSimulatorImpl);
+
+thread_local CellParallelSimulatorImpl::BatchEvent *CellParallelSimulatorImpl::t_event = 0;
+thread_local const CellParallelSimulatorImpl::BatchGroup *CellParallelSimulatorImpl::t_group = 0;
+
+TypeId
+CellParallelSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CellParallelSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<CellParallelSimulatorImpl> ()
+    .AddAttribute ("Threads",
+                   "Maximum number of threads running a batch of parallel events. "
+                   "With 1 thread the batches run on the main thread, with the "
+                   "same results as with any other number of threads.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&CellParallelSimulatorImpl::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+CellParallelSimulatorImpl::CellParallelSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = false;
+  // uids are allocated from 4, see DefaultSimulatorImpl.
+  // uid 3 is "pending" events, scheduled by a batch event
+  m_uid = 4;
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = Simulator::NO_CONTEXT;
+  m_unscheduledEvents = 0;
+  m_eventCount = 0;
+  m_eventsWithContextEmpty = true;
+  m_main = SystemThread::Self();
+  m_threads = 1;
+  m_sequentialUid = 0;
+  m_nextGroup = 0;
+  m_poolBatch = 0;
+  m_poolBusy = 0;
+  m_poolStop = false;
+}
+
+CellParallelSimulatorImpl::~CellParallelSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+}
+
+void
+CellParallelSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  StopWorkers ();
+  ProcessEventsWithContext ();
+
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  m_queueUids.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+CellParallelSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+CellParallelSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
+
+uint32_t
+CellParallelSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+CellParallelSimulatorImpl::AddParallelContext (uint32_t context)
+{
+  NS_LOG_FUNCTION (this << context);
+  NS_ASSERT_MSG (context != Simulator::NO_CONTEXT, "NO_CONTEXT cannot run in parallel");
+  if (context >= m_parallelContexts.size ())
+    {
+      m_parallelContexts.resize (context + 1, false);
+    }
+  m_parallelContexts[context] = true;
+}
+
+bool
+CellParallelSimulatorImpl::IsParallelContext (uint32_t context) const
+{
+  return context < m_parallelContexts.size () && m_parallelContexts[context];
+}
+
+void
+CellParallelSimulatorImpl::ForgetQueueUid (EventImpl *event)
+{
+  if (!m_queueUids.empty ())
+    {
+      m_queueUids.erase (event);
+    }
+}
+
+void
+CellParallelSimulatorImpl::ProcessOneEvent (void)
+{
+  Scheduler::Event next = m_events->RemoveNext ();
+
+  NS_ASSERT (next.key.m_ts >= m_currentTs);
+  m_unscheduledEvents--;
+  ForgetQueueUid (next.impl);
+
+  if (IsParallelContext (next.key.m_context)
+      && (next.key.m_ts != m_currentTs || next.key.m_uid > m_sequentialUid))
+    {
+      ProcessBatch (next);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("handle " << next.key.m_ts);
+      m_currentTs = next.key.m_ts;
+      m_currentContext = next.key.m_context;
+      m_currentUid = next.key.m_uid;
+      m_eventCount++;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+
+  ProcessEventsWithContext ();
+}
+
+void
+CellParallelSimulatorImpl::ProcessBatch (const Scheduler::Event &first)
+{
+  m_batch.clear ();
+  m_groups.clear ();
+  BatchEvent batchEvent;
+  batchEvent.event = first;
+  m_batch.push_back (batchEvent);
+  while (!m_events->IsEmpty ())
+    {
+      const Scheduler::Event &next = m_events->PeekNext ();
+      if (next.key.m_ts != first.key.m_ts || !IsParallelContext (next.key.m_context))
+        {
+          break;
+        }
+      batchEvent.event = m_events->RemoveNext ();
+      m_unscheduledEvents--;
+      m_batch.push_back (batchEvent);
+    }
+
+  // the groups are ordered by their first event
+  std::map<uint32_t, uint32_t> groupOfContext;
+  for (uint32_t i = 0; i < m_batch.size (); ++i)
+    {
+      uint32_t context = m_batch[i].event.key.m_context;
+      std::map<uint32_t, uint32_t>::iterator it = groupOfContext.find (context);
+      if (it == groupOfContext.end ())
+        {
+          it = groupOfContext.insert (std::make_pair (context, m_groups.size ())).first;
+          BatchGroup group;
+          group.context = context;
+          m_groups.push_back (group);
+        }
+      m_groups[it->second].events.push_back (i);
+    }
+
+  if (m_groups.size () == 1)
+    {
+      // one context: put the events back and run them one by one, so that
+      // they can still remove each other from the queue
+      NS_LOG_LOGIC ("no parallel event at " << first.key.m_ts);
+      for (uint32_t i = 1; i < m_batch.size (); ++i)
+        {
+          m_events->Insert (m_batch[i].event);
+          m_unscheduledEvents++;
+        }
+      m_sequentialUid = m_batch.back ().event.key.m_uid;
+      m_batch.clear ();
+      m_groups.clear ();
+      m_currentTs = first.key.m_ts;
+      m_currentContext = first.key.m_context;
+      m_currentUid = first.key.m_uid;
+      m_eventCount++;
+      first.impl->Invoke ();
+      first.impl->Unref ();
+      return;
+    }
+
+  NS_LOG_LOGIC ("handle " << m_batch.size () << " events of " << m_groups.size ()
+                          << " contexts at " << first.key.m_ts);
+  m_currentTs = first.key.m_ts;
+  m_eventCount += m_batch.size ();
+  m_nextGroup = 0;
+  CellParallelBatch::StartBatch (m_batch.size ());
+  if (m_workers.empty ())
+    {
+      m_poolStop = false;
+      for (uint32_t i = 1; i < m_threads; ++i)
+        {
+          m_workers.push_back (Create<SystemThread> (MakeCallback (&CellParallelSimulatorImpl::RunWorker, this)));
+          m_workers.back ()->Start ();
+        }
+    }
+  // the workers see the change through m_poolMutex
+  CellParallelBatch::SetThreaded (!m_workers.empty ());
+  {
+    std::unique_lock<std::mutex> lock (m_poolMutex);
+    m_poolBusy = m_workers.size ();
+    m_poolBatch++;
+  }
+  m_poolStart.notify_all ();
+  RunGroups ();
+  {
+    std::unique_lock<std::mutex> lock (m_poolMutex);
+    while (m_poolBusy != 0)
+      {
+        m_poolDone.wait (lock);
+      }
+  }
+  CellParallelBatch::SetThreaded (false);
+  CellParallelBatch::EndBatch ();
+
+  MergeBatch ();
+  m_currentContext = m_batch.back ().event.key.m_context;
+  m_currentUid = m_batch.back ().event.key.m_uid;
+  m_batch.clear ();
+  m_groups.clear ();
+}
+
+void
+CellParallelSimulatorImpl::RunWorker (void)
+{
+  uint64_t batch = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_poolMutex);
+        while (m_poolBatch == batch && !m_poolStop)
+          {
+            m_poolStart.wait (lock);
+          }
+        if (m_poolStop)
+          {
+            return;
+          }
+        batch = m_poolBatch;
+      }
+      RunGroups ();
+      bool last;
+      {
+        std::unique_lock<std::mutex> lock (m_poolMutex);
+        last = (--m_poolBusy == 0);
+      }
+      if (last)
+        {
+          m_poolDone.notify_one ();
+        }
+    }
+}
+
+void
+CellParallelSimulatorImpl::StopWorkers (void)
+{
+  if (m_workers.empty ())
+    {
+      return;
+    }
+  {
+    std::unique_lock<std::mutex> lock (m_poolMutex);
+    m_poolStop = true;
+  }
+  m_poolStart.notify_all ();
+  for (std::vector<Ptr<SystemThread> >::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  m_workers.clear ();
+}
+
+void
+CellParallelSimulatorImpl::RunGroups (void)
+{
+  while (true)
+    {
+      uint32_t group;
+      {
+        CriticalSection cs (m_groupMutex);
+        if (m_nextGroup == m_groups.size ())
+          {
+            break;
+          }
+        group = m_nextGroup++;
+      }
+      t_group = &m_groups[group];
+      for (std::vector<uint32_t>::const_iterator it = t_group->events.begin (); it != t_group->events.end (); ++it)
+        {
+          t_event = &m_batch[*it];
+          CellParallelBatch::SetRunning (&CellParallelSimulatorImpl::AddBarrierEvent, *it);
+          t_event->event.impl->Invoke ();
+        }
+    }
+  t_event = 0;
+  t_group = 0;
+  CellParallelBatch::SetRunning (0, 0);
+}
+
+void
+CellParallelSimulatorImpl::AddBarrierEvent (EventImpl *event)
+{
+  PendingOp op;
+  op.kind = PendingOp::BARRIER;
+  op.event.impl = event;
+  t_event->ops.push_back (op);
+}
+
+void
+CellParallelSimulatorImpl::MergeBatch (void)
+{
+  uint64_t batchTs = m_batch.front ().event.key.m_ts;
+  uint32_t batchUid = m_batch.back ().event.key.m_uid;
+  // all the events of the batch ran: none of them is pending any more for
+  // the barrier events
+  m_currentUid = batchUid;
+  for (std::vector<BatchEvent>::iterator b = m_batch.begin (); b != m_batch.end (); ++b)
+    {
+      m_currentContext = b->event.key.m_context;
+      for (std::vector<PendingOp>::iterator op = b->ops.begin (); op != b->ops.end (); ++op)
+        {
+          switch (op->kind)
+            {
+            case PendingOp::INSERT:
+              // the uid is taken even if the event was removed, as the
+              // default implementation does
+              op->event.key.m_uid = m_uid;
+              m_uid++;
+              if (op->removed)
+                {
+                  op->event.impl->Unref ();
+                }
+              else
+                {
+                  m_unscheduledEvents++;
+                  m_events->Insert (op->event);
+                  if (op->hasId)
+                    {
+                      m_queueUids[op->event.impl] = op->event.key.m_uid;
+                    }
+                }
+              break;
+            case PendingOp::DESTROY:
+              m_destroyEvents.push_back (op->id);
+              m_uid++;
+              break;
+            case PendingOp::REMOVE:
+              if (op->id.GetUid () == 2)
+                {
+                  m_destroyEvents.remove (op->id);
+                }
+              else
+                {
+                  uint32_t uid = GetQueueUid (op->id);
+                  // the events of the batch already left the queue
+                  if (uid != PENDING_UID
+                      && !(op->id.GetTs () == batchTs && uid <= batchUid))
+                    {
+                      DoRemove (op->id, uid);
+                    }
+                }
+              break;
+            case PendingOp::STOP:
+              m_stop = true;
+              break;
+            case PendingOp::BARRIER:
+              // runs on this thread as if at the end of the batch event:
+              // what it schedules is queued right away, after the events
+              // the batch event scheduled before deferring it
+              op->event.impl->Invoke ();
+              op->event.impl->Unref ();
+              break;
+            }
+        }
+    }
+  for (std::vector<BatchEvent>::iterator b = m_batch.begin (); b != m_batch.end (); ++b)
+    {
+      ForgetQueueUid (b->event.impl);
+      b->event.impl->Unref ();
+    }
+}
+
+bool
+CellParallelSimulatorImpl::IsFinished (void) const
+{
+  return m_events->IsEmpty () || m_stop;
+}
+
+void
+CellParallelSimulatorImpl::ProcessEventsWithContext (void)
+{
+  if (m_eventsWithContextEmpty)
+    {
+      return;
+    }
+
+  // swap queues
+  EventsWithContext eventsWithContext;
+  {
+    CriticalSection cs (m_eventsWithContextMutex);
+    m_eventsWithContext.swap(eventsWithContext);
+    m_eventsWithContextEmpty = true;
+  }
+  while (!eventsWithContext.empty ())
+    {
+       EventWithContext event = eventsWithContext.front ();
+       eventsWithContext.pop_front ();
+       Scheduler::Event ev;
+       ev.impl = event.event;
+       ev.key.m_ts = m_currentTs + event.timestamp;
+       ev.key.m_context = event.context;
+       ev.key.m_uid = m_uid;
+       m_uid++;
+       m_unscheduledEvents++;
+       m_events->Insert (ev);
+    }
+}
+
+void
+CellParallelSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self();
+  ProcessEventsWithContext ();
+  m_stop = false;
+
+  while (!m_events->IsEmpty () && !m_stop)
+    {
+      ProcessOneEvent ();
+    }
+
+  // If the simulator stopped naturally by lack of events, make a
+  // consistency test to check that we didn't lose any events along the way.
+  NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
+}
+
+void
+CellParallelSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (t_event != 0)
+    {
+      PendingOp op;
+      op.kind = PendingOp::STOP;
+      t_event->ops.push_back (op);
+      return;
+    }
+  m_stop = true;
+}
+
+void
+CellParallelSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Simulator::Schedule (delay, &Simulator::Stop);
+}
+
+EventId
+CellParallelSimulatorImpl::AddPendingEvent (const Scheduler::Event &event, bool hasId)
+{
+  PendingOp op;
+  op.kind = PendingOp::INSERT;
+  op.event = event;
+  op.hasId = hasId;
+  op.removed = false;
+  t_event->ops.push_back (op);
+  return EventId (event.impl, event.key.m_ts, event.key.m_context, PENDING_UID);
+}
+
+const CellParallelSimulatorImpl::PendingOp *
+CellParallelSimulatorImpl::FindPendingOp (const EventId &id) const
+{
+  if (t_event == 0)
+    {
+      return 0;
+    }
+  // only the events of the calling context are visible
+  for (std::vector<uint32_t>::const_iterator it = t_group->events.begin (); it != t_group->events.end (); ++it)
+    {
+      const BatchEvent &batchEvent = m_batch[*it];
+      for (std::vector<PendingOp>::const_iterator op = batchEvent.ops.begin (); op != batchEvent.ops.end (); ++op)
+        {
+          if (op->kind == PendingOp::INSERT && op->event.impl == id.PeekEventImpl ())
+            {
+              return &(*op);
+            }
+        }
+      if (&batchEvent == t_event)
+        {
+          break;
+        }
+    }
+  return 0;
+}
+
+uint32_t
+CellParallelSimulatorImpl::GetQueueUid (const EventId &id) const
+{
+  if (id.GetUid () != PENDING_UID)
+    {
+      return id.GetUid ();
+    }
+  std::map<EventImpl *, uint32_t>::const_iterator it = m_queueUids.find (id.PeekEventImpl ());
+  if (it == m_queueUids.end ())
+    {
+      return PENDING_UID;
+    }
+  return it->second;
+}
+
+EventId
+CellParallelSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+
+  Time tAbsolute = delay + TimeStep (m_currentTs);
+
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (m_currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = GetContext ();
+  if (t_event != 0)
+    {
+      return AddPendingEvent (ev, true);
+    }
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+CellParallelSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  if (t_event != 0)
+    {
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) (delay + TimeStep (m_currentTs)).GetTimeStep ();
+      ev.key.m_context = context;
+      AddPendingEvent (ev, false);
+    }
+  else if (SystemThread::Equals (m_main))
+    {
+      Time tAbsolute = delay + TimeStep (m_currentTs);
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+  else
+    {
+      EventWithContext ev;
+      ev.context = context;
+      // Current time added in ProcessEventsWithContext()
+      ev.timestamp = delay.GetTimeStep ();
+      ev.event = event;
+      {
+        CriticalSection cs (m_eventsWithContextMutex);
+        m_eventsWithContext.push_back(ev);
+        m_eventsWithContextEmpty = false;
+      }
+    }
+}
+
+EventId
+CellParallelSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = m_currentTs;
+  ev.key.m_context = GetContext ();
+  if (t_event != 0)
+    {
+      return AddPendingEvent (ev, true);
+    }
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleNow Thread-unsafe invocation!");
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+EventId
+CellParallelSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), m_currentTs, 0xffffffff, 2);
+  if (t_event != 0)
+    {
+      PendingOp op;
+      op.kind = PendingOp::DESTROY;
+      op.id = id;
+      t_event->ops.push_back (op);
+      return id;
+    }
+  NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::ScheduleDestroy Thread-unsafe invocation!");
+  m_destroyEvents.push_back (id);
+  m_uid++;
+  return id;
+}
+
+Time
+CellParallelSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  return TimeStep (m_currentTs);
+}
+
+Time
+CellParallelSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs () - m_currentTs);
+    }
+}
+
+void
+CellParallelSimulatorImpl::Remove (const EventId &id)
+{
+  if (t_event != 0)
+    {
+      if (IsExpired (id))
+        {
+          return;
+        }
+      const PendingOp *pending = FindPendingOp (id);
+      if (pending != 0)
+        {
+          const_cast<PendingOp *> (pending)->removed = true;
+        }
+      else
+        {
+          // the event does not run any more, it leaves the queue at the merge
+          PendingOp op;
+          op.kind = PendingOp::REMOVE;
+          op.id = id;
+          t_event->ops.push_back (op);
+        }
+      if (id.GetUid () != 2)
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
+      return;
+    }
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  DoRemove (id, GetQueueUid (id));
+}
+
+void
+CellParallelSimulatorImpl::DoRemove (const EventId &id, uint32_t uid)
+{
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = uid;
+  m_events->Remove (event);
+  ForgetQueueUid (event.impl);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  m_unscheduledEvents--;
+}
+
+void
+CellParallelSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+CellParallelSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      if (t_event != 0)
+        {
+          for (std::vector<PendingOp>::const_iterator op = t_event->ops.begin (); op != t_event->ops.end (); ++op)
+            {
+              if (op->kind == PendingOp::DESTROY && op->id == id)
+                {
+                  return false;
+                }
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0 ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  uint32_t uid = GetQueueUid (id);
+  if (uid == PENDING_UID)
+    {
+      // either still buffered by a batch event, or already run
+      const PendingOp *pending = FindPendingOp (id);
+      return pending == 0 || pending->removed;
+    }
+  uint32_t currentUid = (t_event != 0) ? t_event->event.key.m_uid : m_currentUid;
+  if (id.GetTs () < m_currentTs ||
+      (id.GetTs () == m_currentTs &&
+       uid <= currentUid))
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+CellParallelSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+CellParallelSimulatorImpl::GetContext (void) const
+{
+  if (t_event != 0)
+    {
+      return t_event->event.key.m_context;
+    }
+  return m_currentContext;
+}
+
+uint64_t
+CellParallelSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
+} // namespace ns3
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CELL_PARALLEL_SIMULATOR_IMPL_H
+#define CELL_PARALLEL_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+
+#include "ptr.h"
+
+#include <list>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::CellParallelSimulatorImpl.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * A single process simulator implementation running the events of
+ * different contexts (node ids) which fall on the same timestamp on
+ * several threads, e.g. the TTI processing of the cells of a multi-cell
+ * scenario.
+ *
+ * The contexts allowed to run in parallel are registered with
+ * AddParallelContext(); all the other events run sequentially exactly as
+ * with the DefaultSimulatorImpl. When the next events of the queue share
+ * their timestamp and belong to parallel contexts, they are removed as a
+ * batch and grouped by context. The events of a group run in order on one
+ * thread, and the groups run on the main thread and on "Threads" - 1
+ * worker threads, started at the first batch and waiting for the next
+ * batch in between.
+ *
+ * The events scheduled while a batch runs are not inserted in the event
+ * queue right away: they are buffered per batch event and merged after all
+ * the groups completed, in the order of the batch. Each of them thus gets
+ * the uid it would have got with the DefaultSimulatorImpl, and the order of
+ * the following events, and hence the results, do not depend on the number
+ * of threads. The end of the batch is the synchronization barrier: the
+ * objects shared by the cells, such as the channels, defer their work to
+ * it with CellParallelBatch::ScheduleAtBarrier, and it then runs on the
+ * main thread in the order of the batch.
+ *
+ * The reference counts and the trace sinks are safe to use from a batch.
+ * The packet uids and the random stream indices are taken from a
+ * CellParallelBatch::Counter, which numbers the values of a batch by the
+ * position of the event in the batch, so that they do not depend on the
+ * threads either. Any other state shared by the cells must be reached
+ * through the barrier.
+ */
+class CellParallelSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  CellParallelSimulatorImpl ();
+  /** Destructor. */
+  ~CellParallelSimulatorImpl ();
+
+  /**
+   * Allow the events of a context to run in parallel with the events of
+   * the other parallel contexts.
+   *
+   * \param context the context, usually the id of the node of a cell
+   */
+  void AddParallelContext (uint32_t context);
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
+
+private:
+  /**
+   * Uid of the EventIds returned while a batch runs, before the event gets
+   * its final uid at the merge.
+   */
+  static const uint32_t PENDING_UID = 3;
+
+  /** An operation of a batch event on the event queue, applied at the merge. */
+  struct PendingOp
+  {
+    /** Kind of operation. */
+    enum Kind
+    {
+      INSERT,   ///< insert an event
+      DESTROY,  ///< add a destroy event
+      REMOVE,   ///< remove an event
+      STOP,     ///< stop the simulation
+      BARRIER   ///< run an event at the merge
+    };
+    Kind kind;                  ///< kind of operation
+    Scheduler::Event event;     ///< event to insert, uid not set, or to run
+    EventId id;                 ///< EventId to remove or destroy event
+    bool hasId;                 ///< an EventId was returned for the inserted event
+    bool removed;               ///< the inserted event was removed before the merge
+  };
+
+  /** An event of a batch and the operations it did on the event queue. */
+  struct BatchEvent
+  {
+    Scheduler::Event event;          ///< the event
+    std::vector<PendingOp> ops;      ///< operations, in call order
+  };
+
+  /** The events of one context in a batch. */
+  struct BatchGroup
+  {
+    uint32_t context;                ///< context of the group
+    std::vector<uint32_t> events;    ///< indices of the events in the batch
+  };
+
+  virtual void DoDispose (void);
+
+  /** Process the next event, or the next batch of parallel events. */
+  void ProcessOneEvent (void);
+  /** Move events from a different context into the main event queue. */
+  void ProcessEventsWithContext (void);
+  /**
+   * Remove from the queue the events following \p first which can run in
+   * the same batch and run them.
+   *
+   * \param first the first event of the batch, already removed
+   */
+  void ProcessBatch (const Scheduler::Event &first);
+  /** Run the groups of the batch until none is left. */
+  void RunGroups (void);
+  /** Run the groups of each batch, until StopWorkers(). */
+  void RunWorker (void);
+  /** Stop and join the worker threads. */
+  void StopWorkers (void);
+  /**
+   * Buffer an event to run at the merge, see
+   * CellParallelBatch::ScheduleAtBarrier.
+   *
+   * \param event the event
+   */
+  static void AddBarrierEvent (EventImpl *event);
+  /** Apply the operations of the batch events on the event queue. */
+  void MergeBatch (void);
+
+  /**
+   * \param context the context
+   * \return true if the events of the context can run in parallel
+   */
+  bool IsParallelContext (uint32_t context) const;
+  /**
+   * \param event the event to buffer
+   * \param hasId an EventId is returned for the event
+   * \return the EventId
+   */
+  EventId AddPendingEvent (const Scheduler::Event &event, bool hasId);
+  /**
+   * \param id an EventId returned while a batch ran
+   * \return the operation inserting the event, 0 if it was merged
+   */
+  const PendingOp * FindPendingOp (const EventId &id) const;
+  /**
+   * \param id an EventId
+   * \return the uid of the event in the queue
+   */
+  uint32_t GetQueueUid (const EventId &id) const;
+  /**
+   * Remove an event which is not expired from the queue.
+   *
+   * \param id the event
+   * \param uid the uid of the event in the queue
+   */
+  void DoRemove (const EventId &id, uint32_t uid);
+  /**
+   * Forget the final uid of an event leaving the queue.
+   *
+   * \param event the event
+   */
+  void ForgetQueueUid (EventImpl *event);
+
+  /** Wrap an event with its execution context. */
+  struct EventWithContext {
+    /** The event context. */
+    uint32_t context;
+    /** Event timestamp. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /** Container type for the events from a different context. */
+  typedef std::list<struct EventWithContext> EventsWithContext;
+  /** The container of events from a different context. */
+  EventsWithContext m_eventsWithContext;
+  /**
+   * Flag \c true if all events with context have been moved to the
+   * primary event queue.
+   */
+  bool m_eventsWithContextEmpty;
+  /** Mutex to control access to the list of events with context. */
+  SystemMutex m_eventsWithContextMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Flag calling for the end of the simulation. */
+  bool m_stop;
+  /** The event priority queue. */
+  Ptr<Scheduler> m_events;
+
+  /** Next event unique id. */
+  uint32_t m_uid;
+  /** Unique id of the current event. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current event. */
+  uint64_t m_currentTs;
+  /** Execution context of the current event. */
+  uint32_t m_currentContext;
+  /**
+   * Number of events that have been inserted but not yet scheduled,
+   *  not counting the Destroy events; this is used for validation
+   */
+  int m_unscheduledEvents;
+  /** Number of executed events. */
+  uint64_t m_eventCount;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+
+  /** Maximum number of threads running a batch. */
+  uint32_t m_threads;
+  /** Flag of the parallel contexts, indexed by context. */
+  std::vector<bool> m_parallelContexts;
+  /**
+   * Events of the current timestamp up to this uid were found not to form
+   * a batch, and run sequentially.
+   */
+  uint32_t m_sequentialUid;
+  /** Events of the current batch, in queue order. */
+  std::vector<BatchEvent> m_batch;
+  /** Groups of the current batch. */
+  std::vector<BatchGroup> m_groups;
+  /** Next group to run. */
+  uint32_t m_nextGroup;
+  /** Mutex protecting m_nextGroup. */
+  SystemMutex m_groupMutex;
+  /** Worker threads running the groups with the main thread. */
+  std::vector<Ptr<SystemThread> > m_workers;
+  /** Mutex protecting the state of the workers. */
+  std::mutex m_poolMutex;
+  /** Signals the workers that a batch started, or to stop. */
+  std::condition_variable m_poolStart;
+  /** Signals the main thread that the workers completed the batch. */
+  std::condition_variable m_poolDone;
+  /** Number of the batch run by the workers. */
+  uint64_t m_poolBatch;
+  /** Number of workers still running the batch. */
+  uint32_t m_poolBusy;
+  /** Flag asking the workers to stop. */
+  bool m_poolStop;
+  /** Final uid of the queued events scheduled by batch events. */
+  std::map<EventImpl *, uint32_t> m_queueUids;
+
+  /** Batch event run by the calling thread, 0 outside of a batch. */
+  static thread_local BatchEvent *t_event;
+  /** Group of the batch event run by the calling thread. */
+  static thread_local const BatchGroup *t_group;
+};
+
+} // namespace ns3
+
+#endif /* CELL_PARALLEL_SIMULATOR_IMPL_H */
@@ -77,6 +77,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
 
 private:
   virtual void DoDispose (void);
@@ -129,6 +130,8 @@ private:
    *  not counting the Destroy events; this is used for validation
    */
   int m_unscheduledEvents;
+  /** Number of executed events. */
+  uint64_t m_eventCount;
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
@@ -20,6 +20,7 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include <new>
 
 /**
  * \file
@@ -31,6 +32,158 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** The freelists of the events of a thread. */
+struct EventPool
+{
+  /** Size of the size classes. */
+  static const std::size_t GRANULARITY = 16;
+  /** Number of size classes. */
+  static const std::size_t N_CLASSES = 16;
+  /** Maximum number of free blocks kept per size class. */
+  static const uint32_t MAX_FREE = 4096;
+
+  /** A free block. */
+  struct FreeBlock
+  {
+    FreeBlock *next;   //!< next free block of the size class
+  };
+
+  /** Constructor. */
+  EventPool ()
+  {
+    for (std::size_t i = 0; i < N_CLASSES; i++)
+      {
+        m_free[i] = 0;
+        m_nFree[i] = 0;
+      }
+    m_stats.m_allocated = 0;
+    m_stats.m_recycled = 0;
+    m_stats.m_freed = 0;
+  }
+  /** Destructor, returning the free blocks to the heap. */
+  ~EventPool ()
+  {
+    for (std::size_t i = 0; i < N_CLASSES; i++)
+      {
+        while (m_free[i] != 0)
+          {
+            FreeBlock *block = m_free[i];
+            m_free[i] = block->next;
+            ::operator delete (block);
+          }
+      }
+  }
+
+  FreeBlock *m_free[N_CLASSES];        //!< free blocks of each size class
+  uint32_t m_nFree[N_CLASSES];         //!< number of free blocks of each size class
+  EventImpl::AllocationStats m_stats;  //!< allocation counters
+};
+
+/** Marks the pool of a thread which already exited. */
+EventPool * const DEAD_POOL = reinterpret_cast<EventPool *> (1);
+
+/**
+ * Pool of the calling thread. A plain pointer, which remains valid while
+ * the other thread local objects are destroyed.
+ */
+thread_local EventPool *t_pool = 0;
+
+/** Deletes the pool of its thread when the thread exits. */
+struct EventPoolGuard
+{
+  /** Destructor. */
+  ~EventPoolGuard ()
+  {
+    if (t_pool != DEAD_POOL)
+      {
+        delete t_pool;
+      }
+    t_pool = DEAD_POOL;
+  }
+  bool m_armed;  //!< the pool of the thread was created
+};
+
+/** Guard of the pool of the calling thread. */
+thread_local EventPoolGuard t_guard;
+
+/**
+ * \return the pool of the calling thread, or DEAD_POOL while the thread
+ * exits
+ */
+EventPool *
+GetPool (void)
+{
+  if (t_pool == 0)
+    {
+      t_guard.m_armed = true;
+      t_pool = new EventPool ();
+    }
+  return t_pool;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / EventPool::GRANULARITY;
+  EventPool *pool = GetPool ();
+  if (pool == DEAD_POOL)
+    {
+      return ::operator new (size);
+    }
+  pool->m_stats.m_allocated++;
+  if (sizeClass >= EventPool::N_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  EventPool::FreeBlock *block = pool->m_free[sizeClass];
+  if (block != 0)
+    {
+      pool->m_free[sizeClass] = block->next;
+      pool->m_nFree[sizeClass]--;
+      pool->m_stats.m_recycled++;
+      return block;
+    }
+  return ::operator new ((sizeClass + 1) * EventPool::GRANULARITY);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / EventPool::GRANULARITY;
+  EventPool *pool = GetPool ();
+  if (pool == DEAD_POOL)
+    {
+      ::operator delete (p);
+      return;
+    }
+  pool->m_stats.m_freed++;
+  if (sizeClass >= EventPool::N_CLASSES || pool->m_nFree[sizeClass] >= EventPool::MAX_FREE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  EventPool::FreeBlock *block = static_cast<EventPool::FreeBlock *> (p);
+  block->next = pool->m_free[sizeClass];
+  pool->m_free[sizeClass] = block;
+  pool->m_nFree[sizeClass]++;
+}
+
+EventImpl::AllocationStats
+EventImpl::GetAllocationStats (void)
+{
+  EventPool *pool = GetPool ();
+  if (pool == DEAD_POOL)
+    {
+      AllocationStats stats = { 0, 0, 0 };
+      return stats;
+    }
+  return pool->m_stats;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
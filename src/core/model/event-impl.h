@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,10 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The events are allocated from per-thread freelists, one for each size
+ * class of 16 bytes up to 256 bytes, so that the events bound by MakeEvent,
+ * with their arguments stored inline, seldom reach the heap allocator.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +71,34 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate an event from the freelist of its size class.
+   *
+   * \param size the size of the event
+   * \return the memory of the event
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return the memory of an event to the freelist of its size class.
+   *
+   * \param p the memory of the event
+   * \param size the size of the event
+   */
+  static void operator delete (void *p, std::size_t size);
+
+  /** Allocation counters of the events. */
+  struct AllocationStats
+  {
+    uint64_t m_allocated;   //!< events allocated
+    uint64_t m_recycled;    //!< events allocated from a freelist
+    uint64_t m_freed;       //!< events freed
+  };
+  /**
+   * \return the allocation counters of the events allocated and freed by
+   * the calling thread
+   */
+  static AllocationStats GetAllocationStats (void);
+
 protected:
   /**
    * Implementation for Invoke().
@@ -0,0 +1,261 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "assert.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ *
+ * Hash table with 32 bit keys, e.g. GTP-U TEIDs or IPv4 addresses, for
+ * the lookups done for each packet of a data path.
+ *
+ * The entries are kept in a single array with open addressing and linear
+ * probing, so that a lookup reads a few contiguous slots instead of
+ * following the nodes of a std::map. The keys are spread with Fibonacci
+ * hashing, since identifiers and addresses are often allocated
+ * sequentially. The array doubles when it is half full, and erasing
+ * shifts the following entries back instead of leaving tombstones.
+ */
+template <class T>
+class FlatHashMap
+{
+public:
+  FlatHashMap ();
+
+  /**
+   * \param key the key of an entry
+   * \return the value of the entry, or 0 if there is none
+   */
+  T* Find (uint32_t key);
+
+  /**
+   * \param key the key of an entry
+   * \return the value of the entry, or 0 if there is none
+   */
+  const T* Find (uint32_t key) const;
+
+  /**
+   * \param key the key of an entry
+   * \return the value of the entry, default constructed if the entry
+   *         was not there
+   */
+  T& operator[] (uint32_t key);
+
+  /**
+   * \param key the key of an entry
+   * \return true if the entry was there
+   */
+  bool Erase (uint32_t key);
+
+  /**
+   * \return the number of entries
+   */
+  uint32_t GetSize () const;
+
+  /**
+   * Remove all the entries
+   */
+  void Clear ();
+
+private:
+
+  /**
+   * \param key a key
+   * \return the slot where the probing for the key starts
+   */
+  uint32_t GetHome (uint32_t key) const;
+
+  /**
+   * \param key a key
+   * \return the slot of the key, or of the free slot where it would go
+   */
+  uint32_t Probe (uint32_t key) const;
+
+  /**
+   * Double the number of slots
+   */
+  void Grow ();
+
+  struct Slot
+  {
+    uint32_t key;
+    bool used;
+    T value;
+  };
+
+  std::vector<Slot> m_slots;
+  uint32_t m_shift; ///< 32 minus the log2 of the number of slots
+  uint32_t m_size;
+};
+
+
+template <class T>
+FlatHashMap<T>::FlatHashMap ()
+  : m_slots (16),
+    m_shift (28),
+    m_size (0)
+{
+  for (typename std::vector<Slot>::iterator it = m_slots.begin (); it != m_slots.end (); ++it)
+    {
+      it->used = false;
+    }
+}
+
+template <class T>
+uint32_t
+FlatHashMap<T>::GetHome (uint32_t key) const
+{
+  return (key * 2654435769U) >> m_shift;
+}
+
+template <class T>
+uint32_t
+FlatHashMap<T>::Probe (uint32_t key) const
+{
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t i = GetHome (key);
+  while (m_slots[i].used && m_slots[i].key != key)
+    {
+      i = (i + 1) & mask;
+    }
+  return i;
+}
+
+template <class T>
+T*
+FlatHashMap<T>::Find (uint32_t key)
+{
+  Slot &slot = m_slots[Probe (key)];
+  return slot.used ? &slot.value : 0;
+}
+
+template <class T>
+const T*
+FlatHashMap<T>::Find (uint32_t key) const
+{
+  const Slot &slot = m_slots[Probe (key)];
+  return slot.used ? &slot.value : 0;
+}
+
+template <class T>
+T&
+FlatHashMap<T>::operator[] (uint32_t key)
+{
+  uint32_t i = Probe (key);
+  if (m_slots[i].used)
+    {
+      return m_slots[i].value;
+    }
+  if (2 * (m_size + 1) > m_slots.size ())
+    {
+      Grow ();
+      i = Probe (key);
+    }
+  m_slots[i].key = key;
+  m_slots[i].used = true;
+  m_slots[i].value = T ();
+  ++m_size;
+  return m_slots[i].value;
+}
+
+template <class T>
+bool
+FlatHashMap<T>::Erase (uint32_t key)
+{
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t i = Probe (key);
+  if (!m_slots[i].used)
+    {
+      return false;
+    }
+  // move back the entries of the probe sequence which would no longer
+  // be reachable through the freed slot
+  uint32_t j = i;
+  while (true)
+    {
+      j = (j + 1) & mask;
+      if (!m_slots[j].used)
+        {
+          break;
+        }
+      uint32_t home = GetHome (m_slots[j].key);
+      bool reachable = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+      if (!reachable)
+        {
+          m_slots[i].key = m_slots[j].key;
+          m_slots[i].value = m_slots[j].value;
+          i = j;
+        }
+    }
+  m_slots[i].used = false;
+  m_slots[i].value = T ();
+  --m_size;
+  return true;
+}
+
+template <class T>
+uint32_t
+FlatHashMap<T>::GetSize () const
+{
+  return m_size;
+}
+
+template <class T>
+void
+FlatHashMap<T>::Clear ()
+{
+  for (typename std::vector<Slot>::iterator it = m_slots.begin (); it != m_slots.end (); ++it)
+    {
+      it->used = false;
+      it->value = T ();
+    }
+  m_size = 0;
+}
+
+template <class T>
+void
+FlatHashMap<T>::Grow ()
+{
+  NS_ASSERT_MSG (m_shift > 1, "hash table too large");
+  std::vector<Slot> old (2 * m_slots.size ());
+  old.swap (m_slots);
+  --m_shift;
+  for (typename std::vector<Slot>::iterator it = m_slots.begin (); it != m_slots.end (); ++it)
+    {
+      it->used = false;
+    }
+  for (typename std::vector<Slot>::iterator it = old.begin (); it != old.end (); ++it)
+    {
+      if (it->used)
+        {
+          Slot &slot = m_slots[Probe (it->key)];
+          slot.key = it->key;
+          slot.used = true;
+          slot.value = it->value;
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* FLAT_HASH_MAP_H */
@@ -25,6 +25,7 @@
 #include "attribute.h"
 #include "log.h"
 #include "string.h"
+#include "cell-parallel-batch.h"
 #include <vector>
 #include <sstream>
 #include <cstdlib>
@@ -46,6 +47,8 @@ NS_LOG_COMPONENT_DEFINE ("Object");
 
 NS_OBJECT_ENSURE_REGISTERED (Object);
 
+uint64_t Object::m_nGetObjectCalls = 0;
+
 Object::AggregateIterator::AggregateIterator ()
   : m_object (0),
     m_current (0)
@@ -103,6 +106,7 @@ Object::Object ()
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearLookupCache (m_aggregates);
 }
 Object::~Object () 
 {
@@ -120,6 +124,7 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  ClearLookupCache (m_aggregates);
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -137,6 +142,7 @@ Object::Object (const Object &o)
 {
   m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
+  ClearLookupCache (m_aggregates);
 }
 void
 Object::Construct (const AttributeConstructionList &attributes)
@@ -151,17 +157,26 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  struct Lookup &lookup = m_aggregates->cache[tid.GetUid () % LOOKUP_CACHE_SIZE];
+  if (lookup.tid == tid.GetUid ())
+    {
+      return lookup.object;
+    }
+  // other cells may look up the same object concurrently in a parallel
+  // batch: leave the cache and the order of the aggregates unchanged
+  bool update = !CellParallelBatch::IsRunning ();
+  if (update)
+    {
+      lookup.tid = tid.GetUid ();
+      lookup.object = 0;
+    }
+
   uint32_t n = m_aggregates->n;
-  TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
     {
       Object *current = m_aggregates->buffer[i];
       TypeId cur = current->GetInstanceTypeId ();
-      while (cur != tid && cur != objectTid)
-        {
-          cur = cur.GetParent ();
-        }
-      if (cur == tid)
+      if (cur == tid || cur.IsChildOf (tid))
         {
           // This is an attempt to 'cache' the result of this lookup.
           // the idea is that if we perform a lookup for a TypeId on this object,
@@ -169,17 +184,35 @@ Object::DoGetObject (TypeId tid) const
           // that the aggregate array is sorted by the number of accesses
           // to each object.
 
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
+          if (update)
+            {
+              // first, increment the access count
+              current->m_getObjectCount++;
+              // then, update the sort
+              UpdateSortedArray (m_aggregates, i);
+              // finally, remember the match
+              lookup.object = current;
+            }
           return const_cast<Object *> (current);
         }
     }
   return 0;
 }
 void
+Object::ClearLookupCache (struct Aggregates *aggregates)
+{
+  for (uint32_t i = 0; i < LOOKUP_CACHE_SIZE; i++)
+    {
+      aggregates->cache[i].tid = 0;
+      aggregates->cache[i].object = 0;
+    }
+}
+uint64_t
+Object::GetNGetObjectCalls (void)
+{
+  return m_nGetObjectCalls;
+}
+void
 Object::Initialize (void)
 {
   /**
@@ -263,6 +296,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  ClearLookupCache (aggregates);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -340,6 +374,7 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  ClearLookupCache (m_aggregates);
 }
 
 void
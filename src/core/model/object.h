@@ -160,6 +160,16 @@ private:
    */
   template <typename T>
   Ptr<T> GetObject (TypeId tid) const;
+  /**
+   * Get the number of calls to GetObject() since the start of the
+   * program, in all the threads.
+   *
+   * Sampling it periodically gives the number of calls per simulated
+   * second of a scenario.
+   *
+   * \returns The number of calls.
+   */
+  static uint64_t GetNGetObjectCalls (void);
   /**
    * Dispose of this Object.
    *
@@ -320,6 +330,16 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /** Number of entries of the lookup cache of the aggregates. */
+  static const uint32_t LOOKUP_CACHE_SIZE = 8;
+  /** A lookup of DoGetObject, which may have found no Object. */
+  struct Lookup {
+    /** The uid of the TypeId looked up, 0 if the entry is empty. */
+    uint16_t tid;
+    /** The Object found. */
+    Object *object;
+  };
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -335,6 +355,11 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /**
+     * The last lookups, indexed by TypeId uid modulo LOOKUP_CACHE_SIZE.
+     * A new aggregation creates new Aggregates, which drops the cache.
+     */
+    struct Lookup cache[LOOKUP_CACHE_SIZE];
     /** The array of Objects. */
     Object *buffer[1];
   };
@@ -346,6 +371,12 @@ private:
    * \return The matching Object, if it is found
    */
   Ptr<Object> DoGetObject (TypeId tid) const;
+  /**
+   * Empty the lookup cache of some aggregates.
+   *
+   * \param [in] aggregates The aggregates
+   */
+  static void ClearLookupCache (struct Aggregates *aggregates);
   /**
    * Verify that this Object is still live, by checking it's reference count.
    * \return \c true if the reference count is non zero.
@@ -432,6 +463,8 @@ private:
    * the array of aggregates in most-frequently accessed order.
    */
   uint32_t m_getObjectCount;
+  /** The number of calls to GetObject(), approximate with threads. */
+  static uint64_t m_nGetObjectCalls;
 };
 
 template <typename T>
@@ -458,6 +491,7 @@ template <typename T>
 Ptr<T> 
 Object::GetObject () const
 {
+  m_nGetObjectCalls++;
   // This is an optimization: if the cast works (which is likely),
   // things will be pretty fast.
   T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
@@ -478,6 +512,7 @@ template <typename T>
 Ptr<T> 
 Object::GetObject (TypeId tid) const
 {
+  m_nGetObjectCalls++;
   Ptr<Object> found = DoGetObject (tid);
   if (found != 0)
     {
@@ -90,6 +90,7 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
+  m_eventCount = 0;
 
   m_main = SystemThread::Self();
 
@@ -387,6 +388,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
   // changing things out from under us.
 
   EventImpl *event = next.impl;
+  m_eventCount++;
   m_synchronizer->EventStart ();
   event->Invoke ();
   m_synchronizer->EventEnd ();
@@ -820,6 +822,12 @@ RealtimeSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint64_t
+RealtimeSimulatorImpl::GetEventCount (void) const
+{
+  return m_eventCount;
+}
+
 void 
 RealtimeSimulatorImpl::SetSynchronizationMode (enum SynchronizationMode mode)
 {
@@ -107,6 +107,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
 
   /** \copydoc ScheduleWithContext(uint32_t,const Time&,EventImpl*) */
   void ScheduleRealtimeWithContext (uint32_t context, const Time &delay, EventImpl *event);
@@ -194,6 +195,8 @@ private:
   Ptr<Scheduler> m_events;
   /**< Number of events in the event list. */
   int m_unscheduledEvents;
+  /**< Number of executed events. */
+  uint64_t m_eventCount;
   /**< Unique id for the next event to be scheduled. */
   uint32_t m_uid;
   /**< Unique id of the current event. */
@@ -105,6 +105,12 @@ public:
    */
   static uint64_t GetNextStreamIndex(void);
 
+  /**
+   * Resets the global stream index counter, so that the next automatically
+   * assigned stream index is 0 again.
+   */
+  static void ResetNextStreamIndex (void);
+
 };
 
 /** Alias for compatibility. */
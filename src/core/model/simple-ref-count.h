@@ -27,6 +27,7 @@
 #include "assert.h"
 #include <stdint.h>
 #include <limits>
+#include "cell-parallel-batch.h"
 
 /**
  * \file
@@ -100,7 +101,7 @@ public:
   inline void Ref (void) const
   {
     NS_ASSERT (m_count < std::numeric_limits<uint32_t>::max());
-    m_count++;
+    ++m_count;
   }
   /**
    * Decrement the reference count. This method should not be called
@@ -110,8 +111,7 @@ public:
    */
   inline void Unref (void) const
   {
-    m_count--;
-    if (m_count == 0)
+    if (--m_count == 0)
       {
         DELETER::Delete (static_cast<T*> (const_cast<SimpleRefCount *> (this)));
       }
@@ -138,9 +138,11 @@ private:
    *
    * \internal
    * Note we make this mutable so that the const methods can still
-   * change it.
+   * change it. It is a CellParallelBatch::RefCount as the objects shared
+   * by the cells of a CellParallelSimulatorImpl are referenced from
+   * several threads.
    */
-  mutable uint32_t m_count;
+  mutable CellParallelBatch::RefCount m_count;
 };
 
 } // namespace ns3
@@ -24,6 +24,7 @@
 #include "map-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
+#include "system-wall-clock-ms.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -77,6 +78,60 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
                                                   TypeIdValue (MapScheduler::GetTypeId ()),
                                                   MakeTypeIdChecker ());
 
+/**
+ * \ingroup simulator
+ * The file to write the performance report of the simulation to.
+ *
+ * If not empty, Simulator::Destroy writes the number of executed events,
+ * the simulated time and the wall clock time spent in Simulator::Run to
+ * this file, as a JSON object read by utils/run-benchmarks.py.
+ */
+static GlobalValue g_perfReportFile = GlobalValue
+  ("PerfReportFile",
+   "If not empty, the file to write the performance report of the simulation to",
+   StringValue (""),
+   MakeStringChecker ());
+
+/**
+ * \ingroup simulator
+ * Wall clock time spent in Simulator::Run since the last Simulator::Destroy,
+ * in milliseconds.
+ */
+static int64_t g_runWallClockMs = 0;
+
+/**
+ * \ingroup simulator
+ * Write the performance report of the simulation, if a PerfReportFile is set.
+ *
+ * \param [in] impl The simulator implementation, before it is destroyed.
+ */
+static void
+WritePerfReport (SimulatorImpl *impl)
+{
+  StringValue s;
+  g_perfReportFile.GetValue (s);
+  std::string fileName = s.Get ();
+  if (fileName.empty ())
+    {
+      return;
+    }
+  std::ofstream os (fileName.c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("cannot open the performance report file " << fileName);
+      return;
+    }
+  uint64_t events = impl->GetEventCount ();
+  double wallClock = g_runWallClockMs / 1000.0;
+  os << std::setprecision (9)
+     << "{\n"
+     << "  \"events\": " << events << ",\n"
+     << "  \"simulatedSeconds\": " << impl->Now ().GetSeconds () << ",\n"
+     << "  \"wallClockSeconds\": " << wallClock << ",\n"
+     << "  \"eventsPerSecond\": " << (wallClock > 0 ? events / wallClock : 0) << "\n"
+     << "}\n";
+}
+
 /**
  * \ingroup logging
  * Default TimePrinter implementation.
@@ -203,6 +258,8 @@ Simulator::Destroy (void)
    */
   LogSetTimePrinter (0);
   LogSetNodePrinter (0);
+  WritePerfReport (*pimpl);
+  g_runWallClockMs = 0;
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
@@ -227,7 +284,10 @@ Simulator::Run (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   Time::ClearMarkedTimes ();
+  SystemWallClockMs wallClock;
+  wallClock.Start ();
   GetImpl ()->Run ();
+  g_runWallClockMs += wallClock.End ();
 }
 
 void 
@@ -380,6 +440,12 @@ Simulator::GetContext (void)
   return GetImpl ()->GetContext ();
 }
 
+uint64_t
+Simulator::GetEventCount (void)
+{
+  return GetImpl ()->GetEventCount ();
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
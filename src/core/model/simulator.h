@@ -184,6 +184,17 @@ public:
    */
   static uint32_t GetContext (void);
 
+  /**
+   * Get the number of events executed so far.
+   *
+   * The count covers the events taken from the event list by Run(),
+   * in every context, including the cancelled events which were not
+   * removed from the list. It excludes the destroy events.
+   *
+   * @return The number of executed events.
+   */
+  static uint64_t GetEventCount (void);
+
   /** Context enum values. */
   enum {
     /**
@@ -0,0 +1,319 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timing-wheel-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "string.h"
+#include "assert.h"
+#include "abort.h"
+#include "log.h"
+#include <algorithm>
+#include <iomanip>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimingWheelScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (TimingWheelScheduler);
+
+TypeId
+TimingWheelScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimingWheelScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimingWheelScheduler> ()
+    .AddAttribute ("Buckets",
+                   "The number of buckets of the wheel, a power of two not lower than 64.",
+                   UintegerValue (8192),
+                   MakeUintegerAccessor (&TimingWheelScheduler::m_nBuckets),
+                   MakeUintegerChecker<uint32_t> (64))
+    .AddAttribute ("BucketWidth",
+                   "The duration of a bucket of the wheel. The wheel spans "
+                   "Buckets times BucketWidth, beyond which the events are kept "
+                   "in an overflow map.",
+                   TimeValue (MicroSeconds (2)),
+                   MakeTimeAccessor (&TimingWheelScheduler::m_bucketWidth),
+                   MakeTimeChecker ())
+    .AddAttribute ("DelayTraceFile",
+                   "If not empty, the delay of every inserted event from the last "
+                   "removed one is written to this file, in seconds, as read by "
+                   "utils/bench-simulator --file.",
+                   StringValue (""),
+                   MakeStringAccessor (&TimingWheelScheduler::m_delayTraceFileName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TimingWheelScheduler::TimingWheelScheduler ()
+  : m_width (0),
+    m_head (0),
+    m_tick (0),
+    m_nWheel (0),
+    m_lastTs (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TimingWheelScheduler::~TimingWheelScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_delayTraceFile.is_open ())
+    {
+      m_delayTraceFile.close ();
+    }
+}
+
+void
+TimingWheelScheduler::Init (void)
+{
+  NS_LOG_FUNCTION (this << m_nBuckets << m_bucketWidth);
+  NS_ABORT_MSG_IF ((m_nBuckets & (m_nBuckets - 1)) != 0, "the number of buckets must be a power of two");
+  m_width = m_bucketWidth.GetTimeStep ();
+  NS_ABORT_MSG_IF (m_width == 0, "the bucket width must be at least one time step");
+  m_buckets.resize (m_nBuckets);
+  m_busy.assign (m_nBuckets / 64, 0);
+  if (!m_delayTraceFileName.empty ())
+    {
+      m_delayTraceFile.open (m_delayTraceFileName.c_str ());
+      NS_ABORT_MSG_UNLESS (m_delayTraceFile.is_open (), "cannot open " << m_delayTraceFileName);
+      m_delayTraceFile << std::setprecision (12);
+    }
+}
+
+uint64_t
+TimingWheelScheduler::GetTick (uint64_t ts) const
+{
+  return ts / m_width;
+}
+
+void
+TimingWheelScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_buckets.empty ())
+    {
+      Init ();
+    }
+  if (m_delayTraceFile.is_open ())
+    {
+      m_delayTraceFile << TimeStep (ev.key.m_ts - m_lastTs).GetSeconds () << std::endl;
+    }
+
+  uint64_t tick = GetTick (ev.key.m_ts);
+  if (m_head == m_current.size ())
+    {
+      // the current bucket is only empty when the whole queue is
+      m_current.clear ();
+      m_head = 0;
+      m_tick = tick;
+      m_current.push_back (ev);
+    }
+  else if (tick <= m_tick)
+    {
+      InsertCurrent (ev);
+    }
+  else if (tick - m_tick < m_nBuckets)
+    {
+      InsertWheel (ev, tick);
+    }
+  else
+    {
+      std::pair<EventMap::iterator, bool> result = m_overflow.insert (std::make_pair (ev.key, ev.impl));
+      NS_ASSERT (result.second);
+    }
+}
+
+void
+TimingWheelScheduler::InsertCurrent (const Event &ev)
+{
+  // the events scheduled now and the periodic events usually go last
+  if (m_current.back ().key < ev.key)
+    {
+      m_current.push_back (ev);
+    }
+  else
+    {
+      Bucket::iterator it = std::upper_bound (m_current.begin () + m_head, m_current.end (), ev);
+      m_current.insert (it, ev);
+    }
+}
+
+void
+TimingWheelScheduler::InsertWheel (const Event &ev, uint64_t tick)
+{
+  uint32_t slot = tick & (m_nBuckets - 1);
+  m_buckets[slot].push_back (ev);
+  m_busy[slot / 64] |= (uint64_t) 1 << (slot % 64);
+  m_nWheel++;
+}
+
+bool
+TimingWheelScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_head == m_current.size ();
+}
+
+Scheduler::Event
+TimingWheelScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_head < m_current.size ());
+  return m_current[m_head];
+}
+
+Scheduler::Event
+TimingWheelScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_head < m_current.size ());
+  Event ev = m_current[m_head];
+  m_head++;
+  m_lastTs = ev.key.m_ts;
+  if (m_head == m_current.size () && (m_nWheel > 0 || !m_overflow.empty ()))
+    {
+      Advance ();
+    }
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+TimingWheelScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t tick = GetTick (ev.key.m_ts);
+  if (tick <= m_tick)
+    {
+      Bucket::iterator it = std::lower_bound (m_current.begin () + m_head, m_current.end (), ev);
+      NS_ASSERT (it != m_current.end () && it->impl == ev.impl);
+      if (it == m_current.begin () + m_head)
+        {
+          m_head++;
+        }
+      else
+        {
+          m_current.erase (it);
+        }
+      if (m_head == m_current.size () && (m_nWheel > 0 || !m_overflow.empty ()))
+        {
+          Advance ();
+        }
+    }
+  else if (tick - m_tick < m_nBuckets)
+    {
+      uint32_t slot = tick & (m_nBuckets - 1);
+      Bucket &bucket = m_buckets[slot];
+      Bucket::iterator it = bucket.begin ();
+      while (it->key.m_uid != ev.key.m_uid)
+        {
+          ++it;
+          NS_ASSERT (it != bucket.end ());
+        }
+      NS_ASSERT (it->impl == ev.impl);
+      *it = bucket.back ();
+      bucket.pop_back ();
+      if (bucket.empty ())
+        {
+          m_busy[slot / 64] &= ~((uint64_t) 1 << (slot % 64));
+        }
+      m_nWheel--;
+    }
+  else
+    {
+      EventMap::iterator i = m_overflow.find (ev.key);
+      NS_ASSERT (i->second == ev.impl);
+      m_overflow.erase (i);
+    }
+}
+
+uint64_t
+TimingWheelScheduler::FindBusyTick (uint64_t tick) const
+{
+  uint32_t slot = tick & (m_nBuckets - 1);
+  uint32_t word = slot / 64;
+  uint32_t bit = slot % 64;
+  uint64_t bits = m_busy[word] & (~(uint64_t) 0 << bit);
+  if (bits != 0)
+    {
+      return tick + __builtin_ctzll (bits) - bit;
+    }
+  uint64_t distance = 64 - bit;
+  uint32_t nWords = m_busy.size ();
+  for (uint32_t i = 1; i <= nWords; i++)
+    {
+      bits = m_busy[(word + i) % nWords];
+      if (bits != 0)
+        {
+          return tick + distance + __builtin_ctzll (bits);
+        }
+      distance += 64;
+    }
+  NS_FATAL_ERROR ("no busy bucket in the wheel");
+  return tick;
+}
+
+void
+TimingWheelScheduler::Advance (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_head == m_current.size ());
+  m_current.clear ();
+  m_head = 0;
+
+  // the overflow map only holds events beyond the span of the wheel
+  if (m_nWheel > 0)
+    {
+      m_tick = FindBusyTick (m_tick + 1);
+    }
+  else
+    {
+      m_tick = GetTick (m_overflow.begin ()->first.m_ts);
+    }
+  while (!m_overflow.empty ())
+    {
+      EventMap::iterator i = m_overflow.begin ();
+      uint64_t tick = GetTick (i->first.m_ts);
+      if (tick - m_tick >= m_nBuckets)
+        {
+          break;
+        }
+      Event ev;
+      ev.impl = i->second;
+      ev.key = i->first;
+      InsertWheel (ev, tick);
+      m_overflow.erase (i);
+    }
+
+  // the emptied current bucket keeps its capacity for a later tick
+  uint32_t slot = m_tick & (m_nBuckets - 1);
+  m_current.swap (m_buckets[slot]);
+  m_busy[slot / 64] &= ~((uint64_t) 1 << (slot % 64));
+  m_nWheel -= m_current.size ();
+  NS_ASSERT (!m_current.empty ());
+  std::sort (m_current.begin (), m_current.end ());
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMING_WHEEL_SCHEDULER_H
+#define TIMING_WHEEL_SCHEDULER_H
+
+#include "scheduler.h"
+#include "nstime.h"
+#include <stdint.h>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a timing wheel event scheduler
+ *
+ * This event scheduler is tuned for the strictly periodic events which
+ * dominate the cellular simulations: slots and TTIs, HARQ timers, periodic
+ * reports and traces. The near future is a wheel of "Buckets" unsorted
+ * buckets of "BucketWidth" each, so that inserting or removing an event
+ * due within the span of the wheel costs O(1). The events beyond the span
+ * of the wheel are kept in an overflow map, like in the MapScheduler, and
+ * move to the wheel when it turns.
+ *
+ * The bucket of the next events is sorted when the wheel reaches it, and
+ * the events inserted in it, e.g. by Simulator::ScheduleNow, are inserted
+ * in order. A bitmap of the busy buckets lets the wheel skip the empty
+ * ones quickly.
+ *
+ * The wheel works best when a bucket holds a few events and its span covers
+ * the periods of the scenario. utils/bench-simulator replays the delays
+ * written to "DelayTraceFile" by a simulation to compare the schedulers.
+ */
+class TimingWheelScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  TimingWheelScheduler ();
+  /** Destructor. */
+  virtual ~TimingWheelScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Allocate the wheel from the attributes, at the first insertion. */
+  void Init (void);
+  /**
+   * \param ts a timestamp, in time steps
+   * \return the tick of the bucket holding the timestamp
+   */
+  uint64_t GetTick (uint64_t ts) const;
+  /**
+   * Insert an event in the sorted current bucket.
+   *
+   * \param ev the event
+   */
+  void InsertCurrent (const Scheduler::Event &ev);
+  /**
+   * Insert an event in the bucket of a tick of the wheel.
+   *
+   * \param ev the event
+   * \param tick the tick of the event, within the span of the wheel
+   */
+  void InsertWheel (const Scheduler::Event &ev, uint64_t tick);
+  /**
+   * Turn the wheel to the next busy bucket, refill it from the overflow
+   * map and make it the current bucket. The current bucket must be empty.
+   */
+  void Advance (void);
+  /**
+   * \param tick the tick following the current one
+   * \return the first tick from \p tick on whose bucket holds events
+   */
+  uint64_t FindBusyTick (uint64_t tick) const;
+
+  /** Event list type: a vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+  /** Overflow list type: a Map from EventKey to EventImpl. */
+  typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
+
+  /** Number of buckets of the wheel, a power of two. */
+  uint32_t m_nBuckets;
+  /** Duration of a bucket. */
+  Time m_bucketWidth;
+  /** Duration of a bucket, in time steps. */
+  uint64_t m_width;
+  /** Buckets of the wheel, indexed by tick modulo the number of buckets. */
+  std::vector<Bucket> m_buckets;
+  /** One bit per bucket of the wheel, set if it holds events. */
+  std::vector<uint64_t> m_busy;
+  /** Events of the current tick and earlier, sorted. */
+  Bucket m_current;
+  /** Index of the next event in m_current. */
+  uint32_t m_head;
+  /** Tick of the current bucket. */
+  uint64_t m_tick;
+  /** Number of events in the buckets of the wheel. */
+  uint32_t m_nWheel;
+  /** Events beyond the span of the wheel. */
+  EventMap m_overflow;
+  /** Timestamp of the last removed event. */
+  uint64_t m_lastTs;
+  /** Name of the file of the delays of the inserted events. */
+  std::string m_delayTraceFileName;
+  /** File of the delays of the inserted events. */
+  std::ofstream m_delayTraceFile;
+};
+
+} // namespace ns3
+
+#endif /* TIMING_WHEEL_SCHEDULER_H */
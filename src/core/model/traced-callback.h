@@ -23,6 +23,7 @@
 
 #include <list>
 #include "callback.h"
+#include "cell-parallel-batch.h"
 
 /**
  * \file
@@ -321,6 +322,12 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  // the sinks may be shared by the cells running in parallel
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -334,6 +341,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -347,6 +359,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -360,6 +377,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -373,6 +395,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -386,6 +413,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -399,6 +431,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -412,6 +449,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -425,6 +467,11 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  CellParallelBatch::TraceSinkGuard guard;
   for (typename CallbackList::const_iterator i = m_callbackList.begin ();
        i != m_callbackList.end (); i++)
     {
@@ -143,6 +143,13 @@ public:
    * \returns The parent type id of the type id.
    */
   uint16_t GetParent (uint16_t uid) const;
+  /**
+   * Check if a type id is a child of another one, in constant time.
+   * \param [in] uid The id.
+   * \param [in] other The id of the candidate ancestor.
+   * \returns \c true if \p other is a strict ancestor of \p uid.
+   */
+  bool IsChildOf (uint16_t uid, uint16_t other) const;
   /**
    * Get the group name of a type id.
    * \param [in] uid The id.
@@ -301,6 +308,11 @@ private:
     TypeId::hash_t hash;
     /** The parent type id. */
     uint16_t parent;
+    /**
+     * The ancestors of the type id, from the root down to the type id
+     * itself, so that the ancestor of any depth is at hand.
+     */
+    std::vector<uint16_t> ancestors;
     /** The group name. */
     std::string groupName;
     /** The size of the object represented by this type id. */
@@ -432,6 +444,7 @@ IidManager::AllocateUid (std::string name)
   m_information.push_back (information);
   uint32_t uid = m_information.size ();
   NS_ASSERT (uid <= 0xffff);
+  m_information.back ().ancestors.push_back (uid);
 
   // Add to both maps:
   m_namemap.insert (std::make_pair (name, uid));
@@ -456,6 +469,13 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  // the parent is complete, as SetParent<T> gets its TypeId first
+  information->ancestors.clear ();
+  if (parent != uid && parent != 0)
+    {
+      information->ancestors = LookupInformation (parent)->ancestors;
+    }
+  information->ancestors.push_back (uid);
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -544,6 +564,14 @@ IidManager::GetParent (uint16_t uid) const
   NS_LOG_LOGIC (IIDL << pid);
   return pid;
 }
+bool
+IidManager::IsChildOf (uint16_t uid, uint16_t other) const
+{
+  NS_LOG_FUNCTION (IID << uid << other);
+  const std::vector<uint16_t> &ancestors = LookupInformation (uid)->ancestors;
+  std::size_t depth = LookupInformation (other)->ancestors.size ();
+  return depth < ancestors.size () && ancestors[depth - 1] == other;
+}
 std::string 
 IidManager::GetGroupName (uint16_t uid) const
 {
@@ -939,12 +967,7 @@ bool
 TypeId::IsChildOf (TypeId other) const
 {
   NS_LOG_FUNCTION (this << other.GetUid ());
-  TypeId tmp = *this;
-  while (tmp != other && tmp != tmp.GetParent ())
-    {
-      tmp = tmp.GetParent ();
-    }
-  return tmp == other && *this != other;
+  return IidManager::Get ()->IsChildOf (m_tid, other.m_tid);
 }
 std::string 
 TypeId::GetGroupName (void) const
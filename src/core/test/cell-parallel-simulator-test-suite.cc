@@ -0,0 +1,546 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/cell-parallel-simulator-impl.h"
+#include "ns3/cell-parallel-batch.h"
+#include "ns3/make-event.h"
+#include "ns3/traced-callback.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/object.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+#include <set>
+
+using namespace ns3;
+
+/**
+ * Runs the same multi-cell scenario with the default simulator and with
+ * the cell parallel simulator on 1 and 4 threads, and checks that every
+ * cell sees the same events in the same order.
+ *
+ * Every TTI, each cell starts a retransmission timer that an ack scheduled
+ * at the same time cancels, schedules and removes a dummy event, and sends
+ * a value to its two neighbours at the same time, so that the order of the
+ * values received by a cell depends on the merge of the batch. A sequential
+ * context samples the state of all the cells every TTI.
+ */
+class CellParallelSimulatorTestCase : public TestCase
+{
+public:
+  CellParallelSimulatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param simulatorType the simulator implementation
+   * \param threads the number of threads of the cell parallel simulator
+   * \return the log of each context
+   */
+  std::vector<std::vector<uint64_t> > RunScenario (std::string simulatorType, uint32_t threads);
+  /**
+   * TTI of a cell.
+   * \param cell the cell
+   * \param n the TTI number
+   */
+  void Tti (uint32_t cell, uint32_t n);
+  /**
+   * Ack cancelling the retransmission of a cell.
+   * \param cell the cell
+   * \param retx the retransmission
+   */
+  void Ack (uint32_t cell, EventId retx);
+  /**
+   * Retransmission, never run.
+   * \param cell the cell
+   */
+  void Retx (uint32_t cell);
+  /**
+   * Reception of a value from a neighbour cell.
+   * \param cell the receiving cell
+   * \param value the value
+   */
+  void Rx (uint32_t cell, uint64_t value);
+  /** Sample the state of the cells. */
+  void Sample (void);
+
+  static const uint32_t N_CELLS = 4;   ///< number of cells, contexts 1 to N_CELLS
+  static const uint32_t N_TTIS = 20;   ///< number of TTIs
+
+  std::vector<std::vector<uint64_t> > m_logs;  ///< log of each context
+  std::vector<uint8_t> m_errors;               ///< error flag of each context
+};
+
+CellParallelSimulatorTestCase::CellParallelSimulatorTestCase ()
+  : TestCase ("Check that the parallel cell events give the results of the default simulator")
+{
+}
+
+void
+CellParallelSimulatorTestCase::Tti (uint32_t cell, uint32_t n)
+{
+  if (Simulator::GetContext () != cell)
+    {
+      m_errors[cell] = 1;
+    }
+  m_logs[cell].push_back (Simulator::Now ().GetMicroSeconds () * 10 + 1);
+
+  EventId retx = Simulator::Schedule (MicroSeconds (500), &CellParallelSimulatorTestCase::Retx, this, cell);
+  Simulator::ScheduleNow (&CellParallelSimulatorTestCase::Ack, this, cell, retx);
+  EventId dummy = Simulator::Schedule (MicroSeconds (100), &CellParallelSimulatorTestCase::Retx, this, cell);
+  if (dummy.IsExpired ())
+    {
+      m_errors[cell] = 1;
+    }
+  Simulator::Remove (dummy);
+  if (!dummy.IsExpired ())
+    {
+      m_errors[cell] = 1;
+    }
+
+  for (uint32_t k = 1; k <= 2; k++)
+    {
+      uint32_t neighbour = (cell + k - 1) % N_CELLS + 1;
+      Simulator::ScheduleWithContext (neighbour, Seconds (0), &CellParallelSimulatorTestCase::Rx, this,
+                                      neighbour, cell * 1000 + n);
+    }
+  if (n < N_TTIS)
+    {
+      Simulator::Schedule (MilliSeconds (1), &CellParallelSimulatorTestCase::Tti, this, cell, n + 1);
+    }
+}
+
+void
+CellParallelSimulatorTestCase::Ack (uint32_t cell, EventId retx)
+{
+  if (Simulator::GetContext () != cell || retx.IsExpired ())
+    {
+      m_errors[cell] = 1;
+    }
+  m_logs[cell].push_back (2);
+  Simulator::Cancel (retx);
+  if (!retx.IsExpired ())
+    {
+      m_errors[cell] = 1;
+    }
+}
+
+void
+CellParallelSimulatorTestCase::Retx (uint32_t cell)
+{
+  m_errors[cell] = 1;
+}
+
+void
+CellParallelSimulatorTestCase::Rx (uint32_t cell, uint64_t value)
+{
+  if (Simulator::GetContext () != cell)
+    {
+      m_errors[cell] = 1;
+    }
+  m_logs[cell].push_back (value);
+}
+
+void
+CellParallelSimulatorTestCase::Sample (void)
+{
+  uint64_t sample = 0;
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      sample = sample * 1000 + m_logs[cell].size ();
+    }
+  m_logs[0].push_back (sample);
+  if (Simulator::Now () < MilliSeconds (N_TTIS))
+    {
+      Simulator::Schedule (MilliSeconds (1), &CellParallelSimulatorTestCase::Sample, this);
+    }
+}
+
+std::vector<std::vector<uint64_t> >
+CellParallelSimulatorTestCase::RunScenario (std::string simulatorType, uint32_t threads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::CellParallelSimulatorImpl::Threads", UintegerValue (threads));
+  m_logs.assign (N_CELLS + 1, std::vector<uint64_t> ());
+  m_errors.assign (N_CELLS + 1, 0);
+
+  Ptr<CellParallelSimulatorImpl> impl = DynamicCast<CellParallelSimulatorImpl> (Simulator::GetImplementation ());
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      if (impl != 0)
+        {
+          impl->AddParallelContext (cell);
+        }
+      Simulator::ScheduleWithContext (cell, MilliSeconds (1), &CellParallelSimulatorTestCase::Tti, this, cell, 1);
+    }
+  Simulator::ScheduleWithContext (0, MilliSeconds (1), &CellParallelSimulatorTestCase::Sample, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  for (uint32_t context = 0; context <= N_CELLS; context++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_errors[context], 0, "wrong events in context " << context
+                             << " with " << simulatorType << " on " << threads << " threads");
+    }
+  return m_logs;
+}
+
+void
+CellParallelSimulatorTestCase::DoRun (void)
+{
+  std::vector<std::vector<uint64_t> > reference = RunScenario ("ns3::DefaultSimulatorImpl", 1);
+  std::vector<std::vector<uint64_t> > sequential = RunScenario ("ns3::CellParallelSimulatorImpl", 1);
+  std::vector<std::vector<uint64_t> > parallel = RunScenario ("ns3::CellParallelSimulatorImpl", 4);
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::Reset ();
+
+  // TTI, ack and two receptions per TTI in each cell
+  NS_TEST_ASSERT_MSG_EQ (reference[1].size (), 4 * N_TTIS, "wrong number of events");
+  for (uint32_t context = 0; context <= N_CELLS; context++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((sequential[context] == reference[context]), true,
+                             "different events in context " << context << " on 1 thread");
+      NS_TEST_ASSERT_MSG_EQ ((parallel[context] == reference[context]), true,
+                             "different events in context " << context << " on 4 threads");
+    }
+}
+
+
+/**
+ * Checks the state shared by the cells running in parallel: the reference
+ * counts of a shared object, a shared trace sink, the random stream
+ * indices, and a shared channel which defers the transmissions to the
+ * barrier.
+ */
+class CellParallelSharedStateTestCase : public TestCase
+{
+public:
+  CellParallelSharedStateTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param simulatorType the simulator implementation
+   * \param threads the number of threads of the cell parallel simulator
+   */
+  void RunScenario (std::string simulatorType, uint32_t threads);
+  /**
+   * TTI of a cell.
+   * \param cell the cell
+   * \param n the TTI number
+   */
+  void Tti (uint32_t cell, uint32_t n);
+  /**
+   * Transmission on the shared channel, deferred to the barrier in a batch.
+   * \param cell the transmitting cell
+   * \param n the TTI number
+   */
+  void Transmit (uint32_t cell, uint32_t n);
+  /**
+   * Reception from the shared channel.
+   * \param cell the receiving cell
+   * \param value the value
+   */
+  void Rx (uint32_t cell, uint64_t value);
+  /**
+   * Sink of the shared trace.
+   * \param value the traced value
+   */
+  void TraceSink (uint32_t value);
+
+  static const uint32_t N_CELLS = 8;      ///< number of cells, contexts 1 to N_CELLS
+  static const uint32_t N_TTIS = 50;      ///< number of TTIs
+  static const uint32_t N_COPIES = 1000;  ///< copies of the shared object per TTI
+  static const uint32_t N_TRACES = 100;   ///< traces per TTI
+
+  Ptr<Object> m_shared;                       ///< object shared by the cells
+  TracedCallback<uint32_t> m_trace;           ///< trace shared by the cells
+  uint64_t m_traceCount;                      ///< number of traced values
+  std::vector<std::vector<uint64_t> > m_streams;  ///< stream indices taken by each cell
+  std::vector<uint64_t> m_channelLog;         ///< transmissions, in channel order
+  std::vector<std::vector<uint64_t> > m_logs; ///< receptions of each cell
+  std::vector<uint8_t> m_errors;              ///< error flag of each cell
+};
+
+CellParallelSharedStateTestCase::CellParallelSharedStateTestCase ()
+  : TestCase ("Check the state shared by the parallel cells")
+{
+}
+
+void
+CellParallelSharedStateTestCase::Tti (uint32_t cell, uint32_t n)
+{
+  std::vector<Ptr<Object> > copies;
+  for (uint32_t i = 0; i < N_COPIES; i++)
+    {
+      copies.push_back (m_shared);
+    }
+  copies.clear ();
+  for (uint32_t i = 0; i < N_TRACES; i++)
+    {
+      m_trace (cell);
+    }
+  m_streams[cell].push_back (RngSeedManager::GetNextStreamIndex ());
+
+  Transmit (cell, n);
+  if (n < N_TTIS)
+    {
+      Simulator::Schedule (MilliSeconds (1), &CellParallelSharedStateTestCase::Tti, this, cell, n + 1);
+    }
+}
+
+void
+CellParallelSharedStateTestCase::Transmit (uint32_t cell, uint32_t n)
+{
+  if (CellParallelBatch::IsRunning ())
+    {
+      CellParallelBatch::ScheduleAtBarrier (MakeEvent (&CellParallelSharedStateTestCase::Transmit, this, cell, n));
+      return;
+    }
+  if (Simulator::GetContext () != cell || Simulator::Now () != MilliSeconds (n))
+    {
+      m_errors[cell] = 1;
+    }
+  m_channelLog.push_back (cell * 1000 + n);
+  for (uint32_t neighbour = 1; neighbour <= N_CELLS; neighbour++)
+    {
+      if (neighbour != cell)
+        {
+          Simulator::ScheduleWithContext (neighbour, MicroSeconds (10), &CellParallelSharedStateTestCase::Rx, this,
+                                          neighbour, cell * 1000 + n);
+        }
+    }
+}
+
+void
+CellParallelSharedStateTestCase::Rx (uint32_t cell, uint64_t value)
+{
+  if (Simulator::GetContext () != cell)
+    {
+      m_errors[cell] = 1;
+    }
+  m_logs[cell].push_back (value);
+}
+
+void
+CellParallelSharedStateTestCase::TraceSink (uint32_t value)
+{
+  m_traceCount++;
+}
+
+void
+CellParallelSharedStateTestCase::RunScenario (std::string simulatorType, uint32_t threads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (simulatorType));
+  Config::SetDefault ("ns3::CellParallelSimulatorImpl::Threads", UintegerValue (threads));
+  m_shared = CreateObject<Object> ();
+  m_traceCount = 0;
+  m_streams.assign (N_CELLS + 1, std::vector<uint64_t> ());
+  m_channelLog.clear ();
+  m_logs.assign (N_CELLS + 1, std::vector<uint64_t> ());
+  m_errors.assign (N_CELLS + 1, 0);
+
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      CellParallelBatch::AddParallelContext (cell);
+      Simulator::ScheduleWithContext (cell, MilliSeconds (1), &CellParallelSharedStateTestCase::Tti, this, cell, 1);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::string run = simulatorType + " on " + std::to_string (threads) + " threads";
+  NS_TEST_EXPECT_MSG_EQ (m_shared->GetReferenceCount (), 1, "wrong reference count with " << run);
+  NS_TEST_EXPECT_MSG_EQ (m_traceCount, N_CELLS * N_TTIS * N_TRACES, "lost traces with " << run);
+  std::set<uint64_t> streams;
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_errors[cell], 0, "wrong events in cell " << cell << " with " << run);
+      streams.insert (m_streams[cell].begin (), m_streams[cell].end ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (streams.size (), N_CELLS * N_TTIS, "stream index taken twice with " << run);
+  m_shared = 0;
+}
+
+void
+CellParallelSharedStateTestCase::DoRun (void)
+{
+  m_trace.ConnectWithoutContext (MakeCallback (&CellParallelSharedStateTestCase::TraceSink, this));
+
+  RunScenario ("ns3::DefaultSimulatorImpl", 1);
+  std::vector<uint64_t> referenceChannel = m_channelLog;
+  std::vector<std::vector<uint64_t> > reference = m_logs;
+
+  RunScenario ("ns3::CellParallelSimulatorImpl", 4);
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::Reset ();
+
+  NS_TEST_ASSERT_MSG_EQ (referenceChannel.size (), N_CELLS * N_TTIS, "wrong number of transmissions");
+  NS_TEST_ASSERT_MSG_EQ ((m_channelLog == referenceChannel), true, "different order on the channel");
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((m_logs[cell] == reference[cell]), true,
+                             "different receptions in cell " << cell);
+    }
+}
+
+
+/**
+ * Checks that the numbers taken by the parallel cells, the streams of the
+ * random variables they create and the uids of the packets they send, do
+ * not depend on the number of threads. The cells create different numbers
+ * of random variables and take different numbers of uids from a counter
+ * numbering them as Packet does.
+ */
+class CellParallelNumberingTestCase : public TestCase
+{
+public:
+  CellParallelNumberingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param threads the number of threads of the cell parallel simulator
+   * \return the log of each cell
+   */
+  std::vector<std::vector<uint64_t> > RunScenario (uint32_t threads);
+  /**
+   * TTI of a cell.
+   * \param cell the cell
+   * \param n the TTI number
+   */
+  void Tti (uint32_t cell, uint32_t n);
+
+  static const uint32_t N_CELLS = 6;      ///< number of cells, contexts 1 to N_CELLS
+  static const uint32_t N_TTIS = 20;      ///< number of TTIs
+
+  CellParallelBatch::Counter m_uids;          ///< uids of the packets
+  std::vector<std::vector<uint64_t> > m_logs; ///< values and uids taken by each cell
+};
+
+CellParallelNumberingTestCase::CellParallelNumberingTestCase ()
+  : TestCase ("Check that the random streams and the packet uids do not depend on the threads")
+{
+}
+
+void
+CellParallelNumberingTestCase::Tti (uint32_t cell, uint32_t n)
+{
+  for (uint32_t i = 0; i < cell % 3 + 1; i++)
+    {
+      Ptr<UniformRandomVariable> variable = CreateObject<UniformRandomVariable> ();
+      m_logs[cell].push_back (variable->GetInteger (0, 1000000));
+    }
+  for (uint32_t i = 0; i < (cell + n) % 4; i++)
+    {
+      m_logs[cell].push_back (m_uids.Next ());
+    }
+  if (n < N_TTIS)
+    {
+      Simulator::Schedule (MilliSeconds (1), &CellParallelNumberingTestCase::Tti, this, cell, n + 1);
+    }
+}
+
+std::vector<std::vector<uint64_t> >
+CellParallelNumberingTestCase::RunScenario (uint32_t threads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::CellParallelSimulatorImpl"));
+  Config::SetDefault ("ns3::CellParallelSimulatorImpl::Threads", UintegerValue (threads));
+  RngSeedManager::ResetNextStreamIndex ();
+  m_uids.Reset (0);
+  m_logs.assign (N_CELLS + 1, std::vector<uint64_t> ());
+
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      CellParallelBatch::AddParallelContext (cell);
+      Simulator::ScheduleWithContext (cell, MilliSeconds (1), &CellParallelNumberingTestCase::Tti, this, cell, 1);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the uids taken in a batch are interleaved by cell, and the following
+  // ones do not reuse them
+  std::set<uint64_t> uids;
+  uint32_t count = 0;
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      uint32_t variables = cell % 3 + 1;
+      for (uint32_t n = 1, i = 0; n <= N_TTIS; n++)
+        {
+          i += variables;
+          for (uint32_t k = 0; k < (cell + n) % 4; k++, i++, count++)
+            {
+              uids.insert (m_logs[cell][i]);
+            }
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (uids.size (), count, "uid taken twice on " << threads << " threads");
+  return m_logs;
+}
+
+void
+CellParallelNumberingTestCase::DoRun (void)
+{
+  std::vector<std::vector<uint64_t> > sequential = RunScenario (1);
+  std::vector<std::vector<uint64_t> > parallel3 = RunScenario (3);
+  std::vector<std::vector<uint64_t> > parallel4 = RunScenario (4);
+
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::Reset ();
+
+  for (uint32_t cell = 1; cell <= N_CELLS; cell++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((parallel3[cell] == sequential[cell]), true,
+                             "different numbers in cell " << cell << " on 3 threads");
+      NS_TEST_ASSERT_MSG_EQ ((parallel4[cell] == sequential[cell]), true,
+                             "different numbers in cell " << cell << " on 4 threads");
+    }
+}
+
+
+/**
+ * Test the cell parallel simulator implementation
+ */
+class CellParallelSimulatorTestSuite : public TestSuite
+{
+public:
+  CellParallelSimulatorTestSuite ();
+};
+
+static CellParallelSimulatorTestSuite g_cellParallelSimulatorTestSuite;
+
+CellParallelSimulatorTestSuite::CellParallelSimulatorTestSuite ()
+  : TestSuite ("cell-parallel-simulator", UNIT)
+{
+  AddTestCase (new CellParallelSimulatorTestCase (), TestCase::QUICK);
+  AddTestCase (new CellParallelSharedStateTestCase (), TestCase::QUICK);
+  AddTestCase (new CellParallelNumberingTestCase (), TestCase::QUICK);
+}
@@ -431,6 +431,55 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+// ===========================================================================
+// Test case to make sure that the lookup cache of GetObject follows the
+// aggregation, and that the type hierarchy checks match the parent chain
+// ===========================================================================
+class GetObjectCacheTestCase : public TestCase
+{
+public:
+  GetObjectCacheTestCase ();
+  virtual ~GetObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectCacheTestCase::GetObjectCacheTestCase ()
+  : TestCase ("Check the GetObject lookup cache")
+{
+}
+
+GetObjectCacheTestCase::~GetObjectCacheTestCase ()
+{
+}
+
+void
+GetObjectCacheTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (BaseA::GetTypeId ()), true, "DerivedA is not a BaseA");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (Object::GetTypeId ()), true, "DerivedA is not an Object");
+  NS_TEST_ASSERT_MSG_EQ (BaseA::GetTypeId ().IsChildOf (DerivedA::GetTypeId ()), false, "BaseA is a DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (DerivedA::GetTypeId ().IsChildOf (BaseB::GetTypeId ()), false, "DerivedA is a BaseB");
+  NS_TEST_ASSERT_MSG_EQ (BaseA::GetTypeId ().IsChildOf (BaseA::GetTypeId ()), false, "BaseA is its own child");
+
+  uint64_t calls = Object::GetNGetObjectCalls ();
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+
+  //
+  // The failed lookups are cached too, until the next aggregation
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a cached BaseB");
+  baseA->AggregateObject (derivedB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject for the BaseB part of a DerivedB");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject for the cached BaseB");
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "Cannot GetObject (through derivedB) for BaseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedA> (), 0, "Unexpectedly found a DerivedA");
+  NS_TEST_ASSERT_MSG_EQ (Object::GetNGetObjectCalls () - calls, 6, "Wrong number of GetObject calls");
+}
+
 // ===========================================================================
 // The Test Suite that glues the Test Cases together.
 // ===========================================================================
@@ -446,6 +495,7 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
+  AddTestCase (new GetObjectCacheTestCase, TestCase::QUICK);
 }
 
 static ObjectTestSuite objectTestSuite;
@@ -23,6 +23,9 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/timing-wheel-scheduler.h"
+#include "ns3/uinteger.h"
+#include "ns3/event-impl.h"
 
 using namespace ns3;
 
@@ -131,7 +134,10 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (!a.IsExpired (), true, "");
   Simulator::Cancel (a);
   NS_TEST_EXPECT_MSG_EQ (a.IsExpired (), true, "");
+  uint64_t eventCount = Simulator::GetEventCount ();
   Simulator::Run ();
+  // the cancelled event A is still taken from the list, the removed C is not
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetEventCount () - eventCount, 3, "Wrong number of executed events");
   NS_TEST_EXPECT_MSG_EQ (m_a, true, "Event A did not run ?");
   NS_TEST_EXPECT_MSG_EQ (m_b, true, "Event B did not run ?");
   NS_TEST_EXPECT_MSG_EQ (m_c, true, "Event C did not run ?");
@@ -459,6 +465,43 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+private:
+  virtual void DoRun (void);
+  void Small (void) { m_count++; }
+  void Large (uint64_t, uint64_t, uint64_t, uint64_t, uint64_t) { m_count++; }
+  uint32_t m_count;
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that the events are recycled through the freelists"),
+    m_count (0)
+{
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  EventImpl::AllocationStats start = EventImpl::GetAllocationStats ();
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Small, this);
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Large, this, 1, 2, 3, 4, 5);
+      Simulator::Run ();
+    }
+  Simulator::Destroy ();
+  EventImpl::AllocationStats end = EventImpl::GetAllocationStats ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_count, 200, "events did not run");
+  NS_TEST_EXPECT_MSG_EQ (end.m_allocated - start.m_allocated, 200, "wrong number of allocated events");
+  NS_TEST_EXPECT_MSG_EQ (end.m_freed - start.m_freed, 200, "events not freed");
+  // each round reuses the events of the previous one
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (end.m_recycled - start.m_recycled, 198, "events not recycled");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +518,12 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (TimingWheelScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    // a wheel spanning 64 ns, so that the events go through the overflow map
+    factory.Set ("BucketWidth", TimeValue (NanoSeconds (1)));
+    factory.Set ("Buckets", UintegerValue (64));
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
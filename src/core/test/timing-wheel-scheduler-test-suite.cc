@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/map-scheduler.h"
+#include "ns3/timing-wheel-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Runs the same random sequence of insertions and removals on the map
+ * scheduler and on a small timing wheel scheduler, and checks that they
+ * return the same events.
+ *
+ * The delays mix events scheduled now, periodic events within the span of
+ * the wheel and far events going through the overflow map.
+ */
+class TimingWheelSchedulerTestCase : public TestCase
+{
+public:
+  TimingWheelSchedulerTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+TimingWheelSchedulerTestCase::TimingWheelSchedulerTestCase ()
+  : TestCase ("Check that the timing wheel scheduler orders the events as the map scheduler")
+{
+}
+
+void
+TimingWheelSchedulerTestCase::DoRun (void)
+{
+  Ptr<MapScheduler> reference = CreateObject<MapScheduler> ();
+  ObjectFactory factory;
+  factory.SetTypeId (TimingWheelScheduler::GetTypeId ());
+  factory.Set ("Buckets", UintegerValue (64));
+  factory.Set ("BucketWidth", TimeValue (TimeStep (10)));
+  Ptr<Scheduler> wheel = factory.Create<Scheduler> ();
+
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  rand->SetStream (1);
+  const uint64_t delays[] = { 0, 3, 10, 125, 640, 1000, 10000 };
+  std::vector<Scheduler::Event> pending;
+  uint64_t now = 0;
+  uint32_t uid = 4;
+
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint32_t op = rand->GetInteger (0, 99);
+      if (op < 50 || pending.empty ())
+        {
+          Scheduler::Event ev;
+          ev.key.m_ts = now + delays[rand->GetInteger (0, 6)] + rand->GetInteger (0, 1);
+          ev.key.m_uid = uid;
+          ev.key.m_context = 0;
+          // the schedulers never dereference the event implementation
+          ev.impl = reinterpret_cast<EventImpl *> (8 * (uintptr_t) uid);
+          uid++;
+          reference->Insert (ev);
+          wheel->Insert (ev);
+          pending.push_back (ev);
+        }
+      else if (op < 85)
+        {
+          Scheduler::Event next = reference->PeekNext ();
+          NS_TEST_ASSERT_MSG_EQ (wheel->PeekNext ().key.m_uid, next.key.m_uid, "wrong next event at step " << i);
+          reference->RemoveNext ();
+          Scheduler::Event ev = wheel->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, next.key.m_uid, "wrong removed event at step " << i);
+          NS_TEST_ASSERT_MSG_EQ (ev.impl, next.impl, "wrong event implementation at step " << i);
+          now = ev.key.m_ts;
+          for (uint32_t j = 0; j < pending.size (); j++)
+            {
+              if (pending[j].key.m_uid == ev.key.m_uid)
+                {
+                  pending[j] = pending.back ();
+                  pending.pop_back ();
+                  break;
+                }
+            }
+        }
+      else
+        {
+          uint32_t j = rand->GetInteger (0, pending.size () - 1);
+          reference->Remove (pending[j]);
+          wheel->Remove (pending[j]);
+          pending[j] = pending.back ();
+          pending.pop_back ();
+        }
+      NS_TEST_ASSERT_MSG_EQ (wheel->IsEmpty (), reference->IsEmpty (), "wrong emptiness at step " << i);
+    }
+
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (wheel->RemoveNext ().key.m_uid, reference->RemoveNext ().key.m_uid,
+                             "wrong event when draining");
+    }
+  NS_TEST_ASSERT_MSG_EQ (wheel->IsEmpty (), true, "events left in the wheel");
+}
+
+
+/**
+ * Test the timing wheel scheduler
+ */
+class TimingWheelSchedulerTestSuite : public TestSuite
+{
+public:
+  TimingWheelSchedulerTestSuite ();
+};
+
+static TimingWheelSchedulerTestSuite g_timingWheelSchedulerTestSuite;
+
+TimingWheelSchedulerTestSuite::TimingWheelSchedulerTestSuite ()
+  : TestSuite ("timing-wheel-scheduler", UNIT)
+{
+  AddTestCase (new TimingWheelSchedulerTestCase (), TestCase::QUICK);
+}
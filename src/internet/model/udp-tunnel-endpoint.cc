@@ -0,0 +1,205 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "udp-tunnel-endpoint.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/inet-socket-address.h"
+#include "ipv4.h"
+#include "ipv4-routing-protocol.h"
+#include "ipv4-end-point.h"
+#include "udp-l4-protocol.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("UdpTunnelEndpoint");
+
+NS_OBJECT_ENSURE_REGISTERED (UdpTunnelEndpoint);
+
+UdpTunnelEndpoint::UdpTunnelEndpoint ()
+  : m_port (0),
+    m_endPoint (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+UdpTunnelEndpoint::~UdpTunnelEndpoint ()
+{
+  NS_LOG_FUNCTION (this);
+  DeallocateEndPoint ();
+}
+
+TypeId
+UdpTunnelEndpoint::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::UdpTunnelEndpoint")
+    .SetParent<Object> ()
+    .SetGroupName("Internet")
+    .AddConstructor<UdpTunnelEndpoint> ()
+    .AddAttribute ("FastPath",
+                   "Whether to exchange the tunnel traffic with the UDP protocol directly "
+                   "instead of through the UDP socket",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&UdpTunnelEndpoint::m_fastPath),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Headroom",
+                   "The room reserved at the start of the packets entering the tunnel, "
+                   "for their tunnel, UDP, IP and link headers [bytes]",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&UdpTunnelEndpoint::m_headroom),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+void
+UdpTunnelEndpoint::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_socket != 0)
+    {
+      m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      m_socket = 0;
+    }
+  DeallocateEndPoint ();
+  m_udp = 0;
+  m_node = 0;
+  m_routes.Clear ();
+  m_recvCallback = MakeNullCallback<void, Ptr<Packet> > ();
+  Object::DoDispose ();
+}
+
+void
+UdpTunnelEndpoint::SetSocket (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Address address;
+  socket->GetSockName (address);
+  InetSocketAddress local = InetSocketAddress::ConvertFrom (address);
+  m_port = local.GetPort ();
+  if (!m_fastPath)
+    {
+      m_socket = socket;
+      m_socket->SetRecvCallback (MakeCallback (&UdpTunnelEndpoint::RecvFromSocket, this));
+      return;
+    }
+  // release the port of the socket for the UDP endpoint
+  socket->Close ();
+  m_node = socket->GetNode ();
+  m_udp = m_node->GetObject<UdpL4Protocol> ();
+  m_endPoint = m_udp->Allocate (local.GetIpv4 (), m_port);
+  NS_ASSERT_MSG (m_endPoint != 0, "tunnel port " << m_port << " already in use");
+  m_endPoint->SetRxCallback (MakeCallback (&UdpTunnelEndpoint::RecvFromEndPoint, this));
+  m_endPoint->SetDestroyCallback (MakeCallback (&UdpTunnelEndpoint::Destroy, this));
+}
+
+void
+UdpTunnelEndpoint::SetRecvCallback (Callback<void, Ptr<Packet> > cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_recvCallback = cb;
+}
+
+void
+UdpTunnelEndpoint::Send (Ptr<Packet> packet, const Header &header, Ipv4Address peerAddress)
+{
+  NS_LOG_FUNCTION (this << packet << peerAddress);
+  packet->ReserveHeadroom (m_headroom);
+  packet->AddHeader (header);
+  if (!m_fastPath)
+    {
+      uint32_t flags = 0;
+      m_socket->SendTo (packet, flags, InetSocketAddress (peerAddress, m_port));
+      return;
+    }
+  if (m_endPoint == 0)
+    {
+      NS_LOG_WARN ("UDP endpoint destroyed, discarding packet");
+      return;
+    }
+  Ptr<Ipv4Route> route = GetRoute (packet, peerAddress);
+  if (route == 0)
+    {
+      NS_LOG_WARN ("no route to " << peerAddress << ", discarding packet");
+      return;
+    }
+  Ipv4Address source = m_endPoint->GetLocalAddress ();
+  if (source == Ipv4Address::GetAny ())
+    {
+      source = route->GetSource ();
+    }
+  m_udp->Send (packet, source, peerAddress, m_port, m_port, route);
+}
+
+void
+UdpTunnelEndpoint::RecvFromSocket (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  NS_ASSERT (socket == m_socket);
+  m_recvCallback (socket->Recv ());
+}
+
+void
+UdpTunnelEndpoint::RecvFromEndPoint (Ptr<Packet> packet, Ipv4Header header, uint16_t port, Ptr<Ipv4Interface> incomingInterface)
+{
+  NS_LOG_FUNCTION (this << packet << header.GetSource () << port);
+  // as the UDP socket does
+  SocketPriorityTag priorityTag;
+  packet->RemovePacketTag (priorityTag);
+  m_recvCallback (packet);
+}
+
+Ptr<Ipv4Route>
+UdpTunnelEndpoint::GetRoute (Ptr<Packet> packet, Ipv4Address peerAddress)
+{
+  Ptr<Ipv4Route> *route = m_routes.Find (peerAddress.Get ());
+  if (route != 0)
+    {
+      return *route;
+    }
+  Ipv4Header header;
+  header.SetDestination (peerAddress);
+  header.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  Socket::SocketErrno errno_;
+  Ptr<Ipv4Route> newRoute = m_node->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (packet, header, 0, errno_);
+  if (newRoute != 0)
+    {
+      NS_LOG_LOGIC ("route to " << peerAddress << " through " << newRoute->GetGateway ());
+      m_routes[peerAddress.Get ()] = newRoute;
+    }
+  return newRoute;
+}
+
+void
+UdpTunnelEndpoint::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_endPoint = 0;
+}
+
+void
+UdpTunnelEndpoint::DeallocateEndPoint ()
+{
+  if (m_endPoint != 0)
+    {
+      m_endPoint->SetDestroyCallback (MakeNullCallback<void> ());
+      m_udp->DeAllocate (m_endPoint);
+      m_endPoint = 0;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef UDP_TUNNEL_ENDPOINT_H
+#define UDP_TUNNEL_ENDPOINT_H
+
+#include "ns3/object.h"
+#include "ns3/callback.h"
+#include "ns3/socket.h"
+#include "ns3/node.h"
+#include "ns3/header.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/flat-hash-map.h"
+
+namespace ns3 {
+
+class UdpL4Protocol;
+class Ipv4EndPoint;
+class Ipv4Interface;
+
+/**
+ * \ingroup udp
+ *
+ * UDP endpoint of a tunnel between two nodes, e.g. of the GTP-U tunnels
+ * of the S1-U interface of the EPC or of the N3 interface of the 5G core.
+ * The owner of the endpoint adds the tunnel header, e.g. the GTP-U header,
+ * and removes it from the packets received.
+ *
+ * Each packet entering the tunnel gets the room for its tunnel, UDP, IP
+ * and link headers reserved at once with Packet::ReserveHeadroom, so
+ * that the headers are then written in place instead of reallocating the
+ * buffer for each of them.
+ *
+ * With "FastPath", the endpoint takes over the address and the port of
+ * the UDP socket it is given, and exchanges the tunnel traffic with the
+ * UDP protocol of the node directly: the packets received do not go
+ * through the receive queue of the socket, and the packets sent skip the
+ * socket options and the routing lookup of each packet, the route to
+ * each peer being looked up once and then kept, the network between the
+ * tunnel endpoints being static.
+ */
+class UdpTunnelEndpoint : public Object
+{
+public:
+  UdpTunnelEndpoint ();
+  virtual ~UdpTunnelEndpoint ();
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \param socket UDP socket bound to the tunnel port, closed with
+   * "FastPath" once the endpoint has taken over its address and port
+   */
+  void SetSocket (Ptr<Socket> socket);
+
+  /**
+   * \param cb callback called with each packet coming out of the
+   * tunnel, starting with its tunnel header
+   */
+  void SetRecvCallback (Callback<void, Ptr<Packet> > cb);
+
+  /**
+   * Send a packet through the tunnel
+   *
+   * \param packet the packet
+   * \param header the tunnel header, e.g. the GTP-U header
+   * \param peerAddress the address of the other endpoint
+   */
+  void Send (Ptr<Packet> packet, const Header &header, Ipv4Address peerAddress);
+
+private:
+
+  /**
+   * Receive callback of the socket, without "FastPath"
+   *
+   * \param socket the socket
+   */
+  void RecvFromSocket (Ptr<Socket> socket);
+
+  /**
+   * Receive callback of the UDP endpoint, with "FastPath"
+   *
+   * \param packet the packet, without IP and UDP headers
+   * \param header the IP header of the packet
+   * \param port the source port
+   * \param incomingInterface the interface the packet came from
+   */
+  void RecvFromEndPoint (Ptr<Packet> packet, Ipv4Header header, uint16_t port, Ptr<Ipv4Interface> incomingInterface);
+
+  /**
+   * \param packet the first packet sent to the peer
+   * \param peerAddress the address of the other endpoint
+   * \return the route to the peer, or 0 if there is none
+   */
+  Ptr<Ipv4Route> GetRoute (Ptr<Packet> packet, Ipv4Address peerAddress);
+
+  /**
+   * Called by the UDP protocol when it destroys the UDP endpoint
+   */
+  void Destroy ();
+
+  /**
+   * Release the UDP endpoint
+   */
+  void DeallocateEndPoint ();
+
+  bool m_fastPath;
+  uint32_t m_headroom;
+
+  /**
+   * UDP port of the endpoint and of its peers
+   */
+  uint16_t m_port;
+
+  /**
+   * the socket, without "FastPath"
+   */
+  Ptr<Socket> m_socket;
+
+  /**
+   * the UDP protocol of the node and the UDP endpoint, with "FastPath"
+   */
+  Ptr<Node> m_node;
+  Ptr<UdpL4Protocol> m_udp;
+  Ipv4EndPoint *m_endPoint;
+
+  /**
+   * routes to the peers, keyed by their address as a 32 bit integer
+   */
+  FlatHashMap<Ptr<Ipv4Route> > m_routes;
+
+  Callback<void, Ptr<Packet> > m_recvCallback;
+};
+
+} // namespace ns3
+
+#endif /* UDP_TUNNEL_ENDPOINT_H */
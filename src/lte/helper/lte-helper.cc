@@ -61,6 +61,7 @@
 #include <ns3/buildings-propagation-loss-model.h>
 #include <ns3/lte-spectrum-value-helper.h>
 #include <ns3/epc-x2.h>
+#include <ns3/cell-parallel-batch.h>
 
 namespace ns3 {
 
@@ -200,6 +201,18 @@ TypeId LteHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&LteHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("BasicCellId",
+                   "The cell id of the next eNB is this value plus one. "
+                   "The ranks of a distributed simulation use it to number their cells apart.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LteHelper::m_cellIdCounter),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("BasicImsi",
+                   "The IMSI of the next UE is this value plus one. "
+                   "The ranks of a distributed simulation use it to number their UEs apart.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LteHelper::m_imsiCounter),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
@@ -389,6 +402,7 @@ LteHelper::InstallEnbDevice (NodeContainer c)
       Ptr<Node> node = *i;
       Ptr<NetDevice> device = InstallSingleEnbDevice (node);
       devices.Add (device);
+      CellParallelBatch::AddParallelContext (node->GetId ());
     }
   return devices;
 }
@@ -44,6 +44,8 @@
 #include <ns3/lte-ue-net-device.h>
 #include <ns3/epc-mme-application.h>
 #include <ns3/epc-ue-nas.h>
+#include <ns3/simple-net-device.h>
+#include <ns3/abort.h>
 
 namespace ns3 {
 
@@ -204,56 +206,17 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
 
   NS_ASSERT (enb == lteEnbNetDevice->GetNode ());
 
-  // add an IPv4 stack to the previously created eNB
-  InternetStackHelper internet;
-  internet.Install (enb);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after node creation: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
-
-  // create a point to point link between the new eNB and the SGW with
-  // the corresponding new NetDevices on each side  
-  NodeContainer enbSgwNodes;
-  enbSgwNodes.Add (m_sgwPgw);
-  enbSgwNodes.Add (enb);
-  PointToPointHelper p2ph;
-  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_s1uLinkDataRate));
-  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_s1uLinkMtu));
-  p2ph.SetChannelAttribute ("Delay", TimeValue (m_s1uLinkDelay));  
-  NetDeviceContainer enbSgwDevices = p2ph.Install (enb, m_sgwPgw);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
-  Ptr<NetDevice> enbDev = enbSgwDevices.Get (0);
-  Ptr<NetDevice> sgwDev = enbSgwDevices.Get (1);
-  m_s1uIpv4AddressHelper.NewNetwork ();
-  Ipv4InterfaceContainer enbSgwIpIfaces = m_s1uIpv4AddressHelper.Assign (enbSgwDevices);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to S1 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
-  
-  Ipv4Address enbAddress = enbSgwIpIfaces.GetAddress (0);
-  Ipv4Address sgwAddress = enbSgwIpIfaces.GetAddress (1);
+  Ipv4Address enbAddress;
+  Ipv4Address sgwAddress;
+  Ipv4Address mme_enbAddress;
+  Ipv4Address mmeAddress;
+  ConnectEnbToCore (enb, cellId, enbAddress, sgwAddress, mme_enbAddress, mmeAddress);
 
   // create S1-U socket for the ENB
   Ptr<Socket> enbS1uSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::UdpSocketFactory"));
   int retval = enbS1uSocket->Bind (InetSocketAddress (enbAddress, m_gtpuUdpPort));
   NS_ASSERT (retval == 0);
 
-
-  // create a point to point link between the new eNB and the MME with
-  // the corresponding new NetDevices on each side
-  NodeContainer enbMmeNodes;
-  enbMmeNodes.Add (m_mmeNode);
-  enbMmeNodes.Add (enb);
-  PointToPointHelper p2ph_mme;
-  p2ph_mme.SetDeviceAttribute ("DataRate", DataRateValue (m_s1apLinkDataRate));
-  p2ph_mme.SetDeviceAttribute ("Mtu", UintegerValue (m_s1apLinkMtu));
-  p2ph_mme.SetChannelAttribute ("Delay", TimeValue (m_s1apLinkDelay));  
-  NetDeviceContainer enbMmeDevices = p2ph_mme.Install (enb, m_mmeNode);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
-
-  m_s1apIpv4AddressHelper.NewNetwork ();
-  Ipv4InterfaceContainer enbMmeIpIfaces = m_s1apIpv4AddressHelper.Assign (enbMmeDevices);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to S1 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
-  
-  Ipv4Address mme_enbAddress = enbMmeIpIfaces.GetAddress (0);
-  Ipv4Address mmeAddress = enbMmeIpIfaces.GetAddress (1);
-
   // create S1-AP socket for the ENB
   Ptr<Socket> enbS1apSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::UdpSocketFactory"));
   retval = enbS1apSocket->Bind (InetSocketAddress (mme_enbAddress, m_s1apUdpPort));
@@ -297,6 +260,73 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
   enb->AggregateObject(s1apEnb);
   enbApp->SetS1apSapMme (s1apEnb->GetEpcS1apSapEnbProvider ());
   s1apEnb->SetEpcS1apSapEnbUser (enbApp->GetS1apSapEnb());
+}
+
+void
+PointToPointEpcHelper::AddRemoteEnb (Ptr<Node> enb, uint16_t cellId)
+{
+  NS_LOG_FUNCTION (this << enb << cellId);
+  NS_ABORT_MSG_IF (m_s1uLinkDelay.IsZero () || m_s1apLinkDelay.IsZero (),
+                   "the S1 links of a remote eNB need a delay, which is the lookahead of the ranks");
+
+  // the owner rank adds the LteEnbNetDevice before calling AddEnb
+  enb->AddDevice (CreateObject<SimpleNetDevice> ());
+  m_remoteEnbCellIds[enb->GetId ()] = cellId;
+
+  Ipv4Address enbAddress;
+  Ipv4Address sgwAddress;
+  Ipv4Address mme_enbAddress;
+  Ipv4Address mmeAddress;
+  ConnectEnbToCore (enb, cellId, enbAddress, sgwAddress, mme_enbAddress, mmeAddress);
+}
+
+void
+PointToPointEpcHelper::ConnectEnbToCore (Ptr<Node> enb, uint16_t cellId,
+                                         Ipv4Address &enbAddress, Ipv4Address &sgwAddress,
+                                         Ipv4Address &mme_enbAddress, Ipv4Address &mmeAddress)
+{
+  // add an IPv4 stack to the previously created eNB
+  InternetStackHelper internet;
+  internet.Install (enb);
+  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after node creation: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+
+  // create a point to point link between the new eNB and the SGW with
+  // the corresponding new NetDevices on each side  
+  NodeContainer enbSgwNodes;
+  enbSgwNodes.Add (m_sgwPgw);
+  enbSgwNodes.Add (enb);
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_s1uLinkDataRate));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_s1uLinkMtu));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (m_s1uLinkDelay));  
+  NetDeviceContainer enbSgwDevices = p2ph.Install (enb, m_sgwPgw);
+  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
+  m_s1uIpv4AddressHelper.NewNetwork ();
+  Ipv4InterfaceContainer enbSgwIpIfaces = m_s1uIpv4AddressHelper.Assign (enbSgwDevices);
+  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to S1 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+  
+  enbAddress = enbSgwIpIfaces.GetAddress (0);
+  sgwAddress = enbSgwIpIfaces.GetAddress (1);
+
+  // create a point to point link between the new eNB and the MME with
+  // the corresponding new NetDevices on each side
+  NodeContainer enbMmeNodes;
+  enbMmeNodes.Add (m_mmeNode);
+  enbMmeNodes.Add (enb);
+  PointToPointHelper p2ph_mme;
+  p2ph_mme.SetDeviceAttribute ("DataRate", DataRateValue (m_s1apLinkDataRate));
+  p2ph_mme.SetDeviceAttribute ("Mtu", UintegerValue (m_s1apLinkMtu));
+  p2ph_mme.SetChannelAttribute ("Delay", TimeValue (m_s1apLinkDelay));  
+  NetDeviceContainer enbMmeDevices = p2ph_mme.Install (enb, m_mmeNode);
+  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
+
+  m_s1apIpv4AddressHelper.NewNetwork ();
+  Ipv4InterfaceContainer enbMmeIpIfaces = m_s1apIpv4AddressHelper.Assign (enbMmeDevices);
+  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to S1 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+  
+  mme_enbAddress = enbMmeIpIfaces.GetAddress (0);
+  mmeAddress = enbMmeIpIfaces.GetAddress (1);
+
   m_mmeApp->AddEnb (cellId, mme_enbAddress); // TODO consider if this can be removed
   // add the interface to the S1AP endpoint on the MME
   Ptr<EpcS1apMme> s1apMme = m_mmeNode->GetObject<EpcS1apMme> ();
@@ -334,22 +364,44 @@ PointToPointEpcHelper::AddX2Interface (Ptr<Node> enb1, Ptr<Node> enb2)
   Ipv4Address enb1X2Address = enbIpIfaces.GetAddress (0);
   Ipv4Address enb2X2Address = enbIpIfaces.GetAddress (1);
 
-  // Add X2 interface to both eNBs' X2 entities
-  Ptr<EpcX2> enb1X2 = enb1->GetObject<EpcX2> ();
-  Ptr<LteEnbNetDevice> enb1LteDev = enb1->GetDevice (0)->GetObject<LteEnbNetDevice> ();
-  uint16_t enb1CellId = enb1LteDev->GetCellId ();
+  // Add X2 interface to the X2 entities of the eNBs simulated by this rank
+  std::map<uint32_t, uint16_t>::const_iterator remote1 = m_remoteEnbCellIds.find (enb1->GetId ());
+  std::map<uint32_t, uint16_t>::const_iterator remote2 = m_remoteEnbCellIds.find (enb2->GetId ());
+  Ptr<LteEnbNetDevice> enb1LteDev;
+  Ptr<LteEnbNetDevice> enb2LteDev;
+  uint16_t enb1CellId;
+  uint16_t enb2CellId;
+  if (remote1 == m_remoteEnbCellIds.end ())
+    {
+      enb1LteDev = enb1->GetDevice (0)->GetObject<LteEnbNetDevice> ();
+      enb1CellId = enb1LteDev->GetCellId ();
+    }
+  else
+    {
+      enb1CellId = remote1->second;
+    }
   NS_LOG_LOGIC ("LteEnbNetDevice #1 = " << enb1LteDev << " - CellId = " << enb1CellId);
-
-  Ptr<EpcX2> enb2X2 = enb2->GetObject<EpcX2> ();
-  Ptr<LteEnbNetDevice> enb2LteDev = enb2->GetDevice (0)->GetObject<LteEnbNetDevice> ();
-  uint16_t enb2CellId = enb2LteDev->GetCellId ();
+  if (remote2 == m_remoteEnbCellIds.end ())
+    {
+      enb2LteDev = enb2->GetDevice (0)->GetObject<LteEnbNetDevice> ();
+      enb2CellId = enb2LteDev->GetCellId ();
+    }
+  else
+    {
+      enb2CellId = remote2->second;
+    }
   NS_LOG_LOGIC ("LteEnbNetDevice #2 = " << enb2LteDev << " - CellId = " << enb2CellId);
 
-  enb1X2->AddX2Interface (enb1CellId, enb1X2Address, enb2CellId, enb2X2Address);
-  enb2X2->AddX2Interface (enb2CellId, enb2X2Address, enb1CellId, enb1X2Address);
-
-  enb1LteDev->GetRrc ()->AddX2Neighbour (enb2LteDev->GetCellId ());
-  enb2LteDev->GetRrc ()->AddX2Neighbour (enb1LteDev->GetCellId ());
+  if (enb1LteDev != 0)
+    {
+      enb1->GetObject<EpcX2> ()->AddX2Interface (enb1CellId, enb1X2Address, enb2CellId, enb2X2Address);
+      enb1LteDev->GetRrc ()->AddX2Neighbour (enb2CellId);
+    }
+  if (enb2LteDev != 0)
+    {
+      enb2->GetObject<EpcX2> ()->AddX2Interface (enb2CellId, enb2X2Address, enb1CellId, enb1X2Address);
+      enb2LteDev->GetRrc ()->AddX2Neighbour (enb1CellId);
+    }
 }
 
 
@@ -437,6 +489,28 @@ PointToPointEpcHelper::AssignUeIpv4Address (NetDeviceContainer ueDevices)
 
 
 
+Ipv4Address
+PointToPointEpcHelper::AssignRemoteUeIpv4Address ()
+{
+  return m_ueAddressHelper.NewAddress ();
+}
+
+void
+PointToPointEpcHelper::AddRemoteUe (uint64_t imsi, Ipv4Address ueAddress)
+{
+  NS_LOG_FUNCTION (this << imsi << ueAddress);
+  m_mmeApp->AddUe (imsi);
+  m_sgwPgwApp->AddUe (imsi);
+  m_sgwPgwApp->SetUeAddress (imsi, ueAddress);
+}
+
+uint8_t
+PointToPointEpcHelper::ActivateRemoteEpsBearer (uint64_t imsi, Ptr<EpcTft> tft, EpsBearer bearer)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  return m_mmeApp->AddBearer (imsi, tft, bearer);
+}
+
 Ipv4Address
 PointToPointEpcHelper::GetUeDefaultGatewayAddress ()
 {
@@ -55,6 +55,18 @@ class EpcS1apMme;
  * single node that implements both the SGW and PGW functionality, and
  * an MME node. The S1-U, S1-AP, X2-U and X2-C interfaces are realized over
  * PointToPoint links. 
+ *
+ * The topology can be split across the ranks of a distributed (MPI)
+ * simulation. The SGW/PGW and MME nodes, which are coupled through the
+ * S11 SAP, stay on rank 0 and each rank simulates a cluster of eNBs and
+ * UEs with its own LteHelper, i.e. its own channel. Every rank builds
+ * the whole topology in the same order: the eNBs and UEs of the other
+ * ranks are added with AddRemoteEnb(), AddRemoteUe() and
+ * ActivateRemoteEpsBearer(), so that the nodes, the devices and the
+ * addresses are the same in every rank. The S1 and X2 links between two
+ * ranks become remote point-to-point channels carrying the GTP-U tunnels,
+ * and their delays give the lookahead of the distributed simulator, so
+ * they must not be zero.
  */
 class PointToPointEpcHelper : public EpcHelper
 {
@@ -89,10 +101,66 @@ public:
   virtual Ipv4InterfaceContainer AssignUeIpv4Address (NetDeviceContainer ueDevices);
   virtual Ipv4Address GetUeDefaultGatewayAddress ();
 
+  /**
+   * Add an eNB simulated by another rank of a distributed simulation:
+   * build the same S1-U and S1-AP links and register the cell in the
+   * SGW/PGW and in the MME as AddEnb() does, without the eNB applications.
+   * A placeholder device stands for the LteEnbNetDevice, so that the
+   * devices of the links get the indices they have in the other rank.
+   *
+   * \param enbNode the eNB node, owned by another rank
+   * \param cellId the cell id the other rank gives to the eNB
+   */
+  void AddRemoteEnb (Ptr<Node> enbNode, uint16_t cellId);
 
+  /**
+   * Take the address that AssignUeIpv4Address() gives to a UE simulated
+   * by another rank.
+   *
+   * \return the address of the UE
+   */
+  Ipv4Address AssignRemoteUeIpv4Address ();
+
+  /**
+   * Register in the SGW/PGW and in the MME a UE simulated by another rank.
+   *
+   * \param imsi the IMSI the other rank gives to the UE
+   * \param ueAddress the address of the UE
+   */
+  void AddRemoteUe (uint64_t imsi, Ipv4Address ueAddress);
+
+  /**
+   * Add to the MME an EPS bearer of a UE simulated by another rank.
+   *
+   * \param imsi the IMSI of the UE
+   * \param tft the Traffic Flow Template of the bearer
+   * \param bearer the characteristics of the bearer
+   * \return bearer ID
+   */
+  uint8_t ActivateRemoteEpsBearer (uint64_t imsi, Ptr<EpcTft> tft, EpsBearer bearer);
 
 private:
 
+  /**
+   * Install the internet stack on an eNB, connect it to the SGW/PGW and to
+   * the MME and register the cell in both.
+   *
+   * \param enb the eNB node
+   * \param cellId the cell id
+   * \param enbS1uAddress the S1-U address of the eNB
+   * \param sgwS1uAddress the S1-U address of the SGW
+   * \param enbS1apAddress the S1-AP address of the eNB
+   * \param mmeS1apAddress the S1-AP address of the MME
+   */
+  void ConnectEnbToCore (Ptr<Node> enb, uint16_t cellId,
+                         Ipv4Address &enbS1uAddress, Ipv4Address &sgwS1uAddress,
+                         Ipv4Address &enbS1apAddress, Ipv4Address &mmeS1apAddress);
+
+  /**
+   * Cell id of the eNBs simulated by another rank, by node id
+   */
+  std::map<uint32_t, uint16_t> m_remoteEnbCellIds;
+
   /** 
    * helper to assign addresses to UE devices as well as to the TUN device of the SGW/PGW
    */
@@ -0,0 +1,275 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "assistant-info-reporter.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/enum.h>
+#include <ns3/uinteger.h>
+#include <ns3/trace-source-accessor.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AssistantInfoReporter");
+
+NS_OBJECT_ENSURE_REGISTERED (AssistantInfoReporter);
+
+AssistantInfoReporter::AssistantInfoReporter ()
+  : m_running (false),
+    m_firstTrigger (Seconds (0)),
+    m_lastReportTime (Seconds (0)),
+    m_reported (false),
+    m_lastQueueSize (0),
+    m_lastSeenQueueSize (0),
+    m_drainedSinceReport (0),
+    m_reportsSent (0),
+    m_triggersCoalesced (0),
+    m_totalLag (Seconds (0))
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AssistantInfoReporter::~AssistantInfoReporter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+AssistantInfoReporter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AssistantInfoReporter")
+    .SetParent<Object> ()
+    .SetGroupName("Lte")
+    .AddConstructor<AssistantInfoReporter> ()
+    .AddAttribute ("Mode",
+                   "When the assistant information is reported",
+                   EnumValue (AssistantInfoReporter::PERIODIC),
+                   MakeEnumAccessor (&AssistantInfoReporter::m_mode),
+                   MakeEnumChecker (AssistantInfoReporter::PERIODIC, "Periodic",
+                                    AssistantInfoReporter::THRESHOLD, "Threshold",
+                                    AssistantInfoReporter::CREDIT, "Credit"))
+    .AddAttribute ("Period",
+                   "Reporting period in the Periodic mode, longest time without "
+                   "a report in the other modes (0 means no limit)",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&AssistantInfoReporter::m_period),
+                   MakeTimeChecker ())
+    .AddAttribute ("QueueDelta",
+                   "Change of the queue (Threshold mode) or of the desired buffer "
+                   "size (Credit mode) that triggers a report, in bytes",
+                   UintegerValue (10000),
+                   MakeUintegerAccessor (&AssistantInfoReporter::m_queueDelta),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("TargetBuffer",
+                   "Bytes the RLC wants to have queued, used in the Credit mode to "
+                   "compute the desired buffer size",
+                   UintegerValue (100000),
+                   MakeUintegerAccessor (&AssistantInfoReporter::m_targetBuffer),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MinInterval",
+                   "Minimum time between two reports; triggers inside this "
+                   "interval are coalesced",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&AssistantInfoReporter::m_minInterval),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Report",
+                     "An assistant information report has been sent.",
+                     MakeTraceSourceAccessor (&AssistantInfoReporter::m_reportTrace),
+                     "ns3::AssistantInfoReporter::ReportTracedCallback")
+    ;
+  return tid;
+}
+
+void
+AssistantInfoReporter::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  m_snapshot = MakeNullCallback<EpcX2Sap::AssistantInformationForSplitting> ();
+  m_send = MakeNullCallback<void, EpcX2Sap::AssistantInformationForSplitting> ();
+  Object::DoDispose ();
+}
+
+void
+AssistantInfoReporter::SetSnapshotCallback (Callback<EpcX2Sap::AssistantInformationForSplitting> cb)
+{
+  m_snapshot = cb;
+}
+
+void
+AssistantInfoReporter::SetSendCallback (Callback<void, EpcX2Sap::AssistantInformationForSplitting> cb)
+{
+  m_send = cb;
+}
+
+void
+AssistantInfoReporter::Start (Time delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT_MSG (!m_snapshot.IsNull () && !m_send.IsNull (), "callbacks not set");
+  m_running = true;
+  m_periodTimer.Cancel ();
+  m_periodTimer = Simulator::Schedule (delay, &AssistantInfoReporter::ExpirePeriodTimer, this);
+}
+
+void
+AssistantInfoReporter::Stop ()
+{
+  NS_LOG_FUNCTION (this);
+  m_running = false;
+  m_periodTimer.Cancel ();
+  m_pendingReport.Cancel ();
+}
+
+bool
+AssistantInfoReporter::IsRunning () const
+{
+  return m_running;
+}
+
+void
+AssistantInfoReporter::NotifyQueueUpdate ()
+{
+  if (!m_running || m_mode == PERIODIC)
+    {
+      return;
+    }
+  EpcX2Sap::AssistantInformationForSplitting info = m_snapshot ();
+  if (info.Tx_On_Q_Size < m_lastSeenQueueSize)
+    {
+      m_drainedSinceReport += m_lastSeenQueueSize - info.Tx_On_Q_Size;
+    }
+  m_lastSeenQueueSize = info.Tx_On_Q_Size;
+  if (!m_reported)
+    {
+      return;
+    }
+  if (m_pendingReport.IsRunning ())
+    {
+      ++m_triggersCoalesced;
+      return;
+    }
+  if (IsTriggered (info))
+    {
+      Trigger ();
+    }
+}
+
+bool
+AssistantInfoReporter::IsTriggered (const EpcX2Sap::AssistantInformationForSplitting &info) const
+{
+  uint32_t queue = info.Tx_On_Q_Size;
+  if (m_mode == THRESHOLD)
+    {
+      uint32_t delta = (queue > m_lastQueueSize) ? queue - m_lastQueueSize : m_lastQueueSize - queue;
+      return delta >= m_queueDelta;
+    }
+  else if (m_mode == CREDIT)
+    {
+      uint32_t desired = (m_targetBuffer > queue) ? m_targetBuffer - queue : 0;
+      return desired >= m_queueDelta && m_drainedSinceReport >= m_queueDelta;
+    }
+  return false;
+}
+
+void
+AssistantInfoReporter::Trigger ()
+{
+  if (m_pendingReport.IsRunning ())
+    {
+      ++m_triggersCoalesced;
+      return;
+    }
+  Time now = Simulator::Now ();
+  m_firstTrigger = now;
+  Time earliest = m_lastReportTime + m_minInterval;
+  if (!m_reported || now >= earliest)
+    {
+      SendReport ();
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Rate limited, report delayed by " << earliest - now);
+      m_pendingReport = Simulator::Schedule (earliest - now, &AssistantInfoReporter::SendReport, this);
+    }
+}
+
+void
+AssistantInfoReporter::SendReport ()
+{
+  Time now = Simulator::Now ();
+  EpcX2Sap::AssistantInformationForSplitting info = m_snapshot ();
+  if (m_mode == CREDIT)
+    {
+      info.Desired_Buffer_Size = (m_targetBuffer > info.Tx_On_Q_Size) ? m_targetBuffer - info.Tx_On_Q_Size : 0;
+    }
+  info.Report_Time = now.GetNanoSeconds ();
+
+  Time lag = now - m_firstTrigger;
+  ++m_reportsSent;
+  m_totalLag += lag;
+  m_lastReportTime = now;
+  m_reported = true;
+  m_lastQueueSize = info.Tx_On_Q_Size;
+  m_lastSeenQueueSize = info.Tx_On_Q_Size;
+  m_drainedSinceReport = 0;
+  NS_LOG_LOGIC ("Report " << m_reportsSent << " queue " << info.Tx_On_Q_Size
+                << " desired " << info.Desired_Buffer_Size << " lag " << lag);
+
+  m_reportTrace (info, lag.GetNanoSeconds ());
+  m_send (info);
+
+  if (m_mode != PERIODIC && m_period > Seconds (0))
+    {
+      m_periodTimer.Cancel ();
+      m_periodTimer = Simulator::Schedule (m_period, &AssistantInfoReporter::ExpirePeriodTimer, this);
+    }
+}
+
+void
+AssistantInfoReporter::ExpirePeriodTimer ()
+{
+  Trigger ();
+  if (m_mode == PERIODIC && m_period > Seconds (0))
+    {
+      m_periodTimer = Simulator::Schedule (m_period, &AssistantInfoReporter::ExpirePeriodTimer, this);
+    }
+}
+
+uint64_t
+AssistantInfoReporter::GetReportsSent () const
+{
+  return m_reportsSent;
+}
+
+uint64_t
+AssistantInfoReporter::GetTriggersCoalesced () const
+{
+  return m_triggersCoalesced;
+}
+
+Time
+AssistantInfoReporter::GetMeanReportLag () const
+{
+  if (m_reportsSent == 0)
+    {
+      return Seconds (0);
+    }
+  return NanoSeconds (m_totalLag.GetNanoSeconds () / (int64_t) m_reportsSent);
+}
+
+} // namespace ns3
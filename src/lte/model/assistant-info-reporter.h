@@ -0,0 +1,169 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASSISTANT_INFO_REPORTER_H
+#define ASSISTANT_INFO_REPORTER_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/callback.h>
+#include <ns3/traced-callback.h>
+#include <ns3/epc-x2-sap.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Decides when an RLC entity of a split bearer sends its
+ * AssistantInformationForSplitting to the PDCP of the MeNB.
+ *
+ * Three modes are supported:
+ * - PERIODIC: a report every Period;
+ * - THRESHOLD: a report when the queue moved by at least QueueDelta bytes
+ *   since the last report;
+ * - CREDIT: like the 3GPP Downlink Data Delivery Status, every report
+ *   carries the desired buffer size (TargetBuffer minus the queue), and a
+ *   new report is sent when at least QueueDelta bytes have been drained
+ *   since the last report and the desired buffer size is at least
+ *   QueueDelta bytes, i.e., when the RLC is ready for more data.
+ *
+ * In the event driven modes a non zero Period is the longest silence
+ * allowed between two reports. In every mode reports are at least
+ * MinInterval apart: triggers inside that interval are coalesced into a
+ * single report, built when it is actually sent.
+ *
+ * The RLC provides the current state through the snapshot callback and
+ * the report is delivered through the send callback.
+ */
+class AssistantInfoReporter : public Object
+{
+public:
+  enum Mode
+  {
+    PERIODIC,
+    THRESHOLD,
+    CREDIT
+  };
+
+  AssistantInfoReporter ();
+  virtual ~AssistantInfoReporter ();
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * \param cb the callback returning the current state of the RLC
+   */
+  void SetSnapshotCallback (Callback<EpcX2Sap::AssistantInformationForSplitting> cb);
+
+  /**
+   * \param cb the callback delivering a report to the PDCP
+   */
+  void SetSendCallback (Callback<void, EpcX2Sap::AssistantInformationForSplitting> cb);
+
+  /**
+   * Start reporting. The first report is sent after the given delay.
+   *
+   * \param delay the delay of the first report
+   */
+  void Start (Time delay);
+
+  /**
+   * Stop reporting
+   */
+  void Stop ();
+
+  /**
+   * \return true if Start has been called and Stop has not
+   */
+  bool IsRunning () const;
+
+  /**
+   * To be called by the RLC every time its queues change
+   */
+  void NotifyQueueUpdate ();
+
+  /**
+   * \return the number of reports sent
+   */
+  uint64_t GetReportsSent () const;
+
+  /**
+   * \return the number of triggers merged into an already pending report
+   */
+  uint64_t GetTriggersCoalesced () const;
+
+  /**
+   * \return the mean time between the first trigger of a report and its
+   * transmission
+   */
+  Time GetMeanReportLag () const;
+
+  /**
+   * TracedCallback signature for report transmission.
+   *
+   * \param [in] info The report.
+   * \param [in] lag Time since the report was triggered, in ns.
+   */
+  typedef void (* ReportTracedCallback)
+    (EpcX2Sap::AssistantInformationForSplitting info, uint64_t lag);
+
+private:
+  /**
+   * \param info the current state of the RLC
+   * \return true if the state differs enough from the last report
+   */
+  bool IsTriggered (const EpcX2Sap::AssistantInformationForSplitting &info) const;
+
+  /**
+   * Send a report now, or at the end of the MinInterval if the last report
+   * is too recent
+   */
+  void Trigger ();
+
+  void SendReport ();
+  void ExpirePeriodTimer ();
+
+  Mode m_mode;
+  Time m_period;
+  uint32_t m_queueDelta;
+  uint32_t m_targetBuffer;
+  Time m_minInterval;
+
+  Callback<EpcX2Sap::AssistantInformationForSplitting> m_snapshot;
+  Callback<void, EpcX2Sap::AssistantInformationForSplitting> m_send;
+
+  bool m_running;
+  EventId m_periodTimer;
+  EventId m_pendingReport;
+  Time m_firstTrigger;     ///< time of the first trigger of the pending report
+  Time m_lastReportTime;
+  bool m_reported;
+  uint32_t m_lastQueueSize;       ///< queue at the last report
+  uint32_t m_lastSeenQueueSize;   ///< queue at the last update
+  uint32_t m_drainedSinceReport;  ///< bytes drained since the last report
+
+  uint64_t m_reportsSent;
+  uint64_t m_triggersCoalesced;
+  Time m_totalLag;
+
+  TracedCallback<EpcX2Sap::AssistantInformationForSplitting, uint64_t> m_reportTrace;
+};
+
+} // namespace ns3
+
+#endif // ASSISTANT_INFO_REPORTER_H
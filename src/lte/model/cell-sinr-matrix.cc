@@ -0,0 +1,233 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cell-sinr-matrix.h"
+
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CellSinrMatrix");
+
+CellSinrMatrix::CellSinrMatrix ()
+{
+}
+
+void
+CellSinrMatrix::UpdateCell (uint16_t cellId, const std::map<uint64_t, double> &imsiSinrMap)
+{
+  NS_LOG_FUNCTION (this << cellId << imsiSinrMap.size ());
+  uint32_t col = AddCell (cellId);
+
+  // both the report and the rows are sorted by IMSI
+  std::vector<uint64_t> newImsis;
+  std::vector<uint64_t>::const_iterator rowIt = m_imsis.begin ();
+  for (std::map<uint64_t, double>::const_iterator it = imsiSinrMap.begin (); it != imsiSinrMap.end (); ++it)
+    {
+      while (rowIt != m_imsis.end () && *rowIt < it->first)
+        {
+          ++rowIt;
+        }
+      if (rowIt == m_imsis.end () || *rowIt != it->first)
+        {
+          newImsis.push_back (it->first);
+        }
+    }
+  if (!newImsis.empty ())
+    {
+      AddUes (newImsis);
+    }
+
+  uint32_t nCells = m_cellIds.size ();
+  uint32_t row = 0;
+  for (std::map<uint64_t, double>::const_iterator it = imsiSinrMap.begin (); it != imsiSinrMap.end (); ++it)
+    {
+      while (m_imsis[row] < it->first)
+        {
+          ++row;
+        }
+      double &value = m_sinr[row * nCells + col];
+      if (value != it->second)
+        {
+          value = it->second;
+          m_updated[row] = 1;
+        }
+    }
+}
+
+bool
+CellSinrMatrix::HasUe (uint64_t imsi) const
+{
+  return FindRow (imsi) < m_imsis.size ();
+}
+
+double
+CellSinrMatrix::Get (uint64_t imsi, uint16_t cellId) const
+{
+  uint32_t row = FindRow (imsi);
+  uint32_t col = FindCol (cellId);
+  if (row == m_imsis.size () || col == m_cellIds.size ())
+    {
+      return 0;
+    }
+  return GetSinr (row, col);
+}
+
+void
+CellSinrMatrix::Clear ()
+{
+  NS_LOG_FUNCTION (this);
+  m_imsis.clear ();
+  m_cellIds.clear ();
+  m_sinr.clear ();
+  m_updated.clear ();
+}
+
+uint32_t
+CellSinrMatrix::GetNUes () const
+{
+  return m_imsis.size ();
+}
+
+uint32_t
+CellSinrMatrix::GetNCells () const
+{
+  return m_cellIds.size ();
+}
+
+uint64_t
+CellSinrMatrix::GetImsi (uint32_t row) const
+{
+  return m_imsis[row];
+}
+
+uint16_t
+CellSinrMatrix::GetCellId (uint32_t col) const
+{
+  return m_cellIds[col];
+}
+
+bool
+CellSinrMatrix::IsReported (uint32_t row, uint32_t col) const
+{
+  return m_sinr[row * m_cellIds.size () + col] >= 0;
+}
+
+double
+CellSinrMatrix::GetSinr (uint32_t row, uint32_t col) const
+{
+  double value = m_sinr[row * m_cellIds.size () + col];
+  return (value >= 0) ? value : 0;
+}
+
+bool
+CellSinrMatrix::IsUpdated (uint32_t row) const
+{
+  return m_updated[row] != 0;
+}
+
+void
+CellSinrMatrix::ClearUpdated (uint32_t row)
+{
+  m_updated[row] = 0;
+}
+
+uint32_t
+CellSinrMatrix::AddCell (uint16_t cellId)
+{
+  uint32_t col = FindCol (cellId);
+  if (col < m_cellIds.size ())
+    {
+      return col;
+    }
+  NS_LOG_LOGIC ("New cell " << cellId);
+  col = std::lower_bound (m_cellIds.begin (), m_cellIds.end (), cellId) - m_cellIds.begin ();
+  uint32_t oldCells = m_cellIds.size ();
+  std::vector<double> sinr (m_imsis.size () * (oldCells + 1), -1.0);
+  for (uint32_t row = 0; row < m_imsis.size (); ++row)
+    {
+      for (uint32_t c = 0; c < oldCells; ++c)
+        {
+          sinr[row * (oldCells + 1) + c + (c >= col ? 1 : 0)] = m_sinr[row * oldCells + c];
+        }
+    }
+  m_sinr.swap (sinr);
+  m_cellIds.insert (m_cellIds.begin () + col, cellId);
+  return col;
+}
+
+void
+CellSinrMatrix::AddUes (const std::vector<uint64_t> &imsis)
+{
+  NS_LOG_FUNCTION (this << imsis.size ());
+  uint32_t nCells = m_cellIds.size ();
+  std::vector<uint64_t> mergedImsis;
+  std::vector<double> sinr;
+  std::vector<uint8_t> updated;
+  mergedImsis.reserve (m_imsis.size () + imsis.size ());
+  sinr.reserve ((m_imsis.size () + imsis.size ()) * nCells);
+  updated.reserve (m_imsis.size () + imsis.size ());
+
+  uint32_t row = 0;
+  std::vector<uint64_t>::const_iterator newIt = imsis.begin ();
+  while (row < m_imsis.size () || newIt != imsis.end ())
+    {
+      if (newIt == imsis.end () || (row < m_imsis.size () && m_imsis[row] < *newIt))
+        {
+          mergedImsis.push_back (m_imsis[row]);
+          sinr.insert (sinr.end (), m_sinr.begin () + row * nCells, m_sinr.begin () + (row + 1) * nCells);
+          updated.push_back (m_updated[row]);
+          ++row;
+        }
+      else
+        {
+          NS_ASSERT (row == m_imsis.size () || m_imsis[row] != *newIt);
+          mergedImsis.push_back (*newIt);
+          sinr.insert (sinr.end (), nCells, -1.0);
+          updated.push_back (1);
+          ++newIt;
+        }
+    }
+  m_imsis.swap (mergedImsis);
+  m_sinr.swap (sinr);
+  m_updated.swap (updated);
+}
+
+uint32_t
+CellSinrMatrix::FindRow (uint64_t imsi) const
+{
+  std::vector<uint64_t>::const_iterator it = std::lower_bound (m_imsis.begin (), m_imsis.end (), imsi);
+  if (it != m_imsis.end () && *it == imsi)
+    {
+      return it - m_imsis.begin ();
+    }
+  return m_imsis.size ();
+}
+
+uint32_t
+CellSinrMatrix::FindCol (uint16_t cellId) const
+{
+  std::vector<uint16_t>::const_iterator it = std::lower_bound (m_cellIds.begin (), m_cellIds.end (), cellId);
+  if (it != m_cellIds.end () && *it == cellId)
+    {
+      return it - m_cellIds.begin ();
+    }
+  return m_cellIds.size ();
+}
+
+} // namespace ns3
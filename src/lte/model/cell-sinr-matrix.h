@@ -0,0 +1,136 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CELL_SINR_MATRIX_H
+#define CELL_SINR_MATRIX_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * SINR of the UEs in the mmWave cells, as reported to the coordinator eNB.
+ *
+ * Rows are UEs sorted by IMSI, columns are cells sorted by cell ID, and the
+ * values are stored row by row in a single array. The report of a cell is
+ * merged into its column with a single pass over the rows. Every row has
+ * a flag raised when one of its values changes, so that the RRC can skip
+ * the UEs without new measurements.
+ */
+class CellSinrMatrix
+{
+public:
+  CellSinrMatrix ();
+
+  /**
+   * Store the SINR reported by a cell, adding the cell and the UEs not
+   * known yet. The SINR of the UEs missing from the report is kept.
+   *
+   * \param cellId the reporting cell
+   * \param imsiSinrMap the linear SINR of each IMSI in the cell
+   */
+  void UpdateCell (uint16_t cellId, const std::map<uint64_t, double> &imsiSinrMap);
+
+  /**
+   * \param imsi the IMSI
+   * \return true if a cell reported this IMSI
+   */
+  bool HasUe (uint64_t imsi) const;
+
+  /**
+   * \param imsi the IMSI
+   * \param cellId the cell ID
+   * \return the SINR of the IMSI in the cell, 0 if never reported
+   */
+  double Get (uint64_t imsi, uint16_t cellId) const;
+
+  /**
+   * Remove all the UEs and cells
+   */
+  void Clear ();
+
+  /// \return the number of rows
+  uint32_t GetNUes () const;
+  /// \return the number of columns
+  uint32_t GetNCells () const;
+  /**
+   * \param row the row
+   * \return the IMSI of the row
+   */
+  uint64_t GetImsi (uint32_t row) const;
+  /**
+   * \param col the column
+   * \return the cell ID of the column
+   */
+  uint16_t GetCellId (uint32_t col) const;
+  /**
+   * \param row the row
+   * \param col the column
+   * \return true if the cell reported the UE
+   */
+  bool IsReported (uint32_t row, uint32_t col) const;
+  /**
+   * \param row the row
+   * \param col the column
+   * \return the SINR of the UE in the cell, 0 if never reported
+   */
+  double GetSinr (uint32_t row, uint32_t col) const;
+
+  /**
+   * \param row the row
+   * \return true if a value of the row changed since ClearUpdated
+   */
+  bool IsUpdated (uint32_t row) const;
+  /**
+   * \param row the row
+   */
+  void ClearUpdated (uint32_t row);
+
+private:
+  /**
+   * \param cellId the cell ID
+   * \return the column of the cell, adding it if needed
+   */
+  uint32_t AddCell (uint16_t cellId);
+  /**
+   * Add rows, keeping the rows sorted
+   * \param imsis the sorted IMSIs to add, not in the matrix yet
+   */
+  void AddUes (const std::vector<uint64_t> &imsis);
+  /**
+   * \param imsi the IMSI
+   * \return the row of the IMSI, or GetNUes () if absent
+   */
+  uint32_t FindRow (uint64_t imsi) const;
+  /**
+   * \param cellId the cell ID
+   * \return the column of the cell, or GetNCells () if absent
+   */
+  uint32_t FindCol (uint16_t cellId) const;
+
+  std::vector<uint64_t> m_imsis;     ///< IMSI of each row, sorted
+  std::vector<uint16_t> m_cellIds;   ///< cell ID of each column, sorted
+  std::vector<double> m_sinr;        ///< values, row by row, negative if not reported
+  std::vector<uint8_t> m_updated;    ///< update flag of each row
+};
+
+} // namespace ns3
+
+#endif // CELL_SINR_MATRIX_H
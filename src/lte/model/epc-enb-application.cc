@@ -76,7 +76,8 @@ EpcEnbApplication::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_lteSocket = 0;
-  m_s1uSocket = 0;
+  m_s1uTunnel->Dispose ();
+  m_s1uTunnel = 0;
   delete m_s1SapProvider;
   delete m_s1apSapEnb;
 }
@@ -84,17 +85,17 @@ EpcEnbApplication::DoDispose (void)
 
 EpcEnbApplication::EpcEnbApplication (Ptr<Socket> lteSocket, Ptr<Socket> s1uSocket, Ipv4Address enbS1uAddress, Ipv4Address sgwS1uAddress, uint16_t cellId)
   : m_lteSocket (lteSocket),
-    m_s1uSocket (s1uSocket),    
     m_enbS1uAddress (enbS1uAddress),
     m_sgwS1uAddress (sgwS1uAddress),
-    m_gtpuUdpPort (2152), // fixed by the standard
     m_s1SapUser (0),
     m_s1apSapEnbProvider (0),
 	//m_s1apSapMme (0), // jhlim
     m_cellId (cellId)
 {
   NS_LOG_FUNCTION (this << lteSocket << s1uSocket << sgwS1uAddress);
-  m_s1uSocket->SetRecvCallback (MakeCallback (&EpcEnbApplication::RecvFromS1uSocket, this));
+  m_s1uTunnel = CreateObject<UdpTunnelEndpoint> ();
+  m_s1uTunnel->SetSocket (s1uSocket);
+  m_s1uTunnel->SetRecvCallback (MakeCallback (&EpcEnbApplication::RecvFromS1uTunnel, this));
   m_lteSocket->SetRecvCallback (MakeCallback (&EpcEnbApplication::RecvFromLteSocket, this));
   m_s1SapProvider = new MemberEpcEnbS1SapProvider<EpcEnbApplication> (this);
   m_s1apSapEnb = new MemberEpcS1apSapEnb<EpcEnbApplication> (this);
@@ -187,7 +188,7 @@ EpcEnbApplication::DoPathSwitchRequest (EpcEnbS1SapProvider::PathSwitchRequestPa
       
       EpsFlowId_t rbid (params.rnti, bit->epsBearerId);
       // side effect: create entries if not exist
-      m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
+      m_rbidTeidMap[GetRbidKey (params.rnti, bit->epsBearerId)] = teid;
       m_teidRbidMap[teid] = rbid;
 
       EpcS1apSapMme::ErabSwitchedInDownlinkItem erab;
@@ -225,7 +226,7 @@ EpcEnbApplication::DoPathSwitchRequest (EpcEnbS1SapProvider::PathSwitchRequestPa
       
       EpsFlowId_t rbid (params.rnti, bit->epsBearerId);
       // side effect: create entries if not exist
-      m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
+      m_rbidTeidMap[GetRbidKey (params.rnti, bit->epsBearerId)] = teid;
       m_teidRbidMap[teid] = rbid;
 
       EpcS1apSapMme::ErabSwitchedInDownlinkItem erab;
@@ -242,17 +243,14 @@ void
 EpcEnbApplication::DoUeContextRelease (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
-  std::map<uint16_t, std::map<uint8_t, uint32_t> >::iterator rntiIt = m_rbidTeidMap.find (rnti);
-  if (rntiIt != m_rbidTeidMap.end ())
+  for (uint8_t bid = 0; bid < 16; ++bid)
     {
-      for (std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.begin ();
-           bidIt != rntiIt->second.end ();
-           ++bidIt)
+      uint32_t *teid = m_rbidTeidMap.Find (GetRbidKey (rnti, bid));
+      if (teid != 0)
         {
-          uint32_t teid = bidIt->second;
-          m_teidRbidMap.erase (teid);
+          m_teidRbidMap.Erase (*teid);
+          m_rbidTeidMap.Erase (GetRbidKey (rnti, bid));
         }
-      m_rbidTeidMap.erase (rntiIt);
     }
 }
 
@@ -281,7 +279,7 @@ EpcEnbApplication::DoInitialContextSetupRequest (uint64_t mmeUeS1Id, uint16_t en
 
       EpsFlowId_t rbid (rnti, erabIt->erabId);
       // side effect: create entries if not exist
-      m_rbidTeidMap[rnti][erabIt->erabId] = params.gtpTeid;
+      m_rbidTeidMap[GetRbidKey (rnti, erabIt->erabId)] = params.gtpTeid;
       m_teidRbidMap[params.gtpTeid] = rbid;
 
     }
@@ -301,6 +299,14 @@ EpcEnbApplication::DoPathSwitchRequestAcknowledge (uint64_t enbUeS1Id, uint64_t
   m_s1SapUser->PathSwitchRequestAcknowledge (params);
 }
 
+uint32_t
+EpcEnbApplication::GetRbidKey (uint16_t rnti, uint8_t bid)
+{
+  // the EPS bearer identity has 4 bits, see 3GPP TS 24.007 section 11.2.3.1.5
+  NS_ASSERT_MSG (bid < 16, "invalid EPS bearer identity " << (uint32_t) bid);
+  return (static_cast<uint32_t> (rnti) << 4) | bid;
+}
+
 void 
 EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
 {
@@ -319,26 +325,21 @@ EpcEnbApplication::RecvFromLteSocket (Ptr<Socket> socket)
   uint16_t rnti = tag.GetRnti ();
   uint8_t bid = tag.GetBid ();
   NS_LOG_LOGIC ("received packet with RNTI=" << (uint32_t) rnti << ", BID=" << (uint32_t)  bid);
-  std::map<uint16_t, std::map<uint8_t, uint32_t> >::iterator rntiIt = m_rbidTeidMap.find (rnti);
-  if (rntiIt == m_rbidTeidMap.end ())
+  uint32_t *teid = m_rbidTeidMap.Find (GetRbidKey (rnti, bid));
+  if (teid == 0)
     {
       NS_LOG_WARN ("UE context not found, discarding packet when receiving from lteSocket");
     }
   else
     {
-      std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.find (bid);
-      NS_ASSERT (bidIt != rntiIt->second.end ());
-      uint32_t teid = bidIt->second;
-      SendToS1uSocket (packet, teid);
+      SendToS1uTunnel (packet, *teid);
     }
 }
 
 void 
-EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
+EpcEnbApplication::RecvFromS1uTunnel (Ptr<Packet> packet)
 {
-  NS_LOG_FUNCTION (this << socket);  
-  NS_ASSERT (socket == m_s1uSocket);
-  Ptr<Packet> packet = socket->Recv ();
+  NS_LOG_FUNCTION (this << packet);
   GtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
   uint32_t teid = gtpu.GetTeid ();
@@ -348,15 +349,15 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
   //SocketAddressTag tag;
   //packet->RemovePacketTag (tag);
 
-  std::map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
-  if (it != m_teidRbidMap.end ())
+  EpsFlowId_t *rbid = m_teidRbidMap.Find (teid);
+  if (rbid != 0)
     {
-      SendToLteSocket (packet, it->second.m_rnti, it->second.m_bid);
+      SendToLteSocket (packet, rbid->m_rnti, rbid->m_bid);
     }
   else
     {
       packet = 0;
-      NS_LOG_DEBUG("UE context not found, discarding packet when receiving from s1uSocket");
+      NS_LOG_DEBUG("UE context not found, discarding packet when receiving from the S1-U tunnel");
     }  
 }
 
@@ -372,17 +373,15 @@ EpcEnbApplication::SendToLteSocket (Ptr<Packet> packet, uint16_t rnti, uint8_t b
 
 
 void 
-EpcEnbApplication::SendToS1uSocket (Ptr<Packet> packet, uint32_t teid)
+EpcEnbApplication::SendToS1uTunnel (Ptr<Packet> packet, uint32_t teid)
 {
   NS_LOG_FUNCTION (this << packet << teid <<  packet->GetSize ());  
   GtpuHeader gtpu;
   gtpu.SetTeid (teid);
   // From 3GPP TS 29.281 v10.0.0 Section 5.1
   // Length of the payload + the non obligatory GTP-U header
-  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);  
-  packet->AddHeader (gtpu);
-  uint32_t flags = 0;
-  m_s1uSocket->SendTo (packet, flags, InetSocketAddress (m_sgwS1uAddress, m_gtpuUdpPort));
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  m_s1uTunnel->Send (packet, gtpu, m_sgwS1uAddress);
 }
 
 void
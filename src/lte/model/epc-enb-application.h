@@ -38,6 +38,8 @@
 #include <ns3/eps-bearer.h>
 #include <ns3/epc-enb-s1-sap.h>
 #include <ns3/epc-s1ap-sap.h>
+#include <ns3/flat-hash-map.h>
+#include <ns3/udp-tunnel-endpoint.h>
 #include <map>
 
 namespace ns3 {
@@ -123,11 +125,11 @@ public:
 
 
   /** 
-   * Method to be assigned to the recv callback of the S1-U socket. It is called when the eNB receives a data packet from the SGW that is to be forwarded to the UE.
+   * Method to be assigned to the recv callback of the S1-U tunnel endpoint. It is called when the eNB receives a data packet from the SGW that is to be forwarded to the UE.
    * 
-   * \param socket pointer to the S1-U socket
+   * \param packet the packet, starting with its GTP-U header
    */
-  void RecvFromS1uSocket (Ptr<Socket> socket);
+  void RecvFromS1uTunnel (Ptr<Packet> packet);
 
 
   struct EpsFlowId_t
@@ -184,7 +186,7 @@ private:
    * \param packet packet to be sent
    * \param teid the Tunnel Enpoint IDentifier
    */
-  void SendToS1uSocket (Ptr<Packet> packet, uint32_t teid);
+  void SendToS1uTunnel (Ptr<Packet> packet, uint32_t teid);
 
 
   
@@ -203,9 +205,9 @@ private:
   Ptr<Socket> m_lteSocket;
 
   /**
-   * UDP socket to send and receive GTP-U the packets to and from the S1-U interface
+   * GTP-U tunnel endpoint to send and receive the packets to and from the S1-U interface
    */
-  Ptr<Socket> m_s1uSocket;
+  Ptr<UdpTunnelEndpoint> m_s1uTunnel;
 
   /**
    * address of the eNB for S1-U communications
@@ -218,22 +220,24 @@ private:
   Ipv4Address m_sgwS1uAddress;
 
   /**
-   * map of maps telling for each RNTI and BID the corresponding  S1-U TEID
-   * 
+   * \param rnti the RNTI of a UE
+   * \param bid the EPS bearer identity of a bearer of the UE
+   * \return the key of the bearer in m_rbidTeidMap
+   */
+  static uint32_t GetRbidKey (uint16_t rnti, uint8_t bid);
+
+  /**
+   * map telling for each RNTI and BID, keyed by GetRbidKey(), the
+   * corresponding S1-U TEID
    */
-  std::map<uint16_t, std::map<uint8_t, uint32_t> > m_rbidTeidMap;  
+  FlatHashMap<uint32_t> m_rbidTeidMap;
 
   /**
    * map telling for each S1-U TEID the corresponding RNTI,BID
    * 
    */
-  std::map<uint32_t, EpsFlowId_t> m_teidRbidMap;
+  FlatHashMap<EpsFlowId_t> m_teidRbidMap;
  
-  /**
-   * UDP port to be used for GTP
-   */
-  uint16_t m_gtpuUdpPort;
-
   /**
    * Provider for the S1 SAP 
    */
@@ -25,6 +25,8 @@
 
 #include <ns3/fatal-error.h>
 #include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/make-event.h>
 
 #include "epc-s1ap-sap.h"
 #include "epc-s11-sap.h"
@@ -43,6 +45,7 @@ EpcMmeApplication::EpcMmeApplication ()
   NS_LOG_FUNCTION (this);
   m_s1apSapMme = new MemberEpcS1apSapMme<EpcMmeApplication> (this);
   m_s11SapMme = new MemberEpcS11SapMme<EpcMmeApplication> (this);
+  m_queue = CreateObject<NfQueue> ();
 }
 
 
@@ -57,6 +60,7 @@ EpcMmeApplication::DoDispose ()
   NS_LOG_FUNCTION (this);
   delete m_s1apSapMme;
   delete m_s11SapMme;
+  m_queue = 0;
 }
 
 TypeId
@@ -132,11 +136,44 @@ EpcMmeApplication::AddBearer (uint64_t imsi, Ptr<EpcTft> tft, EpsBearer bearer)
   return bearerInfo.bearerId;
 }
 
+Ptr<NfQueue>
+EpcMmeApplication::GetQueue () const
+{
+  return m_queue;
+}
+
+void
+EpcMmeApplication::Receive (std::string message, bool initial, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << message);
+  Ptr<EventImpl> processing (event, false);
+  if (m_queue->IsInstantaneous ())
+    {
+      processing->Invoke ();
+      return;
+    }
+  Time delay;
+  if (!m_queue->Enqueue (message, initial, delay))
+    {
+      // the UE retries once its NAS timer expires
+      return;
+    }
+  Simulator::Schedule (delay, processing);
+}
+
 
 // S1-AP SAP MME forwarded methods
 
-void 
+void
 EpcMmeApplication::DoInitialUeMessage (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, uint64_t imsi, uint16_t gci)
+{
+  NS_LOG_FUNCTION (this << mmeUeS1Id << enbUeS1Id << imsi << gci);
+  Receive ("InitialUeMessage", true,
+           MakeEvent (&EpcMmeApplication::ProcessInitialUeMessage, this, mmeUeS1Id, enbUeS1Id, imsi, gci));
+}
+
+void
+EpcMmeApplication::ProcessInitialUeMessage (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, uint64_t imsi, uint16_t gci)
 {
   NS_LOG_FUNCTION (this << mmeUeS1Id << enbUeS1Id << imsi << gci);
   std::map<uint64_t, Ptr<UeInfo> >::iterator it = m_ueInfoMap.find (imsi);
@@ -169,8 +206,16 @@ EpcMmeApplication::DoInitialContextSetupResponse (uint64_t mmeUeS1Id, uint16_t e
   NS_FATAL_ERROR ("unimplemented");
 }
 
-void 
+void
 EpcMmeApplication::DoPathSwitchRequest (uint64_t enbUeS1Id, uint64_t mmeUeS1Id, uint16_t gci, std::list<EpcS1apSapMme::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
+{
+  NS_LOG_FUNCTION (this << mmeUeS1Id << enbUeS1Id << gci);
+  Receive ("PathSwitchRequest", false,
+           MakeEvent (&EpcMmeApplication::ProcessPathSwitchRequest, this, enbUeS1Id, mmeUeS1Id, gci, erabToBeSwitchedInDownlinkList));
+}
+
+void
+EpcMmeApplication::ProcessPathSwitchRequest (uint64_t enbUeS1Id, uint64_t mmeUeS1Id, uint16_t gci, std::list<EpcS1apSapMme::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
 {
   NS_LOG_FUNCTION (this << mmeUeS1Id << enbUeS1Id << gci);
 
@@ -191,8 +236,16 @@ EpcMmeApplication::DoPathSwitchRequest (uint64_t enbUeS1Id, uint64_t mmeUeS1Id,
 
 // S11 SAP MME forwarded methods
 
-void 
+void
 EpcMmeApplication::DoCreateSessionResponse (EpcS11SapMme::CreateSessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.teid);
+  Receive ("CreateSessionResponse", false,
+           MakeEvent (&EpcMmeApplication::ProcessCreateSessionResponse, this, msg));
+}
+
+void
+EpcMmeApplication::ProcessCreateSessionResponse (EpcS11SapMme::CreateSessionResponseMessage msg)
 {
   NS_LOG_FUNCTION (this << msg.teid);
   uint64_t imsi = msg.teid;
@@ -219,8 +272,16 @@ EpcMmeApplication::DoCreateSessionResponse (EpcS11SapMme::CreateSessionResponseM
 }
 
 
-void 
+void
 EpcMmeApplication::DoModifyBearerResponse (EpcS11SapMme::ModifyBearerResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.teid);
+  Receive ("ModifyBearerResponse", false,
+           MakeEvent (&EpcMmeApplication::ProcessModifyBearerResponse, this, msg));
+}
+
+void
+EpcMmeApplication::ProcessModifyBearerResponse (EpcS11SapMme::ModifyBearerResponseMessage msg)
 {
   NS_LOG_FUNCTION (this << msg.teid);
   NS_ASSERT (msg.cause == EpcS11SapMme::ModifyBearerResponseMessage::REQUEST_ACCEPTED);
@@ -238,6 +299,14 @@ EpcMmeApplication::DoModifyBearerResponse (EpcS11SapMme::ModifyBearerResponseMes
 
 void
 EpcMmeApplication::DoErabReleaseIndication (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, std::list<EpcS1apSapMme::ErabToBeReleasedIndication> erabToBeReleaseIndication)
+{
+  NS_LOG_FUNCTION (this << mmeUeS1Id << enbUeS1Id);
+  Receive ("ErabReleaseIndication", false,
+           MakeEvent (&EpcMmeApplication::ProcessErabReleaseIndication, this, mmeUeS1Id, enbUeS1Id, erabToBeReleaseIndication));
+}
+
+void
+EpcMmeApplication::ProcessErabReleaseIndication (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, std::list<EpcS1apSapMme::ErabToBeReleasedIndication> erabToBeReleaseIndication)
 {
   NS_LOG_FUNCTION (this << mmeUeS1Id << enbUeS1Id);
   uint64_t imsi = mmeUeS1Id;
@@ -260,6 +329,14 @@ EpcMmeApplication::DoErabReleaseIndication (uint64_t mmeUeS1Id, uint16_t enbUeS1
 
 void
 EpcMmeApplication::DoDeleteBearerRequest (EpcS11SapMme::DeleteBearerRequestMessage msg)
+{
+  NS_LOG_FUNCTION (this);
+  Receive ("DeleteBearerRequest", false,
+           MakeEvent (&EpcMmeApplication::ProcessDeleteBearerRequest, this, msg));
+}
+
+void
+EpcMmeApplication::ProcessDeleteBearerRequest (EpcS11SapMme::DeleteBearerRequestMessage msg)
 {
   NS_LOG_FUNCTION (this);
   uint64_t imsi = msg.teid;
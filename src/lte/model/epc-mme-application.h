@@ -27,6 +27,8 @@
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
 #include <ns3/application.h>
+#include <ns3/event-impl.h>
+#include <ns3/nf-queue.h>
 
 
 #include <map>
@@ -117,6 +119,11 @@ public:
    */
   uint8_t AddBearer (uint64_t imsi, Ptr<EpcTft> tft, EpsBearer bearer);
 
+  /**
+   * \return the processing queue of the MME, which sets the service time
+   * of each message and the number of workers
+   */
+  Ptr<NfQueue> GetQueue () const;
 
 private:
 
@@ -131,6 +138,24 @@ private:
   void DoModifyBearerResponse (EpcS11SapMme::ModifyBearerResponseMessage msg);
   void DoDeleteBearerRequest (EpcS11SapMme::DeleteBearerRequestMessage msg);
 
+  // processing of the messages once served
+  void ProcessInitialUeMessage (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, uint64_t imsi, uint16_t ecgi);
+  void ProcessPathSwitchRequest (uint64_t enbUeS1Id, uint64_t mmeUeS1Id, uint16_t cgi, std::list<EpcS1apSapMme::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList);
+  void ProcessErabReleaseIndication (uint64_t mmeUeS1Id, uint16_t enbUeS1Id, std::list<EpcS1apSapMme::ErabToBeReleasedIndication> erabToBeReleaseIndication);
+  void ProcessCreateSessionResponse (EpcS11SapMme::CreateSessionResponseMessage msg);
+  void ProcessModifyBearerResponse (EpcS11SapMme::ModifyBearerResponseMessage msg);
+  void ProcessDeleteBearerRequest (EpcS11SapMme::DeleteBearerRequestMessage msg);
+
+  /**
+   * Queue a message for processing
+   *
+   * \param message the name of the message
+   * \param initial whether the message starts a procedure, in which case
+   *                it is dropped when the MME is overloaded
+   * \param event the processing of the message
+   */
+  void Receive (std::string message, bool initial, EventImpl *event);
+
 
   /**
    * Hold info on an EPS bearer to be activated
@@ -194,6 +219,11 @@ private:
 
   EpcS11SapMme* m_s11SapMme;
   EpcS11SapSgw* m_s11SapSgw;
+
+  /**
+   * processing queue of the S1-AP and S11 messages
+   */
+  Ptr<NfQueue> m_queue;
   
 };
 
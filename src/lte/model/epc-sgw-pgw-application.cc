@@ -113,22 +113,22 @@ void
 EpcSgwPgwApplication::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_s1uSocket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
-  m_s1uSocket = 0;
+  m_s1uTunnel->Dispose ();
+  m_s1uTunnel = 0;
   delete (m_s11SapSgw);
 }
 
   
 
 EpcSgwPgwApplication::EpcSgwPgwApplication (const Ptr<VirtualNetDevice> tunDevice, const Ptr<Socket> s1uSocket)
-  : m_s1uSocket (s1uSocket),
-    m_tunDevice (tunDevice),
-    m_gtpuUdpPort (2152), // fixed by the standard
+  : m_tunDevice (tunDevice),
     m_teidCount (0),
     m_s11SapMme (0)
 {
   NS_LOG_FUNCTION (this << tunDevice << s1uSocket);
-  m_s1uSocket->SetRecvCallback (MakeCallback (&EpcSgwPgwApplication::RecvFromS1uSocket, this));
+  m_s1uTunnel = CreateObject<UdpTunnelEndpoint> ();
+  m_s1uTunnel->SetSocket (s1uSocket);
+  m_s1uTunnel->SetRecvCallback (MakeCallback (&EpcSgwPgwApplication::RecvFromS1uTunnel, this));
   m_s11SapSgw = new MemberEpcS11SapSgw<EpcSgwPgwApplication> (this);
 }
 
@@ -145,29 +145,28 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
   NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
 
   // get IP address of UE
-  Ptr<Packet> pCopy = packet->Copy ();
   Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  packet->PeekHeader (ipv4Header);
   Ipv4Address ueAddr =  ipv4Header.GetDestination ();
   NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
 
   // find corresponding UeInfo address
-  std::map<Ipv4Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap.find (ueAddr);
-  if (it == m_ueInfoByAddrMap.end ())
+  Ptr<UeInfo> *ueInfo = m_ueInfoByAddrMap.Find (ueAddr.Get ());
+  if (ueInfo == 0)
     {        
       NS_LOG_WARN ("unknown UE address " << ueAddr);
     }
   else
     {
-      Ipv4Address enbAddr = it->second->GetEnbAddr ();      
-      uint32_t teid = it->second->Classify (packet);   
+      Ipv4Address enbAddr = (*ueInfo)->GetEnbAddr ();
+      uint32_t teid = (*ueInfo)->Classify (packet);
       if (teid == 0)
         {
           NS_LOG_WARN ("no matching bearer for this packet");                   
         }
       else
         {
-          SendToS1uSocket (packet, enbAddr, teid);
+          SendToS1uTunnel (packet, enbAddr, teid);
         }
     }
   // there is no reason why we should notify the TUN
@@ -178,11 +177,9 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
 }
 
 void 
-EpcSgwPgwApplication::RecvFromS1uSocket (Ptr<Socket> socket)
+EpcSgwPgwApplication::RecvFromS1uTunnel (Ptr<Packet> packet)
 {
-  NS_LOG_FUNCTION (this << socket);  
-  NS_ASSERT (socket == m_s1uSocket);
-  Ptr<Packet> packet = socket->Recv ();
+  NS_LOG_FUNCTION (this << packet);
   GtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
   uint32_t teid = gtpu.GetTeid ();
@@ -204,18 +201,15 @@ EpcSgwPgwApplication::SendToTunDevice (Ptr<Packet> packet, uint32_t teid)
 }
 
 void 
-EpcSgwPgwApplication::SendToS1uSocket (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid)
+EpcSgwPgwApplication::SendToS1uTunnel (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid)
 {
   NS_LOG_FUNCTION (this << packet << enbAddr << teid);
-
   GtpuHeader gtpu;
   gtpu.SetTeid (teid);
   // From 3GPP TS 29.281 v10.0.0 Section 5.1
   // Length of the payload + the non obligatory GTP-U header
-  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);  
-  packet->AddHeader (gtpu);
-  uint32_t flags = 0;
-  m_s1uSocket->SendTo (packet, flags, InetSocketAddress (enbAddr, m_gtpuUdpPort));
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  m_s1uTunnel->Send (packet, gtpu, enbAddr);
 }
 
 
@@ -255,7 +249,7 @@ EpcSgwPgwApplication::SetUeAddress (uint64_t imsi, Ipv4Address ueAddr)
   NS_LOG_FUNCTION (this << imsi << ueAddr);
   std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
   NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi); 
-  m_ueInfoByAddrMap[ueAddr] = ueit->second;
+  m_ueInfoByAddrMap[ueAddr.Get ()] = ueit->second;
   ueit->second->SetUeAddr (ueAddr);
 }
 
@@ -36,6 +36,8 @@
 #include <ns3/application.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <ns3/epc-s11-sap.h>
+#include <ns3/flat-hash-map.h>
+#include <ns3/udp-tunnel-endpoint.h>
 #include <map>
 
 namespace ns3 {
@@ -86,13 +88,13 @@ public:
 
 
   /** 
-   * Method to be assigned to the recv callback of the S1-U socket. It
-   * is called when the SGW/PGW receives a data packet from the eNB
-   * that is to be forwarded to the internet. 
+   * Method to be assigned to the recv callback of the S1-U tunnel
+   * endpoint. It is called when the SGW/PGW receives a data packet from
+   * the eNB that is to be forwarded to the internet. 
    * 
-   * \param socket pointer to the S1-U socket
+   * \param packet the packet, starting with its GTP-U header
    */
-  void RecvFromS1uSocket (Ptr<Socket> socket);
+  void RecvFromS1uTunnel (Ptr<Packet> packet);
 
   /** 
    * Send a packet to the internet via the Gi interface of the SGW/PGW
@@ -109,7 +111,7 @@ public:
    * \param enbS1uAddress the address of the eNB
    * \param teid the Tunnel Enpoint IDentifier
    */
-  void SendToS1uSocket (Ptr<Packet> packet, Ipv4Address enbS1uAddress, uint32_t teid);
+  void SendToS1uTunnel (Ptr<Packet> packet, Ipv4Address enbS1uAddress, uint32_t teid);
   
 
   /** 
@@ -227,9 +229,9 @@ public:
 
 
  /**
-  * UDP socket to send and receive GTP-U packets to and from the S1-U interface
+  * GTP-U tunnel endpoint to send and receive the packets to and from the S1-U interface
   */
-  Ptr<Socket> m_s1uSocket;
+  Ptr<UdpTunnelEndpoint> m_s1uTunnel;
   
   /**
    * TUN VirtualNetDevice used for tunneling/detunneling IP packets
@@ -238,20 +240,16 @@ public:
   Ptr<VirtualNetDevice> m_tunDevice;
 
   /**
-   * Map telling for each UE address the corresponding UE info 
+   * Map telling for each UE address, as a 32 bit integer, the
+   * corresponding UE info
    */
-  std::map<Ipv4Address, Ptr<UeInfo> > m_ueInfoByAddrMap;
+  FlatHashMap<Ptr<UeInfo> > m_ueInfoByAddrMap;
 
   /**
    * Map telling for each IMSI the corresponding UE info 
    */
   std::map<uint64_t, Ptr<UeInfo> > m_ueInfoByImsiMap;
 
-  /**
-   * UDP port to be used for GTP
-   */
-  uint16_t m_gtpuUdpPort;
-
   uint32_t m_teidCount;
 
   /**
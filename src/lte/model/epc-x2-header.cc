@@ -158,7 +158,9 @@ EpcX2AssistantInfoHeader::EpcX2AssistantInfoHeader(){
 	sourceCellId =0xfa;
 	rnti=0xfa;
 	drbId=0xfa;
-	headerLength=23;
+	desiredBufferSize=0xfffffffa;
+	reportTime=0xfffffffffffffffa;
+	headerLength=37;
 }
 EpcX2AssistantInfoHeader::~EpcX2AssistantInfoHeader(){
 	TxonQueueSize=0xfffffffb;
@@ -202,6 +204,13 @@ EpcX2AssistantInfoHeader::Serialize(Buffer::Iterator start)const {
 	 i.WriteU8(sourceCellId);
 	 i.WriteU8(rnti);
 	 i.WriteU8(drbId);
+	 i.WriteHtonU32(desiredBufferSize);
+	 i.WriteHtonU64(reportTime);
+	 i.WriteHtonU16(deliveredPdcpSn.size());
+	 for (std::vector<uint16_t>::const_iterator it = deliveredPdcpSn.begin(); it != deliveredPdcpSn.end(); ++it)
+	   {
+	     i.WriteHtonU16(*it);
+	   }
 
 }
 uint32_t
@@ -215,7 +224,15 @@ EpcX2AssistantInfoHeader::Deserialize(Buffer::Iterator start){
 	sourceCellId = i.ReadU8();
 	rnti=i.ReadU8();
 	drbId=i.ReadU8();
-	headerLength =23;
+	desiredBufferSize = i.ReadNtohU32();
+	reportTime = i.ReadNtohU64();
+	uint16_t numSn = i.ReadNtohU16();
+	deliveredPdcpSn.clear();
+	for (uint16_t k = 0; k < numSn; k++)
+	  {
+	    deliveredPdcpSn.push_back(i.ReadNtohU16());
+	  }
+	headerLength =37 + 2*numSn;
 	return GetSerializedSize();
 }
 void
@@ -227,6 +244,8 @@ EpcX2AssistantInfoHeader::Print(std::ostream &os) const
 	os<<"TxQ_delay = "<<TxQueingDelay ;
 	os<< "ReTxQ_delay = " << ReTxQueingDelay ;
 	os<<"source Cell ID = " << sourceCellId ;
+	os<<"desired buffer = " << desiredBufferSize;
+	os<<"delivered SNs = " << deliveredPdcpSn.size();
 }
 uint32_t
 EpcX2AssistantInfoHeader::GetTxonQueue()const{
@@ -292,9 +311,34 @@ uint8_t
 EpcX2AssistantInfoHeader::GetDrbId(){
 	return drbId;
 }
+uint32_t
+EpcX2AssistantInfoHeader::GetDesiredBufferSize() const {
+	return desiredBufferSize;
+}
+void
+EpcX2AssistantInfoHeader::SetDesiredBufferSize(uint32_t desiredBufferSize){
+	this->desiredBufferSize = desiredBufferSize;
+}
+uint64_t
+EpcX2AssistantInfoHeader::GetReportTime() const {
+	return reportTime;
+}
+void
+EpcX2AssistantInfoHeader::SetReportTime(uint64_t reportTime){
+	this->reportTime = reportTime;
+}
+std::vector<uint16_t>
+EpcX2AssistantInfoHeader::GetDeliveredPdcpSn() const {
+	return deliveredPdcpSn;
+}
+void
+EpcX2AssistantInfoHeader::SetDeliveredPdcpSn(std::vector<uint16_t> sns){
+	deliveredPdcpSn = sns;
+	headerLength = 37 + 2*sns.size();
+}
 uint16_t
 EpcX2AssistantInfoHeader::GetNumbefOfIes(){
-	return 8;
+	return 11;
 }
 /////////////////////////////////////////////////////////////////////
 
@@ -1611,6 +1655,176 @@ EpcX2DuplicationRlcBufferHeader::GetNumberOfIes () const
 }
 /////////////////////////////////////////////////////////////////////
 
+NS_OBJECT_ENSURE_REGISTERED (EpcX2DiscardPdcpSduHeader);
+
+EpcX2DiscardPdcpSduHeader::EpcX2DiscardPdcpSduHeader ()
+{
+}
+
+EpcX2DiscardPdcpSduHeader::~EpcX2DiscardPdcpSduHeader ()
+{
+  m_pdcpSns.clear ();
+}
+
+TypeId
+EpcX2DiscardPdcpSduHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EpcX2DiscardPdcpSduHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Lte")
+    .AddConstructor<EpcX2DiscardPdcpSduHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+EpcX2DiscardPdcpSduHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+EpcX2DiscardPdcpSduHeader::GetSerializedSize (void) const
+{
+  return 2 + 2 * m_pdcpSns.size ();
+}
+
+void
+EpcX2DiscardPdcpSduHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteHtonU16 (m_pdcpSns.size ());
+  for (std::vector<uint16_t>::const_iterator it = m_pdcpSns.begin (); it != m_pdcpSns.end (); ++it)
+    {
+      i.WriteHtonU16 (*it);
+    }
+}
+
+uint32_t
+EpcX2DiscardPdcpSduHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  uint16_t numSn = i.ReadNtohU16 ();
+  m_pdcpSns.clear ();
+  for (uint16_t k = 0; k < numSn; k++)
+    {
+      m_pdcpSns.push_back (i.ReadNtohU16 ());
+    }
+
+  return GetSerializedSize ();
+}
+
+void
+EpcX2DiscardPdcpSduHeader::Print (std::ostream &os) const
+{
+  os << "PdcpSns=";
+  for (std::vector<uint16_t>::const_iterator it = m_pdcpSns.begin (); it != m_pdcpSns.end (); ++it)
+    {
+      os << " " << *it;
+    }
+}
+
+std::vector<uint16_t>
+EpcX2DiscardPdcpSduHeader::GetPdcpSns () const
+{
+  return m_pdcpSns;
+}
+
+void
+EpcX2DiscardPdcpSduHeader::SetPdcpSns (std::vector<uint16_t> sns)
+{
+  m_pdcpSns = sns;
+}
+
+/////////////////////////////////////////////////////////////////////
+
+NS_OBJECT_ENSURE_REGISTERED (EpcX2McPduBatchHeader);
+
+EpcX2McPduBatchHeader::EpcX2McPduBatchHeader ()
+{
+}
+
+EpcX2McPduBatchHeader::~EpcX2McPduBatchHeader ()
+{
+  m_pduSizes.clear ();
+}
+
+TypeId
+EpcX2McPduBatchHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EpcX2McPduBatchHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Lte")
+    .AddConstructor<EpcX2McPduBatchHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+EpcX2McPduBatchHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+EpcX2McPduBatchHeader::GetSerializedSize (void) const
+{
+  return 2 + 2 * m_pduSizes.size ();
+}
+
+void
+EpcX2McPduBatchHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteHtonU16 (m_pduSizes.size ());
+  for (std::vector<uint16_t>::const_iterator it = m_pduSizes.begin (); it != m_pduSizes.end (); ++it)
+    {
+      i.WriteHtonU16 (*it);
+    }
+}
+
+uint32_t
+EpcX2McPduBatchHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  uint16_t numPdus = i.ReadNtohU16 ();
+  m_pduSizes.clear ();
+  for (uint16_t k = 0; k < numPdus; k++)
+    {
+      m_pduSizes.push_back (i.ReadNtohU16 ());
+    }
+
+  return GetSerializedSize ();
+}
+
+void
+EpcX2McPduBatchHeader::Print (std::ostream &os) const
+{
+  os << "PduSizes=";
+  for (std::vector<uint16_t>::const_iterator it = m_pduSizes.begin (); it != m_pduSizes.end (); ++it)
+    {
+      os << " " << *it;
+    }
+}
+
+std::vector<uint16_t>
+EpcX2McPduBatchHeader::GetPduSizes () const
+{
+  return m_pduSizes;
+}
+
+void
+EpcX2McPduBatchHeader::SetPduSizes (std::vector<uint16_t> sizes)
+{
+  m_pduSizes = sizes;
+}
+
+/////////////////////////////////////////////////////////////////////
+
 NS_OBJECT_ENSURE_REGISTERED (EpcX2NotifyCoordinatorHandoverFailedHeader);
 
 EpcX2NotifyCoordinatorHandoverFailedHeader::EpcX2NotifyCoordinatorHandoverFailedHeader ()
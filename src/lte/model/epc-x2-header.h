@@ -87,7 +87,11 @@ public:
     McForwardUplinkData     = 4,
 	McAssistantInfoForwarding =5,  // for sending assistant information by sjkang1114
 	SuccesfulOutcomToLte = 6 , // for sending ack to LTE eNB by sjkang0416
-	DuplicationRlcBuffer = 7 ///for sending NLOS eNB to duplicate RLC buffer and send it to LOS eNB
+	DuplicationRlcBuffer = 7, ///for sending NLOS eNB to duplicate RLC buffer and send it to LOS eNB
+	McDiscardDownlinkData = 8, // discard of duplicated PDCP SDUs delivered on the other leg
+	McForwardDownlinkDataBatch = 9, // several PDCP PDUs of a bearer in one X2-U container
+	McForwardUplinkDataBatch = 10,
+	McRlcBufferTransfer = 11 // the RLC buffer of a bearer, forwarded in a secondary cell HO
 
 
   };
@@ -128,6 +132,12 @@ public:
 	 uint8_t GetRnti();
 	 void SetDrbId(uint8_t drbid);
 	 uint8_t GetDrbId();
+	uint32_t GetDesiredBufferSize() const;
+	void SetDesiredBufferSize(uint32_t desiredBufferSize);
+	uint64_t GetReportTime() const;
+	void SetReportTime(uint64_t reportTime);
+	std::vector<uint16_t> GetDeliveredPdcpSn() const;
+	void SetDeliveredPdcpSn(std::vector<uint16_t> sns);
 private:
 	uint32_t TxonQueueSize;
 	uint32_t TxedQueueSize;
@@ -137,6 +147,9 @@ private:
 	uint8_t sourceCellId;
 	uint8_t drbId;
 	uint8_t rnti;
+	uint32_t desiredBufferSize;
+	uint64_t reportTime;
+	std::vector<uint16_t> deliveredPdcpSn;
 	uint32_t headerLength;
 };
 
@@ -405,6 +418,54 @@ private:
 	  bool 	m_option;
 
 };
+
+/**
+ * Header of the X2-U message asking the RLC of one leg of a duplicated
+ * bearer to discard the PDCP SDUs already delivered on the other leg
+ */
+class EpcX2DiscardPdcpSduHeader : public Header
+{
+public:
+  EpcX2DiscardPdcpSduHeader ();
+  virtual ~EpcX2DiscardPdcpSduHeader ();
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+  std::vector<uint16_t> GetPdcpSns () const;
+  void SetPdcpSns (std::vector<uint16_t> sns);
+
+private:
+  std::vector<uint16_t> m_pdcpSns;
+};
+
+/**
+ * Header of the X2-U container carrying several PDCP PDUs of the same
+ * bearer, one after the other, with the size of each of them
+ */
+class EpcX2McPduBatchHeader : public Header
+{
+public:
+  EpcX2McPduBatchHeader ();
+  virtual ~EpcX2McPduBatchHeader ();
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+  std::vector<uint16_t> GetPduSizes () const;
+  void SetPduSizes (std::vector<uint16_t> sizes);
+
+private:
+  std::vector<uint16_t> m_pduSizes;
+};
 class EpcX2NotifyCoordinatorHandoverFailedHeader : public Header
 {
 public:
@@ -421,6 +421,37 @@ struct SendBufferDuplicationMessage
   	  uint32_t Re_Tx_Q_Delay=0;
   	  uint32_t Tx_On_Q_Delay=0;
   	  uint32_t Txed_Q_Delay=0;
+  	  uint32_t Desired_Buffer_Size=0; ///< bytes the RLC can accept (credit based reporting)
+  	  uint64_t Report_Time=0;         ///< time the report was generated, in ns
+  	  std::vector<uint16_t> Delivered_Pdcp_Sn; ///< PDCP SNs acknowledged since the previous report
+  };
+
+  /**
+   * \brief Parameters of the discard of duplicated PDCP SDUs
+   *
+   * Sent by the PDCP of a duplicated bearer to the RLC of one leg (targetCellId)
+   * once the other leg has delivered the listed SNs
+   */
+  struct DiscardPdcpSduParams
+  {
+    uint16_t    sourceCellId;
+    uint16_t    targetCellId;
+    uint32_t    gtpTeid;
+    std::vector<uint16_t> pdcpSns;
+  };
+
+  /**
+   * \brief Parameters of the transfer of the RLC buffer of a bearer
+   *
+   * Sent by the source mmWave eNB of a secondary cell HO, which forwards the
+   * whole buffer in one X2-U message, restored by the target RLC at once
+   */
+  struct RlcBufferTransferParams
+  {
+    uint16_t    sourceCellId;
+    uint16_t    targetCellId;
+    uint32_t    gtpTeid;
+    std::vector< Ptr<Packet> > pdcpPdus;
   };
 };
 
@@ -439,6 +470,8 @@ public:
   // X2 sends a Pdcp PDU in downlink to the MmWave eNB for transmission to the UE
   virtual void SendMcPdcpPdu (UeDataParams params) = 0;
   virtual void ReceiveAssistantInformation (AssistantInformationForSplitting info)=0;
+  // X2 asks the MmWave eNB to discard PDCP SDUs delivered on the other leg
+  virtual void DiscardMcPdcpSdus (DiscardPdcpSduParams params) = 0;
 };
 
 
@@ -489,6 +522,10 @@ public:
    */
   // X2 sends a PDCP SDU to RLC for downlink transmission to the UE
   virtual void SendMcPdcpSdu (UeDataParams params) = 0;
+  // X2 sends the PDCP SDUs unpacked from an X2-U container to RLC at once
+  virtual void SendMcPdcpSdus (std::vector<UeDataParams> params) = 0;
+  // X2 asks the RLC to discard PDCP SDUs not yet transmitted
+  virtual void DiscardMcPdcpSdus (DiscardPdcpSduParams params) = 0;
 };
 
 /**
@@ -554,6 +591,8 @@ public:
   virtual void RemoveTeidToBeForwarded (uint32_t gtpTeid) = 0;
   // to forward the packets in the RLC buffers in the source cell as if they were generated by a PDCP
   virtual void ForwardRlcPdu (UeDataParams params) = 0;
+  // to forward all the packets in the RLC buffer of a bearer at once
+  virtual void TransferRlcBuffer (RlcBufferTransferParams params) = 0;
 
 };
 
@@ -666,6 +705,8 @@ public:
 
   virtual void ForwardRlcPdu (UeDataParams params);
 
+  virtual void TransferRlcBuffer (RlcBufferTransferParams params);
+
 private:
   EpcX2SpecificEpcX2SapProvider ();
   C* m_x2;
@@ -851,6 +892,13 @@ EpcX2SpecificEpcX2SapProvider<C>::ForwardRlcPdu(UeDataParams params)
   m_x2->DoSendMcPdcpPdu(params);
 }
 
+template <class C>
+void
+EpcX2SpecificEpcX2SapProvider<C>::TransferRlcBuffer (RlcBufferTransferParams params)
+{
+  m_x2->DoTransferRlcBuffer (params);
+}
+
 ///////////////////////////////////////
 
 template <class C>
@@ -1044,6 +1092,7 @@ public:
   // Inherited
   virtual void SendMcPdcpPdu (UeDataParams params);
   virtual void ReceiveAssistantInformation(AssistantInformationForSplitting info); //sjkang
+  virtual void DiscardMcPdcpSdus (DiscardPdcpSduParams params);
 
 private:
   EpcX2PdcpSpecificProvider ();
@@ -1073,6 +1122,13 @@ EpcX2PdcpSpecificProvider<C>::ReceiveAssistantInformation(AssistantInformationFo
 {
   m_x2->DoReceiveAssistantInformation(info);
 }
+
+template <class C>
+void
+EpcX2PdcpSpecificProvider<C>::DiscardMcPdcpSdus (DiscardPdcpSduParams params)
+{
+  m_x2->DoDiscardMcPdcpSdus (params);
+}
 /////////////////////////////////////////////
 template <class C>
 class EpcX2RlcSpecificProvider : public EpcX2RlcProvider
@@ -1161,6 +1217,8 @@ public:
 
   // Inherited
   virtual void SendMcPdcpSdu (UeDataParams params);
+  virtual void SendMcPdcpSdus (std::vector<UeDataParams> params);
+  virtual void DiscardMcPdcpSdus (DiscardPdcpSduParams params);
 
 private:
   EpcX2RlcSpecificUser ();
@@ -1185,6 +1243,20 @@ EpcX2RlcSpecificUser<C>::SendMcPdcpSdu(UeDataParams params)
   m_rlc->DoSendMcPdcpSdu(params);
 }
 
+template <class C>
+void
+EpcX2RlcSpecificUser<C>::SendMcPdcpSdus (std::vector<UeDataParams> params)
+{
+  m_rlc->DoSendMcPdcpSdus (params);
+}
+
+template <class C>
+void
+EpcX2RlcSpecificUser<C>::DiscardMcPdcpSdus (DiscardPdcpSduParams params)
+{
+  m_rlc->DoDiscardPdcpSdus (params.pdcpSns);
+}
+
 } // namespace ns3
 
 #endif // EPC_X2_SAP_H
@@ -23,6 +23,7 @@
  */
 
 #include "epc-x2-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -47,10 +48,10 @@ EpcX2Tag::EpcX2Tag (Time senderTimestamp)
 TypeId
 EpcX2Tag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::EpcX2Tag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::EpcX2Tag")
     .SetParent<Tag> ()
     .SetGroupName("Lte")
-    .AddConstructor<EpcX2Tag> ();
+    .AddConstructor<EpcX2Tag> ());
   return tid;
 }
 
@@ -26,6 +26,8 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/packet.h"
 #include "ns3/node.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include "ns3/epc-gtpu-header.h"
 #include "ns3/epc-x2-tag.h"
 #include "ns3/lte-pdcp-tag.h"
@@ -37,6 +39,9 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcX2");
 
+// largest RLC buffer sent in one X2-U message, within the 16 bit GTP-U length
+static const uint32_t MAX_RLC_BUFFER_TRANSFER_BYTES = 60000;
+
 X2IfaceInfo::X2IfaceInfo (Ipv4Address remoteIpAddr, Ptr<Socket> localCtrlPlaneSocket, Ptr<Socket> localUserPlaneSocket)
 {
   m_remoteIpAddr = remoteIpAddr;
@@ -89,7 +94,8 @@ NS_OBJECT_ENSURE_REGISTERED (EpcX2);
 
 EpcX2::EpcX2 ()
   : m_x2cUdpPort (4444),
-    m_x2uUdpPort (2152)
+    m_x2uUdpPort (2152),
+    m_mcPduAggregation (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -115,6 +121,12 @@ EpcX2::DoDispose (void)
   m_x2PdcpUserMap.clear ();
   m_x2RlcUserMap_2.clear (); //sjkang1016
   m_x2PdcpUserMap_2.clear ();//sjakng1016
+  for (std::map < McPduBatchKey, McPduBatch >::iterator it = m_mcPduBatches.begin ();
+       it != m_mcPduBatches.end (); ++it)
+    {
+      it->second.flushEvent.Cancel ();
+    }
+  m_mcPduBatches.clear ();
 
   delete m_x2SapProvider;
   delete m_x2RlcProvider;
@@ -132,7 +144,32 @@ EpcX2::GetTypeId (void)
     .AddTraceSource ("RxPDU",
                      "PDU received.",
                      MakeTraceSourceAccessor (&EpcX2::m_rxPdu),
-                     "ns3::EpcX2::ReceiveTracedCallback");
+                     "ns3::EpcX2::ReceiveTracedCallback")
+    .AddAttribute ("McPduAggregation",
+                   "Whether to send the PDCP PDUs of the split bearers to the other eNB "
+                   "in X2-U containers of several PDUs of the same bearer",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EpcX2::m_mcPduAggregation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("McAggregationInterval",
+                   "The longest time a PDCP PDU waits for its X2-U container to be sent",
+                   TimeValue (MicroSeconds (250)),
+                   MakeTimeAccessor (&EpcX2::m_mcAggregationInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("McAggregationMaxBytes",
+                   "The size of the PDCP PDUs above which an X2-U container is sent "
+                   "without waiting; keep it, with the headers, within the X2 link MTU",
+                   UintegerValue (8000),
+                   MakeUintegerAccessor (&EpcX2::m_mcAggregationMaxBytes),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddTraceSource ("TxMcPduBatch",
+                     "X2-U container of PDCP PDUs sent.",
+                     MakeTraceSourceAccessor (&EpcX2::m_txMcPduBatch),
+                     "ns3::EpcX2::McPduBatchTracedCallback")
+    .AddTraceSource ("TxRlcBuffer",
+                     "RLC buffer of a bearer sent in a secondary cell HO.",
+                     MakeTraceSourceAccessor (&EpcX2::m_txRlcBuffer),
+                     "ns3::EpcX2::RlcBufferTracedCallback");
   return tid;
 }
 void
@@ -629,13 +666,16 @@ EpcX2::RecvFromX2cSocket (Ptr<Socket> socket)
     		packet->RemoveHeader(epcX2AssistantHeader);
     		EpcX2SapUser::AssistantInformationForSplitting params;
     		params.Tx_On_Q_Size = epcX2AssistantHeader.GetTxonQueue();
-    		params.Txed_Q_Delay =epcX2AssistantHeader.GetTxedQueue();
+    		params.Txed_Q_Size =epcX2AssistantHeader.GetTxedQueue();
     		params.Re_TX_Q_Size =epcX2AssistantHeader.GetRetxQueue();
     		params.Tx_On_Q_Delay = epcX2AssistantHeader.GetTxonQueingDelay();
     		params.Re_Tx_Q_Delay = epcX2AssistantHeader.GetReTxQueuingDelay();
     		params.sourceCellId = epcX2AssistantHeader.GetSourceCellId();
     		params.rnti = epcX2AssistantHeader.GetRnti();
     		params.drbId = epcX2AssistantHeader.GetDrbId();
+    		params.Desired_Buffer_Size = epcX2AssistantHeader.GetDesiredBufferSize();
+    		params.Report_Time = epcX2AssistantHeader.GetReportTime();
+    		params.Delivered_Pdcp_Sn = epcX2AssistantHeader.GetDeliveredPdcpSn();
     	//	std::cout << "forwarding assistant infor " <<std::endl;
     		//std::cout << m_x2SapProvider << std::endl;
     	   m_x2SapUser ->RecvAssistantInformation(params); //sjkang1115
@@ -703,6 +743,48 @@ EpcX2::RecvFromX2uSocket (Ptr<Socket> socket)
   NS_LOG_LOGIC("Received packet on X2 u, size " << packet->GetSize() 
     << " source " << params.sourceCellId << " target " << params.targetCellId << " type " << gtpu.GetMessageType());
 
+  if (gtpu.GetMessageType() == EpcX2Header::McDiscardDownlinkData)
+  {
+    EpcX2DiscardPdcpSduHeader discardHeader;
+    packet->RemoveHeader (discardHeader);
+    EpcX2Sap::DiscardPdcpSduParams discardParams;
+    discardParams.sourceCellId = params.sourceCellId;
+    discardParams.targetCellId = params.targetCellId;
+    discardParams.gtpTeid = params.gtpTeid;
+    discardParams.pdcpSns = discardHeader.GetPdcpSns ();
+
+    if (m_teidToBeForwardedMap.find(params.gtpTeid) != m_teidToBeForwardedMap.end())
+    {
+      discardParams.targetCellId = m_teidToBeForwardedMap.find(params.gtpTeid)->second;
+      NS_LOG_LOGIC("Forward discard from " << cellsInfo->m_localCellId << " to " << discardParams.targetCellId);
+      DoDiscardMcPdcpSdus(discardParams);
+      return;
+    }
+    std::map <uint32_t, EpcX2RlcUser* >::iterator user = m_x2RlcUserMap.find(params.gtpTeid);
+    std::map <uint32_t, EpcX2RlcUser* >::iterator user_2 = m_x2RlcUserMap_2.find(params.gtpTeid);
+    if (!isAdditionalMmWave && user != m_x2RlcUserMap.end() && user->second != 0)
+    {
+      user->second->DiscardMcPdcpSdus(discardParams);
+    }
+    else if (isAdditionalMmWave && user_2 != m_x2RlcUserMap_2.end() && user_2->second != 0)
+    {
+      user_2->second->DiscardMcPdcpSdus(discardParams);
+    }
+    else
+    {
+      NS_LOG_INFO("No RLC for teid " << params.gtpTeid << ", discard ignored");
+    }
+    return;
+  }
+
+  if (gtpu.GetMessageType () == EpcX2Header::McForwardDownlinkDataBatch
+      || gtpu.GetMessageType () == EpcX2Header::McForwardUplinkDataBatch
+      || gtpu.GetMessageType () == EpcX2Header::McRlcBufferTransfer)
+  {
+    ReceiveMcPdcpPdus (params, gtpu.GetMessageType ());
+    return;
+  }
+
   if(m_teidToBeForwardedMap.find(params.gtpTeid) == m_teidToBeForwardedMap.end())
   {
     if(gtpu.GetMessageType() == EpcX2Header::McForwardDownlinkData)
@@ -755,6 +837,91 @@ EpcX2::RecvFromX2uSocket (Ptr<Socket> socket)
   }
 }
 
+void
+EpcX2::ReceiveMcPdcpPdus (EpcX2SapUser::UeDataParams params, uint8_t messageType)
+{
+  NS_LOG_FUNCTION (this << params.gtpTeid << (uint32_t) messageType);
+
+  EpcX2McPduBatchHeader batchHeader;
+  params.ueData->RemoveHeader (batchHeader);
+  std::vector<uint16_t> sizes = batchHeader.GetPduSizes ();
+  NS_LOG_LOGIC ("X2-U container of " << sizes.size () << " PDCP PDUs");
+
+  std::vector<EpcX2SapUser::UeDataParams> pdus;
+  uint32_t offset = 0;
+  for (std::vector<uint16_t>::iterator it = sizes.begin (); it != sizes.end (); ++it)
+    {
+      EpcX2SapUser::UeDataParams pdu = params;
+      pdu.ueData = params.ueData->CreateFragment (offset, *it);
+      offset += *it;
+      pdus.push_back (pdu);
+    }
+
+  std::map <uint32_t, uint16_t>::iterator forward = m_teidToBeForwardedMap.find (params.gtpTeid);
+  if (forward != m_teidToBeForwardedMap.end () && messageType == EpcX2Header::McRlcBufferTransfer)
+  {
+    // the UE moved again, pass the buffer on as a whole
+    EpcX2SapProvider::RlcBufferTransferParams transfer;
+    transfer.sourceCellId = params.targetCellId;
+    transfer.targetCellId = forward->second;
+    transfer.gtpTeid = params.gtpTeid;
+    for (std::vector<EpcX2SapUser::UeDataParams>::iterator it = pdus.begin (); it != pdus.end (); ++it)
+      {
+        transfer.pdcpPdus.push_back (it->ueData);
+      }
+    DoTransferRlcBuffer (transfer);
+    return;
+  }
+  if (forward != m_teidToBeForwardedMap.end ())
+  {
+    // received during a secondary cell HO, forward to the target cell
+    NS_LOG_LOGIC ("Forward " << pdus.size () << " PDUs from " << params.targetCellId << " to " << forward->second);
+    for (std::vector<EpcX2SapUser::UeDataParams>::iterator it = pdus.begin (); it != pdus.end (); ++it)
+      {
+        it->targetCellId = forward->second;
+        DoSendMcPdcpPdu (*it);
+      }
+    return;
+  }
+
+  if (messageType != EpcX2Header::McForwardUplinkDataBatch)
+  {
+    for (std::vector<EpcX2SapUser::UeDataParams>::iterator it = pdus.begin (); it != pdus.end (); ++it)
+      {
+        PdcpTag pdcpTag (Simulator::Now ());
+        it->ueData->AddByteTag (pdcpTag);
+      }
+    std::map <uint32_t, EpcX2RlcUser* >::iterator user = m_x2RlcUserMap.find (params.gtpTeid);
+    std::map <uint32_t, EpcX2RlcUser* >::iterator user_2 = m_x2RlcUserMap_2.find (params.gtpTeid);
+    if (!isAdditionalMmWave && user != m_x2RlcUserMap.end () && user->second != 0)
+    {
+      user->second->SendMcPdcpSdus (pdus);
+    }
+    else if (isAdditionalMmWave && user_2 != m_x2RlcUserMap_2.end () && user_2->second != 0)
+    {
+      user_2->second->SendMcPdcpSdus (pdus);
+    }
+    else
+    {
+      NS_LOG_INFO ("Not implemented: Forward to the other cell or to LTE");
+    }
+  }
+  else
+  {
+    NS_LOG_INFO ("Call PDCP interface");
+    std::map <uint32_t, EpcX2PdcpUser* >::iterator user = m_x2PdcpUserMap.find (params.gtpTeid);
+    if (user == m_x2PdcpUserMap.end () || user->second == 0)
+    {
+      NS_LOG_INFO ("No PDCP for teid " << params.gtpTeid << ", " << pdus.size () << " PDUs dropped");
+      return;
+    }
+    for (std::vector<EpcX2SapUser::UeDataParams>::iterator it = pdus.begin (); it != pdus.end (); ++it)
+      {
+        user->second->ReceiveMcPdcpPdu (*it);
+      }
+  }
+}
+
 //
 // Implementation of the X2 SAP Provider
 //
@@ -1371,6 +1538,12 @@ EpcX2::DoSendMcPdcpPdu(EpcX2Sap::UeDataParams params)
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
   NS_LOG_LOGIC ("gtpTeid = " << params.gtpTeid);
 
+  if (m_mcPduAggregation)
+  {
+    EnqueueMcPdcpPdu (params, EpcX2Header::McForwardDownlinkDataBatch);
+    return;
+  }
+
   NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
                  "Missing infos for targetCellId = " << params.targetCellId);
   Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
@@ -1397,6 +1570,43 @@ EpcX2::DoSendMcPdcpPdu(EpcX2Sap::UeDataParams params)
   sourceSocket->SendTo (packet, 0, InetSocketAddress (targetIpAddr, m_x2uUdpPort));  /// should be transmitted to EpcX2:RecvFromX2Socket
 }
 
+void
+EpcX2::DoDiscardMcPdcpSdus (EpcX2Sap::DiscardPdcpSduParams params)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_LOGIC ("sourceCellId = " << params.sourceCellId);
+  NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
+  NS_LOG_LOGIC ("gtpTeid = " << params.gtpTeid);
+
+  // the PDUs still waiting for their container must not arrive after the discard
+  FlushMcPdcpPdus (params.gtpTeid, params.targetCellId, EpcX2Header::McForwardDownlinkDataBatch);
+
+  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+                 "Missing infos for targetCellId = " << params.targetCellId);
+  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
+  Ptr<Socket> sourceSocket = socketInfo->m_localUserPlaneSocket;
+  Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
+
+  EpcX2DiscardPdcpSduHeader discardHeader;
+  discardHeader.SetPdcpSns (params.pdcpSns);
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (discardHeader);
+
+  GtpuHeader gtpu;
+  gtpu.SetTeid (params.gtpTeid);
+  gtpu.SetMessageType (EpcX2Header::McDiscardDownlinkData);
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  packet->AddHeader (gtpu);
+
+  EpcX2Tag tag (Simulator::Now());
+  packet->AddPacketTag (tag);
+
+  NS_LOG_INFO ("Send discard of " << params.pdcpSns.size () << " PDCP SDUs through X2 interface");
+  sourceSocket->SendTo (packet, 0, InetSocketAddress (targetIpAddr, m_x2uUdpPort));
+}
+
 void
 EpcX2::DoReceiveMcPdcpSdu(EpcX2Sap::UeDataParams params)
 {
@@ -1406,6 +1616,12 @@ EpcX2::DoReceiveMcPdcpSdu(EpcX2Sap::UeDataParams params)
   NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
   NS_LOG_LOGIC ("gtpTeid = " << params.gtpTeid);
 
+  if (m_mcPduAggregation)
+  {
+    EnqueueMcPdcpPdu (params, EpcX2Header::McForwardUplinkDataBatch);
+    return;
+  }
+
   //NS_LOG_UNCOND( m_x2InterfaceSockets.find(params.targetCellId)== m_x2InterfaceSockets.end() );
   //NS_LOG_UNCOND("forward data to other Enb");
   NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
@@ -1433,6 +1649,148 @@ EpcX2::DoReceiveMcPdcpSdu(EpcX2Sap::UeDataParams params)
   NS_LOG_INFO ("Forward MC UE DATA through X2 interface");
   sourceSocket->SendTo (packet, 0, InetSocketAddress (targetIpAddr, m_x2uUdpPort));  
 }
+
+void
+EpcX2::DoTransferRlcBuffer (EpcX2SapProvider::RlcBufferTransferParams params)
+{
+  NS_LOG_FUNCTION (this << params.gtpTeid << params.pdcpPdus.size ());
+
+  NS_LOG_LOGIC ("sourceCellId = " << params.sourceCellId);
+  NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
+  NS_LOG_LOGIC ("gtpTeid = " << params.gtpTeid);
+
+  NS_ASSERT_MSG (m_x2InterfaceSockets.find (params.targetCellId) != m_x2InterfaceSockets.end (),
+                 "Missing infos for targetCellId = " << params.targetCellId);
+  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [params.targetCellId];
+  Ptr<Socket> sourceSocket = socketInfo->m_localUserPlaneSocket;
+  Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
+
+  // the PDUs already waiting for their container must arrive first
+  FlushMcPdcpPdus (params.gtpTeid, params.targetCellId, EpcX2Header::McForwardDownlinkDataBatch);
+
+  std::vector< Ptr<Packet> >::iterator pdu = params.pdcpPdus.begin ();
+  while (pdu != params.pdcpPdus.end ())
+    {
+      // one message for the whole buffer, unless it does not fit
+      Ptr<Packet> packet = Create<Packet> ();
+      std::vector<uint16_t> sizes;
+      uint32_t bytes = 0;
+      for (; pdu != params.pdcpPdus.end (); ++pdu)
+        {
+          uint32_t size = (*pdu)->GetSize ();
+          NS_ASSERT_MSG (size <= 0xffff, "PDCP PDU too big for an X2-U container");
+          if (!sizes.empty () && bytes + size > MAX_RLC_BUFFER_TRANSFER_BYTES)
+            {
+              break;
+            }
+          sizes.push_back (size);
+          bytes += size;
+          packet->AddAtEnd (*pdu);
+        }
+      EpcX2McPduBatchHeader batchHeader;
+      batchHeader.SetPduSizes (sizes);
+      packet->AddHeader (batchHeader);
+
+      GtpuHeader gtpu;
+      gtpu.SetTeid (params.gtpTeid);
+      gtpu.SetMessageType (EpcX2Header::McRlcBufferTransfer);
+      gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+      packet->AddHeader (gtpu);
+
+      EpcX2Tag tag (Simulator::Now ());
+      packet->AddPacketTag (tag);
+
+      m_txRlcBuffer (params.sourceCellId, params.targetCellId, params.gtpTeid, sizes.size (), bytes);
+
+      NS_LOG_INFO ("Send the RLC buffer of teid " << params.gtpTeid << ", " << sizes.size ()
+                   << " PDCP PDUs, through X2 interface");
+      sourceSocket->SendTo (packet, 0, InetSocketAddress (targetIpAddr, m_x2uUdpPort));
+    }
+}
+
+void
+EpcX2::EnqueueMcPdcpPdu (EpcX2SapProvider::UeDataParams params, uint8_t messageType)
+{
+  NS_LOG_FUNCTION (this << params.gtpTeid << (uint32_t) messageType);
+
+  uint32_t size = params.ueData->GetSize ();
+  NS_ASSERT_MSG (size <= 0xffff, "PDCP PDU too big for an X2-U container");
+  McPduBatchKey key (std::make_pair (params.gtpTeid, params.targetCellId), messageType);
+  std::map < McPduBatchKey, McPduBatch >::iterator it = m_mcPduBatches.find (key);
+  if (it != m_mcPduBatches.end () && it->second.bytes + size > m_mcAggregationMaxBytes)
+  {
+    FlushMcPdcpPdus (params.gtpTeid, params.targetCellId, messageType);
+  }
+
+  McPduBatch &batch = m_mcPduBatches[key];
+  if (batch.pdus.empty ())
+  {
+    batch.sourceCellId = params.sourceCellId;
+    batch.targetCellId = params.targetCellId;
+    batch.bytes = 0;
+    batch.enqueueTimeSum = 0;
+    batch.flushEvent = Simulator::Schedule (m_mcAggregationInterval, &EpcX2::FlushMcPdcpPdus, this,
+                                            params.gtpTeid, params.targetCellId, messageType);
+  }
+  batch.pdus.push_back (params.ueData);
+  batch.bytes += size;
+  batch.enqueueTimeSum += Simulator::Now ().GetNanoSeconds ();
+  NS_LOG_LOGIC ("X2-U container of teid " << params.gtpTeid << ": " << batch.pdus.size ()
+                << " PDUs, " << batch.bytes << " bytes");
+
+  if (batch.bytes >= m_mcAggregationMaxBytes)
+  {
+    FlushMcPdcpPdus (params.gtpTeid, params.targetCellId, messageType);
+  }
+}
+
+void
+EpcX2::FlushMcPdcpPdus (uint32_t teid, uint16_t targetCellId, uint8_t messageType)
+{
+  NS_LOG_FUNCTION (this << teid << targetCellId << (uint32_t) messageType);
+
+  std::map < McPduBatchKey, McPduBatch >::iterator it =
+    m_mcPduBatches.find (McPduBatchKey (std::make_pair (teid, targetCellId), messageType));
+  if (it == m_mcPduBatches.end ())
+  {
+    return;
+  }
+  McPduBatch batch = it->second;
+  m_mcPduBatches.erase (it);
+  batch.flushEvent.Cancel ();
+
+  NS_ASSERT_MSG (m_x2InterfaceSockets.find (batch.targetCellId) != m_x2InterfaceSockets.end (),
+                 "Missing infos for targetCellId = " << batch.targetCellId);
+  Ptr<X2IfaceInfo> socketInfo = m_x2InterfaceSockets [batch.targetCellId];
+  Ptr<Socket> sourceSocket = socketInfo->m_localUserPlaneSocket;
+  Ipv4Address targetIpAddr = socketInfo->m_remoteIpAddr;
+
+  Ptr<Packet> packet = Create<Packet> ();
+  std::vector<uint16_t> sizes;
+  for (std::vector< Ptr<Packet> >::iterator pdu = batch.pdus.begin (); pdu != batch.pdus.end (); ++pdu)
+    {
+      sizes.push_back ((*pdu)->GetSize ());
+      packet->AddAtEnd (*pdu);
+    }
+  EpcX2McPduBatchHeader batchHeader;
+  batchHeader.SetPduSizes (sizes);
+  packet->AddHeader (batchHeader);
+
+  GtpuHeader gtpu;
+  gtpu.SetTeid (teid);
+  gtpu.SetMessageType (messageType);
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  packet->AddHeader (gtpu);
+
+  EpcX2Tag tag (Simulator::Now ());
+  packet->AddPacketTag (tag);
+
+  uint64_t delay = Simulator::Now ().GetNanoSeconds () - batch.enqueueTimeSum / (int64_t) batch.pdus.size ();
+  m_txMcPduBatch (batch.sourceCellId, batch.targetCellId, teid, batch.pdus.size (), batch.bytes, delay);
+
+  NS_LOG_INFO ("Send " << batch.pdus.size () << " MC PDCP PDUs in an X2-U container");
+  sourceSocket->SendTo (packet, 0, InetSocketAddress (targetIpAddr, m_x2uUdpPort));
+}
 void
 EpcX2::DoReceiveAssistantInformation(EpcX2Sap::AssistantInformationForSplitting params){ //sjkang
 NS_LOG_INFO("received assistant information at X2" << params.sourceCellId << "\t" << params.targetCellId);
@@ -1462,6 +1820,9 @@ NS_LOG_INFO (this);
  assistantInfoHeader.SetSourceCellId(params.sourceCellId);
  assistantInfoHeader.SetDrbId(params.drbId);
  assistantInfoHeader.SetRnti(params.rnti);
+ assistantInfoHeader.SetDesiredBufferSize(params.Desired_Buffer_Size);
+ assistantInfoHeader.SetReportTime(params.Report_Time);
+ assistantInfoHeader.SetDeliveredPdcpSn(params.Delivered_Pdcp_Sn);
  EpcX2Header epcX2Header;
  epcX2Header.SetMessageType(EpcX2Header::McAssistantInfoForwarding);
  epcX2Header.SetProcedureCode(EpcX2Header::SendingAssistantInformation);
@@ -31,6 +31,8 @@
 #include "ns3/object.h"
  #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
 
 #include "ns3/epc-x2-sap.h"
 
@@ -168,6 +170,33 @@ public:
   typedef void (* ReceiveTracedCallback)
     (uint16_t sourceCellId, uint16_t targetCellId, uint32_t bytes, uint64_t delay, bool data);
 
+  /**
+   * TracedCallback signature for the transmission of an X2-U container
+   * of PDCP PDUs
+   *
+   * \param [in] source
+   * \param [in] target
+   * \param [in] teid The GTP TEID of the bearer.
+   * \param [in] numPdus The number of PDCP PDUs in the container.
+   * \param [in] bytes The size of the PDCP PDUs.
+   * \param [in] delay Mean time the PDUs waited for the container, in ns.
+   */
+  typedef void (* McPduBatchTracedCallback)
+    (uint16_t sourceCellId, uint16_t targetCellId, uint32_t teid, uint32_t numPdus, uint32_t bytes, uint64_t delay);
+
+  /**
+   * TracedCallback signature for the transmission of the RLC buffer of a
+   * bearer in a secondary cell HO
+   *
+   * \param [in] source
+   * \param [in] target
+   * \param [in] teid The GTP TEID of the bearer.
+   * \param [in] numPdus The number of PDCP PDUs in the X2-U message.
+   * \param [in] bytes The size of the PDCP PDUs.
+   */
+  typedef void (* RlcBufferTracedCallback)
+    (uint16_t sourceCellId, uint16_t targetCellId, uint32_t teid, uint32_t numPdus, uint32_t bytes);
+
 protected:
   // Interface provided by EpcX2SapProvider
 virtual  void DoReceiveAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info);//sjkang1114
@@ -184,7 +213,9 @@ virtual  void DoReceiveAssistantInformation(EpcX2Sap::AssistantInformationForSpl
   virtual void DoSendResourceStatusUpdate (EpcX2SapProvider::ResourceStatusUpdateParams params);
   virtual void DoSendUeData (EpcX2SapProvider::UeDataParams params);
   virtual void DoSendMcPdcpPdu (EpcX2SapProvider::UeDataParams params);
+  virtual void DoDiscardMcPdcpSdus (EpcX2SapProvider::DiscardPdcpSduParams params);
   virtual void DoReceiveMcPdcpSdu (EpcX2SapProvider::UeDataParams params);
+  virtual void DoTransferRlcBuffer (EpcX2SapProvider::RlcBufferTransferParams params);
   //virtual void DoReceiveAssistantInformation(EpcX2SapProvider::AssistantInformationForSplitting info); //sjkang1114
   virtual void DoSendUeSinrUpdate(EpcX2Sap::UeImsiSinrParams params);
   virtual void DoSendMcHandoverRequest (EpcX2SapProvider::SecondaryHandoverParams params);
@@ -198,6 +229,34 @@ virtual  void DoReceiveAssistantInformation(EpcX2Sap::AssistantInformationForSpl
   virtual void DoAddTeidToBeForwarded(uint32_t teid, uint16_t targetCellId);
   virtual void DoRemoveTeidToBeForwarded(uint32_t teid);
 
+  /**
+   * Add a PDCP PDU of a split bearer to the X2-U container of its bearer
+   * and target cell, and send the container if it is full
+   *
+   * \param params the PDU
+   * \param messageType McForwardDownlinkDataBatch or McForwardUplinkDataBatch
+   */
+  void EnqueueMcPdcpPdu (EpcX2SapProvider::UeDataParams params, uint8_t messageType);
+
+  /**
+   * Send the X2-U container of a bearer to a cell, if it holds any PDCP PDU
+   *
+   * \param teid the GTP TEID of the bearer
+   * \param targetCellId the cell the container is sent to
+   * \param messageType McForwardDownlinkDataBatch or McForwardUplinkDataBatch
+   */
+  void FlushMcPdcpPdus (uint32_t teid, uint16_t targetCellId, uint8_t messageType);
+
+  /**
+   * Unpack an X2-U container and deliver its PDCP PDUs, to the RLC in one
+   * call in downlink and to the PDCP in uplink
+   *
+   * \param params the container, without its GTP-U header
+   * \param messageType McForwardDownlinkDataBatch, McForwardUplinkDataBatch
+   * or McRlcBufferTransfer
+   */
+  void ReceiveMcPdcpPdus (EpcX2SapUser::UeDataParams params, uint8_t messageType);
+
   EpcX2SapUser* m_x2SapUser;
   EpcX2SapProvider* m_x2SapProvider;
   
@@ -247,6 +306,37 @@ private:
    */
   std::map <uint32_t, uint16_t> m_teidToBeForwardedMap;
 
+  /**
+   * Whether the PDCP PDUs of the split bearers are sent in X2-U containers
+   */
+  bool m_mcPduAggregation;
+  Time m_mcAggregationInterval;
+  uint32_t m_mcAggregationMaxBytes;
+
+  /**
+   * PDCP PDUs waiting for the X2-U container of their bearer
+   */
+  struct McPduBatch
+  {
+    uint16_t sourceCellId;
+    uint16_t targetCellId;
+    std::vector< Ptr<Packet> > pdus;
+    uint32_t bytes;
+    int64_t enqueueTimeSum; // in ns, for the mean aggregation delay
+    EventId flushEvent;
+  };
+
+  /**
+   * ((gtpTeid, target cell ID), message type) of an X2-U container. The
+   * legs of a split bearer fill their own container.
+   */
+  typedef std::pair<std::pair<uint32_t, uint16_t>, uint8_t> McPduBatchKey;
+
+  std::map < McPduBatchKey, McPduBatch > m_mcPduBatches;
+
+  TracedCallback<uint16_t, uint16_t, uint32_t, uint32_t, uint32_t, uint64_t> m_txMcPduBatch;
+  TracedCallback<uint16_t, uint16_t, uint32_t, uint32_t, uint32_t> m_txRlcBuffer;
+
 };
 
 } //namespace ns3
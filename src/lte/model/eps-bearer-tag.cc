@@ -21,6 +21,7 @@
 
 
 #include "eps-bearer-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -31,7 +32,7 @@ NS_OBJECT_ENSURE_REGISTERED (EpsBearerTag);
 TypeId
 EpsBearerTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::EpsBearerTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::EpsBearerTag")
     .SetParent<Tag> ()
     .SetGroupName("Lte")
     .AddConstructor<EpsBearerTag> ()
@@ -43,7 +44,7 @@ EpsBearerTag::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&EpsBearerTag::GetBid),
                    MakeUintegerChecker<uint8_t> ())
-  ;
+  );
   return tid;
 }
 
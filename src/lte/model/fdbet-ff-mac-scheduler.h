@@ -22,54 +22,20 @@
 #ifndef FDBET_FF_MAC_SCHEDULER_H
 #define FDBET_FF_MAC_SCHEDULER_H
 
-#include <ns3/lte-common.h>
-#include <ns3/ff-mac-csched-sap.h>
-#include <ns3/ff-mac-sched-sap.h>
-#include <ns3/ff-mac-scheduler.h>
-#include <vector>
-#include <map>
-#include <ns3/nstime.h>
-#include <ns3/lte-amc.h>
-#include <ns3/lte-ffr-sap.h>
-
-// value for SINR outside the range defined by FF-API, used to indicate that there
-// is no CQI for this element
-#define NO_SINR -5000
-
-
-#define HARQ_PROC_NUM 8
-#define HARQ_DL_TIMEOUT 11
+#include <ns3/lte-ff-mac-scheduler-traits.h>
+#include <ns3/ff-mac-scheduler-engine.h>
+#include <ns3/ff-mac-scheduler-policies.h>
 
 namespace ns3 {
 
-
-typedef std::vector < uint8_t > DlHarqProcessesStatus_t;
-typedef std::vector < uint8_t > DlHarqProcessesTimer_t;
-typedef std::vector < DlDciListElement_s > DlHarqProcessesDciBuffer_t;
-typedef std::vector < std::vector <struct RlcPduListElement_s> > RlcPduList_t; // vector of the LCs and layers per UE
-typedef std::vector < RlcPduList_t > DlHarqRlcPduListBuffer_t; // vector of the 8 HARQ processes per UE
-
-typedef std::vector < UlDciListElement_s > UlHarqProcessesDciBuffer_t;
-typedef std::vector < uint8_t > UlHarqProcessesStatus_t;
-
-
-struct fdbetsFlowPerf_t
-{
-  Time flowStart;
-  unsigned long totalBytesTransmitted;
-  unsigned int lastTtiBytesTrasmitted;
-  double lastAveragedThroughput;
-};
-
-
 /**
  * \ingroup ff-api
  * \brief Implements the SCHED SAP and CSCHED SAP for a Frequency Domain Blind Equal Throughput scheduler
  *
- * This class implements the interface defined by the FfMacScheduler abstract class
+ * The SAPs are implemented by FfMacSchedulerEngine, with the RBG
+ * allocation of FdbetFfMacPolicy.
  */
-
-class FdBetFfMacScheduler : public FfMacScheduler
+class FdBetFfMacScheduler : public FfMacSchedulerEngine<LteFfMacSchedulerTraits, FdbetFfMacPolicy>
 {
 public:
   /**
@@ -84,212 +50,17 @@ public:
    */
   virtual ~FdBetFfMacScheduler ();
 
-  // inherited from Object
-  virtual void DoDispose (void);
-  static TypeId GetTypeId (void);
-
-  // inherited from FfMacScheduler
-  virtual void SetFfMacCschedSapUser (FfMacCschedSapUser* s);
-  virtual void SetFfMacSchedSapUser (FfMacSchedSapUser* s);
-  virtual FfMacCschedSapProvider* GetFfMacCschedSapProvider ();
-  virtual FfMacSchedSapProvider* GetFfMacSchedSapProvider ();
-
-  // FFR SAPs
-  virtual void SetLteFfrSapProvider (LteFfrSapProvider* s);
-  virtual LteFfrSapUser* GetLteFfrSapUser ();
-
-  friend class FdBetSchedulerMemberCschedSapProvider;
-  friend class FdBetSchedulerMemberSchedSapProvider;
-
-  void TransmissionModeConfigurationUpdate (uint16_t rnti, uint8_t txMode);
-
-private:
-  //
-  // Implementation of the CSCHED API primitives
-  // (See 4.1 for description of the primitives)
-  //
-
-  void DoCschedCellConfigReq (const struct FfMacCschedSapProvider::CschedCellConfigReqParameters& params);
-
-  void DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params);
-
-  void DoCschedLcConfigReq (const struct FfMacCschedSapProvider::CschedLcConfigReqParameters& params);
-
-  void DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::CschedLcReleaseReqParameters& params);
-
-  void DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::CschedUeReleaseReqParameters& params);
-
-  //
-  // Implementation of the SCHED API primitives
-  // (See 4.2 for description of the primitives)
-  //
-
-  void DoSchedDlRlcBufferReq (const struct FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
-
-  void DoSchedDlPagingBufferReq (const struct FfMacSchedSapProvider::SchedDlPagingBufferReqParameters& params);
-
-  void DoSchedDlMacBufferReq (const struct FfMacSchedSapProvider::SchedDlMacBufferReqParameters& params);
-
-  void DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params);
-
-  void DoSchedDlRachInfoReq (const struct FfMacSchedSapProvider::SchedDlRachInfoReqParameters& params);
-
-  void DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
-
-  void DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::SchedUlTriggerReqParameters& params);
-
-  void DoSchedUlNoiseInterferenceReq (const struct FfMacSchedSapProvider::SchedUlNoiseInterferenceReqParameters& params);
-
-  void DoSchedUlSrInfoReq (const struct FfMacSchedSapProvider::SchedUlSrInfoReqParameters& params);
-
-  void DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
-
-  void DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
-
-
-  int GetRbgSize (int dlbandwidth);
-
-  int LcActivePerFlow (uint16_t rnti);
-
-  double EstimateUlSinr (uint16_t rnti, uint16_t rb);
-
-  void RefreshDlCqiMaps (void);
-  void RefreshUlCqiMaps (void);
-
-  void UpdateDlRlcBufferInfo (uint16_t rnti, uint8_t lcid, uint16_t size);
-  void UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size);
-
   /**
-  * \brief Update and return a new process Id for the RNTI specified
-  *
-  * \param rnti the RNTI of the UE to be updated
-  * \return the process id  value
-  */
-  uint8_t UpdateHarqProcessId (uint16_t rnti);
-
-  /**
-  * \brief Return the availability of free process for the RNTI specified
-  *
-  * \param rnti the RNTI of the UE to be updated
-  * \return the process id  value
-  */
-  uint8_t HarqProcessAvailability (uint16_t rnti);
-
-  /**
-  * \brief Refresh HARQ processes according to the timers
-  *
-  */
-  void RefreshHarqProcesses ();
-
-  Ptr<LteAmc> m_amc;
-
-  /*
-   * Vectors of UE's LC info
-  */
-  std::map <LteFlowId_t, FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
-
-
-  /*
-  * Map of UE statistics (per RNTI basis) in downlink
-  */
-  std::map <uint16_t, fdbetsFlowPerf_t> m_flowStatsDl;
-
-  /*
-  * Map of UE statistics (per RNTI basis)
-  */
-  std::map <uint16_t, fdbetsFlowPerf_t> m_flowStatsUl;
-
-
-  /*
-  * Map of UE's DL CQI P01 received
-  */
-  std::map <uint16_t,uint8_t> m_p10CqiRxed;
-  /*
-  * Map of UE's timers on DL CQI P01 received
-  */
-  std::map <uint16_t,uint32_t> m_p10CqiTimers;
-
-  /*
-  * Map of UE's DL CQI A30 received
-  */
-  std::map <uint16_t,SbMeasResult_s> m_a30CqiRxed;
-  /*
-  * Map of UE's timers on DL CQI A30 received
-  */
-  std::map <uint16_t,uint32_t> m_a30CqiTimers;
-
-  /*
-  * Map of previous allocated UE per RBG
-  * (used to retrieve info from UL-CQI)
-  */
-  std::map <uint16_t, std::vector <uint16_t> > m_allocationMaps;
-
-  /*
-  * Map of UEs' UL-CQI per RBG
-  */
-  std::map <uint16_t, std::vector <double> > m_ueCqi;
-  /*
-  * Map of UEs' timers on UL-CQI per RBG
-  */
-  std::map <uint16_t, uint32_t> m_ueCqiTimers;
-
-  /*
-  * Map of UE's buffer status reports received
-  */
-  std::map <uint16_t,uint32_t> m_ceBsrRxed;
-
-  // MAC SAPs
-  FfMacCschedSapUser* m_cschedSapUser;
-  FfMacSchedSapUser* m_schedSapUser;
-  FfMacCschedSapProvider* m_cschedSapProvider;
-  FfMacSchedSapProvider* m_schedSapProvider;
-
-  // FFR SAPs
-  LteFfrSapUser* m_ffrSapUser;
-  LteFfrSapProvider* m_ffrSapProvider;
-
-  // Internal parameters
-  FfMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig;
-
-
-  double m_timeWindow;
-
-  uint16_t m_nextRntiUl; // RNTI of the next user to be served next scheduling in UL
-
-  uint32_t m_cqiTimersThreshold; // # of TTIs for which a CQI canbe considered valid
-
-  std::map <uint16_t,uint8_t> m_uesTxMode; // txMode of the UEs
-
-  // HARQ attributes
-  /**
-  * m_harqOn when false inhibit te HARQ mechanisms (by default active)
-  */
-  bool m_harqOn;
-  std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId;
-  //HARQ status
-  // 0: process Id available
-  // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
-  std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
-  std::map <uint16_t, DlHarqProcessesDciBuffer_t> m_dlHarqProcessesDciBuffer;
-  std::map <uint16_t, DlHarqRlcPduListBuffer_t> m_dlHarqProcessesRlcPduListBuffer;
-  std::vector <DlInfoListElement_s> m_dlInfoListBuffered; // HARQ retx buffered
-
-  std::map <uint16_t, uint8_t> m_ulHarqCurrentProcessId;
-  //HARQ status
-  // 0: process Id available
-  // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, UlHarqProcessesStatus_t> m_ulHarqProcessesStatus;
-  std::map <uint16_t, UlHarqProcessesDciBuffer_t> m_ulHarqProcessesDciBuffer;
-
-
-  // RACH attributes
-  std::vector <struct RachListElement_s> m_rachList;
-  std::vector <uint16_t> m_rachAllocationMap;
-  uint8_t m_ulGrantMcs; // MCS for UL grant (default 0)
-
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
 };
 
+/// log component of FdBetFfMacScheduler
+template <>
+LogComponent FfMacSchedulerEngine<LteFfMacSchedulerTraits, FdbetFfMacPolicy>::g_log;
+
 } // namespace ns3
 
 #endif /* FDBET_FF_MAC_SCHEDULER_H */
@@ -0,0 +1,444 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_RBG_ALLOCATOR_H
+#define FF_MAC_RBG_ALLOCATOR_H
+
+#include <ns3/ptr.h>
+#include <ns3/assert.h>
+#include <ns3/ff-mac-common.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * A UE competing for the RBGs of a frequency domain scheduler in the
+ * current TTI. The scheduler fills one entry per UE that can be served
+ * (HARQ process available, not retransmitting, data to send), so that
+ * the allocation loop works on a dense array instead of looking up the
+ * scheduler maps for every RBG.
+ */
+struct FfMacRbgCandidate
+{
+  uint16_t m_rnti;                        ///< RNTI
+  uint8_t m_nLayer;                       ///< number of layers of the transmission mode
+  const std::vector<double> *m_sbRate;    ///< rates of the last A30 CQI report, 0 if none
+  std::vector<uint16_t> *m_rbgs;          ///< RBGs assigned to the UE in this TTI
+  double m_weight;                        ///< UE weight used by the metric
+};
+
+/**
+ * \ingroup lte
+ *
+ * Metric of the PF and TTA schedulers: the achievable rate on the RBG
+ * divided by the weight of the UE, i.e. its averaged throughput (PF) or its
+ * achievable wideband rate (TTA).
+ */
+struct FfMacRelativeRateMetric
+{
+  /**
+   * \param sbRate achievable rate of the UE on the RBG
+   * \param ue the UE
+   * \return the metric
+   */
+  static double Compute (double sbRate, const FfMacRbgCandidate &ue)
+  {
+    return sbRate / ue.m_weight;
+  }
+};
+
+/**
+ * \ingroup lte
+ *
+ * Metric of the FDMT scheduler: the achievable rate on the RBG.
+ */
+struct FfMacMaxRateMetric
+{
+  /**
+   * \param sbRate achievable rate of the UE on the RBG
+   * \param ue the UE
+   * \return the metric
+   */
+  static double Compute (double sbRate, const FfMacRbgCandidate &ue)
+  {
+    return sbRate;
+  }
+};
+
+/**
+ * \ingroup lte
+ *
+ * RBG allocation shared by the FF MAC schedulers of the lte and nr
+ * modules. The AMC module (LteAmc or NrAmc) and the FFR SAP provider
+ * (LteFfrSapProvider or NrFfrSapProvider) are template parameters, so that
+ * both modules use this header.
+ *
+ * FfMacSchedulerEngine keeps one allocator as a member:
+ * - Configure() is called once the RBG size is known, and tabulates the
+ *   achievable rate of one layer on one RBG for every CQI value.
+ * - ComputeSbRates() is called by the CQI handler for each A30 report, and
+ *   converts the subband CQIs into rates once per report instead of once
+ *   per TTI. The scheduler keeps the rates with the other state of the UE.
+ *
+ * In the DL trigger the policy of the engine then uses:
+ * - Allocate() to assign each RBG to the UE with the highest metric (PF,
+ *   FDMT, TTA);
+ * - AllocateAll() to assign the free RBGs to one UE (TDMT, TDBET, TDTBFQ);
+ * - GetSbRate(), GetWbRate() and AssignRbg() for the schedulers with their
+ *   own per-RBG loop (PSS, CQA, FDBET, FDTBFQ);
+ * - AllocateNext() to assign the next free RBGs in order (RR).
+ */
+template <class Amc, class FfrSap>
+class FfMacRbgAllocator
+{
+public:
+  FfMacRbgAllocator ();
+
+  /**
+   * Tabulate the rate of each CQI. The rates computed by ComputeSbRates()
+   * with another RBG size must be computed again.
+   *
+   * \param amc the AMC module of the scheduler
+   * \param rbgSize the number of RBs of an RBG
+   */
+  void Configure (Ptr<Amc> amc, int rbgSize);
+
+  /**
+   * Convert an A30 CQI report into achievable rates
+   *
+   * \param sbMeas the subband CQI report
+   * \param rates the rates, MAX_CODEWORDS entries per RBG, negative for
+   * the RBGs out of range
+   */
+  void ComputeSbRates (const SbMeasResult_s &sbMeas, std::vector<double> &rates) const;
+
+  /**
+   * \param cqi the CQI
+   * \return the achievable rate of one layer on one RBG, in bytes per second
+   */
+  double GetLayerRate (uint8_t cqi) const;
+
+  /**
+   * \param cqi the wideband CQI
+   * \param nLayer the number of layers
+   * \return the achievable rate on one RBG summed over the layers
+   */
+  double GetWbRate (uint8_t cqi, uint8_t nLayer) const;
+
+  /**
+   * \param rnti the RNTI of the UE
+   * \param nLayer the number of layers of its transmission mode
+   * \param sbRate the rates of its last A30 report, 0 if none
+   * \param rbgs the RBGs assigned to the UE, filled by Allocate()
+   * \param weight the weight used by the metric
+   * \return the UE
+   */
+  static FfMacRbgCandidate MakeCandidate (uint16_t rnti, uint8_t nLayer, const std::vector<double> *sbRate,
+                                          std::vector<uint16_t> *rbgs, double weight);
+
+  /**
+   * \param ue the UE
+   * \param rbg the RBG
+   * \param rate the achievable rate of the UE on the RBG, summed over its layers
+   * \return false if the RBG is out of range for the UE (all CQIs 0)
+   */
+  bool GetSbRate (const FfMacRbgCandidate &ue, int rbg, double &rate) const;
+
+  /**
+   * Assign each free RBG to the UE with the highest metric. On equal
+   * metrics the UE found first in the array wins. The metric is a template
+   * parameter, so that it is inlined in the loop over RBGs and UEs.
+   *
+   * \param ues the UEs that can be served, sorted by RNTI; the RBGs are
+   * appended to their m_rbgs
+   * \param ffr if not 0, the RBGs the FFR algorithm forbids to a UE are skipped
+   * \param rbgMap the RBGs already in use, updated
+   */
+  template <class Metric>
+  void Allocate (const std::vector<FfMacRbgCandidate> &ues, FfrSap *ffr,
+                 std::vector<bool> &rbgMap) const;
+
+  /**
+   * Assign all the free RBGs to one UE
+   *
+   * \param rnti the RNTI of the UE
+   * \param ffr if not 0, the RBGs the FFR algorithm forbids to the UE are skipped
+   * \param rbgMap the RBGs already in use, updated
+   * \param rbgs the RBGs assigned to the UE, updated
+   */
+  static void AllocateAll (uint16_t rnti, FfrSap *ffr, std::vector<bool> &rbgMap,
+                           std::vector<uint16_t> &rbgs);
+
+  /**
+   * Assign one RBG to a UE
+   *
+   * \param rbg the RBG
+   * \param rbgMap the RBGs already in use, updated
+   * \param rbgs the RBGs assigned to the UE, updated
+   */
+  static void AssignRbg (uint16_t rbg, std::vector<bool> &rbgMap, std::vector<uint16_t> &rbgs);
+
+  /**
+   * Take the next free RBGs in order
+   *
+   * \param rbgCount the number of RBGs to take
+   * \param nextRbg the first RBG to look at, moved past the last one taken
+   * \param rbgMap the RBGs already in use, updated
+   * \param rbgs the RBGs assigned to the UE, updated
+   */
+  static void AllocateNext (int rbgCount, int &nextRbg, std::vector<bool> &rbgMap,
+                            std::vector<uint16_t> &rbgs);
+
+private:
+  /**
+   * \param mcs the MCS
+   * \return the achievable rate of one layer on one RBG
+   */
+  double ComputeRate (int mcs) const;
+
+  static const uint8_t MAX_CQI = 15;       ///< highest CQI of table 7.2.3-1 of 36.213
+  static const uint8_t MAX_CODEWORDS = 2;  ///< subband CQIs of an A30 report per RBG
+
+  Ptr<Amc> m_amc;                    ///< AMC module
+  int m_rbgSize;                     ///< RBs per RBG
+  double m_layerRate[MAX_CQI + 1];   ///< achievable rate of one layer for each CQI
+  double m_worstRate;                ///< achievable rate at MCS 0, used without subband info
+};
+
+
+template <class Amc, class FfrSap>
+FfMacRbgAllocator<Amc, FfrSap>::FfMacRbgAllocator ()
+  : m_rbgSize (0),
+    m_worstRate (0.0)
+{
+  for (uint8_t cqi = 0; cqi <= MAX_CQI; cqi++)
+    {
+      m_layerRate[cqi] = 0.0;
+    }
+}
+
+template <class Amc, class FfrSap>
+void
+FfMacRbgAllocator<Amc, FfrSap>::Configure (Ptr<Amc> amc, int rbgSize)
+{
+  if (m_amc == amc && m_rbgSize == rbgSize)
+    {
+      return;
+    }
+  m_amc = amc;
+  m_rbgSize = rbgSize;
+  for (uint8_t cqi = 0; cqi <= MAX_CQI; cqi++)
+    {
+      m_layerRate[cqi] = ComputeRate (m_amc->GetMcsFromCqi (cqi));
+    }
+  m_worstRate = ComputeRate (0);
+}
+
+template <class Amc, class FfrSap>
+double
+FfMacRbgAllocator<Amc, FfrSap>::ComputeRate (int mcs) const
+{
+  return ((m_amc->GetTbSizeFromMcs (mcs, m_rbgSize) / 8) / 0.001);   // = TB size / TTI
+}
+
+template <class Amc, class FfrSap>
+void
+FfMacRbgAllocator<Amc, FfrSap>::ComputeSbRates (const SbMeasResult_s &sbMeas, std::vector<double> &rates) const
+{
+  NS_ASSERT_MSG (m_amc != 0, "CQI report before the allocator is configured");
+  rates.resize (sbMeas.m_higherLayerSelected.size () * MAX_CODEWORDS);
+  for (uint32_t rbg = 0; rbg < sbMeas.m_higherLayerSelected.size (); rbg++)
+    {
+      const std::vector<uint8_t> &sbCqi = sbMeas.m_higherLayerSelected[rbg].m_sbCqi;
+      uint8_t cqi1 = sbCqi.at (0);
+      uint8_t cqi2 = 1;
+      if (sbCqi.size () > 1)
+        {
+          cqi2 = sbCqi.at (1);
+        }
+      for (uint8_t k = 0; k < MAX_CODEWORDS; k++)
+        {
+          if ((cqi1 == 0) && (cqi2 == 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+            {
+              rates[rbg * MAX_CODEWORDS + k] = -1.0;
+            }
+          else if (sbCqi.size () > k)
+            {
+              rates[rbg * MAX_CODEWORDS + k] = GetLayerRate (sbCqi[k]);
+            }
+          else
+            {
+              // no info on this subband -> worst MCS
+              rates[rbg * MAX_CODEWORDS + k] = m_worstRate;
+            }
+        }
+    }
+}
+
+template <class Amc, class FfrSap>
+double
+FfMacRbgAllocator<Amc, FfrSap>::GetLayerRate (uint8_t cqi) const
+{
+  if (cqi <= MAX_CQI)
+    {
+      return m_layerRate[cqi];
+    }
+  return ComputeRate (m_amc->GetMcsFromCqi (cqi));
+}
+
+template <class Amc, class FfrSap>
+double
+FfMacRbgAllocator<Amc, FfrSap>::GetWbRate (uint8_t cqi, uint8_t nLayer) const
+{
+  double rate = 0.0;
+  for (uint8_t k = 0; k < nLayer; k++)
+    {
+      rate += GetLayerRate (cqi);
+    }
+  return rate;
+}
+
+template <class Amc, class FfrSap>
+FfMacRbgCandidate
+FfMacRbgAllocator<Amc, FfrSap>::MakeCandidate (uint16_t rnti, uint8_t nLayer, const std::vector<double> *sbRate,
+                                               std::vector<uint16_t> *rbgs, double weight)
+{
+  FfMacRbgCandidate ue;
+  ue.m_rnti = rnti;
+  ue.m_nLayer = nLayer;
+  ue.m_sbRate = sbRate;
+  ue.m_rbgs = rbgs;
+  ue.m_weight = weight;
+  return ue;
+}
+
+template <class Amc, class FfrSap>
+bool
+FfMacRbgAllocator<Amc, FfrSap>::GetSbRate (const FfMacRbgCandidate &ue, int rbg, double &rate) const
+{
+  rate = 0.0;
+  if (ue.m_sbRate == 0)
+    {
+      // no subband report, start with the lowest CQI on every layer
+      for (uint8_t k = 0; k < ue.m_nLayer; k++)
+        {
+          rate += m_layerRate[1];
+        }
+      return true;
+    }
+  NS_ASSERT_MSG ((rbg + 1) * MAX_CODEWORDS <= (int) ue.m_sbRate->size (), "no subband CQI for RBG " << rbg);
+  const double *sbRate = &(*ue.m_sbRate)[rbg * MAX_CODEWORDS];
+  if (sbRate[0] < 0)
+    {
+      return false;
+    }
+  for (uint8_t k = 0; k < ue.m_nLayer; k++)
+    {
+      rate += (k < MAX_CODEWORDS) ? sbRate[k] : m_worstRate;
+    }
+  return true;
+}
+
+template <class Amc, class FfrSap>
+template <class Metric>
+void
+FfMacRbgAllocator<Amc, FfrSap>::Allocate (const std::vector<FfMacRbgCandidate> &ues, FfrSap *ffr,
+                                          std::vector<bool> &rbgMap) const
+{
+  for (uint32_t i = 0; i < rbgMap.size (); i++)
+    {
+      if (rbgMap[i])
+        {
+          continue;
+        }
+      const FfMacRbgCandidate *best = 0;
+      double metricMax = 0.0;
+      for (std::vector<FfMacRbgCandidate>::const_iterator it = ues.begin (); it != ues.end (); ++it)
+        {
+          if (ffr != 0 && !ffr->IsDlRbgAvailableForUe (i, it->m_rnti))
+            {
+              continue;
+            }
+          double sbRate;
+          if (!GetSbRate (*it, i, sbRate))
+            {
+              continue;
+            }
+          double metric = Metric::Compute (sbRate, *it);
+          if (metric > metricMax)
+            {
+              metricMax = metric;
+              best = &(*it);
+            }
+        }
+      if (best != 0)
+        {
+          AssignRbg (i, rbgMap, *best->m_rbgs);
+        }
+    }
+}
+
+template <class Amc, class FfrSap>
+void
+FfMacRbgAllocator<Amc, FfrSap>::AllocateAll (uint16_t rnti, FfrSap *ffr, std::vector<bool> &rbgMap,
+                                             std::vector<uint16_t> &rbgs)
+{
+  for (uint32_t i = 0; i < rbgMap.size (); i++)
+    {
+      if (rbgMap[i])
+        {
+          continue;
+        }
+      if (ffr != 0 && !ffr->IsDlRbgAvailableForUe (i, rnti))
+        {
+          continue;
+        }
+      rbgMap[i] = true;
+      rbgs.push_back (i);
+    }
+}
+
+template <class Amc, class FfrSap>
+void
+FfMacRbgAllocator<Amc, FfrSap>::AssignRbg (uint16_t rbg, std::vector<bool> &rbgMap, std::vector<uint16_t> &rbgs)
+{
+  rbgMap.at (rbg) = true;
+  rbgs.push_back (rbg);
+}
+
+template <class Amc, class FfrSap>
+void
+FfMacRbgAllocator<Amc, FfrSap>::AllocateNext (int rbgCount, int &nextRbg, std::vector<bool> &rbgMap,
+                                              std::vector<uint16_t> &rbgs)
+{
+  int taken = 0;
+  while (taken < rbgCount)
+    {
+      if (rbgMap.at (nextRbg) == false)
+        {
+          rbgMap.at (nextRbg) = true;
+          rbgs.push_back (nextRbg);
+          taken++;
+        }
+      nextRbg++;
+    }
+}
+
+} // namespace ns3
+
+#endif // FF_MAC_RBG_ALLOCATOR_H
@@ -0,0 +1,2238 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_ENGINE_H
+#define FF_MAC_SCHEDULER_ENGINE_H
+
+#include <ns3/log.h>
+#include <ns3/object.h>
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-csched-sap.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/ff-mac-rbg-allocator.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ *
+ * The SCHED SAP and CSCHED SAP of the FF MAC schedulers of the lte and nr
+ * modules. The engine keeps the state of the UEs (HARQ processes, CQIs,
+ * RLC buffers, BSRs) in one entry per UE, in a dense array sorted by RNTI,
+ * and runs the bookkeeping of each TTI: CQI and HARQ timers, RACH grants,
+ * DL HARQ retransmissions, DCI and RLC PDU generation, UL HARQ
+ * retransmissions and the UL round robin.
+ *
+ * The scheduler specific part is the Policy, a base class of the engine
+ * whose hooks are called on the engine itself, so that they are resolved
+ * at compile time:
+ * - UeInfo, the per UE state of the policy, kept in each entry;
+ * - FFR_AWARE, true if the scheduler follows the FFR algorithm;
+ * - SUBBAND_MCS, true if the MCS of a DCI is taken from the worst subband
+ *   CQI of its RBGs (A30), false if from the wideband CQI (P10);
+ * - UL_RESUME_UNSERVED, true if the next UL round robin starts from the UE
+ *   left without resources, false if from the first UE of this one;
+ * - STATS_IF_HARQ_FULL, true if ScheduleDl () and UpdateDlStats () run
+ *   also in the TTIs whose RBGs all go to HARQ retransmissions;
+ * - ConfigureLc (), called for each configured LC;
+ * - AddDlLc (), called on the first RLC buffer report of a LC;
+ * - ScheduleDl (), which assigns the free RBGs of the TTI to the UEs;
+ * - UpdateDlStats (), called once the DCIs of the TTI are built.
+ *
+ * Traits gives the scheduler base class (FfMacScheduler or
+ * NrFfMacScheduler, with the FFR SAP of the module), the AMC class and the
+ * conversions of the module. Each scheduler is a thin class deriving from
+ * an instantiation of the engine, which registers the TypeId and the
+ * attributes.
+ */
+template <class Traits, class Policy>
+class FfMacSchedulerEngine : public Traits::Scheduler,
+                             public Policy
+{
+  friend Policy;
+
+public:
+  FfMacSchedulerEngine ();
+  virtual ~FfMacSchedulerEngine ();
+
+  // inherited from Object
+  virtual void DoDispose (void);
+
+  // inherited from FfMacScheduler
+  virtual void SetFfMacCschedSapUser (FfMacCschedSapUser* s);
+  virtual void SetFfMacSchedSapUser (FfMacSchedSapUser* s);
+  virtual FfMacCschedSapProvider* GetFfMacCschedSapProvider ();
+  virtual FfMacSchedSapProvider* GetFfMacSchedSapProvider ();
+
+  /**
+   * \brief Inform the MAC of a new transmission mode of a UE
+   *
+   * \param rnti the RNTI of the UE
+   * \param txMode the transmission mode
+   */
+  void TransmissionModeConfigurationUpdate (uint16_t rnti, uint8_t txMode);
+
+protected:
+  static LogComponent g_log; ///< log component, defined by each scheduler
+
+  uint32_t m_cqiTimersThreshold; ///< # of TTIs for which a CQI can be considered valid
+  bool m_harqOn;                 ///< m_harqOn when false inhibit the HARQ mechanisms (by default active)
+  uint8_t m_ulGrantMcs;          ///< MCS for UL grant (default 0)
+
+private:
+  class MemberCschedSapProvider;
+  class MemberSchedSapProvider;
+
+  static const uint8_t HARQ_PROCESSES = 8;        ///< HARQ processes per UE and direction
+  static const uint8_t HARQ_DL_TIMEOUT_TTIS = 11; ///< TTIs without feedback before a DL HARQ process is released
+  static const uint8_t HARQ_UL_PERIOD = 7;        ///< TTIs between a UL grant and its HARQ feedback
+  static const int NO_SINR_VALUE = -5000;         ///< SINR outside the FF-API range, marks a RB without UL CQI
+
+  /// the state of a UE
+  struct Ue
+  {
+    /**
+     * \param rnti the RNTI
+     * \param txMode the transmission mode
+     * \param nLayer the number of layers of the transmission mode
+     */
+    Ue (uint16_t rnti, uint8_t txMode, uint8_t nLayer);
+
+    uint16_t m_rnti;   ///< RNTI
+    uint8_t m_txMode;  ///< transmission mode
+    uint8_t m_nLayer;  ///< number of layers of the transmission mode
+
+    uint8_t m_dlHarqId;                                                    ///< last DL HARQ process used
+    uint8_t m_dlHarqStatus[HARQ_PROCESSES];                                ///< DL HARQ process status, 0 if free
+    uint8_t m_dlHarqTimer[HARQ_PROCESSES];                                 ///< TTIs since the last DL transmission of the process
+    DlDciListElement_s m_dlHarqDci[HARQ_PROCESSES];                        ///< DCI of the last DL transmission of the process
+    std::vector<RlcPduListElement_s> m_dlHarqRlcPdus[2][HARQ_PROCESSES];   ///< RLC PDUs per layer of the process
+    bool m_dlHarqRetx;                                                     ///< DL HARQ retransmission in this TTI
+
+    uint8_t m_ulHarqId;                              ///< current UL HARQ process
+    uint8_t m_ulHarqStatus[HARQ_PROCESSES];          ///< UL HARQ process status, i.e. its RV
+    UlDciListElement_s m_ulHarqDci[HARQ_PROCESSES];  ///< DCI of the last UL grant of the process
+    bool m_ulHarqRetx;                               ///< UL HARQ retransmission in this TTI
+
+    bool m_p10Valid;     ///< a wideband CQI is available
+    uint8_t m_p10Cqi;    ///< last wideband CQI
+    uint32_t m_p10Timer; ///< TTIs before the wideband CQI expires
+
+    bool m_a30Valid;              ///< a subband CQI report is available
+    SbMeasResult_s m_a30Cqi;      ///< last subband CQI report
+    uint32_t m_a30Timer;          ///< TTIs before the subband CQI report expires
+    std::vector<double> m_sbRate; ///< rates of the subband CQI report, see FfMacRbgAllocator::ComputeSbRates ()
+
+    std::vector<double> m_ulSinr; ///< UL SINR per RB, empty if none
+    uint32_t m_ulSinrTimer;       ///< TTIs before the UL SINR expires
+
+    uint32_t m_bsr;      ///< UL buffer of the last BSR, updated by the grants
+    bool m_bsrReceived;  ///< a BSR has been received, the UE is in the UL round robin
+
+    std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBuffers; ///< DL RLC buffers, sorted by LCID
+    std::vector<LogicalChannelConfigListElement_s> m_lcs;                           ///< configured LCs, sorted by LCID
+    bool m_lcConfigured;                                                            ///< at least one LC has been configured
+
+    std::vector<uint16_t> m_dlRbgs; ///< RBGs assigned in this TTI
+    uint32_t m_dlBytes;             ///< bytes of the new DL transmission of this TTI
+
+    typename Policy::UeInfo m_info; ///< state of the policy
+  };
+
+  // CSCHED SAP
+  void DoCschedCellConfigReq (const struct FfMacCschedSapProvider::CschedCellConfigReqParameters& params);
+  void DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params);
+  void DoCschedLcConfigReq (const struct FfMacCschedSapProvider::CschedLcConfigReqParameters& params);
+  void DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+  void DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+  // SCHED SAP
+  void DoSchedDlRlcBufferReq (const struct FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+  void DoSchedDlPagingBufferReq (const struct FfMacSchedSapProvider::SchedDlPagingBufferReqParameters& params);
+  void DoSchedDlMacBufferReq (const struct FfMacSchedSapProvider::SchedDlMacBufferReqParameters& params);
+  void DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params);
+  void DoSchedDlRachInfoReq (const struct FfMacSchedSapProvider::SchedDlRachInfoReqParameters& params);
+  void DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+  void DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::SchedUlTriggerReqParameters& params);
+  void DoSchedUlNoiseInterferenceReq (const struct FfMacSchedSapProvider::SchedUlNoiseInterferenceReqParameters& params);
+  void DoSchedUlSrInfoReq (const struct FfMacSchedSapProvider::SchedUlSrInfoReqParameters& params);
+  void DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+  void DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+
+  /**
+   * \param dlbandwidth the DL bandwidth, in RBs
+   * \return the RBG size of allocation type 0
+   */
+  static int GetRbgSize (int dlbandwidth);
+
+  /**
+   * \param ue a UE
+   * \param rnti an RNTI
+   * \return true if the RNTI of the UE is lower
+   */
+  static bool RntiLess (const Ue &ue, uint16_t rnti);
+
+  /**
+   * \param rnti the RNTI
+   * \return the UE, 0 if unknown
+   */
+  Ue* FindUe (uint16_t rnti);
+
+  /**
+   * \param lcs RLC buffers or LC configurations sorted by LCID
+   * \param lcid the LCID
+   * \return the entry of the LCID, or the position where to insert it
+   */
+  template <class T>
+  static typename std::vector<T>::iterator FindLc (std::vector<T> &lcs, uint8_t lcid);
+
+  /**
+   * \param ue the UE
+   * \return the number of LCs of the UE with data in the RLC buffers
+   */
+  int LcActivePerFlow (const Ue &ue) const;
+
+  /**
+   * \param it a UE
+   * \return the next UE that reported a BSR, in the UL round robin
+   */
+  typename std::vector<Ue>::iterator NextUlUe (typename std::vector<Ue>::iterator it);
+
+  /**
+   * \param ue the UE
+   * \return true if a DL HARQ process is free
+   */
+  bool HarqProcessAvailability (const Ue &ue) const;
+
+  /**
+   * \param ue the UE
+   * \return true if a new DL transmission can be scheduled to the UE in
+   * this TTI: a configured LC, no HARQ retransmission and a free HARQ
+   * process
+   */
+  bool IsDlSchedulable (const Ue &ue) const;
+
+  /**
+   * \param ue the UE
+   * \return the DL HARQ process of a new transmission, marked as busy
+   */
+  uint8_t UpdateHarqProcessId (Ue &ue);
+
+  /**
+   * \param ue the UE
+   * \return the wideband CQI, 1 (the lowest value for trying a transmission)
+   * if none
+   */
+  uint8_t GetWbCqi (const Ue &ue) const;
+
+  /**
+   * \param ue the UE
+   * \param weight the weight used by the metric
+   * \return the UE as a candidate of the RBG allocator, receiving the RBGs
+   * in m_dlRbgs
+   */
+  FfMacRbgCandidate MakeCandidate (Ue &ue, double weight);
+
+  /**
+   * \return the FFR SAP provider if the policy follows the FFR algorithm,
+   * else 0
+   */
+  typename Traits::FfrSapProvider* GetFfrSapProvider () const;
+
+  /**
+   * Set the MCS and the TB size of each layer from the worst subband CQI of
+   * the RBGs of the UE
+   *
+   * \param ue the UE
+   * \param dci the DCI
+   * \return the bytes of the TBs
+   */
+  uint32_t SetSubbandMcs (const Ue &ue, DlDciListElement_s &dci) const;
+
+  /**
+   * Set the MCS and the TB size of each layer from the wideband CQI
+   *
+   * \param ue the UE
+   * \param dci the DCI
+   * \return the bytes of the TBs
+   */
+  uint32_t SetWidebandMcs (const Ue &ue, DlDciListElement_s &dci) const;
+
+  /// Release the DL HARQ processes without feedback for too long
+  void RefreshHarqProcesses ();
+  /// Decrement the DL CQI timers and drop the expired CQIs
+  void RefreshDlCqiMaps ();
+  /// Decrement the UL CQI timers and drop the expired SINRs
+  void RefreshUlCqiMaps ();
+
+  /**
+   * Grant the UL resources of the RACH messages
+   *
+   * \param ret the DL configuration of the TTI
+   */
+  void AllocateRach (FfMacSchedSapUser::SchedDlConfigIndParameters &ret);
+
+  /**
+   * Process the DL HARQ feedback and schedule the retransmissions
+   *
+   * \param params the DL trigger
+   * \param ret the DL configuration of the TTI
+   */
+  void ScheduleDlHarqRetx (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params,
+                           FfMacSchedSapUser::SchedDlConfigIndParameters &ret);
+
+  /**
+   * Build a DCI and the RLC PDUs for each UE with RBGs in this TTI
+   *
+   * \param ret the DL configuration of the TTI
+   */
+  void BuildDlDcis (FfMacSchedSapUser::SchedDlConfigIndParameters &ret);
+
+  /**
+   * \param ue the UE
+   * \param rb the RB
+   * \return the average UL SINR of the UE over the RBs with a report,
+   * stored for the RB
+   */
+  double EstimateUlSinr (Ue &ue, uint16_t rb);
+
+  /**
+   * \param rlc the RLC buffer of a LC
+   * \param size the bytes scheduled to the LC
+   */
+  void UpdateDlRlcBufferInfo (FfMacSchedSapProvider::SchedDlRlcBufferReqParameters &rlc, uint16_t size);
+
+  /**
+   * \param ue the UE
+   * \param size the size of the UL grant
+   */
+  void UpdateUlRlcBufferInfo (Ue &ue, uint16_t size);
+
+  Ptr<typename Traits::Amc> m_amc; ///< AMC module
+
+  FfMacRbgAllocator<typename Traits::Amc, typename Traits::FfrSapProvider> m_rbgAllocator; ///< RBG allocator
+
+  std::vector<Ue> m_ues; ///< the UEs, sorted by RNTI
+
+  FfMacCschedSapUser* m_cschedSapUser;         ///< CSched SAP user
+  FfMacSchedSapUser* m_schedSapUser;           ///< Sched SAP user
+  FfMacCschedSapProvider* m_cschedSapProvider; ///< CSched SAP provider
+  FfMacSchedSapProvider* m_schedSapProvider;   ///< Sched SAP provider
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig; ///< CSched cell config
+
+  int m_rbgSize;                      ///< RBs per RBG
+  int m_rbgNum;                       ///< RBGs of the DL bandwidth
+  std::vector<bool> m_rbgMap;         ///< RBGs in use in this TTI
+  uint16_t m_rbgAllocatedNum;         ///< number of RBGs in use in this TTI
+  std::vector<FfMacRbgCandidate> m_candidates; ///< UEs competing for the RBGs in this TTI
+
+  std::vector<DlInfoListElement_s> m_dlInfoListBuffered; ///< HARQ retx buffered
+
+  std::map<uint16_t, std::vector<uint16_t> > m_allocationMaps; ///< RNTI of each UL RB, per sfnSf
+
+  std::vector<struct RachListElement_s> m_rachList; ///< RACH messages to grant
+  std::vector<uint16_t> m_rachAllocationMap;        ///< RNTI of each UL RB granted to a RACH message
+
+  uint16_t m_nextRntiUl; ///< RNTI the UL round robin starts from
+  uint16_t m_nextRntiDl; ///< RNTI the DL round robin starts from, used by the RR policy
+};
+
+
+/// CSCHED SAP of the engine
+template <class Traits, class Policy>
+class FfMacSchedulerEngine<Traits, Policy>::MemberCschedSapProvider : public FfMacCschedSapProvider
+{
+public:
+  /**
+   * \param scheduler the scheduler
+   */
+  MemberCschedSapProvider (FfMacSchedulerEngine* scheduler)
+    : m_scheduler (scheduler)
+  {
+  }
+
+  // inherited from FfMacCschedSapProvider
+  virtual void CschedCellConfigReq (const struct CschedCellConfigReqParameters& params)
+  {
+    m_scheduler->DoCschedCellConfigReq (params);
+  }
+  virtual void CschedUeConfigReq (const struct CschedUeConfigReqParameters& params)
+  {
+    m_scheduler->DoCschedUeConfigReq (params);
+  }
+  virtual void CschedLcConfigReq (const struct CschedLcConfigReqParameters& params)
+  {
+    m_scheduler->DoCschedLcConfigReq (params);
+  }
+  virtual void CschedLcReleaseReq (const struct CschedLcReleaseReqParameters& params)
+  {
+    m_scheduler->DoCschedLcReleaseReq (params);
+  }
+  virtual void CschedUeReleaseReq (const struct CschedUeReleaseReqParameters& params)
+  {
+    m_scheduler->DoCschedUeReleaseReq (params);
+  }
+
+private:
+  FfMacSchedulerEngine* m_scheduler; ///< the scheduler
+};
+
+/// SCHED SAP of the engine
+template <class Traits, class Policy>
+class FfMacSchedulerEngine<Traits, Policy>::MemberSchedSapProvider : public FfMacSchedSapProvider
+{
+public:
+  /**
+   * \param scheduler the scheduler
+   */
+  MemberSchedSapProvider (FfMacSchedulerEngine* scheduler)
+    : m_scheduler (scheduler)
+  {
+  }
+
+  // inherited from FfMacSchedSapProvider
+  virtual void SchedDlRlcBufferReq (const struct SchedDlRlcBufferReqParameters& params)
+  {
+    m_scheduler->DoSchedDlRlcBufferReq (params);
+  }
+  virtual void SchedDlPagingBufferReq (const struct SchedDlPagingBufferReqParameters& params)
+  {
+    m_scheduler->DoSchedDlPagingBufferReq (params);
+  }
+  virtual void SchedDlMacBufferReq (const struct SchedDlMacBufferReqParameters& params)
+  {
+    m_scheduler->DoSchedDlMacBufferReq (params);
+  }
+  virtual void SchedDlTriggerReq (const struct SchedDlTriggerReqParameters& params)
+  {
+    m_scheduler->DoSchedDlTriggerReq (params);
+  }
+  virtual void SchedDlRachInfoReq (const struct SchedDlRachInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedDlRachInfoReq (params);
+  }
+  virtual void SchedDlCqiInfoReq (const struct SchedDlCqiInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedDlCqiInfoReq (params);
+  }
+  virtual void SchedUlTriggerReq (const struct SchedUlTriggerReqParameters& params)
+  {
+    m_scheduler->DoSchedUlTriggerReq (params);
+  }
+  virtual void SchedUlNoiseInterferenceReq (const struct SchedUlNoiseInterferenceReqParameters& params)
+  {
+    m_scheduler->DoSchedUlNoiseInterferenceReq (params);
+  }
+  virtual void SchedUlSrInfoReq (const struct SchedUlSrInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedUlSrInfoReq (params);
+  }
+  virtual void SchedUlMacCtrlInfoReq (const struct SchedUlMacCtrlInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedUlMacCtrlInfoReq (params);
+  }
+  virtual void SchedUlCqiInfoReq (const struct SchedUlCqiInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedUlCqiInfoReq (params);
+  }
+
+private:
+  FfMacSchedulerEngine* m_scheduler; ///< the scheduler
+};
+
+
+template <class Traits, class Policy>
+const uint8_t FfMacSchedulerEngine<Traits, Policy>::HARQ_PROCESSES;
+template <class Traits, class Policy>
+const uint8_t FfMacSchedulerEngine<Traits, Policy>::HARQ_DL_TIMEOUT_TTIS;
+template <class Traits, class Policy>
+const uint8_t FfMacSchedulerEngine<Traits, Policy>::HARQ_UL_PERIOD;
+template <class Traits, class Policy>
+const int FfMacSchedulerEngine<Traits, Policy>::NO_SINR_VALUE;
+
+template <class Traits, class Policy>
+FfMacSchedulerEngine<Traits, Policy>::Ue::Ue (uint16_t rnti, uint8_t txMode, uint8_t nLayer)
+  : m_rnti (rnti),
+    m_txMode (txMode),
+    m_nLayer (nLayer),
+    m_dlHarqId (0),
+    m_dlHarqStatus (),
+    m_dlHarqTimer (),
+    m_dlHarqDci (),
+    m_dlHarqRetx (false),
+    m_ulHarqId (0),
+    m_ulHarqStatus (),
+    m_ulHarqDci (),
+    m_ulHarqRetx (false),
+    m_p10Valid (false),
+    m_p10Cqi (0),
+    m_p10Timer (0),
+    m_a30Valid (false),
+    m_a30Timer (0),
+    m_ulSinrTimer (0),
+    m_bsr (0),
+    m_bsrReceived (false),
+    m_lcConfigured (false),
+    m_dlBytes (0),
+    m_info ()
+{
+}
+
+template <class Traits, class Policy>
+FfMacSchedulerEngine<Traits, Policy>::FfMacSchedulerEngine ()
+  : m_cqiTimersThreshold (1000),
+    m_harqOn (true),
+    m_ulGrantMcs (0),
+    m_cschedSapUser (0),
+    m_schedSapUser (0),
+    m_rbgSize (0),
+    m_rbgNum (0),
+    m_rbgAllocatedNum (0),
+    m_nextRntiUl (0),
+    m_nextRntiDl (0)
+{
+  m_amc = CreateObject <typename Traits::Amc> ();
+  m_cschedSapProvider = new MemberCschedSapProvider (this);
+  m_schedSapProvider = new MemberSchedSapProvider (this);
+}
+
+template <class Traits, class Policy>
+FfMacSchedulerEngine<Traits, Policy>::~FfMacSchedulerEngine ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_ues.clear ();
+  m_dlInfoListBuffered.clear ();
+  delete m_cschedSapProvider;
+  m_cschedSapProvider = 0;
+  delete m_schedSapProvider;
+  m_schedSapProvider = 0;
+  Traits::Scheduler::DoDispose ();
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::SetFfMacCschedSapUser (FfMacCschedSapUser* s)
+{
+  m_cschedSapUser = s;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::SetFfMacSchedSapUser (FfMacSchedSapUser* s)
+{
+  m_schedSapUser = s;
+}
+
+template <class Traits, class Policy>
+FfMacCschedSapProvider*
+FfMacSchedulerEngine<Traits, Policy>::GetFfMacCschedSapProvider ()
+{
+  return m_cschedSapProvider;
+}
+
+template <class Traits, class Policy>
+FfMacSchedSapProvider*
+FfMacSchedulerEngine<Traits, Policy>::GetFfMacSchedSapProvider ()
+{
+  return m_schedSapProvider;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoCschedCellConfigReq (const struct FfMacCschedSapProvider::CschedCellConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  // Read the subset of parameters used
+  m_cschedCellConfig = params;
+  m_rbgSize = GetRbgSize (m_cschedCellConfig.m_dlBandwidth);
+  m_rbgNum = m_cschedCellConfig.m_dlBandwidth / m_rbgSize;
+  m_rbgAllocator.Configure (m_amc, m_rbgSize);
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      if (it->m_a30Valid)
+        {
+          m_rbgAllocator.ComputeSbRates (it->m_a30Cqi, it->m_sbRate);
+        }
+    }
+  m_rachAllocationMap.resize (m_cschedCellConfig.m_ulBandwidth, 0);
+  FfMacCschedSapUser::CschedUeConfigCnfParameters cnf;
+  cnf.m_result = SUCCESS;
+  m_cschedSapUser->CschedUeConfigCnf (cnf);
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoCschedUeConfigReq (const struct FfMacCschedSapProvider::CschedUeConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
+  uint8_t nLayer = Traits::TxMode2LayerNum (params.m_transmissionMode);
+  typename std::vector<Ue>::iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), params.m_rnti, RntiLess);
+  if (it == m_ues.end () || it->m_rnti != params.m_rnti)
+    {
+      // new UE, with its HARQ buffers
+      m_ues.insert (it, Ue (params.m_rnti, params.m_transmissionMode, nLayer));
+    }
+  else
+    {
+      it->m_txMode = params.m_transmissionMode;
+      it->m_nLayer = nLayer;
+    }
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoCschedLcConfigReq (const struct FfMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " New LC, rnti: "  << params.m_rnti);
+  Ue *ue = FindUe (params.m_rnti);
+  if (ue == 0)
+    {
+      NS_LOG_ERROR (this << " LC configuration of unknown UE " << params.m_rnti);
+      return;
+    }
+  for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
+    {
+      const LogicalChannelConfigListElement_s &lc = params.m_logicalChannelConfigList.at (i);
+      this->ConfigureLc (ue->m_info, lc, !ue->m_lcConfigured);
+      ue->m_lcConfigured = true;
+      typename std::vector<LogicalChannelConfigListElement_s>::iterator it = FindLc (ue->m_lcs, lc.m_logicalChannelIdentity);
+      if (it != ue->m_lcs.end () && it->m_logicalChannelIdentity == lc.m_logicalChannelIdentity)
+        {
+          *it = lc;
+        }
+      else
+        {
+          ue->m_lcs.insert (it, lc);
+        }
+    }
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoCschedLcReleaseReq (const struct FfMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  Ue *ue = FindUe (params.m_rnti);
+  if (ue == 0)
+    {
+      return;
+    }
+  for (uint16_t i = 0; i < params.m_logicalChannelIdentity.size (); i++)
+    {
+      uint8_t lcid = params.m_logicalChannelIdentity.at (i);
+      typename std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlc = FindLc (ue->m_rlcBuffers, lcid);
+      if (itRlc != ue->m_rlcBuffers.end () && itRlc->m_logicalChannelIdentity == lcid)
+        {
+          ue->m_rlcBuffers.erase (itRlc);
+        }
+      typename std::vector<LogicalChannelConfigListElement_s>::iterator itLc = FindLc (ue->m_lcs, lcid);
+      if (itLc != ue->m_lcs.end () && itLc->m_logicalChannelIdentity == lcid)
+        {
+          ue->m_lcs.erase (itLc);
+        }
+    }
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoCschedUeReleaseReq (const struct FfMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  typename std::vector<Ue>::iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), params.m_rnti, RntiLess);
+  if (it != m_ues.end () && it->m_rnti == params.m_rnti)
+    {
+      m_ues.erase (it);
+    }
+  if (m_nextRntiUl == params.m_rnti)
+    {
+      m_nextRntiUl = 0;
+    }
+  if (m_nextRntiDl == params.m_rnti)
+    {
+      m_nextRntiDl = 0;
+    }
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedDlRlcBufferReq (const struct FfMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << params.m_rnti << (uint32_t) params.m_logicalChannelIdentity);
+  // API generated by RLC for updating RLC parameters on a LC (tx and retx queues)
+  Ue *ue = FindUe (params.m_rnti);
+  if (ue == 0)
+    {
+      NS_LOG_ERROR (this << " RLC buffer report of unknown UE " << params.m_rnti);
+      return;
+    }
+  typename std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator it = FindLc (ue->m_rlcBuffers, params.m_logicalChannelIdentity);
+  if (it != ue->m_rlcBuffers.end () && it->m_logicalChannelIdentity == params.m_logicalChannelIdentity)
+    {
+      *it = params;
+    }
+  else
+    {
+      ue->m_rlcBuffers.insert (it, params);
+      this->AddDlLc (*this, *ue);
+    }
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedDlPagingBufferReq (const struct FfMacSchedSapProvider::SchedDlPagingBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  NS_FATAL_ERROR ("method not implemented");
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedDlMacBufferReq (const struct FfMacSchedSapProvider::SchedDlMacBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  NS_FATAL_ERROR ("method not implemented");
+  return;
+}
+
+template <class Traits, class Policy>
+int
+FfMacSchedulerEngine<Traits, Policy>::GetRbgSize (int dlbandwidth)
+{
+  static const int type0AllocationRbg[4] = {
+    10,       // RGB size 1
+    26,       // RGB size 2
+    63,       // RGB size 3
+    110       // RGB size 4
+  };  // see table 7.1.6.1-1 of 36.213
+
+  for (int i = 0; i < 4; i++)
+    {
+      if (dlbandwidth < type0AllocationRbg[i])
+        {
+          return (i + 1);
+        }
+    }
+
+  return (-1);
+}
+
+template <class Traits, class Policy>
+bool
+FfMacSchedulerEngine<Traits, Policy>::RntiLess (const Ue &ue, uint16_t rnti)
+{
+  return ue.m_rnti < rnti;
+}
+
+template <class Traits, class Policy>
+typename FfMacSchedulerEngine<Traits, Policy>::Ue*
+FfMacSchedulerEngine<Traits, Policy>::FindUe (uint16_t rnti)
+{
+  typename std::vector<Ue>::iterator it = std::lower_bound (m_ues.begin (), m_ues.end (), rnti, RntiLess);
+  if (it == m_ues.end () || it->m_rnti != rnti)
+    {
+      return 0;
+    }
+  return &(*it);
+}
+
+template <class Traits, class Policy>
+template <class T>
+typename std::vector<T>::iterator
+FfMacSchedulerEngine<Traits, Policy>::FindLc (std::vector<T> &lcs, uint8_t lcid)
+{
+  // a UE has a handful of LCs: a linear search is the fastest
+  typename std::vector<T>::iterator it = lcs.begin ();
+  while (it != lcs.end () && it->m_logicalChannelIdentity < lcid)
+    {
+      ++it;
+    }
+  return it;
+}
+
+template <class Traits, class Policy>
+int
+FfMacSchedulerEngine<Traits, Policy>::LcActivePerFlow (const Ue &ue) const
+{
+  int lcActive = 0;
+  typename std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::const_iterator it;
+  for (it = ue.m_rlcBuffers.begin (); it != ue.m_rlcBuffers.end (); ++it)
+    {
+      if ((it->m_rlcTransmissionQueueSize > 0)
+          || (it->m_rlcRetransmissionQueueSize > 0)
+          || (it->m_rlcStatusPduSize > 0))
+        {
+          lcActive++;
+        }
+    }
+  return (lcActive);
+}
+
+template <class Traits, class Policy>
+bool
+FfMacSchedulerEngine<Traits, Policy>::HarqProcessAvailability (const Ue &ue) const
+{
+  for (uint8_t i = 0; i < HARQ_PROCESSES; i++)
+    {
+      if (ue.m_dlHarqStatus[i] == 0)
+        {
+          return (true);
+        }
+    }
+  return (false);
+}
+
+template <class Traits, class Policy>
+typename std::vector<typename FfMacSchedulerEngine<Traits, Policy>::Ue>::iterator
+FfMacSchedulerEngine<Traits, Policy>::NextUlUe (typename std::vector<Ue>::iterator it)
+{
+  do
+    {
+      it++;
+      if (it == m_ues.end ())
+        {
+          // restart from the first
+          it = m_ues.begin ();
+        }
+    }
+  while (!it->m_bsrReceived);
+  return it;
+}
+
+template <class Traits, class Policy>
+bool
+FfMacSchedulerEngine<Traits, Policy>::IsDlSchedulable (const Ue &ue) const
+{
+  return ue.m_lcConfigured && !ue.m_dlHarqRetx && HarqProcessAvailability (ue);
+}
+
+template <class Traits, class Policy>
+uint8_t
+FfMacSchedulerEngine<Traits, Policy>::UpdateHarqProcessId (Ue &ue)
+{
+  NS_LOG_FUNCTION (this << ue.m_rnti);
+
+  if (m_harqOn == false)
+    {
+      return (0);
+    }
+
+  uint8_t i = ue.m_dlHarqId;
+  do
+    {
+      i = (i + 1) % HARQ_PROCESSES;
+    }
+  while ((ue.m_dlHarqStatus[i] != 0) && (i != ue.m_dlHarqId));
+  if (ue.m_dlHarqStatus[i] == 0)
+    {
+      ue.m_dlHarqId = i;
+      ue.m_dlHarqStatus[i] = 1;
+    }
+  else
+    {
+      NS_FATAL_ERROR ("No HARQ process available for RNTI " << ue.m_rnti << " check before update with HarqProcessAvailability");
+    }
+
+  return (ue.m_dlHarqId);
+}
+
+template <class Traits, class Policy>
+uint8_t
+FfMacSchedulerEngine<Traits, Policy>::GetWbCqi (const Ue &ue) const
+{
+  return ue.m_p10Valid ? ue.m_p10Cqi : 1;
+}
+
+template <class Traits, class Policy>
+FfMacRbgCandidate
+FfMacSchedulerEngine<Traits, Policy>::MakeCandidate (Ue &ue, double weight)
+{
+  return m_rbgAllocator.MakeCandidate (ue.m_rnti, ue.m_nLayer, ue.m_a30Valid ? &ue.m_sbRate : 0,
+                                       &ue.m_dlRbgs, weight);
+}
+
+template <class Traits, class Policy>
+typename Traits::FfrSapProvider*
+FfMacSchedulerEngine<Traits, Policy>::GetFfrSapProvider () const
+{
+  return Policy::FFR_AWARE ? this->m_ffrSapProvider : 0;
+}
+
+template <class Traits, class Policy>
+uint32_t
+FfMacSchedulerEngine<Traits, Policy>::SetSubbandMcs (const Ue &ue, DlDciListElement_s &dci) const
+{
+  std::vector <uint8_t> worstCqi (2, 15);
+  if (ue.m_a30Valid)
+    {
+      const std::vector<HigherLayerSelected_s> &sbCqis = ue.m_a30Cqi.m_higherLayerSelected;
+      for (uint16_t k = 0; k < ue.m_dlRbgs.size (); k++)
+        {
+          if (sbCqis.size () > ue.m_dlRbgs.at (k))
+            {
+              const std::vector<uint8_t> &sbCqi = sbCqis.at (ue.m_dlRbgs.at (k)).m_sbCqi;
+              for (uint8_t j = 0; j < ue.m_nLayer; j++)
+                {
+                  if (sbCqi.size () > j)
+                    {
+                      if (sbCqi.at (j) < worstCqi.at (j))
+                        {
+                          worstCqi.at (j) = sbCqi.at (j);
+                        }
+                    }
+                  else
+                    {
+                      // no CQI for this layer of this suband -> worst one
+                      worstCqi.at (j) = 1;
+                    }
+                }
+            }
+          else
+            {
+              for (uint8_t j = 0; j < ue.m_nLayer; j++)
+                {
+                  worstCqi.at (j) = 1; // try with lowest MCS in RBG with no info on channel
+                }
+            }
+        }
+    }
+  else
+    {
+      for (uint8_t j = 0; j < ue.m_nLayer; j++)
+        {
+          worstCqi.at (j) = 1; // try with lowest MCS in RBG with no info on channel
+        }
+    }
+  uint32_t bytesTxed = 0;
+  for (uint8_t j = 0; j < ue.m_nLayer; j++)
+    {
+      dci.m_mcs.push_back (m_amc->GetMcsFromCqi (worstCqi.at (j)));
+      int tbSize = (m_amc->GetTbSizeFromMcs (dci.m_mcs.at (j), ue.m_dlRbgs.size () * m_rbgSize) / 8); // (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
+      dci.m_tbsSize.push_back (tbSize);
+      bytesTxed += tbSize;
+    }
+  return bytesTxed;
+}
+
+template <class Traits, class Policy>
+uint32_t
+FfMacSchedulerEngine<Traits, Policy>::SetWidebandMcs (const Ue &ue, DlDciListElement_s &dci) const
+{
+  uint32_t bytesTxed = 0;
+  for (uint8_t j = 0; j < ue.m_nLayer; j++)
+    {
+      if (ue.m_p10Valid)
+        {
+          dci.m_mcs.push_back (m_amc->GetMcsFromCqi (ue.m_p10Cqi));
+        }
+      else
+        {
+          dci.m_mcs.push_back (0); // no info on this user -> lowest MCS
+        }
+      int tbSize = (m_amc->GetTbSizeFromMcs (dci.m_mcs.at (j), ue.m_dlRbgs.size () * m_rbgSize) / 8); // (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
+      dci.m_tbsSize.push_back (tbSize);
+      bytesTxed += tbSize;
+    }
+  return bytesTxed;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::RefreshHarqProcesses ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      for (uint16_t i = 0; i < HARQ_PROCESSES; i++)
+        {
+          if (it->m_dlHarqTimer[i] == HARQ_DL_TIMEOUT_TTIS)
+            {
+              // reset HARQ process
+              NS_LOG_DEBUG (this << " Reset HARQ proc " << i << " for RNTI " << it->m_rnti);
+              it->m_dlHarqStatus[i] = 0;
+              it->m_dlHarqTimer[i] = 0;
+            }
+          else
+            {
+              it->m_dlHarqTimer[i]++;
+            }
+        }
+    }
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::RefreshDlCqiMaps ()
+{
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      if (it->m_p10Valid)
+        {
+          if (it->m_p10Timer == 0)
+            {
+              NS_LOG_INFO (this << " P10-CQI expired for user " << it->m_rnti);
+              it->m_p10Valid = false;
+            }
+          else
+            {
+              it->m_p10Timer--;
+            }
+        }
+      if (it->m_a30Valid)
+        {
+          if (it->m_a30Timer == 0)
+            {
+              NS_LOG_INFO (this << " A30-CQI expired for user " << it->m_rnti);
+              it->m_a30Valid = false;
+              it->m_sbRate.clear ();
+            }
+          else
+            {
+              it->m_a30Timer--;
+            }
+        }
+    }
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::RefreshUlCqiMaps ()
+{
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      if (it->m_ulSinr.empty ())
+        {
+          continue;
+        }
+      if (it->m_ulSinrTimer == 0)
+        {
+          NS_LOG_INFO (this << " UL-CQI exired for user " << it->m_rnti);
+          it->m_ulSinr.clear ();
+        }
+      else
+        {
+          it->m_ulSinrTimer--;
+        }
+    }
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::AllocateRach (FfMacSchedSapUser::SchedDlConfigIndParameters &ret)
+{
+  uint16_t rbStart = 0;
+  uint16_t rbEnd = m_cschedCellConfig.m_ulBandwidth;
+  if (Policy::FFR_AWARE)
+    {
+      // grant the RACH messages in the largest block of RBs the FFR algorithm leaves free
+      std::vector <bool> ulRbMap = this->m_ffrSapProvider->GetAvailableUlRbg ();
+      uint8_t maxContinuousUlBandwidth = 0;
+      uint8_t tmpMinBandwidth = 0;
+      uint16_t ffrRbStartOffset = 0;
+      uint16_t tmpFfrRbStartOffset = 0;
+      uint16_t index = 0;
+
+      for (std::vector<bool>::iterator it = ulRbMap.begin (); it != ulRbMap.end (); it++)
+        {
+          if ((*it) == true )
+            {
+              if (tmpMinBandwidth > maxContinuousUlBandwidth)
+                {
+                  maxContinuousUlBandwidth = tmpMinBandwidth;
+                  ffrRbStartOffset = tmpFfrRbStartOffset;
+                }
+              tmpMinBandwidth = 0;
+            }
+          else
+            {
+              if (tmpMinBandwidth == 0)
+                {
+                  tmpFfrRbStartOffset = index;
+                }
+              tmpMinBandwidth++;
+            }
+          index++;
+        }
+
+      if (tmpMinBandwidth > maxContinuousUlBandwidth)
+        {
+          maxContinuousUlBandwidth = tmpMinBandwidth;
+          ffrRbStartOffset = tmpFfrRbStartOffset;
+        }
+      rbStart = ffrRbStartOffset;
+      rbEnd = ffrRbStartOffset + maxContinuousUlBandwidth;
+    }
+
+  m_rachAllocationMap.resize (m_cschedCellConfig.m_ulBandwidth, 0);
+  std::vector <struct RachListElement_s>::iterator itRach;
+  for (itRach = m_rachList.begin (); itRach != m_rachList.end (); itRach++)
+    {
+      NS_ASSERT_MSG (m_amc->GetTbSizeFromMcs (m_ulGrantMcs, m_cschedCellConfig.m_ulBandwidth) > (*itRach).m_estimatedSize, " Default UL Grant MCS does not allow to send RACH messages");
+      BuildRarListElement_s newRar;
+      newRar.m_rnti = (*itRach).m_rnti;
+      // DL-RACH Allocation
+      // Ideal: no needs of configuring m_dci
+      // UL-RACH Allocation
+      newRar.m_grant.m_rnti = newRar.m_rnti;
+      newRar.m_grant.m_mcs = m_ulGrantMcs;
+      uint16_t rbLen = 1;
+      uint16_t tbSizeBits = 0;
+      // find lowest TB size that fits UL grant estimated size
+      while ((tbSizeBits < (*itRach).m_estimatedSize) && (rbStart + rbLen < rbEnd))
+        {
+          rbLen++;
+          tbSizeBits = m_amc->GetTbSizeFromMcs (m_ulGrantMcs, rbLen);
+        }
+      if (tbSizeBits < (*itRach).m_estimatedSize)
+        {
+          // no more allocation space: finish allocation
+          break;
+        }
+      newRar.m_grant.m_rbStart = rbStart;
+      newRar.m_grant.m_rbLen = rbLen;
+      newRar.m_grant.m_tbSize = tbSizeBits / 8;
+      newRar.m_grant.m_hopping = false;
+      newRar.m_grant.m_tpc = 0;
+      newRar.m_grant.m_cqiRequest = false;
+      newRar.m_grant.m_ulDelay = false;
+      NS_LOG_INFO (this << " UL grant allocated to RNTI " << (*itRach).m_rnti << " rbStart " << rbStart << " rbLen " << rbLen << " MCS " << (uint16_t) m_ulGrantMcs << " tbSize " << newRar.m_grant.m_tbSize);
+      for (uint16_t i = rbStart; i < rbStart + rbLen; i++)
+        {
+          m_rachAllocationMap.at (i) = (*itRach).m_rnti;
+        }
+
+      Ue *ue = FindUe (newRar.m_rnti);
+      if (m_harqOn == true && ue != 0)
+        {
+          // generate UL-DCI for HARQ retransmissions
+          UlDciListElement_s uldci;
+          uldci.m_rnti = newRar.m_rnti;
+          uldci.m_rbLen = rbLen;
+          uldci.m_rbStart = rbStart;
+          uldci.m_mcs = m_ulGrantMcs;
+          uldci.m_tbSize = tbSizeBits / 8;
+          uldci.m_ndi = 1;
+          uldci.m_cceIndex = 0;
+          uldci.m_aggrLevel = 1;
+          uldci.m_ueTxAntennaSelection = 3; // antenna selection OFF
+          uldci.m_hopping = false;
+          uldci.m_n2Dmrs = 0;
+          uldci.m_tpc = 0; // no power control
+          uldci.m_cqiRequest = false; // only period CQI at this stage
+          uldci.m_ulIndex = 0; // TDD parameter
+          uldci.m_dai = 1; // TDD parameter
+          uldci.m_freqHopping = 0;
+          uldci.m_pdcchPowerOffset = 0; // not used
+          ue->m_ulHarqDci[ue->m_ulHarqId] = uldci;
+        }
+
+      rbStart = rbStart + rbLen;
+      ret.m_buildRarList.push_back (newRar);
+    }
+  m_rachList.clear ();
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::ScheduleDlHarqRetx (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params,
+                                                          FfMacSchedSapUser::SchedDlConfigIndParameters &ret)
+{
+  // retrieve past HARQ retx buffered
+  if (params.m_dlInfoList.size () > 0)
+    {
+      NS_LOG_INFO (this << " Received DL-HARQ feedback");
+      m_dlInfoListBuffered.insert (m_dlInfoListBuffered.end (), params.m_dlInfoList.begin (), params.m_dlInfoList.end ());
+    }
+  if (m_harqOn == false)
+    {
+      // Ignore HARQ feedback
+      m_dlInfoListBuffered.clear ();
+    }
+  std::vector <struct DlInfoListElement_s> dlInfoListUntxed;
+  for (uint16_t i = 0; i < m_dlInfoListBuffered.size (); i++)
+    {
+      const DlInfoListElement_s &dlInfo = m_dlInfoListBuffered.at (i);
+      Ue *ue = FindUe (dlInfo.m_rnti);
+      if (ue == 0)
+        {
+          NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << dlInfo.m_rnti);
+          continue;
+        }
+      if (ue->m_dlHarqRetx)
+        {
+          // RNTI already allocated for retx
+          continue;
+        }
+      uint8_t nLayers = dlInfo.m_harqStatus.size ();
+      bool retx[2];
+      NS_LOG_INFO (this << " Processing DLHARQ feedback");
+      retx[0] = (dlInfo.m_harqStatus.at (0) == DlInfoListElement_s::NACK);
+      retx[1] = (nLayers > 1) && (dlInfo.m_harqStatus.at (1) == DlInfoListElement_s::NACK);
+      uint8_t harqId = dlInfo.m_harqProcessId;
+      if (retx[0] || retx[1])
+        {
+          // retrieve HARQ process information
+          NS_LOG_INFO (this << " HARQ retx RNTI " << ue->m_rnti << " harqId " << (uint16_t)harqId);
+          DlDciListElement_s dci = ue->m_dlHarqDci[harqId];
+          int rv = 0;
+          if (dci.m_rv.size () == 1)
+            {
+              rv = dci.m_rv.at (0);
+            }
+          else
+            {
+              rv = (dci.m_rv.at (0) > dci.m_rv.at (1) ? dci.m_rv.at (0) : dci.m_rv.at (1));
+            }
+
+          if (rv == 3)
+            {
+              // maximum number of retx reached -> drop process
+              NS_LOG_INFO ("Maximum number of retransmissions reached -> drop process");
+              ue->m_dlHarqStatus[harqId] = 0;
+              for (uint16_t k = 0; k < 2; k++)
+                {
+                  ue->m_dlHarqRlcPdus[k][harqId].clear ();
+                }
+              continue;
+            }
+          // check the feasibility of retransmitting on the same RBGs
+          // translate the DCI to Spectrum framework
+          std::vector <int> dciRbg;
+          uint32_t mask = 0x1;
+          NS_LOG_INFO ("Original RBGs " << dci.m_rbBitmap << " rnti " << dci.m_rnti);
+          for (int j = 0; j < 32; j++)
+            {
+              if (((dci.m_rbBitmap & mask) >> j) == 1)
+                {
+                  dciRbg.push_back (j);
+                  NS_LOG_INFO ("\t" << j);
+                }
+              mask = (mask << 1);
+            }
+          bool free = true;
+          for (uint8_t j = 0; j < dciRbg.size (); j++)
+            {
+              if (m_rbgMap.at (dciRbg.at (j)) == true)
+                {
+                  free = false;
+                  break;
+                }
+            }
+          if (free)
+            {
+              // use the same RBGs for the retx
+              // reserve RBGs
+              for (uint8_t j = 0; j < dciRbg.size (); j++)
+                {
+                  m_rbgMap.at (dciRbg.at (j)) = true;
+                  NS_LOG_INFO ("RBG " << dciRbg.at (j) << " assigned");
+                  m_rbgAllocatedNum++;
+                }
+
+              NS_LOG_INFO (this << " Send retx in the same RBGs");
+            }
+          else
+            {
+              // find RBGs for sending HARQ retx
+              uint8_t j = 0;
+              uint8_t rbgId = (dciRbg.at (dciRbg.size () - 1) + 1) % m_rbgNum;
+              uint8_t startRbg = dciRbg.at (dciRbg.size () - 1);
+              std::vector <bool> rbgMapCopy = m_rbgMap;
+              while ((j < dciRbg.size ()) && (startRbg != rbgId))
+                {
+                  if (rbgMapCopy.at (rbgId) == false)
+                    {
+                      rbgMapCopy.at (rbgId) = true;
+                      dciRbg.at (j) = rbgId;
+                      j++;
+                    }
+                  rbgId = (rbgId + 1) % m_rbgNum;
+                }
+              if (j == dciRbg.size ())
+                {
+                  // find new RBGs -> update DCI map
+                  uint32_t rbgMask = 0;
+                  for (uint16_t k = 0; k < dciRbg.size (); k++)
+                    {
+                      rbgMask = rbgMask + (0x1 << dciRbg.at (k));
+                      m_rbgAllocatedNum++;
+                    }
+                  dci.m_rbBitmap = rbgMask;
+                  m_rbgMap = rbgMapCopy;
+                  NS_LOG_INFO (this << " Move retx in RBGs " << dciRbg.size ());
+                }
+              else
+                {
+                  // HARQ retx cannot be performed on this TTI -> store it
+                  dlInfoListUntxed.push_back (dlInfo);
+                  NS_LOG_INFO (this << " No resource for this retx -> buffer it");
+                }
+            }
+          // retrieve RLC PDU list for retx TBsize and update DCI
+          BuildDataListElement_s newEl;
+          for (uint8_t j = 0; j < nLayers; j++)
+            {
+              if (retx[j])
+                {
+                  if (j >= dci.m_ndi.size ())
+                    {
+                      // for avoiding errors in MIMO transient phases
+                      dci.m_ndi.push_back (0);
+                      dci.m_rv.push_back (0);
+                      dci.m_mcs.push_back (0);
+                      dci.m_tbsSize.push_back (0);
+                      NS_LOG_INFO (this << " layer " << (uint16_t)j << " no txed (MIMO transition)");
+                    }
+                  else
+                    {
+                      dci.m_ndi.at (j) = 0;
+                      dci.m_rv.at (j)++;
+                      ue->m_dlHarqDci[harqId].m_rv.at (j)++;
+                      NS_LOG_INFO (this << " layer " << (uint16_t)j << " RV " << (uint16_t)dci.m_rv.at (j));
+                    }
+                }
+              else
+                {
+                  // empty TB of layer j
+                  dci.m_ndi.at (j) = 0;
+                  dci.m_rv.at (j) = 0;
+                  dci.m_mcs.at (j) = 0;
+                  dci.m_tbsSize.at (j) = 0;
+                  NS_LOG_INFO (this << " layer " << (uint16_t)j << " no retx");
+                }
+            }
+          for (uint16_t k = 0; k < ue->m_dlHarqRlcPdus[0][dci.m_harqProcess].size (); k++)
+            {
+              std::vector <struct RlcPduListElement_s> rlcPduListPerLc;
+              for (uint8_t j = 0; j < nLayers; j++)
+                {
+                  if (retx[j])
+                    {
+                      if (j < dci.m_ndi.size ())
+                        {
+                          rlcPduListPerLc.push_back (ue->m_dlHarqRlcPdus[j][dci.m_harqProcess].at (k));
+                        }
+                    }
+                }
+
+              if (rlcPduListPerLc.size () > 0)
+                {
+                  newEl.m_rlcPduList.push_back (rlcPduListPerLc);
+                }
+            }
+          newEl.m_rnti = ue->m_rnti;
+          newEl.m_dci = dci;
+          ue->m_dlHarqDci[harqId].m_rv = dci.m_rv;
+          // refresh timer
+          ue->m_dlHarqTimer[harqId] = 0;
+          ret.m_buildDataList.push_back (newEl);
+          ue->m_dlHarqRetx = true;
+        }
+      else
+        {
+          // update HARQ process status
+          NS_LOG_INFO (this << " HARQ received ACK for UE " << ue->m_rnti);
+          ue->m_dlHarqStatus[harqId] = 0;
+          for (uint16_t k = 0; k < 2; k++)
+            {
+              ue->m_dlHarqRlcPdus[k][harqId].clear ();
+            }
+        }
+    }
+  m_dlInfoListBuffered.swap (dlInfoListUntxed);
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::BuildDlDcis (FfMacSchedSapUser::SchedDlConfigIndParameters &ret)
+{
+  // generate the transmission opportunities by grouping the RBGs of the same RNTI and
+  // creating the correspondent DCIs
+  for (typename std::vector<Ue>::iterator itUe = m_ues.begin (); itUe != m_ues.end (); ++itUe)
+    {
+      Ue &ue = *itUe;
+      if (ue.m_dlRbgs.empty ())
+        {
+          continue;
+        }
+      // create new BuildDataListElement_s for this LC
+      BuildDataListElement_s newEl;
+      newEl.m_rnti = ue.m_rnti;
+      // create the DlDciListElement_s
+      DlDciListElement_s newDci;
+      newDci.m_rnti = ue.m_rnti;
+      newDci.m_harqProcess = UpdateHarqProcessId (ue);
+
+      uint16_t lcActives = LcActivePerFlow (ue);
+      NS_LOG_INFO (this << " Allocate user " << newEl.m_rnti << " rbg " << lcActives);
+      if (lcActives == 0)
+        {
+          // Set to max value, to avoid divide by 0 below
+          lcActives = (uint16_t)65535; // UINT16_MAX;
+        }
+      uint32_t bytesTxed = Policy::SUBBAND_MCS ? SetSubbandMcs (ue, newDci) : SetWidebandMcs (ue, newDci);
+
+      newDci.m_resAlloc = 0;  // only allocation type 0 at this stage
+      uint32_t rbgMask = 0;
+      for (uint16_t k = 0; k < ue.m_dlRbgs.size (); k++)
+        {
+          rbgMask = rbgMask + (0x1 << ue.m_dlRbgs.at (k));
+          NS_LOG_INFO (this << " Allocated RBG " << ue.m_dlRbgs.at (k));
+        }
+      newDci.m_rbBitmap = rbgMask; // (32 bit bitmap see 7.1.6 of 36.213)
+
+      // create the rlc PDUs -> equally divide resources among actives LCs
+      typename std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itBufReq;
+      for (itBufReq = ue.m_rlcBuffers.begin (); itBufReq != ue.m_rlcBuffers.end (); ++itBufReq)
+        {
+          if ((itBufReq->m_rlcTransmissionQueueSize > 0)
+              || (itBufReq->m_rlcRetransmissionQueueSize > 0)
+              || (itBufReq->m_rlcStatusPduSize > 0))
+            {
+              std::vector <struct RlcPduListElement_s> newRlcPduLe;
+              for (uint8_t j = 0; j < ue.m_nLayer; j++)
+                {
+                  RlcPduListElement_s newRlcEl;
+                  newRlcEl.m_logicalChannelIdentity = itBufReq->m_logicalChannelIdentity;
+                  newRlcEl.m_size = newDci.m_tbsSize.at (j) / lcActives;
+                  NS_LOG_INFO (this << " LCID " << (uint32_t) newRlcEl.m_logicalChannelIdentity << " size " << newRlcEl.m_size << " layer " << (uint16_t)j);
+                  newRlcPduLe.push_back (newRlcEl);
+                  UpdateDlRlcBufferInfo (*itBufReq, newRlcEl.m_size);
+                  if (m_harqOn == true)
+                    {
+                      // store RLC PDU list for HARQ
+                      ue.m_dlHarqRlcPdus[j][newDci.m_harqProcess].push_back (newRlcEl);
+                    }
+                }
+              newEl.m_rlcPduList.push_back (newRlcPduLe);
+            }
+        }
+      for (uint8_t j = 0; j < ue.m_nLayer; j++)
+        {
+          newDci.m_ndi.push_back (1);
+          newDci.m_rv.push_back (0);
+        }
+
+      if (Policy::FFR_AWARE)
+        {
+          newDci.m_tpc = this->m_ffrSapProvider->GetTpc (ue.m_rnti);
+        }
+      else
+        {
+          newDci.m_tpc = 1; //1 is mapped to 0 in Accumulated Mode and to -1 in Absolute Mode
+        }
+
+      newEl.m_dci = newDci;
+
+      if (m_harqOn == true)
+        {
+          // store DCI for HARQ
+          ue.m_dlHarqDci[newDci.m_harqProcess] = newDci;
+          // refresh timer
+          ue.m_dlHarqTimer[newDci.m_harqProcess] = 0;
+        }
+
+      // ...more parameters -> ingored in this version
+
+      ret.m_buildDataList.push_back (newEl);
+      ue.m_dlBytes = bytesTxed;
+      NS_LOG_INFO (this << " UE total bytes txed " << ue.m_dlBytes);
+    }
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedDlTriggerReq (const struct FfMacSchedSapProvider::SchedDlTriggerReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
+  // API generated by RLC for triggering the scheduling of a DL subframe
+
+  // evaluate the relative channel quality indicator for each UE per each RBG
+  // (since we are using allocation type 0 the small unit of allocation is RBG)
+  // Resource allocation type 0 (see sec 7.1.6.1 of 36.213)
+
+  RefreshDlCqiMaps ();
+
+  m_rbgAllocatedNum = 0;
+  if (Policy::FFR_AWARE)
+    {
+      m_rbgMap = this->m_ffrSapProvider->GetAvailableDlRbg ();
+      for (std::vector<bool>::iterator it = m_rbgMap.begin (); it != m_rbgMap.end (); it++)
+        {
+          if ((*it) == true )
+            {
+              m_rbgAllocatedNum++;
+            }
+        }
+    }
+  else
+    {
+      m_rbgMap.assign (m_rbgNum, false);
+    }
+
+  FfMacSchedSapUser::SchedDlConfigIndParameters ret;
+
+  //   update UL HARQ proc id
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      it->m_ulHarqId = (it->m_ulHarqId + 1) % HARQ_PROCESSES;
+      it->m_dlHarqRetx = false;
+    }
+
+  // RACH Allocation
+  AllocateRach (ret);
+
+  // Process DL HARQ feedback
+  RefreshHarqProcesses ();
+  ScheduleDlHarqRetx (params, ret);
+
+  if ((m_rbgAllocatedNum == m_rbgNum) && !Policy::STATS_IF_HARQ_FULL)
+    {
+      // all the RBGs are already allocated -> exit
+      if ((ret.m_buildDataList.size () > 0) || (ret.m_buildRarList.size () > 0))
+        {
+          m_schedSapUser->SchedDlConfigInd (ret);
+        }
+      return;
+    }
+
+  // reset TTI stats of users
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      it->m_dlRbgs.clear ();
+      it->m_dlBytes = 0;
+    }
+
+  this->ScheduleDl (*this);
+  BuildDlDcis (ret);
+  ret.m_nrOfPdcchOfdmSymbols = 1;   /// \todo check correct value according the DCIs txed
+
+  this->UpdateDlStats (*this);
+
+  m_schedSapUser->SchedDlConfigInd (ret);
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedDlRachInfoReq (const struct FfMacSchedSapProvider::SchedDlRachInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_rachList = params.m_rachList;
+
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedDlCqiInfoReq (const struct FfMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  if (Policy::FFR_AWARE)
+    {
+      this->m_ffrSapProvider->ReportDlCqiInfo (params);
+    }
+
+  for (unsigned int i = 0; i < params.m_cqiList.size (); i++)
+    {
+      const CqiListElement_s &cqi = params.m_cqiList.at (i);
+      Ue *ue = FindUe (cqi.m_rnti);
+      if (ue == 0)
+        {
+          NS_LOG_ERROR (this << " CQI of unknown UE " << cqi.m_rnti);
+          continue;
+        }
+      if (cqi.m_cqiType == CqiListElement_s::P10)
+        {
+          NS_LOG_LOGIC ("wideband CQI " <<  (uint32_t) cqi.m_wbCqi.at (0) << " reported");
+          ue->m_p10Valid = true;
+          ue->m_p10Cqi = cqi.m_wbCqi.at (0); // only codeword 0 at this stage (SISO)
+          ue->m_p10Timer = m_cqiTimersThreshold;
+        }
+      else if (cqi.m_cqiType == CqiListElement_s::A30)
+        {
+          // subband CQI reporting high layer configured
+          ue->m_a30Valid = true;
+          ue->m_a30Cqi = cqi.m_sbMeasResult;
+          ue->m_a30Timer = m_cqiTimersThreshold;
+          m_rbgAllocator.ComputeSbRates (ue->m_a30Cqi, ue->m_sbRate);
+        }
+      else
+        {
+          NS_LOG_ERROR (this << " CQI type unknown");
+        }
+    }
+
+  return;
+}
+
+template <class Traits, class Policy>
+double
+FfMacSchedulerEngine<Traits, Policy>::EstimateUlSinr (Ue &ue, uint16_t rb)
+{
+  if (ue.m_ulSinr.empty ())
+    {
+      // no cqi info about this UE
+      return (NO_SINR_VALUE);
+    }
+  // take the average SINR value among the available
+  double sinrSum = 0;
+  int sinrNum = 0;
+  for (uint32_t i = 0; i < m_cschedCellConfig.m_ulBandwidth; i++)
+    {
+      double sinr = ue.m_ulSinr.at (i);
+      if (sinr != NO_SINR_VALUE)
+        {
+          sinrSum += sinr;
+          sinrNum++;
+        }
+    }
+  double estimatedSinr = (sinrNum > 0) ? (sinrSum / sinrNum) : DBL_MAX;
+  // store the value
+  ue.m_ulSinr.at (rb) = estimatedSinr;
+  return (estimatedSinr);
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedUlTriggerReq (const struct FfMacSchedSapProvider::SchedUlTriggerReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " UL - Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf) << " size " << params.m_ulInfoList.size ());
+
+  RefreshUlCqiMaps ();
+  if (Policy::FFR_AWARE)
+    {
+      std::map <uint16_t, std::vector <double> > ulCqiMap;
+      for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+        {
+          if (!it->m_ulSinr.empty ())
+            {
+              ulCqiMap.insert (ulCqiMap.end (), std::make_pair (it->m_rnti, it->m_ulSinr));
+            }
+        }
+      this->m_ffrSapProvider->ReportUlCqiInfo (ulCqiMap);
+    }
+
+  // Generate RBs map
+  FfMacSchedSapUser::SchedUlConfigIndParameters ret;
+  std::vector <bool> rbMap;
+  uint16_t rbAllocatedNum = 0;
+  int retxNum = 0;
+  std::vector <uint16_t> rbgAllocationMap;
+  // update with RACH allocation map
+  rbgAllocationMap = m_rachAllocationMap;
+  m_rachAllocationMap.clear ();
+  m_rachAllocationMap.resize (m_cschedCellConfig.m_ulBandwidth, 0);
+
+  uint8_t minContinuousUlBandwidth = 0;
+  uint8_t ffrUlBandwidth = 0;
+  if (Policy::FFR_AWARE)
+    {
+      rbMap = this->m_ffrSapProvider->GetAvailableUlRbg ();
+      for (std::vector<bool>::iterator it = rbMap.begin (); it != rbMap.end (); it++)
+        {
+          if ((*it) == true )
+            {
+              rbAllocatedNum++;
+            }
+        }
+      minContinuousUlBandwidth = this->m_ffrSapProvider->GetMinContinuousUlBandwidth ();
+      ffrUlBandwidth = m_cschedCellConfig.m_ulBandwidth - rbAllocatedNum;
+    }
+  else
+    {
+      rbMap.resize (m_cschedCellConfig.m_ulBandwidth, false);
+    }
+
+  // remove RACH allocation
+  for (uint16_t i = 0; i < m_cschedCellConfig.m_ulBandwidth; i++)
+    {
+      if (rbgAllocationMap.at (i) != 0)
+        {
+          rbMap.at (i) = true;
+          NS_LOG_DEBUG (this << " Allocated for RACH " << i);
+        }
+    }
+
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      it->m_ulHarqRetx = false;
+    }
+
+  if (m_harqOn == true)
+    {
+      //   Process UL HARQ feedback
+      for (uint16_t i = 0; i < params.m_ulInfoList.size (); i++)
+        {
+          if (params.m_ulInfoList.at (i).m_receptionStatus == UlInfoListElement_s::NotOk)
+            {
+              // retx correspondent block: retrieve the UL-DCI
+              uint16_t rnti = params.m_ulInfoList.at (i).m_rnti;
+              Ue *ue = FindUe (rnti);
+              if (ue == 0)
+                {
+                  NS_LOG_ERROR ("No info find in HARQ buffer for UE (might change eNB) " << rnti);
+                  continue;
+                }
+              uint8_t harqId = (uint8_t)(ue->m_ulHarqId - HARQ_UL_PERIOD) % HARQ_PROCESSES;
+              NS_LOG_INFO (this << " UL-HARQ retx RNTI " << rnti << " harqId " << (uint16_t)harqId << " i " << i << " size "  << params.m_ulInfoList.size ());
+              UlDciListElement_s dci = ue->m_ulHarqDci[harqId];
+              if (ue->m_ulHarqStatus[harqId] >= 3)
+                {
+                  NS_LOG_INFO ("Max number of retransmissions reached (UL)-> drop process");
+                  continue;
+                }
+              bool free = true;
+              for (int j = dci.m_rbStart; j < dci.m_rbStart + dci.m_rbLen; j++)
+                {
+                  if (rbMap.at (j) == true)
+                    {
+                      free = false;
+                      NS_LOG_INFO (this << " BUSY " << j);
+                    }
+                }
+              if (free)
+                {
+                  // retx on the same RBs
+                  for (int j = dci.m_rbStart; j < dci.m_rbStart + dci.m_rbLen; j++)
+                    {
+                      rbMap.at (j) = true;
+                      rbgAllocationMap.at (j) = dci.m_rnti;
+                      NS_LOG_INFO ("\tRB " << j);
+                      rbAllocatedNum++;
+                    }
+                  NS_LOG_INFO (this << " Send retx in the same RBs " << (uint16_t)dci.m_rbStart << " to " << dci.m_rbStart + dci.m_rbLen << " RV " << ue->m_ulHarqStatus[harqId] + 1);
+                }
+              else
+                {
+                  NS_LOG_INFO ("Cannot allocate retx due to RACH allocations for UE " << rnti);
+                  continue;
+                }
+              dci.m_ndi = 0;
+              // Update HARQ buffers with new HarqId
+              ue->m_ulHarqStatus[ue->m_ulHarqId] = ue->m_ulHarqStatus[harqId] + 1;
+              ue->m_ulHarqStatus[harqId] = 0;
+              ue->m_ulHarqDci[ue->m_ulHarqId] = dci;
+              ret.m_dciList.push_back (dci);
+              if (!ue->m_ulHarqRetx)
+                {
+                  ue->m_ulHarqRetx = true;
+                  retxNum++;
+                }
+            }
+          else
+            {
+              NS_LOG_INFO (this << " HARQ-ACK feedback from RNTI " << params.m_ulInfoList.at (i).m_rnti);
+            }
+        }
+    }
+
+  int nflows = 0;
+  for (typename std::vector<Ue>::iterator it = m_ues.begin (); it != m_ues.end (); ++it)
+    {
+      // select UEs with queues not empty and not yet allocated for HARQ
+      if ((it->m_bsr > 0) && !it->m_ulHarqRetx)
+        {
+          nflows++;
+        }
+    }
+
+  if (nflows == 0)
+    {
+      if (ret.m_dciList.size () > 0)
+        {
+          m_allocationMaps.insert (std::pair <uint16_t, std::vector <uint16_t> > (params.m_sfnSf, rbgAllocationMap));
+          m_schedSapUser->SchedUlConfigInd (ret);
+        }
+
+      return;  // no flows to be scheduled
+    }
+
+
+  // Divide the remaining resources equally among the active users starting from the subsequent one served last scheduling trigger
+  uint16_t rbPerFlow;
+  if (Policy::FFR_AWARE)
+    {
+      uint16_t tempRbPerFlow = (ffrUlBandwidth) / (nflows + retxNum);
+      rbPerFlow = (minContinuousUlBandwidth < tempRbPerFlow) ? minContinuousUlBandwidth : tempRbPerFlow;
+    }
+  else
+    {
+      rbPerFlow = (m_cschedCellConfig.m_ulBandwidth) / (nflows + retxNum);
+    }
+
+  if (rbPerFlow < 3)
+    {
+      rbPerFlow = 3;  // at least 3 rbg per flow (till available resource) to ensure TxOpportunity >= 7 bytes
+    }
+
+  int rbAllocated = 0;
+
+  typename std::vector<Ue>::iterator it = m_ues.end ();
+  if (m_nextRntiUl != 0)
+    {
+      it = std::lower_bound (m_ues.begin (), m_ues.end (), m_nextRntiUl, RntiLess);
+      if (it == m_ues.end () || it->m_rnti != m_nextRntiUl)
+        {
+          NS_LOG_ERROR (this << " no user found");
+          it = m_ues.end ();
+        }
+    }
+  if (it == m_ues.end ())
+    {
+      // start from the first UE that reported a BSR
+      it = m_ues.begin ();
+      while (!it->m_bsrReceived)
+        {
+          it++;
+        }
+      m_nextRntiUl = it->m_rnti;
+    }
+  do
+    {
+      if (it->m_ulHarqRetx || (it->m_bsr == 0))
+        {
+          // UE already allocated for UL-HARQ -> skip it
+          NS_LOG_DEBUG (this << " UE already allocated in HARQ -> discared, RNTI " << it->m_rnti);
+          it = NextUlUe (it);
+          continue;
+        }
+      if (rbAllocated + rbPerFlow - 1 > m_cschedCellConfig.m_ulBandwidth)
+        {
+          // limit to physical resources last resource assignment
+          rbPerFlow = m_cschedCellConfig.m_ulBandwidth - rbAllocated;
+          // at least 3 rbg per flow to ensure TxOpportunity >= 7 bytes
+          if (rbPerFlow < 3)
+            {
+              // terminate allocation
+              rbPerFlow = 0;
+            }
+        }
+
+      if (Policy::FFR_AWARE)
+        {
+          // the RBs the FFR algorithm leaves to the UE may be anywhere in the band
+          rbAllocated = 0;
+        }
+      UlDciListElement_s uldci;
+      uldci.m_rnti = it->m_rnti;
+      uldci.m_rbLen = rbPerFlow;
+      bool allocated = false;
+
+      while ((!allocated) && ((rbAllocated + rbPerFlow - m_cschedCellConfig.m_ulBandwidth) < 1) && (rbPerFlow != 0))
+        {
+          // check availability
+          bool free = true;
+          for (uint16_t j = rbAllocated; j < rbAllocated + rbPerFlow; j++)
+            {
+              if (rbMap.at (j) == true)
+                {
+                  free = false;
+                  break;
+                }
+              if (Policy::FFR_AWARE && (this->m_ffrSapProvider->IsUlRbgAvailableForUe (j, it->m_rnti)) == false)
+                {
+                  free = false;
+                  break;
+                }
+            }
+          if (free)
+            {
+              NS_LOG_INFO (this << "RNTI: "<< it->m_rnti << " RB Allocated " << rbAllocated << " rbPerFlow " << rbPerFlow << " flows " << nflows);
+              uldci.m_rbStart = rbAllocated;
+
+              for (uint16_t j = rbAllocated; j < rbAllocated + rbPerFlow; j++)
+                {
+                  rbMap.at (j) = true;
+                  // store info on allocation for managing ul-cqi interpretation
+                  rbgAllocationMap.at (j) = it->m_rnti;
+                }
+              rbAllocated += rbPerFlow;
+              allocated = true;
+              break;
+            }
+          rbAllocated++;
+          if (rbAllocated + rbPerFlow - 1 > m_cschedCellConfig.m_ulBandwidth)
+            {
+              // limit to physical resources last resource assignment
+              rbPerFlow = m_cschedCellConfig.m_ulBandwidth - rbAllocated;
+              // at least 3 rbg per flow to ensure TxOpportunity >= 7 bytes
+              if (rbPerFlow < 3)
+                {
+                  // terminate allocation
+                  rbPerFlow = 0;
+                }
+            }
+        }
+      if (!allocated)
+        {
+          // unable to allocate new resource: finish scheduling
+          if (Policy::UL_RESUME_UNSERVED)
+            {
+              m_nextRntiUl = it->m_rnti;
+            }
+          if (!Policy::FFR_AWARE)
+            {
+              if (ret.m_dciList.size () > 0)
+                {
+                  m_schedSapUser->SchedUlConfigInd (ret);
+                }
+              m_allocationMaps.insert (std::pair <uint16_t, std::vector <uint16_t> > (params.m_sfnSf, rbgAllocationMap));
+              return;
+            }
+          break;
+        }
+
+      int cqi = 0;
+      if (it->m_ulSinr.empty ())
+        {
+          // no cqi info about this UE
+          uldci.m_mcs = 0; // MCS 0 -> UL-AMC TBD
+        }
+      else
+        {
+          // take the lowest CQI value (worst RB)
+          double minSinr = it->m_ulSinr.at (uldci.m_rbStart);
+          if (minSinr == NO_SINR_VALUE)
+            {
+              minSinr = EstimateUlSinr (*it, uldci.m_rbStart);
+            }
+          for (uint16_t i = uldci.m_rbStart; i < uldci.m_rbStart + uldci.m_rbLen; i++)
+            {
+              if (it->m_ulSinr.at (i) == NO_SINR_VALUE)
+                {
+                  EstimateUlSinr (*it, i);
+                }
+              if (it->m_ulSinr.at (i) < minSinr)
+                {
+                  minSinr = it->m_ulSinr.at (i);
+                }
+            }
+
+          // translate SINR -> cqi: WILD ACK: same as DL
+          double s = log2 ( 1 + (
+                              std::pow (10, minSinr / 10 )  /
+                              ( (-std::log (5.0 * 0.00005 )) / 1.5) ));
+          cqi = m_amc->GetCqiFromSpectralEfficiency (s);
+          if (cqi == 0)
+            {
+              NS_LOG_DEBUG (this << " UE discared for CQI=0, RNTI " << uldci.m_rnti);
+              it = NextUlUe (it);
+              // remove UE from allocation map
+              for (uint16_t i = uldci.m_rbStart; i < uldci.m_rbStart + uldci.m_rbLen; i++)
+                {
+                  rbgAllocationMap.at (i) = 0;
+                }
+              continue; // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+            }
+          uldci.m_mcs = m_amc->GetMcsFromCqi (cqi);
+        }
+
+      uldci.m_tbSize = (m_amc->GetTbSizeFromMcs (uldci.m_mcs, rbPerFlow) / 8);
+      UpdateUlRlcBufferInfo (*it, uldci.m_tbSize);
+      uldci.m_ndi = 1;
+      uldci.m_cceIndex = 0;
+      uldci.m_aggrLevel = 1;
+      uldci.m_ueTxAntennaSelection = 3; // antenna selection OFF
+      uldci.m_hopping = false;
+      uldci.m_n2Dmrs = 0;
+      uldci.m_tpc = 0; // no power control
+      uldci.m_cqiRequest = false; // only period CQI at this stage
+      uldci.m_ulIndex = 0; // TDD parameter
+      uldci.m_dai = 1; // TDD parameter
+      uldci.m_freqHopping = 0;
+      uldci.m_pdcchPowerOffset = 0; // not used
+      ret.m_dciList.push_back (uldci);
+      // store DCI for HARQ_PERIOD
+      if (m_harqOn == true)
+        {
+          it->m_ulHarqDci[it->m_ulHarqId] = uldci;
+          // Update HARQ process status (RV 0)
+          it->m_ulHarqStatus[it->m_ulHarqId] = 0;
+        }
+
+      NS_LOG_INFO (this << " UE Allocation RNTI " << it->m_rnti << " startPRB " << (uint32_t)uldci.m_rbStart << " nPRB " << (uint32_t)uldci.m_rbLen << " CQI " << cqi << " MCS " << (uint32_t)uldci.m_mcs << " TBsize " << uldci.m_tbSize << " RbAlloc " << rbAllocated << " harqId " << (uint16_t)it->m_ulHarqId);
+
+      it = NextUlUe (it);
+      if ((rbAllocated == m_cschedCellConfig.m_ulBandwidth) || (rbPerFlow == 0))
+        {
+          // Stop allocation: no more PRBs
+          m_nextRntiUl = it->m_rnti;
+          break;
+        }
+    }
+  while ((it->m_rnti != m_nextRntiUl) && (rbPerFlow != 0));
+
+  m_allocationMaps.insert (std::pair <uint16_t, std::vector <uint16_t> > (params.m_sfnSf, rbgAllocationMap));
+  m_schedSapUser->SchedUlConfigInd (ret);
+
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedUlNoiseInterferenceReq (const struct FfMacSchedSapProvider::SchedUlNoiseInterferenceReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedUlSrInfoReq (const struct FfMacSchedSapProvider::SchedUlSrInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedUlMacCtrlInfoReq (const struct FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
+    {
+      if ( params.m_macCeList.at (i).m_macCeType == MacCeListElement_s::BSR )
+        {
+          // buffer status report
+          // note that this scheduler does not differentiate the
+          // allocation according to which LCGs have more/less bytes
+          // to send.
+          // Hence the BSR of different LCGs are just summed up to get
+          // a total queue size that is used for allocation purposes.
+
+          uint32_t buffer = 0;
+          for (uint8_t lcg = 0; lcg < 4; ++lcg)
+            {
+              uint8_t bsrId = params.m_macCeList.at (i).m_macCeValue.m_bufferStatus.at (lcg);
+              buffer += Traits::BsrId2BufferSize (bsrId);
+            }
+
+          uint16_t rnti = params.m_macCeList.at (i).m_rnti;
+          NS_LOG_LOGIC (this << "RNTI=" << rnti << " buffer=" << buffer);
+          Ue *ue = FindUe (rnti);
+          if (ue == 0)
+            {
+              NS_LOG_ERROR (this << " BSR of unknown UE " << rnti);
+              continue;
+            }
+          ue->m_bsr = buffer;
+          ue->m_bsrReceived = true;
+        }
+    }
+
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::DoSchedUlCqiInfoReq (const struct FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  if (Policy::FFR_AWARE)
+    {
+      this->m_ffrSapProvider->ReportUlCqiInfo (params);
+    }
+
+  // retrieve the allocation for this subframe
+  switch (this->m_ulCqiFilter)
+    {
+    case Traits::Scheduler::SRS_UL_CQI:
+      {
+        // filter all the CQIs that are not SRS based
+        if (params.m_ulCqi.m_type != UlCqi_s::SRS)
+          {
+            return;
+          }
+      }
+      break;
+    case Traits::Scheduler::PUSCH_UL_CQI:
+      {
+        // filter all the CQIs that are not PUSCH based
+        if (params.m_ulCqi.m_type != UlCqi_s::PUSCH)
+          {
+            return;
+          }
+      }
+    case Traits::Scheduler::ALL_UL_CQI:
+      break;
+
+    default:
+      NS_FATAL_ERROR ("Unknown UL CQI type");
+    }
+
+  switch (params.m_ulCqi.m_type)
+    {
+    case UlCqi_s::PUSCH:
+      {
+        NS_LOG_DEBUG (this << " Collect PUSCH CQIs of Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
+        std::map <uint16_t, std::vector <uint16_t> >::iterator itMap = m_allocationMaps.find (params.m_sfnSf);
+        if (itMap == m_allocationMaps.end ())
+          {
+            return;
+          }
+        for (uint32_t i = 0; i < (*itMap).second.size (); i++)
+          {
+            Ue *ue = FindUe ((*itMap).second.at (i));
+            if (ue == 0)
+              {
+                // RB not allocated, or UE released
+                continue;
+              }
+            // convert from fixed point notation Sxxxxxxxxxxx.xxx to double
+            double sinr = Traits::FpS11dot3toDouble (params.m_ulCqi.m_sinr.at (i));
+            if (ue->m_ulSinr.empty ())
+              {
+                // initialize with NO_SINR value.
+                ue->m_ulSinr.resize (m_cschedCellConfig.m_ulBandwidth, NO_SINR_VALUE);
+              }
+            ue->m_ulSinr.at (i) = sinr;
+            NS_LOG_DEBUG (this << " RNTI " << ue->m_rnti << " RB " << i << " SINR " << sinr);
+            // update correspondent timer
+            ue->m_ulSinrTimer = m_cqiTimersThreshold;
+          }
+        // remove obsolete info on allocation
+        m_allocationMaps.erase (itMap);
+      }
+      break;
+    case UlCqi_s::SRS:
+      {
+        NS_LOG_DEBUG (this << " Collect SRS CQIs of Frame no. " << (params.m_sfnSf >> 4) << " subframe no. " << (0xF & params.m_sfnSf));
+        // get the RNTI from vendor specific parameters
+        Ue *ue = FindUe (Traits::GetSrsCqiRnti (params));
+        if (ue == 0)
+          {
+            return;
+          }
+        ue->m_ulSinr.resize (m_cschedCellConfig.m_ulBandwidth);
+        for (uint32_t j = 0; j < m_cschedCellConfig.m_ulBandwidth; j++)
+          {
+            double sinr = Traits::FpS11dot3toDouble (params.m_ulCqi.m_sinr.at (j));
+            ue->m_ulSinr.at (j) = sinr;
+            NS_LOG_INFO (this << " RNTI " << ue->m_rnti << " SRS-CQI for RB  " << j << " value " << sinr);
+          }
+        // update correspondent timer
+        ue->m_ulSinrTimer = m_cqiTimersThreshold;
+      }
+      break;
+    case UlCqi_s::PUCCH_1:
+    case UlCqi_s::PUCCH_2:
+    case UlCqi_s::PRACH:
+      {
+        NS_FATAL_ERROR (g_log.Name () << " supports only PUSCH and SRS UL-CQIs");
+      }
+      break;
+    default:
+      NS_FATAL_ERROR ("Unknown type of UL-CQI");
+    }
+  return;
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::UpdateDlRlcBufferInfo (FfMacSchedSapProvider::SchedDlRlcBufferReqParameters &rlc, uint16_t size)
+{
+  NS_LOG_INFO (this << " UE " << rlc.m_rnti << " LC " << (uint16_t)rlc.m_logicalChannelIdentity << " txqueue " << rlc.m_rlcTransmissionQueueSize << " retxqueue " << rlc.m_rlcRetransmissionQueueSize << " status " << rlc.m_rlcStatusPduSize << " decrease " << size);
+  // Update queues: RLC tx order Status, ReTx, Tx
+  // Update status queue
+  if ((rlc.m_rlcStatusPduSize > 0) && (size >= rlc.m_rlcStatusPduSize))
+    {
+      rlc.m_rlcStatusPduSize = 0;
+    }
+  else if ((rlc.m_rlcRetransmissionQueueSize > 0) && (size >= rlc.m_rlcRetransmissionQueueSize))
+    {
+      rlc.m_rlcRetransmissionQueueSize = 0;
+    }
+  else if (rlc.m_rlcTransmissionQueueSize > 0)
+    {
+      uint32_t rlcOverhead;
+      if (rlc.m_logicalChannelIdentity == 1)
+        {
+          // for SRB1 (using RLC AM) it's better to
+          // overestimate RLC overhead rather than
+          // underestimate it and risk unneeded
+          // segmentation which increases delay
+          rlcOverhead = 4;
+        }
+      else
+        {
+          // minimum RLC overhead due to header
+          rlcOverhead = 2;
+        }
+      // update transmission queue
+      if (rlc.m_rlcTransmissionQueueSize <= size - rlcOverhead)
+        {
+          rlc.m_rlcTransmissionQueueSize = 0;
+        }
+      else
+        {
+          rlc.m_rlcTransmissionQueueSize -= size - rlcOverhead;
+        }
+    }
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::UpdateUlRlcBufferInfo (Ue &ue, uint16_t size)
+{
+  size = size - 2; // remove the minimum RLC overhead
+  NS_LOG_INFO (this << " UE " << ue.m_rnti << " size " << size << " BSR " << ue.m_bsr);
+  if (ue.m_bsr >= size)
+    {
+      ue.m_bsr -= size;
+    }
+  else
+    {
+      ue.m_bsr = 0;
+    }
+}
+
+template <class Traits, class Policy>
+void
+FfMacSchedulerEngine<Traits, Policy>::TransmissionModeConfigurationUpdate (uint16_t rnti, uint8_t txMode)
+{
+  NS_LOG_FUNCTION (this << " RNTI " << rnti << " txMode " << (uint16_t)txMode);
+  FfMacCschedSapUser::CschedUeConfigUpdateIndParameters params;
+  params.m_rnti = rnti;
+  params.m_transmissionMode = txMode;
+  m_cschedSapUser->CschedUeConfigUpdateInd (params);
+}
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_ENGINE_H */
@@ -0,0 +1,1319 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FF_MAC_SCHEDULER_POLICIES_H
+#define FF_MAC_SCHEDULER_POLICIES_H
+
+#include <ns3/ff-mac-common.h>
+#include <ns3/ff-mac-rbg-allocator.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ *
+ * Default hooks of the policies of FfMacSchedulerEngine: no per UE state,
+ * no FFR, MCS from the subband CQIs and nothing to do on LC configuration,
+ * on new LCs and once the DCIs are built.
+ *
+ * The hooks are templates on the engine, which is a friend of the policy:
+ * ScheduleDl () reads the UEs of the engine and fills the m_dlRbgs of the
+ * UEs it serves, through the RBG allocator of the engine.
+ */
+class FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+  };
+
+  static const bool FFR_AWARE = false;  ///< the policy follows the FFR algorithm
+  static const bool SUBBAND_MCS = true; ///< the MCS is taken from the subband CQIs
+  static const bool UL_RESUME_UNSERVED = true; ///< the next UL round starts from the UE left without resources
+  static const bool STATS_IF_HARQ_FULL = false; ///< the stats are updated also when HARQ takes all the RBGs
+
+  /**
+   * \param info the state of the UE
+   * \param lc the configuration of the LC
+   * \param first true for the first LC of the UE
+   */
+  template <class Info>
+  void ConfigureLc (Info &info, const LogicalChannelConfigListElement_s &lc, bool first)
+  {
+  }
+
+  /**
+   * \param e the engine
+   * \param ue the UE with a new LC in the RLC buffer reports
+   */
+  template <class Engine, class Ue>
+  void AddDlLc (Engine &e, Ue &ue)
+  {
+  }
+
+  /**
+   * \param e the engine, with the bytes of each UE in this TTI
+   */
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+  }
+
+  /**
+   * Update an averaged throughput (see eq. 12.3 of Sec 12.3.1.2 of LTE – The
+   * UMTS Long Term Evolution, Ed Wiley)
+   *
+   * \param averaged the averaged throughput
+   * \param bytes the bytes of the last TTI
+   * \return the new averaged throughput
+   */
+  static double UpdateAveragedThroughput (double averaged, uint32_t bytes)
+  {
+    const double timeWindow = 99.0;
+    return ((1.0 - (1.0 / timeWindow)) * averaged) + ((1.0 / timeWindow) * (double)(bytes / 0.001));
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Proportional Fair: each RBG goes to the UE with the highest ratio between
+ * its achievable rate and its averaged throughput.
+ */
+class PfFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_lastAveragedThroughput (1)
+    {
+    }
+    double m_lastAveragedThroughput; ///< past average throughput
+  };
+
+  static const bool FFR_AWARE = true; ///< the policy follows the FFR algorithm
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    e.m_candidates.clear ();
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (e.IsDlSchedulable (*it) && e.LcActivePerFlow (*it) > 0)
+          {
+            e.m_candidates.push_back (e.MakeCandidate (*it, it->m_info.m_lastAveragedThroughput));
+          }
+      }
+    e.m_rbgAllocator.template Allocate<FfMacRelativeRateMetric> (e.m_candidates, e.GetFfrSapProvider (), e.m_rbgMap);
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (it->m_lcConfigured)
+          {
+            it->m_info.m_lastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_lastAveragedThroughput, it->m_dlBytes);
+          }
+      }
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Throughput to Average: each RBG goes to the UE with the highest ratio
+ * between its achievable rate on the RBG and its achievable wideband rate.
+ */
+class TtaFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    e.m_candidates.clear ();
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (e.IsDlSchedulable (*it) && e.LcActivePerFlow (*it) > 0)
+          {
+            double weight = e.m_rbgAllocator.GetWbRate (e.GetWbCqi (*it), it->m_nLayer);
+            e.m_candidates.push_back (e.MakeCandidate (*it, weight));
+          }
+      }
+    e.m_rbgAllocator.template Allocate<FfMacRelativeRateMetric> (e.m_candidates, e.GetFfrSapProvider (), e.m_rbgMap);
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Frequency Domain Maximize Throughput: each RBG goes to the UE with the
+ * highest achievable rate on it.
+ */
+class FdmtFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    e.m_candidates.clear ();
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (e.IsDlSchedulable (*it) && e.LcActivePerFlow (*it) > 0)
+          {
+            e.m_candidates.push_back (e.MakeCandidate (*it, 0.0));
+          }
+      }
+    e.m_rbgAllocator.template Allocate<FfMacMaxRateMetric> (e.m_candidates, e.GetFfrSapProvider (), e.m_rbgMap);
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Time Domain Maximize Throughput: all the free RBGs go to the UE with the
+ * highest achievable wideband rate.
+ */
+class TdmtFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  static const bool SUBBAND_MCS = false; ///< the MCS is taken from the wideband CQI
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typename Engine::Ue *best = 0;
+    double metricMax = 0.0;
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        uint8_t wbCqi = e.GetWbCqi (*it);
+        // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+        if (!e.IsDlSchedulable (*it) || wbCqi == 0 || e.LcActivePerFlow (*it) == 0)
+          {
+            continue;
+          }
+        double metric = e.m_rbgAllocator.GetWbRate (wbCqi, it->m_nLayer);
+        if (metric > metricMax)
+          {
+            metricMax = metric;
+            best = &(*it);
+          }
+      }
+    if (best != 0)
+      {
+        e.m_rbgAllocator.AllocateAll (best->m_rnti, e.GetFfrSapProvider (), e.m_rbgMap, best->m_dlRbgs);
+      }
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Time Domain Blind Equal Throughput: all the free RBGs go to the UE with
+ * the lowest averaged throughput.
+ */
+class TdbetFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_lastAveragedThroughput (1)
+    {
+    }
+    double m_lastAveragedThroughput; ///< past average throughput
+  };
+
+  static const bool SUBBAND_MCS = false; ///< the MCS is taken from the wideband CQI
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typename Engine::Ue *best = 0;
+    double metricMax = 0.0;
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (!e.IsDlSchedulable (*it))
+          {
+            continue;
+          }
+        double metric = 1 / it->m_info.m_lastAveragedThroughput;
+        if (metric > metricMax)
+          {
+            metricMax = metric;
+            best = &(*it);
+          }
+      }
+    if (best != 0)
+      {
+        e.m_rbgAllocator.AllocateAll (best->m_rnti, e.GetFfrSapProvider (), e.m_rbgMap, best->m_dlRbgs);
+      }
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (it->m_lcConfigured)
+          {
+            it->m_info.m_lastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_lastAveragedThroughput, it->m_dlBytes);
+          }
+      }
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Frequency Domain Blind Equal Throughput: each RBG goes to the UE with the
+ * lowest averaged throughput, expected with the RBGs it already got in the
+ * TTI.
+ */
+class FdbetFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_lastAveragedThroughput (1),
+        m_expectedThroughput (0),
+        m_rbgCount (0)
+    {
+    }
+    double m_lastAveragedThroughput; ///< past average throughput
+    double m_expectedThroughput;     ///< average throughput expected with the RBGs of this TTI
+    int m_rbgCount;                  ///< RBGs of this TTI, plus one
+  };
+
+  static const bool SUBBAND_MCS = false; ///< the MCS is taken from the wideband CQI
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typedef typename Engine::Ue Ue;
+    std::vector<Ue*> ues;
+    for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (e.IsDlSchedulable (*it))
+          {
+            it->m_info.m_expectedThroughput = it->m_info.m_lastAveragedThroughput;
+            it->m_info.m_rbgCount = 1;
+            ues.push_back (&(*it));
+          }
+      }
+    if (ues.empty ())
+      {
+        return;
+      }
+
+    // The scheduler tries the best to achieve the equal throughput among all UEs
+    Ue *best = GetLowestThroughput (ues);
+    for (int i = 0; i < e.m_rbgNum; i++)
+      {
+        if (e.m_rbgMap.at (i) == true)
+          {
+            continue;
+          }
+        // allocate one RBG to current UE
+        e.m_rbgAllocator.AssignRbg (i, e.m_rbgMap, best->m_dlRbgs);
+
+        // caculate expected throughput for current UE
+        uint8_t mcs = best->m_p10Valid ? e.m_amc->GetMcsFromCqi (best->m_p10Cqi) : 0; // no info on this user -> lowest MCS
+        uint32_t bytesTxed = 0;
+        for (uint8_t j = 0; j < best->m_nLayer; j++)
+          {
+            int tbSize = (e.m_amc->GetTbSizeFromMcs (mcs, best->m_info.m_rbgCount * e.m_rbgSize) / 8); // (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
+            bytesTxed += tbSize;
+          }
+        best->m_info.m_expectedThroughput = UpdateAveragedThroughput (best->m_info.m_lastAveragedThroughput, bytesTxed);
+        best->m_info.m_rbgCount++;
+
+        best = GetLowestThroughput (ues);
+      }
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (it->m_lcConfigured)
+          {
+            it->m_info.m_lastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_lastAveragedThroughput, it->m_dlBytes);
+          }
+      }
+  }
+
+private:
+  /**
+   * \param ues the UEs
+   * \return the first UE with the lowest expected throughput
+   */
+  template <class Ue>
+  static Ue* GetLowestThroughput (const std::vector<Ue*> &ues)
+  {
+    Ue *best = ues.front ();
+    double metricMax = 0.0;
+    for (typename std::vector<Ue*>::const_iterator it = ues.begin (); it != ues.end (); ++it)
+      {
+        double metric = 1 / (*it)->m_info.m_expectedThroughput;
+        if (metric > metricMax)
+          {
+            metricMax = metric;
+            best = *it;
+          }
+      }
+    return best;
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Round Robin: the free RBGs are shared equally among the UEs with data,
+ * starting from the one after the last UE served.
+ */
+class RrFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_active (false)
+    {
+    }
+    bool m_active; ///< the UE is served in this TTI
+  };
+
+  static const bool SUBBAND_MCS = false; ///< the MCS is taken from the wideband CQI
+
+  /**
+   * Start the new UEs with the lowest CQI, so that they can be served
+   * before their first report
+   *
+   * \param e the engine
+   * \param ue the UE
+   */
+  template <class Engine, class Ue>
+  void AddDlLc (Engine &e, Ue &ue)
+  {
+    if (!ue.m_p10Valid)
+      {
+        // initialized to 1 (i.e., the lowest value for transmitting a signal)
+        ue.m_p10Valid = true;
+        ue.m_p10Cqi = 1;
+        ue.m_p10Timer = e.m_cqiTimersThreshold;
+      }
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typedef typename Engine::Ue Ue;
+    int nTbs = 0;
+    for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+        it->m_info.m_active = e.IsDlSchedulable (*it) && e.LcActivePerFlow (*it) > 0 && e.GetWbCqi (*it) != 0;
+        if (it->m_info.m_active)
+          {
+            nTbs++;
+          }
+      }
+    if (nTbs == 0)
+      {
+        return;
+      }
+
+    // Divide the resource equally among the active users according to
+    // Resource allocation type 0 (see sec 7.1.6.1 of 36.213)
+    int rbgPerTb = (e.m_rbgNum - e.m_rbgAllocatedNum) / nTbs;
+    if (rbgPerTb == 0)
+      {
+        rbgPerTb = 1;                // at least 1 rbg per TB (till available resource)
+      }
+    int rbgAllocated = 0;
+
+    // round robin assignment to all UEs registered starting from the subsequent of the one
+    // served last scheduling trigger event
+    typename std::vector<Ue>::iterator it = e.m_ues.begin ();
+    typename Engine::Ue *next = e.FindUe (e.m_nextRntiDl);
+    if (next != 0)
+      {
+        it += next - &e.m_ues.front ();
+      }
+    e.m_nextRntiDl = it->m_rnti;
+    do
+      {
+        if (it->m_info.m_active)
+          {
+            e.m_rbgAllocator.AllocateNext (rbgPerTb, rbgAllocated, e.m_rbgMap, it->m_dlRbgs);
+            e.m_rbgAllocatedNum += rbgPerTb;
+            if (e.m_rbgAllocatedNum == e.m_rbgNum)
+              {
+                e.m_nextRntiDl = it->m_rnti; // store last RNTI served
+                break;                       // no more RGB to be allocated
+              }
+          }
+        ++it;
+        if (it == e.m_ues.end ())
+          {
+            // restart from the first
+            it = e.m_ues.begin ();
+          }
+      }
+    while (it->m_rnti != e.m_nextRntiDl);
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Priority Set Scheduler: the time domain picks the UEs below their target
+ * bit rate first, the frequency domain shares the RBGs among the picked UEs
+ * with the CoItA or the PFsch metric.
+ */
+class PssFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_lastAveragedThroughput (1),
+        m_secondLastAveragedThroughput (1),
+        m_targetThroughput (0),
+        m_tdSelected (false),
+        m_sbCqiSum (0)
+    {
+    }
+    double m_lastAveragedThroughput;       ///< past average throughput
+    double m_secondLastAveragedThroughput; ///< past average throughput of the TTIs the UE was picked
+    double m_targetThroughput;             ///< target throughput
+    bool m_tdSelected;                     ///< picked by the time domain in this TTI
+    uint8_t m_sbCqiSum;                    ///< sum of the subband CQIs, for CoItA
+  };
+
+  static const bool FFR_AWARE = true; ///< the policy follows the FFR algorithm
+  static const bool UL_RESUME_UNSERVED = false; ///< the next UL round starts from the UE left without resources
+
+  std::string m_fdSchedulerType; ///< frequency domain scheduler, "CoItA" or "PFsch"
+  uint32_t m_nMux;               ///< number of UEs picked by the time domain, 0 for half of them
+
+  /**
+   * \param info the state of the UE
+   * \param lc the configuration of the LC
+   * \param first true for the first LC of the UE
+   */
+  void ConfigureLc (UeInfo &info, const LogicalChannelConfigListElement_s &lc, bool first)
+  {
+    // update GBR from UeManager::SetupDataRadioBearer ()
+    info.m_targetThroughput = lc.m_eRabGuaranteedBitrateDl / 8;   // byte/s
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typedef typename Engine::Ue Ue;
+
+    // Time Domain scheduler
+    std::vector <std::pair<double, uint16_t> > ueSet1;
+    std::vector <std::pair<double, uint16_t> > ueSet2;
+    for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        it->m_info.m_tdSelected = false;
+        if (!e.IsDlSchedulable (*it) || e.LcActivePerFlow (*it) == 0)
+          {
+            continue;
+          }
+        if (it->m_info.m_lastAveragedThroughput < it->m_info.m_targetThroughput)
+          {
+            // calculate TD BET metric
+            ueSet1.push_back (std::make_pair (1 / it->m_info.m_lastAveragedThroughput, it->m_rnti));
+          }
+        else
+          {
+            // calculate TD PF metric
+            double metric = 0.0;
+            uint8_t wbCqi = e.GetWbCqi (*it);
+            if (wbCqi > 0)
+              {
+                metric = e.m_rbgAllocator.GetWbRate (wbCqi, it->m_nLayer) / it->m_info.m_lastAveragedThroughput;
+              }
+            ueSet2.push_back (std::make_pair (metric, it->m_rnti));
+          }
+      }
+    if (ueSet1.empty () && ueSet2.empty ())
+      {
+        return;
+      }
+
+    // sorting UE in ueSet1 and ueSet1 in descending order based on their metric value
+    std::sort (ueSet1.rbegin (), ueSet1.rend ());
+    std::sort (ueSet2.rbegin (), ueSet2.rend ());
+
+    // select UE set for frequency domain scheduler
+    uint32_t nMux;
+    if (m_nMux > 0)
+      {
+        nMux = m_nMux;
+      }
+    else
+      {
+        // select half number of UE
+        nMux = (ueSet1.size () + ueSet2.size () <= 2) ? 1 : (ueSet1.size () + ueSet2.size ()) / 2;
+      }
+    ueSet1.insert (ueSet1.end (), ueSet2.begin (), ueSet2.end ());
+    for (uint32_t i = 0; i < ueSet1.size () && i < nMux; i++)
+      {
+        e.FindUe (ueSet1[i].second)->m_info.m_tdSelected = true;
+      }
+    std::vector<Ue*> tdUes;
+    for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (it->m_info.m_tdSelected)
+          {
+            tdUes.push_back (&(*it));
+          }
+      }
+
+    if (m_fdSchedulerType.compare ("CoItA") == 0)
+      {
+        // FD scheduler: Carrier over Interference to Average (CoItA)
+        for (typename std::vector<Ue*>::iterator it = tdUes.begin (); it != tdUes.end (); ++it)
+          {
+            uint8_t sum = 0;
+            for (int i = 0; i < e.m_rbgNum; i++)
+              {
+                sum += GetSbCqiSum (**it, i);
+              }
+            (*it)->m_info.m_sbCqiSum = sum;
+          }
+
+        for (int i = 0; i < e.m_rbgNum; i++)
+          {
+            if (e.m_rbgMap.at (i) == true)
+              {
+                continue;
+              }
+            Ue *best = 0;
+            double metricMax = 0.0;
+            for (typename std::vector<Ue*>::iterator it = tdUes.begin (); it != tdUes.end (); ++it)
+              {
+                if (e.GetFfrSapProvider ()->IsDlRbgAvailableForUe (i, (*it)->m_rnti) == false)
+                  {
+                    continue;
+                  }
+                // calculate PF weigth
+                double weight = GetTbrWeight ((*it)->m_info);
+                double colMetric = (double) GetSbCqiSum (**it, i) / (double)(*it)->m_info.m_sbCqiSum;
+                double metric = (colMetric != 0) ? weight * colMetric : 1;
+                if (metric > metricMax)
+                  {
+                    metricMax = metric;
+                    best = *it;
+                  }
+              }
+            if (best != 0)
+              {
+                e.m_rbgAllocator.AssignRbg (i, e.m_rbgMap, best->m_dlRbgs);
+              }
+          }
+      }
+    else if (m_fdSchedulerType.compare ("PFsch") == 0)
+      {
+        // FD scheduler: Proportional Fair scheduled (PFsch)
+        e.m_candidates.clear ();
+        for (typename std::vector<Ue*>::iterator it = tdUes.begin (); it != tdUes.end (); ++it)
+          {
+            // metric = weight * achievableRate / secondLastAveragedThroughput
+            double weight = GetTbrWeight ((*it)->m_info);
+            e.m_candidates.push_back (e.MakeCandidate (**it, (*it)->m_info.m_secondLastAveragedThroughput / weight));
+          }
+        e.m_rbgAllocator.template Allocate<FfMacRelativeRateMetric> (e.m_candidates, e.GetFfrSapProvider (), e.m_rbgMap);
+      }
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (!it->m_lcConfigured)
+          {
+            continue;
+          }
+        if (it->m_info.m_tdSelected)
+          {
+            it->m_info.m_secondLastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_secondLastAveragedThroughput, it->m_dlBytes);
+          }
+        it->m_info.m_lastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_lastAveragedThroughput, it->m_dlBytes);
+      }
+  }
+
+private:
+  /**
+   * \param info the state of the UE
+   * \return the ratio between the target and the averaged throughput, at least 1
+   */
+  static double GetTbrWeight (const UeInfo &info)
+  {
+    double weight = info.m_targetThroughput / info.m_lastAveragedThroughput;
+    return (weight < 1.0) ? 1.0 : weight;
+  }
+
+  /**
+   * \param ue the UE
+   * \param rbg the RBG
+   * \return the sum of the subband CQIs of the layers of the UE on the RBG,
+   * 0 if out of range
+   */
+  template <class Ue>
+  static uint8_t GetSbCqiSum (const Ue &ue, int rbg)
+  {
+    std::vector <uint8_t> sbCqis;
+    if (ue.m_a30Valid)
+      {
+        sbCqis = ue.m_a30Cqi.m_higherLayerSelected.at (rbg).m_sbCqi;
+      }
+    else
+      {
+        sbCqis.assign (ue.m_nLayer, 1);  // start with lowest value
+      }
+    uint8_t cqi1 = sbCqis.at (0);
+    uint8_t cqi2 = (sbCqis.size () > 1) ? sbCqis.at (1) : 1;
+    uint8_t sum = 0;
+    if ((cqi1 > 0) || (cqi2 > 0)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+      {
+        for (uint8_t k = 0; k < ue.m_nLayer; k++)
+          {
+            // no info on this subband -> 0
+            sum += (sbCqis.size () > k) ? sbCqis.at (k) : 0;
+          }
+      }
+    return sum;
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Common part of the Token Bank Fair Queue policies: each UE gets tokens
+ * at its maximum bit rate, and borrows from the shared bank beyond its pool.
+ */
+class TbfqFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_tokenGenerationRate (0),
+        m_tokenPoolSize (0),
+        m_maxTokenPoolSize (0),
+        m_counter (0),
+        m_burstCredit (0),
+        m_debtLimit (0),
+        m_creditableThreshold (0),
+        m_allocated (false)
+    {
+    }
+    uint64_t m_tokenGenerationRate;  ///< token generation rate ( byte/s )
+    uint32_t m_tokenPoolSize;        ///< current size of token pool (byte)
+    uint32_t m_maxTokenPoolSize;     ///< maximum size of token pool (byte)
+    int m_counter;                   ///< the number of token borrow or given to token bank
+    uint32_t m_burstCredit;          ///< the maximum number of tokens connection i can borrow from the bank each time
+    int m_debtLimit;                 ///< counter threshold that the flow cannot further borrow tokens from bank
+    uint32_t m_creditableThreshold;  ///< the flow cannot borrow token from bank until the number of token it has deposited to bank reaches this threshold
+    bool m_allocated;                ///< already served in this TTI
+  };
+
+  static const bool FFR_AWARE = true; ///< the policy follows the FFR algorithm
+  static const bool UL_RESUME_UNSERVED = false; ///< the next UL round starts from the UE left without resources
+
+  TbfqFfMacPolicy ()
+    : m_bankSize (0)
+  {
+  }
+
+  uint64_t m_bankSize;             ///< the number of bytes in token bank
+  int m_debtLimit;                 ///< flow debt limit (byte)
+  uint32_t m_creditLimit;          ///< flow credit limit (byte)
+  uint32_t m_tokenPoolSize;        ///< maximum size of token pool (byte)
+  uint32_t m_creditableThreshold;  ///< threshold of flow credit
+
+  /**
+   * \param info the state of the UE
+   * \param lc the configuration of the LC
+   * \param first true for the first LC of the UE
+   */
+  void ConfigureLc (UeInfo &info, const LogicalChannelConfigListElement_s &lc, bool first)
+  {
+    if (first)
+      {
+        info.m_tokenPoolSize = 0;
+        info.m_maxTokenPoolSize = m_tokenPoolSize;
+        info.m_counter = 0;
+        info.m_burstCredit = m_creditLimit; // bytes
+        info.m_debtLimit = m_debtLimit; // bytes
+        info.m_creditableThreshold = m_creditableThreshold;
+      }
+    // update MBR from UeManager::SetupDataRadioBearer ()
+    info.m_tokenGenerationRate = lc.m_eRabMaximulBitrateDl / 8;   // byte/s
+  }
+
+  /**
+   * Update token pool, counter and bank size
+   *
+   * \param ues the UEs of the engine
+   */
+  template <class Ue>
+  void GenerateTokens (std::vector<Ue> &ues)
+  {
+    for (typename std::vector<Ue>::iterator it = ues.begin (); it != ues.end (); ++it)
+      {
+        if (!it->m_lcConfigured)
+          {
+            continue;
+          }
+        UeInfo &info = it->m_info;
+        if (info.m_tokenGenerationRate / 1000 + info.m_tokenPoolSize > info.m_maxTokenPoolSize)
+          {
+            info.m_counter += info.m_tokenGenerationRate / 1000 - (info.m_maxTokenPoolSize - info.m_tokenPoolSize);
+            info.m_tokenPoolSize = info.m_maxTokenPoolSize;
+            m_bankSize += info.m_tokenGenerationRate / 1000 - (info.m_maxTokenPoolSize - info.m_tokenPoolSize);
+          }
+        else
+          {
+            info.m_tokenPoolSize += info.m_tokenGenerationRate / 1000;
+          }
+      }
+  }
+
+  /**
+   * Take the tokens of a transmission from the pool of the UE, and from the
+   * bank beyond the pool
+   *
+   * \param info the state of the UE
+   * \param bytesTxed the bytes of the transmission
+   */
+  void ConsumeTokens (UeInfo &info, uint32_t bytesTxed)
+  {
+    if (bytesTxed <= info.m_tokenPoolSize)
+      {
+        info.m_tokenPoolSize -= bytesTxed;
+      }
+    else
+      {
+        info.m_counter = info.m_counter - (bytesTxed - info.m_tokenPoolSize);
+        info.m_tokenPoolSize = 0;
+        if (m_bankSize <= (bytesTxed - info.m_tokenPoolSize))
+          {
+            m_bankSize = 0;
+          }
+        else
+          {
+            m_bankSize = m_bankSize - (bytesTxed - info.m_tokenPoolSize);
+          }
+      }
+  }
+
+  /**
+   * \param info the state of the UE
+   * \return the ratio between the tokens given to the bank and the token
+   * generation rate
+   */
+  static double GetMetric (const UeInfo &info)
+  {
+    return ((double) info.m_counter) / ((double) info.m_tokenGenerationRate);
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Time Domain Token Bank Fair Queue: all the free RBGs go to the UE with
+ * the highest share of tokens given to the bank.
+ */
+class TdtbfqFfMacPolicy : public TbfqFfMacPolicy
+{
+protected:
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    GenerateTokens (e.m_ues);
+
+    // select UE with largest metric
+    typename Engine::Ue *best = 0;
+    double metricMax = 0.0;
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (!e.IsDlSchedulable (*it))
+          {
+            continue;
+          }
+        double metric = GetMetric (it->m_info);
+        if (best == 0 || metric > metricMax)
+          {
+            metricMax = metric;
+            best = &(*it);
+          }
+      }
+    if (best != 0)
+      {
+        e.m_rbgAllocator.AllocateAll (best->m_rnti, e.GetFfrSapProvider (), e.m_rbgMap, best->m_dlRbgs);
+      }
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (!it->m_dlRbgs.empty ())
+          {
+            ConsumeTokens (it->m_info, it->m_dlBytes);
+          }
+      }
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Frequency Domain Token Bank Fair Queue: the UEs are served by decreasing
+ * share of tokens given to the bank, each one with its best RBGs until its
+ * tokens or its data are exhausted.
+ */
+class FdtbfqFfMacPolicy : public TbfqFfMacPolicy
+{
+protected:
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typedef typename Engine::Ue Ue;
+    GenerateTokens (e.m_ues);
+    for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        it->m_info.m_allocated = false;
+      }
+
+    int totalRbg = 0;
+    while (totalRbg < e.m_rbgNum)
+      {
+        // select UE with largest metric
+        Ue *best = 0;
+        double metricMax = 0.0;
+        for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+          {
+            if (!e.IsDlSchedulable (*it) || e.LcActivePerFlow (*it) == 0 || it->m_info.m_allocated)
+              {
+                continue;
+              }
+            double metric = GetMetric (it->m_info);
+            if (best == 0 || metric > metricMax)
+              {
+                metricMax = metric;
+                best = &(*it);
+              }
+          }
+        if (best == 0)
+          {
+            // all UEs are allocated RBG or all UEs already allocated for HARQ or without HARQ process available
+            break;
+          }
+
+        // mark this UE as "allocated"
+        UeInfo &info = best->m_info;
+        info.m_allocated = true;
+
+        // calculate the maximum number of byte that the scheduler can assigned to this UE
+        uint32_t budget = 0;
+        if (m_bankSize > 0)
+          {
+            budget = info.m_counter - info.m_debtLimit;
+            if (budget > info.m_burstCredit)
+              {
+                budget = info.m_burstCredit;
+              }
+            if (budget > m_bankSize)
+              {
+                budget = m_bankSize;
+              }
+          }
+        budget = budget + info.m_tokenPoolSize;
+        if (budget == 0)
+          {
+            // there are no tokens for this UE
+            continue;
+          }
+
+        // calcualte how much bytes this UE actally need, from the RLC buffer of its last LC
+        const FfMacSchedSapProvider::SchedDlRlcBufferReqParameters &rlc = best->m_rlcBuffers.back ();
+        uint32_t rlcBufSize = rlc.m_rlcTransmissionQueueSize + rlc.m_rlcRetransmissionQueueSize + rlc.m_rlcStatusPduSize;
+        if (budget > rlcBufSize)
+          {
+            budget = rlcBufSize;
+          }
+
+        // assign RBGs to this UE
+        uint32_t bytesTxed = 0;
+        uint32_t bytesTxedTmp = 0;
+        int rbgIndex = 0;
+        FfMacRbgCandidate candidate = e.MakeCandidate (*best, 0.0);
+        while (bytesTxed <= budget)
+          {
+            totalRbg++;
+
+            // find RBG with largest achievableRate
+            double achievableRateMax = 0.0;
+            rbgIndex = e.m_rbgNum;
+            for (int k = 0; k < e.m_rbgNum; k++)
+              {
+                if (e.m_rbgMap.at (k) == true)
+                  {
+                    continue;
+                  }
+                if (e.GetFfrSapProvider ()->IsDlRbgAvailableForUe (k, best->m_rnti) == false)
+                  {
+                    continue;
+                  }
+                double achievableRate;
+                if (e.m_rbgAllocator.GetSbRate (candidate, k, achievableRate)) // CQI == 0 means "out of range" (see table 7.2.3-1 of 36.213)
+                  {
+                    if (achievableRate > achievableRateMax)
+                      {
+                        achievableRateMax = achievableRate;
+                        rbgIndex = k;
+                      }
+                  }
+              }
+            if (rbgIndex == e.m_rbgNum)
+              {
+                // all RBGs are already assigned
+                totalRbg = e.m_rbgNum;
+                break;
+              }
+
+            // assign this RBG to UE
+            e.m_rbgAllocator.AssignRbg (rbgIndex, e.m_rbgMap, best->m_dlRbgs);
+
+            // calculate tb size
+            DlDciListElement_s dci;
+            bytesTxedTmp = bytesTxed;
+            bytesTxed = e.SetSubbandMcs (*best, dci);
+          }
+
+        // remove and unmark last RBG assigned to UE
+        if (bytesTxed > budget)
+          {
+            best->m_dlRbgs.pop_back ();
+            bytesTxed = bytesTxedTmp;  // recovery bytesTxed
+            totalRbg--;
+            e.m_rbgMap.at (rbgIndex) = false;  // unmark this RBG
+          }
+
+        ConsumeTokens (info, bytesTxed);
+      }
+  }
+};
+
+/**
+ * \ingroup ff-api
+ *
+ * Channel and QoS Aware: the LCs are grouped by head of line delay, GBR
+ * first, and each group shares the RBGs with the CqaFf or the CqaPf metric.
+ */
+class CqaFfMacPolicy : public FfMacSchedulerPolicy
+{
+protected:
+  /// per UE state of the policy
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_lastAveragedThroughput (1),
+        m_secondLastAveragedThroughput (1),
+        m_targetThroughput (0),
+        m_worstCqi (15)
+    {
+    }
+    double m_lastAveragedThroughput;       ///< past average throughput
+    double m_secondLastAveragedThroughput; ///< past average throughput of the TTIs the UE was served
+    double m_targetThroughput;             ///< target throughput
+    uint8_t m_worstCqi;                    ///< worst subband CQI of the RBGs of this TTI
+  };
+
+  static const bool FFR_AWARE = true; ///< the policy follows the FFR algorithm
+  static const bool UL_RESUME_UNSERVED = false; ///< the next UL round starts from the UE left without resources
+  static const bool STATS_IF_HARQ_FULL = true; ///< the stats are updated also when HARQ takes all the RBGs
+
+  std::string m_cqaMetric; ///< the metric, "CqaFf" or "CqaPf"
+
+  /**
+   * \param info the state of the UE
+   * \param lc the configuration of the LC
+   * \param first true for the first LC of the UE
+   */
+  void ConfigureLc (UeInfo &info, const LogicalChannelConfigListElement_s &lc, bool first)
+  {
+    // update GBR from UeManager::SetupDataRadioBearer ()
+    info.m_targetThroughput = lc.m_eRabGuaranteedBitrateDl / 8;   // byte/s
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void ScheduleDl (Engine &e)
+  {
+    typedef typename Engine::Ue Ue;
+    const int groupingParameter = 1000;
+    const double tolerance = 1.1;
+
+    // the LCs with data, in RNTI and LCID order, grouped by HOL delay
+    std::vector<Flow<Ue> > flows;
+    std::map<int, std::vector<uint32_t>, std::greater<int> > gbrGroups;
+    std::map<int, std::vector<uint32_t>, std::greater<int> > nonGbrGroups;
+    for (typename std::vector<Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        it->m_info.m_worstCqi = 15;
+        if (!e.IsDlSchedulable (*it))
+          {
+            continue;
+          }
+        for (std::vector<LogicalChannelConfigListElement_s>::const_iterator itLc = it->m_lcs.begin (); itLc != it->m_lcs.end (); ++itLc)
+          {
+            typename std::vector<FfMacSchedSapProvider::SchedDlRlcBufferReqParameters>::iterator itRlc = e.FindLc (it->m_rlcBuffers, itLc->m_logicalChannelIdentity);
+            if (itRlc == it->m_rlcBuffers.end () || itRlc->m_logicalChannelIdentity != itLc->m_logicalChannelIdentity)
+              {
+                continue;
+              }
+            int delay = 0;
+            if (itRlc->m_rlcRetransmissionQueueSize > 0)
+              {
+                delay = itRlc->m_rlcRetransmissionHolDelay;
+              }
+            else if (itRlc->m_rlcTransmissionQueueSize > 0)
+              {
+                delay = itRlc->m_rlcTransmissionQueueHolDelay;
+              }
+            else
+              {
+                continue;
+              }
+            Flow<Ue> flow;
+            flow.m_ue = &(*it);
+            flow.m_lcid = itLc->m_logicalChannelIdentity;
+            flow.m_hol = (delay == 0) ? 1 : delay;
+            flow.m_dataToTransfer = 8 * ((int) itRlc->m_rlcRetransmissionQueueSize + (int) itRlc->m_rlcTransmissionQueueSize);
+            flow.m_assigned = 0;
+            if (itLc->m_qosBearerType == LogicalChannelConfigListElement_s::QBT_NON_GBR)
+              {
+                nonGbrGroups[delay / groupingParameter].push_back (flows.size ());
+                flows.push_back (flow);
+              }
+            else if (itLc->m_qosBearerType == LogicalChannelConfigListElement_s::QBT_GBR)
+              {
+                gbrGroups[delay / groupingParameter].push_back (flows.size ());
+                flows.push_back (flow);
+              }
+          }
+      }
+
+    // the RBGs still available
+    std::vector<int> availableRbgs;
+    for (int i = 0; i < e.m_rbgNum; i++)
+      {
+        if (e.m_rbgMap.at (i) == false)
+          {
+            availableRbgs.push_back (i);
+          }
+      }
+
+    // while there are more resources available, loop through the users that are grouped by HOL value
+    typename std::map<int, std::vector<uint32_t>, std::greater<int> >::iterator itGbr = gbrGroups.begin ();
+    typename std::map<int, std::vector<uint32_t>, std::greater<int> >::iterator itNonGbr = nonGbrGroups.begin ();
+    while (availableRbgs.size () > 0)
+      {
+        std::vector<uint32_t> *group;
+        if (itGbr != gbrGroups.end ())
+          {
+            group = &itGbr->second;
+            itGbr++;
+          }
+        else if (itNonGbr != nonGbrGroups.end ())
+          {
+            // if there are no more flows with retransmission queue start to scheduler flows with transmission queue
+            group = &itNonGbr->second;
+            itNonGbr++;
+          }
+        else
+          {
+            break;
+          }
+
+        while (availableRbgs.size () > 0 && group->size () > 0)
+          {
+            int currentRbg = availableRbgs.front ();
+            std::vector<uint32_t>::iterator best = group->end ();
+            uint8_t bestCqi = 1;
+            double maximumValueMetric = 0;
+            // Iterate through the users and calculate which user will use the best of the current RBG
+            for (std::vector<uint32_t>::iterator it = group->begin (); it != group->end (); ++it)
+              {
+                Flow<Ue> &flow = flows[*it];
+                Ue &ue = *flow.m_ue;
+                if (e.GetFfrSapProvider ()->IsDlRbgAvailableForUe (currentRbg, ue.m_rnti) == false)
+                  {
+                    continue;
+                  }
+                double tbrWeight = ue.m_info.m_targetThroughput / ue.m_info.m_lastAveragedThroughput;
+                if (tbrWeight < 1.0)
+                  {
+                    tbrWeight = 1.0;
+                  }
+
+                uint8_t cqi = 1; //higher better, maximum is 15
+                double coitaMetric = 1;
+                if (ue.m_a30Valid)
+                  {
+                    const std::vector<HigherLayerSelected_s> &sbCqis = ue.m_a30Cqi.m_higherLayerSelected;
+                    double coitaSum = 0;
+                    for (std::vector<int>::const_iterator itRbg = availableRbgs.begin (); itRbg != availableRbgs.end (); ++itRbg)
+                      {
+                        int val = 1; // if no info on channel use the worst cqi
+                        if ((int) sbCqis.size () > *itRbg && sbCqis[*itRbg].m_sbCqi.size () > 0)
+                          {
+                            val = sbCqis[*itRbg].m_sbCqi[0];
+                            if (val == 0)
+                              {
+                                val = 1; // if no info, use minimum
+                              }
+                            if (*itRbg == currentRbg)
+                              {
+                                cqi = val;
+                              }
+                          }
+                        coitaSum += val;
+                      }
+                    coitaMetric = cqi / coitaSum;
+                  }
+
+                uint8_t worstCqi = std::min (ue.m_info.m_worstCqi, cqi);
+                int mcs = e.m_amc->GetMcsFromCqi (worstCqi);
+                // similar to calculation of TB size (size of TB in bytes according to table 7.1.7.2.1-1 of 36.213)
+                flow.m_assigned = e.m_amc->GetTbSizeFromMcs (mcs, (ue.m_dlRbgs.size () + 1) * e.m_rbgSize) / 8;
+                double achievableRate = e.m_rbgAllocator.GetLayerRate (worstCqi);
+                double pfWeight = achievableRate / ue.m_info.m_secondLastAveragedThroughput;
+
+                double metric;
+                if (m_cqaMetric.compare ("CqaFf") == 0)
+                  {
+                    metric = coitaMetric * tbrWeight * flow.m_hol;
+                  }
+                else if (m_cqaMetric.compare ("CqaPf") == 0)
+                  {
+                    metric = tbrWeight * pfWeight * flow.m_hol;
+                  }
+                else
+                  {
+                    metric = 1;
+                  }
+                if (metric >= maximumValueMetric)
+                  {
+                    maximumValueMetric = metric;
+                    best = it;
+                    bestCqi = cqi;
+                  }
+              }
+
+            // erase current RBG from the list of available RBG
+            availableRbgs.erase (availableRbgs.begin ());
+            if (best == group->end ())
+              {
+                continue;
+              }
+            Flow<Ue> &flow = flows[*best];
+            e.m_rbgAllocator.AssignRbg (currentRbg, e.m_rbgMap, flow.m_ue->m_dlRbgs);
+            flow.m_ue->m_info.m_worstCqi = std::min (flow.m_ue->m_info.m_worstCqi, bestCqi);
+            if (flow.m_dataToTransfer <= flow.m_assigned * tolerance)
+              {
+                group->erase (best);
+              }
+          }
+      }
+  }
+
+  /// \param e the engine
+  template <class Engine>
+  void UpdateDlStats (Engine &e)
+  {
+    for (typename std::vector<typename Engine::Ue>::iterator it = e.m_ues.begin (); it != e.m_ues.end (); ++it)
+      {
+        if (!it->m_lcConfigured)
+          {
+            continue;
+          }
+        if (!it->m_dlRbgs.empty ())
+          {
+            it->m_info.m_secondLastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_secondLastAveragedThroughput, it->m_dlBytes);
+          }
+        it->m_info.m_lastAveragedThroughput = UpdateAveragedThroughput (it->m_info.m_lastAveragedThroughput, it->m_dlBytes);
+      }
+  }
+
+private:
+  /// a LC with data competing for the RBGs of this TTI
+  template <class Ue>
+  struct Flow
+  {
+    Ue *m_ue;             ///< the UE
+    uint8_t m_lcid;       ///< the LCID
+    int m_hol;            ///< head of line delay, at least 1
+    int m_dataToTransfer; ///< bits in the RLC queues
+    int m_assigned;       ///< bytes of the TB with the next RBG
+  };
+};
+
+} // namespace ns3
+
+#endif /* FF_MAC_SCHEDULER_POLICIES_H */
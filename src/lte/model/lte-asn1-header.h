@@ -65,17 +65,39 @@ public:
   virtual void PreSerialize (void) const = 0;
 
 protected:
-  mutable uint8_t m_serializationPendingBits; //!< pending bits
+  /**
+   * Bits written but not yet flushed to the scratch buffer, or read from
+   * the buffer but not yet consumed, left aligned (first bit is the MSB)
+   */
+  mutable uint64_t m_serializationPendingBits;
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
   mutable Buffer m_serializationResult; //!< serialization result
 
   /**
-   * Function to write in m_serializationResult, after resizing its size
+   * Write an octet
    * \param octet bits to write
    */
   void WriteOctet (uint8_t octet) const;
 
+  /**
+   * Append the numBits least significant bits of value, most significant
+   * first. Whole 64 bit words are flushed to a scratch buffer shared by all
+   * the headers, which is copied to m_serializationResult only by
+   * FinalizeSerialization.
+   * \param value bits to write
+   * \param numBits number of bits to write (at most 64)
+   */
+  void WriteBits (uint64_t value, uint8_t numBits) const;
+
+  /**
+   * Read bits, loading up to 64 bits at a time from the buffer
+   * \param numBits number of bits to read (at most 64)
+   * \param bIterator buffer iterator, advanced past the loaded octets
+   * \returns the bits read, right aligned
+   */
+  uint64_t ReadBits (uint8_t numBits, Buffer::Iterator &bIterator);
+
   // Serialization functions
 
   /**
@@ -523,6 +545,23 @@ protected:
    */
   Buffer::Iterator DeserializeSequenceOf (int *numElems, int nMax, int nMin,
                                           Buffer::Iterator bIterator);
+
+private:
+  /**
+   * Reset the bit writer before a call to PreSerialize
+   */
+  void StartSerialization (void) const;
+  /**
+   * Store the octets read by the last deserialization as the serialization
+   * result, so that the received message is not encoded again to get its
+   * size or to be forwarded. Deserialize methods call it by returning
+   * GetSerializedSize ().
+   */
+  void FinalizeDeserialization (void) const;
+
+  mutable bool m_isDataDeserializing; //!< true if a deserialization is in progress
+  Buffer::Iterator m_deserializationStart; //!< first octet of the message being deserialized
+  uint32_t m_numDeserializedOctets; //!< octets loaded by the bit reader
 };
 
 } // namespace ns3
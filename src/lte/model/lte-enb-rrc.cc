@@ -51,6 +51,7 @@
 #include "ns3/lte-pdcp-tag.h"
 #include <ns3/lte-rlc-sap.h>
 #include <ns3/epc-x2.h>
+#include <algorithm>
 
 
 namespace ns3 {
@@ -1043,16 +1044,30 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
   {
     //Copy lte-rlc-um.m_txOnBuffer to X2 forwarding buffer.
     NS_LOG_DEBUG(this << " Copying txonBuffer from RLC UM " << m_rnti);
-    m_x2forwardingBuffer = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
     m_x2forwardingBufferSize =  rlc->GetObject<LteRlcUm>()->GetTxBufferSize();
+    if (m_rrc->m_bulkRlcBufferTransfer && mcMmToMmWaveForwarding)
+    {
+      rlc->GetObject<LteRlcUm>()->TakeTxBuffer(m_x2forwardingBuffer);
+    }
+    else
+    {
+      m_x2forwardingBuffer = rlc->GetObject<LteRlcUm>()->GetTxBuffer();
+    }
   }
   else if (0 != rlc->GetObject<LteRlcUmLowLat> ())
   {
     //Copy lte-rlc-um-low-lat.m_txOnBuffer to X2 forwarding buffer.
     NS_LOG_DEBUG(this << " Copying txonBuffer from RLC UM " << m_rnti);
-    m_x2forwardingBuffer = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
-//    rlc->GetObject<LteRlcUmLowLat>()->ClearTxBuffer(); //sjkang0807
     m_x2forwardingBufferSize =  rlc->GetObject<LteRlcUmLowLat>()->GetTxBufferSize();
+    if (m_rrc->m_bulkRlcBufferTransfer && mcMmToMmWaveForwarding)
+    {
+      rlc->GetObject<LteRlcUmLowLat>()->TakeTxBuffer(m_x2forwardingBuffer);
+    }
+    else
+    {
+      m_x2forwardingBuffer = rlc->GetObject<LteRlcUmLowLat>()->GetTxBuffer();
+    }
+//    rlc->GetObject<LteRlcUmLowLat>()->ClearTxBuffer(); //sjkang0807
     std::cout<<"------------------ buffer forwarding occur ------------------ " << m_x2forwardingBuffer.size()<<"\t"<< m_x2forwardingBufferSize <<std::endl;
     NS_LOG_UNCOND("Forward to target cell RLC in HO  to " << m_targetCellId << "\t "<<" from " <<
           		   m_rrc->m_cellId);
@@ -1072,6 +1087,11 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     NS_ASSERT_MSG(bid > 0, "Bid can't be 0");
     NS_ASSERT_MSG(mcPdcp->GetUseMmWaveConnection(), "The McEnbPdcp is not forwarding data to the mmWave eNB, check if the switch happened!");
   }
+  // in bulk mode the PDUs are collected and leave in one X2-U message
+  EpcX2Sap::RlcBufferTransferParams transfer;
+  transfer.sourceCellId = m_rrc->m_cellId;
+  transfer.targetCellId = m_targetCellId;
+  transfer.gtpTeid = gtpTeid;
    while (!m_x2forwardingBuffer.empty())
   {
     NS_LOG_DEBUG(this << " Forwarding m_x2forwardingBuffer to target eNB, gtpTeid = " << gtpTeid );
@@ -1151,7 +1171,14 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
         //   NS_LOG_UNCOND("Forward to target cell RLC in HO  to " << m_targetCellId << "\t "<<m_secondMmWaveCellID << " from " <<
         //		   m_rrc->m_cellId);
          //  std::cout<< m_x2forwardingBuffer.size() << std::endl;
-            m_rrc->m_x2SapProvider->ForwardRlcPdu (params);
+            if (m_rrc->m_bulkRlcBufferTransfer)
+            {
+              transfer.pdcpPdus.push_back (rlcSdu);
+            }
+            else
+            {
+              m_rrc->m_x2SapProvider->ForwardRlcPdu (params);
+            }
          //   m_rrc->m_x2SapProvider->ForwardRlcPdu(params_2); //sjkang
         //   m_rrc->m_x2SapProvider_2->ForwardRlcPdu(params);
             NS_LOG_LOGIC ("sourceCellId = " << params.sourceCellId);
@@ -1187,6 +1214,12 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     }
     //NS_LOG_UNCOND(this << " After forwarding: buffer size = " << m_x2forwardingBufferSize );
   }
+
+  if (!transfer.pdcpPdus.empty())
+  {
+    NS_LOG_INFO("Transfer " << transfer.pdcpPdus.size() << " RLC PDUs of teid " << gtpTeid << " to " << m_targetCellId);
+    m_rrc->m_x2SapProvider->TransferRlcBuffer(transfer);
+  }
 }
 void
 UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTeid, bool mcLteToMmWaveForwarding, bool mcMmToMmWaveForwarding, uint8_t bid, bool copyMode)
@@ -1232,6 +1265,11 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     NS_ASSERT_MSG(bid > 0, "Bid can't be 0");
     NS_ASSERT_MSG(mcPdcp->GetUseMmWaveConnection(), "The McEnbPdcp is not forwarding data to the mmWave eNB, check if the switch happened!");
   }
+  // in bulk mode the PDUs are collected and leave in one X2-U message
+  EpcX2Sap::RlcBufferTransferParams transfer;
+  transfer.sourceCellId = m_rrc->m_cellId;
+  transfer.targetCellId = m_targetCellId;
+  transfer.gtpTeid = gtpTeid;
   std::vector<Ptr<Packet>>::iterator iter;
    for (iter = m_x2forwardingBuffer.begin(); iter!=m_x2forwardingBuffer.end(); iter ++)
   {
@@ -1278,7 +1316,14 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
           else
           {
         //   NS_LOG_UNCOND("Forward to target cell RLC in HO  to " << m_targetCellId << "\t "<<m_secondMmWaveCellID << " from " <<
-            m_rrc->m_x2SapProvider->ForwardRlcPdu (params);
+            if (m_rrc->m_bulkRlcBufferTransfer)
+            {
+              transfer.pdcpPdus.push_back (rlcSdu);
+            }
+            else
+            {
+              m_rrc->m_x2SapProvider->ForwardRlcPdu (params);
+            }
             NS_LOG_LOGIC ("sourceCellId = " << params.sourceCellId);
             NS_LOG_LOGIC ("targetCellId = " << params.targetCellId);
             NS_LOG_LOGIC("gtpTeid = " << params.gtpTeid);
@@ -1312,6 +1357,12 @@ UeManager::ForwardRlcBuffers(Ptr<LteRlc> rlc, Ptr<LtePdcp> pdcp, uint32_t gtpTei
     }
     //NS_LOG_UNCOND(this << " After forwarding: buffer size = " << m_x2forwardingBufferSize );
   }
+
+  if (!transfer.pdcpPdus.empty())
+  {
+    NS_LOG_INFO("Transfer " << transfer.pdcpPdus.size() << " RLC PDUs of teid " << gtpTeid << " to " << m_targetCellId);
+    m_rrc->m_x2SapProvider->TransferRlcBuffer(transfer);
+  }
 }
 
 LteRrcSap::RadioResourceConfigDedicated
@@ -1755,7 +1806,7 @@ UeManager::RecvRrcConnectionSetupCompleted (LteRrcSap::RrcConnectionSetupComplet
       { 
         uint16_t maxSinrCellId = m_rrc->m_bestMmWaveCellForImsiMap[m_imsi];
         // get the SINR
-        double maxSinrDb = 10*std::log10(m_rrc->m_imsiCellSinrMap.find(m_imsi)->second.find(maxSinrCellId)->second);
+        double maxSinrDb = 10*std::log10(m_rrc->m_imsiCellSinrMatrix.Get(m_imsi, maxSinrCellId));
         if(maxSinrDb > m_rrc->m_outageThreshold)
         {
           // there is a MmWave cell to which the UE can connect
@@ -2856,6 +2907,19 @@ else if (option == true){
   }
 
 }
+void
+UeManager::RemoveX2RlcUsers ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::map <uint8_t, Ptr<RlcBearerInfo> >::iterator rlcIt = m_rlcMap.begin ();
+       rlcIt != m_rlcMap.end ();
+       ++rlcIt)
+    {
+      m_rrc->m_x2SapProvider->SetEpcX2RlcUser (rlcIt->second->gtpTeid, 0);
+      m_rrc->m_x2SapProvider->SetEpcX2RlcUser_2 (rlcIt->second->gtpTeid, 0);
+    }
+}
+
 ///////////////////////////////////////////
 // eNB RRC methods
 ///////////////////////////////////////////
@@ -2890,7 +2954,8 @@ LteEnbRrc::LteEnbRrc ()
   m_x2SapUser = new EpcX2SpecificEpcX2SapUser<LteEnbRrc> (this);
   m_s1SapUser = new MemberEpcEnbS1SapUser<LteEnbRrc> (this);
   m_cphySapUser = new MemberLteEnbCphySapUser<LteEnbRrc> (this);
-  m_imsiCellSinrMap.clear();
+  m_imsiCellSinrMatrix.Clear();
+  m_ueCellRanking.clear();
   m_x2_received_cnt = 0;
   m_switchEnabled = true;
   m_lteCellId = 0;
@@ -2912,6 +2977,7 @@ LteEnbRrc::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_ueMap.clear ();
+  m_ueTable.clear ();
   delete m_cmacSapUser;
   delete m_handoverManagementSapUser;
   delete m_anrSapUser;
@@ -3109,6 +3175,30 @@ LteEnbRrc::GetTypeId (void)
         IntegerValue(1600),
         MakeIntegerAccessor(&LteEnbRrc::m_crtPeriod),
         MakeIntegerChecker<int>()) // TODO consider using a TimeValue  
+    .AddAttribute ("PredictiveHandover",
+        "If true, forecast the SINR of the UEs in the mmWave cells and switch "
+        "as soon as the serving cell is forecast in outage, without waiting for the TTT",
+        BooleanValue(false),
+        MakeBooleanAccessor(&LteEnbRrc::m_predictiveHandover),
+        MakeBooleanChecker())
+    .AddAttribute ("PredictionHorizon",
+        "How far ahead the SINR is forecast",
+        TimeValue(MilliSeconds(80)),
+        MakeTimeAccessor(&LteEnbRrc::SetPredictionHorizon,
+                         &LteEnbRrc::GetPredictionHorizon),
+        MakeTimeChecker())
+    .AddAttribute ("SinrHistoryLength",
+        "The number of SINR reports of each UE in each mmWave cell used for the forecast",
+        UintegerValue(16),
+        MakeUintegerAccessor(&LteEnbRrc::SetSinrHistoryLength,
+                             &LteEnbRrc::GetSinrHistoryLength),
+        MakeUintegerChecker<uint32_t>(2))
+    .AddAttribute ("BulkRlcBufferTransfer",
+        "If true, in a secondary cell HO the RLC buffer of each bearer is moved out of "
+        "the source RLC and sent to the target in one X2-U message, instead of one per PDU",
+        BooleanValue(false),
+        MakeBooleanAccessor(&LteEnbRrc::m_bulkRlcBufferTransfer),
+        MakeBooleanChecker())
     // Trace sources
     .AddTraceSource ("NewUeContext",
                      "Fired upon creation of a new UE context.",
@@ -3138,6 +3228,10 @@ LteEnbRrc::GetTypeId (void)
                  "trace fired when measurement report is received from mmWave cells, for each cell, for each UE",
                  MakeTraceSourceAccessor (&LteEnbRrc::m_notifyMmWaveSinrTrace),
                  "ns3::LteEnbRrc::NotifyMmWaveSinrTracedCallback")
+    .AddTraceSource ("PredictedOutage",
+                 "trace fired when an outage forecast is confirmed by the cell the UE left, or expires",
+                 MakeTraceSourceAccessor (&LteEnbRrc::m_predictedOutageTrace),
+                 "ns3::LteEnbRrc::PredictedOutageTracedCallback")
   ;
   return tid;
 }
@@ -3293,8 +3387,7 @@ bool
 LteEnbRrc::HasUeManager (uint16_t rnti) const
 {
   NS_LOG_FUNCTION (this << (uint32_t) rnti);
-  std::map<uint16_t, Ptr<UeManager> >::const_iterator it = m_ueMap.find (rnti);
-  return (it != m_ueMap.end ());
+  return (rnti < m_ueTable.size () && m_ueTable[rnti] != 0);
 }
 
 Ptr<UeManager>
@@ -3302,10 +3395,8 @@ LteEnbRrc::GetUeManager (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << (uint32_t) rnti);
   NS_ASSERT (0 != rnti);
-  std::map<uint16_t, Ptr<UeManager> >::iterator it = m_ueMap.find (rnti);
-
-  NS_ASSERT_MSG (it != m_ueMap.end (), "RNTI " << rnti << " not found in eNB with cellId " << m_cellId);
-  return it->second;
+  NS_ASSERT_MSG (rnti < m_ueTable.size () && m_ueTable[rnti] != 0, "RNTI " << rnti << " not found in eNB with cellId " << m_cellId);
+  return m_ueTable[rnti];
 }
 
 void 
@@ -3328,14 +3419,11 @@ LteEnbRrc::RegisterImsiToRnti(uint64_t imsi, uint16_t rnti)
    //
   }
 
-  if(m_rntiImsiMap.find(rnti) == m_rntiImsiMap.end())
-  {
-    m_rntiImsiMap.insert(std::pair<uint16_t, uint64_t> (rnti, imsi));
-  }
-  else
+  if(rnti >= m_rntiImsiTable.size())
   {
-    m_rntiImsiMap.find(rnti)->second = imsi;
+    m_rntiImsiTable.resize(rnti + 1, 0);
   }
+  m_rntiImsiTable[rnti] = imsi;
 }
 
 uint16_t 
@@ -3354,9 +3442,9 @@ LteEnbRrc::GetRntiFromImsi(uint64_t imsi)
 uint64_t
 LteEnbRrc::GetImsiFromRnti(uint16_t rnti)
 {
-  if(m_rntiImsiMap.find(rnti) != m_rntiImsiMap.end())
+  if(rnti < m_rntiImsiTable.size())
   {
-    return m_rntiImsiMap.find(rnti)->second;
+    return m_rntiImsiTable[rnti];
   }
   else
   {
@@ -3520,7 +3608,8 @@ LteEnbRrc::ConfigureCell (uint8_t ulBandwidth, uint8_t dlBandwidth,
    */
   // mmWave module: Changed scheduling of initial system information to +2ms
   Simulator::Schedule (MilliSeconds (m_firstSibTime), &LteEnbRrc::SendSystemInformation, this);
-  m_imsiCellSinrMap.clear();
+  m_imsiCellSinrMatrix.Clear();
+  m_ueCellRanking.clear();
   m_firstReport = true;
   m_configured = true;
 }
@@ -3605,40 +3694,33 @@ if(params.secondBestCellId ==0)
     uint64_t imsi = imsiIter->first;
     double sinr = imsiIter->second;
 
-
-
     m_notifyMmWaveSinrTrace(imsi, mmWaveCellId, sinr);
+    if(m_predictiveHandover && sinr > 0)
+    {
+      m_sinrPredictor.AddSample(imsi, mmWaveCellId, Simulator::Now(), 10*std::log10(sinr));
+    }
     
     NS_LOG_FUNCTION("Imsi " << imsi << " sinr " << sinr);
+	}
+  m_imsiCellSinrMatrix.UpdateCell(mmWaveCellId, params.ueImsiSinrMap);
+  if(!m_predictedOutages.empty())
+  {
+    CheckPredictedOutages(mmWaveCellId, params.ueImsiSinrMap);
+  }
 
-    if(m_imsiCellSinrMap.find(imsi) != m_imsiCellSinrMap.end())
+  if(g_log.IsEnabled(LOG_LOGIC))
+  {
+    for(uint32_t row = 0; row < m_imsiCellSinrMatrix.GetNUes(); ++row)
     {
-      if(m_imsiCellSinrMap[imsi].find(mmWaveCellId) != m_imsiCellSinrMap[imsi].end())
+      NS_LOG_LOGIC("Imsi " << m_imsiCellSinrMatrix.GetImsi(row));
+      for(uint32_t col = 0; col < m_imsiCellSinrMatrix.GetNCells(); ++col)
       {
-        // update the SINR measure
-        m_imsiCellSinrMap[imsi].find(mmWaveCellId)->second = sinr;
-      }
-      else // new cell for this Imsi
-      {
-        // insert a new SINR measure
-        m_imsiCellSinrMap[imsi].insert(std::pair<uint16_t, double>(mmWaveCellId, sinr));
+        if(m_imsiCellSinrMatrix.IsReported(row, col))
+        {
+          NS_LOG_LOGIC("mmWaveCell " << m_imsiCellSinrMatrix.GetCellId(col) << " sinr " << m_imsiCellSinrMatrix.GetSinr(row, col));
+        }
       }
     }
-    else // new imsi
-    {
-      CellSinrMap map;
-      map.insert(std::pair<uint16_t, double>(mmWaveCellId, sinr));
-      m_imsiCellSinrMap.insert(std::pair<uint64_t, CellSinrMap> (imsi, map));
-    	}
-	}
-  
-	for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
-	{
-    NS_LOG_LOGIC("Imsi " << imsiIter->first);
-    for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
-    {
-      NS_LOG_LOGIC("mmWaveCell " << cellIter->first << " sinr " <<  cellIter->second);
-    }
   }
 
 	if(!m_ismmWave && !m_interRatHoMode && m_firstReport)
@@ -3682,10 +3764,9 @@ else{
 }
 
 void  //73G
-LteEnbRrc::TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::TttBasedHandover_mmWave1(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
  NS_LOG_FUNCTION(this);
-	uint64_t imsi = imsiIter->first;
 
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
@@ -3714,7 +3795,7 @@ LteEnbRrc::TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator im
 
   if(alreadyAssociatedImsi && m_lastMmWaveCell.find(imsi) != m_lastMmWaveCell.end())
   {
-    currentSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[m_lastMmWaveCell[imsi]]);
+    currentSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, m_lastMmWaveCell[imsi]));
     NS_LOG_DEBUG("Current SINR " << currentSinrDb);
   }
   // the UE was in outage, now a mmWave eNB is available. It may be the one to which the UE is already attached or
@@ -3788,7 +3869,7 @@ LteEnbRrc::TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator im
       // check if the cell to which the handover should happen is maxSinrCellId
       if(handoverEvent->second.targetCellId == maxSinrCellId)
       {
-    	  if(currentSinrDb < m_outageThreshold) // we need to handover right now!
+    	  if(currentSinrDb < m_outageThreshold || IsOutagePredicted(imsi, m_lastMmWaveCell[imsi], maxSinrCellId)) // we need to handover right now!
     	  	  {
     		  	  handoverEvent->second.scheduledHandoverEvent.Cancel();
     		  	  handoverNeeded = true;
@@ -3814,7 +3895,7 @@ LteEnbRrc::TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator im
         uint16_t targetCellId = handoverEvent->second.targetCellId;
         NS_LOG_INFO("------ Handover was scheduled for " << handoverEvent->second.targetCellId << " but now maxSinrCellId is " << maxSinrCellId);
         //  get the SINR for the scheduled targetCellId: if the diff is smaller than 3 dB handover anyway
-        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[targetCellId]);
+        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, targetCellId));
        // std::cout << "max sinr is " << maxSinrCellId <<" original target  eNB sinr is "<< originalTargetSinrDb << std::endl;
       //  std::cout << maxSinrDb - originalTargetSinrDb<<"\t"<<"db" << std::endl;
         if(maxSinrDb - originalTargetSinrDb > m_sinrThresholdDifference) // this parameter is the same as the one for ThresholdBasedSecondaryCellHandover
@@ -3893,6 +3974,12 @@ LteEnbRrc::TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator im
       millisecondsToHandover = 0;
       NS_LOG_INFO("Current Cell is in outage, handover immediately");
     }
+    else if(IsOutagePredicted(imsi, m_lastMmWaveCell[imsi], maxSinrCellId))
+    {
+      millisecondsToHandover = 0;
+      RecordPredictedOutage(imsi, m_lastMmWaveCell[imsi], maxSinrCellId);
+      NS_LOG_INFO("Current Cell is forecast in outage, handover immediately");
+    }
     // schedule the event
   //  if (sinrDifference > 15)
    //  GetUeManager(GetRntiFromImsi(imsi))->SetDuplicationMode(true);//sjkang0714
@@ -3917,10 +4004,9 @@ LteEnbRrc::TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator im
   }
 }
 void //28G
-LteEnbRrc::TttBasedHandover_mmWave2(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::TttBasedHandover_mmWave2(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
  NS_LOG_FUNCTION(this);
-	uint64_t imsi = imsiIter->first;
 
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
@@ -3949,7 +4035,7 @@ LteEnbRrc::TttBasedHandover_mmWave2(std::map<uint64_t, CellSinrMap>::iterator im
 
   if(alreadyAssociatedImsi && m_lastMmWaveCell_2.find(imsi) != m_lastMmWaveCell_2.end())
   {
-    currentSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[m_lastMmWaveCell_2[imsi]]);
+    currentSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, m_lastMmWaveCell_2[imsi]));
     NS_LOG_DEBUG("Current SINR " << currentSinrDb);
   }
   // the UE was in outage, now a mmWave eNB is available. It may be the one to which the UE is already attached or
@@ -4023,7 +4109,7 @@ LteEnbRrc::TttBasedHandover_mmWave2(std::map<uint64_t, CellSinrMap>::iterator im
       // check if the cell to which the handover should happen is maxSinrCellId
       if(handoverEvent->second.targetCellId == maxSinrCellId)
       {
-    	  if(currentSinrDb < m_outageThreshold) // we need to handover right now!
+    	  if(currentSinrDb < m_outageThreshold || IsOutagePredicted(imsi, m_lastMmWaveCell_2[imsi], maxSinrCellId)) // we need to handover right now!
     	  	  {
     		  	  handoverEvent->second.scheduledHandoverEvent.Cancel();
     		  	  handoverNeeded = true;
@@ -4049,7 +4135,7 @@ LteEnbRrc::TttBasedHandover_mmWave2(std::map<uint64_t, CellSinrMap>::iterator im
         uint16_t targetCellId = handoverEvent->second.targetCellId;
         NS_LOG_INFO("------ Handover was scheduled for " << handoverEvent->second.targetCellId << " but now maxSinrCellId is " << maxSinrCellId);
         //  get the SINR for the scheduled targetCellId: if the diff is smaller than 3 dB handover anyway
-        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[targetCellId]);
+        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, targetCellId));
            if(maxSinrDb - originalTargetSinrDb > m_sinrThresholdDifference) // this parameter is the same as the one for ThresholdBasedSecondaryCellHandover
         {
           // delete this event
@@ -4127,6 +4213,12 @@ LteEnbRrc::TttBasedHandover_mmWave2(std::map<uint64_t, CellSinrMap>::iterator im
       millisecondsToHandover = 0;
       NS_LOG_INFO("Current Cell is in outage, handover immediately");
     }
+    else if(IsOutagePredicted(imsi, m_lastMmWaveCell_2[imsi], maxSinrCellId))
+    {
+      millisecondsToHandover = 0;
+      RecordPredictedOutage(imsi, m_lastMmWaveCell_2[imsi], maxSinrCellId);
+      NS_LOG_INFO("Current Cell is forecast in outage, handover immediately");
+    }
     // schedule the event
    //   if (sinrDifference > 15)
     //	  GetUeManager(GetRntiFromImsi(imsi))->SetDuplicationMode(true);//sjkang0714
@@ -4290,10 +4382,9 @@ LteEnbRrc::DoRecvBufferDuplicationMessage(EpcX2Sap::SendBufferDuplicationMessage
 
 }
 void 
-LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::ThresholdBasedSecondaryCellHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
   NS_LOG_FUNCTION(this);
-	uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -4313,11 +4404,21 @@ LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::
   }
   NS_LOG_INFO("ThresholdBasedSecondaryCellHandover: alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
+  // a forecast outage of the current cell overrides the SINR hysteresis
+  bool outagePredicted = alreadyAssociatedImsi && !onHandoverImsi && !m_imsiUsingLte[imsi]
+    && sinrDifference <= m_sinrThresholdDifference
+    && IsOutagePredicted(imsi, m_lastMmWaveCell[imsi], maxSinrCellId);
+
   if(maxSinrCellId == m_bestMmWaveCellForImsiMap[imsi] && !m_imsiUsingLte[imsi])
   {
-    if (alreadyAssociatedImsi && !onHandoverImsi && m_lastMmWaveCell[imsi] != maxSinrCellId && sinrDifference > m_sinrThresholdDifference) // not on LTE, handover between MmWave cells
+    if (alreadyAssociatedImsi && !onHandoverImsi && m_lastMmWaveCell[imsi] != maxSinrCellId
+        && (sinrDifference > m_sinrThresholdDifference || outagePredicted)) // not on LTE, handover between MmWave cells
     // this may happen when channel changes while there is an handover
     {
+      if(outagePredicted)
+      {
+        RecordPredictedOutage(imsi, m_lastMmWaveCell[imsi], maxSinrCellId);
+      }
       NS_LOG_INFO("----- handover from " << m_lastMmWaveCell[imsi] << " to " << maxSinrCellId << " channel changed previously at time " << Simulator::Now().GetSeconds());
 
       // The new secondary cell HO procedure does not require to switch to LTE
@@ -4374,9 +4475,14 @@ LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::
 
       m_mmWaveCellSetupCompleted[imsi] = false;
     }
-    else if (alreadyAssociatedImsi && !onHandoverImsi && m_lastMmWaveCell[imsi] != maxSinrCellId && sinrDifference > m_sinrThresholdDifference) 
+    else if (alreadyAssociatedImsi && !onHandoverImsi && m_lastMmWaveCell[imsi] != maxSinrCellId
+             && (sinrDifference > m_sinrThresholdDifference || outagePredicted))
     // not on LTE, handover between MmWave cells
     {
+      if(outagePredicted)
+      {
+        RecordPredictedOutage(imsi, m_lastMmWaveCell[imsi], maxSinrCellId);
+      }
       // The new secondary cell HO procedure does not require to switch to LTE
       NS_LOG_INFO("----- handover from " << m_lastMmWaveCell[imsi] << " to " << maxSinrCellId << " at time " << Simulator::Now().GetSeconds());
       //Ptr<UeManager> ueMan = GetUeManager(GetRntiFromImsi(imsi));
@@ -4407,17 +4513,28 @@ LteEnbRrc::TriggerUeAssociationUpdate()
 
 {
 	NS_LOG_FUNCTION(this);
-  if(m_imsiCellSinrMap.size() > 0) // there are some entries
+  uint32_t nUes = m_imsiCellSinrMatrix.GetNUes();
+  if(m_ueCellRanking.size() != nUes)
+  {
+    // new UEs shifted the rows of the matrix, rank all the cells again
+    UeCellRanking ranking;
+    ranking.valid = false;
+    ranking.changed = true;
+    m_ueCellRanking.assign(nUes, ranking);
+  }
+  if(nUes > 0) // there are some entries
   {
-    for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+    for(uint32_t row = 0; row < nUes; ++row)
     {
-      uint64_t imsi = imsiIter->first;
-      long double maxSinr = 0;
-      long double secondMaxSinr=-31.0;//sjkang
-      long double currentSinr = 0;
-     long double currentSinr_2 =0;
-      uint16_t maxSinrCellId = 0;
-      uint16_t secondMaxSinrCellId=0;
+      uint64_t imsi = m_imsiCellSinrMatrix.GetImsi(row);
+      UeCellRanking &ranking = m_ueCellRanking[row];
+      UpdateUeCellRanking(row, ranking);
+      long double maxSinr = ranking.maxSinr;
+      long double secondMaxSinr = ranking.secondMaxSinr;//sjkang
+      long double currentSinr = m_imsiCellSinrMatrix.Get(imsi, m_lastMmWaveCell[imsi]);
+      long double currentSinr_2 = m_imsiCellSinrMatrix.Get(imsi, m_lastMmWaveCell_2[imsi]); //28G
+      uint16_t maxSinrCellId = ranking.maxSinrCellId;
+      uint16_t secondMaxSinrCellId = ranking.secondMaxSinrCellId;
       bool alreadyAssociatedImsi = false;
       bool onHandoverImsi = true;
       Ptr<UeManager> ueMan;
@@ -4439,34 +4556,6 @@ LteEnbRrc::TriggerUeAssociationUpdate()
       }
       NS_LOG_INFO("alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
-      for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
-      {
-        NS_LOG_INFO("Cell " << cellIter->first << " reports " << 10*std::log10(cellIter->second));
-        /// find a MmWave Cell ID among the cells we need to connect firstly
-
-        if(cellIter->second > maxSinr && EnbType[cellIter->first] )
-        {
-
-        	maxSinr = cellIter->second;
-          maxSinrCellId = cellIter->first; //sjkang1221/?
-
-           } /// find a MmWave Cell ID among the cells we need to connect secondly
-        if (!EnbType[cellIter->first] && cellIter->second > secondMaxSinr) //sjkang
-
-        {
-        	secondMaxSinr = cellIter->second;
-        	secondMaxSinrCellId=cellIter->first;
-         }
-       if(m_lastMmWaveCell[imsi] == cellIter->first) //sjkang0709
-       {
-    	   currentSinr = cellIter->second;
-       }
-
-        if(m_lastMmWaveCell_2[imsi] == cellIter->first) //sjkang0709
-        {
-       currentSinr_2 = cellIter->second; //28G
-        }
-      }
       //long double sinrDifference = std::abs(10*(std::log10((long double)maxSinr) - std::log10((long double)currentSinr)));
       long double sinrDifference = std::abs(10*(std::log10((long double)maxSinr) - std::log10((long double)currentSinr)));
      long double sinrDifference_2 = std::abs(10*(std::log10((long double)secondMaxSinr) - std::log10((long double)currentSinr_2)));
@@ -4478,7 +4567,16 @@ LteEnbRrc::TriggerUeAssociationUpdate()
           " current cell " << m_lastMmWaveCell[imsi] << " currentSinr " << currentSinrDb << " sinrDifference " << sinrDifference);
  //     std::cout << maxSinrCellId<<"\t"<<maxSinrDb << "\t"<<secondMaxSinrCellId<<"\t"<<secondMaxSinrDb <<std::endl;
 
-      if ((maxSinrDb < m_outageThreshold || (m_imsiUsingLte[imsi] && maxSinrDb < m_outageThreshold + 2)) && alreadyAssociatedImsi) // no MmWaveCell can serve this UE
+      if((m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
+         && !ranking.changed && IsUeAssociationStable(imsi, ranking, maxSinrDb))
+      {
+        NS_LOG_LOGIC("Imsi " << imsi << " served by its best cells, skip");
+        continue;
+      }
+
+      bool outagePredicted = alreadyAssociatedImsi && maxSinrDb >= m_outageThreshold && IsUeOutagePredicted(row);
+      if ((maxSinrDb < m_outageThreshold || (m_imsiUsingLte[imsi] && maxSinrDb < m_outageThreshold + 2) || outagePredicted)
+          && alreadyAssociatedImsi) // no MmWaveCell can serve this UE
       { //sjkang_handover event occurs , it is the case of outage event of mmWave
         // outage, perform fast switching if MC device or hard handover
         NS_LOG_UNCOND("----- Warn: outage detected ------ at time " << Simulator::Now().GetSeconds());
@@ -4486,6 +4584,10 @@ LteEnbRrc::TriggerUeAssociationUpdate()
         {
           ueMan = GetUeManager(GetRntiFromImsi(imsi));
           NS_LOG_UNCOND("Switch to LTE stack");
+          if(outagePredicted)
+          {
+            RecordPredictedOutage(imsi, m_lastMmWaveCell[imsi], m_cellId);
+          }
           bool useMmWaveConnection = false; 
           m_imsiUsingLte[imsi] = !useMmWaveConnection;
           ueMan->SendRrcConnectionSwitch(useMmWaveConnection);
@@ -4522,7 +4624,7 @@ LteEnbRrc::TriggerUeAssociationUpdate()
       {
         if(m_handoverMode == THRESHOLD)
         {
-          ThresholdBasedSecondaryCellHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);  
+          ThresholdBasedSecondaryCellHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);  
         }
         else if(m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
         {
@@ -4597,11 +4699,11 @@ LteEnbRrc::TriggerUeAssociationUpdate()
         		        		GetUeManager(GetRntiFromImsi(imsi))->changePathAtPdcp(maxSinrCellId, secondMaxSinrCellId);
         	}
 */
-          //TttBasedHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          //TttBasedHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
 
 
-          TttBasedHandover_mmWave2(imsiIter, sinrDifference_2, secondMaxSinrCellId, secondMaxSinrDb);
-         TttBasedHandover_mmWave1(imsiIter,sinrDifference, maxSinrCellId, maxSinrDb);
+          TttBasedHandover_mmWave2(imsi, sinrDifference_2, secondMaxSinrCellId, secondMaxSinrDb);
+         TttBasedHandover_mmWave1(imsi,sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else
         {
@@ -4614,12 +4716,229 @@ LteEnbRrc::TriggerUeAssociationUpdate()
   Simulator::Schedule(MicroSeconds(m_crtPeriod), &LteEnbRrc::TriggerUeAssociationUpdate, this);
 }
 
+void
+LteEnbRrc::UpdateUeCellRanking(uint32_t row, UeCellRanking &ranking)
+{
+  if(ranking.valid && !m_imsiCellSinrMatrix.IsUpdated(row))
+  {
+    ranking.changed = false;
+    return;
+  }
+  UeCellRanking newRanking;
+  newRanking.maxSinr = 0;
+  newRanking.maxSinrCellId = 0;
+  newRanking.secondMaxSinr = -31.0; //sjkang
+  newRanking.secondMaxSinrCellId = 0;
+  for(uint32_t col = 0; col < m_imsiCellSinrMatrix.GetNCells(); ++col)
+  {
+    if(!m_imsiCellSinrMatrix.IsReported(row, col))
+    {
+      continue;
+    }
+    uint16_t cellId = m_imsiCellSinrMatrix.GetCellId(col);
+    double sinr = m_imsiCellSinrMatrix.GetSinr(row, col);
+    NS_LOG_INFO("Cell " << cellId << " reports " << 10*std::log10(sinr));
+    /// find a MmWave Cell ID among the cells we need to connect firstly
+    if(EnbType[cellId] && sinr > newRanking.maxSinr)
+    {
+      newRanking.maxSinr = sinr;
+      newRanking.maxSinrCellId = cellId;
+    }
+    /// find a MmWave Cell ID among the cells we need to connect secondly
+    if(!EnbType[cellId] && sinr > newRanking.secondMaxSinr)
+    {
+      newRanking.secondMaxSinr = sinr;
+      newRanking.secondMaxSinrCellId = cellId;
+    }
+  }
+  newRanking.valid = true;
+  newRanking.changed = !ranking.valid || newRanking.maxSinrCellId != ranking.maxSinrCellId
+    || newRanking.secondMaxSinrCellId != ranking.secondMaxSinrCellId;
+  ranking = newRanking;
+  m_imsiCellSinrMatrix.ClearUpdated(row);
+}
+
+bool
+LteEnbRrc::IsUeAssociationStable(uint64_t imsi, const UeCellRanking &ranking, double maxSinrDb)
+{
+  std::map<uint64_t, bool>::const_iterator setupIt = m_mmWaveCellSetupCompleted.find(imsi);
+  if(setupIt == m_mmWaveCellSetupCompleted.end() || !setupIt->second)
+  {
+    // not associated yet or on handover
+    return false;
+  }
+  std::map<uint64_t, bool>::const_iterator lteIt = m_imsiUsingLte.find(imsi);
+  if((lteIt != m_imsiUsingLte.end() && lteIt->second) || maxSinrDb < m_outageThreshold)
+  {
+    return false;
+  }
+  if(m_imsiHandoverEventsMap.find(imsi) != m_imsiHandoverEventsMap.end()
+     || m_imsiHandoverEventsMap_2.find(imsi) != m_imsiHandoverEventsMap_2.end())
+  {
+    return false;
+  }
+  std::map<uint64_t, uint16_t>::const_iterator it;
+  it = m_lastMmWaveCell.find(imsi);
+  if(it == m_lastMmWaveCell.end() || it->second != ranking.maxSinrCellId)
+  {
+    return false;
+  }
+  it = m_lastMmWaveCell_2.find(imsi);
+  if(it == m_lastMmWaveCell_2.end() || it->second != ranking.secondMaxSinrCellId)
+  {
+    return false;
+  }
+  it = m_bestMmWaveCellForImsiMap.find(imsi);
+  if(it == m_bestMmWaveCellForImsiMap.end() || it->second != ranking.maxSinrCellId)
+  {
+    return false;
+  }
+  it = m_secondMmWaveCellForImsiMap.find(imsi);
+  return it != m_secondMmWaveCellForImsiMap.end() && it->second == ranking.secondMaxSinrCellId;
+}
+
+bool
+LteEnbRrc::IsOutagePredicted(uint64_t imsi, uint16_t servingCellId, uint16_t targetCellId)
+{
+  if(!m_predictiveHandover || servingCellId == targetCellId)
+  {
+    return false;
+  }
+  Time forecastTime = Simulator::Now() + m_predictionHorizon;
+  double servingSinrDb;
+  if(!m_sinrPredictor.Predict(imsi, servingCellId, forecastTime, servingSinrDb)
+     || servingSinrDb >= m_outageThreshold)
+  {
+    return false;
+  }
+  // the target must be usable now and at the end of the horizon
+  double targetSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, targetCellId));
+  double forecastSinrDb;
+  if(m_sinrPredictor.Predict(imsi, targetCellId, forecastTime, forecastSinrDb))
+  {
+    targetSinrDb = std::min(targetSinrDb, forecastSinrDb);
+  }
+  NS_LOG_INFO("Imsi " << imsi << " cell " << servingCellId << " forecast at " << servingSinrDb
+    << " dB, cell " << targetCellId << " at " << targetSinrDb << " dB");
+  return targetSinrDb >= m_outageThreshold;
+}
+
+bool
+LteEnbRrc::IsUeOutagePredicted(uint32_t row)
+{
+  if(!m_predictiveHandover)
+  {
+    return false;
+  }
+  uint64_t imsi = m_imsiCellSinrMatrix.GetImsi(row);
+  Time forecastTime = Simulator::Now() + m_predictionHorizon;
+  bool anyForecast = false;
+  for(uint32_t col = 0; col < m_imsiCellSinrMatrix.GetNCells(); ++col)
+  {
+    if(!m_imsiCellSinrMatrix.IsReported(row, col))
+    {
+      continue;
+    }
+    double sinrDb;
+    if(m_sinrPredictor.Predict(imsi, m_imsiCellSinrMatrix.GetCellId(col), forecastTime, sinrDb))
+    {
+      anyForecast = true;
+    }
+    else
+    {
+      sinrDb = 10*std::log10(m_imsiCellSinrMatrix.GetSinr(row, col));
+    }
+    if(sinrDb >= m_outageThreshold)
+    {
+      return false;
+    }
+  }
+  return anyForecast;
+}
+
+void
+LteEnbRrc::RecordPredictedOutage(uint64_t imsi, uint16_t servingCellId, uint16_t targetCellId)
+{
+  NS_LOG_INFO("Imsi " << imsi << " forecast in outage in cell " << servingCellId << ", switch to "
+    << targetCellId << " at time " << Simulator::Now().GetSeconds());
+  PredictedOutageInfo info;
+  info.targetCellId = targetCellId;
+  info.switchTime = Simulator::Now();
+  // keep the earliest switch if the forecast is repeated
+  m_predictedOutages.insert(std::make_pair(std::make_pair(imsi, servingCellId), info));
+}
+
+void
+LteEnbRrc::CheckPredictedOutages(uint16_t cellId, const ImsiSinrMap &imsiSinrMap)
+{
+  PredictedOutageMap::iterator outage = m_predictedOutages.begin();
+  while(outage != m_predictedOutages.end())
+  {
+    // the reactive policies detect the outage only with this report, so the
+    // lead time is the outage time saved, up to the duration of the switch
+    Time leadTime = Simulator::Now() - outage->second.switchTime;
+    ImsiSinrMap::const_iterator report = imsiSinrMap.end();
+    if(outage->first.second == cellId)
+    {
+      report = imsiSinrMap.find(outage->first.first);
+    }
+    if(report != imsiSinrMap.end() && 10*std::log10(report->second) < m_outageThreshold)
+    {
+      NS_LOG_INFO("Imsi " << report->first << " in outage in cell " << cellId << ", switched "
+        << leadTime.GetSeconds() << " s in advance");
+      m_predictedOutageTrace(report->first, cellId, outage->second.targetCellId, true, leadTime);
+      m_predictedOutages.erase(outage++);
+    }
+    else if(report != imsiSinrMap.end() && leadTime > m_predictionHorizon + m_predictionHorizon)
+    {
+      NS_LOG_INFO("Imsi " << report->first << " not in outage in cell " << cellId << ", false forecast");
+      m_predictedOutageTrace(report->first, cellId, outage->second.targetCellId, false, leadTime);
+      m_predictedOutages.erase(outage++);
+    }
+    else if(leadTime > 4*m_predictionHorizon)
+    {
+      // the cell stopped reporting the UE, the forecast cannot be checked
+      NS_LOG_INFO("Imsi " << outage->first.first << " no longer reported by cell " << outage->first.second);
+      m_predictedOutages.erase(outage++);
+    }
+    else
+    {
+      ++outage;
+    }
+  }
+}
+
+void
+LteEnbRrc::SetSinrHistoryLength(uint32_t length)
+{
+  m_sinrPredictor.SetHistoryLength(length);
+}
+
+uint32_t
+LteEnbRrc::GetSinrHistoryLength() const
+{
+  return m_sinrPredictor.GetHistoryLength();
+}
+
+void
+LteEnbRrc::SetPredictionHorizon(Time horizon)
+{
+  m_predictionHorizon = horizon;
+  // the forecast is at now + horizon, use the samples of the last horizon
+  m_sinrPredictor.SetMaxSampleAge(horizon + horizon);
+}
+
+Time
+LteEnbRrc::GetPredictionHorizon() const
+{
+  return m_predictionHorizon;
+}
+
 
 void 
-LteEnbRrc::ThresholdBasedInterRatHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::ThresholdBasedInterRatHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
  NS_LOG_FUNCTION(this);
-	uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -4703,11 +5022,11 @@ void
 LteEnbRrc::UpdateUeHandoverAssociation()
 {
   // TODO rules for possible ho of each UE
-  if(m_imsiCellSinrMap.size() > 0) // there are some entries
+  if(m_imsiCellSinrMatrix.GetNUes() > 0) // there are some entries
   {
-    for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+    for(uint32_t row = 0; row < m_imsiCellSinrMatrix.GetNUes(); ++row)
     {
-      uint64_t imsi = imsiIter->first;
+      uint64_t imsi = m_imsiCellSinrMatrix.GetImsi(row);
       long double maxSinr = 0;
       long double currentSinr = 0;
       uint16_t maxSinrCellId = 0;
@@ -4730,17 +5049,23 @@ LteEnbRrc::UpdateUeHandoverAssociation()
       }
       NS_LOG_INFO("alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
-      for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
+      for(uint32_t col = 0; col < m_imsiCellSinrMatrix.GetNCells(); ++col)
       {
-        NS_LOG_INFO("Cell " << cellIter->first << " reports " << 10*std::log10(cellIter->second));
-        if(cellIter->second > maxSinr)
+        if(!m_imsiCellSinrMatrix.IsReported(row, col))
         {
-          maxSinr = cellIter->second;
-          maxSinrCellId = cellIter->first;
+          continue;
         }
-        if(m_lastMmWaveCell[imsi] == cellIter->first)
+        uint16_t cellId = m_imsiCellSinrMatrix.GetCellId(col);
+        double sinr = m_imsiCellSinrMatrix.GetSinr(row, col);
+        NS_LOG_INFO("Cell " << cellId << " reports " << 10*std::log10(sinr));
+        if(sinr > maxSinr)
         {
-          currentSinr = cellIter->second;
+          maxSinr = sinr;
+          maxSinrCellId = cellId;
+        }
+        if(m_lastMmWaveCell[imsi] == cellId)
+        {
+          currentSinr = sinr;
         }
       }
 
@@ -4794,12 +5119,12 @@ LteEnbRrc::UpdateUeHandoverAssociation()
       {
         if(m_handoverMode == THRESHOLD)
         {
-          ThresholdBasedInterRatHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);  
+          ThresholdBasedInterRatHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);  
         }
         else if(m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
         {
           m_bestMmWaveCellForImsiMap[imsi] = maxSinrCellId;
-         TttBasedHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+         TttBasedHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else
         {
@@ -5474,7 +5799,7 @@ LteEnbRrc::AddUe (UeManager::State state)
        (rnti != m_lastAllocatedRnti - 1) && (!found);
        ++rnti)
     {
-      if ((rnti != 0) && (m_ueMap.find (rnti) == m_ueMap.end ()))
+      if ((rnti != 0) && !HasUeManager (rnti))
         {
           found = true;
           break;
@@ -5486,6 +5811,11 @@ LteEnbRrc::AddUe (UeManager::State state)
 //  std::cout << this << " AddUe  " <<"sjkang1114 " <<std::endl;
   Ptr<UeManager> ueManager = CreateObject<UeManager> (this, rnti, state); 
   m_ueMap.insert (std::pair<uint16_t, Ptr<UeManager> > (rnti, ueManager));
+  if (rnti >= m_ueTable.size ())
+    {
+      m_ueTable.resize (rnti + 1);
+    }
+  m_ueTable[rnti] = ueManager;
   ueManager->Initialize ();
   NS_LOG_DEBUG (this << " New UE RNTI " << rnti << " cellId " << m_cellId << " srs CI " << ueManager->GetSrsConfigurationIndex ());
   m_newUeContextTrace (m_cellId, rnti);
@@ -5500,9 +5830,18 @@ LteEnbRrc::RemoveUe (uint16_t rnti)
   std::map <uint16_t, Ptr<UeManager> >::iterator it = m_ueMap.find (rnti);
   NS_ASSERT_MSG (it != m_ueMap.end (), "request to remove UE info with unknown rnti " << rnti);
   uint16_t srsCi = (*it).second->GetSrsConfigurationIndex ();
+  uint64_t imsi = it->second->GetImsi ();
   bool isMc = it->second->GetIsMc();
   bool isMc_2 = it->second->GetIsMc_2();
+  it->second->RemoveX2RlcUsers ();
   m_ueMap.erase (it);
+  m_ueTable[rnti] = 0;
+  m_sinrPredictor.RemoveUe (imsi);
+  PredictedOutageMap::iterator outage = m_predictedOutages.lower_bound (std::make_pair (imsi, (uint16_t) 0));
+  while (outage != m_predictedOutages.end () && outage->first.first == imsi)
+    {
+      m_predictedOutages.erase (outage++);
+    }
   m_cmacSapProvider->RemoveUe (rnti);
   m_cphySapProvider->RemoveUe (rnti);
   if (m_s1SapProvider != 0 && !isMc && !isMc_2)
@@ -5762,10 +6101,9 @@ LteEnbRrc::GetX2(){ //sjkang1114
 	return m_x2;
 }
 void
-LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::TttBasedHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
  NS_LOG_FUNCTION(this);
-	uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -5793,7 +6131,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
 
   if(alreadyAssociatedImsi && m_lastMmWaveCell.find(imsi) != m_lastMmWaveCell.end())
   {
-    currentSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[m_lastMmWaveCell[imsi]]);
+    currentSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, m_lastMmWaveCell[imsi]));
     NS_LOG_DEBUG("Current SINR " << currentSinrDb);
   }
   // the UE was in outage, now a mmWave eNB is available. It may be the one to which the UE is already attached or
@@ -5867,7 +6205,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
       // check if the cell to which the handover should happen is maxSinrCellId
       if(handoverEvent->second.targetCellId == maxSinrCellId)
       {
-    	  if(currentSinrDb < m_outageThreshold) // we need to handover right now!
+    	  if(currentSinrDb < m_outageThreshold || IsOutagePredicted(imsi, m_lastMmWaveCell[imsi], maxSinrCellId)) // we need to handover right now!
     	  	  {
     		  	  handoverEvent->second.scheduledHandoverEvent.Cancel();
     		  	  handoverNeeded = true;
@@ -5893,7 +6231,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
         uint16_t targetCellId = handoverEvent->second.targetCellId;
         NS_LOG_INFO("------ Handover was scheduled for " << handoverEvent->second.targetCellId << " but now maxSinrCellId is " << maxSinrCellId);
         //  get the SINR for the scheduled targetCellId: if the diff is smaller than 3 dB handover anyway
-        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[targetCellId]);
+        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMatrix.Get(imsi, targetCellId));
        // std::cout << "max sinr is " << maxSinrCellId <<" original target  eNB sinr is "<< originalTargetSinrDb << std::endl;
 
         if(maxSinrDb - originalTargetSinrDb > m_sinrThresholdDifference) // this parameter is the same as the one for ThresholdBasedSecondaryCellHandover
@@ -5967,6 +6305,12 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
       millisecondsToHandover = 0;
       NS_LOG_INFO("Current Cell is in outage, handover immediately");
     }
+    else if(IsOutagePredicted(imsi, m_lastMmWaveCell[imsi], maxSinrCellId))
+    {
+      millisecondsToHandover = 0;
+      RecordPredictedOutage(imsi, m_lastMmWaveCell[imsi], maxSinrCellId);
+      NS_LOG_INFO("Current Cell is forecast in outage, handover immediately");
+    }
     // schedule the event
 		EventId scheduledHandoverEvent = Simulator::Schedule(MilliSeconds(millisecondsToHandover), &LteEnbRrc::PerformHandover, this, imsi, 0);
     LteEnbRrc::HandoverEventInfo handoverInfo;
@@ -47,6 +47,8 @@
 #include <ns3/lte-rlc.h>
 #include <ns3/lte-pdcp.h>
 #include <ns3/lte-rlc-am.h>
+#include <ns3/cell-sinr-matrix.h>
+#include <ns3/sinr-trajectory-predictor.h>
 
 #include <map>
 #include <set>
@@ -401,6 +403,12 @@ public:
   void waitForReceivingSecondRnti(std::map <uint8_t, Ptr<LteDataRadioBearerInfo> >::iterator it); //sjkang
   void SetDuplicationMode(bool); //sjkang
   void SetRlcBufferForwardMode(uint16_t targetCellID,bool option); //sjkang
+
+  /**
+   * Detach the secondary cell RLC entities from X2-U before the UE context
+   * is removed, so that data still in flight for them is dropped
+   */
+  void RemoveX2RlcUsers ();
 //  void UeContextRelease(EpcX2SapProvider::UeContextReleaseParams); //sjkang
 private:
   //Lossless HO: merge 2 buffers into 1 with increment order.
@@ -1045,6 +1053,18 @@ uint16_t GetRntifromCellIDAndImsi[60][60];
   typedef void (* NotifyMmWaveSinrTracedCallback)
     (uint64_t imsi, uint16_t cellId, long double sinr);
 
+  /**
+   * TracedCallback signature for the outcome of an outage forecast.
+   *
+   * \param [in] imsi
+   * \param [in] cellId The cell forecast in outage.
+   * \param [in] targetCellId The cell the UE was moved to in advance.
+   * \param [in] confirmed True if the cell then reported the UE in outage.
+   * \param [in] leadTime The time between the switch and the outage report.
+   */
+  typedef void (* PredictedOutageTracedCallback)
+    (uint64_t imsi, uint16_t cellId, uint16_t targetCellId, bool confirmed, Time leadTime);
+
   /**
    * Different secondary cell handover modes
    */
@@ -1284,25 +1304,109 @@ private:
    */
   void TriggerUeAssociationUpdate();
 
+  /**
+   * Best cells of a UE, computed from its row of m_imsiCellSinrMatrix
+   */
+  struct UeCellRanking
+  {
+    long double maxSinr;           ///< SINR of the best first mmWave layer cell
+    uint16_t maxSinrCellId;        ///< best first mmWave layer cell
+    long double secondMaxSinr;     ///< SINR of the best second mmWave layer cell
+    uint16_t secondMaxSinrCellId;  ///< best second mmWave layer cell
+    bool valid;                    ///< false if the ranking must be computed from scratch
+    bool changed;                  ///< true if a best cell changed at the last update
+  };
+
+  /**
+   * Rank the cells that reported the UE in a row of m_imsiCellSinrMatrix.
+   * The ranking is computed again only if the row has new values.
+   * @params the row
+   * @params the ranking
+   */
+  void UpdateUeCellRanking(uint32_t row, UeCellRanking &ranking);
+
+  /**
+   * @params the imsi of the UE
+   * @params the ranking of the cells for this UE
+   * @params the SINR of the best cell, in dB
+   * @return true if the UE is served by its best cells of both layers, is not
+   * in outage and has no pending handover, so that evaluating its
+   * association would not change anything
+   */
+  bool IsUeAssociationStable(uint64_t imsi, const UeCellRanking &ranking, double maxSinrDb);
+
+  /**
+   * @params the imsi of the UE
+   * @params the mmWave cell serving the UE
+   * @params the candidate target cell
+   * @return true if PredictiveHandover is enabled, the SINR of the serving
+   * cell is forecast below m_outageThreshold at the end of the prediction
+   * horizon and the target cell stays above it
+   */
+  bool IsOutagePredicted(uint64_t imsi, uint16_t servingCellId, uint16_t targetCellId);
+
+  /**
+   * @params the row of the UE in m_imsiCellSinrMatrix
+   * @return true if PredictiveHandover is enabled and all the mmWave cells
+   * that reported the UE are forecast below m_outageThreshold
+   */
+  bool IsUeOutagePredicted(uint32_t row);
+
+  /**
+   * Remember that the UE left a cell because of a forecast, to compare the
+   * switch time with the time the cell reports the UE in outage
+   * @params the imsi of the UE
+   * @params the cell forecast in outage
+   * @params the cell the UE is moved to
+   */
+  void RecordPredictedOutage(uint64_t imsi, uint16_t servingCellId, uint16_t targetCellId);
+
+  /**
+   * Check the pending forecasts of a cell against its new SINR report, and
+   * drop the expired forecasts of the UEs no longer reported
+   * @params the reporting cell
+   * @params the linear SINR of each IMSI in the cell
+   */
+  void CheckPredictedOutages(uint16_t cellId, const ImsiSinrMap &imsiSinrMap);
+
+  /**
+   * @params the number of SINR samples kept for each UE and mmWave cell
+   */
+  void SetSinrHistoryLength(uint32_t length);
+  /**
+   * @return the number of SINR samples kept for each UE and mmWave cell
+   */
+  uint32_t GetSinrHistoryLength() const;
+
+  /**
+   * @params how far ahead the SINR is forecast, which also limits the age
+   *         of the samples used for the forecast
+   */
+  void SetPredictionHorizon(Time horizon);
+  /**
+   * @return how far ahead the SINR is forecast
+   */
+  Time GetPredictionHorizon() const;
+
   /**
    * Trigger an handover according to certain conditions on the SINR
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the imsi of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void ThresholdBasedSecondaryCellHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
     /**
    * Trigger an handover according to certain conditions on the SINR and the TTT
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the imsi of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void TttBasedHandover_mmWave1(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb); //sjkang
-  void TttBasedHandover_mmWave2(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb); //sjkang
-  void TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void TttBasedHandover_mmWave1(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb); //sjkang
+  void TttBasedHandover_mmWave2(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb); //sjkang
+  void TttBasedHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
   /**
    * Compute the TTT according to the sinrDifference and the dynamic handover algorithm
@@ -1323,12 +1427,12 @@ private:
 
   /**
    * Trigger an handover according to certain conditions on the SINR (for single-connectivity devices)
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the imsi of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */  
-  void ThresholdBasedInterRatHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void ThresholdBasedInterRatHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
   
   Callback <void, Ptr<Packet> > m_forwardUpCallback;
   //uint32_t StartHandover; //sjkang
@@ -1403,6 +1507,11 @@ private:
    * The `UeMap` attribute. List of UeManager by C-RNTI.
    */
   std::map<uint16_t, Ptr<UeManager> > m_ueMap;
+  /**
+   * UeManager by C-RNTI, for constant time lookup (RNTIs are allocated
+   * sequentially). m_ueMap is kept for the `UeMap` attribute.
+   */
+  std::vector<Ptr<UeManager> > m_ueTable;
 
   //std::map<uint16_t, EpcX2SapUser::HandoverRequestParams> m_requestMap;
   /**
@@ -1546,6 +1655,11 @@ private:
   TracedCallback<uint64_t, uint16_t, uint16_t, LteRrcSap::MeasurementReport> m_recvMeasurementReportTrace;
 
   TracedCallback<uint64_t, uint16_t, long double> m_notifyMmWaveSinrTrace;
+  /**
+   * The `PredictedOutage` trace source. Fired when a cell the UE left on an
+   * outage forecast reports it in outage, or when the forecast expires.
+   */
+  TracedCallback<uint64_t, uint16_t, uint16_t, bool, Time> m_predictedOutageTrace;
 
   bool m_ismmWave;
   bool m_ismmWave_2;
@@ -1567,9 +1681,10 @@ private:
   std::map<uint64_t, uint16_t> m_lastMmWaveCell_2; //sjkang
   std::map<uint64_t, bool> m_mmWaveCellSetupCompleted;
   std::map<uint64_t, bool> m_imsiUsingLte;
-  std::map<uint64_t, CellSinrMap> m_imsiCellSinrMap;
+  CellSinrMatrix m_imsiCellSinrMatrix;
+  std::vector<UeCellRanking> m_ueCellRanking;  ///< ranking of each row of m_imsiCellSinrMatrix
   std::map<uint64_t, uint16_t> m_imsiRntiMap;
-  std::map<uint16_t, uint64_t> m_rntiImsiMap;
+  std::vector<uint64_t> m_rntiImsiTable;       ///< imsi by C-RNTI, 0 if unknown
 
   HandoverMode m_handoverMode;
 
@@ -1588,6 +1703,22 @@ private:
 
   int m_crtPeriod;
 
+  // SINR forecast, to switch before an outage
+  bool m_predictiveHandover;
+  Time m_predictionHorizon;
+  SinrTrajectoryPredictor m_sinrPredictor;
+
+  // send the RLC buffers of a secondary cell HO in one X2-U message per bearer
+  bool m_bulkRlcBufferTransfer;
+
+  struct PredictedOutageInfo
+  {
+    uint16_t targetCellId;
+    Time switchTime;
+  };
+  typedef std::map<std::pair<uint64_t, uint16_t>, PredictedOutageInfo> PredictedOutageMap;
+  PredictedOutageMap m_predictedOutages;  ///< (imsi, cell left) of the pending forecasts
+
   uint32_t m_x2_received_cnt;
   Ptr<EpcX2> m_x2;
 
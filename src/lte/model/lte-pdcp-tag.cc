@@ -20,6 +20,7 @@
  */
 
 #include "lte-pdcp-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -44,10 +45,10 @@ PdcpTag::PdcpTag (Time senderTimestamp)
 TypeId
 PdcpTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::PdcpTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::PdcpTag")
     .SetParent<Tag> ()
     .SetGroupName("Lte")
-    .AddConstructor<PdcpTag> ();
+    .AddConstructor<PdcpTag> ());
   return tid;
 }
 
@@ -20,6 +20,7 @@
 
 
 #include "lte-radio-bearer-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -30,7 +31,7 @@ NS_OBJECT_ENSURE_REGISTERED (LteRadioBearerTag);
 TypeId
 LteRadioBearerTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::LteRadioBearerTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::LteRadioBearerTag")
     .SetParent<Tag> ()
     .SetGroupName("Lte")
     .AddConstructor<LteRadioBearerTag> ()
@@ -42,7 +43,7 @@ LteRadioBearerTag::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&LteRadioBearerTag::GetLcid),
                    MakeUintegerChecker<uint8_t> ())
-  ;
+  );
   return tid;
 }
 
@@ -34,6 +34,7 @@
 #include "ns3/ipv4-queue-disc-item.h"
 #include "ns3/ipv4-packet-filter.h"
 #include <fstream>
+#include <set>
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LteRlcAm");
@@ -51,6 +52,9 @@ LteRlcAm::LteRlcAm ()
   m_retxBuffer.resize (1024);
   m_retxBufferSize = 0;
   m_txedBuffer.resize (1024);
+  m_pdcpSnOfRlcPdu.resize (1024);
+  m_segmentedPdcpSn = 0;
+  m_discardedBytes = 0;
   m_txedBufferSize = 0;
 
   // LL HO
@@ -193,6 +197,10 @@ LteRlcAm::GetTypeId (void)
                    StringValue ("RlcAmBufferSize.txt"),
                    MakeStringAccessor (&LteRlcAm::SetBufferSizeFilename),
                    MakeStringChecker ())
+    .AddTraceSource ("PdcpSduDiscarded",
+                     "A PDCP SDU has been discarded before transmission",
+                     MakeTraceSourceAccessor (&LteRlcAm::m_discardTrace),
+                     "ns3::LteRlcAm::DiscardTracedCallback")
     ;
   return tid;
 }
@@ -207,6 +215,8 @@ LteRlcAm::DoDispose ()
   m_rbsTimer.Cancel ();
 
   m_txonBuffer.clear ();
+  m_pdcpSnOfRlcPdu.clear ();
+  m_deliveredPdcpSn.clear ();
   m_txonBufferSize = 0;
   m_txedBuffer.clear ();
   m_txedBufferSize = 0;
@@ -244,13 +254,21 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << p->GetSize ());
 
-  if (m_epcX2RlcProvider !=0 && reporting_Start==0){ //sjkang1114
-        EpcX2Sap::AssistantInformationForSplitting info;
-       std::cout << "will send assistant info from LteRlcAm" <<std::endl;
-       RecordingQueueStatistics();
-       Simulator::Schedule(MilliSeconds(10),&LteRlcAm::SendAssistantInformation,this, info);
+  StorePdcpPdu (p);
 
-       reporting_Start=1;
+  /** Report Buffer Status */
+  DoReportBufferStatus ();
+  m_rbsTimer.Cancel ();
+  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
+}
+
+void
+LteRlcAm::StorePdcpPdu (Ptr<Packet> p)
+{
+  if (m_epcX2RlcProvider !=0 && !m_assistantInfoReporter->IsRunning ()){ //sjkang1114
+       NS_LOG_INFO ("Start sending assistant info over X2");
+       RecordingQueueStatistics();
+       StartAssistantInfoReports (MakeCallback (&LteRlcAm::SendAssistantInformation, this));
         }
 
   if(m_enableAqm == false)
@@ -303,12 +321,6 @@ LteRlcAm::DoTransmitPdcpPdu (Ptr<Packet> p)
     item = Create<Ipv4QueueDiscItem> (p, dest, 0, ipv4Header);
     m_txonQueue->Enqueue (item);
   }
-  
-
-  /** Report Buffer Status */
-  DoReportBufferStatus ();
-  m_rbsTimer.Cancel ();
-  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
 }
 
 void 
@@ -319,6 +331,21 @@ LteRlcAm::DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params)
   DoTransmitPdcpPdu(params.ueData);
 }
 
+void
+LteRlcAm::DoSendMcPdcpSdus (std::vector<EpcX2Sap::UeDataParams> params)
+{
+  NS_LOG_FUNCTION (this << params.size ());
+  for (std::vector<EpcX2Sap::UeDataParams>::iterator it = params.begin (); it != params.end (); ++it)
+    {
+      StorePdcpPdu (it->ueData);
+    }
+
+  /** Report Buffer Status once for all of them */
+  DoReportBufferStatus ();
+  m_rbsTimer.Cancel ();
+  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
+}
+
 
 /**
  * MAC SAP
@@ -1034,6 +1061,11 @@ LteRlcAm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   // Set the FramingInfo flag after the calculation
   rlcAmHeader.SetFramingInfo (framingInfo);
 
+  if (m_assistantInfoReporter->IsRunning ())
+    {
+      RecordPdcpSns (rlcAmHeader.GetSequenceNumber ().GetValue (), dataField);
+    }
+
 
   // Calculate the Polling Bit (5.2.2.1)
   rlcAmHeader.SetPollingBit (LteRlcAmHeader::STATUS_REPORT_NOT_REQUESTED);
@@ -1113,8 +1145,7 @@ LteRlcAm::GetTxBuffer()
   std::vector < Ptr<Packet> > toBeReturned;
   if(!m_enableAqm)
   {
-    toBeReturned.insert(toBeReturned.begin(), m_txonBuffer.begin(), m_txonBuffer.end());
-    m_txonBuffer.clear();
+    toBeReturned.swap(m_txonBuffer);
     m_txonBufferSize = 0;
   }
   else
@@ -2159,6 +2190,13 @@ sumPacketSize +=p->GetSize();
             {
               NS_LOG_LOGIC ("sn " << sn << " is ACKed");
 
+              if (m_txedBuffer.at (seqNumberValue).m_pdu || m_retxBuffer.at (seqNumberValue).m_pdu)
+                {
+                  std::vector<uint16_t> &pdcpSns = m_pdcpSnOfRlcPdu.at (seqNumberValue);
+                  m_deliveredPdcpSn.insert (m_deliveredPdcpSn.end (), pdcpSns.begin (), pdcpSns.end ());
+                  pdcpSns.clear ();
+                }
+
               if (m_txedBuffer.at (seqNumberValue).m_pdu)
                 {
                   NS_LOG_INFO ("ACKed SN = " << seqNumberValue << " from txedBuffer");
@@ -2763,6 +2801,8 @@ LteRlcAm::DoReportBufferStatus (void)
     {
       NS_LOG_INFO ("ReportBufferStatus don't needed");
     }
+
+  m_assistantInfoReporter->NotifyQueueUpdate ();
 }
 
 
@@ -2917,42 +2957,94 @@ LteRlcAm::ExpireRbsTimer (void)
       m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcAm::ExpireRbsTimer, this);
     }
 }
-void
-LteRlcAm::SendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info){
-	info.targetCellId = m_ueDataParams.targetCellId;
-	info.sourceCellId = m_ueDataParams.sourceCellId;
+EpcX2Sap::AssistantInformationForSplitting
+LteRlcAm::GetAssistantInformation ()
+{
+  EpcX2Sap::AssistantInformationForSplitting info = LteRlc::GetAssistantInformation ();
     info.Tx_On_Q_Size= m_txonBufferSize + m_txedBufferSize;
     info.Re_TX_Q_Size= m_retxBufferSize;
     info.Txed_Q_Size = m_txedBufferSize;
     info.Tx_On_Q_Delay = TxOn_QueingDelay;
     info.Re_Tx_Q_Delay = ReTx_QueingDelay;
-    info.rnti = m_rnti;
-    info.drbId = m_drbId;
+  return info;
+}
 
-    m_epcX2RlcProvider->ReceiveAssistantInformation(info);
-   // std::cout<<"MmWave at Rlc Am  " <<(double) (info.Txed_Q_Delay+info.Tx_On_Q_Delay)/10e3<<"s"<<std::endl;
+void
+LteRlcAm::SendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info){
+    info.Delivered_Pdcp_Sn.swap (m_deliveredPdcpSn);
+    LteRlc::SendAssistantInformation (info);
+}
 
-//std::cout << "will send LTE assist info" <<m_rlcSapUser<<std::endl;
+void
+LteRlcAm::SendLteAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info){//sjkang1114
+  info.Delivered_Pdcp_Sn.swap (m_deliveredPdcpSn);
+  LteRlc::SendLteAssistantInformation (info);
+}
 
-	      Simulator::Schedule(MilliSeconds(1),&LteRlcAm::SendAssistantInformation,this, info);
+void
+LteRlcAm::RecordPdcpSns (uint16_t rlcSn, const std::vector < Ptr<Packet> > &dataField)
+{
+  NS_LOG_FUNCTION (this << rlcSn);
+  std::vector<uint16_t> &pdcpSns = m_pdcpSnOfRlcPdu.at (rlcSn);
+  pdcpSns.clear ();
+  for (std::vector < Ptr<Packet> >::const_iterator it = dataField.begin (); it != dataField.end (); ++it)
+    {
+      LteRlcSduStatusTag tag;
+      if (!(*it)->PeekPacketTag (tag))
+        {
+          continue;
+        }
+      LtePdcpHeader pdcpHeader;
+      if ((tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU
+           || tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
+          && (*it)->GetSize () >= pdcpHeader.GetSerializedSize ())
+        {
+          (*it)->PeekHeader (pdcpHeader);
+          m_segmentedPdcpSn = pdcpHeader.GetSequenceNumber ();
+        }
+      if (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU
+          || tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT)
+        {
+          pdcpSns.push_back (m_segmentedPdcpSn);
+        }
+    }
 }
 
 void
-LteRlcAm::SendLteAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info){//sjkang1114
-	info.targetCellId = m_ueDataParams.targetCellId;
-	info.sourceCellId = m_ueDataParams.sourceCellId;
-    info.Tx_On_Q_Size= m_txonBufferSize + m_txedBufferSize;
-    info.Re_TX_Q_Size= m_retxBufferSize;
-    info.Txed_Q_Size = m_txedBufferSize;
-    info.Tx_On_Q_Delay = TxOn_QueingDelay;
-    info.Re_Tx_Q_Delay = ReTx_QueingDelay;
-    info.rnti = m_rnti;
-    info.drbId = m_drbId;
-//std::cout<<"LTE at Rlc Am  " <<(double) (info.Txed_Q_Delay+info.Tx_On_Q_Delay)/10e3 <<"s"<<std::endl;
-  m_rlcSapUser->SendLteAssi(info);
+LteRlcAm::DoDiscardPdcpSdus (std::vector<uint16_t> pdcpSns)
+{
+  NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << pdcpSns.size ());
+  std::set<uint16_t> toDiscard (pdcpSns.begin (), pdcpSns.end ());
+  std::vector < Ptr<Packet> >::iterator it = m_txonBuffer.begin ();
+  while (it != m_txonBuffer.end ())
+    {
+      // only the SDUs not segmented yet start with their PDCP header
+      LteRlcSduStatusTag tag;
+      LtePdcpHeader pdcpHeader;
+      if ((*it)->PeekPacketTag (tag) && tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU
+          && (*it)->GetSize () >= pdcpHeader.GetSerializedSize ())
+        {
+          (*it)->PeekHeader (pdcpHeader);
+          if (toDiscard.find (pdcpHeader.GetSequenceNumber ()) != toDiscard.end ())
+            {
+              uint32_t size = (*it)->GetSize ();
+              NS_LOG_INFO ("Discard PDCP SN " << pdcpHeader.GetSequenceNumber () << " size " << size);
+              m_txonBufferSize -= size;
+              m_discardedBytes += size;
+              m_discardTrace (m_rnti, m_lcid, pdcpHeader.GetSequenceNumber (), size);
+              it = m_txonBuffer.erase (it);
+              continue;
+            }
+        }
+      ++it;
+    }
+  DoReportBufferStatus ();
+}
 
-	//}
-	      Simulator::Schedule(MilliSeconds(1),&LteRlcAm::SendLteAssistantInformation,this, info);
+uint64_t
+LteRlcAm::GetDiscardedBytes () const
+{
+  return m_discardedBytes;
 }
 
 void
@@ -2990,10 +3082,9 @@ Simulator::Schedule(MilliSeconds(1.0),&LteRlcAm::RecordingQueueStatistics,this);
 void
 LteRlcAm::DoRequestAssistantInfo(){
 
-	             EpcX2Sap::AssistantInformationForSplitting info;
-	            std::cout << "will send LTE assistant info from LteRlcAm" <<std::endl;
+	            NS_LOG_INFO ("Start sending LTE assistant info");
 	            RecordingQueueStatistics();
-	            Simulator::Schedule(MilliSeconds(10),&LteRlcAm::SendLteAssistantInformation,this, info);
+	            StartAssistantInfoReports (MakeCallback (&LteRlcAm::SendLteAssistantInformation, this));
 
 }
 } // namespace ns3
@@ -29,6 +29,7 @@
 #include <ns3/lte-rlc.h>
 #include <ns3/epc-x2-sap.h>
 #include <ns3/lte-pdcp-header.h>
+#include <ns3/assistant-info-reporter.h>
 
 #include <vector>
 #include <map>
@@ -65,8 +66,40 @@ public:
    * RLC EPC X2 SAP
    */
   virtual void DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params);
+  /**
+   * Store all the PDCP SDUs of an X2-U container, then report the buffer
+   * status once
+   *
+   * \param params the PDCP SDUs, in order
+   */
+  virtual void DoSendMcPdcpSdus (std::vector<EpcX2Sap::UeDataParams> params);
   virtual void CalculatePathThroughput(std::ofstream *stream); //sjkang
 
+  /**
+   * Discard the PDCP SDUs not segmented yet whose sequence number is in the
+   * list. SDUs already mapped to RLC PDUs are kept, since the RLC sequence
+   * numbers have to be delivered anyway.
+   *
+   * \param pdcpSns the PDCP sequence numbers
+   */
+  virtual void DoDiscardPdcpSdus (std::vector<uint16_t> pdcpSns);
+
+  /**
+   * \return the bytes removed from the transmission buffer by DoDiscardPdcpSdus
+   */
+  uint64_t GetDiscardedBytes () const;
+
+  /**
+   * TracedCallback signature for the discard of a PDCP SDU.
+   *
+   * \param [in] rnti C-RNTI of the UE.
+   * \param [in] lcid The logical channel id.
+   * \param [in] pdcpSn PDCP sequence number of the SDU.
+   * \param [in] bytes SDU size.
+   */
+  typedef void (* DiscardTracedCallback)
+    (uint16_t rnti, uint8_t lcid, uint16_t pdcpSn, uint32_t bytes);
+
   // LL HO
   std::vector < Ptr<Packet> > GetTxBuffer();
   uint32_t GetTxBufferSize();
@@ -138,6 +171,14 @@ private:
   void ReassembleAndDeliver (Ptr<Packet> packet);
   void TriggerReceivePdcpPdu(Ptr<Packet> p);
 
+  /**
+   * Add a PDCP PDU to the transmission buffer, or drop it if the buffer
+   * is full, without reporting the buffer status
+   *
+   * \param p the PDCP PDU
+   */
+  void StorePdcpPdu (Ptr<Packet> p);
+
   void Reassemble (Ptr<Packet> Packet);
 
   void DoReportBufferStatus ();
@@ -145,9 +186,19 @@ private:
   std::string GetBufferSizeFilename();
   void SetBufferSizeFilename(std::string filename);
   void BufferSizeTrace();
-  void SendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
-  void SendLteAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
+  virtual EpcX2Sap::AssistantInformationForSplitting GetAssistantInformation ();
+  virtual void SendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
+  virtual void SendLteAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
   void DoRequestAssistantInfo();
+
+  /**
+   * Remember which PDCP SDUs end in a new RLC PDU, so that their delivery
+   * can be reported to the PDCP when the RLC PDU is acknowledged
+   *
+   * \param rlcSn the RLC sequence number of the PDU
+   * \param dataField the SDUs and SDU segments in the PDU
+   */
+  void RecordPdcpSns (uint16_t rlcSn, const std::vector < Ptr<Packet> > &dataField);
 private:
     std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
 
@@ -286,7 +337,11 @@ private:
   uint64_t sumPacketSize=0;
   double TotalTime=0.0;
 
-  uint16_t reporting_Start=0; //sjkang
+  std::vector < std::vector<uint16_t> > m_pdcpSnOfRlcPdu; ///< PDCP SNs whose last byte is in each RLC PDU
+  uint16_t m_segmentedPdcpSn;               ///< PDCP SN of the SDU being segmented
+  std::vector<uint16_t> m_deliveredPdcpSn;  ///< PDCP SNs acknowledged since the last report
+  uint64_t m_discardedBytes;
+  TracedCallback<uint16_t, uint8_t, uint16_t, uint32_t> m_discardTrace;
   uint16_t TxOn_QueingDelay; //sjkang
   uint16_t ReTx_QueingDelay; //sjkang
 
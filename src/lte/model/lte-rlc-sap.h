@@ -86,6 +86,15 @@ public:
    */
   virtual void TransmitPdcpPdu (TransmitPdcpPduParameters params) = 0;
   virtual void RequestAssistantInfo()=0; //sjkang
+
+  /**
+   * Discard the PDCP SDUs with the given sequence numbers that have not
+   * been transmitted yet, e.g., because a duplicate was delivered on
+   * another leg
+   *
+   * \param pdcpSns the PDCP sequence numbers
+   */
+  virtual void DiscardPdcpSdus (std::vector<uint16_t> pdcpSns) = 0;
 };
 
 
@@ -125,6 +134,7 @@ public:
   // Interface implemented from LteRlcSapProvider
   virtual void TransmitPdcpPdu (TransmitPdcpPduParameters params);
   virtual void RequestAssistantInfo(); //sjkang
+  virtual void DiscardPdcpSdus (std::vector<uint16_t> pdcpSns);
 private:
   LteRlcSpecificLteRlcSapProvider ();
   C* m_rlc;
@@ -151,6 +161,11 @@ template  <class C>
 void LteRlcSpecificLteRlcSapProvider<C>::RequestAssistantInfo(){ //sjkang
 m_rlc->DoRequestAssistantInfo();
 }
+template <class C>
+void LteRlcSpecificLteRlcSapProvider<C>::DiscardPdcpSdus (std::vector<uint16_t> pdcpSns)
+{
+  m_rlc->DoDiscardPdcpSdus (pdcpSns);
+}
 ///////////////////////////////////////
 
 template <class C>
@@ -19,6 +19,7 @@
  */
 
 #include "ns3/lte-rlc-sdu-status-tag.h"
+#include "ns3/packet-tag-list.h"
 
 namespace ns3 {
 
@@ -43,11 +44,11 @@ LteRlcSduStatusTag::GetStatus (void) const
 TypeId
 LteRlcSduStatusTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::LteRlcSduStatusTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::LteRlcSduStatusTag")
     .SetParent<Tag> ()
     .SetGroupName("Lte")
     .AddConstructor<LteRlcSduStatusTag> ()
-  ;
+  );
   return tid;
 }
 TypeId
@@ -19,6 +19,7 @@
  */
 
 #include "lte-rlc-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -43,10 +44,10 @@ RlcTag::RlcTag (Time senderTimestamp)
 TypeId
 RlcTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::RlcTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::RlcTag")
     .SetParent<Tag> ()
     .SetGroupName("Lte")
-    .AddConstructor<RlcTag> ();
+    .AddConstructor<RlcTag> ());
   return tid;
 }
 
@@ -124,6 +124,19 @@ LteRlcUmLowLat::DoTransmitPdcpPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << p->GetSize ());
 
+  StorePdcpPdu (p);
+
+  /** Report Buffer Status */
+
+  DoReportBufferStatus ();
+  m_bsrReported = true;
+  m_rbsTimer.Cancel ();
+  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcUmLowLat::ExpireRbsTimer, this);
+}
+
+void
+LteRlcUmLowLat::StorePdcpPdu (Ptr<Packet> p)
+{
   if (m_txBufferSize + p->GetSize () <= m_maxTxBufferSize)
     {
       /** Store arrival time */
@@ -131,12 +144,10 @@ LteRlcUmLowLat::DoTransmitPdcpPdu (Ptr<Packet> p)
       p->AddPacketTag (timeTag);
 
 
-      if (m_epcX2RlcProvider !=0 && reporting_start==0){ //sjkang1114
-       EpcX2Sap::AssistantInformationForSplitting info;
-      std::cout << "will send assistant info from LteRlcUmLowRat" <<std::endl;
+      if (m_epcX2RlcProvider !=0 && !m_assistantInfoReporter->IsRunning ()){ //sjkang1114
+      NS_LOG_INFO ("Start sending assistant info over X2");
       RecordingQueueStatistics(); //sjkang1116
-      Simulator::Schedule(MilliSeconds(10),&LteRlcUmLowLat::DoSendAssistantInformation,this, info);
-      reporting_start=1;
+      StartAssistantInfoReports (MakeCallback (&LteRlcUmLowLat::SendAssistantInformation, this));
        }
 
       LteRlcSduStatusTag tag;
@@ -170,13 +181,6 @@ LteRlcUmLowLat::DoTransmitPdcpPdu (Ptr<Packet> p)
       NS_LOG_LOGIC ("txBufferSize    = " << m_txBufferSize);
       NS_LOG_LOGIC ("packet size     = " << p->GetSize ());
     }
-
-  /** Report Buffer Status */
-
-  DoReportBufferStatus ();
-  m_bsrReported = true;
-  m_rbsTimer.Cancel ();
-  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcUmLowLat::ExpireRbsTimer, this);
 }
 
 void 
@@ -186,6 +190,22 @@ LteRlcUmLowLat::DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params)
   DoTransmitPdcpPdu(params.ueData);
 }
 
+void
+LteRlcUmLowLat::DoSendMcPdcpSdus (std::vector<EpcX2Sap::UeDataParams> params)
+{
+  NS_LOG_FUNCTION (this << params.size ());
+  for (std::vector<EpcX2Sap::UeDataParams>::iterator it = params.begin (); it != params.end (); ++it)
+    {
+      StorePdcpPdu (it->ueData);
+    }
+
+  /** Report Buffer Status once for all of them */
+  DoReportBufferStatus ();
+  m_bsrReported = true;
+  m_rbsTimer.Cancel ();
+  m_rbsTimer = Simulator::Schedule (m_rbsTimerValue, &LteRlcUmLowLat::ExpireRbsTimer, this);
+}
+
 /**
  * MAC SAP
  */
@@ -483,6 +503,16 @@ LteRlcUmLowLat::GetTxBuffer()
 {
   return m_txBuffer;
 }
+
+void
+LteRlcUmLowLat::TakeTxBuffer (std::vector < Ptr<Packet> > &buffer)
+{
+  NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << m_txBuffer.size ());
+  buffer.clear ();
+  buffer.swap (m_txBuffer);
+  m_txBufferSize = 0;
+  DoReportBufferStatus ();
+}
 void
 LteRlcUmLowLat::ClearTxBuffer()
 {
@@ -1243,6 +1273,7 @@ LteRlcUmLowLat::DoReportBufferStatus (void)
     NS_LOG_INFO ("Send ReportBufferStatus = " << r.txQueueSize << ", " << r.txQueueHolDelay << ", " << r.txPacketSizes.size());
     m_macSapProvider->ReportBufferStatus (r);
   }
+  m_assistantInfoReporter->NotifyQueueUpdate ();
 }
 
 
@@ -1313,20 +1344,13 @@ LteRlcUmLowLat::TriggerReceivePdcpPdu(Ptr<Packet> p)
     m_epcX2RlcProvider->ReceiveMcPdcpSdu(m_ueDataParams);
   }
 }
-void
-LteRlcUmLowLat::DoSendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info){ //sjkang
-
-	info.targetCellId = m_ueDataParams.targetCellId;
-	info.sourceCellId = m_ueDataParams.sourceCellId;
-    info.Tx_On_Q_Size=m_txBufferSize;
-    info.Tx_On_Q_Delay = TxOn_QueingDelay;
-    info.rnti = m_rnti;
-    info.drbId = (unsigned)m_drbId;
-  // m_sendAssistatInfo.Cancel();
-	//m_epcX2RlcProvider->ReceiveAssistantInformation(info);
-	//if(!m_sendAssistatInfo.IsRunning())
-	    //  m_sendAssistatInfo = Simulator::Schedule(MilliSeconds(1),&LteRlcUmLowLat::DoSendAssistantInformation,this, info);
-
+EpcX2Sap::AssistantInformationForSplitting
+LteRlcUmLowLat::GetAssistantInformation ()
+{
+  EpcX2Sap::AssistantInformationForSplitting info = LteRlc::GetAssistantInformation ();
+  info.Tx_On_Q_Size = m_txBufferSize;
+  info.Tx_On_Q_Delay = TxOn_QueingDelay;
+  return info;
 }
 void
 LteRlcUmLowLat::CalculatePathThroughput (std::ofstream *streamPathThroughput){
@@ -1342,11 +1366,9 @@ m_reorderingTimer.Cancel();
 }
 void
 LteRlcUmLowLat::DoRequestAssistantInfo(){
-	  EpcX2Sap::AssistantInformationForSplitting info;
-		            std::cout << "will send LTE assistant info from LteRlcUm" <<std::endl;
-		            RecordingQueueStatistics();
-
-		            Simulator::Schedule(MilliSeconds(10),&LteRlcUmLowLat::DoSendAssistantInformation,this, info);
+	NS_LOG_INFO ("Start sending LTE assistant info");
+	RecordingQueueStatistics();
+	StartAssistantInfoReports (MakeCallback (&LteRlcUmLowLat::SendLteAssistantInformation, this));
 }
 //voi
 //LteRlcUmLowLat::SetDrbId(uint8_t drbId){
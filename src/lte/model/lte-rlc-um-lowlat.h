@@ -58,7 +58,14 @@ public:
    * RLC EPC X2 SAP
    */
   virtual void DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params);
-  void DoSendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
+  /**
+   * Store all the PDCP SDUs of an X2-U container, then report the buffer
+   * status once
+   *
+   * \param params the PDCP SDUs, in order
+   */
+  virtual void DoSendMcPdcpSdus (std::vector<EpcX2Sap::UeDataParams> params);
+  virtual EpcX2Sap::AssistantInformationForSplitting GetAssistantInformation ();
    virtual void DoRequestAssistantInfo();
 
   /**
@@ -69,6 +76,14 @@ public:
   virtual void DoReceivePdu (Ptr<Packet> p);
   virtual void CalculatePathThroughput(std::ofstream *stream);
   std::vector < Ptr<Packet> > GetTxBuffer();
+  /**
+   * Move the transmission buffer out of the RLC, which is left empty, and
+   * report the new buffer status. Used to hand the buffer over to the
+   * target cell of a handover without copying it.
+   *
+   * \param buffer receives the PDCP PDUs, oldest first
+   */
+  void TakeTxBuffer (std::vector < Ptr<Packet> > &buffer);
   void ClearTxBuffer();
   uint32_t GetTxBufferSize()
   {
@@ -89,6 +104,14 @@ private:
   void TriggerReceivePdcpPdu(Ptr<Packet> p);
 
   void DoReportBufferStatus ();
+
+  /**
+   * Add a PDCP PDU to the transmission buffer, or drop it if the buffer
+   * is full, without reporting the buffer status
+   *
+   * \param p the PDCP PDU
+   */
+  void StorePdcpPdu (Ptr<Packet> p);
   void RecordingQueueStatistics() ; //sjkang1116
 
 private:
@@ -147,7 +170,6 @@ private:
   Time m_reorderingTimeExpires;
 
   bool m_bsrReported;
-  uint16_t reporting_start=0; //sjkang
 
  // uint8_t m_drbId;
 };
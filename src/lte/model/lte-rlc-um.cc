@@ -105,6 +105,11 @@ LteRlcUm::DoTransmitPdcpPdu (Ptr<Packet> p)
 {
   NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << p->GetSize ());
 
+  if (m_epcX2RlcProvider != 0)
+    {
+      StartAssistantInfoReports (MakeCallback (&LteRlcUm::SendAssistantInformation, this));
+    }
+
   if (m_txBufferSize + p->GetSize () <= m_maxTxBufferSize)
     {
       /** Store arrival time */
@@ -415,6 +420,7 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
       m_rbsTimer.Cancel ();
       m_rbsTimer = Simulator::Schedule (MilliSeconds (10), &LteRlcUm::ExpireRbsTimer, this);
     }
+  m_assistantInfoReporter->NotifyQueueUpdate ();
 }
 
 void
@@ -429,6 +435,16 @@ LteRlcUm::GetTxBuffer()
   return m_txBuffer;
 }
 
+void
+LteRlcUm::TakeTxBuffer (std::vector < Ptr<Packet> > &buffer)
+{
+  NS_LOG_FUNCTION (this << m_rnti << (uint32_t) m_lcid << m_txBuffer.size ());
+  buffer.clear ();
+  buffer.swap (m_txBuffer);
+  m_txBufferSize = 0;
+  DoReportBufferStatus ();
+}
+
 void
 LteRlcUm::DoReceivePdu (Ptr<Packet> p)
 {
@@ -441,15 +457,6 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
 		m_Tput_Calculator = Simulator::Schedule (MilliSeconds (100), &LteRlcUm::CalculatePathThroughput,this , stream);
 	}
   isEnbaleMeasuring =true;
-// std::cout << "will sedn assistant infor  " <<m_epcX2RlcProvider<<std::endl;
-
-  if (m_epcX2RlcProvider !=0){
-  EpcX2Sap::AssistantInformationForSplitting info;
- info.Re_TX_Q_Size=0;info.Re_Tx_Q_Delay=0;info.Tx_On_Q_Delay=0;
- info.Txed_Q_Size=0; info.Txed_Q_Delay=0;
- std::cout << "will sedn assistant infor" <<std::endl;
- DoSendAssistantInformation(info);
-  }
   //std::cout << "----------------------received data   " <<std::endl;
   //}
 //std::cout<< "RlcUm receive data " << std::endl;
@@ -1118,12 +1125,18 @@ LteRlcUm::TriggerReceivePdcpPdu(Ptr<Packet> p)
 
   }
 }
-void
-LteRlcUm::DoSendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info){ //sjkang
-
-	info.targetCellId = m_ueDataParams.targetCellId;
-	info.sourceCellId = m_ueDataParams.sourceCellId;
-	m_epcX2RlcProvider->ReceiveAssistantInformation(info);
+EpcX2Sap::AssistantInformationForSplitting
+LteRlcUm::GetAssistantInformation ()
+{
+  EpcX2Sap::AssistantInformationForSplitting info = LteRlc::GetAssistantInformation ();
+  info.Tx_On_Q_Size = m_txBufferSize;
+  if (!m_txBuffer.empty ())
+    {
+      RlcTag holTimeTag;
+      m_txBuffer.front ()->PeekPacketTag (holTimeTag);
+      info.Tx_On_Q_Delay = (Simulator::Now () - holTimeTag.GetSenderTimestamp ()).GetMicroSeconds ();
+    }
+  return info;
 }
 
 
@@ -1211,6 +1224,8 @@ LteRlcUm::DoReportBufferStatus (void)
   TxQueuingDelay = holDelay.GetSeconds();
   NS_LOG_LOGIC ("Send ReportBufferStatus = " << r.txQueueSize << ", " << r.txQueueHolDelay );
   m_macSapProvider->ReportBufferStatus (r);
+
+  m_assistantInfoReporter->NotifyQueueUpdate ();
 }
 
 
@@ -1330,10 +1345,8 @@ Simulator::Schedule(MilliSeconds(1.0),&LteRlcUm::RecordingQueueStatistics,this);
 }
 void
 LteRlcUm::DoRequestAssistantInfo(){
-	 EpcX2Sap::AssistantInformationForSplitting info;
-			            std::cout << "will send LTE assistant info from LteRlcUmLowLat" <<std::endl;
-			            RecordingQueueStatistics();
-			            Simulator::Schedule(MilliSeconds(10),&LteRlcUm::DoSendAssistantInformation,this, info);
-
+	NS_LOG_INFO ("Start sending LTE assistant info");
+	RecordingQueueStatistics();
+	StartAssistantInfoReports (MakeCallback (&LteRlcUm::SendLteAssistantInformation, this));
 }
 } // namespace ns3
@@ -56,7 +56,7 @@ public:
    * RLC EPC X2 SAP
    */
   virtual void DoSendMcPdcpSdu(EpcX2Sap::UeDataParams params);
-  void DoSendAssistantInformation(EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
+  virtual EpcX2Sap::AssistantInformationForSplitting GetAssistantInformation ();
   /**
    * MAC SAP
    */
@@ -67,6 +67,14 @@ public:
    void CalculateThroughput();
   virtual void DoRequestAssistantInfo(); //sjkang
   std::vector < Ptr<Packet> > GetTxBuffer();
+  /**
+   * Move the transmission buffer out of the RLC, which is left empty, and
+   * report the new buffer status. Used to hand the buffer over to the
+   * target cell of a handover without copying it.
+   *
+   * \param buffer receives the PDCP PDUs, oldest first
+   */
+  void TakeTxBuffer (std::vector < Ptr<Packet> > &buffer);
   uint32_t GetTxBufferSize()
   {
     return m_txBufferSize;
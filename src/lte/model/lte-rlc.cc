@@ -25,6 +25,7 @@
 
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/pointer.h"
 
 #include "ns3/lte-rlc.h"
 #include "ns3/lte-rlc-tag.h"
@@ -91,6 +92,8 @@ LteRlc::LteRlc ()
   m_rlcSapProvider = new LteRlcSpecificLteRlcSapProvider<LteRlc> (this);
   m_epcX2RlcUser = new EpcX2RlcSpecificUser<LteRlc> (this);
   m_macSapUser = new LteRlcSpecificLteMacSapUser (this);
+  m_assistantInfoReporter = CreateObject<AssistantInfoReporter> ();
+  m_assistantInfoReporter->SetSnapshotCallback (MakeCallback (&LteRlc::GetAssistantInformation, this));
  // m_drbId=0;
 //  std::cout << "sjkang1114" << "\t " << this <<"\t"<<"this is rlc address" << std::endl;
 }
@@ -117,6 +120,11 @@ TypeId LteRlc::GetTypeId (void)
                      "PDU acked.",
                      MakeTraceSourceAccessor (&LteRlc::m_txCompletedCallback),
                      "ns3::LteRlc::RetransmissionCountCallback")
+    .AddAttribute ("AssistantInfoReporter",
+                   "The reporter of the assistant information sent to the PDCP of a split bearer",
+                   PointerValue (),
+                   MakePointerAccessor (&LteRlc::m_assistantInfoReporter),
+                   MakePointerChecker<AssistantInfoReporter> ())
     ;
   return tid;
 }
@@ -127,6 +135,8 @@ LteRlc::DoDispose ()
   NS_LOG_FUNCTION (this);
   delete (m_rlcSapProvider);
   delete (m_macSapUser);
+  m_assistantInfoReporter->Dispose ();
+  m_assistantInfoReporter = 0;
 }
 
 void
@@ -212,6 +222,58 @@ void
 LteRlc:: DoRequestAssistantInfo() {//sjkang
 }
 
+void
+LteRlc::StartAssistantInfoReports (Callback<void, EpcX2Sap::AssistantInformationForSplitting> send)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_assistantInfoReporter->IsRunning ())
+    {
+      return;
+    }
+  m_assistantInfoReporter->SetSendCallback (send);
+  m_assistantInfoReporter->Start (MilliSeconds (10));
+}
+
+EpcX2Sap::AssistantInformationForSplitting
+LteRlc::GetAssistantInformation ()
+{
+  EpcX2Sap::AssistantInformationForSplitting info;
+  info.targetCellId = m_ueDataParams.targetCellId;
+  info.sourceCellId = m_ueDataParams.sourceCellId;
+  info.rnti = m_rnti;
+  info.drbId = m_drbId;
+  return info;
+}
+
+void
+LteRlc::SendAssistantInformation (EpcX2Sap::AssistantInformationForSplitting info)
+{
+  m_epcX2RlcProvider->ReceiveAssistantInformation (info);
+}
+
+void
+LteRlc::SendLteAssistantInformation (EpcX2Sap::AssistantInformationForSplitting info)
+{
+  m_rlcSapUser->SendLteAssi (info);
+}
+
+void
+LteRlc::DoDiscardPdcpSdus (std::vector<uint16_t> pdcpSns)
+{
+  NS_LOG_FUNCTION (this << pdcpSns.size ());
+  NS_LOG_INFO ("PDCP SDU discard not supported by this RLC");
+}
+
+void
+LteRlc::DoSendMcPdcpSdus (std::vector<EpcX2Sap::UeDataParams> params)
+{
+  NS_LOG_FUNCTION (this << params.size ());
+  for (std::vector<EpcX2Sap::UeDataParams>::iterator it = params.begin (); it != params.end (); ++it)
+    {
+      DoSendMcPdcpSdu (*it);
+    }
+}
+
 ////////////////////////////////////////
 
 NS_OBJECT_ENSURE_REGISTERED (LteRlcSm);
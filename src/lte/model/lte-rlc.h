@@ -37,6 +37,7 @@
 
 #include "ns3/lte-rlc-sap.h"
 #include "ns3/lte-mac-sap.h"
+#include "ns3/assistant-info-reporter.h"
 #include <fstream>//sjkang
 
 namespace ns3 {
@@ -185,6 +186,21 @@ public:
   // NB to avoid the use of multiple inheritance
   virtual void CalculatePathThroughput(std::ofstream *stream)=0; //sjkang
 
+  /**
+   * Discard PDCP SDUs not transmitted yet. Only the AM RLC supports it.
+   *
+   * \param pdcpSns the PDCP sequence numbers
+   */
+  virtual void DoDiscardPdcpSdus (std::vector<uint16_t> pdcpSns);
+
+  /**
+   * Transmit the PDCP SDUs of an X2-U container. By default they are
+   * transmitted one by one.
+   *
+   * \param params the PDCP SDUs, in order
+   */
+  virtual void DoSendMcPdcpSdus (std::vector<EpcX2Sap::UeDataParams> params);
+
 protected:
   // Interface forwarded by LteRlcSapProvider
   virtual void DoTransmitPdcpPdu (Ptr<Packet> p) = 0;
@@ -203,6 +219,31 @@ protected:
 
   virtual void DoRequestAssistantInfo();//sjkang
 
+  /**
+   * Start reporting the assistant information of a split bearer to the
+   * PDCP of the MeNB, unless the reports are already running
+   *
+   * \param send the callback delivering the reports, either
+   *        SendAssistantInformation or SendLteAssistantInformation
+   */
+  void StartAssistantInfoReports (Callback<void, EpcX2Sap::AssistantInformationForSplitting> send);
+  /**
+   * \return the current queue state, as reported to the PDCP of a split bearer
+   */
+  virtual EpcX2Sap::AssistantInformationForSplitting GetAssistantInformation ();
+  /**
+   * Send a report to the PDCP of the MeNB over X2
+   * \param info the report
+   */
+  virtual void SendAssistantInformation (EpcX2Sap::AssistantInformationForSplitting info);
+  /**
+   * Send a report to the local PDCP, for the LTE leg of a split bearer
+   * \param info the report
+   */
+  virtual void SendLteAssistantInformation (EpcX2Sap::AssistantInformationForSplitting info);
+
+  Ptr<AssistantInfoReporter> m_assistantInfoReporter; ///< decides when the reports are sent
+
   LteMacSapUser* m_macSapUser;
   LteMacSapProvider* m_macSapProvider;
 
@@ -39,6 +39,7 @@
 #define MAX_MEAS_ID 32
 #define MAX_CELL_MEAS 32
 #define MAX_CELL_REPORT 8
+#define MAX_COALESCED_MESSAGES 16
 
 namespace ns3 {
 
@@ -6305,6 +6306,7 @@ RrcConnectionRejectHeader::GetMessage () const
 //////////////////// MeasurementReportHeader class ////////////////////////
 
 MeasurementReportHeader::MeasurementReportHeader ()
+  : m_delta (false)
 {
 }
 
@@ -6317,8 +6319,8 @@ MeasurementReportHeader::PreSerialize () const
 {
   m_serializationResult = Buffer ();
 
-  // Serialize DCCH message
-  SerializeUlDcchMessage (1);
+  // Serialize DCCH message, a delta report uses a spare message type
+  SerializeUlDcchMessage (m_delta ? 7 : 1);
 
   // Serialize MeasurementReport sequence:
   // no default or optional fields. Extension marker not present.
@@ -6351,6 +6353,7 @@ MeasurementReportHeader::Deserialize (Buffer::Iterator bIterator)
   bIterator = DeserializeSequence (&bitset0,false,bIterator);
 
   bIterator = DeserializeUlDcchMessage (bIterator);
+  m_delta = (m_messageType == 7);
 
   int criticalExtensionsChoice;
   bIterator = DeserializeChoice (2,false,&criticalExtensionsChoice,bIterator);
@@ -6395,6 +6398,7 @@ void
 MeasurementReportHeader::Print (std::ostream &os) const
 {
   os << "measId = " << (int)m_measurementReport.measResults.measId << std::endl;
+  os << "delta = " << m_delta << std::endl;
   os << "rsrpResult = " << (int)m_measurementReport.measResults.rsrpResult << std::endl;
   os << "rsrqResult = " << (int)m_measurementReport.measResults.rsrqResult << std::endl;
   os << "haveMeasResultNeighCells = " << (int)m_measurementReport.measResults.haveMeasResultNeighCells << std::endl;
@@ -6453,6 +6457,97 @@ MeasurementReportHeader::GetMessage () const
   return msg;
 }
 
+void
+MeasurementReportHeader::SetDelta (bool delta)
+{
+  m_delta = delta;
+  m_isDataSerialized = false;
+}
+
+bool
+MeasurementReportHeader::IsDelta () const
+{
+  return m_delta;
+}
+//////////////////// RrcCoalescedMessagesHeader class ////////////////////////
+
+RrcCoalescedMessagesHeader::RrcCoalescedMessagesHeader ()
+{
+}
+
+RrcCoalescedMessagesHeader::~RrcCoalescedMessagesHeader ()
+{
+}
+
+TypeId
+RrcCoalescedMessagesHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RrcCoalescedMessagesHeader")
+    .SetParent<Header> ()
+    .SetGroupName("Lte")
+  ;
+  return tid;
+}
+
+void
+RrcCoalescedMessagesHeader::Print (std::ostream &os) const
+{
+  os << "numMessages = " << m_messageSizes.size () << std::endl;
+  for (std::vector<uint16_t>::const_iterator it = m_messageSizes.begin (); it != m_messageSizes.end (); ++it)
+    {
+      os << "   size = " << *it << std::endl;
+    }
+}
+
+void
+RrcCoalescedMessagesHeader::PreSerialize () const
+{
+  m_serializationResult = Buffer ();
+
+  SerializeUlDcchMessage (6);
+
+  SerializeSequenceOf (m_messageSizes.size (),MAX_COALESCED_MESSAGES,1);
+  for (std::vector<uint16_t>::const_iterator it = m_messageSizes.begin (); it != m_messageSizes.end (); ++it)
+    {
+      SerializeInteger (*it,1,65535);
+    }
+
+  // Finish serialization
+  FinalizeSerialization ();
+}
+
+uint32_t
+RrcCoalescedMessagesHeader::Deserialize (Buffer::Iterator bIterator)
+{
+  bIterator = DeserializeUlDcchMessage (bIterator);
+
+  int numMessages;
+  bIterator = DeserializeSequenceOf (&numMessages,MAX_COALESCED_MESSAGES,1,bIterator);
+  m_messageSizes.clear ();
+  for (int i = 0; i < numMessages; i++)
+    {
+      int size;
+      bIterator = DeserializeInteger (&size,1,65535,bIterator);
+      m_messageSizes.push_back (size);
+    }
+
+  return GetSerializedSize ();
+}
+
+void
+RrcCoalescedMessagesHeader::SetMessageSizes (std::vector<uint16_t> sizes)
+{
+  NS_ASSERT_MSG (!sizes.empty () && sizes.size () <= MAX_COALESCED_MESSAGES, "invalid number of coalesced messages " << sizes.size ());
+  m_messageSizes = sizes;
+  m_isDataSerialized = false;
+}
+
+std::vector<uint16_t>
+RrcCoalescedMessagesHeader::GetMessageSizes () const
+{
+  return m_messageSizes;
+}
+
 ///////////////////  RrcUlDcchMessage //////////////////////////////////
 RrcUlDcchMessage::RrcUlDcchMessage () : RrcAsn1Header ()
 {
@@ -29,6 +29,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 #include "ns3/lte-rrc-sap.h"
 #include "ns3/lte-asn1-header.h"
@@ -279,6 +280,37 @@ private:
   std::bitset<16> m_mmWaveRnti;
 };
 
+/**
+ * Container of several UL-DCCH messages of the same UE, sent in a single
+ * SRB1 PDU. The header carries the size of each message, the serialized
+ * messages follow it in order.
+ */
+class RrcCoalescedMessagesHeader : public RrcUlDcchMessage
+{
+public:
+  RrcCoalescedMessagesHeader ();
+  ~RrcCoalescedMessagesHeader ();
+
+  // Inherited from RrcAsn1Header
+  static TypeId GetTypeId (void);
+  void PreSerialize () const;
+  uint32_t Deserialize (Buffer::Iterator bIterator);
+  void Print (std::ostream &os) const;
+
+  /**
+   * \param sizes the size in bytes of each message in the container
+   */
+  void SetMessageSizes (std::vector<uint16_t> sizes);
+
+  /**
+   * \return the size in bytes of each message in the container
+   */
+  std::vector<uint16_t> GetMessageSizes () const;
+
+private:
+  std::vector<uint16_t> m_messageSizes;
+};
+
 class RrcConnectionSwitchHeader : public RrcDlDcchMessage
 {
 public:
@@ -837,8 +869,21 @@ public:
   */
   LteRrcSap::MeasurementReport GetMessage () const;
 
+  /**
+  * Mark the report as a delta report, which lists only the neighbour cells
+  * whose results changed since the previous report with the same measId
+  * @param delta true for a delta report
+  */
+  void SetDelta (bool delta);
+
+  /**
+  * @return true if the report is a delta report
+  */
+  bool IsDelta () const;
+
 private:
   LteRrcSap::MeasurementReport m_measurementReport;
+  bool m_delta;
 
 };
 
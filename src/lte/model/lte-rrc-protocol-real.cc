@@ -29,6 +29,9 @@
 #include <ns3/node-list.h>
 #include <ns3/node.h>
 #include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/trace-source-accessor.h>
 
 #include "lte-rrc-protocol-real.h"
 #include "lte-ue-rrc.h"
@@ -42,11 +45,18 @@ NS_LOG_COMPONENT_DEFINE ("LteRrcProtocolReal");
 
 const Time RRC_REAL_MSG_DELAY = MicroSeconds (500); 
 
+/// maximum number of RRC messages coalesced in one SRB1 PDU
+static const uint32_t MAX_COALESCED_SRB1_SDUS = 16;
+
 NS_OBJECT_ENSURE_REGISTERED (LteUeRrcProtocolReal);
 
 LteUeRrcProtocolReal::LteUeRrcProtocolReal ()
   :  m_ueRrcSapProvider (0),
-    m_enbRrcSapProvider (0)
+    m_enbRrcSapProvider (0),
+    m_coalesceMessages (false),
+    m_deltaMeasurementReports (false),
+    m_measReportHysteresis (2),
+    m_measReportCellId (0)
 {
   m_ueRrcSapUser = new MemberLteUeRrcSapUser<LteUeRrcProtocolReal> (this);
   m_completeSetupParameters.srb0SapUser = new LteRlcSpecificLteRlcSapUser<LteUeRrcProtocolReal> (this);
@@ -68,6 +78,8 @@ void
 LteUeRrcProtocolReal::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_flushSrb1Event.Cancel ();
+  m_pendingSrb1Sdus.clear ();
   delete m_ueRrcSapUser;
   delete m_completeSetupParameters.srb0SapUser;
   delete m_completeSetupParameters.srb1SapUser;
@@ -81,6 +93,35 @@ LteUeRrcProtocolReal::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName("Lte")
     .AddConstructor<LteUeRrcProtocolReal> ()
+    .AddAttribute ("CoalesceMessages",
+                   "If true, the RRC messages sent over SRB1 in the same TTI "
+                   "are coalesced in a single PDCP SDU",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUeRrcProtocolReal::m_coalesceMessages),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TtiDuration",
+                   "The TTI of the link carrying SRB1: coalesced messages are "
+                   "sent at the end of the TTI in which they are generated",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&LteUeRrcProtocolReal::m_ttiDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("DeltaMeasurementReports",
+                   "If true, a measurement report lists only the neighbour cells "
+                   "whose RSRP or RSRQ moved by more than MeasurementReportHysteresis "
+                   "since the previous report with the same measId",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteUeRrcProtocolReal::m_deltaMeasurementReports),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MeasurementReportHysteresis",
+                   "Change of the RSRP or RSRQ of a neighbour cell, in range units, "
+                   "above which the cell is listed in a delta measurement report",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&LteUeRrcProtocolReal::m_measReportHysteresis),
+                   MakeUintegerChecker<uint8_t> ())
+    .AddTraceSource ("TxSrbPdu",
+                     "PDU sent over a signalling radio bearer",
+                     MakeTraceSourceAccessor (&LteUeRrcProtocolReal::m_txSrbPduTrace),
+                     "ns3::LteUeRrcProtocolReal::TxSrbPduTracedCallback")
   ;
   return tid;
 }
@@ -108,6 +149,8 @@ LteUeRrcProtocolReal::DoSetup (LteUeRrcSapUser::SetupParameters params)
 {
   NS_LOG_FUNCTION (this);
 
+  // the queued messages go to the SRB1 they were generated for
+  FlushSrb1Sdus ();
   m_setupParameters.srb0SapProvider = params.srb0SapProvider;
   m_setupParameters.srb1SapProvider = params.srb1SapProvider; 
   m_ueRrcSapProvider->CompleteSetup (m_completeSetupParameters);
@@ -158,10 +201,9 @@ LteUeRrcProtocolReal::DoSendRrcConnectionSetupCompleted (LteRrcSap::RrcConnectio
   transmitPdcpSduParameters.rnti = m_rnti;
   transmitPdcpSduParameters.lcid = 1;
 
-  if (m_setupParameters.srb1SapProvider)
-    {
-      m_setupParameters.srb1SapProvider->TransmitPdcpSdu (transmitPdcpSduParameters);
-    }
+  // a new connection starts without reference measurement results
+  m_measReportCodec.Clear ();
+  TransmitSrb1Sdu (transmitPdcpSduParameters);
 }
 
 void 
@@ -184,7 +226,7 @@ LteUeRrcProtocolReal::DoSendRrcConnectionReconfigurationCompleted (LteRrcSap::Rr
   transmitPdcpSduParameters.rnti = m_rnti;
   transmitPdcpSduParameters.lcid = 1;
   NS_LOG_INFO("Tx RRC Connection reconf completed");
-  m_setupParameters.srb1SapProvider->TransmitPdcpSdu (transmitPdcpSduParameters);
+  TransmitSrb1Sdu (transmitPdcpSduParameters);
 }
 
 void 
@@ -197,8 +239,21 @@ LteUeRrcProtocolReal::DoSendMeasurementReport (LteRrcSap::MeasurementReport msg)
 
   Ptr<Packet> packet = Create<Packet> ();
 
+  bool delta = false;
+  if (m_deltaMeasurementReports)
+    {
+      if (m_rrc->GetCellId () != m_measReportCellId)
+        {
+          m_measReportCodec.Clear ();
+          m_measReportCellId = m_rrc->GetCellId ();
+        }
+      m_measReportCodec.SetHysteresis (m_measReportHysteresis);
+      delta = m_measReportCodec.Encode (m_rnti, msg);
+    }
+
   MeasurementReportHeader measurementReportHeader;
   measurementReportHeader.SetMessage (msg);
+  measurementReportHeader.SetDelta (delta);
 
   packet->AddHeader (measurementReportHeader);
 
@@ -207,7 +262,7 @@ LteUeRrcProtocolReal::DoSendMeasurementReport (LteRrcSap::MeasurementReport msg)
   transmitPdcpSduParameters.rnti = m_rnti;
   transmitPdcpSduParameters.lcid = 1;
 
-  m_setupParameters.srb1SapProvider->TransmitPdcpSdu (transmitPdcpSduParameters);
+  TransmitSrb1Sdu (transmitPdcpSduParameters);
 }
 
 void 
@@ -228,7 +283,7 @@ LteUeRrcProtocolReal::DoSendNotifySecondaryCellConnected (uint16_t mmWaveRnti, u
   transmitPdcpSduParameters.rnti = m_rnti;
   transmitPdcpSduParameters.lcid = 1;
 
-  m_setupParameters.srb1SapProvider->TransmitPdcpSdu (transmitPdcpSduParameters);
+  TransmitSrb1Sdu (transmitPdcpSduParameters);
 }
 
 
@@ -247,12 +302,15 @@ LteUeRrcProtocolReal::DoSendRrcConnectionReestablishmentRequest (LteRrcSap::RrcC
   transmitPdcpPduParameters.rnti = m_rnti;
   transmitPdcpPduParameters.lcid = 0;
 
+  m_txSrbPduTrace (m_rrc->GetImsi (), m_rrc->GetCellId (), m_rnti, packet->GetSize (), 1);
   m_setupParameters.srb0SapProvider->TransmitPdcpPdu (transmitPdcpPduParameters);
 }
 
 void 
 LteUeRrcProtocolReal::DoSendRrcConnectionReestablishmentComplete (LteRrcSap::RrcConnectionReestablishmentComplete msg)
 {
+  m_measReportCodec.Clear ();
+
   Ptr<Packet> packet = Create<Packet> ();
 
   RrcConnectionReestablishmentCompleteHeader rrcConnectionReestablishmentCompleteHeader;
@@ -265,9 +323,74 @@ LteUeRrcProtocolReal::DoSendRrcConnectionReestablishmentComplete (LteRrcSap::Rrc
   transmitPdcpSduParameters.rnti = m_rnti;
   transmitPdcpSduParameters.lcid = 1;
 
-  m_setupParameters.srb1SapProvider->TransmitPdcpSdu (transmitPdcpSduParameters);
+  TransmitSrb1Sdu (transmitPdcpSduParameters);
 }
 
+void
+LteUeRrcProtocolReal::TransmitSrb1Sdu (LtePdcpSapProvider::TransmitPdcpSduParameters params)
+{
+  if (m_setupParameters.srb1SapProvider == 0)
+    {
+      return;
+    }
+  if (!m_coalesceMessages)
+    {
+      m_txSrbPduTrace (m_rrc->GetImsi (), m_rrc->GetCellId (), params.rnti, params.pdcpSdu->GetSize (), 1);
+      m_setupParameters.srb1SapProvider->TransmitPdcpSdu (params);
+      return;
+    }
+
+  // messages of different RNTIs are not mixed
+  if (!m_pendingSrb1Sdus.empty () && m_pendingSrb1Sdus.front ().rnti != params.rnti)
+    {
+      FlushSrb1Sdus ();
+    }
+  m_pendingSrb1Sdus.push_back (params);
+  if (m_pendingSrb1Sdus.size () == MAX_COALESCED_SRB1_SDUS)
+    {
+      FlushSrb1Sdus ();
+    }
+  else if (!m_flushSrb1Event.IsRunning ())
+    {
+      // the TTIs start at multiples of the TTI duration
+      int64_t ttiNs = m_ttiDuration.GetNanoSeconds ();
+      Time untilTtiEnd = NanoSeconds (ttiNs - Simulator::Now ().GetNanoSeconds () % ttiNs);
+      m_flushSrb1Event = Simulator::Schedule (untilTtiEnd, &LteUeRrcProtocolReal::FlushSrb1Sdus, this);
+    }
+}
+
+void
+LteUeRrcProtocolReal::FlushSrb1Sdus ()
+{
+  m_flushSrb1Event.Cancel ();
+  if (m_pendingSrb1Sdus.empty ())
+    {
+      return;
+    }
+
+  LtePdcpSapProvider::TransmitPdcpSduParameters params = m_pendingSrb1Sdus.front ();
+  uint32_t nMessages = m_pendingSrb1Sdus.size ();
+  if (nMessages > 1)
+    {
+      Ptr<Packet> packet = Create<Packet> ();
+      std::vector<uint16_t> sizes;
+      for (std::vector<LtePdcpSapProvider::TransmitPdcpSduParameters>::const_iterator it = m_pendingSrb1Sdus.begin ();
+           it != m_pendingSrb1Sdus.end (); ++it)
+        {
+          sizes.push_back (it->pdcpSdu->GetSize ());
+          packet->AddAtEnd (it->pdcpSdu);
+        }
+      RrcCoalescedMessagesHeader rrcCoalescedMessagesHeader;
+      rrcCoalescedMessagesHeader.SetMessageSizes (sizes);
+      packet->AddHeader (rrcCoalescedMessagesHeader);
+      params.pdcpSdu = packet;
+    }
+  m_pendingSrb1Sdus.clear ();
+
+  NS_LOG_LOGIC ("Rnti " << params.rnti << " sends " << nMessages << " RRC messages in " << params.pdcpSdu->GetSize () << " bytes");
+  m_txSrbPduTrace (m_rrc->GetImsi (), m_rrc->GetCellId (), params.rnti, params.pdcpSdu->GetSize (), nMessages);
+  m_setupParameters.srb1SapProvider->TransmitPdcpSdu (params);
+}
 
 void 
 LteUeRrcProtocolReal::SetEnbRrcSapProvider ()
@@ -523,6 +646,7 @@ LteEnbRrcProtocolReal::DoSetupUe (uint16_t rnti, LteEnbRrcSapUser::SetupUeParame
   // ue upon connection request or connection reconfiguration
   // completed 
   m_enbRrcSapProviderMap[rnti] = 0;
+  m_measReportCodec.RemoveUe (rnti);
 
   // Store SetupUeParameters
   m_setupUeParametersMap[rnti] = params;
@@ -559,6 +683,7 @@ LteEnbRrcProtocolReal::DoRemoveUe (uint16_t rnti)
   m_completeSetupUeParametersMap.erase (it);
   m_enbRrcSapProviderMap.erase (rnti);
   m_setupUeParametersMap.erase (rnti);
+  m_measReportCodec.RemoveUe (rnti);
 }
 
 void 
@@ -798,8 +923,11 @@ LteEnbRrcProtocolReal::DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameter
   switch ( rrcUlDcchMessage.GetMessageType () )
     {
     case 1:
+    case 7:
       params.pdcpSdu->RemoveHeader (measurementReportHeader);
       measurementReportMsg = measurementReportHeader.GetMessage ();
+      // a delta report without reference is passed on with the changed cells only
+      m_measReportCodec.Decode (params.rnti, measurementReportMsg, measurementReportHeader.IsDelta ());
       m_enbRrcSapProvider->RecvMeasurementReport (params.rnti,measurementReportMsg);
       break;
     case 2:
@@ -817,6 +945,22 @@ LteEnbRrcProtocolReal::DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameter
       rrcConnectionSetupCompletedMsg = rrcConnectionSetupCompleteHeader.GetMessage ();
       m_enbRrcSapProvider->RecvRrcConnectionSetupCompleted (params.rnti, rrcConnectionSetupCompletedMsg);
       break;
+    case 6:
+      {
+        // split the coalesced messages and receive them in order
+        RrcCoalescedMessagesHeader rrcCoalescedMessagesHeader;
+        params.pdcpSdu->RemoveHeader (rrcCoalescedMessagesHeader);
+        std::vector<uint16_t> sizes = rrcCoalescedMessagesHeader.GetMessageSizes ();
+        uint32_t offset = 0;
+        for (std::vector<uint16_t>::const_iterator it = sizes.begin (); it != sizes.end (); ++it)
+          {
+            LtePdcpSapUser::ReceivePdcpSduParameters messageParams = params;
+            messageParams.pdcpSdu = params.pdcpSdu->CreateFragment (offset, *it);
+            offset += *it;
+            DoReceivePdcpSdu (messageParams);
+          }
+      }
+      break;
     case 5:
       params.pdcpSdu->RemoveHeader (rrcNotifyHeader);
       std::pair<uint16_t, uint16_t> rrcNotifyPair;
@@ -28,6 +28,9 @@
 #include "ns3/lte-pdcp-sap.h"
 #include "ns3/lte-pdcp-tag.h"
 #include "ns3/epc-x2-sap.h"
+#include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
 #include <ctime>
 
 namespace ns3 {
@@ -134,6 +137,9 @@ McEnbPdcp::McEnbPdcp ()
   m_isLteMmWaveDC = false;
   RequestAssistantInfoLTE = false;
   m_isEnableDuplicate = false;
+  m_duplicatedBytes = 0;
+  m_duplicateWastedBytes = 0;
+  m_duplicateSavedBytes = 0;
   //RequestAssistantInfoMmWave = false;
 }
 void
@@ -230,6 +236,18 @@ McEnbPdcp::GetTypeId (void)
 	.AddAttribute("enableLteMmWaveDC", "this value means if Lte - mmWave DC is enable or not", BooleanValue(false),
 			MakeBooleanAccessor(&McEnbPdcp::m_isLteMmWaveDC),
 			MakeBooleanChecker())
+    .AddAttribute ("SplitPolicyType",
+                   "TypeId of the SplitBearerPolicy created for each bearer "
+                   "(e.g., ns3::DelayEqualizingSplitPolicy). If empty, "
+                   "numberOfAlgorithm selects one of the legacy algorithms.",
+                   StringValue (""),
+                   MakeStringAccessor (&McEnbPdcp::m_splitPolicyType),
+                   MakeStringChecker ())
+    .AddAttribute ("SplitPolicy",
+                   "The SplitBearerPolicy of this bearer",
+                   PointerValue (),
+                   MakePointerAccessor (&McEnbPdcp::m_splitPolicy),
+                   MakePointerChecker<SplitBearerPolicy> ())
     .AddTraceSource ("TxPDU",
                      "PDU transmission notified to the RLC.",
                      MakeTraceSourceAccessor (&McEnbPdcp::m_txPdu),
@@ -238,6 +256,14 @@ McEnbPdcp::GetTypeId (void)
                      "PDU received.",
                      MakeTraceSourceAccessor (&McEnbPdcp::m_rxPdu),
                      "ns3::McEnbPdcp::PduRxTracedCallback")
+    .AddTraceSource ("AssistantInfoRx",
+                     "Assistant information received from the RLC of a leg.",
+                     MakeTraceSourceAccessor (&McEnbPdcp::m_assistantInfoRx),
+                     "ns3::McEnbPdcp::AssistantInfoRxTracedCallback")
+    .AddTraceSource ("DuplicateDiscard",
+                     "Discard of duplicated PDCP SDUs requested to the RLC of a leg.",
+                     MakeTraceSourceAccessor (&McEnbPdcp::m_duplicateDiscard),
+                     "ns3::McEnbPdcp::DuplicateDiscardTracedCallback")
     ;
   return tid;
 }
@@ -249,6 +275,7 @@ McEnbPdcp::DoDispose ()
   delete (m_pdcpSapProvider);
   delete (m_rlcSapUser);
   delete (m_epcX2PdcpUser);
+  m_splitPolicy = 0;
 }
 
 void
@@ -405,7 +432,7 @@ McEnbPdcp::DoTransmitPdcpSdu (Ptr<Packet> p)
     		    							RequestAssistantInfoLTE = true; //sjkang
     		    						}
 
-    		if (splitingAlgorithm() == lteCellId ){
+    		if (splitingAlgorithm (p->GetSize () + pdcpHeader.GetSerializedSize ()) == lteCellId ){
     				  p->AddHeader (pdcpHeader);
     			    PdcpTag pdcpTag (Simulator::Now ());
     			    p->AddByteTag (pdcpTag);
@@ -440,8 +467,22 @@ McEnbPdcp::DoTransmitPdcpSdu (Ptr<Packet> p)
     			    	 m_ueDataParams.targetCellId = targetCellId_1;
     			    	 m_ueDataParams_copy.targetCellId = targetCellId_2;
     			    		params.pdcpPdu = p;
+    			    	 RecordDuplicate (pdcpHeader.GetSequenceNumber (), p->GetSize ());
     			    	   if (targetCellId_1 == lteCellId or targetCellId_2 == lteCellId)
-    			    	    		  m_rlcSapProvider->TransmitPdcpPdu (params);
+    			    	     {
+    			    	       // the LTE leg is served by the local RLC, the other one over X2
+    			    	       if (!RequestAssistantInfoLTE)
+    			    	         {
+    			    	           m_rlcSapProvider->RequestAssistantInfo ();
+    			    	           RequestAssistantInfoLTE = true;
+    			    	         }
+    			    	       m_rlcSapProvider->TransmitPdcpPdu (params);
+    			    	       if (targetCellId_1 != targetCellId_2)
+    			    	         {
+    			    	           m_ueDataParams_copy.targetCellId = (targetCellId_1 == lteCellId) ? targetCellId_2 : targetCellId_1;
+    			    	           m_epcX2PdcpProvider->SendMcPdcpPdu (m_ueDataParams_copy);
+    			    	         }
+    			    	     }
     			    	  else{
 
     			    	 m_epcX2PdcpProvider->SendMcPdcpPdu(m_ueDataParams);
@@ -449,7 +490,7 @@ McEnbPdcp::DoTransmitPdcpSdu (Ptr<Packet> p)
     			    	  }
 
     			}else{
-    					uint16_t Cellid = splitingAlgorithm();
+    					uint16_t Cellid = splitingAlgorithm (p->GetSize () + pdcpHeader.GetSerializedSize ());
 
     					m_ueDataParams.targetCellId = Cellid;
     				//	std::cout<<Simulator::Now().GetSeconds()<<"\t"<<Cellid << std::endl;
@@ -567,13 +608,40 @@ McEnbPdcp::GetUseMmWaveConnection() const
   return m_useMmWaveConnection && (m_epcX2PdcpProvider != 0);
 }
 
+void
+McEnbPdcp::SetSplitPolicy (Ptr<SplitBearerPolicy> policy)
+{
+  NS_LOG_FUNCTION (this << policy);
+  m_splitPolicy = policy;
+}
+
+Ptr<SplitBearerPolicy>
+McEnbPdcp::GetSplitPolicy ()
+{
+  if (m_splitPolicy == 0 && !m_splitPolicyType.empty ())
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (m_splitPolicyType);
+      m_splitPolicy = factory.Create<SplitBearerPolicy> ();
+      NS_LOG_INFO ("Created split policy " << m_splitPolicyType << " for lcid " << (uint32_t) m_lcid);
+    }
+  return m_splitPolicy;
+}
+
 
 void
 McEnbPdcp::UpdateEta(){
 
 }
 uint16_t
-McEnbPdcp::splitingAlgorithm(){
+McEnbPdcp::splitingAlgorithm (uint32_t pduSize){
+
+Ptr<SplitBearerPolicy> policy = GetSplitPolicy ();
+if (policy != 0)
+  {
+    policy->SetLegs (targetCellId_1, targetCellId_2);
+    return policy->SelectCell (pduSize);
+  }
 
 switch(m_isSplitting){
 case 0:
@@ -694,6 +762,12 @@ McEnbPdcp::DoReceiveAssistantInformation(EpcX2Sap::AssistantInformationForSplitt
 	//q_Delay[info.sourceCellId] =(double) (info.Txed_Q_Delay+info.Tx_On_Q_Delay+info.Re_Tx_Q_Delay)/10e6;
 	double alpha=0.9;
 	q_Delay[info.sourceCellId] =(1-alpha)*(double) (info.Tx_On_Q_Delay)/10e3 + alpha*q_Delay[info.sourceCellId];
+	if (GetSplitPolicy () != 0)
+	  {
+	    m_splitPolicy->ReportAssistantInfo (info.sourceCellId, info);
+	  }
+	m_assistantInfoRx (info.sourceCellId, Simulator::Now ().GetNanoSeconds () - info.Report_Time);
+	ProcessDeliveredSns (info.sourceCellId, info.Delivered_Pdcp_Sn);
 //std::cout <<info.Re_TX_Q_Size <<std::endl;
 	//std::cout<<"mmWave received-->" <<info.Tx_On_Q_Delay<<std::endl;;
 	//std::cout << "MmWave : "<<info.Tx_On_Q_Delay << "\t"<< info.Re_Tx_Q_Delay << info.Txed_Q_Delay <<std::endl;
@@ -706,9 +780,105 @@ McEnbPdcp::DoReceiveLteAssistantInfo(EpcX2Sap::AssistantInformationForSplitting
 	//q_Delay[lteCellId] =(double) (info.Txed_Q_Delay+info.Tx_On_Q_Delay+info.Re_Tx_Q_Delay)/10e6;
 	double alpha = 0.9;
 	q_Delay[lteCellId]=(1-alpha)*(double) (info.Tx_On_Q_Delay)/10e3 + alpha* q_Delay[lteCellId];
+	if (GetSplitPolicy () != 0)
+	  {
+	    m_splitPolicy->ReportAssistantInfo (lteCellId, info);
+	  }
+	m_assistantInfoRx (lteCellId, Simulator::Now ().GetNanoSeconds () - info.Report_Time);
+	ProcessDeliveredSns (lteCellId, info.Delivered_Pdcp_Sn);
 
 //	std::cout << "lte received -->"<<q_Delay[lteCellId]<<std::endl;;
    // std::cout << "LTE : "<<info.Tx_On_Q_Delay << "\t"<< info.Re_Tx_Q_Delay <<"\t"<< info.Txed_Q_Delay <<std::endl;
 }
 
+void
+McEnbPdcp::RecordDuplicate (uint16_t sn, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << sn << size);
+  std::map<uint16_t, DuplicateInfo>::iterator it = m_duplicates.find (sn);
+  if (it != m_duplicates.end () && it->second.deliveredCellId != 0)
+    {
+      // the SN is reused and the second copy of the previous SDU never
+      // showed up: it was discarded before using the air interface
+      m_duplicateSavedBytes += it->second.size;
+    }
+  DuplicateInfo info;
+  info.size = size;
+  info.deliveredCellId = 0;
+  m_duplicates[sn] = info;
+  m_duplicatedBytes += size;
+}
+
+void
+McEnbPdcp::ProcessDeliveredSns (uint16_t cellId, const std::vector<uint16_t> &sns)
+{
+  if (sns.empty () || m_duplicates.empty ()
+      || (cellId != targetCellId_1 && cellId != targetCellId_2))
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << cellId << sns.size ());
+  std::map<uint16_t, std::vector<uint16_t> > discard;
+  for (std::vector<uint16_t>::const_iterator snIt = sns.begin (); snIt != sns.end (); ++snIt)
+    {
+      std::map<uint16_t, DuplicateInfo>::iterator it = m_duplicates.find (*snIt);
+      if (it == m_duplicates.end ())
+        {
+          continue;
+        }
+      if (it->second.deliveredCellId == 0)
+        {
+          it->second.deliveredCellId = cellId;
+          uint16_t otherCellId = (cellId == targetCellId_1) ? targetCellId_2 : targetCellId_1;
+          if (otherCellId != cellId)
+            {
+              discard[otherCellId].push_back (*snIt);
+            }
+        }
+      else if (it->second.deliveredCellId != cellId)
+        {
+          // both copies used the air interface
+          m_duplicateWastedBytes += it->second.size;
+          m_duplicates.erase (it);
+        }
+    }
+
+  for (std::map<uint16_t, std::vector<uint16_t> >::iterator it = discard.begin (); it != discard.end (); ++it)
+    {
+      NS_LOG_INFO ("Discard " << it->second.size () << " duplicated PDCP SDUs on cell " << it->first);
+      m_duplicateDiscard (it->first, it->second.size ());
+      if (it->first == lteCellId)
+        {
+          m_rlcSapProvider->DiscardPdcpSdus (it->second);
+        }
+      else if (m_epcX2PdcpProvider != 0)
+        {
+          EpcX2Sap::DiscardPdcpSduParams params;
+          params.sourceCellId = m_ueDataParams.sourceCellId;
+          params.targetCellId = it->first;
+          params.gtpTeid = m_ueDataParams.gtpTeid;
+          params.pdcpSns = it->second;
+          m_epcX2PdcpProvider->DiscardMcPdcpSdus (params);
+        }
+    }
+}
+
+uint64_t
+McEnbPdcp::GetDuplicatedBytes () const
+{
+  return m_duplicatedBytes;
+}
+
+uint64_t
+McEnbPdcp::GetDuplicateWastedBytes () const
+{
+  return m_duplicateWastedBytes;
+}
+
+uint64_t
+McEnbPdcp::GetDuplicateSavedBytes () const
+{
+  return m_duplicateSavedBytes;
+}
+
 } // namespace ns3
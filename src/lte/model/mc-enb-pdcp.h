@@ -33,6 +33,7 @@
 #include <ns3/lte-pdcp-sap.h>
 #include <ns3/lte-rlc-sap.h>
 #include <ns3/lte-pdcp.h>
+#include <ns3/split-bearer-policy.h>
 #include <fstream>
 namespace ns3 {
 
@@ -178,6 +179,15 @@ public:
     (const uint16_t rnti, const uint8_t lcid,
      const uint32_t size, const uint64_t delay);
 
+  /**
+   * TracedCallback signature for assistant information reception.
+   *
+   * \param [in] cellId The cell the report refers to.
+   * \param [in] staleness Time since the report was sent by the RLC, in ns.
+   */
+  typedef void (* AssistantInfoRxTracedCallback)
+    (uint16_t cellId, uint64_t staleness);
+
   /**
    * Switch between LTE and MmWave
    */
@@ -191,9 +201,58 @@ public:
   uint16_t GetTargetCellId_1(); //sjkang
   uint16_t GetTargetCellId_2(); //sjkang
   virtual void DoReceiveAssistantInformation (EpcX2Sap::AssistantInformationForSplitting info); //sjkang1114
-  uint16_t splitingAlgorithm();
+
+  /**
+   * Select the cell on which the next PDU is transmitted. The SplitBearerPolicy
+   * of this bearer is used if one is configured, otherwise the legacy
+   * algorithm given by numberOfAlgorithm.
+   *
+   * \param pduSize the size of the PDU, in bytes
+   * \return the cell id of the selected leg
+   */
+  uint16_t splitingAlgorithm (uint32_t pduSize);
+
+  /**
+   * Set the policy used to split this bearer
+   *
+   * \param policy the policy, or 0 to use the legacy algorithms
+   */
+  void SetSplitPolicy (Ptr<SplitBearerPolicy> policy);
+
+  /**
+   * \return the policy used to split this bearer, created from
+   * SplitPolicyType on first use, or 0 if the legacy algorithms are used
+   */
+  Ptr<SplitBearerPolicy> GetSplitPolicy ();
  void DoReceiveLteAssistantInfo(EpcX2Sap::AssistantInformationForSplitting info); //sjkang
  void SetPacketDuplicateMode (bool) ; //sjkang
+
+  /**
+   * \return the bytes of the PDCP PDUs sent on both legs in duplicate mode
+   */
+  uint64_t GetDuplicatedBytes () const;
+
+  /**
+   * \return the bytes of the duplicated PDUs delivered on both legs, i.e.,
+   * the air interface wasted by the duplication
+   */
+  uint64_t GetDuplicateWastedBytes () const;
+
+  /**
+   * \return the bytes of the duplicated PDUs delivered on one leg only after
+   * the discard was requested on the other one, i.e., the air interface
+   * saved by the discard. A PDU is counted when its SN is reused.
+   */
+  uint64_t GetDuplicateSavedBytes () const;
+
+  /**
+   * TracedCallback signature for the discard of duplicated PDUs.
+   *
+   * \param [in] cellId The cell of the leg asked to discard.
+   * \param [in] numSn Number of PDCP SNs to discard.
+   */
+  typedef void (* DuplicateDiscardTracedCallback)
+    (uint16_t cellId, uint32_t numSn);
 protected:
   // Interface provided to upper RRC entity
   virtual void DoTransmitPdcpSdu (Ptr<Packet> p);
@@ -223,6 +282,16 @@ protected:
    * The parameters are RNTI, LCID, bytes delivered and delivery delay in nanoseconds. 
    */
   TracedCallback<uint16_t, uint8_t, uint32_t, uint64_t> m_rxPdu;
+  /**
+   * Used to inform of the reception of assistant information.
+   * The parameters are the cell id and the staleness of the report in nanoseconds.
+   */
+  TracedCallback<uint16_t, uint64_t> m_assistantInfoRx;
+  /**
+   * Used to inform of the discard of duplicated PDUs on one leg.
+   * The parameters are the cell id of the leg and the number of SNs.
+   */
+  TracedCallback<uint16_t, uint32_t> m_duplicateDiscard;
 
   // Interface provided to EpcX2 entity
   virtual void DoReceiveMcPdcpPdu(EpcX2Sap::UeDataParams params);
@@ -265,6 +334,32 @@ private:
   bool m_isLteMmWaveDC;
   bool RequestAssistantInfoLTE;
   bool m_isEnableDuplicate;
+
+  std::string m_splitPolicyType;
+  Ptr<SplitBearerPolicy> m_splitPolicy;
+
+  /**
+   * Start tracking a PDU sent on both legs
+   */
+  void RecordDuplicate (uint16_t sn, uint32_t size);
+
+  /**
+   * Ask the other leg to discard the duplicated PDUs delivered by a leg
+   *
+   * \param cellId the cell of the leg which delivered the PDUs
+   * \param sns the delivered PDCP SNs
+   */
+  void ProcessDeliveredSns (uint16_t cellId, const std::vector<uint16_t> &sns);
+
+  struct DuplicateInfo
+  {
+    uint32_t size;
+    uint16_t deliveredCellId;  ///< leg which delivered the PDU first, 0 if none
+  };
+  std::map<uint16_t, DuplicateInfo> m_duplicates;  ///< duplicated PDUs by PDCP SN
+  uint64_t m_duplicatedBytes;
+  uint64_t m_duplicateWastedBytes;
+  uint64_t m_duplicateSavedBytes;
 };
 
 
@@ -0,0 +1,176 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "measurement-report-delta-codec.h"
+
+#include <ns3/log.h>
+#include <cstdlib>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MeasurementReportDeltaCodec");
+
+MeasurementReportDeltaCodec::MeasurementReportDeltaCodec ()
+  : m_hysteresis (2)
+{
+}
+
+void
+MeasurementReportDeltaCodec::SetHysteresis (uint8_t hysteresis)
+{
+  NS_LOG_FUNCTION (this << (uint16_t) hysteresis);
+  m_hysteresis = hysteresis;
+}
+
+uint8_t
+MeasurementReportDeltaCodec::GetHysteresis () const
+{
+  return m_hysteresis;
+}
+
+bool
+MeasurementReportDeltaCodec::Encode (uint16_t rnti, LteRrcSap::MeasurementReport &report)
+{
+  LteRrcSap::MeasResults &measResults = report.measResults;
+  std::pair<uint16_t, uint8_t> key (rnti, measResults.measId);
+  CellListMap::iterator it = m_cells.find (key);
+
+  // a delta report is possible only for the same cells in the same order
+  bool sameCells = it != m_cells.end () && measResults.haveMeasResultNeighCells
+    && measResults.measResultListEutra.size () == it->second.size ();
+  if (sameCells)
+    {
+      CellList::const_iterator refIt = it->second.begin ();
+      for (std::list<LteRrcSap::MeasResultEutra>::const_iterator cellIt = measResults.measResultListEutra.begin ();
+           cellIt != measResults.measResultListEutra.end (); ++cellIt, ++refIt)
+        {
+          if (cellIt->physCellId != refIt->physCellId)
+            {
+              sameCells = false;
+              break;
+            }
+        }
+    }
+  if (!sameCells)
+    {
+      StoreFull (key, measResults);
+      return false;
+    }
+
+  std::list<LteRrcSap::MeasResultEutra> changed;
+  CellList::iterator refIt = it->second.begin ();
+  for (std::list<LteRrcSap::MeasResultEutra>::const_iterator cellIt = measResults.measResultListEutra.begin ();
+       cellIt != measResults.measResultListEutra.end (); ++cellIt, ++refIt)
+    {
+      if (cellIt->haveCgiInfo || IsChanged (*refIt, *cellIt))
+        {
+          changed.push_back (*cellIt);
+          *refIt = *cellIt;
+        }
+    }
+  NS_LOG_LOGIC ("Rnti " << rnti << " measId " << (uint16_t) measResults.measId << " delta report with "
+                        << changed.size () << " of " << it->second.size () << " cells");
+  measResults.measResultListEutra = changed;
+  measResults.haveMeasResultNeighCells = !changed.empty ();
+  return true;
+}
+
+bool
+MeasurementReportDeltaCodec::Decode (uint16_t rnti, LteRrcSap::MeasurementReport &report, bool delta)
+{
+  LteRrcSap::MeasResults &measResults = report.measResults;
+  std::pair<uint16_t, uint8_t> key (rnti, measResults.measId);
+  if (!delta)
+    {
+      StoreFull (key, measResults);
+      return true;
+    }
+
+  CellListMap::iterator it = m_cells.find (key);
+  if (it == m_cells.end ())
+    {
+      NS_LOG_WARN ("Rnti " << rnti << " measId " << (uint16_t) measResults.measId << " delta report without reference");
+      return false;
+    }
+  for (std::list<LteRrcSap::MeasResultEutra>::const_iterator cellIt = measResults.measResultListEutra.begin ();
+       cellIt != measResults.measResultListEutra.end (); ++cellIt)
+    {
+      CellList::iterator refIt = it->second.begin ();
+      while (refIt != it->second.end () && refIt->physCellId != cellIt->physCellId)
+        {
+          ++refIt;
+        }
+      if (refIt == it->second.end ())
+        {
+          NS_LOG_WARN ("Rnti " << rnti << " delta report for the unknown cell " << cellIt->physCellId);
+          continue;
+        }
+      *refIt = *cellIt;
+    }
+  measResults.measResultListEutra.assign (it->second.begin (), it->second.end ());
+  measResults.haveMeasResultNeighCells = true;
+  return true;
+}
+
+void
+MeasurementReportDeltaCodec::RemoveUe (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  CellListMap::iterator it = m_cells.lower_bound (std::make_pair (rnti, (uint8_t) 0));
+  while (it != m_cells.end () && it->first.first == rnti)
+    {
+      m_cells.erase (it++);
+    }
+}
+
+void
+MeasurementReportDeltaCodec::Clear ()
+{
+  m_cells.clear ();
+}
+
+void
+MeasurementReportDeltaCodec::StoreFull (std::pair<uint16_t, uint8_t> key, const LteRrcSap::MeasResults &measResults)
+{
+  if (measResults.haveMeasResultNeighCells && !measResults.measResultListEutra.empty ())
+    {
+      m_cells[key].assign (measResults.measResultListEutra.begin (), measResults.measResultListEutra.end ());
+    }
+  else
+    {
+      m_cells.erase (key);
+    }
+}
+
+bool
+MeasurementReportDeltaCodec::IsChanged (const LteRrcSap::MeasResultEutra &reference, const LteRrcSap::MeasResultEutra &result) const
+{
+  if (reference.haveRsrpResult != result.haveRsrpResult || reference.haveRsrqResult != result.haveRsrqResult)
+    {
+      return true;
+    }
+  if (result.haveRsrpResult && std::abs ((int) result.rsrpResult - (int) reference.rsrpResult) > m_hysteresis)
+    {
+      return true;
+    }
+  if (result.haveRsrqResult && std::abs ((int) result.rsrqResult - (int) reference.rsrqResult) > m_hysteresis)
+    {
+      return true;
+    }
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEASUREMENT_REPORT_DELTA_CODEC_H
+#define MEASUREMENT_REPORT_DELTA_CODEC_H
+
+#include <ns3/lte-rrc-sap.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Delta encoding of the neighbour cells of the measurement reports.
+ *
+ * The UE and the eNB each keep the neighbour cell results last known to
+ * the eNB, for every RNTI and measId. When a new report lists the same
+ * cells in the same order, the UE sends a delta report with only the
+ * cells whose RSRP or RSRQ moved by more than the hysteresis, and the eNB
+ * restores the other cells from its copy. Any other report is sent in full
+ * and replaces the copies.
+ */
+class MeasurementReportDeltaCodec
+{
+public:
+  MeasurementReportDeltaCodec ();
+
+  /**
+   * \param hysteresis the change of RSRP or RSRQ, in range units, above
+   *        which a cell is listed in a delta report
+   */
+  void SetHysteresis (uint8_t hysteresis);
+  /// \return the hysteresis in range units
+  uint8_t GetHysteresis () const;
+
+  /**
+   * UE side: turn the report into a delta report if possible
+   *
+   * \param rnti the RNTI of the UE
+   * \param report the report, whose neighbour cells are reduced to the
+   *        changed ones if a delta report is possible
+   * \return true if the report is now a delta report
+   */
+  bool Encode (uint16_t rnti, LteRrcSap::MeasurementReport &report);
+
+  /**
+   * eNB side: restore the full list of neighbour cells of a report
+   *
+   * \param rnti the RNTI of the UE
+   * \param report the report received, completed in place
+   * \param delta true if the report was received as a delta report
+   * \return false if a delta report has no reference to restore it from
+   */
+  bool Decode (uint16_t rnti, LteRrcSap::MeasurementReport &report, bool delta);
+
+  /**
+   * Remove the reference results of a UE
+   * \param rnti the RNTI of the UE
+   */
+  void RemoveUe (uint16_t rnti);
+
+  /**
+   * Remove all the reference results
+   */
+  void Clear ();
+
+private:
+  typedef std::vector<LteRrcSap::MeasResultEutra> CellList;
+  typedef std::map<std::pair<uint16_t, uint8_t>, CellList> CellListMap;
+
+  /**
+   * Store the neighbour cells of a full report as the reference
+   * \param key the RNTI and measId
+   * \param measResults the results of the report
+   */
+  void StoreFull (std::pair<uint16_t, uint8_t> key, const LteRrcSap::MeasResults &measResults);
+
+  /**
+   * \param reference the result known to the eNB
+   * \param result the new result of the same cell
+   * \return true if the new result must be sent
+   */
+  bool IsChanged (const LteRrcSap::MeasResultEutra &reference, const LteRrcSap::MeasResultEutra &result) const;
+
+  uint8_t m_hysteresis;    ///< change in range units that must be reported
+  CellListMap m_cells;     ///< reference neighbour cells of each (RNTI, measId)
+};
+
+} // namespace ns3
+
+#endif // MEASUREMENT_REPORT_DELTA_CODEC_H
@@ -0,0 +1,159 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "sinr-trajectory-predictor.h"
+
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SinrTrajectoryPredictor");
+
+SinrTrajectoryPredictor::SinrTrajectoryPredictor ()
+  : m_historyLength (16),
+    m_maxSampleAgeNs (0)
+{
+}
+
+void
+SinrTrajectoryPredictor::SetHistoryLength (uint32_t length)
+{
+  NS_LOG_FUNCTION (this << length);
+  NS_ASSERT_MSG (length >= 2, "a trajectory needs at least 2 samples");
+  m_historyLength = length;
+  m_histories.clear ();
+}
+
+uint32_t
+SinrTrajectoryPredictor::GetHistoryLength () const
+{
+  return m_historyLength;
+}
+
+void
+SinrTrajectoryPredictor::SetMaxSampleAge (Time maxAge)
+{
+  NS_LOG_FUNCTION (this << maxAge);
+  m_maxSampleAgeNs = maxAge.GetNanoSeconds ();
+}
+
+Time
+SinrTrajectoryPredictor::GetMaxSampleAge () const
+{
+  return NanoSeconds (m_maxSampleAgeNs);
+}
+
+void
+SinrTrajectoryPredictor::AddSample (uint64_t imsi, uint16_t cellId, Time t, double sinrDb)
+{
+  NS_LOG_FUNCTION (this << imsi << cellId << t << sinrDb);
+  History &history = m_histories[std::make_pair (imsi, cellId)];
+  if (history.timeNs.size () < m_historyLength)
+    {
+      NS_ASSERT (history.timeNs.empty () || history.timeNs.back () <= t.GetNanoSeconds ());
+      history.timeNs.push_back (t.GetNanoSeconds ());
+      history.sinrDb.push_back (sinrDb);
+      history.next = history.timeNs.size () % m_historyLength;
+    }
+  else
+    {
+      history.timeNs[history.next] = t.GetNanoSeconds ();
+      history.sinrDb[history.next] = sinrDb;
+      history.next = (history.next + 1) % m_historyLength;
+    }
+}
+
+bool
+SinrTrajectoryPredictor::Predict (uint64_t imsi, uint16_t cellId, Time t, double &sinrDb) const
+{
+  HistoryMap::const_iterator it = m_histories.find (std::make_pair (imsi, cellId));
+  if (it == m_histories.end () || it->second.timeNs.size () < 2)
+    {
+      return false;
+    }
+  const History &history = it->second;
+  int64_t minTimeNs = m_maxSampleAgeNs > 0 ? t.GetNanoSeconds () - m_maxSampleAgeNs : std::numeric_limits<int64_t>::min ();
+
+  // times relative to the first sample, in seconds, to keep the sums small
+  int64_t t0 = history.timeNs[history.next % history.timeNs.size ()];
+  uint32_t n = 0;
+  double meanT = 0;
+  double meanSinr = 0;
+  for (uint32_t i = 0; i < history.timeNs.size (); ++i)
+    {
+      if (history.timeNs[i] >= minTimeNs)
+        {
+          meanT += (history.timeNs[i] - t0) / 1e9;
+          meanSinr += history.sinrDb[i];
+          ++n;
+        }
+    }
+  if (n < 2)
+    {
+      NS_LOG_LOGIC ("Imsi " << imsi << " cell " << cellId << " has " << n << " recent samples");
+      return false;
+    }
+  meanT /= n;
+  meanSinr /= n;
+
+  double sxx = 0;
+  double sxy = 0;
+  for (uint32_t i = 0; i < history.timeNs.size (); ++i)
+    {
+      if (history.timeNs[i] >= minTimeNs)
+        {
+          double dt = (history.timeNs[i] - t0) / 1e9 - meanT;
+          sxx += dt * dt;
+          sxy += dt * (history.sinrDb[i] - meanSinr);
+        }
+    }
+  if (sxx <= 0)
+    {
+      return false;
+    }
+  double slope = sxy / sxx;
+  sinrDb = meanSinr + slope * ((t.GetNanoSeconds () - t0) / 1e9 - meanT);
+  NS_LOG_LOGIC ("Imsi " << imsi << " cell " << cellId << " slope " << slope << " dB/s, forecast " << sinrDb << " dB at " << t);
+  return true;
+}
+
+uint32_t
+SinrTrajectoryPredictor::GetNSamples (uint64_t imsi, uint16_t cellId) const
+{
+  HistoryMap::const_iterator it = m_histories.find (std::make_pair (imsi, cellId));
+  return it == m_histories.end () ? 0 : it->second.timeNs.size ();
+}
+
+void
+SinrTrajectoryPredictor::RemoveUe (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  HistoryMap::iterator it = m_histories.lower_bound (std::make_pair (imsi, (uint16_t) 0));
+  while (it != m_histories.end () && it->first.first == imsi)
+    {
+      m_histories.erase (it++);
+    }
+}
+
+void
+SinrTrajectoryPredictor::Clear ()
+{
+  m_histories.clear ();
+}
+
+} // namespace ns3
@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SINR_TRAJECTORY_PREDICTOR_H
+#define SINR_TRAJECTORY_PREDICTOR_H
+
+#include <ns3/nstime.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Short SINR history of every UE in every mmWave cell, used by the
+ * coordinator eNB to forecast the SINR a few tens of ms ahead.
+ *
+ * The last samples of each UE and cell are kept in a ring buffer of fixed
+ * length. The forecast is the least squares line through the samples not
+ * older than the maximum sample age, evaluated at the requested time.
+ */
+class SinrTrajectoryPredictor
+{
+public:
+  SinrTrajectoryPredictor ();
+
+  /**
+   * Set the number of samples kept for each UE and cell. The histories
+   * already stored are dropped.
+   *
+   * \param length the number of samples, at least 2
+   */
+  void SetHistoryLength (uint32_t length);
+  /// \return the number of samples kept for each UE and cell
+  uint32_t GetHistoryLength () const;
+
+  /**
+   * Set the maximum age of the samples used for a forecast, measured from
+   * the time of the forecast. Older samples are kept but ignored.
+   *
+   * \param maxAge the maximum age, zero for no limit
+   */
+  void SetMaxSampleAge (Time maxAge);
+  /// \return the maximum age of the samples used for a forecast
+  Time GetMaxSampleAge () const;
+
+  /**
+   * Store a sample, replacing the oldest one if the history is full
+   *
+   * \param imsi the IMSI
+   * \param cellId the cell
+   * \param t the time of the sample, not older than the previous one
+   * \param sinrDb the SINR in dB
+   */
+  void AddSample (uint64_t imsi, uint16_t cellId, Time t, double sinrDb);
+
+  /**
+   * \param imsi the IMSI
+   * \param cellId the cell
+   * \param t the time of the forecast
+   * \param sinrDb the forecast SINR in dB, if available
+   * \return false if the recent samples do not span two different times
+   */
+  bool Predict (uint64_t imsi, uint16_t cellId, Time t, double &sinrDb) const;
+
+  /**
+   * \param imsi the IMSI
+   * \param cellId the cell
+   * \return the number of samples stored
+   */
+  uint32_t GetNSamples (uint64_t imsi, uint16_t cellId) const;
+
+  /**
+   * Remove the histories of a UE in all the cells
+   * \param imsi the IMSI
+   */
+  void RemoveUe (uint64_t imsi);
+
+  /**
+   * Remove all the histories
+   */
+  void Clear ();
+
+private:
+  /// samples of a UE in a cell, oldest first starting at m_next once full
+  struct History
+  {
+    std::vector<int64_t> timeNs;  ///< time of each sample
+    std::vector<double> sinrDb;   ///< SINR of each sample
+    uint32_t next;                ///< position of the next sample
+  };
+
+  typedef std::map<std::pair<uint64_t, uint16_t>, History> HistoryMap;
+
+  uint32_t m_historyLength;  ///< samples kept per UE and cell
+  int64_t m_maxSampleAgeNs;  ///< age of the oldest sample used, 0 for no limit
+  HistoryMap m_histories;    ///< history of each (IMSI, cell ID)
+};
+
+} // namespace ns3
+
+#endif // SINR_TRAJECTORY_PREDICTOR_H
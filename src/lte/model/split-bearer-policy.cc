@@ -0,0 +1,329 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "split-bearer-policy.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/trace-source-accessor.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SplitBearerPolicy");
+
+NS_OBJECT_ENSURE_REGISTERED (SplitBearerPolicy);
+
+SplitBearerPolicy::SplitBearerPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+  ResetLeg (0, 0);
+  ResetLeg (1, 0);
+}
+
+SplitBearerPolicy::~SplitBearerPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+SplitBearerPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SplitBearerPolicy")
+    .SetParent<Object> ()
+    .SetGroupName("Lte")
+    .AddAttribute ("ThroughputAlpha",
+                   "Weight of the past estimate in the EWMA of the leg throughput",
+                   DoubleValue (0.9),
+                   MakeDoubleAccessor (&SplitBearerPolicy::m_alpha),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddTraceSource ("LegSelected",
+                     "A PDU has been assigned to a leg of the split bearer.",
+                     MakeTraceSourceAccessor (&SplitBearerPolicy::m_legSelectedTrace),
+                     "ns3::SplitBearerPolicy::LegSelectedTracedCallback")
+    ;
+  return tid;
+}
+
+void
+SplitBearerPolicy::ResetLeg (uint8_t leg, uint16_t cellId)
+{
+  m_legs[leg].cellId = cellId;
+  m_legs[leg].queueSize = 0;
+  m_legs[leg].retxQueueSize = 0;
+  m_legs[leg].holDelay = Seconds (0);
+  m_legs[leg].throughput = 0;
+  m_legs[leg].reported = false;
+  m_legs[leg].lastReport = Seconds (0);
+  m_legs[leg].bytesSinceReport = 0;
+  m_legs[leg].txBytes = 0;
+  m_credit[leg] = 0;
+}
+
+void
+SplitBearerPolicy::SetLegs (uint16_t cellId0, uint16_t cellId1)
+{
+  if (m_legs[0].cellId != cellId0)
+    {
+      NS_LOG_INFO ("Leg 0 moved from cell " << m_legs[0].cellId << " to " << cellId0);
+      ResetLeg (0, cellId0);
+    }
+  if (m_legs[1].cellId != cellId1)
+    {
+      NS_LOG_INFO ("Leg 1 moved from cell " << m_legs[1].cellId << " to " << cellId1);
+      ResetLeg (1, cellId1);
+    }
+}
+
+void
+SplitBearerPolicy::ReportAssistantInfo (uint16_t cellId, EpcX2Sap::AssistantInformationForSplitting info)
+{
+  uint8_t leg;
+  if (m_legs[0].cellId == cellId)
+    {
+      leg = 0;
+    }
+  else if (m_legs[1].cellId == cellId)
+    {
+      leg = 1;
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Report from cell " << cellId << " which serves no leg");
+      return;
+    }
+
+  LegInfo &l = m_legs[leg];
+  Time now = Simulator::Now ();
+  if (l.reported && now > l.lastReport)
+    {
+      // the bytes that left the queue are those queued at the last report,
+      // plus those sent since then, minus those still queued
+      double drained = (double) l.queueSize + l.bytesSinceReport - info.Tx_On_Q_Size;
+      if (drained < 0)
+        {
+          drained = 0;
+        }
+      double sample = drained / (now - l.lastReport).GetSeconds ();
+      if (l.throughput == 0)
+        {
+          l.throughput = sample;
+        }
+      else if (info.Tx_On_Q_Size > 0 || sample > l.throughput)
+        {
+          // an emptied queue only gives a lower bound of the leg rate
+          l.throughput = m_alpha * l.throughput + (1 - m_alpha) * sample;
+        }
+    }
+  l.queueSize = info.Tx_On_Q_Size;
+  l.retxQueueSize = info.Re_TX_Q_Size;
+  l.holDelay = MilliSeconds (info.Tx_On_Q_Delay);
+  l.bytesSinceReport = 0;
+  l.lastReport = now;
+  l.reported = true;
+  NS_LOG_LOGIC ("Cell " << cellId << " queue " << l.queueSize << " hol " << l.holDelay
+                << " throughput " << l.throughput);
+}
+
+uint16_t
+SplitBearerPolicy::SelectCell (uint32_t pduSize)
+{
+  uint8_t leg = DoSelectLeg (pduSize);
+  NS_ASSERT (leg < 2);
+  m_legs[leg].bytesSinceReport += pduSize;
+  m_legs[leg].txBytes += pduSize;
+  m_legSelectedTrace (m_legs[leg].cellId, pduSize);
+  return m_legs[leg].cellId;
+}
+
+const SplitBearerPolicy::LegInfo&
+SplitBearerPolicy::GetLegInfo (uint8_t leg) const
+{
+  NS_ASSERT (leg < 2);
+  return m_legs[leg];
+}
+
+uint8_t
+SplitBearerPolicy::SelectByShare (double share0, uint32_t pduSize)
+{
+  m_credit[0] += share0 * pduSize;
+  m_credit[1] += (1 - share0) * pduSize;
+  uint8_t leg = (m_credit[0] >= m_credit[1]) ? 0 : 1;
+  m_credit[leg] -= pduSize;
+  return leg;
+}
+
+uint32_t
+SplitBearerPolicy::GetBacklog (uint8_t leg) const
+{
+  return m_legs[leg].queueSize + m_legs[leg].bytesSinceReport;
+}
+
+
+////////////////////////////////////////
+// DelayEqualizingSplitPolicy
+////////////////////////////////////////
+
+NS_OBJECT_ENSURE_REGISTERED (DelayEqualizingSplitPolicy);
+
+DelayEqualizingSplitPolicy::DelayEqualizingSplitPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DelayEqualizingSplitPolicy::~DelayEqualizingSplitPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+DelayEqualizingSplitPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DelayEqualizingSplitPolicy")
+    .SetParent<SplitBearerPolicy> ()
+    .SetGroupName("Lte")
+    .AddConstructor<DelayEqualizingSplitPolicy> ()
+    .AddAttribute ("Leg1Offset",
+                   "Additional fixed delay of the second leg (e.g., the X2 latency "
+                   "when only the second leg is remote)",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&DelayEqualizingSplitPolicy::m_leg1Offset),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinThroughput",
+                   "Throughput assumed for a leg without an estimate, in bytes/s",
+                   DoubleValue (125000),
+                   MakeDoubleAccessor (&DelayEqualizingSplitPolicy::m_minThroughput),
+                   MakeDoubleChecker<double> (1.0))
+    ;
+  return tid;
+}
+
+Time
+DelayEqualizingSplitPolicy::PredictDelay (uint8_t leg, uint32_t pduSize) const
+{
+  const LegInfo &l = m_legs[leg];
+  double bytes = (double) GetBacklog (leg) + pduSize;
+  Time delay;
+  if (l.throughput > 0)
+    {
+      delay = Seconds (bytes / l.throughput);
+    }
+  else
+    {
+      delay = l.holDelay + Seconds (bytes / m_minThroughput);
+    }
+  if (leg == 1)
+    {
+      delay += m_leg1Offset;
+    }
+  return delay;
+}
+
+uint8_t
+DelayEqualizingSplitPolicy::DoSelectLeg (uint32_t pduSize)
+{
+  Time d0 = PredictDelay (0, pduSize);
+  Time d1 = PredictDelay (1, pduSize);
+  NS_LOG_LOGIC ("Predicted delay " << d0 << " on cell " << m_legs[0].cellId
+                << ", " << d1 << " on cell " << m_legs[1].cellId);
+  if (d0 == d1)
+    {
+      return (m_legs[0].txBytes <= m_legs[1].txBytes) ? 0 : 1;
+    }
+  return (d0 < d1) ? 0 : 1;
+}
+
+
+////////////////////////////////////////
+// BacklogWeightedSplitPolicy
+////////////////////////////////////////
+
+NS_OBJECT_ENSURE_REGISTERED (BacklogWeightedSplitPolicy);
+
+BacklogWeightedSplitPolicy::BacklogWeightedSplitPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BacklogWeightedSplitPolicy::~BacklogWeightedSplitPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+BacklogWeightedSplitPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BacklogWeightedSplitPolicy")
+    .SetParent<SplitBearerPolicy> ()
+    .SetGroupName("Lte")
+    .AddConstructor<BacklogWeightedSplitPolicy> ()
+    .AddAttribute ("MinBacklog",
+                   "Backlog floor used to weight the legs, in bytes",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&BacklogWeightedSplitPolicy::m_minBacklog),
+                   MakeUintegerChecker<uint32_t> (1))
+    ;
+  return tid;
+}
+
+uint8_t
+BacklogWeightedSplitPolicy::DoSelectLeg (uint32_t pduSize)
+{
+  // weights are 1 / (backlog + floor), normalized over the two legs
+  double b0 = (double) GetBacklog (0) + m_minBacklog;
+  double b1 = (double) GetBacklog (1) + m_minBacklog;
+  return SelectByShare (b1 / (b0 + b1), pduSize);
+}
+
+
+////////////////////////////////////////
+// ThroughputProportionalSplitPolicy
+////////////////////////////////////////
+
+NS_OBJECT_ENSURE_REGISTERED (ThroughputProportionalSplitPolicy);
+
+ThroughputProportionalSplitPolicy::ThroughputProportionalSplitPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ThroughputProportionalSplitPolicy::~ThroughputProportionalSplitPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+ThroughputProportionalSplitPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ThroughputProportionalSplitPolicy")
+    .SetParent<SplitBearerPolicy> ()
+    .SetGroupName("Lte")
+    .AddConstructor<ThroughputProportionalSplitPolicy> ()
+    ;
+  return tid;
+}
+
+uint8_t
+ThroughputProportionalSplitPolicy::DoSelectLeg (uint32_t pduSize)
+{
+  double t0 = m_legs[0].throughput;
+  double t1 = m_legs[1].throughput;
+  double share0 = (t0 + t1 > 0) ? t0 / (t0 + t1) : 0.5;
+  return SelectByShare (share0, pduSize);
+}
+
+} // namespace ns3
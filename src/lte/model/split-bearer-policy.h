@@ -0,0 +1,201 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPLIT_BEARER_POLICY_H
+#define SPLIT_BEARER_POLICY_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/traced-callback.h>
+#include <ns3/epc-x2-sap.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * Base class of the split bearer policies used by McEnbPdcp to choose,
+ * for every PDCP PDU, on which of the two legs of a dual connected bearer
+ * it is transmitted.
+ *
+ * The base class keeps the state of the two legs, which is fed by the
+ * AssistantInformationForSplitting reports of the RLC entities and by the
+ * PDUs the PDCP hands to each leg. From this it estimates the rate at which
+ * each leg drains its queue. Subclasses only implement DoSelectLeg.
+ */
+class SplitBearerPolicy : public Object
+{
+public:
+  /**
+   * Status of one leg of the split bearer, as seen by the PDCP
+   */
+  struct LegInfo
+  {
+    uint16_t cellId;          ///< cell id serving this leg
+    uint32_t queueSize;       ///< bytes in the RLC tx queues at the last report
+    uint32_t retxQueueSize;   ///< bytes in the RLC retx queue at the last report
+    Time holDelay;            ///< head-of-line delay of the tx queue at the last report
+    double throughput;        ///< estimated drain rate, in bytes/s
+    bool reported;            ///< true once the first report has been received
+    Time lastReport;          ///< time of the last report
+    uint32_t bytesSinceReport; ///< bytes sent to this leg since the last report
+    uint64_t txBytes;         ///< total bytes sent to this leg
+  };
+
+  SplitBearerPolicy ();
+  virtual ~SplitBearerPolicy ();
+  static TypeId GetTypeId (void);
+
+  /**
+   * Set the cells serving the two legs. The state of a leg is reset when
+   * its cell changes.
+   *
+   * \param cellId0 the cell of the first leg
+   * \param cellId1 the cell of the second leg
+   */
+  void SetLegs (uint16_t cellId0, uint16_t cellId1);
+
+  /**
+   * Update the state of the leg served by a cell with a report from its RLC
+   *
+   * \param cellId the cell the report refers to
+   * \param info the report
+   */
+  void ReportAssistantInfo (uint16_t cellId, EpcX2Sap::AssistantInformationForSplitting info);
+
+  /**
+   * Select the leg for the next PDU and account its bytes on that leg
+   *
+   * \param pduSize size of the PDU, in bytes
+   * \return the cell id of the selected leg
+   */
+  uint16_t SelectCell (uint32_t pduSize);
+
+  /**
+   * \param leg 0 or 1
+   * \return the status of the leg
+   */
+  const LegInfo& GetLegInfo (uint8_t leg) const;
+
+  /**
+   * TracedCallback signature for leg selection.
+   *
+   * \param [in] cellId The cell of the selected leg.
+   * \param [in] size PDU size.
+   */
+  typedef void (* LegSelectedTracedCallback)(uint16_t cellId, uint32_t size);
+
+protected:
+  /**
+   * \param pduSize size of the PDU, in bytes
+   * \return the leg (0 or 1) on which the PDU is sent
+   */
+  virtual uint8_t DoSelectLeg (uint32_t pduSize) = 0;
+
+  /**
+   * Smooth weighted round robin: each leg earns credit in proportion to its
+   * share of the traffic and the leg with the most credit is selected.
+   *
+   * \param share0 fraction of the bytes to be sent on leg 0, in [0, 1]
+   * \param pduSize size of the PDU, in bytes
+   * \return the selected leg
+   */
+  uint8_t SelectByShare (double share0, uint32_t pduSize);
+
+  /**
+   * \param leg 0 or 1
+   * \return the bytes queued on the leg, including those sent after the last report
+   */
+  uint32_t GetBacklog (uint8_t leg) const;
+
+  LegInfo m_legs[2];
+
+private:
+  void ResetLeg (uint8_t leg, uint16_t cellId);
+
+  double m_alpha;       ///< EWMA weight of the past throughput estimate
+  double m_credit[2];   ///< credit of each leg, for SelectByShare
+  TracedCallback<uint16_t, uint32_t> m_legSelectedTrace;
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Sends each PDU on the leg where it is predicted to be delivered first.
+ * The delivery time is predicted as the time needed to drain the backlog
+ * in front of the PDU at the estimated leg throughput (or, until there is
+ * an estimate, as the head-of-line delay plus the drain time at
+ * MinThroughput). Keeping the two legs at the same delay minimizes the
+ * reordering at the UE.
+ */
+class DelayEqualizingSplitPolicy : public SplitBearerPolicy
+{
+public:
+  DelayEqualizingSplitPolicy ();
+  virtual ~DelayEqualizingSplitPolicy ();
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual uint8_t DoSelectLeg (uint32_t pduSize);
+
+private:
+  Time PredictDelay (uint8_t leg, uint32_t pduSize) const;
+
+  Time m_leg1Offset;    ///< additional fixed delay of leg 1 (e.g., X2 latency)
+  double m_minThroughput; ///< throughput used when no estimate is available, in bytes/s
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Splits the traffic in inverse proportion to the backlog of each leg.
+ */
+class BacklogWeightedSplitPolicy : public SplitBearerPolicy
+{
+public:
+  BacklogWeightedSplitPolicy ();
+  virtual ~BacklogWeightedSplitPolicy ();
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual uint8_t DoSelectLeg (uint32_t pduSize);
+
+private:
+  uint32_t m_minBacklog; ///< backlog floor, which avoids infinite weights for empty queues
+};
+
+
+/**
+ * \ingroup lte
+ *
+ * Splits the traffic in proportion to the estimated throughput of each leg.
+ */
+class ThroughputProportionalSplitPolicy : public SplitBearerPolicy
+{
+public:
+  ThroughputProportionalSplitPolicy ();
+  virtual ~ThroughputProportionalSplitPolicy ();
+  static TypeId GetTypeId (void);
+
+protected:
+  virtual uint8_t DoSelectLeg (uint32_t pduSize);
+};
+
+} // namespace ns3
+
+#endif // SPLIT_BEARER_POLICY_H
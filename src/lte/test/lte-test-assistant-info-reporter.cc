@@ -0,0 +1,300 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/config.h"
+#include "ns3/object-factory.h"
+
+#include "ns3/assistant-info-reporter.h"
+#include "ns3/lte-rlc.h"
+
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestAssistantInfoReporter");
+
+/**
+ * Drives an AssistantInfoReporter with a queue updated every millisecond and
+ * checks the number of reports sent in one second.
+ *
+ * Without credit the queue grows by 1000 bytes per millisecond. With credit
+ * the queue is drained at 1000 bytes per millisecond and refilled, like by the
+ * PDCP, with the desired buffer size of each report.
+ */
+class LteAssistantInfoReporterTestCase : public TestCase
+{
+public:
+  LteAssistantInfoReporterTestCase (std::string name, std::string mode, Time period,
+                                    Time minInterval, uint64_t minReports, uint64_t maxReports);
+  virtual ~LteAssistantInfoReporterTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Tick ();
+  EpcX2Sap::AssistantInformationForSplitting Snapshot ();
+  void Send (EpcX2Sap::AssistantInformationForSplitting info);
+
+  std::string m_mode;
+  Time m_period;
+  Time m_minInterval;
+  uint64_t m_minReports;
+  uint64_t m_maxReports;
+  uint32_t m_queue;
+  uint32_t m_maxQueue;
+  uint64_t m_drained;
+  Ptr<AssistantInfoReporter> m_reporter;
+};
+
+LteAssistantInfoReporterTestCase::LteAssistantInfoReporterTestCase (std::string name, std::string mode,
+                                                                    Time period, Time minInterval,
+                                                                    uint64_t minReports, uint64_t maxReports)
+  : TestCase (name),
+    m_mode (mode),
+    m_period (period),
+    m_minInterval (minInterval),
+    m_minReports (minReports),
+    m_maxReports (maxReports)
+{
+}
+
+LteAssistantInfoReporterTestCase::~LteAssistantInfoReporterTestCase ()
+{
+}
+
+EpcX2Sap::AssistantInformationForSplitting
+LteAssistantInfoReporterTestCase::Snapshot ()
+{
+  EpcX2Sap::AssistantInformationForSplitting info;
+  info.Tx_On_Q_Size = m_queue;
+  return info;
+}
+
+void
+LteAssistantInfoReporterTestCase::Send (EpcX2Sap::AssistantInformationForSplitting info)
+{
+  NS_TEST_ASSERT_MSG_EQ (info.Report_Time, (uint64_t) Simulator::Now ().GetNanoSeconds (), "wrong report time");
+  if (m_mode == "Credit")
+    {
+      m_queue += info.Desired_Buffer_Size;
+      m_maxQueue = std::max (m_maxQueue, m_queue);
+    }
+}
+
+void
+LteAssistantInfoReporterTestCase::Tick ()
+{
+  const uint32_t rate = 1000;
+  if (m_mode == "Credit")
+    {
+      uint32_t drained = std::min (m_queue, rate);
+      m_queue -= drained;
+      m_drained += drained;
+    }
+  else
+    {
+      m_queue += rate;
+    }
+  m_reporter->NotifyQueueUpdate ();
+  Simulator::Schedule (MilliSeconds (1), &LteAssistantInfoReporterTestCase::Tick, this);
+}
+
+void
+LteAssistantInfoReporterTestCase::DoRun (void)
+{
+  m_queue = 0;
+  m_maxQueue = 0;
+  m_drained = 0;
+  m_reporter = CreateObject<AssistantInfoReporter> ();
+  m_reporter->SetAttribute ("Mode", StringValue (m_mode));
+  m_reporter->SetAttribute ("Period", TimeValue (m_period));
+  m_reporter->SetAttribute ("MinInterval", TimeValue (m_minInterval));
+  m_reporter->SetAttribute ("QueueDelta", UintegerValue (5000));
+  m_reporter->SetAttribute ("TargetBuffer", UintegerValue (20000));
+  m_reporter->SetSnapshotCallback (MakeCallback (&LteAssistantInfoReporterTestCase::Snapshot, this));
+  m_reporter->SetSendCallback (MakeCallback (&LteAssistantInfoReporterTestCase::Send, this));
+  m_reporter->Start (MicroSeconds (500));
+
+  Simulator::Schedule (MilliSeconds (1), &LteAssistantInfoReporterTestCase::Tick, this);
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  uint64_t reports = m_reporter->GetReportsSent ();
+  NS_LOG_INFO (GetName () << " reports " << reports << " coalesced " << m_reporter->GetTriggersCoalesced ()
+               << " lag " << m_reporter->GetMeanReportLag () << " drained " << m_drained);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (reports, m_minReports, "too few reports");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (reports, m_maxReports, "too many reports");
+  if (m_minInterval > Seconds (0))
+    {
+      NS_TEST_ASSERT_MSG_GT (m_reporter->GetTriggersCoalesced (), 0, "no trigger was coalesced");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_reporter->GetMeanReportLag (), m_minInterval, "report lag larger than MinInterval");
+    }
+  if (m_mode == "Credit")
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxQueue, 20000, "the queue exceeded the target buffer");
+      NS_TEST_ASSERT_MSG_GT (m_drained, 900000, "the queue went empty too often");
+    }
+
+  m_reporter->Dispose ();
+  m_reporter = 0;
+  Simulator::Destroy ();
+}
+
+
+/**
+ * MAC SAP provider of the RLC under test, which drops everything
+ */
+class LteAssistantInfoTestMacSapProvider : public LteMacSapProvider
+{
+public:
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+  }
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+  }
+};
+
+/**
+ * X2 provider of the RLC under test, which records the assistant information
+ */
+class LteAssistantInfoTestX2RlcProvider : public EpcX2RlcProvider
+{
+public:
+  virtual void ReceiveMcPdcpSdu (UeDataParams params)
+  {
+  }
+  virtual void ReceiveAssistantInformation (AssistantInformationForSplitting info)
+  {
+    m_reports.push_back (info);
+  }
+
+  std::vector<AssistantInformationForSplitting> m_reports;  ///< the reports received
+};
+
+/**
+ * Feeds an RLC of the secondary leg of a split bearer with a PDCP PDU every
+ * millisecond and checks the periodic reports it sends over X2.
+ */
+class LteRlcAssistantInfoTestCase : public TestCase
+{
+public:
+  LteRlcAssistantInfoTestCase (std::string rlcType);
+  virtual ~LteRlcAssistantInfoTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Transmit ();
+
+  std::string m_rlcType;
+  Ptr<LteRlc> m_rlc;
+  std::ofstream m_queueStream;
+};
+
+LteRlcAssistantInfoTestCase::LteRlcAssistantInfoTestCase (std::string rlcType)
+  : TestCase ("assistant info of " + rlcType),
+    m_rlcType (rlcType)
+{
+}
+
+LteRlcAssistantInfoTestCase::~LteRlcAssistantInfoTestCase ()
+{
+}
+
+void
+LteRlcAssistantInfoTestCase::Transmit ()
+{
+  LteRlcSapProvider::TransmitPdcpPduParameters params;
+  params.pdcpPdu = Create<Packet> (10);
+  params.rnti = 1;
+  params.lcid = 3;
+  m_rlc->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+  Simulator::Schedule (MilliSeconds (1), &LteRlcAssistantInfoTestCase::Transmit, this);
+}
+
+void
+LteRlcAssistantInfoTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::AssistantInfoReporter::Mode", StringValue ("Periodic"));
+  Config::SetDefault ("ns3::AssistantInfoReporter::Period", TimeValue (MilliSeconds (5)));
+
+  LteAssistantInfoTestMacSapProvider mac;
+  LteAssistantInfoTestX2RlcProvider x2;
+  ObjectFactory factory;
+  factory.SetTypeId (m_rlcType);
+  m_rlc = factory.Create<LteRlc> ();
+  m_rlc->SetLteMacSapProvider (&mac);
+  m_rlc->SetEpcX2RlcProvider (&x2);
+  m_rlc->SetRnti (1);
+  m_rlc->SetLcId (3);
+  m_rlc->SetDrbId (1);
+  m_rlc->SetStreamForQueueStatistics (&m_queueStream);
+
+  Simulator::Schedule (MilliSeconds (1), &LteRlcAssistantInfoTestCase::Transmit, this);
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+
+  // the first report 10 ms after the first PDU, then one every 5 ms
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (x2.m_reports.size (), 195, "too few reports");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (x2.m_reports.size (), 200, "too many reports");
+  if (!x2.m_reports.empty ())
+    {
+      const EpcX2Sap::AssistantInformationForSplitting &last = x2.m_reports.back ();
+      NS_TEST_EXPECT_MSG_EQ (last.rnti, 1, "wrong RNTI");
+      NS_TEST_EXPECT_MSG_EQ (last.drbId, 1, "wrong DRB id");
+      NS_TEST_EXPECT_MSG_GT (last.Tx_On_Q_Size, 0, "empty queue reported");
+      NS_TEST_EXPECT_MSG_GT (last.Report_Time, 0, "report time not set");
+    }
+
+  m_rlc->Dispose ();
+  m_rlc = 0;
+  Simulator::Destroy ();
+  Config::Reset ();
+}
+
+
+/**
+ * Test the reporting of the assistant information of split bearers
+ */
+class LteAssistantInfoReporterTestSuite : public TestSuite
+{
+public:
+  LteAssistantInfoReporterTestSuite ();
+};
+
+static LteAssistantInfoReporterTestSuite g_lteAssistantInfoReporterTestSuite;
+
+LteAssistantInfoReporterTestSuite::LteAssistantInfoReporterTestSuite ()
+  : TestSuite ("lte-assistant-info-reporter", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new LteAssistantInfoReporterTestCase ("periodic", "Periodic", MilliSeconds (1), Seconds (0), 999, 1000), TestCase::QUICK);
+  // the queue moves by 5000 bytes every 5 ms
+  AddTestCase (new LteAssistantInfoReporterTestCase ("threshold", "Threshold", Seconds (0), Seconds (0), 195, 201), TestCase::QUICK);
+  // the keep-alive period is shorter than the threshold
+  AddTestCase (new LteAssistantInfoReporterTestCase ("threshold keep-alive", "Threshold", MilliSeconds (2), Seconds (0), 490, 501), TestCase::QUICK);
+  // rate limited to one report every 20 ms
+  AddTestCase (new LteAssistantInfoReporterTestCase ("threshold rate limited", "Threshold", Seconds (0), MilliSeconds (20), 45, 51), TestCase::QUICK);
+  AddTestCase (new LteAssistantInfoReporterTestCase ("credit", "Credit", MilliSeconds (100), Seconds (0), 150, 260), TestCase::QUICK);
+  AddTestCase (new LteRlcAssistantInfoTestCase ("ns3::LteRlcUm"), TestCase::QUICK);
+  AddTestCase (new LteRlcAssistantInfoTestCase ("ns3::LteRlcUmLowLat"), TestCase::QUICK);
+  AddTestCase (new LteRlcAssistantInfoTestCase ("ns3::LteRlcAm"), TestCase::QUICK);
+}
@@ -0,0 +1,121 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+#include "ns3/cell-sinr-matrix.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestCellSinrMatrix");
+
+/**
+ * Feeds the reports of three cells, arriving in random order, to a
+ * CellSinrMatrix and checks the rows, the columns and the update flags.
+ */
+class LteCellSinrMatrixTestCase : public TestCase
+{
+public:
+  LteCellSinrMatrixTestCase ();
+  virtual ~LteCellSinrMatrixTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteCellSinrMatrixTestCase::LteCellSinrMatrixTestCase ()
+  : TestCase ("SINR matrix")
+{
+}
+
+LteCellSinrMatrixTestCase::~LteCellSinrMatrixTestCase ()
+{
+}
+
+void
+LteCellSinrMatrixTestCase::DoRun (void)
+{
+  CellSinrMatrix matrix;
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetNUes (), 0, "matrix not empty");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (1, 2), 0, "unknown entry not 0");
+
+  std::map<uint64_t, double> report;
+  report[5] = 50;
+  report[3] = 30;
+  matrix.UpdateCell (7, report);
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetNUes (), 2, "wrong number of UEs");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetImsi (0), 3, "rows not sorted");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsUpdated (0), true, "new row not flagged");
+  matrix.ClearUpdated (0);
+  matrix.ClearUpdated (1);
+
+  // a cell with a smaller ID and a new UE in between
+  report.clear ();
+  report[4] = 4;
+  report[5] = 5;
+  matrix.UpdateCell (2, report);
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetNUes (), 3, "wrong number of UEs");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetNCells (), 2, "wrong number of cells");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetCellId (0), 2, "columns not sorted");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetImsi (1), 4, "rows not sorted");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsUpdated (0), false, "row of imsi 3 flagged");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsUpdated (2), true, "row of imsi 5 not flagged");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (3, 7), 30, "value lost when adding a cell");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 7), 50, "value lost when adding a row");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 2), 5, "wrong value");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsReported (0, 0), false, "imsi 3 reported by cell 2");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (3, 2), 0, "unreported entry not 0");
+  NS_TEST_ASSERT_MSG_EQ (matrix.HasUe (6), false, "unknown imsi found");
+  for (uint32_t row = 0; row < matrix.GetNUes (); ++row)
+    {
+      matrix.ClearUpdated (row);
+    }
+
+  // the same values do not flag the row, the imsi missing from the report is kept
+  report.clear ();
+  report[3] = 30;
+  report[5] = 51;
+  matrix.UpdateCell (7, report);
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsUpdated (0), false, "unchanged row flagged");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsUpdated (2), true, "changed row not flagged");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 7), 51, "value not updated");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 2), 5, "value of another cell changed");
+
+  matrix.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetNUes (), 0, "matrix not cleared");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetNCells (), 0, "matrix not cleared");
+}
+
+
+/**
+ * Test the SINR matrix of the coordinator eNB
+ */
+class LteCellSinrMatrixTestSuite : public TestSuite
+{
+public:
+  LteCellSinrMatrixTestSuite ();
+};
+
+static LteCellSinrMatrixTestSuite g_lteCellSinrMatrixTestSuite;
+
+LteCellSinrMatrixTestSuite::LteCellSinrMatrixTestSuite ()
+  : TestSuite ("lte-cell-sinr-matrix", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new LteCellSinrMatrixTestCase (), TestCase::QUICK);
+}
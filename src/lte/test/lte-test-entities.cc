@@ -328,6 +328,12 @@ LteTestPdcp::DoReceivePdcpPdu (Ptr<Packet> p)
   delete [] buf;
 }
 
+void
+LteTestPdcp::DoReceiveLteAssistantInfo (EpcX2Sap::AssistantInformationForSplitting info)
+{
+  NS_LOG_FUNCTION (this);
+}
+
 /**
  * START
  */
@@ -384,6 +390,7 @@ LteTestMac::LteTestMac ()
   m_txBytes = 0;
   m_rxPdus = 0;
   m_rxBytes = 0;
+  m_bufferStatusReports = 0;
 
 //   m_cmacSapProvider = new EnbMacMemberLteEnbCmacSapProvider (this);
 //   m_schedSapUser = new EnbMacMemberFfMacSchedSapUser (this);
@@ -469,6 +476,13 @@ LteTestMac::GetRxBytes (void)
   return m_rxBytes;
 }
 
+uint32_t
+LteTestMac::GetBufferStatusReports (void)
+{
+  NS_LOG_FUNCTION (this << m_bufferStatusReports);
+  return m_bufferStatusReports;
+}
+
 
 void
 LteTestMac::SendTxOpportunity (Time time, uint32_t bytes)
@@ -609,6 +623,8 @@ LteTestMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameter
 {
   NS_LOG_FUNCTION (this << params.txQueueSize << params.retxQueueSize << params.statusPduSize);
 
+  m_bufferStatusReports++;
+
   if (m_txOpportunityMode == AUTOMATIC_MODE)
     {
       // cancel all previously scheduled TxOpps
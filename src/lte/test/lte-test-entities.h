@@ -143,6 +143,7 @@ class LteTestPdcp : public Object
   private:
     // Interface forwarded by LteRlcSapUser
   virtual void DoReceivePdcpPdu (Ptr<Packet> p);
+  virtual void DoReceiveLteAssistantInfo (EpcX2Sap::AssistantInformationForSplitting info);
 
     LteRlcSapUser* m_rlcSapUser;
     LteRlcSapProvider* m_rlcSapProvider;
@@ -228,6 +229,7 @@ class LteTestMac : public Object
     uint32_t GetTxBytes (void);
     uint32_t GetRxPdus (void);
     uint32_t GetRxBytes (void);
+    uint32_t GetBufferStatusReports (void);
 
   private:
     // forwarded from LteMacSapProvider
@@ -257,6 +259,7 @@ class LteTestMac : public Object
     uint32_t m_txBytes;
     uint32_t m_rxPdus;
     uint32_t m_rxBytes;
+    uint32_t m_bufferStatusReports;
 
 };
 
@@ -0,0 +1,143 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/lte-helper.h"
+#include "ns3/point-to-point-epc-helper.h"
+#include "ns3/lte-enb-net-device.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestEpcRemoteEnb");
+
+/**
+ * Builds the same topology as two ranks of a distributed simulation would,
+ * the first one simulating both eNBs and the second one none of them, and
+ * checks that the S1 and X2 devices and addresses of the eNBs match, as the
+ * packets crossing the ranks are delivered by node id and interface index.
+ */
+class LteEpcRemoteEnbTestCase : public TestCase
+{
+public:
+  LteEpcRemoteEnbTestCase ();
+  virtual ~LteEpcRemoteEnbTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteEpcRemoteEnbTestCase::LteEpcRemoteEnbTestCase ()
+  : TestCase ("Remote eNBs of a distributed simulation")
+{
+}
+
+LteEpcRemoteEnbTestCase::~LteEpcRemoteEnbTestCase ()
+{
+}
+
+void
+LteEpcRemoteEnbTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::PointToPointEpcHelper::S1uLinkDelay", TimeValue (MilliSeconds (1)));
+  Config::SetDefault ("ns3::PointToPointEpcHelper::S1apLinkDelay", TimeValue (MilliSeconds (1)));
+  Config::SetDefault ("ns3::PointToPointEpcHelper::X2LinkDelay", TimeValue (MilliSeconds (1)));
+
+  // rank simulating the eNBs
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  Ptr<PointToPointEpcHelper> localEpc = CreateObject<PointToPointEpcHelper> ();
+  lteHelper->SetEpcHelper (localEpc);
+  lteHelper->SetAttribute ("BasicCellId", UintegerValue (4));
+  NodeContainer localEnbs;
+  localEnbs.Create (2);
+  MobilityHelper mobility;
+  mobility.Install (localEnbs);
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (localEnbs);
+  localEpc->AddX2Interface (localEnbs.Get (0), localEnbs.Get (1));
+
+  // rank simulating other eNBs, which builds the same topology in its own
+  // process and hence with its own address generator
+  Ipv4AddressGenerator::Reset ();
+  Ptr<PointToPointEpcHelper> remoteEpc = CreateObject<PointToPointEpcHelper> ();
+  NodeContainer remoteEnbs;
+  remoteEnbs.Create (2);
+  remoteEpc->AddRemoteEnb (remoteEnbs.Get (0), 5);
+  remoteEpc->AddRemoteEnb (remoteEnbs.Get (1), 6);
+  remoteEpc->AddX2Interface (remoteEnbs.Get (0), remoteEnbs.Get (1));
+
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (enbDevs.Get (i)->GetObject<LteEnbNetDevice> ()->GetCellId (), 5 + i,
+                             "BasicCellId not applied");
+      Ptr<Node> local = localEnbs.Get (i);
+      Ptr<Node> remote = remoteEnbs.Get (i);
+      NS_TEST_ASSERT_MSG_EQ (local->GetNDevices (), remote->GetNDevices (), "different number of devices");
+      Ptr<Ipv4> localIpv4 = local->GetObject<Ipv4> ();
+      Ptr<Ipv4> remoteIpv4 = remote->GetObject<Ipv4> ();
+      NS_TEST_ASSERT_MSG_EQ (localIpv4->GetNInterfaces (), remoteIpv4->GetNInterfaces (),
+                             "different number of interfaces");
+      for (uint32_t j = 1; j < local->GetNDevices (); j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (local->GetDevice (j)->GetInstanceTypeId (),
+                                 remote->GetDevice (j)->GetInstanceTypeId (), "different device " << j);
+          int32_t localIf = localIpv4->GetInterfaceForDevice (local->GetDevice (j));
+          int32_t remoteIf = remoteIpv4->GetInterfaceForDevice (remote->GetDevice (j));
+          NS_TEST_ASSERT_MSG_EQ (localIf, remoteIf, "different interface of device " << j);
+          NS_TEST_ASSERT_MSG_EQ (localIpv4->GetAddress (localIf, 0).GetLocal (),
+                                 remoteIpv4->GetAddress (remoteIf, 0).GetLocal (),
+                                 "different address of device " << j);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (localEpc->GetPgwNode ()->GetNDevices (), remoteEpc->GetPgwNode ()->GetNDevices (),
+                         "different number of PGW devices");
+
+  // the UEs of the other ranks get their addresses in the same order
+  Ipv4Address ueAddress = remoteEpc->AssignRemoteUeIpv4Address ();
+  NS_TEST_ASSERT_MSG_EQ (ueAddress, Ipv4Address ("7.0.0.2"), "wrong remote UE address");
+  remoteEpc->AddRemoteUe (1, ueAddress);
+  uint8_t bearerId = remoteEpc->ActivateRemoteEpsBearer (1, EpcTft::Default (),
+                                                         EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) bearerId, 1, "wrong bearer id");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test the remote eNBs of the point to point EPC helper
+ */
+class LteEpcRemoteEnbTestSuite : public TestSuite
+{
+public:
+  LteEpcRemoteEnbTestSuite ();
+};
+
+static LteEpcRemoteEnbTestSuite g_lteEpcRemoteEnbTestSuite;
+
+LteEpcRemoteEnbTestSuite::LteEpcRemoteEnbTestSuite ()
+  : TestSuite ("lte-epc-remote-enb", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new LteEpcRemoteEnbTestCase (), TestCase::QUICK);
+}
@@ -0,0 +1,193 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+#include "ns3/lte-amc.h"
+#include "ns3/lte-ffr-sap.h"
+#include "ns3/ff-mac-rbg-allocator.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestFfMacRbgAllocator");
+
+/**
+ * Builds a subband CQI report with the same CQI on both codewords of each RBG
+ *
+ * \param cqis the CQI of each RBG
+ * \return the report
+ */
+static SbMeasResult_s
+MakeSbReport (const std::vector<uint8_t> &cqis)
+{
+  SbMeasResult_s report;
+  for (uint32_t i = 0; i < cqis.size (); i++)
+    {
+      HigherLayerSelected_s rbg;
+      rbg.m_sbPmi = 0;
+      rbg.m_sbCqi.push_back (cqis[i]);
+      rbg.m_sbCqi.push_back (cqis[i]);
+      report.m_higherLayerSelected.push_back (rbg);
+    }
+  return report;
+}
+
+/**
+ * Checks the RBGs assigned by the allocator with the PF and max rate
+ * metrics, by the time domain and round robin helpers, and the rates
+ * computed for the A30 CQI reports, against the rates computed by the AMC
+ * module.
+ */
+class LteFfMacRbgAllocatorTestCase : public TestCase
+{
+public:
+  LteFfMacRbgAllocatorTestCase ();
+  virtual ~LteFfMacRbgAllocatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteFfMacRbgAllocatorTestCase::LteFfMacRbgAllocatorTestCase ()
+  : TestCase ("RBG allocation")
+{
+}
+
+LteFfMacRbgAllocatorTestCase::~LteFfMacRbgAllocatorTestCase ()
+{
+}
+
+void
+LteFfMacRbgAllocatorTestCase::DoRun (void)
+{
+  Ptr<LteAmc> amc = CreateObject<LteAmc> ();
+  int rbgSize = 3;
+  FfMacRbgAllocator<LteAmc, LteFfrSapProvider> allocator;
+  allocator.Configure (amc, rbgSize);
+
+  double rate = (amc->GetTbSizeFromMcs (amc->GetMcsFromCqi (7), rbgSize) / 8) / 0.001;
+  NS_TEST_ASSERT_MSG_EQ_TOL (allocator.GetLayerRate (7), rate, 1e-9, "wrong rate for CQI 7");
+  NS_TEST_ASSERT_MSG_EQ_TOL (allocator.GetWbRate (7, 2), 2 * rate, 1e-9, "wrong wideband rate");
+
+  std::vector<uint8_t> cqis;
+  cqis.push_back (15);
+  cqis.push_back (0);
+  cqis.push_back (4);
+  cqis.push_back (4);
+  std::vector<double> sbRate1;
+  allocator.ComputeSbRates (MakeSbReport (cqis), sbRate1);
+  cqis[0] = 7;
+  cqis[1] = 0;
+  cqis[2] = 4;
+  cqis[3] = 4;
+  std::vector<double> sbRate2;
+  allocator.ComputeSbRates (MakeSbReport (cqis), sbRate2);
+
+  std::vector<uint16_t> rbgs[4];
+  std::vector<FfMacRbgCandidate> ues;
+  // UE 1 has the best channel but a high averaged throughput
+  ues.push_back (allocator.MakeCandidate (1, 1, &sbRate1, &rbgs[1], 4 * allocator.GetLayerRate (15)));
+  ues.push_back (allocator.MakeCandidate (2, 1, &sbRate2, &rbgs[2], allocator.GetLayerRate (7)));
+  // UE 3 has no subband report: lowest CQI on both layers
+  ues.push_back (allocator.MakeCandidate (3, 2, 0, &rbgs[3], 1e12));
+
+  double sbRate = 0;
+  NS_TEST_ASSERT_MSG_EQ (allocator.GetSbRate (ues[0], 0, sbRate), true, "RBG with CQI 15 out of range");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sbRate, allocator.GetLayerRate (15), 1e-9, "wrong rate from the report");
+  NS_TEST_ASSERT_MSG_EQ (allocator.GetSbRate (ues[1], 1, sbRate), false, "RBG with CQI 0 in range");
+  NS_TEST_ASSERT_MSG_EQ (allocator.GetSbRate (ues[2], 1, sbRate), true, "UE without report out of range");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sbRate, 2 * allocator.GetLayerRate (1), 1e-9, "wrong rate without report");
+
+  // RBG 3 is already used, e.g. by a HARQ retransmission
+  std::vector<bool> rbgMap (4, false);
+  rbgMap[3] = true;
+  allocator.Allocate<FfMacRelativeRateMetric> (ues, 0, rbgMap);
+
+  NS_TEST_ASSERT_MSG_EQ (rbgs[2].size (), 2, "wrong number of RBGs for UE 2");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[2][0], 0, "RBG 0 not assigned to UE 2");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[2][1], 2, "RBG 2 not assigned to UE 2");
+  // only UE 3 can use RBG 1
+  NS_TEST_ASSERT_MSG_EQ (rbgs[3].size (), 1, "wrong number of RBGs for UE 3");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[3][0], 1, "RBG 1 not assigned to UE 3");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[1].size (), 0, "RBG assigned to UE 1");
+  NS_TEST_ASSERT_MSG_EQ (rbgMap[0] && rbgMap[1] && rbgMap[2], true, "RBGs not marked as used");
+
+  // the max rate metric ignores the weight; on RBGs 2 and 3 UE 1 and UE 2 have
+  // the same rate and the first one wins
+  std::fill (rbgMap.begin (), rbgMap.end (), false);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      rbgs[i].clear ();
+    }
+  allocator.Allocate<FfMacMaxRateMetric> (ues, 0, rbgMap);
+  NS_TEST_ASSERT_MSG_EQ (rbgs[1].size (), 3, "wrong number of RBGs for UE 1");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[1][0], 0, "RBG 0 not assigned to UE 1");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[3].size (), 1, "wrong number of RBGs for UE 3");
+  NS_TEST_ASSERT_MSG_EQ (rbgs[3][0], 1, "RBG 1 not assigned to UE 3");
+
+  // a new report replaces the rates
+  cqis[1] = 9;
+  allocator.ComputeSbRates (MakeSbReport (cqis), sbRate2);
+  NS_TEST_ASSERT_MSG_EQ (allocator.GetSbRate (ues[1], 1, sbRate), true, "rates not updated");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sbRate, allocator.GetLayerRate (9), 1e-9, "wrong updated rate");
+
+  // the time domain schedulers take all the free RBGs
+  std::fill (rbgMap.begin (), rbgMap.end (), false);
+  rbgMap[1] = true;
+  std::vector<uint16_t> rbgs5;
+  allocator.AllocateAll (5, 0, rbgMap, rbgs5);
+  NS_TEST_ASSERT_MSG_EQ (rbgs5.size (), 3, "wrong number of RBGs for UE 5");
+  NS_TEST_ASSERT_MSG_EQ (rbgs5[1], 2, "used RBG assigned");
+
+  // round robin takes the next free RBGs in order
+  std::fill (rbgMap.begin (), rbgMap.end (), false);
+  rbgMap[1] = true;
+  int nextRbg = 0;
+  rbgs5.clear ();
+  allocator.AllocateNext (2, nextRbg, rbgMap, rbgs5);
+  NS_TEST_ASSERT_MSG_EQ (rbgs5.size (), 2, "wrong number of RBGs");
+  NS_TEST_ASSERT_MSG_EQ (rbgs5[1], 2, "used RBG taken");
+  NS_TEST_ASSERT_MSG_EQ (nextRbg, 3, "wrong next RBG");
+  NS_TEST_ASSERT_MSG_EQ (rbgMap[3], false, "RBG past the allocation used");
+
+  // a new RBG size changes the rate of each CQI
+  allocator.Configure (amc, 4);
+  rate = (amc->GetTbSizeFromMcs (amc->GetMcsFromCqi (7), 4) / 8) / 0.001;
+  NS_TEST_ASSERT_MSG_EQ_TOL (allocator.GetLayerRate (7), rate, 1e-9, "rates not recomputed");
+  allocator.ComputeSbRates (MakeSbReport (cqis), sbRate1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sbRate1[0], allocator.GetLayerRate (7), 1e-9, "subband rates not recomputed");
+}
+
+
+/**
+ * Test the RBG allocator of the frequency domain FF MAC schedulers
+ */
+class LteFfMacRbgAllocatorTestSuite : public TestSuite
+{
+public:
+  LteFfMacRbgAllocatorTestSuite ();
+};
+
+static LteFfMacRbgAllocatorTestSuite g_lteFfMacRbgAllocatorTestSuite;
+
+LteFfMacRbgAllocatorTestSuite::LteFfMacRbgAllocatorTestSuite ()
+  : TestSuite ("lte-ff-mac-rbg-allocator", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new LteFfMacRbgAllocatorTestCase (), TestCase::QUICK);
+}
@@ -0,0 +1,192 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+#include "ns3/measurement-report-delta-codec.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestMeasurementReportDeltaCodec");
+
+/**
+ * Passes measurement reports through the UE and eNB codecs and checks
+ * which cells the delta reports carry and that the eNB restores the
+ * reports.
+ */
+class LteMeasurementReportDeltaCodecTestCase : public TestCase
+{
+public:
+  LteMeasurementReportDeltaCodecTestCase ();
+  virtual ~LteMeasurementReportDeltaCodecTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param measId the measId of the report
+   * \param rsrp the RSRP of each neighbour cell, whose physCellId is 10 + its index
+   * \return a report with RSRQ of the neighbour cells
+   */
+  static LteRrcSap::MeasurementReport MakeReport (uint8_t measId, std::vector<uint8_t> rsrp);
+
+  /**
+   * \param report a report
+   * \return the RSRP of the neighbour cells, 0 for the cells without RSRP
+   */
+  static std::vector<uint8_t> GetRsrp (const LteRrcSap::MeasurementReport &report);
+};
+
+LteMeasurementReportDeltaCodecTestCase::LteMeasurementReportDeltaCodecTestCase ()
+  : TestCase ("Measurement report delta encoding")
+{
+}
+
+LteMeasurementReportDeltaCodecTestCase::~LteMeasurementReportDeltaCodecTestCase ()
+{
+}
+
+LteRrcSap::MeasurementReport
+LteMeasurementReportDeltaCodecTestCase::MakeReport (uint8_t measId, std::vector<uint8_t> rsrp)
+{
+  LteRrcSap::MeasurementReport report;
+  report.measResults.measId = measId;
+  report.measResults.rsrpResult = 60;
+  report.measResults.rsrqResult = 20;
+  report.measResults.haveMeasResultNeighCells = !rsrp.empty ();
+  for (uint16_t i = 0; i < rsrp.size (); ++i)
+    {
+      LteRrcSap::MeasResultEutra cell;
+      cell.physCellId = 10 + i;
+      cell.haveCgiInfo = false;
+      cell.haveRsrpResult = true;
+      cell.rsrpResult = rsrp[i];
+      cell.haveRsrqResult = false;
+      report.measResults.measResultListEutra.push_back (cell);
+    }
+  return report;
+}
+
+std::vector<uint8_t>
+LteMeasurementReportDeltaCodecTestCase::GetRsrp (const LteRrcSap::MeasurementReport &report)
+{
+  std::vector<uint8_t> rsrp;
+  for (std::list<LteRrcSap::MeasResultEutra>::const_iterator it = report.measResults.measResultListEutra.begin ();
+       it != report.measResults.measResultListEutra.end (); ++it)
+    {
+      rsrp.push_back (it->haveRsrpResult ? it->rsrpResult : 0);
+    }
+  return rsrp;
+}
+
+void
+LteMeasurementReportDeltaCodecTestCase::DoRun (void)
+{
+  MeasurementReportDeltaCodec ue;
+  MeasurementReportDeltaCodec enb;
+  ue.SetHysteresis (2);
+
+  std::vector<uint8_t> rsrp;
+  rsrp.push_back (40);
+  rsrp.push_back (35);
+  rsrp.push_back (30);
+
+  // the first report is sent in full
+  LteRrcSap::MeasurementReport report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), false, "first report sent as a delta report");
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.measResultListEutra.size (), 3, "cells removed from a full report");
+  NS_TEST_ASSERT_MSG_EQ (enb.Decode (7, report, false), true, "full report not decoded");
+
+  // only the second cell moved by more than the hysteresis
+  rsrp[0] = 42;
+  rsrp[1] = 31;
+  rsrp[2] = 29;
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), true, "no delta report for the same cells");
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.measResultListEutra.size (), 1, "wrong number of changed cells");
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.measResultListEutra.front ().physCellId, 11, "wrong changed cell");
+  NS_TEST_ASSERT_MSG_EQ (enb.Decode (7, report, true), true, "delta report not decoded");
+  std::vector<uint8_t> decoded = GetRsrp (report);
+  NS_TEST_ASSERT_MSG_EQ (decoded.size (), 3, "cells not restored");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) decoded[0], 40, "unchanged cell not taken from the reference");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) decoded[1], 31, "changed cell not updated");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) decoded[2], 30, "unchanged cell not taken from the reference");
+
+  // the drift is measured against the values known to the eNB
+  rsrp[0] = 43;
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), true, "no delta report for the same cells");
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.measResultListEutra.size (), 1, "accumulated drift not reported");
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.measResultListEutra.front ().physCellId, 10, "wrong changed cell");
+  enb.Decode (7, report, true);
+
+  // nothing changed: an empty delta report
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), true, "no delta report for the same cells");
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.haveMeasResultNeighCells, false, "unchanged cells sent");
+  enb.Decode (7, report, true);
+  NS_TEST_ASSERT_MSG_EQ (report.measResults.haveMeasResultNeighCells, true, "neighbour cells not restored");
+  decoded = GetRsrp (report);
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) decoded[0], 43, "wrong restored cell");
+
+  // a new order of the cells needs a full report
+  std::vector<uint8_t> swapped;
+  swapped.push_back (40);
+  swapped.push_back (35);
+  report = MakeReport (1, swapped);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), false, "delta report with a cell less");
+  enb.Decode (7, report, false);
+  report = MakeReport (1, swapped);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), true, "no delta report after a full report");
+  enb.Decode (7, report, true);
+  NS_TEST_ASSERT_MSG_EQ (GetRsrp (report).size (), 2, "reference not replaced by the full report");
+
+  // other measIds and UEs have their own references
+  report = MakeReport (2, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (7, report), false, "delta report for a new measId");
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (8, report), false, "delta report for a new UE");
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (enb.Decode (8, report, true), false, "delta report decoded without reference");
+
+  enb.RemoveUe (7);
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (enb.Decode (7, report, true), false, "UE not removed");
+  ue.Clear ();
+  report = MakeReport (1, rsrp);
+  NS_TEST_ASSERT_MSG_EQ (ue.Encode (8, report), false, "codec not cleared");
+}
+
+
+/**
+ * Test the delta encoding of the measurement reports
+ */
+class LteMeasurementReportDeltaCodecTestSuite : public TestSuite
+{
+public:
+  LteMeasurementReportDeltaCodecTestSuite ();
+};
+
+static LteMeasurementReportDeltaCodecTestSuite g_lteMeasurementReportDeltaCodecTestSuite;
+
+LteMeasurementReportDeltaCodecTestSuite::LteMeasurementReportDeltaCodecTestSuite ()
+  : TestSuite ("lte-measurement-report-delta-codec", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new LteMeasurementReportDeltaCodecTestCase (), TestCase::QUICK);
+}
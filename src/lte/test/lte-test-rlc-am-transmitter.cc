@@ -23,6 +23,7 @@
 
 #include "ns3/lte-rlc-header.h"
 #include "ns3/lte-rlc-am.h"
+#include "ns3/lte-pdcp-header.h"
 
 #include "lte-test-rlc-am-transmitter.h"
 #include "lte-test-entities.h"
@@ -45,6 +46,8 @@ LteRlcAmTransmitterTestSuite::LteRlcAmTransmitterTestSuite ()
   AddTestCase (new LteRlcAmTransmitterSegmentationTestCase ("Segmentation"), TestCase::QUICK);
   AddTestCase (new LteRlcAmTransmitterConcatenationTestCase ("Concatenation"), TestCase::QUICK);
   AddTestCase (new LteRlcAmTransmitterReportBufferStatusTestCase ("ReportBufferStatus primitive"), TestCase::QUICK);
+  AddTestCase (new LteRlcAmTransmitterDiscardTestCase ("PDCP SDU discard"), TestCase::QUICK);
+  AddTestCase (new LteRlcAmTransmitterMcPduBatchTestCase ("X2-U container of PDCP SDUs"), TestCase::QUICK);
 
 }
 
@@ -300,3 +303,141 @@ LteRlcAmTransmitterReportBufferStatusTestCase::DoRun (void)
   Simulator::Run ();
   Simulator::Destroy ();
 }
+
+/**
+ * Discard of PDCP SDUs not transmitted yet
+ */
+LteRlcAmTransmitterDiscardTestCase::LteRlcAmTransmitterDiscardTestCase (std::string name)
+  : LteRlcAmTransmitterTestCase (name)
+{
+}
+
+LteRlcAmTransmitterDiscardTestCase::~LteRlcAmTransmitterDiscardTestCase ()
+{
+}
+
+void
+LteRlcAmTransmitterDiscardTestCase::SendPdcpPdu (uint16_t sn, std::string data)
+{
+  Ptr<Packet> p = Create<Packet> ((uint8_t *) data.c_str (), data.length ());
+  LtePdcpHeader pdcpHeader;
+  pdcpHeader.SetDcBit (LtePdcpHeader::DATA_PDU);
+  pdcpHeader.SetSequenceNumber (sn);
+  p->AddHeader (pdcpHeader);
+
+  LteRlcSapProvider::TransmitPdcpPduParameters params;
+  params.pdcpPdu = p;
+  params.rnti = 1111;
+  params.lcid = 222;
+  txRlc->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+}
+
+void
+LteRlcAmTransmitterDiscardTestCase::Discard (std::vector<uint16_t> sns)
+{
+  txRlc->GetLteRlcSapProvider ()->DiscardPdcpSdus (sns);
+}
+
+void
+LteRlcAmTransmitterDiscardTestCase::CheckBuffer (uint32_t txBufferSize, uint64_t discardedBytes)
+{
+  Ptr<LteRlcAm> rlcAm = DynamicCast<LteRlcAm> (txRlc);
+  NS_TEST_ASSERT_MSG_EQ (rlcAm->GetTxBufferSize (), txBufferSize, "wrong tx buffer size");
+  NS_TEST_ASSERT_MSG_EQ (rlcAm->GetDiscardedBytes (), discardedBytes, "wrong discarded bytes");
+}
+
+void
+LteRlcAmTransmitterDiscardTestCase::DoRun (void)
+{
+  // Create topology
+  LteRlcAmTransmitterTestCase::DoRun ();
+
+  // three PDCP PDUs of 13, 13 and 9 bytes (3 bytes of PDCP header)
+  Simulator::Schedule (Seconds (0.100), &LteRlcAmTransmitterDiscardTestCase::SendPdcpPdu, this, 0, "ABCDEFGHIJ");
+  Simulator::Schedule (Seconds (0.100), &LteRlcAmTransmitterDiscardTestCase::SendPdcpPdu, this, 1, "KLMNOPQRST");
+  Simulator::Schedule (Seconds (0.100), &LteRlcAmTransmitterDiscardTestCase::SendPdcpPdu, this, 2, "UVWXYZ");
+
+  // the first 5 bytes of SN 0 are sent
+  txMac->SendTxOpportunity (Seconds (0.150), 4 + 5);
+
+  // SN 0 is already segmented and is kept, SN 1 is discarded
+  std::vector<uint16_t> sns;
+  sns.push_back (0);
+  sns.push_back (1);
+  Simulator::Schedule (Seconds (0.200), &LteRlcAmTransmitterDiscardTestCase::Discard, this, sns);
+  Simulator::Schedule (Seconds (0.250), &LteRlcAmTransmitterDiscardTestCase::CheckBuffer, this, 8 + 9, 13);
+
+  // unknown SNs are ignored
+  sns.clear ();
+  sns.push_back (7);
+  Simulator::Schedule (Seconds (0.300), &LteRlcAmTransmitterDiscardTestCase::Discard, this, sns);
+  Simulator::Schedule (Seconds (0.350), &LteRlcAmTransmitterDiscardTestCase::CheckBuffer, this, 8 + 9, 13);
+
+  txMac->SendTxOpportunity (Seconds (0.400), (4+2) + (8+9));
+  Simulator::Schedule (Seconds (0.450), &LteRlcAmTransmitterDiscardTestCase::CheckBuffer, this, 0, 13);
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * PDCP SDUs of an X2-U container stored at once
+ */
+
+LteRlcAmTransmitterMcPduBatchTestCase::LteRlcAmTransmitterMcPduBatchTestCase (std::string name)
+  : LteRlcAmTransmitterTestCase (name)
+{
+}
+
+LteRlcAmTransmitterMcPduBatchTestCase::~LteRlcAmTransmitterMcPduBatchTestCase ()
+{
+}
+
+void
+LteRlcAmTransmitterMcPduBatchTestCase::SendMcPdcpSdus (std::vector<std::string> data)
+{
+  std::vector<EpcX2Sap::UeDataParams> params;
+  for (std::vector<std::string>::iterator it = data.begin (); it != data.end (); ++it)
+    {
+      EpcX2Sap::UeDataParams pdu;
+      pdu.sourceCellId = 1;
+      pdu.targetCellId = 2;
+      pdu.gtpTeid = 1;
+      pdu.ueData = Create<Packet> ((uint8_t *) it->c_str (), it->length ());
+      params.push_back (pdu);
+    }
+  txRlc->GetEpcX2RlcUser ()->SendMcPdcpSdus (params);
+}
+
+void
+LteRlcAmTransmitterMcPduBatchTestCase::CheckBuffer (uint32_t txBufferSize, uint32_t bufferStatusReports)
+{
+  Ptr<LteRlcAm> rlcAm = DynamicCast<LteRlcAm> (txRlc);
+  NS_TEST_ASSERT_MSG_EQ (rlcAm->GetTxBufferSize (), txBufferSize, "wrong tx buffer size");
+  NS_TEST_ASSERT_MSG_EQ (txMac->GetBufferStatusReports (), bufferStatusReports, "wrong number of buffer status reports");
+}
+
+void
+LteRlcAmTransmitterMcPduBatchTestCase::DoRun (void)
+{
+  // Create topology
+  LteRlcAmTransmitterTestCase::DoRun ();
+
+  // three SDUs unpacked from one X2-U container, one buffer status report
+  std::vector<std::string> data;
+  data.push_back ("ABCDEFGH");
+  data.push_back ("IJKLMNOPQR");
+  data.push_back ("STUVWXYZ");
+  Simulator::Schedule (Seconds (0.100), &LteRlcAmTransmitterMcPduBatchTestCase::SendMcPdcpSdus, this, data);
+  Simulator::Schedule (Seconds (0.110), &LteRlcAmTransmitterMcPduBatchTestCase::CheckBuffer, this, 8 + 10 + 8, 1);
+
+  // they are transmitted in order
+  txMac->SendTxOpportunity (Seconds (0.150), 33);
+  CheckDataReceived (Seconds (0.200), "ABCDEFGHIJKLMNOPQRSTUVWXYZ", "SDUs of the container not in order");
+
+  Simulator::Stop (Seconds (0.3));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
@@ -124,4 +124,39 @@ class LteRlcAmTransmitterReportBufferStatusTestCase : public LteRlcAmTransmitter
 
 };
 
+/**
+ * Discard of PDCP SDUs not transmitted yet (duplicated bearers)
+ */
+class LteRlcAmTransmitterDiscardTestCase : public LteRlcAmTransmitterTestCase
+{
+  public:
+    LteRlcAmTransmitterDiscardTestCase (std::string name);
+    LteRlcAmTransmitterDiscardTestCase ();
+    virtual ~LteRlcAmTransmitterDiscardTestCase ();
+
+  private:
+    virtual void DoRun (void);
+    void SendPdcpPdu (uint16_t sn, std::string data);
+    void Discard (std::vector<uint16_t> sns);
+    void CheckBuffer (uint32_t txBufferSize, uint64_t discardedBytes);
+
+};
+
+/**
+ * PDCP SDUs of an X2-U container stored at once (split bearers)
+ */
+class LteRlcAmTransmitterMcPduBatchTestCase : public LteRlcAmTransmitterTestCase
+{
+  public:
+    LteRlcAmTransmitterMcPduBatchTestCase (std::string name);
+    LteRlcAmTransmitterMcPduBatchTestCase ();
+    virtual ~LteRlcAmTransmitterMcPduBatchTestCase ();
+
+  private:
+    virtual void DoRun (void);
+    void SendMcPdcpSdus (std::vector<std::string> data);
+    void CheckBuffer (uint32_t txBufferSize, uint32_t bufferStatusReports);
+
+};
+
 #endif // LTE_TEST_RLC_AM_TRANSMITTER_H
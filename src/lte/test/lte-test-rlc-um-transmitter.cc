@@ -47,6 +47,7 @@ LteRlcUmTransmitterTestSuite::LteRlcUmTransmitterTestSuite ()
   AddTestCase (new LteRlcUmTransmitterSegmentationTestCase ("Segmentation"), TestCase::QUICK);
   AddTestCase (new LteRlcUmTransmitterConcatenationTestCase ("Concatenation"), TestCase::QUICK);
   AddTestCase (new LteRlcUmTransmitterReportBufferStatusTestCase ("ReportBufferStatus primitive"), TestCase::QUICK);
+  AddTestCase (new LteRlcUmTransmitterTakeTxBufferTestCase ("Transmission buffer taken"), TestCase::QUICK);
 
 }
 
@@ -297,3 +298,62 @@ LteRlcUmTransmitterReportBufferStatusTestCase::DoRun (void)
   Simulator::Run ();
   Simulator::Destroy ();
 }
+
+
+/**
+ * Transmission buffer moved out of the RLC
+ */
+LteRlcUmTransmitterTakeTxBufferTestCase::LteRlcUmTransmitterTakeTxBufferTestCase (std::string name)
+  : LteRlcUmTransmitterTestCase (name)
+{
+}
+
+LteRlcUmTransmitterTakeTxBufferTestCase::~LteRlcUmTransmitterTakeTxBufferTestCase ()
+{
+}
+
+void
+LteRlcUmTransmitterTakeTxBufferTestCase::TakeTxBuffer (std::string taken)
+{
+  Ptr<LteRlcUm> rlcUm = DynamicCast<LteRlcUm> (txRlc);
+  uint32_t bufferStatusReports = txMac->GetBufferStatusReports ();
+  std::vector < Ptr<Packet> > buffer;
+  rlcUm->TakeTxBuffer (buffer);
+
+  std::string data;
+  for (std::vector < Ptr<Packet> >::iterator it = buffer.begin (); it != buffer.end (); ++it)
+    {
+      uint32_t size = (*it)->GetSize ();
+      uint8_t *bytes = new uint8_t[size];
+      (*it)->CopyData (bytes, size);
+      data += std::string ((char *) bytes, size);
+      delete [] bytes;
+    }
+  NS_TEST_ASSERT_MSG_EQ (data, taken, "SDUs taken not in order");
+  NS_TEST_ASSERT_MSG_EQ (rlcUm->GetTxBufferSize (), 0, "transmission buffer not empty");
+  NS_TEST_ASSERT_MSG_EQ (txMac->GetBufferStatusReports (), bufferStatusReports + 1, "empty buffer not reported");
+}
+
+void
+LteRlcUmTransmitterTakeTxBufferTestCase::DoRun (void)
+{
+  // Create topology
+  LteRlcUmTransmitterTestCase::DoRun ();
+
+  // a SDU partly sent, the rest is taken with the whole SDUs after it
+  txPdcp->SendData (Seconds (0.100), "ABCDEFGHIJ");
+  txPdcp->SendData (Seconds (0.150), "KLMNOPQRS");
+  txPdcp->SendData (Seconds (0.200), "TUVWXYZ");
+  txMac->SendTxOpportunity (Seconds (0.250), 2 + 4);
+  CheckDataReceived (Seconds (0.300), "ABCD", "SDU is not OK");
+  Simulator::Schedule (Seconds (0.350), &LteRlcUmTransmitterTakeTxBufferTestCase::TakeTxBuffer, this,
+                       "EFGHIJKLMNOPQRSTUVWXYZ");
+
+  // the RLC goes on with the new SDUs only
+  txPdcp->SendData (Seconds (0.400), "ABCDEFGH");
+  txMac->SendTxOpportunity (Seconds (0.450), 2 + 8);
+  CheckDataReceived (Seconds (0.500), "ABCDEFGH", "SDU is not OK");
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
@@ -123,4 +123,21 @@ class LteRlcUmTransmitterReportBufferStatusTestCase : public LteRlcUmTransmitter
 
 };
 
+/**
+ * Transmission buffer moved out of the RLC, as in the bulk transfer
+ * of a secondary cell handover
+ */
+class LteRlcUmTransmitterTakeTxBufferTestCase : public LteRlcUmTransmitterTestCase
+{
+  public:
+    LteRlcUmTransmitterTakeTxBufferTestCase (std::string name);
+    LteRlcUmTransmitterTakeTxBufferTestCase ();
+    virtual ~LteRlcUmTransmitterTakeTxBufferTestCase ();
+
+  private:
+    virtual void DoRun (void);
+    void TakeTxBuffer (std::string taken);
+
+};
+
 #endif /* LTE_TEST_RLC_UM_TRANSMITTER_H */
@@ -0,0 +1,131 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+#include "ns3/sinr-trajectory-predictor.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestSinrTrajectoryPredictor");
+
+/**
+ * Feeds SINR ramps to a SinrTrajectoryPredictor and checks the forecasts,
+ * the ring buffer wrap around, the age limit of the samples and the
+ * removal of a UE.
+ */
+class LteSinrTrajectoryPredictorTestCase : public TestCase
+{
+public:
+  LteSinrTrajectoryPredictorTestCase ();
+  virtual ~LteSinrTrajectoryPredictorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteSinrTrajectoryPredictorTestCase::LteSinrTrajectoryPredictorTestCase ()
+  : TestCase ("SINR trajectory forecast")
+{
+}
+
+LteSinrTrajectoryPredictorTestCase::~LteSinrTrajectoryPredictorTestCase ()
+{
+}
+
+void
+LteSinrTrajectoryPredictorTestCase::DoRun (void)
+{
+  SinrTrajectoryPredictor predictor;
+  predictor.SetHistoryLength (4);
+  double sinrDb = 0;
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 2, MilliSeconds (10), sinrDb), false, "forecast without samples");
+
+  predictor.AddSample (1, 2, MilliSeconds (0), 20);
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 2, MilliSeconds (10), sinrDb), false, "forecast with a single sample");
+  predictor.AddSample (1, 2, MilliSeconds (0), 20);
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 2, MilliSeconds (10), sinrDb), false, "forecast with no time span");
+
+  // 20 dB falling by 1 dB per ms
+  predictor.AddSample (1, 2, MilliSeconds (1), 19);
+  predictor.AddSample (1, 2, MilliSeconds (2), 18);
+  NS_TEST_ASSERT_MSG_EQ (predictor.GetNSamples (1, 2), 4, "wrong number of samples");
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 2, MilliSeconds (52), sinrDb), true, "no forecast");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, -32, 1e-6, "wrong forecast of a falling SINR");
+
+  // the ring buffer drops the samples at time 0, the line becomes exact
+  predictor.AddSample (1, 2, MilliSeconds (3), 17);
+  predictor.AddSample (1, 2, MilliSeconds (4), 16);
+  NS_TEST_ASSERT_MSG_EQ (predictor.GetNSamples (1, 2), 4, "history longer than its length");
+  predictor.Predict (1, 2, MilliSeconds (54), sinrDb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, -34, 1e-6, "oldest samples not replaced");
+  predictor.AddSample (1, 2, MilliSeconds (5), 15);
+  predictor.AddSample (1, 2, MilliSeconds (6), 14);
+  predictor.AddSample (1, 2, MilliSeconds (7), 13);
+  predictor.Predict (1, 2, MilliSeconds (7), sinrDb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, 13, 1e-6, "wrong forecast after a wrap around");
+
+  // another cell of the same UE and another UE are kept apart
+  predictor.AddSample (1, 3, MilliSeconds (0), 5);
+  predictor.AddSample (1, 3, MilliSeconds (10), 10);
+  predictor.AddSample (4, 2, MilliSeconds (0), 0);
+  predictor.AddSample (4, 2, MilliSeconds (10), 0);
+  predictor.Predict (1, 3, MilliSeconds (50), sinrDb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, 30, 1e-6, "wrong forecast of a rising SINR");
+  predictor.Predict (4, 2, MilliSeconds (100), sinrDb);
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, 0, 1e-6, "wrong forecast of a flat SINR");
+
+  // the samples older than the maximum age are ignored
+  predictor.SetMaxSampleAge (MilliSeconds (50));
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 3, MilliSeconds (50), sinrDb), true, "recent samples ignored");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, 30, 1e-6, "wrong forecast with recent samples");
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 3, MilliSeconds (55), sinrDb), false, "forecast with a single recent sample");
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 3, MilliSeconds (1000), sinrDb), false, "forecast from stale samples");
+  predictor.AddSample (1, 3, MilliSeconds (990), 0);
+  predictor.AddSample (1, 3, MilliSeconds (1000), 1);
+  NS_TEST_ASSERT_MSG_EQ (predictor.Predict (1, 3, MilliSeconds (1010), sinrDb), true, "no forecast from new samples");
+  NS_TEST_ASSERT_MSG_EQ_TOL (sinrDb, 2, 1e-6, "stale samples used in the forecast");
+  predictor.SetMaxSampleAge (Seconds (0));
+
+  predictor.RemoveUe (1);
+  NS_TEST_ASSERT_MSG_EQ (predictor.GetNSamples (1, 2), 0, "UE not removed");
+  NS_TEST_ASSERT_MSG_EQ (predictor.GetNSamples (1, 3), 0, "UE not removed");
+  NS_TEST_ASSERT_MSG_EQ (predictor.GetNSamples (4, 2), 2, "another UE removed");
+
+  predictor.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (predictor.GetNSamples (4, 2), 0, "predictor not cleared");
+}
+
+
+/**
+ * Test the SINR forecast of the coordinator eNB
+ */
+class LteSinrTrajectoryPredictorTestSuite : public TestSuite
+{
+public:
+  LteSinrTrajectoryPredictorTestSuite ();
+};
+
+static LteSinrTrajectoryPredictorTestSuite g_lteSinrTrajectoryPredictorTestSuite;
+
+LteSinrTrajectoryPredictorTestSuite::LteSinrTrajectoryPredictorTestSuite ()
+  : TestSuite ("lte-sinr-trajectory-predictor", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new LteSinrTrajectoryPredictorTestCase (), TestCase::QUICK);
+}
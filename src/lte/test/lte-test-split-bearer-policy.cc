@@ -0,0 +1,140 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/object-factory.h"
+
+#include "ns3/split-bearer-policy.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestSplitBearerPolicy");
+
+/**
+ * Feeds a split bearer policy with a fluid model of two legs, which drain
+ * their queue at a constant rate and report it every millisecond, and checks
+ * the share of bytes sent on the first leg and that the queues stay bounded.
+ */
+class LteSplitBearerPolicyTestCase : public TestCase
+{
+public:
+  LteSplitBearerPolicyTestCase (std::string policyType, double rate0, double rate1,
+                                double minShare0, double maxShare0);
+  virtual ~LteSplitBearerPolicyTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Tick ();
+
+  std::string m_policyType;
+  double m_rate[2];     // bytes per tick
+  double m_minShare0;
+  double m_maxShare0;
+  double m_queue[2];
+  Ptr<SplitBearerPolicy> m_policy;
+};
+
+LteSplitBearerPolicyTestCase::LteSplitBearerPolicyTestCase (std::string policyType,
+                                                            double rate0, double rate1,
+                                                            double minShare0, double maxShare0)
+  : TestCase (policyType),
+    m_policyType (policyType),
+    m_minShare0 (minShare0),
+    m_maxShare0 (maxShare0)
+{
+  m_rate[0] = rate0;
+  m_rate[1] = rate1;
+}
+
+LteSplitBearerPolicyTestCase::~LteSplitBearerPolicyTestCase ()
+{
+}
+
+void
+LteSplitBearerPolicyTestCase::Tick ()
+{
+  const uint32_t pduSize = 400;
+  const uint32_t pdusPerTick = 8;   // 80% of the aggregate rate
+  for (uint32_t i = 0; i < pdusPerTick; ++i)
+    {
+      uint16_t cellId = m_policy->SelectCell (pduSize);
+      m_queue[cellId == 1 ? 0 : 1] += pduSize;
+    }
+  for (uint8_t leg = 0; leg < 2; ++leg)
+    {
+      m_queue[leg] = std::max (0.0, m_queue[leg] - m_rate[leg]);
+      EpcX2Sap::AssistantInformationForSplitting info;
+      info.Tx_On_Q_Size = (uint32_t) m_queue[leg];
+      info.Tx_On_Q_Delay = (uint32_t) (m_queue[leg] / m_rate[leg]);
+      m_policy->ReportAssistantInfo (leg + 1, info);
+    }
+  Simulator::Schedule (MilliSeconds (1), &LteSplitBearerPolicyTestCase::Tick, this);
+}
+
+void
+LteSplitBearerPolicyTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (m_policyType);
+  m_policy = factory.Create<SplitBearerPolicy> ();
+  m_policy->SetLegs (1, 2);
+  m_queue[0] = 0;
+  m_queue[1] = 0;
+
+  Simulator::Schedule (MilliSeconds (1), &LteSplitBearerPolicyTestCase::Tick, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  double tx0 = m_policy->GetLegInfo (0).txBytes;
+  double tx1 = m_policy->GetLegInfo (1).txBytes;
+  double share0 = tx0 / (tx0 + tx1);
+  NS_LOG_INFO (m_policyType << " share0 " << share0 << " queues " << m_queue[0] << " " << m_queue[1]);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (share0, m_minShare0, "too little traffic on the first leg");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (share0, m_maxShare0, "too much traffic on the first leg");
+  NS_TEST_ASSERT_MSG_LT (m_queue[0] + m_queue[1], 50000, "the legs are not stable");
+
+  m_policy = 0;
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Test the split bearer policies of McEnbPdcp
+ */
+class LteSplitBearerPolicyTestSuite : public TestSuite
+{
+public:
+  LteSplitBearerPolicyTestSuite ();
+};
+
+static LteSplitBearerPolicyTestSuite g_lteSplitBearerPolicyTestSuite;
+
+LteSplitBearerPolicyTestSuite::LteSplitBearerPolicyTestSuite ()
+  : TestSuite ("lte-split-bearer-policy", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  // first leg three times faster than the second one
+  AddTestCase (new LteSplitBearerPolicyTestCase ("ns3::DelayEqualizingSplitPolicy", 3000, 1000, 0.6, 0.85), TestCase::QUICK);
+  AddTestCase (new LteSplitBearerPolicyTestCase ("ns3::BacklogWeightedSplitPolicy", 3000, 1000, 0.6, 0.85), TestCase::QUICK);
+  AddTestCase (new LteSplitBearerPolicyTestCase ("ns3::ThroughputProportionalSplitPolicy", 3000, 1000, 0.6, 0.85), TestCase::QUICK);
+  // symmetric legs
+  AddTestCase (new LteSplitBearerPolicyTestCase ("ns3::DelayEqualizingSplitPolicy", 2000, 2000, 0.45, 0.55), TestCase::QUICK);
+  AddTestCase (new LteSplitBearerPolicyTestCase ("ns3::BacklogWeightedSplitPolicy", 2000, 2000, 0.45, 0.55), TestCase::QUICK);
+  AddTestCase (new LteSplitBearerPolicyTestCase ("ns3::ThroughputProportionalSplitPolicy", 2000, 2000, 0.45, 0.55), TestCase::QUICK);
+}
@@ -1020,6 +1020,162 @@ MeasurementReportTestCase::DoRun (void)
   packet = 0;
 }
 
+// --------------------------- CLASS ReceivedHeaderReserializationTestCase -----------------------------
+/**
+ * Checks that a received header is not encoded again: its size is the
+ * number of octets read, even if a payload follows it, and serializing it
+ * again gives back the received octets.
+ */
+class ReceivedHeaderReserializationTestCase : public RrcHeaderTestCase
+{
+public:
+  ReceivedHeaderReserializationTestCase ();
+  virtual void DoRun (void);
+};
+
+ReceivedHeaderReserializationTestCase::ReceivedHeaderReserializationTestCase () : RrcHeaderTestCase ("Testing serialization of a received header")
+{
+}
+
+void
+ReceivedHeaderReserializationTestCase::DoRun (void)
+{
+  packet = Create<Packet> (17);
+  NS_LOG_DEBUG ("============= ReceivedHeaderReserializationTestCase ===========");
+
+  LteRrcSap::MeasurementReport msg;
+  msg.measResults.measId = 3;
+  msg.measResults.rsrpResult = 97;
+  msg.measResults.rsrqResult = 34;
+  msg.measResults.haveMeasResultNeighCells = true;
+  for (uint16_t i = 0; i < 6; i++)
+    {
+      LteRrcSap::MeasResultEutra mResEutra;
+      mResEutra.physCellId = 100 + i;
+      mResEutra.haveRsrpResult = true;
+      mResEutra.rsrpResult = 40 + i;
+      mResEutra.haveRsrqResult = (i % 2 == 0);
+      mResEutra.rsrqResult = 10 + i;
+      mResEutra.haveCgiInfo = false;
+      msg.measResults.measResultListEutra.push_back (mResEutra);
+    }
+
+  MeasurementReportHeader source;
+  source.SetMessage (msg);
+  packet->AddHeader (source);
+  std::string sent = TestUtils::sprintPacketContentsHex (packet);
+  TestUtils::LogPacketContents (packet);
+
+  MeasurementReportHeader destination;
+  uint32_t removed = packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (removed, source.GetSerializedSize (), "Different header size!");
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 17, "The payload was not left in the packet!");
+
+  packet->AddHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (TestUtils::sprintPacketContentsHex (packet), sent, "Different octets after serializing the received header!");
+
+  // A new message must be encoded again
+  msg.measResults.measId = 4;
+  destination.SetMessage (msg);
+  Ptr<Packet> other = Create<Packet> (17);
+  other->AddHeader (destination);
+  MeasurementReportHeader check;
+  other->RemoveHeader (check);
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) check.GetMessage ().measResults.measId, 4, "Different measId!");
+  NS_TEST_ASSERT_MSG_EQ (check.GetMessage ().measResults.measResultListEutra.size (), 6, "Different number of neighbour cells!");
+
+  packet = 0;
+}
+
+// --------------------------- CLASS RrcCoalescedMessagesTestCase -----------------------------
+/**
+ * Packs a delta measurement report and a reconfiguration complete message
+ * in one container and unpacks them as the eNB does.
+ */
+class RrcCoalescedMessagesTestCase : public RrcHeaderTestCase
+{
+public:
+  RrcCoalescedMessagesTestCase ();
+  virtual void DoRun (void);
+};
+
+RrcCoalescedMessagesTestCase::RrcCoalescedMessagesTestCase () : RrcHeaderTestCase ("Testing RrcCoalescedMessagesTestCase")
+{
+}
+
+void
+RrcCoalescedMessagesTestCase::DoRun (void)
+{
+  packet = Create<Packet> ();
+  NS_LOG_DEBUG ("============= RrcCoalescedMessagesTestCase ===========");
+
+  LteRrcSap::MeasurementReport report;
+  report.measResults.measId = 2;
+  report.measResults.rsrpResult = 50;
+  report.measResults.rsrqResult = 20;
+  report.measResults.haveMeasResultNeighCells = true;
+  LteRrcSap::MeasResultEutra mResEutra;
+  mResEutra.physCellId = 4;
+  mResEutra.haveRsrpResult = true;
+  mResEutra.rsrpResult = 45;
+  mResEutra.haveRsrqResult = false;
+  mResEutra.haveCgiInfo = false;
+  report.measResults.measResultListEutra.push_back (mResEutra);
+
+  MeasurementReportHeader reportHeader;
+  reportHeader.SetMessage (report);
+  reportHeader.SetDelta (true);
+  Ptr<Packet> first = Create<Packet> ();
+  first->AddHeader (reportHeader);
+
+  LteRrcSap::RrcConnectionReconfigurationCompleted reconfigurationCompleted;
+  reconfigurationCompleted.rrcTransactionIdentifier = 3;
+  RrcConnectionReconfigurationCompleteHeader reconfigurationHeader;
+  reconfigurationHeader.SetMessage (reconfigurationCompleted);
+  Ptr<Packet> second = Create<Packet> ();
+  second->AddHeader (reconfigurationHeader);
+
+  std::vector<uint16_t> sizes;
+  sizes.push_back (first->GetSize ());
+  sizes.push_back (second->GetSize ());
+  packet->AddAtEnd (first);
+  packet->AddAtEnd (second);
+  RrcCoalescedMessagesHeader source;
+  source.SetMessageSizes (sizes);
+  packet->AddHeader (source);
+
+  // Log serialized packet contents
+  TestUtils::LogPacketContents (packet);
+
+  RrcUlDcchMessage ulDcchMessage;
+  packet->PeekHeader (ulDcchMessage);
+  NS_TEST_ASSERT_MSG_EQ (ulDcchMessage.GetMessageType (), 6, "Wrong message type of the container!");
+
+  RrcCoalescedMessagesHeader destination;
+  packet->RemoveHeader (destination);
+  NS_TEST_ASSERT_MSG_EQ (destination.GetMessageSizes ().size (), 2, "Different number of messages!");
+  NS_TEST_ASSERT_MSG_EQ (destination.GetMessageSizes ()[0], sizes[0], "Different size of the first message!");
+  NS_TEST_ASSERT_MSG_EQ (destination.GetMessageSizes ()[1], sizes[1], "Different size of the second message!");
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), sizes[0] + sizes[1], "Different size of the messages!");
+
+  Ptr<Packet> fragment = packet->CreateFragment (0, sizes[0]);
+  RrcUlDcchMessage fragmentUlDcchMessage;
+  fragment->PeekHeader (fragmentUlDcchMessage);
+  NS_TEST_ASSERT_MSG_EQ (fragmentUlDcchMessage.GetMessageType (), 7, "Wrong message type of a delta report!");
+  MeasurementReportHeader reportDestination;
+  fragment->RemoveHeader (reportDestination);
+  NS_TEST_ASSERT_MSG_EQ (reportDestination.IsDelta (), true, "Delta flag lost!");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) reportDestination.GetMessage ().measResults.measId, 2, "Different measId!");
+  NS_TEST_ASSERT_MSG_EQ (reportDestination.GetMessage ().measResults.measResultListEutra.front ().rsrpResult, 45, "Different rsrpResult!");
+
+  fragment = packet->CreateFragment (sizes[0], sizes[1]);
+  RrcConnectionReconfigurationCompleteHeader reconfigurationDestination;
+  fragment->RemoveHeader (reconfigurationDestination);
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) reconfigurationDestination.GetRrcTransactionIdentifier (), 3, "Different rrcTransactionIdentifier!");
+
+  packet = 0;
+}
+
 // --------------------------- CLASS Asn1EncodingSuite -----------------------------
 class Asn1EncodingSuite : public TestSuite
 {
@@ -1042,6 +1198,8 @@ Asn1EncodingSuite::Asn1EncodingSuite ()
   AddTestCase (new RrcConnectionReestablishmentCompleteTestCase (), TestCase::QUICK);
   AddTestCase (new RrcConnectionRejectTestCase (), TestCase::QUICK);
   AddTestCase (new MeasurementReportTestCase (), TestCase::QUICK);
+  AddTestCase (new ReceivedHeaderReserializationTestCase (), TestCase::QUICK);
+  AddTestCase (new RrcCoalescedMessagesTestCase (), TestCase::QUICK);
 }
 
 Asn1EncodingSuite asn1EncodingSuite;
@@ -59,6 +59,11 @@ CoreNetworkStatsCalculator::GetTypeId (void)
                    StringValue ("MmeStats.txt"),
                    MakeStringAccessor (&CoreNetworkStatsCalculator::SetMmeOutputFilename),
                    MakeStringChecker ())
+    .AddAttribute ("X2McPduBatchFileName",
+                   "Name of the file where the X2-U containers of PDCP PDUs sent will be logged.",
+                   StringValue ("X2McPduBatchStats.txt"),
+                   MakeStringAccessor (&CoreNetworkStatsCalculator::SetX2McPduBatchOutputFilename),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -95,6 +100,19 @@ CoreNetworkStatsCalculator::LogMmePacket (std::string path, uint16_t sourceCellI
   m_mmeOutFile << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << sourceCellId << " " << targetCellId << " " << size << " " << delay << std::endl;
 }
 
+void
+CoreNetworkStatsCalculator::LogX2McPduBatch (std::string path, uint16_t sourceCellId, uint16_t targetCellId, uint32_t teid, uint32_t numPdus, uint32_t size, uint64_t delay)
+{
+  NS_LOG_FUNCTION (this << "LogX2McPduBatch" << sourceCellId << targetCellId << teid << numPdus << size << delay);
+
+  if (!m_x2McPduBatchOutFile.is_open ())
+  {
+    m_x2McPduBatchOutFile.open (GetX2McPduBatchOutputFilename ().c_str ());
+  }
+
+  m_x2McPduBatchOutFile << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << sourceCellId << " " << targetCellId << " " << teid << " " << numPdus << " " << size << " " << delay << std::endl;
+}
+
 std::string
 CoreNetworkStatsCalculator::GetX2OutputFilename (void)
 {
@@ -107,6 +125,12 @@ CoreNetworkStatsCalculator::GetMmeOutputFilename (void)
   return m_mmeOutFileName;
 }
 
+std::string
+CoreNetworkStatsCalculator::GetX2McPduBatchOutputFilename (void)
+{
+  return m_x2McPduBatchOutFileName;
+}
+
 void
 CoreNetworkStatsCalculator::SetX2OutputFilename (std::string outputFilename)
 {
@@ -119,4 +143,10 @@ CoreNetworkStatsCalculator::SetMmeOutputFilename (std::string outputFilename)
   m_mmeOutFileName = outputFilename;
 }
 
+void
+CoreNetworkStatsCalculator::SetX2McPduBatchOutputFilename (std::string outputFilename)
+{
+  m_x2McPduBatchOutFileName = outputFilename;
+}
+
 } // namespace ns3
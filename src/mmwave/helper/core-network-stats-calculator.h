@@ -45,18 +45,23 @@ public:
 
   void LogX2Packet (std::string path, uint16_t sourceCellId, uint16_t targetCellId, uint32_t size, uint64_t delay, bool data);
   void LogMmePacket (std::string path, uint16_t sourceCellId, uint16_t targetCellId, uint32_t size, uint64_t delay);
+  void LogX2McPduBatch (std::string path, uint16_t sourceCellId, uint16_t targetCellId, uint32_t teid, uint32_t numPdus, uint32_t size, uint64_t delay);
 
   std::string GetX2OutputFilename (void);
   std::string GetMmeOutputFilename (void);
+  std::string GetX2McPduBatchOutputFilename (void);
   void SetX2OutputFilename (std::string outputFilename);
   void SetMmeOutputFilename (std::string outputFilename);
+  void SetX2McPduBatchOutputFilename (std::string outputFilename);
 
 private:
   std::string m_mmeOutFileName;
   std::string m_x2OutFileName;
+  std::string m_x2McPduBatchOutFileName;
 
   std::ofstream m_x2OutFile;
   std::ofstream m_mmeOutFile;
+  std::ofstream m_x2McPduBatchOutFile;
 
 };
 
@@ -38,6 +38,7 @@
 
 #include "ns3/string.h"
 #include "ns3/nstime.h"
+#include "ns3/simulator.h"
 
 #include <ns3/lte-enb-rrc.h>
 #include <ns3/lte-enb-net-device.h>
@@ -206,6 +207,14 @@ MmWaveBearerStatsConnector::~MmWaveBearerStatsConnector ()
   {
     m_lteSinrOutFile.close();
   }
+  if(m_predictedOutageOutFile.is_open())
+  {
+    m_predictedOutageOutFile.close();
+  }
+  if(m_srbLoadOutFile.is_open())
+  {
+    m_srbLoadOutFile.close();
+  }
 }
 
 TypeId
@@ -236,6 +245,21 @@ MmWaveBearerStatsConnector::GetTypeId (void)
                StringValue ("LteSinrTime.txt"),
                MakeStringAccessor (&MmWaveBearerStatsConnector::SetLteSinrOutputFilename),
                MakeStringChecker ())
+    .AddAttribute ("PredictedOutageOutputFilename",
+               "Name of the file where the outages forecast by the LTE eNB will be saved.",
+               StringValue ("PredictedOutageStats.txt"),
+               MakeStringAccessor (&MmWaveBearerStatsConnector::SetPredictedOutageOutputFilename),
+               MakeStringChecker ())
+    .AddAttribute ("SrbLoadOutputFilename",
+               "Name of the file where the SRB load sent by each UE will be saved.",
+               StringValue ("SrbLoadStats.txt"),
+               MakeStringAccessor (&MmWaveBearerStatsConnector::SetSrbLoadOutputFilename),
+               MakeStringChecker ())
+    .AddAttribute ("SrbLoadPeriod",
+               "Period over which the SRB load of each UE is averaged.",
+               TimeValue (Seconds (1)),
+               MakeTimeAccessor (&MmWaveBearerStatsConnector::m_srbLoadPeriod),
+               MakeTimeChecker ())
     .AddAttribute ("UeHandoverStartOutputFilename",
                    "Name of the file where the UE handover start events will be saved.",
                    StringValue ("UeHandoverStartStats.txt"),
@@ -259,6 +283,7 @@ void
 MmWaveBearerStatsConnector::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_srbLoadEvent.Cancel ();
 }
 
 void 
@@ -319,6 +344,17 @@ MmWaveBearerStatsConnector::EnsureConnected ()
           MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyMmWaveSinr, this));
       Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportCurrentCellRsrpSinr",
                    MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyLteSinr, this));
+      Config::Connect ("/NodeList/*/DeviceList/*/LteEnbRrc/PredictedOutage",
+          MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyPredictedOutage, this));
+      // signalling sent by the UEs, all their RRC instances together
+      Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/$ns3::LteUeRrcProtocolReal/TxSrbPdu",
+          MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyTxSrbPdu, this));
+      Config::Connect ("/NodeList/*/DeviceList/*/LteUeRrc/$ns3::MmWaveLteUeRrcProtocolReal/TxSrbPdu",
+          MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyTxSrbPdu, this));
+      Config::Connect ("/NodeList/*/DeviceList/*/MmWaveUeRrc/$ns3::MmWaveLteUeRrcProtocolReal/TxSrbPdu",
+          MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyTxSrbPdu, this));
+      Config::Connect ("/NodeList/*/DeviceList/*/MmWaveUeRrc_2/$ns3::MmWaveLteUeRrcProtocolReal/TxSrbPdu",
+          MakeBoundCallback (&MmWaveBearerStatsConnector::NotifyTxSrbPdu, this));
       m_connected = true;
     }
 }
@@ -427,6 +463,63 @@ MmWaveBearerStatsConnector::PrintLteSinr (uint16_t rnti, uint16_t cellId, double
   m_lteSinrOutFile << Simulator::Now().GetNanoSeconds()/1.0e9 << " " << rnti << " " << cellId << " " << sinr << std::endl;
 }
 
+void 
+MmWaveBearerStatsConnector::NotifyPredictedOutage (MmWaveBearerStatsConnector* c, std::string context, uint64_t imsi, uint16_t cellId, uint16_t targetCellId, bool confirmed, Time leadTime)
+{
+  c->PrintPredictedOutage (imsi, cellId, targetCellId, confirmed, leadTime);
+}
+
+void
+MmWaveBearerStatsConnector::PrintPredictedOutage (uint64_t imsi, uint16_t cellId, uint16_t targetCellId, bool confirmed, Time leadTime)
+{
+  NS_LOG_FUNCTION(this << " PrintPredictedOutage " << Simulator::Now().GetSeconds());
+  if(!m_predictedOutageOutFile.is_open ())
+  {
+    m_predictedOutageOutFile.open(GetPredictedOutageOutputFilename() .c_str());
+  }
+  m_predictedOutageOutFile << Simulator::Now().GetNanoSeconds()/1.0e9 << " " << imsi << " " << cellId << " " << targetCellId << " " << confirmed << " " << leadTime.GetSeconds() << std::endl;
+}
+
+void
+MmWaveBearerStatsConnector::NotifyTxSrbPdu (MmWaveBearerStatsConnector* c, std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint32_t size, uint32_t nMessages)
+{
+  std::map<uint64_t, SrbLoad>::iterator it = c->m_srbLoad.find (imsi);
+  if (it == c->m_srbLoad.end ())
+    {
+      SrbLoad load;
+      load.bytes = 0;
+      load.pdus = 0;
+      load.messages = 0;
+      it = c->m_srbLoad.insert (std::make_pair (imsi, load)).first;
+    }
+  it->second.bytes += size;
+  it->second.pdus++;
+  it->second.messages += nMessages;
+  if (!c->m_srbLoadEvent.IsRunning ())
+    {
+      c->m_srbLoadEvent = Simulator::Schedule (c->m_srbLoadPeriod, &MmWaveBearerStatsConnector::PrintSrbLoad, c);
+    }
+}
+
+void
+MmWaveBearerStatsConnector::PrintSrbLoad ()
+{
+  NS_LOG_FUNCTION(this << " PrintSrbLoad " << Simulator::Now().GetSeconds());
+  if(!m_srbLoadOutFile.is_open ())
+  {
+    m_srbLoadOutFile.open(GetSrbLoadOutputFilename() .c_str());
+  }
+  // time, IMSI, bytes/s, PDUs/s and RRC messages/s
+  double period = m_srbLoadPeriod.GetSeconds ();
+  for (std::map<uint64_t, SrbLoad>::const_iterator it = m_srbLoad.begin (); it != m_srbLoad.end (); ++it)
+    {
+      m_srbLoadOutFile << Simulator::Now().GetNanoSeconds()/1.0e9 << " " << it->first << " " << it->second.bytes / period
+                       << " " << it->second.pdus / period << " " << it->second.messages / period << std::endl;
+    }
+  // the next period starts with the next PDU
+  m_srbLoad.clear ();
+}
+
 std::string 
 MmWaveBearerStatsConnector::GetEnbHandoverStartOutputFilename (void)
 {
@@ -445,6 +538,18 @@ MmWaveBearerStatsConnector::GetMmWaveSinrOutputFilename (void)
   return m_mmWaveSinrOutputFilename;
 }
 
+std::string 
+MmWaveBearerStatsConnector::GetPredictedOutageOutputFilename (void)
+{
+  return m_predictedOutageOutputFilename;
+}
+
+std::string 
+MmWaveBearerStatsConnector::GetSrbLoadOutputFilename (void)
+{
+  return m_srbLoadOutputFilename;
+}
+
 std::string 
 MmWaveBearerStatsConnector::GetLteSinrOutputFilename (void)
 {
@@ -509,6 +614,18 @@ MmWaveBearerStatsConnector::SetLteSinrOutputFilename (std::string outputFilename
   m_lteSinrOutputFilename = outputFilename;
 }
 
+void
+MmWaveBearerStatsConnector::SetPredictedOutageOutputFilename (std::string outputFilename)
+{
+  m_predictedOutageOutputFilename = outputFilename;
+}
+
+void
+MmWaveBearerStatsConnector::SetSrbLoadOutputFilename (std::string outputFilename)
+{
+  m_srbLoadOutputFilename = outputFilename;
+}
+
 void 
 MmWaveBearerStatsConnector::PrintEnbStartHandover(uint64_t imsi, uint16_t sourceCellid, uint16_t targetCellId, uint16_t rnti)
 {
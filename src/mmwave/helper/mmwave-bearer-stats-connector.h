@@ -38,6 +38,8 @@
 #include <ns3/config.h>
 #include <ns3/simple-ref-count.h>
 #include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
 #include "mc-stats-calculator.h"
 #include <fstream>
 #include "ns3/object.h"
@@ -213,6 +215,25 @@ public:
   void PrintMmWaveSinr (uint64_t imsi, uint16_t cellId, long double sinr);
   static void NotifyLteSinr (MmWaveBearerStatsConnector* c, std::string context, uint16_t cellId, uint16_t rnti, double rsrp, double sinr);
   void PrintLteSinr (uint16_t rnti, uint16_t cellId, double sinr);
+  static void NotifyPredictedOutage (MmWaveBearerStatsConnector* c, std::string context, uint64_t imsi, uint16_t cellId, uint16_t targetCellId, bool confirmed, Time leadTime);
+  void PrintPredictedOutage (uint64_t imsi, uint16_t cellId, uint16_t targetCellId, bool confirmed, Time leadTime);
+
+  /**
+   * Function hooked to the TxSrbPdu trace source of the UE RRC protocol,
+   * which is fired for every PDU sent over SRB0 or SRB1
+   * \param c
+   * \param context
+   * \param imsi
+   * \param cellId
+   * \param rnti
+   * \param size the size of the PDU in bytes
+   * \param nMessages the number of RRC messages in the PDU
+   */
+  static void NotifyTxSrbPdu (MmWaveBearerStatsConnector* c, std::string context, uint64_t imsi, uint16_t cellId, uint16_t rnti, uint32_t size, uint32_t nMessages);
+  /**
+   * Write the SRB load of every UE in the last period and start a new one
+   */
+  void PrintSrbLoad ();
 
   std::string GetEnbHandoverStartOutputFilename (void);
   std::string  GetUeHandoverStartOutputFilename (void);
@@ -221,6 +242,8 @@ public:
   std::string GetCellIdStatsOutputFilename (void);
   std::string GetMmWaveSinrOutputFilename (void);
   std::string GetLteSinrOutputFilename (void);
+  std::string GetPredictedOutageOutputFilename (void);
+  std::string GetSrbLoadOutputFilename (void);
   
   void SetEnbHandoverStartOutputFilename (std::string outputFilename);
   void  SetUeHandoverStartOutputFilename (std::string outputFilename);
@@ -229,6 +252,8 @@ public:
   void SetCellIdStatsOutputFilename (std::string outputFilename);
   void SetMmWaveSinrOutputFilename (std::string outputFilename);
   void SetLteSinrOutputFilename (std::string outputFilename);
+  void SetPredictedOutageOutputFilename (std::string outputFilename);
+  void SetSrbLoadOutputFilename (std::string outputFilename);
 
 private:
   /**
@@ -359,6 +384,8 @@ private:
   std::string m_cellIdInTimeHandoverFilename;
   std::string m_mmWaveSinrOutputFilename;
   std::string m_lteSinrOutputFilename;
+  std::string m_predictedOutageOutputFilename;
+  std::string m_srbLoadOutputFilename;
 
   std::ofstream m_enbHandoverStartOutFile;
   std::ofstream  m_ueHandoverStartOutFile;
@@ -367,6 +394,19 @@ private:
   std::ofstream m_cellIdInTimeHandoverOutFile;
   std::ofstream m_mmWaveSinrOutFile;
   std::ofstream m_lteSinrOutFile;
+  std::ofstream m_predictedOutageOutFile;
+  std::ofstream m_srbLoadOutFile;
+
+  /// SRB load of a UE in the current period
+  struct SrbLoad
+  {
+    uint64_t bytes;      ///< bytes sent
+    uint32_t pdus;       ///< PDUs sent
+    uint32_t messages;   ///< RRC messages sent
+  };
+  std::map<uint64_t, SrbLoad> m_srbLoad;  ///< SRB load of each IMSI
+  Time m_srbLoadPeriod;                   ///< period over which the SRB load is averaged
+  EventId m_srbLoadEvent;                 ///< end of the current period
 };
 
 
@@ -47,6 +47,7 @@
 #include <ns3/mmwave-lte-rrc-protocol-real.h>
 #include <ns3/epc-enb-application.h>
 #include <ns3/epc-x2.h>
+#include <ns3/cell-parallel-batch.h>
 
 #include <ns3/friis-spectrum-propagation-loss.h>
 #include <ns3/mmwave-rrc-protocol-ideal.h>
@@ -577,6 +578,7 @@ MmWaveHelper::InstallEnbDevice_28GHZ (NodeContainer c)
 
 	    device->SetAddress (Mac48Address::Allocate ());
 	    devices.Add (device);
+	    CellParallelBatch::AddParallelContext (node->GetId ());
 	    //cc++;
 	  }
 	return devices;
@@ -596,6 +598,7 @@ MmWaveHelper::InstallEnbDevice_73GHZ (NodeContainer c)
 	    	    device = InstallSingleEnbDevice_2 (node);//73GHz
 	    device->SetAddress (Mac48Address::Allocate ());
 	    devices.Add (device);
+	    CellParallelBatch::AddParallelContext (node->GetId ());
 	    //cc++;
 	  }
 	return devices;
@@ -612,6 +615,7 @@ MmWaveHelper::InstallLteEnbDevice (NodeContainer c)
 	    Ptr<NetDevice> device = InstallSingleLteEnbDevice (node);
 	    device->SetAddress (Mac48Address::Allocate ());
 	    devices.Add (device);
+	    CellParallelBatch::AddParallelContext (node->GetId ());
 	  }
 	return devices;
 }
@@ -2367,6 +2371,8 @@ MmWaveHelper::AddX2Interface (NodeContainer enbNodes)
 	// add traces
   	Config::Connect ("/NodeList/*/$ns3::EpcX2/RxPDU",
     	MakeCallback (&CoreNetworkStatsCalculator::LogX2Packet, m_cnStats));
+  	Config::Connect ("/NodeList/*/$ns3::EpcX2/TxMcPduBatch",
+    	MakeCallback (&CoreNetworkStatsCalculator::LogX2McPduBatch, m_cnStats));
 }
 
 void
@@ -2441,6 +2447,8 @@ MmWaveHelper::AddX2Interface (NodeContainer lteEnbNodes, NodeContainer mmWaveEnb
 	// add traces
   	Config::Connect ("/NodeList/*/$ns3::EpcX2/RxPDU",
     	MakeCallback (&CoreNetworkStatsCalculator::LogX2Packet, m_cnStats));
+  	Config::Connect ("/NodeList/*/$ns3::EpcX2/TxMcPduBatch",
+    	MakeCallback (&CoreNetworkStatsCalculator::LogX2McPduBatch, m_cnStats));
 }
 void
 MmWaveHelper::AddX2Interface (NodeContainer lteEnbNodes, NodeContainer mmWaveEnbNodes1, NodeContainer mmWaveEnbNodes2)
@@ -2558,6 +2566,8 @@ MmWaveHelper::AddX2Interface (NodeContainer lteEnbNodes, NodeContainer mmWaveEnb
 	// add traces
   	Config::Connect ("/NodeList/*/$ns3::EpcX2/RxPDU",
     	MakeCallback (&CoreNetworkStatsCalculator::LogX2Packet, m_cnStats));
+  	Config::Connect ("/NodeList/*/$ns3::EpcX2/TxMcPduBatch",
+    	MakeCallback (&CoreNetworkStatsCalculator::LogX2McPduBatch, m_cnStats));
 }
 /* Call this from a script to configure the MAC PHY common parameters
  * using "SetAttribute" */
@@ -38,6 +38,8 @@
 #include <cfloat>
 #include <cmath>
 #include <ns3/simulator.h>
+#include <ns3/cell-parallel-batch.h>
+#include <ns3/make-event.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
 
@@ -583,6 +585,12 @@ MmWaveEnbPhy::CallPathloss()
 	/* THIS METHOD IS JUST USED TO LOOK THROUGH THE ALL EXPERIMENTAL SINR ADITYA'S TRACE
 	EVEN WHEN THE SINR COMPUTATION IS NOT REQUIRED (SINCE THE SINR TRACE IS MADE EVERY 125MICROSECONDS) */
  NS_LOG_FUNCTION(this);
+	if (CellParallelBatch::IsRunning ())
+	{
+		// steers the antennas of the UEs and reads the channel shared with the other cells
+		CellParallelBatch::ScheduleAtBarrier (MakeEvent (&MmWaveEnbPhy::CallPathloss, this));
+		return;
+	}
 	Ptr<SpectrumValue> noisePsd = MmWaveSpectrumValueHelper::CreateNoisePowerSpectralDensity (m_phyMacConfig, m_noiseFigure);
 	Ptr<SpectrumValue> totalReceivedPsd = Create <SpectrumValue> (SpectrumValue(noisePsd->GetSpectrumModel()));
 
@@ -761,6 +769,12 @@ void
 MmWaveEnbPhy::UpdateUeSinrEstimate()
 {
     NS_LOG_FUNCTION(this);
+	if (CellParallelBatch::IsRunning ())
+	{
+		// steers the antennas of the UEs and reads the channel shared with the other cells
+		CellParallelBatch::ScheduleAtBarrier (MakeEvent (&MmWaveEnbPhy::UpdateUeSinrEstimate, this));
+		return;
+	}
 	m_sinrMap.clear();
 	m_rxPsdMap.clear();
 	
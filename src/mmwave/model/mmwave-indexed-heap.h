@@ -0,0 +1,249 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MMWAVE_INDEXED_HEAP_H
+#define MMWAVE_INDEXED_HEAP_H
+
+#include <ns3/assert.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mmwave
+ *
+ * Base class of the items of an MmWaveIndexedHeap: holds the position of
+ * the item in the heap.
+ *
+ * A copy of an item is not in any heap, so that items can be kept in
+ * containers that copy them; take an item out of its heap before its
+ * container moves it.
+ */
+class MmWaveIndexedHeapItem
+{
+public:
+  /// position of an item that is not in a heap
+  static const uint32_t NOT_IN_HEAP = 0xffffffff;
+
+  MmWaveIndexedHeapItem ()
+    : m_heapIndex (NOT_IN_HEAP)
+  {
+  }
+
+  MmWaveIndexedHeapItem (const MmWaveIndexedHeapItem &)
+    : m_heapIndex (NOT_IN_HEAP)
+  {
+  }
+
+  MmWaveIndexedHeapItem & operator= (const MmWaveIndexedHeapItem &)
+  {
+    // the item keeps its own position
+    return *this;
+  }
+
+private:
+  template <class T, class Less>
+  friend class MmWaveIndexedHeap;
+
+  uint32_t m_heapIndex;   ///< position in the heap, or NOT_IN_HEAP
+};
+
+/**
+ * \ingroup mmwave
+ *
+ * Binary heap of items that keeps the position of each item, so that an item
+ * whose rank changed is moved in O(log n) instead of rebuilding the heap.
+ *
+ * The schedulers keep their UEs or flows in it across subframes. The
+ * position of an item is stored in the item itself (T derives from
+ * MmWaveIndexedHeapItem), so finding it costs nothing and an item is in at
+ * most one heap. The rank of an item is read from the item itself by the
+ * compare functor, as with std::push_heap: after changing what the functor
+ * reads, call Update for that item before changing another one.
+ */
+template <class T, class Less>
+class MmWaveIndexedHeap
+{
+public:
+  /**
+   * \param less the heap order: true if the first item ranks below the second
+   */
+  explicit MmWaveIndexedHeap (Less less = Less ())
+    : m_less (less)
+  {
+  }
+
+  /**
+   * Insert an item, or move it to the position of its current rank
+   * \param item the item
+   */
+  void Update (T* item)
+  {
+    uint32_t pos = item->m_heapIndex;
+    if (pos == MmWaveIndexedHeapItem::NOT_IN_HEAP)
+      {
+        item->m_heapIndex = m_heap.size ();
+        m_heap.push_back (item);
+        SiftUp (m_heap.size () - 1);
+      }
+    else
+      {
+        NS_ASSERT (pos < m_heap.size () && m_heap[pos] == item);
+        SiftDown (SiftUp (pos));
+      }
+  }
+
+  /**
+   * Remove an item, if present
+   * \param item the item
+   */
+  void Remove (T* item)
+  {
+    uint32_t pos = item->m_heapIndex;
+    if (pos == MmWaveIndexedHeapItem::NOT_IN_HEAP)
+      {
+        return;
+      }
+    NS_ASSERT (pos < m_heap.size () && m_heap[pos] == item);
+    item->m_heapIndex = MmWaveIndexedHeapItem::NOT_IN_HEAP;
+    T* last = m_heap.back ();
+    m_heap.pop_back ();
+    if (pos < m_heap.size ())
+      {
+        m_heap[pos] = last;
+        last->m_heapIndex = pos;
+        SiftDown (SiftUp (pos));
+      }
+  }
+
+  /**
+   * \param item the item
+   * \return true if the item is in the heap
+   */
+  bool Contains (const T* item) const
+  {
+    return item->m_heapIndex != MmWaveIndexedHeapItem::NOT_IN_HEAP;
+  }
+
+  /**
+   * \return the item ranked highest
+   */
+  T* Top () const
+  {
+    NS_ASSERT (!m_heap.empty ());
+    return m_heap.front ();
+  }
+
+  /// Remove the item ranked highest
+  void Pop ()
+  {
+    Remove (Top ());
+  }
+
+  /// \return true if the heap has no items
+  bool IsEmpty () const
+  {
+    return m_heap.empty ();
+  }
+
+  /// \return the number of items
+  uint32_t GetSize () const
+  {
+    return m_heap.size ();
+  }
+
+  /// Remove all the items
+  void Clear ()
+  {
+    for (uint32_t i = 0; i < m_heap.size (); ++i)
+      {
+        m_heap[i]->m_heapIndex = MmWaveIndexedHeapItem::NOT_IN_HEAP;
+      }
+    m_heap.clear ();
+  }
+
+private:
+  /**
+   * Move an item up while it ranks above its parent
+   * \param pos the position of the item
+   * \return the new position of the item
+   */
+  uint32_t SiftUp (uint32_t pos)
+  {
+    while (pos > 0)
+      {
+        uint32_t parent = (pos - 1) / 2;
+        if (!m_less (m_heap[parent], m_heap[pos]))
+          {
+            break;
+          }
+        Swap (pos, parent);
+        pos = parent;
+      }
+    return pos;
+  }
+
+  /**
+   * Move an item down while a child ranks above it
+   * \param pos the position of the item
+   */
+  void SiftDown (uint32_t pos)
+  {
+    uint32_t size = m_heap.size ();
+    while (true)
+      {
+        uint32_t top = pos;
+        uint32_t left = 2 * pos + 1;
+        uint32_t right = left + 1;
+        if (left < size && m_less (m_heap[top], m_heap[left]))
+          {
+            top = left;
+          }
+        if (right < size && m_less (m_heap[top], m_heap[right]))
+          {
+            top = right;
+          }
+        if (top == pos)
+          {
+            break;
+          }
+        Swap (pos, top);
+        pos = top;
+      }
+  }
+
+  /**
+   * Swap two items and their positions
+   * \param i the position of the first item
+   * \param j the position of the second item
+   */
+  void Swap (uint32_t i, uint32_t j)
+  {
+    T* tmp = m_heap[i];
+    m_heap[i] = m_heap[j];
+    m_heap[j] = tmp;
+    m_heap[i]->m_heapIndex = i;
+    m_heap[j]->m_heapIndex = j;
+  }
+
+  Less m_less;                ///< heap order
+  std::vector<T*> m_heap;     ///< the items, in heap order
+};
+
+} // namespace ns3
+
+#endif // MMWAVE_INDEXED_HEAP_H
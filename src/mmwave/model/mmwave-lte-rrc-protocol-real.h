@@ -29,14 +29,19 @@
 
 #include <stdint.h>
 #include <map>
+#include <vector>
 
 #include <ns3/ptr.h>
 #include <ns3/object.h>
+#include <ns3/event-id.h>
+#include <ns3/nstime.h>
+#include <ns3/traced-callback.h>
 #include <ns3/lte-rrc-sap.h>
 #include <ns3/lte-pdcp-sap.h>
 #include <ns3/lte-rlc-sap.h>
 #include <ns3/lte-rrc-header.h>
 #include <ns3/epc-x2-sap.h>
+#include <ns3/measurement-report-delta-codec.h>
 namespace ns3 {
 
 class LteUeRrcSapProvider;
@@ -73,6 +78,18 @@ public:
 
   void DoReceiveLteAssistantInfo(EpcX2Sap::AssistantInformationForSplitting info); //sjkang
 
+  /**
+   * TracedCallback signature for the SRB PDUs sent by the UE
+   *
+   * \param [in] imsi the IMSI of the UE
+   * \param [in] cellId the cell the UE is attached to
+   * \param [in] rnti the RNTI of the UE
+   * \param [in] size the size of the PDU in bytes
+   * \param [in] nMessages the number of RRC messages in the PDU
+   */
+  typedef void (* TxSrbPduTracedCallback)
+    (uint64_t imsi, uint16_t cellId, uint16_t rnti, uint32_t size, uint32_t nMessages);
+
 private:
   // methods forwarded from LteUeRrcSapUser
   void DoSetup (LteUeRrcSapUser::SetupParameters params);
@@ -84,6 +101,17 @@ private:
   void DoSendMeasurementReport (LteRrcSap::MeasurementReport msg);
   void DoSendNotifySecondaryCellConnected (uint16_t mmWaveRnti, uint16_t mmWaveCellId);
 
+  /**
+   * Send a message over SRB1, or queue it until the end of the current
+   * TTI, of length m_ttiDuration, if the messages are coalesced
+   * \param params the PDCP SDU with the serialized message
+   */
+  void TransmitSrb1Sdu (LtePdcpSapProvider::TransmitPdcpSduParameters params);
+  /**
+   * Send the queued SRB1 messages in a single PDCP SDU
+   */
+  void FlushSrb1Sdus ();
+
   void SetEnbRrcSapProvider ();
   void DoReceivePdcpPdu (Ptr<Packet> p);
   void DoReceivePdcpSdu (LtePdcpSapUser::ReceivePdcpSduParameters params);
@@ -97,6 +125,19 @@ private:
   LteUeRrcSapUser::SetupParameters m_setupParameters;
   LteUeRrcSapProvider::CompleteSetupParameters m_completeSetupParameters;
 
+  bool m_coalesceMessages;  ///< send the SRB1 messages of a TTI in one PDU
+  Time m_ttiDuration;  ///< TTI of the link carrying SRB1
+  std::vector<LtePdcpSapProvider::TransmitPdcpSduParameters> m_pendingSrb1Sdus;  ///< SRB1 messages of this TTI
+  EventId m_flushSrb1Event;  ///< end of the TTI, when the queued messages are sent
+
+  bool m_deltaMeasurementReports;  ///< send delta measurement reports
+  uint8_t m_measReportHysteresis;  ///< change of a neighbour cell sent in a delta report
+  MeasurementReportDeltaCodec m_measReportCodec;  ///< results known to the eNB
+  uint16_t m_measReportCellId;  ///< cell the codec results refer to
+
+  /// the SRB PDUs sent: IMSI, cell ID, RNTI, size and number of messages
+  TracedCallback<uint64_t, uint16_t, uint16_t, uint32_t, uint32_t> m_txSrbPduTrace;
+
 };
 
 
@@ -161,6 +202,7 @@ private:
   std::map<uint16_t, LteUeRrcSapProvider*> m_enbRrcSapProviderMap;
   std::map<uint16_t, LteEnbRrcSapUser::SetupUeParameters> m_setupUeParametersMap;
   std::map<uint16_t, LteEnbRrcSapProvider::CompleteSetupUeParameters> m_completeSetupUeParametersMap;
+  MeasurementReportDeltaCodec m_measReportCodec;  ///< restores the delta measurement reports
 
 };
 
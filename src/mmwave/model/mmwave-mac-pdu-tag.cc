@@ -27,6 +27,7 @@
 
 
 #include "mmwave-mac-pdu-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "mmwave-phy-mac-common.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
@@ -52,9 +53,9 @@ MmWaveMacPduTag::MmWaveMacPduTag (SfnSf sfn, uint8_t symStart, uint8_t numSym)
 TypeId
 MmWaveMacPduTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::MmWaveMacPduTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::MmWaveMacPduTag")
     .SetParent<Tag> ()
-    .AddConstructor<MmWaveMacPduTag> ();
+    .AddConstructor<MmWaveMacPduTag> ());
   return tid;
 }
 
@@ -28,6 +28,7 @@
 
 
 #include "mmwave-radio-bearer-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -38,7 +39,7 @@ NS_OBJECT_ENSURE_REGISTERED (MmWaveRadioBearerTag);
 TypeId
 MmWaveRadioBearerTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::MmWaveRadioBearerTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::MmWaveRadioBearerTag")
     .SetParent<Tag> ()
     .AddConstructor<MmWaveRadioBearerTag> ()
     .AddAttribute ("rnti", "The rnti that indicates the UE to which packet belongs",
@@ -53,7 +54,7 @@ MmWaveRadioBearerTag::GetTypeId (void)
 									UintegerValue (0),
 									MakeUintegerAccessor (&MmWaveRadioBearerTag::GetSize),
 									MakeUintegerChecker<uint32_t> ())
-  ;
+  );
   return tid;
 }
 
@@ -0,0 +1,213 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+#include "ns3/mmwave-indexed-heap.h"
+
+#include <algorithm>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveTestIndexedHeap");
+
+/**
+ * A UE as ranked by the flex TTI PF scheduler: achievable rate over
+ * average throughput.
+ */
+struct MmWaveTestPfUe : public MmWaveIndexedHeapItem
+{
+  double m_rate;      ///< achievable rate
+  double m_avgTput;   ///< average throughput
+
+  /// \return the PF metric
+  double GetMetric () const
+  {
+    return m_rate / std::max (1.0E-9, m_avgTput);
+  }
+};
+
+/// sort order of the PF scheduler before the heap: highest metric first
+static bool
+CompareUeSort (MmWaveTestPfUe* lue, MmWaveTestPfUe* rue)
+{
+  return lue->GetMetric () > rue->GetMetric ();
+}
+
+/// heap order: the UE with the highest metric is at the top
+struct MmWaveTestPfUeLess
+{
+  bool operator() (const MmWaveTestPfUe* lue, const MmWaveTestPfUe* rue) const
+  {
+    return lue->GetMetric () < rue->GetMetric ();
+  }
+};
+
+/**
+ * Checks that the heap serves the same items as sorting all the items
+ * again before each allocation, as the schedulers did.
+ */
+class MmWaveIndexedHeapTestCase : public TestCase
+{
+public:
+  MmWaveIndexedHeapTestCase ();
+  virtual ~MmWaveIndexedHeapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// \return the next value of a fixed pseudo-random sequence in [0, 1)
+  double NextValue ();
+
+  uint32_t m_seed;    ///< state of the pseudo-random sequence
+};
+
+MmWaveIndexedHeapTestCase::MmWaveIndexedHeapTestCase ()
+  : TestCase ("Indexed heap against sorting"),
+    m_seed (12345)
+{
+}
+
+MmWaveIndexedHeapTestCase::~MmWaveIndexedHeapTestCase ()
+{
+}
+
+double
+MmWaveIndexedHeapTestCase::NextValue ()
+{
+  m_seed = m_seed * 1103515245 + 12345;
+  return ((m_seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+void
+MmWaveIndexedHeapTestCase::DoRun (void)
+{
+  const uint32_t numUes = 20;
+  std::vector<MmWaveTestPfUe> ues (numUes);
+  for (uint32_t i = 0; i < numUes; ++i)
+    {
+      ues[i].m_rate = 1.0 + 100.0 * NextValue ();
+      ues[i].m_avgTput = 0.0;
+    }
+
+  MmWaveIndexedHeap<MmWaveTestPfUe, MmWaveTestPfUeLess> heap;
+  NS_TEST_ASSERT_MSG_EQ (heap.IsEmpty (), true, "new heap not empty");
+
+  // a few subframes: each UE in the heap is served until it has no more data
+  for (uint32_t sf = 0; sf < 5; ++sf)
+    {
+      std::vector<MmWaveTestPfUe*> active;
+      std::vector<uint32_t> served (numUes, 0);
+      for (uint32_t i = 0; i < numUes; ++i)
+        {
+          active.push_back (&ues[i]);
+          heap.Update (&ues[i]);
+        }
+      NS_TEST_ASSERT_MSG_EQ (heap.GetSize (), numUes, "wrong number of items");
+
+      while (!active.empty ())
+        {
+          std::sort (active.begin (), active.end (), &CompareUeSort);
+          MmWaveTestPfUe* ue = heap.Top ();
+          NS_TEST_ASSERT_MSG_EQ_TOL (ue->GetMetric (), active.front ()->GetMetric (), 1e-12,
+                                     "heap and sort serve different UEs");
+
+          uint32_t i = ue - &ues[0];
+          ue->m_avgTput += ue->m_rate * (0.5 + NextValue ());
+          if (++served[i] == 1 + i % 4)
+            {
+              heap.Pop ();
+              active.erase (std::find (active.begin (), active.end (), ue));
+              NS_TEST_ASSERT_MSG_EQ (heap.Contains (ue), false, "popped item still in the heap");
+            }
+          else
+            {
+              heap.Update (ue);
+            }
+          NS_TEST_ASSERT_MSG_EQ (heap.GetSize (), active.size (), "wrong number of items");
+        }
+      NS_TEST_ASSERT_MSG_EQ (heap.IsEmpty (), true, "heap not empty at the end of the subframe");
+
+      // the rates change between subframes, e.g. on new CQI
+      for (uint32_t i = 0; i < numUes; ++i)
+        {
+          ues[i].m_rate = 1.0 + 100.0 * NextValue ();
+        }
+    }
+
+  // random updates of any item, then all items out in rank order
+  for (uint32_t i = 0; i < numUes; ++i)
+    {
+      heap.Update (&ues[i]);
+    }
+  for (uint32_t n = 0; n < 200; ++n)
+    {
+      MmWaveTestPfUe* ue = &ues[(uint32_t) (NextValue () * numUes)];
+      ue->m_rate = 1.0 + 100.0 * NextValue ();
+      heap.Update (ue);
+    }
+  heap.Remove (&ues[3]);
+  heap.Remove (&ues[3]);
+  NS_TEST_ASSERT_MSG_EQ (heap.Contains (&ues[3]), false, "removed item still in the heap");
+  NS_TEST_ASSERT_MSG_EQ (heap.Contains (&ues[4]), true, "item missing from the heap");
+  MmWaveTestPfUe copy = ues[4];
+  NS_TEST_ASSERT_MSG_EQ (heap.Contains (&copy), false, "copy of an item found in the heap");
+  NS_TEST_ASSERT_MSG_EQ (heap.GetSize (), numUes - 1, "wrong number of items after removal");
+
+  std::vector<MmWaveTestPfUe*> sorted;
+  for (uint32_t i = 0; i < numUes; ++i)
+    {
+      if (i != 3)
+        {
+          sorted.push_back (&ues[i]);
+        }
+    }
+  std::sort (sorted.begin (), sorted.end (), &CompareUeSort);
+  for (uint32_t i = 0; i < sorted.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (heap.Top ()->GetMetric (), sorted[i]->GetMetric (), 1e-12,
+                                 "items not popped in rank order");
+      heap.Pop ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (heap.IsEmpty (), true, "heap not empty after popping all items");
+
+  heap.Update (&ues[0]);
+  heap.Update (&ues[1]);
+  heap.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (heap.IsEmpty (), true, "heap not cleared");
+  NS_TEST_ASSERT_MSG_EQ (heap.Contains (&ues[0]), false, "item left after clearing");
+}
+
+
+/**
+ * Test the indexed heap of the flex TTI schedulers
+ */
+class MmWaveIndexedHeapTestSuite : public TestSuite
+{
+public:
+  MmWaveIndexedHeapTestSuite ();
+};
+
+static MmWaveIndexedHeapTestSuite g_mmWaveIndexedHeapTestSuite;
+
+MmWaveIndexedHeapTestSuite::MmWaveIndexedHeapTestSuite ()
+  : TestSuite ("mmwave-indexed-heap", UNIT)
+{
+  NS_LOG_FUNCTION (this);
+
+  AddTestCase (new MmWaveIndexedHeapTestCase (), TestCase::QUICK);
+}
@@ -126,6 +126,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const;
   virtual uint32_t GetContext (void) const;
+  virtual uint64_t GetEventCount (void) const;
 
 private:
   virtual void DoDispose (void);
@@ -148,6 +149,8 @@ private:
   // number of events that have been inserted but not yet scheduled,
   // not counting the "destroy" events; this is used for validation
   int m_unscheduledEvents;
+  // number of executed events
+  uint64_t m_eventCount;
 
   LbtsMessage* m_pLBTS;       // Allocated once we know how many systems
   uint32_t     m_myId;        // MPI Rank
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-allocator.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -43,6 +44,22 @@ static struct Zeroes
   const uint32_t size;  //!< buffer size
 } g_zeroes; //!< Zero-filled buffer
 
+/**
+ * \ingroup packet
+ * \brief Raise a size hint shared by the threads of the simulator.
+ * \param hint the hint
+ * \param value the size seen by the caller
+ */
+void
+UpdateMax (std::atomic<uint32_t> &hint, uint32_t value)
+{
+  uint32_t current = hint.load (std::memory_order_relaxed);
+  while (current < value
+         && !hint.compare_exchange_weak (current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
 }
 
 namespace ns3 {
@@ -50,97 +67,26 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+std::atomic<uint32_t> Buffer::g_recommendedStart (0);
 #ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
- */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
-{
-  NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
-    {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
-        {
-          Buffer::Deallocate (*i);
-        }
-      delete g_freeList;
-      g_freeList = DESTROYED;
-    }
-}
+std::atomic<uint32_t> Buffer::g_maxSize (0);
 
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
-    {
-      Buffer::Deallocate (data);
-    }
-  else
-    {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
-    }
+  UpdateMax (g_maxSize, data->m_size);
+  Buffer::Deallocate (data);
 }
 
 Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
-    {
-      g_freeList = new Buffer::FreeList ();
-    }
-  else if (IS_INITIALIZED (g_freeList))
-    {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
-    }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
-  return data;
+  /* allocate the largest size seen so far, so that the new buffers
+   * seldom need to grow. */
+  return Buffer::Allocate (std::max (dataSize, g_maxSize.load (std::memory_order_relaxed)));
 }
 #else /* BUFFER_FREE_LIST */
 void
@@ -169,9 +115,10 @@ Buffer::Allocate (uint32_t reqSize)
     }
   NS_ASSERT (reqSize >= 1);
   uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
-  struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
-  data->m_size = reqSize;
+  void *b = PacketAllocator::Allocate (size);
+  struct Buffer::Data *data = static_cast<struct Buffer::Data*>(b);
+  // the size class of the block may hold more bytes than requested
+  data->m_size = size + 1 - sizeof (struct Buffer::Data);
   data->m_count = 1;
   return data;
 }
@@ -181,8 +128,7 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
+  PacketAllocator::Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Buffer ()
@@ -245,7 +191,7 @@ Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
   m_data = Buffer::Create (0);
-  m_start = std::min (m_data->m_size, g_recommendedStart);
+  m_start = std::min (m_data->m_size, g_recommendedStart.load (std::memory_order_relaxed));
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
   m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
@@ -262,15 +208,14 @@ Buffer::operator = (Buffer const&o)
   if (m_data != o.m_data) 
     {
       // not assignment to self.
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Recycle (m_data);
         }
       m_data = o.m_data;
       m_data->m_count++;
     }
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+  UpdateMax (g_recommendedStart, m_maxZeroAreaStart);
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
   m_zeroAreaEnd = o.m_zeroAreaEnd;
@@ -284,9 +229,8 @@ Buffer::~Buffer ()
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  UpdateMax (g_recommendedStart, m_maxZeroAreaStart);
+  if (--m_data->m_count == 0) 
     {
       Recycle (m_data);
     }
@@ -328,8 +272,7 @@ Buffer::AddAtStart (uint32_t start)
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0)
+      if (--m_data->m_count == 0)
         {
           Buffer::Recycle (m_data);
         }
@@ -351,6 +294,25 @@ Buffer::AddAtStart (uint32_t start)
   NS_ASSERT (CheckInternalState ());
 }
 void
+Buffer::ReserveAtStart (uint32_t start)
+{
+  NS_LOG_FUNCTION (this << start);
+  NS_ASSERT (CheckInternalState ());
+  bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+  if (m_start >= start && !isDirty)
+    {
+      return;
+    }
+  // the buffer is reallocated, with the new bytes at its start, and is
+  // no longer shared: give them back as free space
+  AddAtStart (start);
+  NS_ASSERT (m_data->m_count == 1 && m_start == 0);
+  m_start = start;
+  m_data->m_dirtyStart = m_start;
+  LOG_INTERNAL_STATE ("reserve start=" << start << ", ");
+  NS_ASSERT (CheckInternalState ());
+}
+void
 Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
@@ -373,8 +335,7 @@ Buffer::AddAtEnd (uint32_t end)
       uint32_t newSize = GetInternalSize () + end;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           Buffer::Recycle (m_data);
         }
@@ -22,8 +22,10 @@
 
 #include <stdint.h>
 #include <vector>
+#include <atomic>
 #include <ostream>
 #include "ns3/assert.h"
+#include "ns3/cell-parallel-batch.h"
 
 #define BUFFER_FREE_LIST 1
 
@@ -509,6 +511,16 @@ private:
    * pointing to this Buffer.
    */
   void AddAtStart (uint32_t start);
+  /**
+   * \param start size to make room for
+   *
+   * Make sure that start bytes can be added at the start of the
+   * Buffer without reallocating it, reallocating it now if needed.
+   * The content of the Buffer is unchanged.
+   * Any call to this method invalidates any Iterator
+   * pointing to this Buffer.
+   */
+  void ReserveAtStart (uint32_t start);
   /**
    * \param end size to reserve
    *
@@ -661,8 +673,10 @@ private:
     /**
      * The reference count of an instance of this data structure.
      * Each buffer which references an instance holds a count.
+     * A CellParallelBatch::RefCount, as the copies of a packet may be held
+     * by the cells of a CellParallelSimulatorImpl running on several threads.
      */
-    uint32_t m_count;
+    CellParallelBatch::RefCount m_count;
     /**
      * the size of the m_data field below.
      */
@@ -766,7 +780,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static std::atomic<uint32_t> g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -790,16 +804,7 @@ private:
   uint32_t m_end;
 
 #ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  static std::atomic<uint32_t> g_maxSize; //!< Max observed data size
 #endif
 };
 
@@ -18,13 +18,13 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "byte-tag-list.h"
+#include "packet-allocator.h"
 #include "ns3/log.h"
+#include "ns3/cell-parallel-batch.h"
 #include <vector>
 #include <cstring>
 #include <limits>
 
-#define USE_FREE_LIST 1
-#define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max ())
 
 namespace ns3 {
@@ -40,38 +40,11 @@ NS_LOG_COMPONENT_DEFINE ("ByteTagList");
  */
 struct ByteTagListData {
   uint32_t size;   //!< size of the data
-  uint32_t count;  //!< use counter (for smart deallocation)
+  CellParallelBatch::RefCount count;  //!< use counter (for smart deallocation)
   uint32_t dirty;  //!< number of bytes actually in use
   uint8_t data[4]; //!< data
 };
 
-#ifdef USE_FREE_LIST
-/**
- * \ingroup packet
- *
- * \brief Container class for struct ByteTagListData
- *
- * Internal use only.
- */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
-{
-public:
-  ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
-
-ByteTagListDataFreeList::~ByteTagListDataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (ByteTagListDataFreeList::iterator i = begin ();
-       i != end (); i++)
-    {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
-    }
-}
-#endif /* USE_FREE_LIST */
-
 ByteTagList::Iterator::Item::Item (TagBuffer buf_)
   : buf (buf_)
 {
@@ -339,69 +312,16 @@ ByteTagList::AddAtStart (int32_t prependOffset)
   *this = list;
 }
 
-#ifdef USE_FREE_LIST
-
-struct ByteTagListData *
-ByteTagList::Allocate (uint32_t size)
-{
-  NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
-    {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
-      NS_ASSERT (data != 0);
-      if (data->size >= size)
-        {
-          data->count = 1;
-          data->dirty = 0;
-          return data;
-        }
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
-    }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
-  data->count = 1;
-  data->size = size;
-  data->dirty = 0;
-  return data;
-}
-
-void 
-ByteTagList::Deallocate (struct ByteTagListData *data)
-{
-  NS_LOG_FUNCTION (this << data);
-  if (data == 0)
-    {
-      return;
-    }
-  g_maxSize = std::max (g_maxSize, data->size);
-  data->count--;
-  if (data->count == 0)
-    {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
-          data->size < g_maxSize)
-        {
-          uint8_t *buffer = (uint8_t *)data;
-          delete [] buffer;
-        }
-      else
-        {
-          g_freeList.push_back (data);
-        }
-    }
-}
-
-#else /* USE_FREE_LIST */
-
 struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  uint8_t *buffer = new uint8_t [size + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+  uint32_t blockSize = size + sizeof (struct ByteTagListData) - 4;
+  void *buffer = PacketAllocator::Allocate (blockSize);
+  struct ByteTagListData *data = static_cast<struct ByteTagListData *> (buffer);
   data->count = 1;
-  data->size = size;
+  // the size class of the block may hold more bytes than requested
+  data->size = blockSize + 4 - sizeof (struct ByteTagListData);
   data->dirty = 0;
   return data;
 }
@@ -414,15 +334,11 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  data->count--;
-  if (data->count == 0)
+  if (--data->count == 0)
     {
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
+      PacketAllocator::Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
     }
 }
 
-#endif /* USE_FREE_LIST */
-
 
 } // namespace ns3
@@ -0,0 +1,330 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-allocator.h"
+#include "ns3/simulator.h"
+#include "ns3/system-mutex.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketAllocator");
+
+namespace {
+
+/** The freelists of the packet blocks of a thread. */
+struct BlockPool
+{
+  /** log2 of the size of the smallest size class. */
+  static const uint32_t MIN_SHIFT = 5;
+  /** Number of size classes, up to 64 KiB. */
+  static const uint32_t N_CLASSES = 12;
+  /** Maximum number of free blocks kept per size class. */
+  static const uint32_t MAX_FREE = 4096;
+  /** Maximum number of bytes kept per size class. */
+  static const uint32_t MAX_FREE_BYTES = 4 << 20;
+
+  /** A free block. */
+  struct FreeBlock
+  {
+    FreeBlock *next;   //!< next free block of the size class
+  };
+
+  BlockPool ();
+  ~BlockPool ();
+
+  /**
+   * Add to a counter of the pool. Only the thread of the pool writes its
+   * counters, GetStats reads them from any thread.
+   *
+   * \param counter the counter
+   * \param value the value to add, possibly wrapping around
+   */
+  static void Add (std::atomic<uint64_t> &counter, uint64_t value)
+  {
+    counter.store (counter.load (std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  FreeBlock *m_free[N_CLASSES];        //!< free blocks of each size class
+  uint32_t m_nFree[N_CLASSES];         //!< number of free blocks of each size class
+  std::atomic<uint64_t> m_allocated;   //!< number of allocated blocks
+  std::atomic<uint64_t> m_recycled;    //!< number of blocks taken from a freelist
+  std::atomic<uint64_t> m_freed;       //!< number of released blocks
+  std::atomic<uint64_t> m_cachedBytes; //!< bytes held in the freelists
+};
+
+/** The pools of the running threads, and the counters of the exited ones. */
+struct PoolRegistry
+{
+  SystemMutex m_mutex;                //!< protects the registry
+  std::vector<BlockPool *> m_pools;   //!< pools of the running threads
+  PacketAllocator::Stats m_exited;    //!< counters of the exited threads
+};
+
+/** \return the registry of the pools */
+PoolRegistry &
+GetRegistry (void)
+{
+  static PoolRegistry registry;
+  return registry;
+}
+
+BlockPool::BlockPool ()
+  : m_allocated (0),
+    m_recycled (0),
+    m_freed (0),
+    m_cachedBytes (0)
+{
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      m_free[i] = 0;
+      m_nFree[i] = 0;
+    }
+  PoolRegistry &registry = GetRegistry ();
+  CriticalSection critical (registry.m_mutex);
+  registry.m_pools.push_back (this);
+}
+
+BlockPool::~BlockPool ()
+{
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      while (m_free[i] != 0)
+        {
+          FreeBlock *block = m_free[i];
+          m_free[i] = block->next;
+          ::operator delete (block);
+        }
+    }
+  PoolRegistry &registry = GetRegistry ();
+  CriticalSection critical (registry.m_mutex);
+  registry.m_pools.erase (std::find (registry.m_pools.begin (), registry.m_pools.end (), this));
+  registry.m_exited.m_allocated += m_allocated;
+  registry.m_exited.m_recycled += m_recycled;
+  registry.m_exited.m_freed += m_freed;
+}
+
+/** Marks the pool of a thread which already exited. */
+BlockPool * const DEAD_POOL = reinterpret_cast<BlockPool *> (1);
+
+/**
+ * Pool of the calling thread. A plain pointer, which remains valid while
+ * the other thread local objects, e.g. static packets, are destroyed.
+ */
+thread_local BlockPool *t_pool = 0;
+
+/** Deletes the pool of its thread when the thread exits. */
+struct BlockPoolGuard
+{
+  /** Destructor. */
+  ~BlockPoolGuard ()
+  {
+    if (t_pool != DEAD_POOL)
+      {
+        delete t_pool;
+      }
+    t_pool = DEAD_POOL;
+  }
+  bool m_armed;  //!< the pool of the thread was created
+};
+
+/** Guard of the pool of the calling thread. */
+thread_local BlockPoolGuard t_guard;
+
+/**
+ * \return the pool of the calling thread, or DEAD_POOL while the thread
+ * exits
+ */
+BlockPool *
+GetPool (void)
+{
+  if (t_pool == 0)
+    {
+      t_guard.m_armed = true;
+      t_pool = new BlockPool ();
+    }
+  return t_pool;
+}
+
+/**
+ * \param size a block size, not null
+ * \return the size class of the block, N_CLASSES or more for the large blocks
+ */
+uint32_t
+GetSizeClass (uint32_t size)
+{
+  if (size <= (1U << BlockPool::MIN_SHIFT))
+    {
+      return 0;
+    }
+  return 32 - __builtin_clz (size - 1) - BlockPool::MIN_SHIFT;
+}
+
+/**
+ * \param [in,out] size a block size, set to the size of its size class
+ * \return the size class of the block, N_CLASSES or more for the large blocks
+ */
+uint32_t
+RoundToSizeClass (uint32_t &size)
+{
+  size = std::max (size, (uint32_t) sizeof (BlockPool::FreeBlock));
+  uint32_t sizeClass = GetSizeClass (size);
+  if (sizeClass < BlockPool::N_CLASSES)
+    {
+      size = 1U << (sizeClass + BlockPool::MIN_SHIFT);
+    }
+  return sizeClass;
+}
+
+} // unnamed namespace
+
+void *
+PacketAllocator::Allocate (uint32_t &size)
+{
+  uint32_t sizeClass = RoundToSizeClass (size);
+  BlockPool *pool = GetPool ();
+  if (pool == DEAD_POOL)
+    {
+      return ::operator new (size);
+    }
+  BlockPool::Add (pool->m_allocated, 1);
+  if (sizeClass >= BlockPool::N_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  BlockPool::FreeBlock *block = pool->m_free[sizeClass];
+  if (block != 0)
+    {
+      pool->m_free[sizeClass] = block->next;
+      pool->m_nFree[sizeClass]--;
+      BlockPool::Add (pool->m_recycled, 1);
+      BlockPool::Add (pool->m_cachedBytes, -(uint64_t) size);
+      return block;
+    }
+  return ::operator new (size);
+}
+
+void
+PacketAllocator::Deallocate (void *p, uint32_t size)
+{
+  // the callers may pass the requested size, account for the block size
+  uint32_t sizeClass = RoundToSizeClass (size);
+  BlockPool *pool = GetPool ();
+  if (pool == DEAD_POOL)
+    {
+      ::operator delete (p);
+      return;
+    }
+  BlockPool::Add (pool->m_freed, 1);
+  if (sizeClass >= BlockPool::N_CLASSES
+      || pool->m_nFree[sizeClass] >= BlockPool::MAX_FREE
+      || pool->m_nFree[sizeClass] >= BlockPool::MAX_FREE_BYTES / size)
+    {
+      ::operator delete (p);
+      return;
+    }
+  BlockPool::FreeBlock *block = static_cast<BlockPool::FreeBlock *> (p);
+  block->next = pool->m_free[sizeClass];
+  pool->m_free[sizeClass] = block;
+  pool->m_nFree[sizeClass]++;
+  BlockPool::Add (pool->m_cachedBytes, size);
+}
+
+PacketAllocator::Stats
+PacketAllocator::GetStats (void)
+{
+  PoolRegistry &registry = GetRegistry ();
+  CriticalSection critical (registry.m_mutex);
+  Stats stats = registry.m_exited;
+  for (std::vector<BlockPool *>::const_iterator i = registry.m_pools.begin (); i != registry.m_pools.end (); ++i)
+    {
+      stats.m_allocated += (*i)->m_allocated.load (std::memory_order_relaxed);
+      stats.m_recycled += (*i)->m_recycled.load (std::memory_order_relaxed);
+      stats.m_freed += (*i)->m_freed.load (std::memory_order_relaxed);
+      stats.m_cachedBytes += (*i)->m_cachedBytes.load (std::memory_order_relaxed);
+    }
+  return stats;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (PacketAllocatorMonitor);
+
+TypeId
+PacketAllocatorMonitor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PacketAllocatorMonitor")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<PacketAllocatorMonitor> ()
+    .AddAttribute ("Interval",
+                   "The interval between two samples of the counters.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&PacketAllocatorMonitor::m_interval),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Stats",
+                     "The counters of the packet allocator, summed over all the threads.",
+                     MakeTraceSourceAccessor (&PacketAllocatorMonitor::m_statsTrace),
+                     "ns3::PacketAllocatorMonitor::StatsTracedCallback")
+  ;
+  return tid;
+}
+
+PacketAllocatorMonitor::PacketAllocatorMonitor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PacketAllocatorMonitor::~PacketAllocatorMonitor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+PacketAllocatorMonitor::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sampleEvent.Cancel ();
+  Object::DoDispose ();
+}
+
+void
+PacketAllocatorMonitor::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sampleEvent.Cancel ();
+  m_sampleEvent = Simulator::ScheduleNow (&PacketAllocatorMonitor::Sample, this);
+}
+
+void
+PacketAllocatorMonitor::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sampleEvent.Cancel ();
+}
+
+void
+PacketAllocatorMonitor::Sample (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_statsTrace (PacketAllocator::GetStats ());
+  m_sampleEvent = Simulator::Schedule (m_interval, &PacketAllocatorMonitor::Sample, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_ALLOCATOR_H
+#define PACKET_ALLOCATOR_H
+
+#include <stdint.h>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief size-class slab allocator of the packet internal storage
+ *
+ * The byte buffers, the metadata and the byte and packet tag lists of
+ * the packets are variable-sized blocks which are copied, fragmented and
+ * released at a high rate by every layer of a protocol stack. This
+ * allocator rounds the blocks up to power of two size classes, from
+ * 32 bytes to 64 KiB, and keeps the released blocks in a freelist per
+ * size class, so that a block of the same class is reused without going
+ * through the heap. The larger blocks go straight to the heap.
+ *
+ * Every thread has its own freelists, so that the threads of a parallel
+ * simulator do not contend for them. A block released by another thread
+ * than the one which allocated it goes to the freelists of the releasing
+ * thread.
+ */
+class PacketAllocator
+{
+public:
+  /** Allocation counters, summed over all the threads. */
+  struct Stats
+  {
+    uint64_t m_allocated;   //!< number of allocated blocks
+    uint64_t m_recycled;    //!< number of blocks taken from a freelist
+    uint64_t m_freed;       //!< number of released blocks
+    uint64_t m_cachedBytes; //!< bytes of the blocks held in the freelists
+  };
+
+  /**
+   * Allocate a block.
+   *
+   * \param [in,out] size the requested size of the block, set to the
+   *        usable size of the allocated block
+   * \return the block
+   */
+  static void * Allocate (uint32_t &size);
+  /**
+   * Release a block.
+   *
+   * \param p the block
+   * \param size the size requested from Allocate, or the usable size it returned
+   */
+  static void Deallocate (void *p, uint32_t size);
+  /**
+   * \return the allocation counters of all the threads
+   */
+  static Stats GetStats (void);
+};
+
+/**
+ * \ingroup packet
+ *
+ * \brief periodically exports the counters of the PacketAllocator
+ *
+ * Once started, the monitor fires its "Stats" trace source with the
+ * counters of the PacketAllocator every "Interval".
+ */
+class PacketAllocatorMonitor : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PacketAllocatorMonitor ();
+  virtual ~PacketAllocatorMonitor ();
+
+  /** Start firing the trace source, from now on. */
+  void Start (void);
+  /** Stop firing the trace source. */
+  void Stop (void);
+
+  /**
+   * TracedCallback signature for the allocation counters.
+   *
+   * \param [in] stats the counters of the PacketAllocator
+   */
+  typedef void (* StatsTracedCallback)(PacketAllocator::Stats stats);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /** Fire the trace source and schedule the next sample. */
+  void Sample (void);
+
+  Time m_interval;                                  //!< sampling interval
+  EventId m_sampleEvent;                            //!< next sample
+  TracedCallback<PacketAllocator::Stats> m_statsTrace; //!< allocation counters trace source
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ALLOCATOR_H */
@@ -23,6 +23,7 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include "packet-metadata.h"
+#include "packet-allocator.h"
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -34,19 +35,8 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList ()
-{
-  NS_LOG_FUNCTION (this);
-  for (iterator i = begin (); i != end (); i++)
-    {
-      PacketMetadata::Deallocate (*i);
-    }
-  PacketMetadata::m_enable = false;
-}
+std::atomic<uint32_t> PacketMetadata::m_maxSize (0);
+CellParallelBatch::Counter PacketMetadata::m_chunkUid (0);
 
 void 
 PacketMetadata::Enable (void)
@@ -77,8 +67,7 @@ PacketMetadata::ReserveCopy (uint32_t size)
   struct PacketMetadata::Data *newData = PacketMetadata::Create (m_used + size);
   memcpy (newData->m_data, m_data->m_data, m_used);
   newData->m_dirtyEnd = m_used;
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       PacketMetadata::Recycle (m_data);
     }
@@ -570,48 +559,25 @@ struct PacketMetadata::Data *
 PacketMetadata::Create (uint32_t size)
 {
   NS_LOG_FUNCTION (size);
-  NS_LOG_LOGIC ("create size="<<size<<", max="<<m_maxSize);
-  if (size > m_maxSize)
-    {
-      m_maxSize = size;
-    }
-  while (!m_freeList.empty ()) 
+  uint32_t maxSize = m_maxSize.load (std::memory_order_relaxed);
+  NS_LOG_LOGIC ("create size="<<size<<", max="<<maxSize);
+  while (size > maxSize
+         && !m_maxSize.compare_exchange_weak (maxSize, size, std::memory_order_relaxed))
     {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
-      if (data->m_size >= size) 
-        {
-          NS_LOG_LOGIC ("create found size="<<data->m_size);
-          data->m_count = 1;
-          return data;
-        }
-      NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
-      PacketMetadata::Deallocate (data);
     }
-  NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
-  return PacketMetadata::Allocate (m_maxSize);
+  maxSize = std::max (size, maxSize);
+  // allocate the largest size seen so far, so that the metadata seldom
+  // need to grow
+  NS_LOG_LOGIC ("create alloc size="<<maxSize);
+  return PacketMetadata::Allocate (maxSize);
 }
 
 void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
-    {
-      PacketMetadata::Deallocate (data);
-      return;
-    } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
-      data->m_size < m_maxSize) 
-    {
-      PacketMetadata::Deallocate (data);
-    } 
-  else 
-    {
-      m_freeList.push_back (data);
-    }
+  PacketMetadata::Deallocate (data);
 }
 
 struct PacketMetadata::Data *
@@ -624,9 +590,10 @@ PacketMetadata::Allocate (uint32_t n)
       n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
   size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-  uint8_t *buf = new uint8_t [size];
-  struct PacketMetadata::Data *data = (struct PacketMetadata::Data *)buf;
-  data->m_size = n;
+  void *buf = PacketAllocator::Allocate (size);
+  struct PacketMetadata::Data *data = static_cast<struct PacketMetadata::Data *> (buf);
+  // the size class of the block may hold more bytes than requested
+  data->m_size = std::min<uint32_t> (size - sizeof (struct Data) + PACKET_METADATA_DATA_M_DATA_SIZE, 0xffff);
   data->m_count = 1;
   data->m_dirtyEnd = 0;
   return data;
@@ -635,8 +602,7 @@ void
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  uint8_t *buf = (uint8_t *)data;
-  delete [] buf;
+  PacketAllocator::Deallocate (data, sizeof (struct Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE);
 }
 
 
@@ -674,8 +640,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = static_cast<uint16_t> (m_chunkUid.Next ());
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
@@ -743,8 +708,7 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
   item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = static_cast<uint16_t> (m_chunkUid.Next ());
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
@@ -23,9 +23,11 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#include <atomic>
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
+#include "ns3/cell-parallel-batch.h"
 #include "buffer.h"
 
 namespace ns3 {
@@ -409,8 +411,9 @@ private:
    * Data structure
    */
   struct Data {
-    /** number of references to this struct Data instance. */
-    uint32_t m_count;
+    /** number of references to this struct Data instance, shared by the
+     *  threads of the simulator. */
+    CellParallelBatch::RefCount m_count;
     /** size (in bytes) of m_data buffer below */
     uint16_t m_size;
     /** max of the m_used field over all objects which
@@ -491,16 +494,6 @@ private:
     uint64_t packetUid;
   };
 
-  /**
-   * \brief Class to hold all the metadata
-   */
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -656,7 +649,6 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -667,8 +659,8 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static std::atomic<uint32_t> m_maxSize; //!< maximum metadata size
+  static CellParallelBatch::Counter m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
   /*
@@ -717,8 +709,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (--m_data->m_count == 0) 
         {
           PacketMetadata::Recycle (m_data);
         }
@@ -735,8 +726,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (--m_data->m_count == 0) 
     {
       PacketMetadata::Recycle (m_data);
     }
@@ -24,16 +24,22 @@
 */
 
 #include "packet-tag-list.h"
+#include "packet-allocator.h"
 #include "tag-buffer.h"
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+const uint32_t PacketTagList::MAX_SLOTS;
+const uint32_t PacketTagList::SLOT_SIZE;
+
 PacketTagList::TagData *
 PacketTagList::CreateTagData (size_t dataSize)
 {
@@ -43,14 +49,154 @@ PacketTagList::CreateTagData (size_t dataSize)
                  << " exceeds maximum "
                  << std::numeric_limits<decltype(TagData::size)>::max () );
 
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+  uint32_t size = sizeof (TagData) + dataSize - 1;
+  void * p = PacketAllocator::Allocate (size);
+  // The matching DeleteTagData are in RemoveAll and RemoveWriter
 
   TagData * tag = new (p) TagData;
   tag->size = dataSize;
   return tag;
 }
 
+void
+PacketTagList::DeleteTagData (TagData * tag)
+{
+  uint32_t size = sizeof (TagData) + tag->size - 1;
+  tag->~TagData ();
+  PacketAllocator::Deallocate (tag, size);
+}
+
+namespace {
+
+/** Marks the slots without an entry in the slot table. */
+const uint8_t NO_ENTRY = 0xff;
+
+/** \returns the TypeId of the tags of each slot */
+std::vector<TypeId> &
+GetSlotTypeIds (void)
+{
+  static std::vector<TypeId> slotTypeIds;
+  return slotTypeIds;
+}
+
+/** \returns the slot of each TypeId uid, or MAX_SLOTS */
+std::vector<uint8_t> &
+GetUidSlots (void)
+{
+  static std::vector<uint8_t> uidSlots;
+  return uidSlots;
+}
+
+/**
+ * \param capacity the number of entries of a slot table
+ * \returns the size of the slot table
+ */
+uint32_t
+GetSlotDataSize (uint32_t capacity)
+{
+  return sizeof (PacketTagList::SlotData) + (capacity - 1) * PacketTagList::SLOT_SIZE;
+}
+
+} // unnamed namespace
+
+TypeId
+PacketTagList::RegisterSlot (TypeId tid)
+{
+  NS_LOG_FUNCTION (tid);
+  std::vector<TypeId> &slotTypeIds = GetSlotTypeIds ();
+  std::vector<uint8_t> &uidSlots = GetUidSlots ();
+  if (GetSlot (tid) != MAX_SLOTS)
+    {
+      return tid;
+    }
+  if (slotTypeIds.size () == MAX_SLOTS)
+    {
+      NS_LOG_WARN ("no slot left for " << tid << ", its tags go to the list");
+      return tid;
+    }
+  if (uidSlots.size () <= tid.GetUid ())
+    {
+      uidSlots.resize (tid.GetUid () + 1, MAX_SLOTS);
+    }
+  uidSlots[tid.GetUid ()] = slotTypeIds.size ();
+  slotTypeIds.push_back (tid);
+  return tid;
+}
+
+TypeId
+PacketTagList::GetSlotTypeId (uint32_t slot)
+{
+  NS_ASSERT (slot < GetSlotTypeIds ().size ());
+  return GetSlotTypeIds ()[slot];
+}
+
+uint32_t
+PacketTagList::GetSlot (TypeId tid)
+{
+  const std::vector<uint8_t> &uidSlots = GetUidSlots ();
+  if (tid.GetUid () < uidSlots.size ())
+    {
+      return uidSlots[tid.GetUid ()];
+    }
+  return MAX_SLOTS;
+}
+
+struct PacketTagList::SlotData *
+PacketTagList::WriteSlots (uint32_t slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+  struct SlotData *slots = m_slots;
+  if (slots != 0 && slots->count == 1
+      && (slots->entry[slot] != NO_ENTRY || slots->used < slots->capacity))
+    {
+      if (slots->entry[slot] == NO_ENTRY)
+        {
+          slots->entry[slot] = slots->used++;
+        }
+      return slots;
+    }
+
+  // copy the tags present in the shared or full table to a new table
+  uint32_t used = (slots != 0) ? __builtin_popcount (slots->present) : 0;
+  uint32_t size = GetSlotDataSize (used + 1);
+  struct SlotData *copy = static_cast<struct SlotData *> (PacketAllocator::Allocate (size));
+  copy->count = 1;
+  copy->present = 0;
+  copy->used = 0;
+  copy->capacity = std::min<uint32_t> ((size - sizeof (SlotData)) / SLOT_SIZE + 1, MAX_SLOTS);
+  memset (copy->entry, NO_ENTRY, MAX_SLOTS);
+  if (slots != 0)
+    {
+      for (uint32_t i = 0; i < MAX_SLOTS; i++)
+        {
+          if (slots->present & (1 << i))
+            {
+              copy->entry[i] = copy->used++;
+              copy->size[i] = slots->size[i];
+              memcpy (copy->data[copy->entry[i]], slots->data[slots->entry[i]], slots->size[i]);
+            }
+        }
+      copy->present = slots->present;
+      ReleaseSlots ();
+    }
+  if (copy->entry[slot] == NO_ENTRY)
+    {
+      copy->entry[slot] = copy->used++;
+    }
+  m_slots = copy;
+  return copy;
+}
+
+void
+PacketTagList::ReleaseSlots (void)
+{
+  if (--m_slots->count == 0)
+    {
+      PacketAllocator::Deallocate (m_slots, GetSlotDataSize (m_slots->capacity));
+    }
+  m_slots = 0;
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -175,6 +321,14 @@ PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove (Tag & tag)
 {
+  uint32_t slot = GetSlot (tag.GetInstanceTypeId ());
+  if (slot != MAX_SLOTS && m_slots != 0 && (m_slots->present & (1 << slot)))
+    {
+      uint8_t *data = m_slots->data[m_slots->entry[slot]];
+      tag.Deserialize (TagBuffer (data, data + m_slots->size[slot]));
+      WriteSlots (slot)->present &= ~(1 << slot);
+      return true;
+    }
   return COWTraverse (tag, &PacketTagList::RemoveWriter);
 }
 
@@ -194,8 +348,7 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      DeleteTagData (cur);
     }
   else
     {
@@ -214,6 +367,22 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
 bool
 PacketTagList::Replace (Tag & tag)
 {
+  uint32_t slot = GetSlot (tag.GetInstanceTypeId ());
+  if (slot != MAX_SLOTS && m_slots != 0 && (m_slots->present & (1 << slot)))
+    {
+      struct SlotData *slots = WriteSlots (slot);
+      if (tag.GetSerializedSize () > SLOT_SIZE)
+        {
+          // the new value only fits in the list
+          slots->present &= ~(1 << slot);
+          Add (tag);
+          return true;
+        }
+      uint8_t *data = slots->data[slots->entry[slot]];
+      slots->size[slot] = tag.GetSerializedSize ();
+      tag.Serialize (TagBuffer (data, data + slots->size[slot]));
+      return true;
+    }
   bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
   if (!found)
     {
@@ -266,6 +435,18 @@ PacketTagList::Add (const Tag &tag) const
       NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (),
                      "Error: cannot add the same kind of tag twice.");
     }
+  uint32_t slot = GetSlot (tag.GetInstanceTypeId ());
+  if (slot != MAX_SLOTS && tag.GetSerializedSize () <= SLOT_SIZE)
+    {
+      NS_ASSERT_MSG (m_slots == 0 || !(m_slots->present & (1 << slot)),
+                     "Error: cannot add the same kind of tag twice.");
+      struct SlotData *slots = const_cast<PacketTagList *> (this)->WriteSlots (slot);
+      uint8_t *data = slots->data[slots->entry[slot]];
+      slots->size[slot] = tag.GetSerializedSize ();
+      tag.Serialize (TagBuffer (data, data + slots->size[slot]));
+      slots->present |= 1 << slot;
+      return;
+    }
   struct TagData * head = CreateTagData (tag.GetSerializedSize ());
   head->count = 1;
   head->next = 0;
@@ -281,6 +462,13 @@ PacketTagList::Peek (Tag &tag) const
 {
   NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
+  uint32_t slot = GetSlot (tid);
+  if (slot != MAX_SLOTS && m_slots != 0 && (m_slots->present & (1 << slot)))
+    {
+      uint8_t *data = m_slots->data[m_slots->entry[slot]];
+      tag.Deserialize (TagBuffer (data, data + m_slots->size[slot]));
+      return true;
+    }
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
     {
       if (cur->tid == tid) 
@@ -300,5 +488,11 @@ PacketTagList::Head (void) const
   return m_next;
 }
 
+const struct PacketTagList::SlotData *
+PacketTagList::Slots (void) const
+{
+  return m_slots;
+}
+
 } /* namespace ns3 */
 
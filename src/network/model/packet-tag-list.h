@@ -28,6 +28,7 @@
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "ns3/cell-parallel-batch.h"
 
 namespace ns3 {
 
@@ -119,6 +120,17 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Fixed slots </b>
+ *
+ * The tags added to nearly every packet by a protocol stack, like the
+ * bearer and RLC tags of the LTE and mmWave stacks, can be given a fixed
+ * slot with #RegisterSlot. The serialized value of such a tag, up to
+ * #SLOT_SIZE bytes, is stored in a SlotData table shared by the copies of
+ * the packet, also copied on write, and the tag is found, added or
+ * removed by a direct access to its slot instead of a walk of the list.
+ * The larger tags of these types, and the tags of the other types, are
+ * kept in the list.
  */
 class PacketTagList 
 {
@@ -141,12 +153,38 @@ public:
   struct TagData
   {
     struct TagData * next;      /**< Pointer to next in list */
-    uint32_t count;             /**< Number of incoming links */
+    CellParallelBatch::RefCount count; /**< Number of incoming links */
     TypeId tid;                 /**< Type of the tag serialized into #data */
     uint32_t size;              /**< Size of the \c data buffer */
     uint8_t data[1];            /**< Serialization buffer */
   };  /* struct TagData */
 
+  /** Maximum number of fixed slots. */
+  static const uint32_t MAX_SLOTS = 16;
+  /** Maximum serialized size of a tag stored in a slot. */
+  static const uint32_t SLOT_SIZE = 32;
+
+  /**
+   * Table of the tags stored in the fixed slots.
+   *
+   * The entries of the table are allocated to the slots as the tags are
+   * added, so that the table only grows to the number of slot tags
+   * carried by the packet.
+   *
+   * \internal
+   * Public for PacketTagIterator, like TagData.
+   */
+  struct SlotData
+  {
+    CellParallelBatch::RefCount count;  /**< Number of PacketTagLists sharing the table */
+    uint16_t present;             /**< Bit set for each slot holding a tag */
+    uint8_t used;                 /**< Number of allocated entries */
+    uint8_t capacity;             /**< Number of entries in \c data */
+    uint8_t entry[MAX_SLOTS];     /**< Entry of each slot, or 0xff */
+    uint8_t size[MAX_SLOTS];      /**< Serialized size of the tag of each slot */
+    uint8_t data[1][SLOT_SIZE];   /**< Entries, \c capacity of them */
+  };  /* struct SlotData */
+
   /**
    * Create a new PacketTagList.
    */
@@ -217,6 +255,25 @@ public:
    * \returns pointer to head of tag list
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * \returns pointer to the table of the slot tags, or 0
+   */
+  const struct PacketTagList::SlotData *Slots (void) const;
+
+  /**
+   * Give a fixed slot to a tag type, to be called from the GetTypeId
+   * of the tag. Once the #MAX_SLOTS slots are taken, the tags of the
+   * type go to the list.
+   *
+   * \param [in] tid The TypeId of the tag.
+   * \returns \pname{tid}
+   */
+  static TypeId RegisterSlot (TypeId tid);
+  /**
+   * \param [in] slot A slot.
+   * \returns The TypeId of the tags of the slot.
+   */
+  static TypeId GetSlotTypeId (uint32_t slot);
 
 private:
   /**
@@ -228,6 +285,31 @@ private:
    */
   static
   TagData * CreateTagData (size_t dataSize);
+  /**
+   * Destruct and release a TagData struct allocated by CreateTagData.
+   *
+   * \param [in] tag The TagData object.
+   */
+  static
+  void DeleteTagData (TagData * tag);
+  /**
+   * \param [in] tid The TypeId of a tag.
+   * \returns The slot of the tag, or #MAX_SLOTS if it has none.
+   */
+  static
+  uint32_t GetSlot (TypeId tid);
+  /**
+   * Make the slot table writable, copying it if it is shared, and
+   * allocate an entry to a slot.
+   *
+   * \param [in] slot The slot.
+   * \returns The writable table.
+   */
+  struct SlotData * WriteSlots (uint32_t slot);
+  /**
+   * Release the slot table.
+   */
+  void ReleaseSlots (void);
   
   /**
    * Typedef of method function pointer for copy-on-write operations
@@ -282,6 +364,10 @@ private:
    * Pointer to first \ref TagData on the list
    */
   struct TagData *m_next;
+  /**
+   * Table of the slot tags, or 0
+   */
+  struct SlotData *m_slots;
 };
 
 } // namespace ns3
@@ -293,24 +379,30 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_slots ()
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (o.m_next),
+    m_slots (o.m_slots)
 {
   if (m_next != 0)
     {
       m_next->count++;
     }
+  if (m_slots != 0)
+    {
+      m_slots->count++;
+    }
 }
 
 PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (m_next == o.m_next && m_slots == o.m_slots) 
     {
       return *this;
     }
@@ -320,6 +412,11 @@ PacketTagList::operator = (PacketTagList const &o)
     {
       m_next->count++;
     }
+  m_slots = o.m_slots;
+  if (m_slots != 0)
+    {
+      m_slots->count++;
+    }
   return *this;
 }
 
@@ -334,24 +431,25 @@ PacketTagList::RemoveAll (void)
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
-      cur->count--;
-      if (cur->count > 0) 
+      if (--cur->count > 0) 
         {
           break;
         }
       if (prev != 0) 
         {
-          prev->~TagData ();
-          std::free (prev);
+          DeleteTagData (prev);
         }
       prev = cur;
     }
   if (prev != 0) 
     {
-      prev->~TagData ();
-      std::free (prev);
+      DeleteTagData (prev);
     }
   m_next = 0;
+  if (m_slots != 0)
+    {
+      ReleaseSlots ();
+    }
 }
 
 } // namespace ns3
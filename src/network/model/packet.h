@@ -34,6 +34,7 @@
 #include "ns3/assert.h"
 #include "ns3/ptr.h"
 #include "ns3/deprecated.h"
+#include "ns3/cell-parallel-batch.h"
 
 namespace ns3 {
 
@@ -152,10 +153,14 @@ private:
     friend class PacketTagIterator;
     /**
      * Constructor
-     * \param data the data to copy.
+     * \param tid the type of the tag.
+     * \param data the serialized tag.
+     * \param size the size of the serialized tag.
      */
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data; //!< the tag data
+    Item (TypeId tid, const uint8_t *data, uint32_t size);
+    TypeId m_tid;          //!< the type of the tag
+    const uint8_t *m_data; //!< the serialized tag
+    uint32_t m_size;       //!< the size of the serialized tag
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -169,9 +174,12 @@ private:
   friend class Packet;
   /**
    * Constructor
+   * \param slots table of the slot items, or 0
    * \param head head of the items
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const struct PacketTagList::SlotData *slots, const struct PacketTagList::TagData *head);
+  const struct PacketTagList::SlotData *m_slots;   //!< table of the slot tags in a packet
+  uint32_t m_slotsLeft;                            //!< slots of the table not visited yet
   const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
 };
 
@@ -312,6 +320,18 @@ public:
    * \param header a reference to the header to add to this packet.
    */
   void AddHeader (const Header & header);
+  /**
+   * \brief Make room for headers at the start of this packet.
+   *
+   * Adding headers to a packet whose buffer is shared, or has no room
+   * left at its start, reallocates the buffer for each header. A packet
+   * about to get several headers, e.g. when it enters a tunnel, can have
+   * its buffer reallocated once here, so that the headers are then
+   * written in place.
+   *
+   * \param size the total size of the headers to be added
+   */
+  void ReserveHeadroom (uint32_t size);
   /**
    * \brief Deserialize and remove the header from the internal buffer.
    *
@@ -730,7 +750,7 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static CellParallelBatch::Counter m_globalUid; //!< Global counter of packets Uid, shared by the threads of the simulator
 };
 
 /**
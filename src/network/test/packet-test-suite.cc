@@ -19,14 +19,25 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/packet-allocator.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
+#include "ns3/cell-parallel-batch.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/core-config.h"
 #include <limits>     // std:numeric_limits
 #include <string>
+#include <vector>
 #include <cstdarg>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <algorithm>
 
 using namespace ns3;
 
@@ -911,6 +922,365 @@ PacketTagListTest::DoRun (void)
     
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Check the packet tags stored in the fixed slots of the PacketTagList,
+ * mixed with the tags stored in the list.
+ */
+class PacketTagSlotTest : public TestCase
+{
+public:
+  PacketTagSlotTest ();
+private:
+  void DoRun (void);
+};
+
+PacketTagSlotTest::PacketTagSlotTest ()
+  : TestCase ("Check the packet tags in fixed slots")
+{
+}
+
+void
+PacketTagSlotTest::DoRun (void)
+{
+  PacketTagList::RegisterSlot (ATestTag<10>::GetTypeId ());
+  PacketTagList::RegisterSlot (ATestTag<11>::GetTypeId ());
+  // too large for a slot
+  PacketTagList::RegisterSlot (ATestTag<40>::GetTypeId ());
+
+  Ptr<Packet> packet = Create<Packet> (10);
+  packet->AddPacketTag (ATestTag<10> (1));
+  packet->AddPacketTag (ATestTag<40> (2));
+  packet->AddPacketTag (ATestTag<2> (3));
+
+  Ptr<Packet> copy = packet->Copy ();
+  ATestTag<10> replaced (4);
+  NS_TEST_EXPECT_MSG_EQ (copy->ReplacePacketTag (replaced), true, "slot tag not replaced");
+  copy->AddPacketTag (ATestTag<11> (5));
+
+  ATestTag<10> a;
+  ATestTag<11> b;
+  ATestTag<40> c;
+  NS_TEST_EXPECT_MSG_EQ (packet->PeekPacketTag (a), true, "slot tag not found");
+  NS_TEST_EXPECT_MSG_EQ (a.GetData (), 1, "slot tag of the original changed by the copy");
+  NS_TEST_EXPECT_MSG_EQ (a.m_error, false, "slot tag corrupted");
+  NS_TEST_EXPECT_MSG_EQ (packet->PeekPacketTag (b), false, "slot tag of the copy added to the original");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (a), true, "replaced slot tag not found");
+  NS_TEST_EXPECT_MSG_EQ (a.GetData (), 4, "slot tag not replaced");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (b), true, "added slot tag not found");
+  NS_TEST_EXPECT_MSG_EQ (b.GetData (), 5, "wrong added slot tag");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (c), true, "large tag not found");
+  NS_TEST_EXPECT_MSG_EQ (c.GetData (), 2, "wrong large tag");
+
+  NS_TEST_EXPECT_MSG_EQ (copy->RemovePacketTag (a), true, "slot tag not removed");
+  NS_TEST_EXPECT_MSG_EQ (a.GetData (), 4, "wrong removed slot tag");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (a), false, "removed slot tag found");
+  NS_TEST_EXPECT_MSG_EQ (packet->PeekPacketTag (a), true, "slot tag of the original removed by the copy");
+  copy->AddPacketTag (ATestTag<10> (6));
+
+  // the iterator visits the slot tags and the list tags
+  uint32_t n = 0;
+  int sum = 0;
+  PacketTagIterator i = copy->GetPacketTagIterator ();
+  while (i.HasNext ())
+    {
+      PacketTagIterator::Item item = i.Next ();
+      Callback<ObjectBase *> constructor = item.GetTypeId ().GetConstructor ();
+      ATestTagBase *tag = dynamic_cast<ATestTagBase *> (constructor ());
+      item.GetTag (*tag);
+      sum += tag->GetData ();
+      delete tag;
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 4, "wrong number of iterated tags");
+  NS_TEST_EXPECT_MSG_EQ (sum, 6 + 5 + 2 + 3, "wrong iterated tags");
+
+  copy->RemoveAllPacketTags ();
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (b), false, "slot tag left after RemoveAll");
+  NS_TEST_EXPECT_MSG_EQ (packet->PeekPacketTag (a), true, "slot tag of the original removed by RemoveAll");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the size classes and the freelists of the PacketAllocator, and
+ * the trace source of the PacketAllocatorMonitor.
+ */
+class PacketAllocatorTest : public TestCase
+{
+public:
+  PacketAllocatorTest ();
+private:
+  void DoRun (void);
+  /**
+   * Sink of the counters of the allocator.
+   * \param stats the counters
+   */
+  void Stats (PacketAllocator::Stats stats);
+
+  std::vector<PacketAllocator::Stats> m_samples; //!< samples of the counters
+};
+
+PacketAllocatorTest::PacketAllocatorTest ()
+  : TestCase ("Check the packet allocator")
+{
+}
+
+void
+PacketAllocatorTest::Stats (PacketAllocator::Stats stats)
+{
+  m_samples.push_back (stats);
+}
+
+void
+PacketAllocatorTest::DoRun (void)
+{
+  PacketAllocator::Stats before = PacketAllocator::GetStats ();
+  uint32_t size = 100;
+  void *p = PacketAllocator::Allocate (size);
+  NS_TEST_EXPECT_MSG_EQ (size, 128, "not rounded up to the size class");
+  PacketAllocator::Deallocate (p, size);
+  size = 120;
+  void *q = PacketAllocator::Allocate (size);
+  NS_TEST_EXPECT_MSG_EQ (q, p, "block of the same size class not reused");
+  PacketAllocator::Deallocate (q, size);
+
+  size = 100000;
+  p = PacketAllocator::Allocate (size);
+  NS_TEST_EXPECT_MSG_EQ (size, 100000, "large block rounded up");
+  PacketAllocator::Deallocate (p, size);
+
+  PacketAllocator::Stats after = PacketAllocator::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (after.m_allocated - before.m_allocated, 3, "wrong number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (after.m_freed - before.m_freed, 3, "wrong number of releases");
+  NS_TEST_EXPECT_MSG_EQ ((after.m_recycled - before.m_recycled >= 1), true, "no block reused");
+
+  // a fragmented and tagged packet goes through the allocator
+  {
+    Ptr<Packet> packet = Create<Packet> (1500);
+    ATestTag<1> tag;
+    packet->AddPacketTag (tag);
+    packet->AddByteTag (tag);
+    Ptr<Packet> fragment = packet->CreateFragment (100, 500);
+    fragment->AddAtEnd (packet->Copy ());
+  }
+  before = after;
+  after = PacketAllocator::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ ((after.m_allocated > before.m_allocated), true, "packet not allocated by the allocator");
+  NS_TEST_EXPECT_MSG_EQ (after.m_allocated - before.m_allocated, after.m_freed - before.m_freed, "packet blocks leaked");
+
+  // a block released with its requested size is accounted at its class size
+  before = after;
+  size = 100;
+  p = PacketAllocator::Allocate (size);
+  PacketAllocator::Deallocate (p, 100);
+  after = PacketAllocator::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (after.m_cachedBytes - before.m_cachedBytes, 128 * (1 - (after.m_recycled - before.m_recycled)),
+                         "block released with its requested size not accounted at its class size");
+
+  // the tag data, released with their requested size, do not make the
+  // cached bytes drift once the freelists are warm
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      before = PacketAllocator::GetStats ();
+      Ptr<Packet> packet = Create<Packet> (100);
+      ATestTag<1> tag1;
+      ATestTag<7> tag7;
+      ATestTag<50> tag50;
+      packet->AddPacketTag (tag1);
+      packet->AddPacketTag (tag7);
+      packet->AddPacketTag (tag50);
+      packet->RemovePacketTag (tag7);
+      packet = 0;
+      after = PacketAllocator::GetStats ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (after.m_cachedBytes, before.m_cachedBytes, "cached bytes drift when tag data are released");
+  NS_TEST_EXPECT_MSG_EQ (after.m_cachedBytes % 32, 0, "cached bytes not a sum of size classes");
+
+  Ptr<PacketAllocatorMonitor> monitor = CreateObject<PacketAllocatorMonitor> ();
+  monitor->SetAttribute ("Interval", TimeValue (MilliSeconds (10)));
+  monitor->TraceConnectWithoutContext ("Stats", MakeCallback (&PacketAllocatorTest::Stats, this));
+  monitor->Start ();
+  Simulator::Stop (MilliSeconds (35));
+  Simulator::Run ();
+  monitor->Dispose ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_samples.size (), 4, "wrong number of samples");
+  NS_TEST_EXPECT_MSG_EQ ((m_samples.front ().m_allocated >= after.m_allocated), true, "wrong sampled counter");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check that the headers added after Packet::ReserveHeadroom are written
+ * in place, without changing the copies sharing the buffer.
+ */
+class PacketHeadroomTest : public TestCase
+{
+public:
+  PacketHeadroomTest ();
+private:
+  void DoRun (void);
+  /**
+   * Remove the first bytes of a copy of a packet, so that the copy shares
+   * a buffer it cannot write into, and add three headers to it.
+   * \param packet the packet
+   * \param reserve whether to reserve the room of the headers first
+   * \param nAllocations the number of blocks allocated to add the headers
+   * \return the copy
+   */
+  Ptr<Packet> AddHeaders (Ptr<const Packet> packet, bool reserve, uint64_t &nAllocations);
+};
+
+PacketHeadroomTest::PacketHeadroomTest ()
+  : TestCase ("Check the headroom reserved in packets")
+{
+}
+
+Ptr<Packet>
+PacketHeadroomTest::AddHeaders (Ptr<const Packet> packet, bool reserve, uint64_t &nAllocations)
+{
+  Ptr<Packet> copy = packet->Copy ();
+  copy->RemoveAtStart (10);
+  if (reserve)
+    {
+      copy->ReserveHeadroom (8 + 8 + 20);
+    }
+  PacketAllocator::Stats before = PacketAllocator::GetStats ();
+  copy->AddHeader (ATestHeader<8> ());
+  copy->AddHeader (ATestHeader<8> ());
+  copy->AddHeader (ATestHeader<20> ());
+  nAllocations = PacketAllocator::GetStats ().m_allocated - before.m_allocated;
+  return copy;
+}
+
+void
+PacketHeadroomTest::DoRun (void)
+{
+  uint8_t data[100];
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      data[i] = i;
+    }
+  Ptr<Packet> packet = Create<Packet> (data, 100);
+
+  uint64_t nAllocations;
+  Ptr<Packet> copy = AddHeaders (packet, false, nAllocations);
+  NS_TEST_EXPECT_MSG_EQ (nAllocations, 3, "buffer not reallocated for each header");
+  copy = AddHeaders (packet, true, nAllocations);
+  NS_TEST_EXPECT_MSG_EQ (nAllocations, 0, "buffer reallocated despite the headroom");
+
+  NS_TEST_EXPECT_MSG_EQ (copy->GetSize (), 90 + 36, "wrong size");
+  ATestHeader<20> ip;
+  ATestHeader<8> udp;
+  ATestHeader<8> gtpu;
+  copy->RemoveHeader (ip);
+  copy->RemoveHeader (udp);
+  copy->RemoveHeader (gtpu);
+  NS_TEST_EXPECT_MSG_EQ ((ip.m_error || udp.m_error || gtpu.m_error), false, "corrupted headers");
+  uint8_t copyData[90];
+  copy->CopyData (copyData, 90);
+  NS_TEST_EXPECT_MSG_EQ (memcmp (copyData, data + 10, 90), 0, "payload changed");
+  uint8_t packetData[100];
+  packet->CopyData (packetData, 100);
+  NS_TEST_EXPECT_MSG_EQ (memcmp (packetData, data, 100), 0, "original packet changed");
+
+  // nothing to do when there is room already
+  PacketAllocator::Stats before = PacketAllocator::GetStats ();
+  copy->ReserveHeadroom (36);
+  NS_TEST_EXPECT_MSG_EQ (PacketAllocator::GetStats ().m_allocated, before.m_allocated, "buffer reallocated with room left");
+}
+
+#ifdef HAVE_PTHREAD_H
+//-----------------------------------------------------------------------------
+/**
+ * Check that the uids of the packets created by the parallel cells of the
+ * CellParallelSimulatorImpl are unique and do not depend on the number
+ * of threads.
+ */
+class PacketParallelUidTest : public TestCase
+{
+public:
+  PacketParallelUidTest ();
+private:
+  void DoRun (void);
+  /**
+   * Run the cells.
+   * \param threads the number of threads of the simulator
+   * \return the uids of the packets of each cell, from the first uid of the run
+   */
+  std::vector<std::vector<uint64_t> > RunCells (uint32_t threads);
+  /**
+   * Create the packets of a cell for a TTI.
+   * \param cell the cell
+   * \param n the TTI number
+   */
+  void Tti (uint32_t cell, uint32_t n);
+
+  std::vector<std::vector<uint64_t> > m_uids; //!< uids of the packets of each cell
+};
+
+PacketParallelUidTest::PacketParallelUidTest ()
+  : TestCase ("Check the uids of the packets created by parallel cells")
+{
+}
+
+void
+PacketParallelUidTest::Tti (uint32_t cell, uint32_t n)
+{
+  for (uint32_t i = 0; i < (cell * n) % 5; i++)
+    {
+      Ptr<Packet> packet = Create<Packet> (100);
+      packet->AddHeader (ATestHeader<8> ());
+      m_uids[cell].push_back (packet->GetUid ());
+    }
+  if (n < 10)
+    {
+      Simulator::Schedule (MilliSeconds (1), &PacketParallelUidTest::Tti, this, cell, n + 1);
+    }
+}
+
+std::vector<std::vector<uint64_t> >
+PacketParallelUidTest::RunCells (uint32_t threads)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::CellParallelSimulatorImpl"));
+  Config::SetDefault ("ns3::CellParallelSimulatorImpl::Threads", UintegerValue (threads));
+  m_uids.assign (5, std::vector<uint64_t> ());
+  for (uint32_t cell = 1; cell < m_uids.size (); cell++)
+    {
+      CellParallelBatch::AddParallelContext (cell);
+      Simulator::ScheduleWithContext (cell, MilliSeconds (1), &PacketParallelUidTest::Tti, this, cell, 1);
+    }
+  uint64_t first = Create<Packet> ()->GetUid () + 1;
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<uint64_t> all;
+  for (uint32_t cell = 1; cell < m_uids.size (); cell++)
+    {
+      for (std::vector<uint64_t>::iterator it = m_uids[cell].begin (); it != m_uids[cell].end (); ++it)
+        {
+          *it -= first;
+          all.push_back (*it);
+        }
+    }
+  std::sort (all.begin (), all.end ());
+  NS_TEST_EXPECT_MSG_EQ ((std::unique (all.begin (), all.end ()) == all.end ()), true,
+                         "packet uid taken twice on " << threads << " threads");
+  return m_uids;
+}
+
+void
+PacketParallelUidTest::DoRun (void)
+{
+  std::vector<std::vector<uint64_t> > sequential = RunCells (1);
+  std::vector<std::vector<uint64_t> > parallel = RunCells (4);
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::Reset ();
+
+  NS_TEST_EXPECT_MSG_EQ (sequential[1].size (), 20, "wrong number of packets");
+  NS_TEST_EXPECT_MSG_EQ ((parallel == sequential), true, "packet uids depend on the threads");
+}
+#endif /* HAVE_PTHREAD_H */
+
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
 {
@@ -923,6 +1293,12 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketTagSlotTest, TestCase::QUICK);
+  AddTestCase (new PacketAllocatorTest, TestCase::QUICK);
+  AddTestCase (new PacketHeadroomTest, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new PacketParallelUidTest, TestCase::QUICK);
+#endif
 }
 
 static PacketTestSuite g_packetTestSuite;
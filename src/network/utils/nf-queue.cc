@@ -0,0 +1,155 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "nf-queue.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NfQueue");
+
+NS_OBJECT_ENSURE_REGISTERED (NfQueue);
+
+NfQueue::NfQueue ()
+  : m_nRefused (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+NfQueue::~NfQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+NfQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NfQueue")
+    .SetParent<Object> ()
+    .SetGroupName("Network")
+    .AddConstructor<NfQueue> ()
+    .AddAttribute ("Workers",
+                   "The number of messages the network function processes in parallel",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&NfQueue::SetNWorkers,
+                                         &NfQueue::GetNWorkers),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("DefaultServiceTime",
+                   "The time a worker takes to process a message without a service time of its own",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&NfQueue::m_defaultServiceTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxQueueLength",
+                   "The number of messages waiting for a worker beyond which the messages "
+                   "starting a procedure are refused, zero for no limit",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NfQueue::m_maxQueueLength),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+void
+NfQueue::SetServiceTime (std::string message, Time serviceTime)
+{
+  NS_LOG_FUNCTION (this << message << serviceTime);
+  m_serviceTimes[message] = serviceTime;
+}
+
+Time
+NfQueue::GetServiceTime (std::string message) const
+{
+  std::map<std::string, Time>::const_iterator it = m_serviceTimes.find (message);
+  return it != m_serviceTimes.end () ? it->second : m_defaultServiceTime;
+}
+
+void
+NfQueue::SetNWorkers (uint32_t nWorkers)
+{
+  NS_LOG_FUNCTION (this << nWorkers);
+  NS_ASSERT_MSG (nWorkers > 0, "a network function needs a worker");
+  // the workers which leave are the last to be free, and they still
+  // process the messages they have been given
+  std::sort (m_workerFreeTimes.begin (), m_workerFreeTimes.end ());
+  m_workerFreeTimes.resize (nWorkers, Simulator::Now ());
+}
+
+uint32_t
+NfQueue::GetNWorkers () const
+{
+  return m_workerFreeTimes.size ();
+}
+
+bool
+NfQueue::IsInstantaneous () const
+{
+  if (!m_defaultServiceTime.IsZero ())
+    {
+      return false;
+    }
+  for (std::map<std::string, Time>::const_iterator it = m_serviceTimes.begin (); it != m_serviceTimes.end (); ++it)
+    {
+      if (!it->second.IsZero ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+NfQueue::Enqueue (std::string message, bool initial, Time &delay)
+{
+  NS_LOG_FUNCTION (this << message << initial);
+  if (initial && m_maxQueueLength > 0 && GetNWaiting () >= m_maxQueueLength)
+    {
+      NS_LOG_INFO ("overload: " << message << " refused");
+      ++m_nRefused;
+      return false;
+    }
+  Time now = Simulator::Now ();
+  std::vector<Time>::iterator worker = std::min_element (m_workerFreeTimes.begin (), m_workerFreeTimes.end ());
+  Time start = std::max (now, *worker);
+  *worker = start + GetServiceTime (message);
+  if (start > now)
+    {
+      m_waitingStartTimes.insert (start);
+    }
+  delay = *worker - now;
+  return true;
+}
+
+uint32_t
+NfQueue::GetNWaiting ()
+{
+  Time now = Simulator::Now ();
+  while (!m_waitingStartTimes.empty () && *m_waitingStartTimes.begin () <= now)
+    {
+      m_waitingStartTimes.erase (m_waitingStartTimes.begin ());
+    }
+  return m_waitingStartTimes.size ();
+}
+
+uint64_t
+NfQueue::GetNRefused () const
+{
+  return m_nRefused;
+}
+
+} // namespace ns3
@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NF_QUEUE_H
+#define NF_QUEUE_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * Processing queue of a network function of a core network, e.g. the MME
+ * of the EPC or the AMF and the SMF of the 5G core. The messages are
+ * served first come first served by "Workers" workers, each message
+ * taking the service time set for its type with SetServiceTime(), or
+ * "DefaultServiceTime".
+ *
+ * A message which starts a procedure is refused when "MaxQueueLength"
+ * messages already wait for a worker, so that the network function can
+ * apply its overload control; the other messages are always queued, so
+ * that the procedures in progress complete.
+ *
+ * The service times being known when the messages arrive, the queue only
+ * keeps when each worker becomes free, and the network function
+ * schedules the processing of each message after the delay given by
+ * Enqueue(). The number of workers can change at run time, e.g. when the
+ * virtual machines hosting the network function scale out: the messages
+ * already queued keep their processing time.
+ */
+class NfQueue : public Object
+{
+public:
+  NfQueue ();
+  virtual ~NfQueue ();
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param message the type of a message, e.g. "InitialUeMessage" or
+   *        "RegistrationRequest"
+   * \param serviceTime the time a worker takes to process the message
+   */
+  void SetServiceTime (std::string message, Time serviceTime);
+
+  /**
+   * \param message the type of a message
+   * \return the time a worker takes to process the message
+   */
+  Time GetServiceTime (std::string message) const;
+
+  /**
+   * \param nWorkers the number of workers, at least one
+   */
+  void SetNWorkers (uint32_t nWorkers);
+
+  /**
+   * \return the number of workers
+   */
+  uint32_t GetNWorkers () const;
+
+  /**
+   * \return true if all the messages have a null service time, in which
+   * case the network function processes them as soon as they arrive
+   */
+  bool IsInstantaneous () const;
+
+  /**
+   * Queue a message arriving now
+   *
+   * \param message the type of the message
+   * \param initial whether the message starts a procedure
+   * \param delay the time after which the message is processed
+   * \return false if the message is refused because of overload
+   */
+  bool Enqueue (std::string message, bool initial, Time &delay);
+
+  /**
+   * \return the number of messages waiting for a worker
+   */
+  uint32_t GetNWaiting ();
+
+  /**
+   * \return the number of messages refused because of overload
+   */
+  uint64_t GetNRefused () const;
+
+private:
+
+  /**
+   * per message type service times
+   */
+  std::map<std::string, Time> m_serviceTimes;
+
+  Time m_defaultServiceTime;
+
+  uint32_t m_maxQueueLength;
+
+  /**
+   * time at which each worker is done with the messages it has been
+   * given
+   */
+  std::vector<Time> m_workerFreeTimes;
+
+  /**
+   * times at which the waiting messages get a worker
+   */
+  std::multiset<Time> m_waitingStartTimes;
+
+  uint64_t m_nRefused;
+};
+
+} // namespace ns3
+
+#endif /* NF_QUEUE_H */
@@ -0,0 +1,223 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/nr-module.h"
+#include "ns3/point-to-point-ngc-helper.h"
+#include "ns3/ngc-control-plane-load-generator.h"
+#include "ns3/eps-bearer-tag.h"
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Throughput of the N3 data path: many UEs set up their PDU session,
+ * driven by the NgcControlPlaneLoadGenerator, and a remote host and the
+ * radio side of the eNBs then send "rate" packets per second each way
+ * through the eNBs and the UPF, to the UEs in turn. The radio is a
+ * SimpleChannel per eNB, so that the run time is spent in the eNB
+ * applications, the GTP-U tunnels and the UPF.
+ */
+
+NS_LOG_COMPONENT_DEFINE ("NgcN3Throughput");
+
+static uint64_t g_nSent = 0;
+static uint64_t g_nDownlink = 0;
+static uint64_t g_nUplink = 0;
+
+static void
+ReceiveDownlink (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                 const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  ++g_nDownlink;
+}
+
+static void
+ReceiveUplink (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      ++g_nUplink;
+    }
+}
+
+/**
+ * a UE seen from the radio side of its eNB
+ */
+struct Ue
+{
+  Ipv4Address addr;
+  uint16_t rnti;
+  Ptr<NetDevice> radioDevice;
+  Address enbAddress;
+};
+
+static void
+SendDownlink (Ptr<Socket> socket, const std::vector<Ue> *ues, uint32_t i, uint32_t size, Time interval, Time stop)
+{
+  socket->SendTo (Create<Packet> (size), 0, InetSocketAddress ((*ues)[i].addr, 9));
+  ++g_nSent;
+  if (Simulator::Now () + interval < stop)
+    {
+      Simulator::Schedule (interval, &SendDownlink, socket, ues, (i + 1) % ues->size (), size, interval, stop);
+    }
+}
+
+static void
+SendUplink (const std::vector<Ue> *ues, Ipv4Address remoteHostAddr, uint32_t i, uint32_t size, Time interval, Time stop)
+{
+  const Ue &ue = (*ues)[i];
+  Ptr<Packet> packet = Create<Packet> (size);
+  UdpHeader udp;
+  udp.SetSourcePort (9);
+  udp.SetDestinationPort (9);
+  packet->AddHeader (udp);
+  Ipv4Header ip;
+  ip.SetSource (ue.addr);
+  ip.SetDestination (remoteHostAddr);
+  ip.SetProtocol (UdpL4Protocol::PROT_NUMBER);
+  ip.SetPayloadSize (packet->GetSize ());
+  ip.SetTtl (64);
+  packet->AddHeader (ip);
+  // the default bearer of the UE
+  packet->AddPacketTag (EpsBearerTag (ue.rnti, 1));
+  ue.radioDevice->Send (packet, ue.enbAddress, Ipv4L3Protocol::PROT_NUMBER);
+  ++g_nSent;
+  if (Simulator::Now () + interval < stop)
+    {
+      Simulator::Schedule (interval, &SendUplink, ues, remoteHostAddr, (i + 1) % ues->size (), size, interval, stop);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numUes = 10000;
+  uint16_t numEnbs = 10;
+  uint16_t numUpfs = 1;
+  double rate = 100000.0;
+  uint32_t packetSize = 100;
+  double trafficTime = 1.0;
+
+  CommandLine cmd;
+  cmd.AddValue ("numUes", "Number of UEs", numUes);
+  cmd.AddValue ("numEnbs", "Number of eNBs", numEnbs);
+  cmd.AddValue ("numUpfs", "Number of UPFs", numUpfs);
+  cmd.AddValue ("rate", "Packets per second in each direction", rate);
+  cmd.AddValue ("packetSize", "Size of the UDP payload [bytes]", packetSize);
+  cmd.AddValue ("trafficTime", "Duration of the traffic [s]", trafficTime);
+  cmd.Parse (argc, argv);
+
+  Ptr<PointToPointNgcHelper> ngcHelper = CreateObject<PointToPointNgcHelper> ();
+  ngcHelper->SetAttribute ("NumUpfs", UintegerValue (numUpfs));
+  ngcHelper->SetAttribute ("N2uLinkDataRate", DataRateValue (DataRate ("100Gb/s")));
+  ngcHelper->SetAttribute ("N2uLinkDelay", TimeValue (MilliSeconds (1)));
+  ngcHelper->SetAttribute ("N6LinkDataRate", DataRateValue (DataRate ("100Gb/s")));
+
+  Ptr<Node> upf = ngcHelper->GetUpfNode ();
+  NodeContainer remoteHostContainer;
+  remoteHostContainer.Create (1);
+  Ptr<Node> remoteHost = remoteHostContainer.Get (0);
+  InternetStackHelper internet;
+  internet.Install (remoteHostContainer);
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (1500));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (MilliSeconds (1)));
+  NetDeviceContainer internetDevices = p2ph.Install (upf, remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+  Ipv4Address remoteHostAddr = internetIpIfaces.GetAddress (1);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> remoteHostStaticRouting = ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ());
+  remoteHostStaticRouting->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+
+  // eNBs without NR stack: each one shares a SimpleChannel with a device
+  // of the radio node, which stands for all its UEs
+  NodeContainer enbNodes;
+  enbNodes.Create (numEnbs);
+  Ptr<Node> radio = CreateObject<Node> ();
+  std::vector<Ptr<NetDevice> > radioDevices;
+  std::vector<Address> enbAddresses;
+  for (uint16_t i = 0; i < numEnbs; ++i)
+    {
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      Ptr<SimpleNetDevice> enbDev = CreateObject<SimpleNetDevice> ();
+      enbDev->SetAddress (Mac48Address::Allocate ());
+      enbDev->SetChannel (channel);
+      enbNodes.Get (i)->AddDevice (enbDev);
+      Ptr<SimpleNetDevice> radioDev = CreateObject<SimpleNetDevice> ();
+      radioDev->SetAddress (Mac48Address::Allocate ());
+      radioDev->SetChannel (channel);
+      radio->AddDevice (radioDev);
+      radio->RegisterProtocolHandler (MakeCallback (&ReceiveDownlink), Ipv4L3Protocol::PROT_NUMBER, radioDev);
+      radioDevices.push_back (radioDev);
+      enbAddresses.push_back (enbDev->GetAddress ());
+      ngcHelper->AddEnb (enbNodes.Get (i), enbDev, i + 1);
+    }
+
+  // the UEs camp on the eNBs in turn, and get their RNTIs in order, as
+  // the load generator gives them
+  Ptr<NgcControlPlaneLoadGenerator> generator = CreateObject<NgcControlPlaneLoadGenerator> ();
+  generator->SetAttribute ("ArrivalProcess", StringValue ("Burst"));
+  generator->SetAttribute ("ReleaseSession", BooleanValue (false));
+  generator->SetAttribute ("ConnectedTime", StringValue ("ns3::ConstantRandomVariable[Constant=1e6]"));
+  for (uint16_t i = 0; i < numEnbs; ++i)
+    {
+      generator->AddEnb (enbNodes.Get (i)->GetApplication (0)->GetObject<NgcEnbApplication> ());
+    }
+  std::vector<Ue> ues;
+  for (uint64_t imsi = 1; imsi <= numUes; ++imsi)
+    {
+      Ue ue;
+      ue.addr = ngcHelper->AssignRemoteUeIpv4Address ();
+      ue.rnti = imsi;
+      ue.radioDevice = radioDevices[(imsi - 1) % numEnbs];
+      ue.enbAddress = enbAddresses[(imsi - 1) % numEnbs];
+      ues.push_back (ue);
+      ngcHelper->AddRemoteUe (imsi, ue.addr);
+      ngcHelper->ActivateRemoteEpsBearer (imsi, NgcTft::Default (), EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+      generator->AddUe (imsi);
+    }
+  generator->AssignStreams (1);
+  generator->Start (Seconds (0.1));
+
+  Ptr<Socket> sink = Socket::CreateSocket (remoteHost, UdpSocketFactory::GetTypeId ());
+  sink->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+  sink->SetRecvCallback (MakeCallback (&ReceiveUplink));
+  Ptr<Socket> source = Socket::CreateSocket (remoteHost, UdpSocketFactory::GetTypeId ());
+  source->Bind ();
+
+  // the sessions are up well before the traffic starts
+  Time start = Seconds (2);
+  Time stop = start + Seconds (trafficTime);
+  Time interval = Seconds (1.0 / rate);
+  Simulator::Schedule (start, &SendDownlink, source, &ues, 0, packetSize, interval, stop);
+  Simulator::Schedule (start, &SendUplink, &ues, remoteHostAddr, 0, packetSize, interval, stop);
+
+  Simulator::Stop (stop + Seconds (0.1));
+  Simulator::Run ();
+
+  std::cout << "downlink packets " << g_nDownlink << ", uplink packets " << g_nUplink
+            << ", sent " << g_nSent << " in total" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
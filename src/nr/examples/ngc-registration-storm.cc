@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/nr-module.h"
+#include "ns3/point-to-point-ngc-helper.h"
+#include "ns3/ngc-control-plane-load-generator.h"
+#include "ns3/ngc-control-plane-profiler.h"
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Registration storm on the NGC: many UEs register, set up their PDU
+ * session, go through CM-IDLE and release their session, driven by the
+ * NgcControlPlaneLoadGenerator in place of the radio. The latency of each
+ * procedure, split between the RAN, the N2-AP transport, the AMF and the
+ * SMF, is written to NgcControlPlaneStats.txt.
+ *
+ * The AMFs and the SMF process each message in "serviceTime" with
+ * "workers" workers; with "maxQueue" set, the AMFs drop or reject the
+ * Registration Requests they cannot queue, according to "overload".
+ */
+
+NS_LOG_COMPONENT_DEFINE ("NgcRegistrationStorm");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numUes = 10000;
+  uint16_t numEnbs = 10;
+  uint16_t numAmfs = 1;
+  std::string arrival = "Burst";
+  double rate = 1000.0;
+  double burstDuration = 1.0;
+  std::string replayFile = "";
+  uint32_t idleCycles = 0;
+  double simTime = 30.0;
+  double serviceTime = 0.0;
+  uint32_t workers = 1;
+  uint32_t maxQueue = 0;
+  std::string overload = "Reject";
+
+  CommandLine cmd;
+  cmd.AddValue ("numUes", "Number of UEs", numUes);
+  cmd.AddValue ("numEnbs", "Number of eNBs", numEnbs);
+  cmd.AddValue ("numAmfs", "Number of AMFs of the AMF set", numAmfs);
+  cmd.AddValue ("arrival", "Arrival process of the UEs (Poisson, Burst or Replay)", arrival);
+  cmd.AddValue ("rate", "Arrival rate of the Poisson process [UEs/s]", rate);
+  cmd.AddValue ("burstDuration", "Duration of the burst [s]", burstDuration);
+  cmd.AddValue ("replayFile", "File of the arrivals to replay", replayFile);
+  cmd.AddValue ("idleCycles", "Number of CM-IDLE cycles of each UE", idleCycles);
+  cmd.AddValue ("simTime", "Total duration of the simulation [s]", simTime);
+  cmd.AddValue ("serviceTime", "Service time of each message in the AMFs and the SMF [ms]", serviceTime);
+  cmd.AddValue ("workers", "Number of workers of the AMFs and of the SMF", workers);
+  cmd.AddValue ("maxQueue", "Queue length beyond which the AMFs refuse the registrations, 0 for no limit", maxQueue);
+  cmd.AddValue ("overload", "What the AMFs do with the registrations they refuse (Drop or Reject)", overload);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::NfQueue::DefaultServiceTime", TimeValue (Seconds (serviceTime / 1000)));
+  Config::SetDefault ("ns3::NfQueue::Workers", UintegerValue (workers));
+  Config::SetDefault ("ns3::NfQueue::MaxQueueLength", UintegerValue (maxQueue));
+  Config::SetDefault ("ns3::NgcAmfApplication::OverloadAction", StringValue (overload));
+
+  Ptr<PointToPointNgcHelper> ngcHelper = CreateObject<PointToPointNgcHelper> ();
+  ngcHelper->SetAttribute ("NumAmfs", UintegerValue (numAmfs));
+  ngcHelper->SetAttribute ("N2apLinkDelay", TimeValue (MilliSeconds (2)));
+  ngcHelper->SetAttribute ("N2apLinkDataRate", DataRateValue (DataRate ("1Gb/s")));
+
+  // eNBs without radio: a placeholder device stands for the NR device
+  NodeContainer enbNodes;
+  enbNodes.Create (numEnbs);
+  for (uint16_t i = 0; i < numEnbs; ++i)
+    {
+      Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+      enbNodes.Get (i)->AddDevice (dev);
+      ngcHelper->AddEnb (enbNodes.Get (i), dev, i + 1);
+    }
+
+  Ptr<NgcControlPlaneProfiler> profiler = CreateObject<NgcControlPlaneProfiler> ();
+  for (uint32_t i = 0; i < ngcHelper->GetNAmfs (); ++i)
+    {
+      profiler->AddAmf (ngcHelper->GetAmfApp (i));
+    }
+  profiler->AddSmf (ngcHelper->GetSmfApp ());
+
+  Ptr<NgcControlPlaneLoadGenerator> generator = CreateObject<NgcControlPlaneLoadGenerator> ();
+  generator->SetAttribute ("ArrivalProcess", StringValue (arrival));
+  generator->SetAttribute ("ArrivalRate", DoubleValue (rate));
+  generator->SetAttribute ("BurstDuration", TimeValue (Seconds (burstDuration)));
+  generator->SetAttribute ("ReplayFilename", StringValue (replayFile));
+  generator->SetAttribute ("IdleCycles", UintegerValue (idleCycles));
+  generator->SetProfiler (profiler);
+  for (uint16_t i = 0; i < numEnbs; ++i)
+    {
+      generator->AddEnb (enbNodes.Get (i)->GetApplication (0)->GetObject<NgcEnbApplication> ());
+    }
+
+  for (uint64_t imsi = 1; imsi <= numUes; ++imsi)
+    {
+      ngcHelper->AddRemoteUe (imsi, ngcHelper->AssignRemoteUeIpv4Address ());
+      ngcHelper->ActivateRemoteEpsBearer (imsi, NgcTft::Default (), EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+      generator->AddUe (imsi);
+    }
+  generator->AssignStreams (1);
+  generator->Start (Seconds (0.1));
+
+  Simulator::Stop (Seconds (simTime));
+  Simulator::Run ();
+
+  profiler->WriteResults ();
+  for (uint32_t p = 0; p < NgcControlPlaneProfiler::N_PROCEDURES; ++p)
+    {
+      NgcControlPlaneProfiler::Procedure procedure = static_cast<NgcControlPlaneProfiler::Procedure> (p);
+      std::cout << NgcControlPlaneProfiler::GetProcedureName (procedure)
+                << ": " << profiler->GetNProcedures (procedure) << " completed";
+      if (profiler->GetNProcedures (procedure) > 0)
+        {
+          std::cout << ", mean " << profiler->GetMeanLatency (procedure, NgcControlPlaneProfiler::TOTAL).GetSeconds () * 1000
+                    << " ms, p99 " << profiler->GetLatencyQuantile (procedure, NgcControlPlaneProfiler::TOTAL, 0.99).GetSeconds () * 1000
+                    << " ms";
+        }
+      std::cout << std::endl;
+    }
+  for (uint32_t i = 0; i < ngcHelper->GetNAmfs (); ++i)
+    {
+      std::ostringstream nf;
+      nf << "AMF" << i + 1;
+      std::cout << nf.str () << " max backlog " << profiler->GetMaxBacklog (nf.str ()) << std::endl;
+    }
+  std::cout << "SMF max backlog " << profiler->GetMaxBacklog ("SMF") << std::endl;
+  std::cout << "registrations rejected " << generator->GetNRejected ()
+            << ", retransmitted " << generator->GetNRetransmissions () << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
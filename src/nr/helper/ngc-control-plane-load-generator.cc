@@ -0,0 +1,436 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ngc-control-plane-load-generator.h"
+#include <ns3/ngc-enb-application.h>
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/simulator.h>
+#include <ns3/enum.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/string.h>
+#include <ns3/pointer.h>
+#include <fstream>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NgcControlPlaneLoadGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED (NgcControlPlaneLoadGenerator);
+
+NgcControlPlaneLoadGenerator::NgcControlPlaneLoadGenerator ()
+  : m_nRejected (0),
+    m_nRetransmissions (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_n2SapUser = new MemberNgcEnbN2SapUser<NgcControlPlaneLoadGenerator> (this);
+  m_interArrivalTime = CreateObject<ExponentialRandomVariable> ();
+  m_burstArrivalTime = CreateObject<UniformRandomVariable> ();
+}
+
+NgcControlPlaneLoadGenerator::~NgcControlPlaneLoadGenerator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+NgcControlPlaneLoadGenerator::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  delete m_n2SapUser;
+  m_n2SapUser = 0;
+  m_enbApps.clear ();
+  m_profiler = 0;
+  m_connectedTime = 0;
+  m_idleTime = 0;
+  m_interArrivalTime = 0;
+  m_burstArrivalTime = 0;
+}
+
+TypeId
+NgcControlPlaneLoadGenerator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NgcControlPlaneLoadGenerator")
+    .SetParent<Object> ()
+    .SetGroupName("Nr")
+    .AddConstructor<NgcControlPlaneLoadGenerator> ()
+    .AddAttribute ("ArrivalProcess",
+                   "The arrival process of the UEs",
+                   EnumValue (POISSON),
+                   MakeEnumAccessor (&NgcControlPlaneLoadGenerator::m_arrivalProcess),
+                   MakeEnumChecker (POISSON, "Poisson",
+                                    BURST, "Burst",
+                                    REPLAY, "Replay"))
+    .AddAttribute ("ArrivalRate",
+                   "The mean number of UEs arriving per second with the Poisson process",
+                   DoubleValue (1000.0),
+                   MakeDoubleAccessor (&NgcControlPlaneLoadGenerator::m_arrivalRate),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("BurstDuration",
+                   "The time within which all the UEs arrive with the burst process",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&NgcControlPlaneLoadGenerator::m_burstDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("ReplayFilename",
+                   "The file of the arrivals replayed with the replay process",
+                   StringValue (""),
+                   MakeStringAccessor (&NgcControlPlaneLoadGenerator::m_replayFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("RrcDelay",
+                   "The time taken by the RAN side of a UE to set up its RRC connection "
+                   "and to answer the NAS messages",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&NgcControlPlaneLoadGenerator::m_rrcDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("ConnectedTime",
+                   "The time in seconds a UE stays in CM-CONNECTED",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=5.0]"),
+                   MakePointerAccessor (&NgcControlPlaneLoadGenerator::m_connectedTime),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("IdleTime",
+                   "The time in seconds a UE stays in CM-IDLE",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=10.0]"),
+                   MakePointerAccessor (&NgcControlPlaneLoadGenerator::m_idleTime),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("IdleCycles",
+                   "The number of cycles of CM-IDLE and Service Request of a UE",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NgcControlPlaneLoadGenerator::m_idleCycles),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ReleaseSession",
+                   "Whether the UEs release their PDU session at the end",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&NgcControlPlaneLoadGenerator::m_releaseSession),
+                   MakeBooleanChecker ())
+    .AddAttribute ("T3510",
+                   "The time after which a UE sends its Registration Request again "
+                   "if the AMF has not answered, zero for never",
+                   TimeValue (Seconds (15)),
+                   MakeTimeAccessor (&NgcControlPlaneLoadGenerator::m_t3510),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+void
+NgcControlPlaneLoadGenerator::AddEnb (Ptr<NgcEnbApplication> enbApp)
+{
+  NS_LOG_FUNCTION (this << enbApp);
+  enbApp->SetN2SapUser (m_n2SapUser);
+  m_enbApps.push_back (enbApp);
+}
+
+void
+NgcControlPlaneLoadGenerator::AddUe (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  NS_ASSERT_MSG (!m_enbApps.empty (), "add the eNBs before the UEs");
+  NS_ASSERT_MSG (m_ueInfoMap.find (imsi) == m_ueInfoMap.end (), "IMSI " << imsi << " already added");
+  NS_ASSERT_MSG (m_imsis.size () < 65535, "too many UEs for the RNTIs");
+  UeInfo ue;
+  ue.enbIndex = m_imsis.size () % m_enbApps.size ();
+  ue.rnti = m_imsis.size () + 1;
+  ue.registered = false;
+  ue.sessionSetup = false;
+  ue.waitingAccept = false;
+  ue.idleCyclesLeft = m_idleCycles;
+  m_ueInfoMap[imsi] = ue;
+  m_imsiByRnti[ue.rnti] = imsi;
+  m_imsis.push_back (imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::SetProfiler (Ptr<NgcControlPlaneProfiler> profiler)
+{
+  m_profiler = profiler;
+}
+
+void
+NgcControlPlaneLoadGenerator::Start (Time start)
+{
+  NS_LOG_FUNCTION (this << start);
+  switch (m_arrivalProcess)
+    {
+    case POISSON:
+      {
+        NS_ASSERT_MSG (m_arrivalRate > 0, "the arrival rate must be positive");
+        double t = start.GetSeconds ();
+        for (std::vector<uint64_t>::iterator it = m_imsis.begin (); it != m_imsis.end (); ++it)
+          {
+            Simulator::Schedule (Seconds (t) - Simulator::Now (),
+                                 &NgcControlPlaneLoadGenerator::Connect, this, *it);
+            t += m_interArrivalTime->GetValue (1.0 / m_arrivalRate, 0);
+          }
+        break;
+      }
+    case BURST:
+      for (std::vector<uint64_t>::iterator it = m_imsis.begin (); it != m_imsis.end (); ++it)
+        {
+          Time t = start + Seconds (m_burstArrivalTime->GetValue (0, m_burstDuration.GetSeconds ()));
+          Simulator::Schedule (t - Simulator::Now (),
+                               &NgcControlPlaneLoadGenerator::Connect, this, *it);
+        }
+      break;
+    case REPLAY:
+      {
+        std::ifstream file (m_replayFilename.c_str ());
+        NS_ABORT_MSG_UNLESS (file.is_open (), "cannot open " << m_replayFilename);
+        std::string line;
+        uint32_t lineNumber = 0;
+        while (std::getline (file, line))
+          {
+            ++lineNumber;
+            std::string::size_type comment = line.find ('#');
+            if (comment != std::string::npos)
+              {
+                line.erase (comment);
+              }
+            std::istringstream iss (line);
+            double t;
+            uint64_t imsi;
+            if (!(iss >> t))
+              {
+                continue;
+              }
+            NS_ABORT_MSG_UNLESS ((iss >> imsi) && t >= 0,
+                                 m_replayFilename << ":" << lineNumber << ": expected <time> <IMSI>");
+            NS_ABORT_MSG_UNLESS (m_ueInfoMap.find (imsi) != m_ueInfoMap.end (),
+                                 m_replayFilename << ":" << lineNumber << ": unknown IMSI " << imsi);
+            Simulator::Schedule (start + Seconds (t) - Simulator::Now (),
+                                 &NgcControlPlaneLoadGenerator::Connect, this, imsi);
+          }
+        break;
+      }
+    default:
+      NS_FATAL_ERROR ("unknown arrival process " << m_arrivalProcess);
+    }
+}
+
+int64_t
+NgcControlPlaneLoadGenerator::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_interArrivalTime->SetStream (stream);
+  m_burstArrivalTime->SetStream (stream + 1);
+  m_connectedTime->SetStream (stream + 2);
+  m_idleTime->SetStream (stream + 3);
+  return 4;
+}
+
+uint64_t
+NgcControlPlaneLoadGenerator::GetNRejected () const
+{
+  return m_nRejected;
+}
+
+uint64_t
+NgcControlPlaneLoadGenerator::GetNRetransmissions () const
+{
+  return m_nRetransmissions;
+}
+
+void
+NgcControlPlaneLoadGenerator::Connect (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  if (m_profiler != 0)
+    {
+      m_profiler->StartProcedure (imsi, ue.registered ? NgcControlPlaneProfiler::SERVICE_REQUEST
+                                                      : NgcControlPlaneProfiler::REGISTRATION);
+      m_profiler->AddDelay (imsi, NgcControlPlaneProfiler::RAN, m_rrcDelay);
+    }
+  Simulator::Schedule (m_rrcDelay, &NgcControlPlaneLoadGenerator::SendRegistrationRequest, this, imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::SendRegistrationRequest (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  // the Service Request of the tree is a Registration Request of a UE
+  // known to its AMF
+  m_enbApps[ue.enbIndex]->GetN2SapProvider ()->RegistrationRequest (imsi, ue.rnti);
+  ue.waitingAccept = true;
+  if (!m_t3510.IsZero ())
+    {
+      ue.t3510Event = Simulator::Schedule (m_t3510, &NgcControlPlaneLoadGenerator::RetransmitRegistrationRequest, this, imsi);
+    }
+}
+
+void
+NgcControlPlaneLoadGenerator::RetransmitRegistrationRequest (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  ++m_nRetransmissions;
+  if (m_profiler != 0)
+    {
+      m_profiler->AddDelay (imsi, NgcControlPlaneProfiler::RAN, m_t3510);
+    }
+  SendRegistrationRequest (imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::DoIdentityRequest (NgcEnbN2SapUser::IdentityRequestParameters params)
+{
+  NS_LOG_FUNCTION (this << params.rnti);
+  // the AMF does not wait for the Identity Response to accept the
+  // registration, so the answer is off the path of the procedure
+  uint64_t imsi = GetImsi (params.rnti);
+  Simulator::Schedule (m_rrcDelay, &NgcControlPlaneLoadGenerator::SendIdentityResponse, this, imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::SendIdentityResponse (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  m_enbApps[ue.enbIndex]->GetN2SapProvider ()->IdentityResponse (imsi, ue.rnti);
+}
+
+void
+NgcControlPlaneLoadGenerator::DoRegistrationAccept (NgcEnbN2SapUser::RegistrationAcceptParameters params)
+{
+  NS_LOG_FUNCTION (this << params.rnti << params.guti);
+  uint64_t imsi = GetImsi (params.rnti);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  if (!ue.waitingAccept)
+    {
+      // answer to a request sent again on the expiry of T3510
+      return;
+    }
+  ue.waitingAccept = false;
+  ue.t3510Event.Cancel ();
+  if (ue.registered)
+    {
+      if (m_profiler != 0)
+        {
+          m_profiler->EndProcedure (imsi, NgcControlPlaneProfiler::SERVICE_REQUEST);
+        }
+      Simulator::Schedule (Seconds (m_connectedTime->GetValue ()),
+                           &NgcControlPlaneLoadGenerator::Disconnect, this, imsi);
+      return;
+    }
+  ue.registered = true;
+  if (m_profiler != 0)
+    {
+      m_profiler->EndProcedure (imsi, NgcControlPlaneProfiler::REGISTRATION);
+      // the PDU session is set up when the AMF gets the Registration Complete
+      m_profiler->StartProcedure (imsi, NgcControlPlaneProfiler::PDU_SESSION_SETUP);
+      m_profiler->AddDelay (imsi, NgcControlPlaneProfiler::RAN, m_rrcDelay);
+    }
+  Simulator::Schedule (m_rrcDelay, &NgcControlPlaneLoadGenerator::SendRegistrationComplete, this, imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::DoRegistrationReject (NgcEnbN2SapUser::RegistrationRejectParameters params)
+{
+  NS_LOG_FUNCTION (this << params.rnti << (uint32_t) params.cause << params.t3346);
+  uint64_t imsi = GetImsi (params.rnti);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  if (!ue.waitingAccept)
+    {
+      return;
+    }
+  ue.waitingAccept = false;
+  ue.t3510Event.Cancel ();
+  ++m_nRejected;
+  // NAS back-off: the UE tries again once T3346 expires, over a new RRC
+  // connection
+  if (m_profiler != 0)
+    {
+      m_profiler->AddDelay (imsi, NgcControlPlaneProfiler::RAN, params.t3346 + m_rrcDelay);
+    }
+  Simulator::Schedule (params.t3346 + m_rrcDelay, &NgcControlPlaneLoadGenerator::SendRegistrationRequest, this, imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::SendRegistrationComplete (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  m_enbApps[ue.enbIndex]->GetN2SapProvider ()->RegistrationComplete (imsi, ue.rnti);
+}
+
+void
+NgcControlPlaneLoadGenerator::DoDataRadioBearerSetupRequest (NgcEnbN2SapUser::DataRadioBearerSetupRequestParameters params)
+{
+  NS_LOG_FUNCTION (this << params.rnti << (uint32_t) params.bearerId);
+  uint64_t imsi = GetImsi (params.rnti);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  ue.bearerIds.push_back (params.bearerId);
+  if (ue.sessionSetup)
+    {
+      // further bearers of the same Initial Context Setup Request
+      return;
+    }
+  ue.sessionSetup = true;
+  if (m_profiler != 0)
+    {
+      m_profiler->EndProcedure (imsi, NgcControlPlaneProfiler::PDU_SESSION_SETUP);
+    }
+  Simulator::Schedule (Seconds (m_connectedTime->GetValue ()),
+                       &NgcControlPlaneLoadGenerator::Disconnect, this, imsi);
+}
+
+void
+NgcControlPlaneLoadGenerator::DoPathSwitchRequestAcknowledge (NgcEnbN2SapUser::PathSwitchRequestAcknowledgeParameters params)
+{
+  NS_LOG_FUNCTION (this << params.rnti);
+  // the UEs of the generator do not move
+}
+
+void
+NgcControlPlaneLoadGenerator::Disconnect (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  UeInfo &ue = m_ueInfoMap[imsi];
+  Ptr<NgcEnbApplication> enbApp = m_enbApps[ue.enbIndex];
+  if (ue.idleCyclesLeft > 0)
+    {
+      // CM-IDLE: the eNB releases the context of the UE, which the AMF keeps
+      --ue.idleCyclesLeft;
+      enbApp->GetN2SapProvider ()->UeContextRelease (ue.rnti);
+      Simulator::Schedule (Seconds (m_idleTime->GetValue ()),
+                           &NgcControlPlaneLoadGenerator::Connect, this, imsi);
+      return;
+    }
+  if (m_releaseSession && !ue.bearerIds.empty ())
+    {
+      if (m_profiler != 0)
+        {
+          m_profiler->StartProcedure (imsi, NgcControlPlaneProfiler::PDU_SESSION_RELEASE);
+        }
+      for (std::list<uint8_t>::iterator it = ue.bearerIds.begin (); it != ue.bearerIds.end (); ++it)
+        {
+          enbApp->GetN2SapProvider ()->DoSendReleaseIndication (imsi, ue.rnti, *it);
+        }
+      ue.bearerIds.clear ();
+    }
+}
+
+uint64_t
+NgcControlPlaneLoadGenerator::GetImsi (uint16_t rnti) const
+{
+  std::map<uint16_t, uint64_t>::const_iterator it = m_imsiByRnti.find (rnti);
+  NS_ASSERT_MSG (it != m_imsiByRnti.end (), "unknown RNTI " << rnti);
+  return it->second;
+}
+
+} // namespace ns3
@@ -0,0 +1,247 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NGC_CONTROL_PLANE_LOAD_GENERATOR_H
+#define NGC_CONTROL_PLANE_LOAD_GENERATOR_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/ngc-enb-n2-sap.h>
+#include <ns3/ngc-control-plane-profiler.h>
+#include <vector>
+#include <map>
+#include <list>
+
+namespace ns3 {
+
+class NgcEnbApplication;
+
+/**
+ * \ingroup nr
+ *
+ * Control plane load generator, which stands for the RRC and the NAS of
+ * many UEs in the eNBs added with AddEnb(), so that the NGC can be
+ * loaded with thousands of UEs without simulating their radio.
+ *
+ * The UEs added with AddUe() arrive according to the "ArrivalProcess"
+ * attribute:
+ *  - POISSON: at "ArrivalRate" UEs per second, in the order they were
+ *    added;
+ *  - BURST: all within "BurstDuration", e.g. after a power outage;
+ *  - REPLAY: at the times of the "ReplayFilename" file, whose lines are
+ *    "<time in seconds> <IMSI>", '#' starting a comment.
+ *
+ * Each UE then registers, sets up its PDU session, stays in CM-CONNECTED
+ * for "ConnectedTime", and makes "IdleCycles" cycles of CM-IDLE for
+ * "IdleTime" followed by a Service Request, before releasing its PDU
+ * session if "ReleaseSession" is set. The RAN side takes "RrcDelay" to
+ * set up the RRC connection before a Registration or a Service Request
+ * and to answer the Registration Accept. The procedures are timed by the
+ * NgcControlPlaneProfiler set with SetProfiler().
+ *
+ * When the AMF is overloaded, a UE whose Registration Request is rejected
+ * backs off for the T3346 given by the AMF, and a UE which gets no answer
+ * sends its request again when "T3510" expires; the procedure stays open
+ * meanwhile, and the back-off counts as RAN time in its latency.
+ *
+ * The UEs need an EPS bearer in the AMF, e.g. added with
+ * PointToPointNgcHelper::ActivateRemoteEpsBearer(), so that their PDU
+ * session is set up.
+ */
+class NgcControlPlaneLoadGenerator : public Object
+{
+  friend class MemberNgcEnbN2SapUser<NgcControlPlaneLoadGenerator>;
+
+public:
+
+  /** arrival processes of the UEs */
+  enum ArrivalProcess
+  {
+    POISSON,
+    BURST,
+    REPLAY
+  };
+
+  NgcControlPlaneLoadGenerator ();
+  virtual ~NgcControlPlaneLoadGenerator ();
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * Let the generator act as the RRC of an eNB
+   *
+   * \param enbApp the NGC application of the eNB
+   */
+  void AddEnb (Ptr<NgcEnbApplication> enbApp);
+
+  /**
+   * Add a UE, which camps on the eNBs in turn
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void AddUe (uint64_t imsi);
+
+  /**
+   * \param profiler the profiler timing the procedures of the UEs
+   */
+  void SetProfiler (Ptr<NgcControlPlaneProfiler> profiler);
+
+  /**
+   * Schedule the arrivals of the UEs
+   *
+   * \param start the time of the first arrival, from which the times
+   *              of the replay file count
+   */
+  void Start (Time start);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * \return the number of Registration Requests rejected by the AMFs
+   */
+  uint64_t GetNRejected () const;
+
+  /**
+   * \return the number of Registration Requests sent again on the
+   * expiry of T3510
+   */
+  uint64_t GetNRetransmissions () const;
+
+private:
+
+  // NGC eNB N2 SAP user methods
+  void DoDataRadioBearerSetupRequest (NgcEnbN2SapUser::DataRadioBearerSetupRequestParameters params);
+  void DoPathSwitchRequestAcknowledge (NgcEnbN2SapUser::PathSwitchRequestAcknowledgeParameters params);
+  void DoIdentityRequest (NgcEnbN2SapUser::IdentityRequestParameters params);
+  void DoRegistrationAccept (NgcEnbN2SapUser::RegistrationAcceptParameters params);
+  void DoRegistrationReject (NgcEnbN2SapUser::RegistrationRejectParameters params);
+
+  /**
+   * Set up the RRC connection of a UE, which then sends a Registration
+   * Request, or a Service Request if it is registered
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void Connect (uint64_t imsi);
+
+  /**
+   * Send the Registration Request of a UE once its RRC connection is up
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void SendRegistrationRequest (uint64_t imsi);
+
+  /**
+   * Send the Registration Request of a UE again, the AMF having not
+   * answered before T3510 expired
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void RetransmitRegistrationRequest (uint64_t imsi);
+
+  /**
+   * Send the answer of a UE to an Identity Request
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void SendIdentityResponse (uint64_t imsi);
+
+  /**
+   * Send the Registration Complete of a UE
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void SendRegistrationComplete (uint64_t imsi);
+
+  /**
+   * Move a UE to CM-IDLE, or release its PDU session after its last
+   * cycle
+   *
+   * \param imsi the IMSI of the UE
+   */
+  void Disconnect (uint64_t imsi);
+
+  /**
+   * \param rnti the RNTI of a UE
+   * \return the IMSI of the UE
+   */
+  uint64_t GetImsi (uint16_t rnti) const;
+
+  /**
+   * a UE driven by the generator
+   */
+  struct UeInfo
+  {
+    uint32_t enbIndex;
+    uint16_t rnti;
+    bool registered;
+    bool sessionSetup;
+    bool waitingAccept;
+    EventId t3510Event;
+    uint32_t idleCyclesLeft;
+    std::list<uint8_t> bearerIds;
+  };
+
+  std::map<uint64_t, UeInfo> m_ueInfoMap;
+
+  /**
+   * IMSIs in the order of AddUe ()
+   */
+  std::vector<uint64_t> m_imsis;
+
+  /**
+   * IMSI by RNTI, the RNTIs being unique across the eNBs
+   */
+  std::map<uint16_t, uint64_t> m_imsiByRnti;
+
+  std::vector<Ptr<NgcEnbApplication> > m_enbApps;
+
+  NgcEnbN2SapUser* m_n2SapUser;
+
+  Ptr<NgcControlPlaneProfiler> m_profiler;
+
+  ArrivalProcess m_arrivalProcess;
+  double m_arrivalRate;
+  Time m_burstDuration;
+  std::string m_replayFilename;
+  Time m_rrcDelay;
+  Ptr<RandomVariableStream> m_connectedTime;
+  Ptr<RandomVariableStream> m_idleTime;
+  uint32_t m_idleCycles;
+  bool m_releaseSession;
+  Time m_t3510;
+
+  uint64_t m_nRejected;
+  uint64_t m_nRetransmissions;
+
+  Ptr<ExponentialRandomVariable> m_interArrivalTime;
+  Ptr<UniformRandomVariable> m_burstArrivalTime;
+};
+
+} // namespace ns3
+
+#endif /* NGC_CONTROL_PLANE_LOAD_GENERATOR_H */
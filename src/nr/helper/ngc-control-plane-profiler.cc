@@ -0,0 +1,381 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ngc-control-plane-profiler.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/ngc-amf-application.h>
+#include <ns3/ngc-smf-application.h>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NgcControlPlaneProfiler");
+
+NS_OBJECT_ENSURE_REGISTERED (NgcControlPlaneProfiler);
+
+NgcControlPlaneProfiler::NgcControlPlaneProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t p = 0; p < N_PROCEDURES; ++p)
+    {
+      for (uint32_t c = 0; c < N_COMPONENTS; ++c)
+        {
+          m_latency[p][c].count = 0;
+        }
+    }
+}
+
+NgcControlPlaneProfiler::~NgcControlPlaneProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+NgcControlPlaneProfiler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NgcControlPlaneProfiler")
+    .SetParent<Object> ()
+    .SetGroupName ("Nr")
+    .AddConstructor<NgcControlPlaneProfiler> ()
+    .AddAttribute ("BinWidth",
+                   "The width of the bins of the latency histograms",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&NgcControlPlaneProfiler::m_binWidth),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("OutputFilename",
+                   "Name of the file where the results will be saved.",
+                   StringValue ("NgcControlPlaneStats.txt"),
+                   MakeStringAccessor (&NgcControlPlaneProfiler::m_outputFilename),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+void
+NgcControlPlaneProfiler::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_openProcedures.clear ();
+  m_backlogByNf.clear ();
+  Object::DoDispose ();
+}
+
+void
+NgcControlPlaneProfiler::AddAmf (Ptr<NgcAmfApplication> amf)
+{
+  NS_LOG_FUNCTION (this << amf);
+  std::ostringstream nf;
+  nf << "AMF" << amf->GetAmfId ();
+  BacklogStats stats;
+  stats.component = AMF;
+  stats.backlog = 0;
+  stats.maxBacklog = 0;
+  stats.nMessages = 0;
+  stats.integral = 0;
+  m_backlogByNf[nf.str ()] = stats;
+  amf->TraceConnect ("RxMessage", nf.str (),
+                     MakeCallback (&NgcControlPlaneProfiler::RxMessage, this));
+  amf->TraceConnect ("ProcessedMessage", nf.str (),
+                     MakeCallback (&NgcControlPlaneProfiler::ProcessedMessage, this));
+}
+
+void
+NgcControlPlaneProfiler::AddSmf (Ptr<NgcSmfApplication> smf)
+{
+  NS_LOG_FUNCTION (this << smf);
+  BacklogStats stats;
+  stats.component = SMF;
+  stats.backlog = 0;
+  stats.maxBacklog = 0;
+  stats.nMessages = 0;
+  stats.integral = 0;
+  m_backlogByNf["SMF"] = stats;
+  smf->TraceConnect ("RxMessage", "SMF",
+                     MakeCallback (&NgcControlPlaneProfiler::RxMessage, this));
+  smf->TraceConnect ("ProcessedMessage", "SMF",
+                     MakeCallback (&NgcControlPlaneProfiler::ProcessedMessage, this));
+}
+
+void
+NgcControlPlaneProfiler::StartProcedure (uint64_t imsi, Procedure procedure)
+{
+  NS_LOG_FUNCTION (this << imsi << procedure);
+  OpenProcedure &open = m_openProcedures[imsi];
+  open.procedure = procedure;
+  open.start = Simulator::Now ();
+  for (uint32_t c = 0; c < N_COMPONENTS; ++c)
+    {
+      open.delay[c] = Seconds (0);
+    }
+}
+
+void
+NgcControlPlaneProfiler::EndProcedure (uint64_t imsi, Procedure procedure)
+{
+  NS_LOG_FUNCTION (this << imsi << procedure);
+  std::map<uint64_t, OpenProcedure>::iterator it = m_openProcedures.find (imsi);
+  if (it == m_openProcedures.end () || it->second.procedure != procedure)
+    {
+      return;
+    }
+  Time total = Simulator::Now () - it->second.start;
+  Time n2ap = total - it->second.delay[RAN] - it->second.delay[AMF] - it->second.delay[SMF];
+  it->second.delay[TOTAL] = total;
+  it->second.delay[N2AP] = Max (n2ap, Seconds (0));
+  for (uint32_t c = 0; c < N_COMPONENTS; ++c)
+    {
+      Record (m_latency[procedure][c], it->second.delay[c]);
+    }
+  NS_LOG_INFO ("IMSI " << imsi << " " << GetProcedureName (procedure) << " in " << total.GetSeconds () << " s");
+  m_openProcedures.erase (it);
+}
+
+void
+NgcControlPlaneProfiler::AddDelay (uint64_t imsi, Component component, Time delay)
+{
+  NS_LOG_FUNCTION (this << imsi << component << delay);
+  NS_ASSERT (component != TOTAL && component != N2AP);
+  std::map<uint64_t, OpenProcedure>::iterator it = m_openProcedures.find (imsi);
+  if (it != m_openProcedures.end ())
+    {
+      it->second.delay[component] += delay;
+    }
+}
+
+void
+NgcControlPlaneProfiler::RxMessage (std::string nf, uint64_t imsi, std::string message)
+{
+  NS_LOG_FUNCTION (this << nf << imsi << message);
+  std::map<std::string, BacklogStats>::iterator it = m_backlogByNf.find (nf);
+  NS_ASSERT (it != m_backlogByNf.end ());
+  UpdateBacklog (it->second, true);
+}
+
+void
+NgcControlPlaneProfiler::ProcessedMessage (std::string nf, uint64_t imsi, std::string message, Time delay)
+{
+  NS_LOG_FUNCTION (this << nf << imsi << message << delay);
+  std::map<std::string, BacklogStats>::iterator it = m_backlogByNf.find (nf);
+  NS_ASSERT (it != m_backlogByNf.end ());
+  UpdateBacklog (it->second, false);
+  AddDelay (imsi, it->second.component, delay);
+  if (it->second.component == AMF && message == "DeleteBearerRequest")
+    {
+      // the session is released in the SMF and in the UPF
+      EndProcedure (imsi, PDU_SESSION_RELEASE);
+    }
+}
+
+void
+NgcControlPlaneProfiler::UpdateBacklog (BacklogStats &stats, bool arrival)
+{
+  Time now = Simulator::Now ();
+  if (now > stats.lastUpdate)
+    {
+      // only a backlog which lasts for some time counts, not the one of
+      // the messages processed as soon as they arrive
+      stats.integral += stats.backlog * (now - stats.lastUpdate).GetSeconds ();
+      stats.maxBacklog = std::max (stats.maxBacklog, stats.backlog);
+      stats.lastUpdate = now;
+    }
+  if (arrival)
+    {
+      ++stats.backlog;
+      ++stats.nMessages;
+    }
+  else
+    {
+      NS_ASSERT (stats.backlog > 0);
+      --stats.backlog;
+    }
+}
+
+void
+NgcControlPlaneProfiler::Record (LatencyStats &stats, Time latency)
+{
+  uint32_t bin = latency.GetTimeStep () / m_binWidth.GetTimeStep ();
+  if (bin >= stats.bins.size ())
+    {
+      stats.bins.resize (bin + 1, 0);
+    }
+  ++stats.bins[bin];
+  if (stats.count == 0 || latency > stats.max)
+    {
+      stats.max = latency;
+    }
+  ++stats.count;
+  stats.sum += latency;
+}
+
+uint32_t
+NgcControlPlaneProfiler::GetNProcedures (Procedure procedure) const
+{
+  return m_latency[procedure][TOTAL].count;
+}
+
+Time
+NgcControlPlaneProfiler::GetMeanLatency (Procedure procedure, Component component) const
+{
+  const LatencyStats &stats = m_latency[procedure][component];
+  if (stats.count == 0)
+    {
+      return Seconds (0);
+    }
+  return stats.sum / static_cast<int64_t> (stats.count);
+}
+
+Time
+NgcControlPlaneProfiler::GetLatencyQuantile (Procedure procedure, Component component, double quantile) const
+{
+  NS_ASSERT (quantile >= 0 && quantile <= 1);
+  const LatencyStats &stats = m_latency[procedure][component];
+  uint32_t rank = std::ceil (quantile * stats.count);
+  uint32_t seen = 0;
+  for (uint32_t bin = 0; bin < stats.bins.size (); ++bin)
+    {
+      seen += stats.bins[bin];
+      if (seen >= rank && seen > 0)
+        {
+          return Min (m_binWidth * static_cast<int64_t> (bin + 1), stats.max);
+        }
+    }
+  return Seconds (0);
+}
+
+uint32_t
+NgcControlPlaneProfiler::GetMaxBacklog (std::string nf) const
+{
+  std::map<std::string, BacklogStats>::const_iterator it = m_backlogByNf.find (nf);
+  NS_ASSERT_MSG (it != m_backlogByNf.end (), "unknown network function " << nf);
+  if (Simulator::Now () > it->second.lastUpdate)
+    {
+      return std::max (it->second.maxBacklog, it->second.backlog);
+    }
+  return it->second.maxBacklog;
+}
+
+void
+NgcControlPlaneProfiler::WriteResults ()
+{
+  NS_LOG_FUNCTION (this << m_outputFilename);
+  std::ofstream outFile (m_outputFilename.c_str ());
+  if (!outFile.is_open ())
+    {
+      NS_LOG_ERROR ("Can't open file " << m_outputFilename.c_str ());
+      return;
+    }
+
+  outFile << "% procedure\tcomponent\tcount\tmean(s)\tp50(s)\tp95(s)\tp99(s)\tmax(s)" << std::endl;
+  for (uint32_t p = 0; p < N_PROCEDURES; ++p)
+    {
+      for (uint32_t c = 0; c < N_COMPONENTS; ++c)
+        {
+          Procedure procedure = static_cast<Procedure> (p);
+          Component component = static_cast<Component> (c);
+          const LatencyStats &stats = m_latency[p][c];
+          if (stats.count == 0)
+            {
+              continue;
+            }
+          outFile << GetProcedureName (procedure) << "\t"
+                  << GetComponentName (component) << "\t"
+                  << stats.count << "\t"
+                  << GetMeanLatency (procedure, component).GetSeconds () << "\t"
+                  << GetLatencyQuantile (procedure, component, 0.5).GetSeconds () << "\t"
+                  << GetLatencyQuantile (procedure, component, 0.95).GetSeconds () << "\t"
+                  << GetLatencyQuantile (procedure, component, 0.99).GetSeconds () << "\t"
+                  << stats.max.GetSeconds () << std::endl;
+        }
+    }
+
+  outFile << "% nf\tmessages\tmaxBacklog\tmeanBacklog" << std::endl;
+  for (std::map<std::string, BacklogStats>::const_iterator it = m_backlogByNf.begin ();
+       it != m_backlogByNf.end ();
+       ++it)
+    {
+      double duration = it->second.lastUpdate.GetSeconds ();
+      outFile << it->first << "\t"
+              << it->second.nMessages << "\t"
+              << GetMaxBacklog (it->first) << "\t"
+              << (duration > 0 ? it->second.integral / duration : 0) << std::endl;
+    }
+
+  outFile << "% procedure\tcomponent\tbinStart(s)\tcount" << std::endl;
+  for (uint32_t p = 0; p < N_PROCEDURES; ++p)
+    {
+      for (uint32_t c = 0; c < N_COMPONENTS; ++c)
+        {
+          const LatencyStats &stats = m_latency[p][c];
+          for (uint32_t bin = 0; bin < stats.bins.size (); ++bin)
+            {
+              if (stats.bins[bin] > 0)
+                {
+                  outFile << GetProcedureName (static_cast<Procedure> (p)) << "\t"
+                          << GetComponentName (static_cast<Component> (c)) << "\t"
+                          << (m_binWidth * static_cast<int64_t> (bin)).GetSeconds () << "\t"
+                          << stats.bins[bin] << std::endl;
+                }
+            }
+        }
+    }
+  outFile.close ();
+}
+
+std::string
+NgcControlPlaneProfiler::GetProcedureName (Procedure procedure)
+{
+  switch (procedure)
+    {
+    case REGISTRATION:
+      return "REGISTRATION";
+    case SERVICE_REQUEST:
+      return "SERVICE_REQUEST";
+    case PDU_SESSION_SETUP:
+      return "PDU_SESSION_SETUP";
+    case PDU_SESSION_RELEASE:
+      return "PDU_SESSION_RELEASE";
+    default:
+      NS_FATAL_ERROR ("unknown procedure " << procedure);
+      return "";
+    }
+}
+
+std::string
+NgcControlPlaneProfiler::GetComponentName (Component component)
+{
+  switch (component)
+    {
+    case TOTAL:
+      return "TOTAL";
+    case RAN:
+      return "RAN";
+    case N2AP:
+      return "N2AP";
+    case AMF:
+      return "AMF";
+    case SMF:
+      return "SMF";
+    default:
+      NS_FATAL_ERROR ("unknown component " << component);
+      return "";
+    }
+}
+
+} // namespace ns3
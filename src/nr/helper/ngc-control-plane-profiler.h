@@ -0,0 +1,264 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NGC_CONTROL_PLANE_PROFILER_H
+#define NGC_CONTROL_PLANE_PROFILER_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class NgcAmfApplication;
+class NgcSmfApplication;
+
+/**
+ * \ingroup nr
+ *
+ * Latency profiler of the control plane procedures of the UEs.
+ *
+ * A procedure of a UE starts and ends with StartProcedure() and
+ * EndProcedure(), called by whoever drives the UE, e.g. the
+ * NgcControlPlaneLoadGenerator; the release of a PDU session ends when
+ * the AMF gets the Delete Bearer Request of the SMF. The latency of
+ * each procedure is split into the time spent in:
+ *  - RAN: the RRC and the radio side of the UE, reported with AddDelay();
+ *  - AMF and SMF: the network functions, reported by the
+ *    "ProcessedMessage" traces of the AMFs and of the SMF, where the
+ *    SMF includes the N4 exchange with the UPF;
+ *  - N2AP: the rest, i.e. the N2-AP transport between the eNB and the
+ *    AMF.
+ * A histogram with bins of "BinWidth" is kept for the total latency and
+ * for each of these parts of each procedure.
+ *
+ * The profiler also tracks the backlog of each network function, i.e.
+ * the number of messages which have arrived at it and which it has not
+ * processed yet.
+ */
+class NgcControlPlaneProfiler : public Object
+{
+public:
+
+  /** control plane procedures of a UE */
+  enum Procedure
+  {
+    REGISTRATION,        ///< initial registration
+    SERVICE_REQUEST,     ///< CM-IDLE to CM-CONNECTED transition
+    PDU_SESSION_SETUP,   ///< establishment of the PDU session
+    PDU_SESSION_RELEASE, ///< release of the PDU session
+    N_PROCEDURES
+  };
+
+  /** parts of the latency of a procedure */
+  enum Component
+  {
+    TOTAL,
+    RAN,
+    N2AP,
+    AMF,
+    SMF,
+    N_COMPONENTS
+  };
+
+  NgcControlPlaneProfiler ();
+  virtual ~NgcControlPlaneProfiler ();
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * Connect the profiler to the traces of an AMF
+   *
+   * \param amf the application of the AMF
+   */
+  void AddAmf (Ptr<NgcAmfApplication> amf);
+
+  /**
+   * Connect the profiler to the traces of the SMF
+   *
+   * \param smf the application of the SMF
+   */
+  void AddSmf (Ptr<NgcSmfApplication> smf);
+
+  /**
+   * Start a procedure of a UE, which replaces any procedure of the UE
+   * still in progress
+   *
+   * \param imsi the IMSI of the UE
+   * \param procedure the procedure
+   */
+  void StartProcedure (uint64_t imsi, Procedure procedure);
+
+  /**
+   * End a procedure of a UE and record its latency, if the procedure is
+   * the one in progress for the UE
+   *
+   * \param imsi the IMSI of the UE
+   * \param procedure the procedure
+   */
+  void EndProcedure (uint64_t imsi, Procedure procedure);
+
+  /**
+   * Add to the procedure in progress of a UE some time spent in a part
+   * of the network
+   *
+   * \param imsi the IMSI of the UE
+   * \param component the part of the network
+   * \param delay the time
+   */
+  void AddDelay (uint64_t imsi, Component component, Time delay);
+
+  /**
+   * \param procedure a procedure
+   * \return the number of completed procedures
+   */
+  uint32_t GetNProcedures (Procedure procedure) const;
+
+  /**
+   * \param procedure a procedure
+   * \param component a part of the latency
+   * \return the mean of the part of the latency of the completed procedures
+   */
+  Time GetMeanLatency (Procedure procedure, Component component) const;
+
+  /**
+   * \param procedure a procedure
+   * \param component a part of the latency
+   * \param quantile the quantile, between 0 and 1
+   * \return the quantile of the part of the latency of the completed
+   * procedures, rounded up to the end of its histogram bin
+   */
+  Time GetLatencyQuantile (Procedure procedure, Component component, double quantile) const;
+
+  /**
+   * \param nf the name of a network function, e.g. "AMF1" or "SMF"
+   * \return the largest backlog of the network function
+   */
+  uint32_t GetMaxBacklog (std::string nf) const;
+
+  /**
+   * Write the statistics of the procedures and of the network functions
+   * to the file set by the "OutputFilename" attribute
+   */
+  void WriteResults ();
+
+  /**
+   * \param procedure a procedure
+   * \return the name of the procedure
+   */
+  static std::string GetProcedureName (Procedure procedure);
+
+  /**
+   * \param component a part of the latency
+   * \return the name of the part
+   */
+  static std::string GetComponentName (Component component);
+
+private:
+
+  /**
+   * Sink of the "RxMessage" traces of the network functions
+   *
+   * \param nf the name of the network function
+   * \param imsi the IMSI of the UE
+   * \param message the name of the message
+   */
+  void RxMessage (std::string nf, uint64_t imsi, std::string message);
+
+  /**
+   * Sink of the "ProcessedMessage" traces of the network functions
+   *
+   * \param nf the name of the network function
+   * \param imsi the IMSI of the UE
+   * \param message the name of the message
+   * \param delay the time the message spent in the network function
+   */
+  void ProcessedMessage (std::string nf, uint64_t imsi, std::string message, Time delay);
+
+  /**
+   * a procedure in progress
+   */
+  struct OpenProcedure
+  {
+    Procedure procedure;
+    Time start;
+    Time delay[N_COMPONENTS];
+  };
+
+  /**
+   * histogram of a part of the latency of a procedure
+   */
+  struct LatencyStats
+  {
+    std::vector<uint32_t> bins;
+    uint32_t count;
+    Time sum;
+    Time max;
+  };
+
+  /**
+   * backlog of a network function
+   */
+  struct BacklogStats
+  {
+    Component component;
+    uint32_t backlog;
+    uint32_t maxBacklog;
+    uint64_t nMessages;
+    double integral;  ///< integral of the backlog over time, in seconds
+    Time lastUpdate;
+  };
+
+  /**
+   * Add a sample to a histogram
+   *
+   * \param stats the histogram
+   * \param latency the sample
+   */
+  void Record (LatencyStats &stats, Time latency);
+
+  /**
+   * Change the backlog of a network function
+   *
+   * \param stats the backlog of the network function
+   * \param arrival whether a message arrives or leaves
+   */
+  void UpdateBacklog (BacklogStats &stats, bool arrival);
+
+  std::map<uint64_t, OpenProcedure> m_openProcedures;
+
+  LatencyStats m_latency[N_PROCEDURES][N_COMPONENTS];
+
+  std::map<std::string, BacklogStats> m_backlogByNf;
+
+  /**
+   * width of the bins of the histograms
+   */
+  Time m_binWidth;
+
+  /**
+   * name of the file where the results are written
+   */
+  std::string m_outputFilename;
+};
+
+} // namespace ns3
+
+#endif /* NGC_CONTROL_PLANE_PROFILER_H */
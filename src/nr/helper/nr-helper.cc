@@ -200,6 +200,18 @@ TypeId NrHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&NrHelper::m_usePdschForCqiGeneration),
                    MakeBooleanChecker ())
+    .AddAttribute ("BasicCellId",
+                   "The cell id of the next eNB is this value plus one. "
+                   "The ranks of a distributed simulation use it to number their cells apart.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NrHelper::m_cellIdCounter),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("BasicImsi",
+                   "The IMSI of the next UE is this value plus one. "
+                   "The ranks of a distributed simulation use it to number their UEs apart.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&NrHelper::m_imsiCounter),
+                   MakeUintegerChecker<uint64_t> ())
   ;
   return tid;
 }
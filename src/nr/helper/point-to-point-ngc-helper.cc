@@ -35,7 +35,10 @@
 #include <ns3/packet-socket-helper.h>
 #include <ns3/packet-socket-address.h>
 #include <ns3/ngc-enb-application.h>
-#include <ns3/ngc-smf-upf-application.h>
+#include <ns3/ngc-smf-application.h>
+#include <ns3/ngc-upf-application.h>
+#include <ns3/ipv4-static-routing-helper.h>
+#include <ns3/mobility-model.h>
 
 #include <ns3/nr-enb-rrc.h>
 #include <ns3/ngc-x2.h>
@@ -44,6 +47,9 @@
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/ngc-amf-application.h>
 #include <ns3/ngc-ue-nas.h>
+#include <ns3/simple-net-device.h>
+#include <ns3/abort.h>
+#include <limits>
 
 namespace ns3 {
 
@@ -53,76 +59,126 @@ NS_OBJECT_ENSURE_REGISTERED (PointToPointNgcHelper);
 
 
 PointToPointNgcHelper::PointToPointNgcHelper () 
-  : m_gtpuUdpPort (2152),  // fixed by the standard
+  : m_nEnbs (0),
+    m_gtpuUdpPort (2152),  // fixed by the standard
     m_n2apUdpPort (36412)
 {
   NS_LOG_FUNCTION (this);
 
-  // since we use point-to-point links for all N2-U and N2-AP links, 
+  // since we use point-to-point links for all N2-U, N2-AP and N6 links,
   // we use a /30 subnet which can hold exactly two addresses 
   // (remember that net broadcast and null address are not valid)
   m_n2uIpv4AddressHelper.SetBase ("10.0.0.0", "255.255.255.252");
   m_n2apIpv4AddressHelper.SetBase ("11.0.0.0", "255.255.255.252");
   m_x2Ipv4AddressHelper.SetBase ("12.0.0.0", "255.255.255.252");
+  m_n6Ipv4AddressHelper.SetBase ("13.0.0.0", "255.255.255.252");
 
   // we use a /8 net for all UEs
   m_ueAddressHelper.SetBase ("7.0.0.0", "255.0.0.0");
-  
-  // create SmfUpfNode
-  m_smfUpf = CreateObject<Node> ();
+
+  // the first UPF is created right away, the others when the helper is
+  // initialized, once the NumUpfs attribute is known
+  m_smfApp = CreateObject<NgcSmfApplication> ();
+  CreateUpf ();
+
+  // the first AMF, which also runs the SMF, is created right away as
+  // well, the others when the helper is initialized
+  CreateAmf ();
+}
+
+void
+PointToPointNgcHelper::CreateAmf ()
+{
+  uint16_t amfId = m_amfNodes.size () + 1;
+  NS_LOG_FUNCTION (this << amfId);
+
+  Ptr<Node> amf = CreateObject<Node> ();
   InternetStackHelper internet;
-  internet.Install (m_smfUpf);
+  internet.Install (amf);
+  if (m_amfNodes.empty ())
+    {
+      amf->AddApplication (m_smfApp);
+    }
 
-  // create AmfNode
-  m_amfNode = CreateObject<Node> ();
-  internet.Install (m_amfNode);
-  
-  // create N2-U socket for SmfUpfNode
-  Ptr<Socket> smfUpfN2uSocket = Socket::CreateSocket (m_smfUpf, TypeId::LookupByName ("ns3::UdpSocketFactory"));
-  int retval = smfUpfN2uSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_gtpuUdpPort));
+  // create N2-AP socket for the AMF
+  Ptr<Socket> amfN2apSocket = Socket::CreateSocket (amf, TypeId::LookupByName ("ns3::UdpSocketFactory"));
+  int retval = amfN2apSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_n2apUdpPort)); // it listens on any IP, port m_n2apUdpPort
   NS_ASSERT (retval == 0);
 
-  // create N2-AP socket for AmfNode
-  Ptr<Socket> amfN2apSocket = Socket::CreateSocket (m_amfNode, TypeId::LookupByName ("ns3::UdpSocketFactory"));
-  retval = amfN2apSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_n2apUdpPort)); // it listens on any IP, port m_n2apUdpPort
+  // create N2apAmf object and aggregate it with the AMF node
+  Ptr<NgcN2apAmf> n2apAmf = CreateObject<NgcN2apAmf> (amfN2apSocket, amfId);
+  amf->AggregateObject(n2apAmf);
+
+  // create NgcAmfApplication and connect with SMF via N11 interface
+  Ptr<NgcAmfApplication> amfApp = CreateObject<NgcAmfApplication> ();
+  amfApp->SetAttribute ("AmfId", UintegerValue (amfId));
+  amf->AddApplication (amfApp);
+  amfApp->SetN11SapSmf (m_smfApp->GetN11SapSmf ());
+  if (m_amfNodes.empty ())
+    {
+      m_smfApp->SetN11SapAmf (amfApp->GetN11SapAmf ());
+    }
+  m_smfApp->AddAmf (amfId, amfApp->GetN11SapAmf ());
+  // connect amfApp to the n2apAmf
+  amfApp->SetN2apSapAmfProvider(n2apAmf->GetNgcN2apSapAmfProvider());
+  n2apAmf->SetNgcN2apSapAmfUser(amfApp->GetN2apSapAmf());
+
+  m_amfNodes.push_back (amf);
+  m_amfApps.push_back (amfApp);
+}
+
+void
+PointToPointNgcHelper::CreateUpf ()
+{
+  uint32_t upfId = m_upfNodes.size ();
+  NS_LOG_FUNCTION (this << upfId);
+
+  Ptr<Node> upf = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (upf);
+
+  // create N3 socket for the UPF
+  Ptr<Socket> upfN3Socket = Socket::CreateSocket (upf, TypeId::LookupByName ("ns3::UdpSocketFactory"));
+  int retval = upfN3Socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_gtpuUdpPort));
   NS_ASSERT (retval == 0);
 
   // create TUN device implementing tunneling of user data over GTP-U/UDP/IP 
-  m_tunDevice = CreateObject<VirtualNetDevice> ();
+  Ptr<VirtualNetDevice> tunDevice = CreateObject<VirtualNetDevice> ();
   // allow jumbo packets
-  m_tunDevice->SetAttribute ("Mtu", UintegerValue (30000));
+  tunDevice->SetAttribute ("Mtu", UintegerValue (30000));
 
   // yes we need this
-  m_tunDevice->SetAddress (Mac48Address::Allocate ()); 
+  tunDevice->SetAddress (Mac48Address::Allocate ()); 
 
-  m_smfUpf->AddDevice (m_tunDevice);
+  upf->AddDevice (tunDevice);
   NetDeviceContainer tunDeviceContainer;
-  tunDeviceContainer.Add (m_tunDevice);
+  tunDeviceContainer.Add (tunDevice);
   
   // the TUN device is on the same subnet as the UEs, so when a packet
   // addressed to an UE arrives at the intenet to the WAN interface of
   // the UPF it will be forwarded to the TUN device. 
   Ipv4InterfaceContainer tunDeviceIpv4IfContainer = m_ueAddressHelper.Assign (tunDeviceContainer);  
 
-  // create NgcSmfUpfApplication
-  m_smfUpfApp = CreateObject<NgcSmfUpfApplication> (m_tunDevice, smfUpfN2uSocket);
-  m_smfUpf->AddApplication (m_smfUpfApp);
+  // the N3 address of the UPF does not depend on the N3 link: it sits
+  // on the loopback interface and every eNB has a host route to it, so
+  // that the TEIDs of a UE keep the same UPF address across handovers
+  Ipv4Address n3Address (Ipv4Address ("14.0.0.1").Get () + upfId);
+  upf->GetObject<Ipv4> ()->AddAddress (0, Ipv4InterfaceAddress (n3Address, Ipv4Mask::GetOnes ()));
+
+  // create NgcUpfApplication and connect it with the SMF via N4 interface
+  Ptr<NgcUpfApplication> upfApp = CreateObject<NgcUpfApplication> (tunDevice, upfN3Socket, upfId);
+  upf->AddApplication (upfApp);
+  uint32_t smfUpfId = m_smfApp->AddUpf (upfApp->GetN4SapUpf ());
+  NS_ASSERT (smfUpfId == upfId);
+  upfApp->SetN4SapSmf (m_smfApp->GetN4SapSmf ());
   
-  // connect SmfUpfApplication and virtual net device for tunneling
-  m_tunDevice->SetSendCallback (MakeCallback (&NgcSmfUpfApplication::RecvFromTunDevice, m_smfUpfApp));
-
-  // create N2apAmf object and aggregate it with the m_amfNode
-  Ptr<NgcN2apAmf> n2apAmf = CreateObject<NgcN2apAmf> (amfN2apSocket, 1); // for now, only one amf!
-  m_amfNode->AggregateObject(n2apAmf);
+  // connect UpfApplication and virtual net device for tunneling
+  tunDevice->SetSendCallback (MakeCallback (&NgcUpfApplication::RecvFromTunDevice, upfApp));
 
-  // create NgcAmfApplication and connect with SMF via N11 interface
-  m_amfApp = CreateObject<NgcAmfApplication> ();
-  m_amfNode->AddApplication (m_amfApp);
-  m_amfApp->SetN11SapSmf (m_smfUpfApp->GetN11SapSmf ());
-  m_smfUpfApp->SetN11SapAmf (m_amfApp->GetN11SapAmf ());
-  // connect m_amfApp to the n2apAmf
-  m_amfApp->SetN2apSapAmfProvider(n2apAmf->GetNgcN2apSapAmfProvider());
-  n2apAmf->SetNgcN2apSapAmfUser(m_amfApp->GetN2apSapAmf());
+  m_upfNodes.push_back (upf);
+  m_upfApps.push_back (upfApp);
+  m_tunDevices.push_back (tunDevice);
+  m_upfN3Addresses.push_back (n3Address);
 }
 
 PointToPointNgcHelper::~PointToPointNgcHelper ()
@@ -137,6 +193,31 @@ PointToPointNgcHelper::GetTypeId (void)
     .SetParent<NgcHelper> ()
     .SetGroupName("Nr")
     .AddConstructor<PointToPointNgcHelper> ()
+    .AddAttribute ("NumUpfs",
+                   "The number of UPFs of the pool",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNgcHelper::m_numUpfs),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("NumAmfs",
+                   "The number of AMFs of the AMF set",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNgcHelper::m_numAmfs),
+                   MakeUintegerChecker<uint32_t> (1, 65535))
+    .AddAttribute ("N6LinkDataRate",
+                   "The data rate of the N6 links between the UPFs and the N6 gateway",
+                   DataRateValue (DataRate ("100Gb/s")),
+                   MakeDataRateAccessor (&PointToPointNgcHelper::m_n6LinkDataRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("N6LinkDelay",
+                   "The delay of the N6 links between the UPFs and the N6 gateway",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&PointToPointNgcHelper::m_n6LinkDelay),
+                   MakeTimeChecker ())
+    .AddAttribute ("N6LinkMtu",
+                   "The MTU of the N6 links between the UPFs and the N6 gateway",
+                   UintegerValue (1500),
+                   MakeUintegerAccessor (&PointToPointNgcHelper::m_n6LinkMtu),
+                   MakeUintegerChecker<uint16_t> ())
     .AddAttribute ("N2uLinkDataRate", 
                    "The data rate to be used for the next N2-U link to be created",
                    DataRateValue (DataRate ("10Gb/s")),
@@ -190,10 +271,84 @@ void
 PointToPointNgcHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_tunDevice->SetSendCallback (MakeNullCallback<bool, Ptr<Packet>, const Address&, const Address&, uint16_t> ());
-  m_tunDevice = 0;
-  m_smfUpfApp = 0;  
-  m_smfUpf->Dispose ();
+  for (uint32_t i = 0; i < m_upfNodes.size (); ++i)
+    {
+      m_tunDevices[i]->SetSendCallback (MakeNullCallback<bool, Ptr<Packet>, const Address&, const Address&, uint16_t> ());
+      m_upfNodes[i]->Dispose ();
+    }
+  m_tunDevices.clear ();
+  m_upfApps.clear ();
+  m_upfNodes.clear ();
+  m_amfApps.clear ();
+  m_amfNodes.clear ();
+  m_smfApp = 0;
+  m_n6Gateway = 0;
+}
+
+void
+PointToPointNgcHelper::DoInitialize ()
+{
+  NS_LOG_FUNCTION (this << m_numUpfs);
+  while (m_upfNodes.size () < m_numUpfs)
+    {
+      CreateUpf ();
+    }
+  while (m_amfNodes.size () < m_numAmfs)
+    {
+      CreateAmf ();
+    }
+
+  if (m_upfNodes.size () > 1)
+    {
+      // the N6 gateway stands for the internet side of the pool: it
+      // routes the packets of each UE to the UPF of its session
+      m_n6Gateway = CreateObject<Node> ();
+      InternetStackHelper internet;
+      internet.Install (m_n6Gateway);
+      Ipv4StaticRoutingHelper ipv4RoutingHelper;
+      PointToPointHelper p2ph;
+      p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_n6LinkDataRate));
+      p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_n6LinkMtu));
+      p2ph.SetChannelAttribute ("Delay", TimeValue (m_n6LinkDelay));
+      for (uint32_t i = 0; i < m_upfNodes.size (); ++i)
+        {
+          NetDeviceContainer n6Devices = p2ph.Install (m_upfNodes[i], m_n6Gateway);
+          m_n6Ipv4AddressHelper.NewNetwork ();
+          Ipv4InterfaceContainer n6IpIfaces = m_n6Ipv4AddressHelper.Assign (n6Devices);
+          N6Link link;
+          link.upfAddress = n6IpIfaces.GetAddress (0);
+          link.upfInterface = n6IpIfaces.Get (0).second;
+          link.gatewayAddress = n6IpIfaces.GetAddress (1);
+          link.gatewayInterface = n6IpIfaces.Get (1).second;
+          m_n6Links.push_back (link);
+
+          // the uplink packets leave the pool through the gateway
+          Ptr<Ipv4StaticRouting> upfStaticRouting = ipv4RoutingHelper.GetStaticRouting (m_upfNodes[i]->GetObject<Ipv4> ());
+          upfStaticRouting->SetDefaultRoute (link.gatewayAddress, link.upfInterface);
+        }
+      m_smfApp->TraceConnectWithoutContext ("SessionEstablished",
+                                            MakeCallback (&PointToPointNgcHelper::NotifySessionEstablished, this));
+    }
+  NgcHelper::DoInitialize ();
+}
+
+void
+PointToPointNgcHelper::NotifySessionEstablished (uint64_t imsi, Ipv4Address ueAddr, uint32_t upfId)
+{
+  NS_LOG_FUNCTION (this << imsi << ueAddr << upfId);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> gatewayStaticRouting = ipv4RoutingHelper.GetStaticRouting (m_n6Gateway->GetObject<Ipv4> ());
+  gatewayStaticRouting->AddHostRouteTo (ueAddr, m_n6Links[upfId].upfAddress, m_n6Links[upfId].gatewayInterface);
+  // the other UPFs send the packets of other UEs addressed to this UE
+  // to the gateway, rather than to their own TUN device
+  for (uint32_t i = 0; i < m_upfNodes.size (); ++i)
+    {
+      if (i != upfId)
+        {
+          Ptr<Ipv4StaticRouting> upfStaticRouting = ipv4RoutingHelper.GetStaticRouting (m_upfNodes[i]->GetObject<Ipv4> ());
+          upfStaticRouting->AddHostRouteTo (ueAddr, m_n6Links[i].gatewayAddress, m_n6Links[i].upfInterface);
+        }
+    }
 }
 
 
@@ -203,61 +358,29 @@ PointToPointNgcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> nrEnbNetDevice, uin
   NS_LOG_FUNCTION (this << enb << nrEnbNetDevice << cellId);
 
   NS_ASSERT (enb == nrEnbNetDevice->GetNode ());
+  Initialize ();
 
-  // add an IPv4 stack to the previously created eNB
-  InternetStackHelper internet;
-  internet.Install (enb);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after node creation: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+  Ipv4Address enbAddress;
+  Ipv4Address smfAddress;
+  std::vector<Ipv4Address> amf_enbAddresses;
+  std::vector<Ipv4Address> amfAddresses;
+  ConnectEnbToCore (enb, cellId, enbAddress, smfAddress, amf_enbAddresses, amfAddresses);
 
-  // create a point to point link between the new eNB and the SMF with
-  // the corresponding new NetDevices on each side  
-  NodeContainer enbSmfNodes;
-  enbSmfNodes.Add (m_smfUpf);
-  enbSmfNodes.Add (enb);
-  PointToPointHelper p2ph;
-  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_n2uLinkDataRate));
-  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_n2uLinkMtu));
-  p2ph.SetChannelAttribute ("Delay", TimeValue (m_n2uLinkDelay));  
-  NetDeviceContainer enbSmfDevices = p2ph.Install (enb, m_smfUpf);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
-  Ptr<NetDevice> enbDev = enbSmfDevices.Get (0);
-  Ptr<NetDevice> smfDev = enbSmfDevices.Get (1);
-  m_n2uIpv4AddressHelper.NewNetwork ();
-  Ipv4InterfaceContainer enbSmfIpIfaces = m_n2uIpv4AddressHelper.Assign (enbSmfDevices);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to N2 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
-  
-  Ipv4Address enbAddress = enbSmfIpIfaces.GetAddress (0);
-  Ipv4Address smfAddress = enbSmfIpIfaces.GetAddress (1);
-
-  // create N2-U socket for the ENB
+  // create N2-U socket for the ENB, which receives from every UPF on
+  // the address of its own N3 link to that UPF
   Ptr<Socket> enbN2uSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::UdpSocketFactory"));
-  int retval = enbN2uSocket->Bind (InetSocketAddress (enbAddress, m_gtpuUdpPort));
+  int retval = enbN2uSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_gtpuUdpPort));
   NS_ASSERT (retval == 0);
 
-
-  // create a point to point link between the new eNB and the AMF with
-  // the corresponding new NetDevices on each side
-  NodeContainer enbAmfNodes;
-  enbAmfNodes.Add (m_amfNode);
-  enbAmfNodes.Add (enb);
-  PointToPointHelper p2ph_amf;
-  p2ph_amf.SetDeviceAttribute ("DataRate", DataRateValue (m_n2apLinkDataRate));
-  p2ph_amf.SetDeviceAttribute ("Mtu", UintegerValue (m_n2apLinkMtu));
-  p2ph_amf.SetChannelAttribute ("Delay", TimeValue (m_n2apLinkDelay));  
-  NetDeviceContainer enbAmfDevices = p2ph_amf.Install (enb, m_amfNode);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
-
-  m_n2apIpv4AddressHelper.NewNetwork ();
-  Ipv4InterfaceContainer enbAmfIpIfaces = m_n2apIpv4AddressHelper.Assign (enbAmfDevices);
-  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to N2 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
-  
-  Ipv4Address amf_enbAddress = enbAmfIpIfaces.GetAddress (0);
-  Ipv4Address amfAddress = enbAmfIpIfaces.GetAddress (1);
-
-  // create N2-AP socket for the ENB
-  Ptr<Socket> enbN2apSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::UdpSocketFactory"));
-  retval = enbN2apSocket->Bind (InetSocketAddress (amf_enbAddress, m_n2apUdpPort));
-  NS_ASSERT (retval == 0);
+  // create an N2-AP socket for the ENB towards each AMF
+  std::vector<Ptr<Socket> > enbN2apSockets;
+  for (uint32_t i = 0; i < amf_enbAddresses.size (); ++i)
+    {
+      Ptr<Socket> enbN2apSocket = Socket::CreateSocket (enb, TypeId::LookupByName ("ns3::UdpSocketFactory"));
+      retval = enbN2apSocket->Bind (InetSocketAddress (amf_enbAddresses[i], m_n2apUdpPort));
+      NS_ASSERT (retval == 0);
+      enbN2apSockets.push_back (enbN2apSocket);
+    }
 
   // give PacketSocket powers to the eNB
   //PacketSocketHelper packetSocket;
@@ -292,17 +415,118 @@ PointToPointNgcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> nrEnbNetDevice, uin
 
   NS_LOG_INFO ("connect N2-AP interface");
 
-  uint16_t amfId = 1;
-  Ptr<NgcN2apEnb> n2apEnb = CreateObject<NgcN2apEnb> (enbN2apSocket, amf_enbAddress, amfAddress, cellId, amfId); // only one amf!
+  // the AMF id of the i-th AMF of the set is i + 1
+  Ptr<NgcN2apEnb> n2apEnb = CreateObject<NgcN2apEnb> (enbN2apSockets[0], amf_enbAddresses[0], amfAddresses[0], cellId, 1);
+  enbApp->AddAmf (1, m_amfApps[0]->GetRelativeCapacity ());
+  for (uint32_t i = 1; i < m_amfApps.size (); ++i)
+    {
+      n2apEnb->AddN2apInterface (cellId, amf_enbAddresses[i], i + 1, amfAddresses[i], enbN2apSockets[i]);
+      enbApp->AddAmf (i + 1, m_amfApps[i]->GetRelativeCapacity ());
+    }
   enb->AggregateObject(n2apEnb);
   enbApp->SetN2apSapAmf (n2apEnb->GetNgcN2apSapEnbProvider ());
   n2apEnb->SetNgcN2apSapEnbUser (enbApp->GetN2apSapEnb());
-  m_amfApp->AddEnb (cellId, amf_enbAddress); // TODO consider if this can be removed
-  // add the interface to the N2AP endpoint on the AMF
-  Ptr<NgcN2apAmf> n2apAmf = m_amfNode->GetObject<NgcN2apAmf> ();
-  n2apAmf->AddN2apInterface (cellId, amf_enbAddress);
-  
-  m_smfUpfApp->AddEnb (cellId, enbAddress, smfAddress);
+}
+
+void
+PointToPointNgcHelper::AddRemoteEnb (Ptr<Node> enb, uint16_t cellId)
+{
+  NS_LOG_FUNCTION (this << enb << cellId);
+  NS_ABORT_MSG_IF (m_n2uLinkDelay.IsZero () || m_n2apLinkDelay.IsZero (),
+                   "the N2 links of a remote eNB need a delay, which is the lookahead of the ranks");
+
+  Initialize ();
+  // the owner rank adds the NrEnbNetDevice before calling AddEnb
+  enb->AddDevice (CreateObject<SimpleNetDevice> ());
+  m_remoteEnbCellIds[enb->GetId ()] = cellId;
+
+  Ipv4Address enbAddress;
+  Ipv4Address smfAddress;
+  std::vector<Ipv4Address> amf_enbAddresses;
+  std::vector<Ipv4Address> amfAddresses;
+  ConnectEnbToCore (enb, cellId, enbAddress, smfAddress, amf_enbAddresses, amfAddresses);
+}
+
+void
+PointToPointNgcHelper::ConnectEnbToCore (Ptr<Node> enb, uint16_t cellId,
+                                         Ipv4Address &enbAddress, Ipv4Address &smfAddress,
+                                         std::vector<Ipv4Address> &amf_enbAddresses,
+                                         std::vector<Ipv4Address> &amfAddresses)
+{
+  // add an IPv4 stack to the previously created eNB
+  InternetStackHelper internet;
+  internet.Install (enb);
+  NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after node creation: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+
+  // create a point to point link between the new eNB and each UPF with
+  // the corresponding new NetDevices on each side  
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (m_n2uLinkDataRate));
+  p2ph.SetDeviceAttribute ("Mtu", UintegerValue (m_n2uLinkMtu));
+  p2ph.SetChannelAttribute ("Delay", TimeValue (m_n2uLinkDelay));  
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  Ptr<Ipv4StaticRouting> enbStaticRouting = ipv4RoutingHelper.GetStaticRouting (enb->GetObject<Ipv4> ());
+  for (uint32_t upfId = 0; upfId < m_upfNodes.size (); ++upfId)
+    {
+      NetDeviceContainer enbUpfDevices = p2ph.Install (enb, m_upfNodes[upfId]);
+      NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
+      m_n2uIpv4AddressHelper.NewNetwork ();
+      Ipv4InterfaceContainer enbUpfIpIfaces = m_n2uIpv4AddressHelper.Assign (enbUpfDevices);
+      NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to N2 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+
+      // the N3 address of the UPF is reached through this link
+      enbStaticRouting->AddHostRouteTo (m_upfN3Addresses[upfId], enbUpfIpIfaces.GetAddress (1), enbUpfIpIfaces.Get (0).second);
+      m_smfApp->AddEnb (cellId, upfId, enbUpfIpIfaces.GetAddress (0), m_upfN3Addresses[upfId]);
+      if (upfId == 0)
+        {
+          enbAddress = enbUpfIpIfaces.GetAddress (0);
+          smfAddress = m_upfN3Addresses[upfId];
+        }
+    }
+
+  // the local UPF of the cell is the nearest one when the eNB and the
+  // UPFs have a position, otherwise the cells take the UPFs in turn
+  uint32_t localUpfId = m_nEnbs++ % m_upfNodes.size ();
+  Ptr<MobilityModel> enbMobility = enb->GetObject<MobilityModel> ();
+  if (enbMobility != 0)
+    {
+      double minDistance = std::numeric_limits<double>::max ();
+      for (uint32_t upfId = 0; upfId < m_upfNodes.size (); ++upfId)
+        {
+          Ptr<MobilityModel> upfMobility = m_upfNodes[upfId]->GetObject<MobilityModel> ();
+          if (upfMobility != 0 && enbMobility->GetDistanceFrom (upfMobility) < minDistance)
+            {
+              minDistance = enbMobility->GetDistanceFrom (upfMobility);
+              localUpfId = upfId;
+            }
+        }
+    }
+  m_smfApp->SetLocalUpf (cellId, localUpfId);
+
+  // create a point to point link between the new eNB and each AMF with
+  // the corresponding new NetDevices on each side
+  PointToPointHelper p2ph_amf;
+  p2ph_amf.SetDeviceAttribute ("DataRate", DataRateValue (m_n2apLinkDataRate));
+  p2ph_amf.SetDeviceAttribute ("Mtu", UintegerValue (m_n2apLinkMtu));
+  p2ph_amf.SetChannelAttribute ("Delay", TimeValue (m_n2apLinkDelay));  
+  for (uint32_t i = 0; i < m_amfNodes.size (); ++i)
+    {
+      NetDeviceContainer enbAmfDevices = p2ph_amf.Install (enb, m_amfNodes[i]);
+      NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after installing p2p dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());  
+
+      m_n2apIpv4AddressHelper.NewNetwork ();
+      Ipv4InterfaceContainer enbAmfIpIfaces = m_n2apIpv4AddressHelper.Assign (enbAmfDevices);
+      NS_LOG_LOGIC ("number of Ipv4 ifaces of the eNB after assigning Ipv4 addr to N2 dev: " << enb->GetObject<Ipv4> ()->GetNInterfaces ());
+
+      Ipv4Address amf_enbAddress = enbAmfIpIfaces.GetAddress (0);
+      amf_enbAddresses.push_back (amf_enbAddress);
+      amfAddresses.push_back (enbAmfIpIfaces.GetAddress (1));
+
+      m_amfApps[i]->AddEnb (cellId, amf_enbAddress); // TODO consider if this can be removed
+      // add the interface to the N2AP endpoint on the AMF
+      Ptr<NgcN2apAmf> n2apAmf = m_amfNodes[i]->GetObject<NgcN2apAmf> ();
+      n2apAmf->AddN2apInterface (cellId, amf_enbAddress);
+    }
 }
 
 
@@ -334,22 +558,44 @@ PointToPointNgcHelper::AddX2Interface (Ptr<Node> enb1, Ptr<Node> enb2)
   Ipv4Address enb1X2Address = enbIpIfaces.GetAddress (0);
   Ipv4Address enb2X2Address = enbIpIfaces.GetAddress (1);
 
-  // Add X2 interface to both eNBs' X2 entities
-  Ptr<NgcX2> enb1X2 = enb1->GetObject<NgcX2> ();
-  Ptr<NrEnbNetDevice> enb1NrDev = enb1->GetDevice (0)->GetObject<NrEnbNetDevice> ();
-  uint16_t enb1CellId = enb1NrDev->GetCellId ();
+  // Add X2 interface to the X2 entities of the eNBs simulated by this rank
+  std::map<uint32_t, uint16_t>::const_iterator remote1 = m_remoteEnbCellIds.find (enb1->GetId ());
+  std::map<uint32_t, uint16_t>::const_iterator remote2 = m_remoteEnbCellIds.find (enb2->GetId ());
+  Ptr<NrEnbNetDevice> enb1NrDev;
+  Ptr<NrEnbNetDevice> enb2NrDev;
+  uint16_t enb1CellId;
+  uint16_t enb2CellId;
+  if (remote1 == m_remoteEnbCellIds.end ())
+    {
+      enb1NrDev = enb1->GetDevice (0)->GetObject<NrEnbNetDevice> ();
+      enb1CellId = enb1NrDev->GetCellId ();
+    }
+  else
+    {
+      enb1CellId = remote1->second;
+    }
   NS_LOG_LOGIC ("NrEnbNetDevice #1 = " << enb1NrDev << " - CellId = " << enb1CellId);
-
-  Ptr<NgcX2> enb2X2 = enb2->GetObject<NgcX2> ();
-  Ptr<NrEnbNetDevice> enb2NrDev = enb2->GetDevice (0)->GetObject<NrEnbNetDevice> ();
-  uint16_t enb2CellId = enb2NrDev->GetCellId ();
+  if (remote2 == m_remoteEnbCellIds.end ())
+    {
+      enb2NrDev = enb2->GetDevice (0)->GetObject<NrEnbNetDevice> ();
+      enb2CellId = enb2NrDev->GetCellId ();
+    }
+  else
+    {
+      enb2CellId = remote2->second;
+    }
   NS_LOG_LOGIC ("NrEnbNetDevice #2 = " << enb2NrDev << " - CellId = " << enb2CellId);
 
-  enb1X2->AddX2Interface (enb1CellId, enb1X2Address, enb2CellId, enb2X2Address);
-  enb2X2->AddX2Interface (enb2CellId, enb2X2Address, enb1CellId, enb1X2Address);
-
-  enb1NrDev->GetRrc ()->AddX2Neighbour (enb2NrDev->GetCellId ());
-  enb2NrDev->GetRrc ()->AddX2Neighbour (enb1NrDev->GetCellId ());
+  if (enb1NrDev != 0)
+    {
+      enb1->GetObject<NgcX2> ()->AddX2Interface (enb1CellId, enb1X2Address, enb2CellId, enb2X2Address);
+      enb1NrDev->GetRrc ()->AddX2Neighbour (enb2CellId);
+    }
+  if (enb2NrDev != 0)
+    {
+      enb2->GetObject<NgcX2> ()->AddX2Interface (enb2CellId, enb2X2Address, enb1CellId, enb1X2Address);
+      enb2NrDev->GetRrc ()->AddX2Neighbour (enb1CellId);
+    }
 }
 
 
@@ -357,9 +603,14 @@ void
 PointToPointNgcHelper::AddUe (Ptr<NetDevice> ueDevice, uint64_t imsi)
 {
   NS_LOG_FUNCTION (this << imsi << ueDevice );
+  Initialize ();
   
-  m_amfApp->AddUe (imsi);
-  m_smfUpfApp->AddUe (imsi);
+  // the AMFs of the set share the subscription data of the UEs
+  for (uint32_t i = 0; i < m_amfApps.size (); ++i)
+    {
+      m_amfApps[i]->AddUe (imsi);
+    }
+  m_smfApp->AddUe (imsi);
   
 
 }
@@ -380,9 +631,9 @@ PointToPointNgcHelper::ActivateEpsBearer (Ptr<NetDevice> ueDevice, uint64_t imsi
   NS_ASSERT (ueIpv4->GetNAddresses (interface) == 1);
   Ipv4Address ueAddr = ueIpv4->GetAddress (interface, 0).GetLocal ();
   NS_LOG_LOGIC (" UE IP address: " << ueAddr);  
-  m_smfUpfApp->SetUeAddress (imsi, ueAddr);
+  m_smfApp->SetUeAddress (imsi, ueAddr);
   
-  uint8_t bearerId = m_amfApp->AddBearer (imsi, tft, bearer);
+  uint8_t bearerId = AddAmfBearer (imsi, tft, bearer);
   Ptr<NrUeNetDevice> ueNrDevice = ueDevice->GetObject<NrUeNetDevice> ();
   if (ueNrDevice)
     {
@@ -407,9 +658,9 @@ PointToPointNgcHelper::ActivateEpsBearer (Ptr<NetDevice> ueDevice, Ptr<NgcUeNas>
   NS_ASSERT (interface >= 0);
   NS_ASSERT (ueIpv4->GetNAddresses (interface) == 1);
   Ipv4Address ueAddr = ueIpv4->GetAddress (interface, 0).GetLocal ();
-  NS_LOG_LOGIC (" UE IP address: " << ueAddr);  m_smfUpfApp->SetUeAddress (imsi, ueAddr);
+  NS_LOG_LOGIC (" UE IP address: " << ueAddr);  m_smfApp->SetUeAddress (imsi, ueAddr);
   
-  uint8_t bearerId = m_amfApp->AddBearer (imsi, tft, bearer);
+  uint8_t bearerId = AddAmfBearer (imsi, tft, bearer);
   ueNas->ActivateEpsBearer (bearer, tft);
   return bearerId;
 }
@@ -418,13 +669,74 @@ PointToPointNgcHelper::ActivateEpsBearer (Ptr<NetDevice> ueDevice, Ptr<NgcUeNas>
 Ptr<Node>
 PointToPointNgcHelper::GetUpfNode ()
 {
-  return m_smfUpf;
+  Initialize ();
+  if (m_n6Gateway != 0)
+    {
+      return m_n6Gateway;
+    }
+  return m_upfNodes[0];
+}
+
+Ptr<Node>
+PointToPointNgcHelper::GetUpfNode (uint32_t i)
+{
+  Initialize ();
+  NS_ASSERT (i < m_upfNodes.size ());
+  return m_upfNodes[i];
+}
+
+uint32_t
+PointToPointNgcHelper::GetNUpfs ()
+{
+  Initialize ();
+  return m_upfNodes.size ();
 }
 
 Ptr<Node>
 PointToPointNgcHelper::GetAmfNode ()
 {
-  return m_amfNode;
+  return m_amfNodes[0];
+}
+
+Ptr<Node>
+PointToPointNgcHelper::GetAmfNode (uint32_t i)
+{
+  Initialize ();
+  NS_ASSERT (i < m_amfNodes.size ());
+  return m_amfNodes[i];
+}
+
+Ptr<NgcAmfApplication>
+PointToPointNgcHelper::GetAmfApp (uint32_t i)
+{
+  Initialize ();
+  NS_ASSERT (i < m_amfApps.size ());
+  return m_amfApps[i];
+}
+
+uint32_t
+PointToPointNgcHelper::GetNAmfs ()
+{
+  Initialize ();
+  return m_amfNodes.size ();
+}
+
+Ptr<NgcSmfApplication>
+PointToPointNgcHelper::GetSmfApp ()
+{
+  Initialize ();
+  return m_smfApp;
+}
+
+uint8_t
+PointToPointNgcHelper::AddAmfBearer (uint64_t imsi, Ptr<NgcTft> tft, EpsBearer bearer)
+{
+  uint8_t bearerId = 0;
+  for (uint32_t i = 0; i < m_amfApps.size (); ++i)
+    {
+      bearerId = m_amfApps[i]->AddBearer (imsi, tft, bearer);
+    }
+  return bearerId;
 }
 
 
@@ -432,16 +744,44 @@ PointToPointNgcHelper::GetAmfNode ()
 Ipv4InterfaceContainer 
 PointToPointNgcHelper::AssignUeIpv4Address (NetDeviceContainer ueDevices)
 {
+  Initialize ();
   return m_ueAddressHelper.Assign (ueDevices);
 }
 
 
 
+Ipv4Address
+PointToPointNgcHelper::AssignRemoteUeIpv4Address ()
+{
+  Initialize ();
+  return m_ueAddressHelper.NewAddress ();
+}
+
+void
+PointToPointNgcHelper::AddRemoteUe (uint64_t imsi, Ipv4Address ueAddress)
+{
+  NS_LOG_FUNCTION (this << imsi << ueAddress);
+  Initialize ();
+  for (uint32_t i = 0; i < m_amfApps.size (); ++i)
+    {
+      m_amfApps[i]->AddUe (imsi);
+    }
+  m_smfApp->AddUe (imsi);
+  m_smfApp->SetUeAddress (imsi, ueAddress);
+}
+
+uint8_t
+PointToPointNgcHelper::ActivateRemoteEpsBearer (uint64_t imsi, Ptr<NgcTft> tft, EpsBearer bearer)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  return AddAmfBearer (imsi, tft, bearer);
+}
+
 Ipv4Address
 PointToPointNgcHelper::GetUeDefaultGatewayAddress ()
 {
-  // return the address of the tun device
-  return m_smfUpf->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+  // return the address of the tun device of the first UPF
+  return m_upfNodes[0]->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
 }
 
 
@@ -33,13 +33,15 @@
 #include <ns3/ngc-tft.h>
 #include <ns3/eps-bearer.h>
 #include <ns3/ngc-helper.h>
+#include <vector>
 
 namespace ns3 {
 
 class Node;
 class NetDevice;
 class VirtualNetDevice;
-class NgcSmfUpfApplication;
+class NgcSmfApplication;
+class NgcUpfApplication;
 class NgcX2;
 class NgcAmf;
 class NgcUeNas;
@@ -51,10 +53,31 @@ class NgcN2apAmf;
  * \ingroup nr
  * \brief Create an NGC network with PointToPoint links
  *
- * This Helper will create an NGC network topology comprising of a
- * single node that implements both the SMF and UPF functionality, and
- * an AMF node. The N2-U, N2-AP, X2-U and X2-C interfaces are realized over
- * PointToPoint links. 
+ * This Helper will create an NGC network topology comprising of a pool
+ * of "NumUpfs" UPF nodes and an AMF set of "NumAmfs" AMF nodes, the
+ * first of which also runs the SMF. Every eNB has an N2-AP link to every
+ * AMF of the set and picks the AMF of each UE, see NgcEnbApplication,
+ * by the 5G-GUTI of the UE or by the relative capacity of the AMFs,
+ * which share the subscription data of the UEs. The SMF picks the UPF of each session, see NgcSmfApplication, and programs
+ * it over the N4 SAP. Every eNB has an N3 (N2-U) link to every UPF, and
+ * reaches each UPF at a stable N3 address, so that the tunnels of a UE
+ * survive its handovers. With more than one UPF, the N6 interfaces of
+ * the UPFs are linked to an N6 gateway node, returned by GetUpfNode(),
+ * which routes the downlink packets of each UE to the UPF of its
+ * session. The N2-U, N2-AP, N6, X2-U and X2-C interfaces are realized
+ * over PointToPoint links.
+ *
+ * The topology can be split across the ranks of a distributed (MPI)
+ * simulation. The UPF and AMF nodes, which are coupled through the
+ * N11 and N4 SAPs, stay on rank 0 and each rank simulates a cluster of eNBs and
+ * UEs with its own NrHelper, i.e. its own channel. Every rank builds
+ * the whole topology in the same order: the eNBs and UEs of the other
+ * ranks are added with AddRemoteEnb(), AddRemoteUe() and
+ * ActivateRemoteEpsBearer(), so that the nodes, the devices and the
+ * addresses are the same in every rank. The N2 and X2 links between two
+ * ranks become remote point-to-point channels carrying the GTP-U tunnels,
+ * and their delays give the lookahead of the distributed simulator, so
+ * they must not be zero.
  */
 class PointToPointNgcHelper : public NgcHelper
 {
@@ -77,6 +100,7 @@ public:
    */
   static TypeId GetTypeId (void);
   virtual void DoDispose ();
+  virtual void DoInitialize ();
 
   // inherited from NgcHelper
   virtual void AddEnb (Ptr<Node> enbNode, Ptr<NetDevice> nrEnbNetDevice, uint16_t cellId);
@@ -89,39 +113,232 @@ public:
   virtual Ipv4InterfaceContainer AssignUeIpv4Address (NetDeviceContainer ueDevices);
   virtual Ipv4Address GetUeDefaultGatewayAddress ();
 
+  /**
+   * \param i the identifier of a UPF of the pool
+   * \return the node of the UPF
+   */
+  Ptr<Node> GetUpfNode (uint32_t i);
+
+  /**
+   * \return the number of UPFs of the pool
+   */
+  uint32_t GetNUpfs ();
+
+  /**
+   * \param i the index of an AMF of the AMF set, whose AMF id is i + 1
+   * \return the node of the AMF
+   */
+  Ptr<Node> GetAmfNode (uint32_t i);
+
+  /**
+   * \param i the index of an AMF of the AMF set, whose AMF id is i + 1
+   * \return the application of the AMF, whose RelativeCapacity is read
+   * when the eNBs are added
+   */
+  Ptr<NgcAmfApplication> GetAmfApp (uint32_t i);
+
+  /**
+   * \return the number of AMFs of the AMF set
+   */
+  uint32_t GetNAmfs ();
 
+  /**
+   * \return the application of the SMF
+   */
+  Ptr<NgcSmfApplication> GetSmfApp ();
+
+  /**
+   * Add an eNB simulated by another rank of a distributed simulation:
+   * build the same N2-U and N2-AP links and register the cell in the
+   * SMF and in the AMF as AddEnb() does, without the eNB applications.
+   * A placeholder device stands for the NrEnbNetDevice, so that the
+   * devices of the links get the indices they have in the other rank.
+   *
+   * \param enbNode the eNB node, owned by another rank
+   * \param cellId the cell id the other rank gives to the eNB
+   */
+  void AddRemoteEnb (Ptr<Node> enbNode, uint16_t cellId);
+
+  /**
+   * Take the address that AssignUeIpv4Address() gives to a UE simulated
+   * by another rank.
+   *
+   * \return the address of the UE
+   */
+  Ipv4Address AssignRemoteUeIpv4Address ();
+
+  /**
+   * Register in the SMF and in the AMF a UE simulated by another rank.
+   *
+   * \param imsi the IMSI the other rank gives to the UE
+   * \param ueAddress the address of the UE
+   */
+  void AddRemoteUe (uint64_t imsi, Ipv4Address ueAddress);
+
+  /**
+   * Add to the AMF an EPS bearer of a UE simulated by another rank.
+   *
+   * \param imsi the IMSI of the UE
+   * \param tft the Traffic Flow Template of the bearer
+   * \param bearer the characteristics of the bearer
+   * \return bearer ID
+   */
+  uint8_t ActivateRemoteEpsBearer (uint64_t imsi, Ptr<NgcTft> tft, EpsBearer bearer);
 
 private:
 
+  /**
+   * Create a UPF node, with its TUN device and its N3 socket, and add it
+   * to the pool of the SMF.
+   */
+  void CreateUpf ();
+
+  /**
+   * Create an AMF node, with its N2-AP endpoint and its application, and
+   * add it to the AMF set served by the SMF.
+   */
+  void CreateAmf ();
+
+  /**
+   * Add a bearer of a UE to every AMF of the set
+   *
+   * \param imsi the IMSI of the UE
+   * \param tft the Traffic Flow Template of the bearer
+   * \param bearer the characteristics of the bearer
+   * \return bearer ID, the same in every AMF
+   */
+  uint8_t AddAmfBearer (uint64_t imsi, Ptr<NgcTft> tft, EpsBearer bearer);
+
+  /**
+   * Route the packets addressed to a UE towards the UPF of its session.
+   * Connected to the SessionEstablished trace of the SMF when the pool
+   * has more than one UPF.
+   *
+   * \param imsi the IMSI of the UE
+   * \param ueAddr the address of the UE
+   * \param upfId the UPF of the session
+   */
+  void NotifySessionEstablished (uint64_t imsi, Ipv4Address ueAddr, uint32_t upfId);
+
+  /**
+   * Install the internet stack on an eNB, connect it to every UPF and to
+   * every AMF and register the cell in the SMF and in the AMFs.
+   *
+   * \param enb the eNB node
+   * \param cellId the cell id
+   * \param enbN2uAddress the N2-U address of the eNB towards the first UPF
+   * \param smfN2uAddress the N3 address of the first UPF
+   * \param enbN2apAddresses the N2-AP addresses of the eNB, by AMF index
+   * \param amfN2apAddresses the N2-AP addresses of the AMFs, by AMF index
+   */
+  void ConnectEnbToCore (Ptr<Node> enb, uint16_t cellId,
+                         Ipv4Address &enbN2uAddress, Ipv4Address &smfN2uAddress,
+                         std::vector<Ipv4Address> &enbN2apAddresses,
+                         std::vector<Ipv4Address> &amfN2apAddresses);
+
+  /**
+   * Cell id of the eNBs simulated by another rank, by node id
+   */
+  std::map<uint32_t, uint16_t> m_remoteEnbCellIds;
+
   /** 
-   * helper to assign addresses to UE devices as well as to the TUN device of the SMF/UPF
+   * helper to assign addresses to UE devices as well as to the TUN devices of the UPFs
    */
   Ipv4AddressHelper m_ueAddressHelper; 
-  
+
+  /**
+   * SMF application
+   */
+  Ptr<NgcSmfApplication> m_smfApp;
+
+  /**
+   * The number of UPFs of the pool
+   */
+  uint32_t m_numUpfs;
+
+  /**
+   * UPF network elements, by UPF identifier
+   */
+  std::vector<Ptr<Node> > m_upfNodes;
+
+  /**
+   * UPF applications, by UPF identifier
+   */
+  std::vector<Ptr<NgcUpfApplication> > m_upfApps;
+
+  /**
+   * TUN devices implementing tunneling of user data over GTP-U/UDP/IP,
+   * by UPF identifier
+   */
+  std::vector<Ptr<VirtualNetDevice> > m_tunDevices;
+
+  /**
+   * N3 addresses of the UPFs, by UPF identifier. Each eNB reaches them
+   * through its own N3 link to the UPF.
+   */
+  std::vector<Ipv4Address> m_upfN3Addresses;
+
+  /**
+   * N6 link between a UPF and the N6 gateway
+   */
+  struct N6Link
+  {
+    Ipv4Address upfAddress;
+    uint32_t upfInterface;
+    Ipv4Address gatewayAddress;
+    uint32_t gatewayInterface;
+  };
+
+  /**
+   * N6 links of the UPFs, by UPF identifier
+   */
+  std::vector<N6Link> m_n6Links;
+
+  /**
+   * N6 gateway, only with more than one UPF
+   */
+  Ptr<Node> m_n6Gateway;
+
+  /**
+   * helper to assign addresses to N6 NetDevices
+   */
+  Ipv4AddressHelper m_n6Ipv4AddressHelper;
+
+  /**
+   * The data rate of the N6 links
+   */
+  DataRate m_n6LinkDataRate;
+
+  /**
+   * The delay of the N6 links
+   */
+  Time     m_n6LinkDelay;
+
   /**
-   * SMF-UPF network element
+   * The MTU of the N6 links
    */
-  Ptr<Node> m_smfUpf; 
+  uint16_t m_n6LinkMtu;
 
   /**
-   * SMF-UPF application
+   * The number of eNBs connected to the core, for the assignment of
+   * the local UPFs
    */
-  Ptr<NgcSmfUpfApplication> m_smfUpfApp;
+  uint32_t m_nEnbs;
 
   /**
-   * TUN device implementing tunneling of user data over GTP-U/UDP/IP
+   * The number of AMFs of the AMF set
    */
-  Ptr<VirtualNetDevice> m_tunDevice;
+  uint32_t m_numAmfs;
 
   /**
-   * AMF network element
+   * AMF network elements, by AMF index; the first one also runs the SMF
    */
-  Ptr<Node> m_amfNode;
+  std::vector<Ptr<Node> > m_amfNodes;
 
   /**
-   * AMF application
+   * AMF applications, by AMF index
    */
-  Ptr<NgcAmfApplication> m_amfApp;
+  std::vector<Ptr<NgcAmfApplication> > m_amfApps;
 
   /**
    * N2-U interfaces
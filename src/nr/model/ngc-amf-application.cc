@@ -25,6 +25,11 @@
 
 #include <ns3/fatal-error.h>
 #include <ns3/log.h>
+#include <ns3/uinteger.h>
+#include <ns3/trace-source-accessor.h>
+#include <ns3/enum.h>
+#include <ns3/simulator.h>
+#include <ns3/make-event.h>
 
 #include "ngc-n2ap-sap.h"
 #include "ngc-n11-sap.h"
@@ -38,11 +43,13 @@ NS_LOG_COMPONENT_DEFINE ("NgcAmfApplication");
 NS_OBJECT_ENSURE_REGISTERED (NgcAmfApplication);
 
 NgcAmfApplication::NgcAmfApplication ()
-  : m_n11SapSmf (0)
+  : m_n11SapSmf (0),
+    m_tmsiCount (0)
 {
   NS_LOG_FUNCTION (this);
   m_n2apSapAmf = new MemberNgcN2apSapAmf<NgcAmfApplication> (this);
   m_n11SapAmf = new MemberNgcN11SapAmf<NgcAmfApplication> (this);
+  m_queue = CreateObject<NfQueue> ();
 }
 
 
@@ -57,6 +64,7 @@ NgcAmfApplication::DoDispose ()
   NS_LOG_FUNCTION (this);
   delete m_n2apSapAmf;
   delete m_n11SapAmf;
+  m_queue = 0;
 }
 
 TypeId
@@ -66,10 +74,53 @@ NgcAmfApplication::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName("Nr")
     .AddConstructor<NgcAmfApplication> ()
+    .AddAttribute ("AmfId",
+                   "The identifier of the AMF in its AMF set, carried by the "
+                   "5G-GUTIs it allocates",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&NgcAmfApplication::m_amfId),
+                   MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("RelativeCapacity",
+                   "The weight of the AMF in the AMF selection of the eNBs, "
+                   "see 3GPP TS 23.501 section 5.19.3",
+                   UintegerValue (255),
+                   MakeUintegerAccessor (&NgcAmfApplication::m_relativeCapacity),
+                   MakeUintegerChecker<uint8_t> (1))
+    .AddAttribute ("OverloadAction",
+                   "What the AMF does with the Registration Requests its queue refuses",
+                   EnumValue (NgcAmfApplication::DROP),
+                   MakeEnumAccessor (&NgcAmfApplication::m_overloadAction),
+                   MakeEnumChecker (NgcAmfApplication::DROP, "Drop",
+                                    NgcAmfApplication::REJECT, "Reject"))
+    .AddAttribute ("T3346",
+                   "The back-off time the AMF gives to the UEs it rejects because of overload",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&NgcAmfApplication::m_t3346),
+                   MakeTimeChecker ())
+    .AddTraceSource ("RxMessage",
+                     "A N2 or N11 message about a UE arrives at the AMF",
+                     MakeTraceSourceAccessor (&NgcAmfApplication::m_rxMessageTrace),
+                     "ns3::NgcAmfApplication::MessageTracedCallback")
+    .AddTraceSource ("ProcessedMessage",
+                     "The AMF has processed a N2 or N11 message about a UE",
+                     MakeTraceSourceAccessor (&NgcAmfApplication::m_processedMessageTrace),
+                     "ns3::NgcAmfApplication::ProcessedMessageTracedCallback")
     ;
   return tid;
 }
 
+uint16_t
+NgcAmfApplication::GetAmfId () const
+{
+  return m_amfId;
+}
+
+uint8_t
+NgcAmfApplication::GetRelativeCapacity () const
+{
+  return m_relativeCapacity;
+}
+
 NgcN2apSapAmf* 
 NgcAmfApplication::GetN2apSapAmf ()
 {
@@ -112,6 +163,8 @@ NgcAmfApplication::AddUe (uint64_t imsi)
   Ptr<UeInfo> ueInfo = Create<UeInfo> ();
   ueInfo->imsi = imsi;
   ueInfo->amfUeN2Id = imsi;
+  ueInfo->guti = 0;
+  ueInfo->pduSessionEstablished = false;
 ///  std::cout << ueInfo->bearersToBeActivated.size() <<"sjkang1021------>" <<std::endl;
   m_ueInfoMap[imsi] = ueInfo;
   ueInfo->bearerCounter = 0;
@@ -133,6 +186,42 @@ NgcAmfApplication::AddBearer (uint64_t imsi, Ptr<NgcTft> tft, EpsBearer bearer)
 }
 
 
+Ptr<NfQueue>
+NgcAmfApplication::GetQueue () const
+{
+  return m_queue;
+}
+
+bool
+NgcAmfApplication::Receive (uint64_t imsi, std::string message, bool initial, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << imsi << message);
+  m_rxMessageTrace (imsi, message);
+  Ptr<EventImpl> processing (event, false);
+  if (m_queue->IsInstantaneous ())
+    {
+      ProcessMessage (imsi, message, Seconds (0), processing);
+      return true;
+    }
+  Time delay;
+  if (!m_queue->Enqueue (message, initial, delay))
+    {
+      // refused: processed at no cost
+      m_processedMessageTrace (imsi, message, Seconds (0));
+      return false;
+    }
+  Simulator::Schedule (delay, &NgcAmfApplication::ProcessMessage, this, imsi, message, delay, processing);
+  return true;
+}
+
+void
+NgcAmfApplication::ProcessMessage (uint64_t imsi, std::string message, Time delay, Ptr<EventImpl> processing)
+{
+  NS_LOG_FUNCTION (this << imsi << message << delay);
+  processing->Invoke ();
+  m_processedMessageTrace (imsi, message, delay);
+}
+
 /* jhlim */
 void
 NgcAmfApplication::NamfCommunicationUeContextTransfer(uint64_t imsi)
@@ -154,8 +243,9 @@ NgcAmfApplication::NamfCommunicationRegistrationCompleteNotify(uint64_t imsi)
 bool
 NgcAmfApplication::IsGuti(uint64_t imsi)
 {
-	//check whether imsi is GUTI or not.
-	return false;
+  // a 5G-GUTI carries the identifier of its AMF above the 5G-TMSI,
+  // where an IMSI has no bits set
+  return NgcN2apSap::GetGutiAmfId (imsi) != 0;
 }
 
 // N2-AP SAP AMF forwarded methods
@@ -191,13 +281,32 @@ NgcAmfApplication::DoRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id
 
 /* jhlim: 3. Registration Request
 	Receive N2 message (N2 parameters, Registration Request (as in step 1), and UE access selection and PDU session selection information, UE Context request) */
-void 
+void
 NgcAmfApplication::DoRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t gci)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id << imsi << gci);
+  if (Receive (imsi, "RegistrationRequest", true,
+               MakeEvent (&NgcAmfApplication::ProcessRegistrationRequest, this, amfUeN2Id, enbUeN2Id, imsi, gci)))
+    {
+      return;
+    }
+  // overload: the UE backs off for T3346 if the AMF rejects it, or
+  // retries when its own timer expires if the AMF drops the request
+  if (m_overloadAction == REJECT)
+    {
+      m_n2apSapAmfProvider->SendRegistrationReject (amfUeN2Id, enbUeN2Id, gci, NgcN2apSap::CONGESTION, m_t3346);
+    }
+}
+
+void 
+NgcAmfApplication::ProcessRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t gci)
 {
   NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id << imsi << gci);
   std::map<uint64_t, Ptr<UeInfo> >::iterator it = m_ueInfoMap.find (imsi);
   NS_ASSERT_MSG (it != m_ueInfoMap.end (), "could not find any UE with IMSI " << imsi);
   it->second->cellId = gci;
+  it->second->amfUeN2Id = amfUeN2Id;
+  it->second->enbUeN2Id = enbUeN2Id;
   uint16_t cellId = it->second->cellId;
   std::string identityRequest;
 
@@ -222,20 +331,64 @@ NgcAmfApplication::DoRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id
   
   // 11-12. Registration Accept
   //     (5G-GUTI, Registration Area, PDU Session status, ...)
-  uint64_t guti = 1; // assign 5G-GUTI for UE
-  m_n2apSapAmfProvider->SendRegistrationAccept(amfUeN2Id, enbUeN2Id, cellId, guti);
+  if (it->second->guti == 0)
+    {
+      // assign 5G-GUTI for UE, which lets the eNBs reach this AMF again
+      it->second->guti = NgcN2apSap::MakeGuti (m_amfId, ++m_tmsiCount);
+    }
+  m_n2apSapAmfProvider->SendRegistrationAccept(amfUeN2Id, enbUeN2Id, cellId, it->second->guti);
 }
 
 void
 NgcAmfApplication::DoRegistrationComplete (uint64_t amfUeN2Id, uint16_t enbUeN2Id)
 {
-	NS_LOG_FUNCTION (this);
-	NS_LOG_INFO("Registration Compelete.");
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id);
+  Receive (amfUeN2Id, "RegistrationComplete", false,
+           MakeEvent (&NgcAmfApplication::ProcessRegistrationComplete, this, amfUeN2Id, enbUeN2Id));
+}
+
+void
+NgcAmfApplication::ProcessRegistrationComplete (uint64_t amfUeN2Id, uint16_t enbUeN2Id)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id);
+  uint64_t imsi = amfUeN2Id;
+  std::map<uint64_t, Ptr<UeInfo> >::iterator it = m_ueInfoMap.find (imsi);
+  NS_ASSERT_MSG (it != m_ueInfoMap.end (), "could not find any UE with IMSI " << imsi);
+  if (it->second->pduSessionEstablished)
+    {
+      return;
+    }
 
+  // PDU Session Establishment of the bearers of the UE, which the UE
+  // requests once registered
+  it->second->pduSessionEstablished = true;
+  NgcN11SapSmf::CreateSessionRequestMessage msg;
+  msg.imsi = imsi;
+  msg.uli.gci = it->second->cellId;
+  msg.amfId = m_amfId;
+  for (std::list<BearerInfo>::iterator bit = it->second->bearersToBeActivated.begin ();
+       bit != it->second->bearersToBeActivated.end ();
+       ++bit)
+    {
+      NgcN11SapSmf::BearerContextToBeCreated bearerContext;
+      bearerContext.epsBearerId = bit->bearerId;
+      bearerContext.bearerLevelQos = bit->bearer;
+      bearerContext.tft = bit->tft;
+      msg.bearerContextsToBeCreated.push_back (bearerContext);
+    }
+  m_n11SapSmf->CreateSessionRequest (msg);
 }
 // jhlim
-void 
+void
 NgcAmfApplication::DoIdentityResponse (uint64_t amfUeN2Id, uint16_t enbUeN2Id)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id);
+  Receive (amfUeN2Id, "IdentityResponse", false,
+           MakeEvent (&NgcAmfApplication::ProcessIdentityResponse, this, amfUeN2Id, enbUeN2Id));
+}
+
+void 
+NgcAmfApplication::ProcessIdentityResponse (uint64_t amfUeN2Id, uint16_t enbUeN2Id)
 {
   NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id);
 }
@@ -261,8 +414,16 @@ NgcAmfApplication::DoInitialContextSetupResponse (uint64_t amfUeN2Id, uint16_t e
   NS_FATAL_ERROR ("unimplemented");
 }
 
-void 
+void
 NgcAmfApplication::DoPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<NgcN2apSapAmf::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id << gci);
+  Receive (amfUeN2Id, "PathSwitchRequest", false,
+           MakeEvent (&NgcAmfApplication::ProcessPathSwitchRequest, this, enbUeN2Id, amfUeN2Id, gci, erabToBeSwitchedInDownlinkList));
+}
+
+void 
+NgcAmfApplication::ProcessPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<NgcN2apSapAmf::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
 {
   NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id << gci);
 
@@ -276,6 +437,7 @@ NgcAmfApplication::DoPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id,
   NgcN11SapSmf::ModifyBearerRequestMessage msg;
   msg.teid = imsi; // trick to avoid the need for allocating TEIDs on the N11 interface
   msg.uli.gci = gci;
+  msg.amfId = m_amfId;
   // bearer modification is not supported for now
   m_n11SapSmf->ModifyBearerRequest (msg);
 }
@@ -283,8 +445,16 @@ NgcAmfApplication::DoPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id,
 
 // N11 SAP AMF forwarded methods
 
-void 
+void
 NgcAmfApplication::DoCreateSessionResponse (NgcN11SapAmf::CreateSessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.teid);
+  Receive (msg.teid, "CreateSessionResponse", false,
+           MakeEvent (&NgcAmfApplication::ProcessCreateSessionResponse, this, msg));
+}
+
+void 
+NgcAmfApplication::ProcessCreateSessionResponse (NgcN11SapAmf::CreateSessionResponseMessage msg)
 {
   NS_LOG_FUNCTION (this << msg.teid);
   uint64_t imsi = msg.teid;
@@ -311,8 +481,16 @@ NgcAmfApplication::DoCreateSessionResponse (NgcN11SapAmf::CreateSessionResponseM
 }
 
 
-void 
+void
 NgcAmfApplication::DoModifyBearerResponse (NgcN11SapAmf::ModifyBearerResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.teid);
+  Receive (msg.teid, "ModifyBearerResponse", false,
+           MakeEvent (&NgcAmfApplication::ProcessModifyBearerResponse, this, msg));
+}
+
+void 
+NgcAmfApplication::ProcessModifyBearerResponse (NgcN11SapAmf::ModifyBearerResponseMessage msg)
 {
   NS_LOG_FUNCTION (this << msg.teid);
   NS_ASSERT (msg.cause == NgcN11SapAmf::ModifyBearerResponseMessage::REQUEST_ACCEPTED);
@@ -330,6 +508,14 @@ NgcAmfApplication::DoModifyBearerResponse (NgcN11SapAmf::ModifyBearerResponseMes
 
 void
 NgcAmfApplication::DoErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<NgcN2apSapAmf::ErabToBeReleasedIndication> erabToBeReleaseIndication)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id);
+  Receive (amfUeN2Id, "ErabReleaseIndication", false,
+           MakeEvent (&NgcAmfApplication::ProcessErabReleaseIndication, this, amfUeN2Id, enbUeN2Id, erabToBeReleaseIndication));
+}
+
+void
+NgcAmfApplication::ProcessErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<NgcN2apSapAmf::ErabToBeReleasedIndication> erabToBeReleaseIndication)
 {
   NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id);
   uint64_t imsi = amfUeN2Id;
@@ -339,6 +525,7 @@ NgcAmfApplication::DoErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2
   NgcN11SapSmf::DeleteBearerCommandMessage msg;
   // trick to avoid the need for allocating TEIDs on the N11 interface
   msg.teid = imsi;
+  msg.amfId = m_amfId;
 
   for (std::list<NgcN2apSapAmf::ErabToBeReleasedIndication>::iterator bit = erabToBeReleaseIndication.begin (); bit != erabToBeReleaseIndication.end (); ++bit)
     {
@@ -352,6 +539,14 @@ NgcAmfApplication::DoErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2
 
 void
 NgcAmfApplication::DoDeleteBearerRequest (NgcN11SapAmf::DeleteBearerRequestMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.teid);
+  Receive (msg.teid, "DeleteBearerRequest", false,
+           MakeEvent (&NgcAmfApplication::ProcessDeleteBearerRequest, this, msg));
+}
+
+void
+NgcAmfApplication::ProcessDeleteBearerRequest (NgcN11SapAmf::DeleteBearerRequestMessage msg)
 {
   NS_LOG_FUNCTION (this);
   uint64_t imsi = msg.teid;
@@ -27,6 +27,10 @@
 #include <ns3/ngc-n2ap-sap.h>
 #include <ns3/ngc-n11-sap.h>
 #include <ns3/application.h>
+#include <ns3/traced-callback.h>
+#include <ns3/nstime.h>
+#include <ns3/event-impl.h>
+#include <ns3/nf-queue.h>
 
 
 #include <map>
@@ -48,6 +52,15 @@ class NgcAmfApplication : public Application
   friend class MemberNgcN11SapAmf<NgcAmfApplication>;
   
 public:
+
+  /**
+   * what the AMF does with a Registration Request it cannot queue
+   */
+  enum OverloadAction
+  {
+    DROP,   ///< discard it, the UE retries on its own timer
+    REJECT  ///< send a Registration Reject with the T3346 back-off timer
+  };
   
   /** 
    * Constructor
@@ -91,8 +104,24 @@ public:
    */
   NgcN11SapAmf* GetN11SapAmf ();
 
-  /** 
-   * Add a new ENB to the AMF. 
+  /**
+   * \return the identifier of the AMF in its AMF set
+   */
+  uint16_t GetAmfId () const;
+
+  /**
+   * \return the weight of the AMF in the AMF selection of the eNBs
+   */
+  uint8_t GetRelativeCapacity () const;
+
+  /**
+   * \return the processing queue of the AMF, which sets the service time
+   * of each message and the number of workers
+   */
+  Ptr<NfQueue> GetQueue () const;
+
+  /**
+   * Add a new ENB to the AMF.
    * \param ecgi E-UTRAN Cell Global ID, the unique identifier of the eNodeB
    * \param the eNB N2UAddr 
    */
@@ -117,6 +146,29 @@ public:
    */
   uint8_t AddBearer (uint64_t imsi, Ptr<NgcTft> tft, EpsBearer bearer);
 
+  /**
+   * TracedCallback signature for the arrival of a N2 or N11 message
+   * about a UE.
+   *
+   * \param [in] imsi the IMSI of the UE
+   * \param [in] message the name of the message
+   */
+  typedef void (* MessageTracedCallback)
+    (uint64_t imsi, std::string message);
+
+  /**
+   * TracedCallback signature for the end of the processing of a N2 or
+   * N11 message about a UE.
+   *
+   * \param [in] imsi the IMSI of the UE
+   * \param [in] message the name of the message
+   * \param [in] delay the time the message spent in the AMF, waiting
+   *             for a worker and being processed, zero if the AMF
+   *             refused it because of overload
+   */
+  typedef void (* ProcessedMessageTracedCallback)
+    (uint64_t imsi, std::string message, Time delay);
+
 
 private:
 
@@ -139,6 +191,38 @@ private:
   void DoRegistrationComplete(uint64_t amfUeN2Id, uint16_t enbUeN2Id);
   void DoIdentityResponse (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
 
+  /**
+   * Queue a message about a UE for processing
+   *
+   * \param imsi the IMSI of the UE
+   * \param message the name of the message
+   * \param initial whether the message starts a procedure, in which case
+   *                it is refused when the AMF is overloaded
+   * \param event the processing of the message
+   * \return false if the message is refused
+   */
+  bool Receive (uint64_t imsi, std::string message, bool initial, EventImpl *event);
+
+  /**
+   * Process a message once a worker has served it
+   *
+   * \param imsi the IMSI of the UE
+   * \param message the name of the message
+   * \param delay the time the message spent in the AMF
+   * \param processing the processing of the message
+   */
+  void ProcessMessage (uint64_t imsi, std::string message, Time delay, Ptr<EventImpl> processing);
+
+  // processing of the messages once served
+  void ProcessRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t ecgi);
+  void ProcessRegistrationComplete (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
+  void ProcessIdentityResponse (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
+  void ProcessPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<NgcN2apSapAmf::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList);
+  void ProcessErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<NgcN2apSapAmf::ErabToBeReleasedIndication> erabToBeReleaseIndication);
+  void ProcessCreateSessionResponse (NgcN11SapAmf::CreateSessionResponseMessage msg);
+  void ProcessModifyBearerResponse (NgcN11SapAmf::ModifyBearerResponseMessage msg);
+  void ProcessDeleteBearerRequest (NgcN11SapAmf::DeleteBearerRequestMessage msg);
+
   // hmlee
   void DoNsmfPDUSessionUpdateSMContext();
   void DoNsmfPDUSessionReleaseSMContext();
@@ -166,6 +250,8 @@ private:
     uint16_t cellId;
     std::list<BearerInfo> bearersToBeActivated;
     uint16_t bearerCounter;
+    uint64_t guti; ///< 5G-GUTI allocated to the UE, 0 if none yet
+    bool pduSessionEstablished; ///< whether the SMF has a session for the UE
   };
 
   /**
@@ -205,6 +291,43 @@ private:
 
   NgcN11SapAmf* m_n11SapAmf;
   NgcN11SapSmf* m_n11SapSmf;
+
+  /**
+   * identifier of the AMF in its AMF set
+   */
+  uint16_t m_amfId;
+
+  /**
+   * weight of the AMF in the AMF selection of the eNBs
+   */
+  uint8_t m_relativeCapacity;
+
+  /**
+   * last 5G-TMSI allocated by the AMF
+   */
+  uint32_t m_tmsiCount;
+
+  /**
+   * processing queue of the N2 and N11 messages
+   */
+  Ptr<NfQueue> m_queue;
+
+  OverloadAction m_overloadAction;
+
+  /**
+   * back-off timer given to the UEs rejected because of overload
+   */
+  Time m_t3346;
+
+  /**
+   * fired when a message about a UE arrives at the AMF
+   */
+  TracedCallback<uint64_t, std::string> m_rxMessageTrace;
+
+  /**
+   * fired when the AMF has processed a message about a UE
+   */
+  TracedCallback<uint64_t, std::string, Time> m_processedMessageTrace;
   
 };
 
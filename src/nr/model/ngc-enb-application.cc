@@ -30,9 +30,11 @@
 #include "ns3/ipv4.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/uinteger.h"
+#include "ns3/hash.h"
 
 #include "ngc-gtpu-header.h"
 #include "eps-bearer-tag.h"
+#include <cmath>
 
 
 namespace ns3 {
@@ -76,7 +78,8 @@ NgcEnbApplication::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_nrSocket = 0;
-  m_n2uSocket = 0;
+  m_n2uTunnel->Dispose ();
+  m_n2uTunnel = 0;
   delete m_n2SapProvider;
   delete m_n2apSapEnb;
 }
@@ -84,17 +87,17 @@ NgcEnbApplication::DoDispose (void)
 
 NgcEnbApplication::NgcEnbApplication (Ptr<Socket> nrSocket, Ptr<Socket> n2uSocket, Ipv4Address enbN2uAddress, Ipv4Address smfN2uAddress, uint16_t cellId)
   : m_nrSocket (nrSocket),
-    m_n2uSocket (n2uSocket),    
     m_enbN2uAddress (enbN2uAddress),
     m_smfN2uAddress (smfN2uAddress),
-    m_gtpuUdpPort (2152), // fixed by the standard
     m_n2SapUser (0),
     m_n2apSapEnbProvider (0),
 	//m_n2apSapAmf (0), // jhlim
     m_cellId (cellId)
 {
   NS_LOG_FUNCTION (this << nrSocket << n2uSocket << smfN2uAddress);
-  m_n2uSocket->SetRecvCallback (MakeCallback (&NgcEnbApplication::RecvFromN2uSocket, this));
+  m_n2uTunnel = CreateObject<UdpTunnelEndpoint> ();
+  m_n2uTunnel->SetSocket (n2uSocket);
+  m_n2uTunnel->SetRecvCallback (MakeCallback (&NgcEnbApplication::RecvFromN2uTunnel, this));
   m_nrSocket->SetRecvCallback (MakeCallback (&NgcEnbApplication::RecvFromNrSocket, this));
   m_n2SapProvider = new MemberNgcEnbN2SapProvider<NgcEnbApplication> (this);
   m_n2apSapEnb = new MemberNgcN2apSapEnb<NgcEnbApplication> (this);
@@ -141,42 +144,106 @@ NgcEnbApplication::GetN2apSapEnb ()
   return m_n2apSapEnb;
 }
 
-bool
-NgcEnbApplication::is5gGuti(uint64_t imsi)
+void
+NgcEnbApplication::AddAmf (uint16_t amfId, uint8_t relativeCapacity)
 {
-	return false;
+  NS_LOG_FUNCTION (this << amfId << (uint32_t) relativeCapacity);
+  NS_ASSERT_MSG (amfId != 0, "AMF id 0 is reserved");
+  m_amfCapacityMap[amfId] = relativeCapacity;
 }
 
-std::string
-NgcEnbApplication::GetCmState(uint64_t imsi)
+NgcEnbApplication::CmState
+NgcEnbApplication::GetCmState (uint64_t imsi) const
 {
-	std::string state = "CM-IDLE"; // UE doesn't have a connected AMF.
-	return state;
+  std::map<uint64_t, UeAmfContext>::const_iterator it = m_ueAmfContextMap.find (imsi);
+  if (it == m_ueAmfContextMap.end ())
+    {
+      return CM_IDLE;
+    }
+  return it->second.cmState;
 }
 
-/* jhlim */
-NgcN2apSapAmf*
-NgcEnbApplication::GetUeConnectedAmf(uint64_t imsi)
+uint16_t
+NgcEnbApplication::GetUeAmfId (uint64_t imsi) const
+{
+  std::map<uint64_t, UeAmfContext>::const_iterator it = m_ueAmfContextMap.find (imsi);
+  if (it == m_ueAmfContextMap.end ())
+    {
+      return 0;
+    }
+  return it->second.amfId;
+}
+
+NgcEnbApplication::UeAmfContext &
+NgcEnbApplication::GetUeAmfContext (uint64_t imsi)
+{
+  std::map<uint64_t, UeAmfContext>::iterator it = m_ueAmfContextMap.find (imsi);
+  if (it == m_ueAmfContextMap.end ())
+    {
+      UeAmfContext ctx;
+      ctx.cmState = CM_IDLE;
+      ctx.amfId = 0;
+      ctx.guti = 0;
+      it = m_ueAmfContextMap.insert (std::make_pair (imsi, ctx)).first;
+    }
+  return it->second;
+}
+
+uint16_t
+NgcEnbApplication::GetUeConnectedAmf (uint64_t imsi) const
 {
-	// find AMF included in imsi(5G-GUTI).
-	return m_n2apSapAmf;
+  std::map<uint64_t, UeAmfContext>::const_iterator it = m_ueAmfContextMap.find (imsi);
+  if (it == m_ueAmfContextMap.end ())
+    {
+      return 0;
+    }
+  // the AMF is the one included in the 5G-GUTI, if the UE has one
+  uint16_t amfId = it->second.amfId;
+  if (it->second.guti != 0)
+    {
+      amfId = NgcN2apSap::GetGutiAmfId (it->second.guti);
+    }
+  if (m_amfCapacityMap.find (amfId) == m_amfCapacityMap.end ())
+    {
+      return 0;
+    }
+  return amfId;
 }
 
-NgcN2apSapAmf*
-NgcEnbApplication::DoAmfSelection(uint64_t imsi)
+uint16_t
+NgcEnbApplication::DoAmfSelection (uint64_t imsi) const
 {
-	std::string state = GetCmState(imsi);
-	NS_ASSERT_MSG((state != "CM-CONNECTED") && (state != "CM-IDLE"), "UE's CM-STATE has wrong value.");
-	if(state == "CM-CONNECTED") {
-		return GetUeConnectedAmf(imsi);
-	}
-	else { // state "CM-IDLE")
-		return m_n2apSapAmf;
-	}
+  if (m_amfCapacityMap.empty ())
+    {
+      return 0;
+    }
+  uint16_t amfId = GetUeConnectedAmf (imsi);
+  if (amfId != 0)
+    {
+      return amfId;
+    }
+  // weighted rendezvous hashing: each AMF draws a pseudo-random
+  // u in (0,1) from the IMSI and scores -capacity / log (u), so that
+  // the highest score goes to each AMF with a probability proportional
+  // to its capacity, whatever the eNB which selects it
+  double bestScore = -1;
+  for (std::map<uint16_t, uint8_t>::const_iterator it = m_amfCapacityMap.begin ();
+       it != m_amfCapacityMap.end ();
+       ++it)
+    {
+      uint64_t key[2] = { imsi, it->first };
+      double u = (Hash32 (reinterpret_cast<const char *> (key), sizeof (key)) + 1.0) / 4294967297.0;
+      double score = -it->second / std::log (u);
+      if (score > bestScore)
+        {
+          bestScore = score;
+          amfId = it->first;
+        }
+    }
+  return amfId;
 }
 
-/* jhlim: In 5G, one of AMFs is selected.
-		 But in lena, only one AMF is registered by Enb  */
+/* jhlim: In 5G, one of AMFs is selected. */
 void 
 NgcEnbApplication::DoRegistrationRequest (uint64_t imsi, uint16_t rnti)
 {
@@ -184,17 +251,18 @@ NgcEnbApplication::DoRegistrationRequest (uint64_t imsi, uint16_t rnti)
   // side effect: create entry if not exist
   m_imsiRntiMap[imsi] = rnti;
 
-  /* jhlim: 2. AMF Selection */
-  if(m_n2apSapEnbProvider == NULL)
-	  m_n2apSapAmf = DoAmfSelection(imsi);
-	  
   /* jhlim: forwards the Registration Request to an AMF */
 
   if(m_n2apSapEnbProvider == NULL)
 	  m_n2apSapAmf->RegistrationRequest (imsi, rnti, imsi, m_cellId);
   else
-	  m_n2apSapEnbProvider->SendRegistrationRequest (imsi, rnti, imsi, m_cellId); // TODO if more than one AMF is used, extend this call
-
+    {
+      /* jhlim: 2. AMF Selection */
+      UeAmfContext &ctx = GetUeAmfContext (imsi);
+      ctx.amfId = DoAmfSelection (imsi);
+      NS_LOG_INFO ("IMSI " << imsi << " in cell " << m_cellId << " selects AMF " << ctx.amfId);
+      m_n2apSapEnbProvider->SendRegistrationRequest (imsi, rnti, imsi, m_cellId, ctx.amfId);
+    }
 }
 
 // jhlim
@@ -233,6 +301,12 @@ NgcEnbApplication::DoPathSwitchRequest (NgcEnbN2SapProvider::PathSwitchRequestPa
   // side effect: create entry if not exist
   m_imsiRntiMap[imsi] = params.rnti;
 
+  // the UE comes in connected to the AMF which the source eNB selected,
+  // which the weighted selection gives again
+  UeAmfContext &ctx = GetUeAmfContext (imsi);
+  ctx.amfId = DoAmfSelection (imsi);
+  ctx.cmState = CM_CONNECTED;
+
   uint16_t gci = params.cellId;
   std::list<NgcN2apSapAmf::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList;
   for (std::list<NgcEnbN2SapProvider::BearerToBeSwitched>::iterator bit = params.bearersToBeSwitched.begin ();
@@ -246,8 +320,9 @@ NgcEnbApplication::DoPathSwitchRequest (NgcEnbN2SapProvider::PathSwitchRequestPa
       
       EpsFlowId_t rbid (params.rnti, bit->epsBearerId);
       // side effect: create entries if not exist
-      m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
+      m_rbidTeidMap[GetRbidKey (params.rnti, bit->epsBearerId)] = teid;
       m_teidRbidMap[teid] = rbid;
+      m_teidUpfAddressMap[teid] = bit->transportLayerAddress;
 
       NgcN2apSapAmf::ErabSwitchedInDownlinkItem erab;
       erab.erabId = bit->epsBearerId;
@@ -256,7 +331,7 @@ NgcEnbApplication::DoPathSwitchRequest (NgcEnbN2SapProvider::PathSwitchRequestPa
 
       erabToBeSwitchedInDownlinkList.push_back (erab);
     }
-  m_n2apSapEnbProvider->SendPathSwitchRequest (enbUeN2Id, amfUeN2Id, gci, erabToBeSwitchedInDownlinkList);
+  m_n2apSapEnbProvider->SendPathSwitchRequest (enbUeN2Id, amfUeN2Id, gci, erabToBeSwitchedInDownlinkList, ctx.amfId);
 }
 
 /* jhlim */
@@ -284,7 +359,7 @@ NgcEnbApplication::DoPathSwitchRequest (NgcEnbN2SapProvider::PathSwitchRequestPa
       
       EpsFlowId_t rbid (params.rnti, bit->epsBearerId);
       // side effect: create entries if not exist
-      m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
+      m_rbidTeidMap[GetRbidKey (params.rnti, bit->epsBearerId)] = teid;
       m_teidRbidMap[teid] = rbid;
 
       NgcN2apSapAmf::ErabSwitchedInDownlinkItem erab;
@@ -301,17 +376,28 @@ void
 NgcEnbApplication::DoUeContextRelease (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << rnti);
-  std::map<uint16_t, std::map<uint8_t, uint32_t> >::iterator rntiIt = m_rbidTeidMap.find (rnti);
-  if (rntiIt != m_rbidTeidMap.end ())
+  for (uint8_t bid = 0; bid < 16; ++bid)
+    {
+      uint32_t *teid = m_rbidTeidMap.Find (GetRbidKey (rnti, bid));
+      if (teid != 0)
+        {
+          m_teidRbidMap.Erase (*teid);
+          m_teidUpfAddressMap.Erase (*teid);
+          m_rbidTeidMap.Erase (GetRbidKey (rnti, bid));
+        }
+    }
+  for (std::map<uint64_t, uint16_t>::iterator imsiIt = m_imsiRntiMap.begin ();
+       imsiIt != m_imsiRntiMap.end ();
+       ++imsiIt)
     {
-      for (std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.begin ();
-           bidIt != rntiIt->second.end ();
-           ++bidIt)
+      if (imsiIt->second == rnti)
         {
-          uint32_t teid = bidIt->second;
-          m_teidRbidMap.erase (teid);
+          std::map<uint64_t, UeAmfContext>::iterator ctxIt = m_ueAmfContextMap.find (imsiIt->first);
+          if (ctxIt != m_ueAmfContextMap.end ())
+            {
+              ctxIt->second.cmState = CM_IDLE;
+            }
         }
-      m_rbidTeidMap.erase (rntiIt);
     }
 }
 
@@ -336,12 +422,14 @@ NgcEnbApplication::DoInitialContextSetupRequest (uint64_t amfUeN2Id, uint16_t en
       params.bearer = erabIt->erabLevelQosParameters;
       params.bearerId = erabIt->erabId;
       params.gtpTeid = erabIt->smfTeid;
+      params.transportLayerAddress = erabIt->transportLayerAddress;
       m_n2SapUser->DataRadioBearerSetupRequest (params);
 
       EpsFlowId_t rbid (rnti, erabIt->erabId);
       // side effect: create entries if not exist
-      m_rbidTeidMap[rnti][erabIt->erabId] = params.gtpTeid;
+      m_rbidTeidMap[GetRbidKey (rnti, erabIt->erabId)] = params.gtpTeid;
       m_teidRbidMap[params.gtpTeid] = rbid;
+      m_teidUpfAddressMap[params.gtpTeid] = erabIt->transportLayerAddress;
 
     }
 }
@@ -369,10 +457,37 @@ NgcEnbApplication::DoRegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id,
   uint64_t imsi = amfUeN2Id;
   std::map<uint64_t, uint16_t>::iterator imsiIt = m_imsiRntiMap.find (imsi);
   uint16_t rnti = imsiIt->second;
+
+  // the UE is now registered with, and connected to, the AMF of its GUTI
+  UeAmfContext &ctx = GetUeAmfContext (imsi);
+  ctx.guti = guti;
+  ctx.cmState = CM_CONNECTED;
+  if (NgcN2apSap::GetGutiAmfId (guti) != 0)
+    {
+      ctx.amfId = NgcN2apSap::GetGutiAmfId (guti);
+    }
+
   struct NgcEnbN2SapUser::RegistrationAcceptParameters params;
   params.rnti = rnti;
+  params.guti = guti;
   m_n2SapUser->RegistrationAccept(params);
 }
+void
+NgcEnbApplication::DoRegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint8_t cause, Time t3346)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id << (uint32_t) cause << t3346);
+
+  uint64_t imsi = amfUeN2Id;
+  std::map<uint64_t, uint16_t>::iterator imsiIt = m_imsiRntiMap.find (imsi);
+  NS_ASSERT_MSG (imsiIt != m_imsiRntiMap.end (), "unknown IMSI");
+
+  // the UE stays deregistered and keeps the AMF selected for it
+  struct NgcEnbN2SapUser::RegistrationRejectParameters params;
+  params.rnti = imsiIt->second;
+  params.cause = cause;
+  params.t3346 = t3346;
+  m_n2SapUser->RegistrationReject (params);
+}
 void 
 NgcEnbApplication::DoPathSwitchRequestAcknowledge (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<NgcN2apSapEnb::ErabSwitchedInUplinkItem> erabToBeSwitchedInUplinkList)
 {
@@ -387,6 +502,14 @@ NgcEnbApplication::DoPathSwitchRequestAcknowledge (uint64_t enbUeN2Id, uint64_t
   m_n2SapUser->PathSwitchRequestAcknowledge (params);
 }
 
+uint32_t
+NgcEnbApplication::GetRbidKey (uint16_t rnti, uint8_t bid)
+{
+  // the EPS bearer identity has 4 bits, see 3GPP TS 24.007 section 11.2.3.1.5
+  NS_ASSERT_MSG (bid < 16, "invalid EPS bearer identity " << (uint32_t) bid);
+  return (static_cast<uint32_t> (rnti) << 4) | bid;
+}
+
 void 
 NgcEnbApplication::RecvFromNrSocket (Ptr<Socket> socket)
 {
@@ -405,26 +528,21 @@ NgcEnbApplication::RecvFromNrSocket (Ptr<Socket> socket)
   uint16_t rnti = tag.GetRnti ();
   uint8_t bid = tag.GetBid ();
   NS_LOG_LOGIC ("received packet with RNTI=" << (uint32_t) rnti << ", BID=" << (uint32_t)  bid);
-  std::map<uint16_t, std::map<uint8_t, uint32_t> >::iterator rntiIt = m_rbidTeidMap.find (rnti);
-  if (rntiIt == m_rbidTeidMap.end ())
+  uint32_t *teid = m_rbidTeidMap.Find (GetRbidKey (rnti, bid));
+  if (teid == 0)
     {
       NS_LOG_WARN ("UE context not found, discarding packet when receiving from nrSocket");
     }
   else
     {
-      std::map<uint8_t, uint32_t>::iterator bidIt = rntiIt->second.find (bid);
-      NS_ASSERT (bidIt != rntiIt->second.end ());
-      uint32_t teid = bidIt->second;
-      SendToN2uSocket (packet, teid);
+      SendToN2uTunnel (packet, *teid);
     }
 }
 
 void 
-NgcEnbApplication::RecvFromN2uSocket (Ptr<Socket> socket)
+NgcEnbApplication::RecvFromN2uTunnel (Ptr<Packet> packet)
 {
-  NS_LOG_FUNCTION (this << socket);  
-  NS_ASSERT (socket == m_n2uSocket);
-  Ptr<Packet> packet = socket->Recv ();
+  NS_LOG_FUNCTION (this << packet);
   NrGtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
   uint32_t teid = gtpu.GetTeid ();
@@ -434,15 +552,15 @@ NgcEnbApplication::RecvFromN2uSocket (Ptr<Socket> socket)
   //SocketAddressTag tag;
   //packet->RemovePacketTag (tag);
 
-  std::map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
-  if (it != m_teidRbidMap.end ())
+  EpsFlowId_t *rbid = m_teidRbidMap.Find (teid);
+  if (rbid != 0)
     {
-      SendToNrSocket (packet, it->second.m_rnti, it->second.m_bid);
+      SendToNrSocket (packet, rbid->m_rnti, rbid->m_bid);
     }
   else
     {
       packet = 0;
-      NS_LOG_DEBUG("UE context not found, discarding packet when receiving from n2uSocket");
+      NS_LOG_DEBUG("UE context not found, discarding packet when receiving from the N2-U tunnel");
     }  
 }
 
@@ -458,17 +576,21 @@ NgcEnbApplication::SendToNrSocket (Ptr<Packet> packet, uint16_t rnti, uint8_t bi
 
 
 void 
-NgcEnbApplication::SendToN2uSocket (Ptr<Packet> packet, uint32_t teid)
+NgcEnbApplication::SendToN2uTunnel (Ptr<Packet> packet, uint32_t teid)
 {
   NS_LOG_FUNCTION (this << packet << teid <<  packet->GetSize ());  
+  Ipv4Address upfAddress = m_smfN2uAddress;
+  const Ipv4Address *tunnelUpfAddress = m_teidUpfAddressMap.Find (teid);
+  if (tunnelUpfAddress != 0)
+    {
+      upfAddress = *tunnelUpfAddress;
+    }
   NrGtpuHeader gtpu;
   gtpu.SetTeid (teid);
   // From 3GPP TS 29.281 v10.0.0 Section 5.1
   // Length of the payload + the non obligatory GTP-U header
-  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);  
-  packet->AddHeader (gtpu);
-  uint32_t flags = 0;
-  m_n2uSocket->SendTo (packet, flags, InetSocketAddress (m_smfN2uAddress, m_gtpuUdpPort));
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  m_n2uTunnel->Send (packet, gtpu, upfAddress);
 }
 
 void
@@ -38,6 +38,8 @@
 #include <ns3/eps-bearer.h>
 #include <ns3/ngc-enb-n2-sap.h>
 #include <ns3/ngc-n2ap-sap.h>
+#include <ns3/flat-hash-map.h>
+#include <ns3/udp-tunnel-endpoint.h>
 #include <map>
 
 namespace ns3 {
@@ -113,6 +115,36 @@ public:
    * \return the ENB side of the N2-AP SAP 
    */
   NgcN2apSapEnb* GetN2apSapEnb ();
+
+  /**
+   * Add an AMF to the AMF set served by this eNB. The N2-AP endpoint of
+   * the eNB must have an interface to the AMF.
+   *
+   * \param amfId the identifier of the AMF in its set
+   * \param relativeCapacity the weight of the AMF in the AMF selection
+   */
+  void AddAmf (uint16_t amfId, uint8_t relativeCapacity);
+
+  /**
+   * Connection management state of a UE, see 3GPP TS 23.501 section 5.3.3
+   */
+  enum CmState
+  {
+    CM_IDLE,
+    CM_CONNECTED
+  };
+
+  /**
+   * \param imsi the IMSI of the UE
+   * \return the CM state of the UE towards the AMF set, as seen by this eNB
+   */
+  CmState GetCmState (uint64_t imsi) const;
+
+  /**
+   * \param imsi the IMSI of the UE
+   * \return the AMF serving the UE, 0 if the eNB did not select one yet
+   */
+  uint16_t GetUeAmfId (uint64_t imsi) const;
  
   /** 
    * Method to be assigned to the recv callback of the NR socket. It is called when the eNB receives a data packet from the radio interface that is to be forwarded to the SMF.
@@ -123,11 +155,11 @@ public:
 
 
   /** 
-   * Method to be assigned to the recv callback of the N2-U socket. It is called when the eNB receives a data packet from the SMF that is to be forwarded to the UE.
+   * Method to be assigned to the recv callback of the N2-U tunnel endpoint. It is called when the eNB receives a data packet from the UPF that is to be forwarded to the UE.
    * 
-   * \param socket pointer to the N2-U socket
+   * \param packet the packet, starting with its GTP-U header
    */
-  void RecvFromN2uSocket (Ptr<Socket> socket);
+  void RecvFromN2uTunnel (Ptr<Packet> packet);
 
 
   struct EpsFlowId_t
@@ -152,6 +184,7 @@ private:
   void DoIdentityRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
   void DoIdentityResponse (uint64_t imsi, uint16_t rnti);
   void DoRegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t guti);
+  void DoRegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint8_t cause, Time t3346);
   void DoRegistrationComplete (uint64_t imsi, uint16_t rnti);
   void DoPathSwitchRequest (NgcEnbN2SapProvider::PathSwitchRequestParameters params);
   void DoUeContextRelease (uint16_t rnti);
@@ -187,7 +220,7 @@ private:
    * \param packet packet to be sent
    * \param teid the Tunnel Enpoint IDentifier
    */
-  void SendToN2uSocket (Ptr<Packet> packet, uint32_t teid);
+  void SendToN2uTunnel (Ptr<Packet> packet, uint32_t teid);
 
 
   
@@ -206,9 +239,9 @@ private:
   Ptr<Socket> m_nrSocket;
 
   /**
-   * UDP socket to send and receive GTP-U the packets to and from the N2-U interface
+   * GTP-U tunnel endpoint to send and receive the packets to and from the N2-U interface
    */
-  Ptr<Socket> m_n2uSocket;
+  Ptr<UdpTunnelEndpoint> m_n2uTunnel;
 
   /**
    * address of the eNB for N2-U communications
@@ -221,22 +254,30 @@ private:
   Ipv4Address m_smfN2uAddress;
 
   /**
-   * map of maps telling for each RNTI and BID the corresponding  N2-U TEID
-   * 
+   * \param rnti the RNTI of a UE
+   * \param bid the EPS bearer identity of a bearer of the UE
+   * \return the key of the bearer in m_rbidTeidMap
    */
-  std::map<uint16_t, std::map<uint8_t, uint32_t> > m_rbidTeidMap;  
+  static uint32_t GetRbidKey (uint16_t rnti, uint8_t bid);
 
   /**
-   * map telling for each N2-U TEID the corresponding RNTI,BID
-   * 
+   * map telling for each N2-U TEID the address of the UPF which
+   * terminates the tunnel, when it is not m_smfN2uAddress
    */
-  std::map<uint32_t, EpsFlowId_t> m_teidRbidMap;
- 
+  FlatHashMap<Ipv4Address> m_teidUpfAddressMap;
+
   /**
-   * UDP port to be used for GTP
+   * map telling for each RNTI and BID, keyed by GetRbidKey(), the
+   * corresponding N2-U TEID
    */
-  uint16_t m_gtpuUdpPort;
+  FlatHashMap<uint32_t> m_rbidTeidMap;
 
+  /**
+   * map telling for each N2-U TEID the corresponding RNTI,BID
+   * 
+   */
+  FlatHashMap<EpsFlowId_t> m_teidRbidMap;
+ 
   /**
    * Provider for the N2 SAP 
    */
@@ -270,13 +311,52 @@ private:
 
   uint16_t m_cellId;
 
-  // jhlim
-  bool is5gGuti(uint64_t imsi);
-  std::string GetCmState(uint64_t imsi);
-  NgcN2apSapAmf* GetUeConnectedAmf(uint64_t imsi);
-  NgcN2apSapAmf* DoAmfSelection(uint64_t imsi);
+  /**
+   * \param imsi the IMSI of the UE
+   * \return the AMF given by the 5G-GUTI of the UE, or the AMF last
+   * selected for the UE, if it belongs to the AMF set of this eNB;
+   * 0 otherwise
+   */
+  uint16_t GetUeConnectedAmf (uint64_t imsi) const;
 
+  /**
+   * Select the AMF of a UE, see 3GPP TS 23.501 section 6.3.5: the AMF
+   * the UE is connected to or registered with, otherwise an AMF of the
+   * set, weighted by its relative capacity. The weighted selection is
+   * a rendezvous hash of the IMSI, so that every eNB of the set gives
+   * the same AMF to a UE.
+   *
+   * \param imsi the IMSI of the UE
+   * \return the identifier of the AMF, 0 for the AMF the N2-AP
+   * endpoint was created with if the eNB has no AMF set
+   */
+  uint16_t DoAmfSelection (uint64_t imsi) const;
 
+  /**
+   * AMF related context of a UE
+   */
+  struct UeAmfContext
+  {
+    CmState cmState;
+    uint16_t amfId;
+    uint64_t guti;
+  };
+
+  /**
+   * \param imsi the IMSI of the UE
+   * \return the AMF context of the UE, created in CM_IDLE if it does not exist
+   */
+  UeAmfContext & GetUeAmfContext (uint64_t imsi);
+
+  /**
+   * AMF context of each UE, indexed by IMSI
+   */
+  std::map<uint64_t, UeAmfContext> m_ueAmfContextMap;
+
+  /**
+   * relative capacity of each AMF of the AMF set, indexed by AMF id
+   */
+  std::map<uint16_t, uint8_t> m_amfCapacityMap;
 
 
 };
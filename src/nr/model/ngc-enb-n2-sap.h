@@ -25,6 +25,7 @@
 #include <stdint.h>
 #include <ns3/eps-bearer.h>
 #include <ns3/ipv4-address.h>
+#include <ns3/nstime.h>
 
 using namespace std;
 
@@ -68,6 +69,7 @@ public:
   {
     uint8_t epsBearerId;
     uint32_t teid;
+    Ipv4Address transportLayerAddress; /**< IP Address of the UPF, see 36.423 9.2.1 */
   };
   
   struct PathSwitchRequestParameters
@@ -130,6 +132,12 @@ public:
     uint16_t rnti;
 	uint64_t guti;
   };
+  struct RegistrationRejectParameters
+  {
+    uint16_t rnti;   /**< the RNTI of the UE */
+    uint8_t cause;   /**< the 5GMM cause */
+    Time t3346;      /**< the back-off time of the UE, zero for none */
+  };
 
   /**
    * request the setup of a DataRadioBearer
@@ -140,6 +148,7 @@ public:
   //jhlim
   virtual void IdentityRequest (IdentityRequestParameters params) = 0;
   virtual void RegistrationAccept (RegistrationAcceptParameters params) = 0;
+  virtual void RegistrationReject (RegistrationRejectParameters params) = 0;
 
   
   struct PathSwitchRequestAcknowledgeParameters
@@ -195,7 +204,6 @@ MemberNgcEnbN2SapProvider<C>::MemberNgcEnbN2SapProvider ()
 template <class C>
 void MemberNgcEnbN2SapProvider<C>::RegistrationRequest (uint64_t imsi, uint16_t rnti)
 {
-  cout<<"DoRegistrationRequest for Provider is called" << endl;
   m_owner->DoRegistrationRequest (imsi, rnti);
 }
 // jhlim
@@ -262,6 +270,7 @@ public:
   // jhlim
   virtual void IdentityRequest (IdentityRequestParameters params);
   virtual void RegistrationAccept (RegistrationAcceptParameters params);
+  virtual void RegistrationReject (RegistrationRejectParameters params);
 
 private:
   MemberNgcEnbN2SapUser ();
@@ -296,6 +305,11 @@ void MemberNgcEnbN2SapUser<C>::RegistrationAccept (RegistrationAcceptParameters
   m_owner->DoRegistrationAccept (params);
 }
 template <class C>
+void MemberNgcEnbN2SapUser<C>::RegistrationReject (RegistrationRejectParameters params)
+{
+  m_owner->DoRegistrationReject (params);
+}
+template <class C>
 void MemberNgcEnbN2SapUser<C>::PathSwitchRequestAcknowledge (PathSwitchRequestAcknowledgeParameters params)
 {
   m_owner->DoPathSwitchRequestAcknowledge (params);
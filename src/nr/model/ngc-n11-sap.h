@@ -174,6 +174,7 @@ public:
     uint64_t imsi; 
     Uli uli; 
     std::list<BearerContextToBeCreated> bearerContextsToBeCreated;    
+    uint16_t amfId; ///< AMF of the AMF set which sends the request
   };
 
   /** 
@@ -194,6 +195,7 @@ public:
   struct DeleteBearerCommandMessage : public GtpcMessage
   {
     std::list<BearerContextToBeRemoved> bearerContextsToBeRemoved;
+    uint16_t amfId; ///< AMF of the AMF set which sends the command
   };
 
   /**
@@ -227,6 +229,7 @@ public:
   struct ModifyBearerRequestMessage : public GtpcMessage
   {
     Uli uli;
+    uint16_t amfId; ///< AMF of the AMF set which sends the request
   };
 
   /** 
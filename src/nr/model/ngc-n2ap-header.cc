@@ -1311,4 +1311,357 @@ NgcN2APPathSwitchRequestAcknowledgeHeader::GetNumberOfIes () const
 
 /////////////////////////////////////////////////////////////////////
 
+NS_OBJECT_ENSURE_REGISTERED (NgcN2APRegistrationAccept);
+
+NgcN2APRegistrationAccept::NgcN2APRegistrationAccept ()
+  : m_numberOfIes (1 + 1 + 1 + 1),
+    m_headerLength (9 + 3 + 3 + 9),
+    m_enbUeN2Id (0xfffa),
+    m_ecgi (0xfffa),
+    m_amfUeN2Id (0xfffffffa),
+    m_guti (0)
+{
+}
+
+NgcN2APRegistrationAccept::~NgcN2APRegistrationAccept ()
+{
+  m_numberOfIes = 0;
+  m_headerLength = 0;
+  m_enbUeN2Id = 0xfffb;
+  m_ecgi = 0xfffb;
+  m_amfUeN2Id = 0xfffffffb;
+  m_guti = 0;
+}
+
+TypeId
+NgcN2APRegistrationAccept::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NgcN2APRegistrationAccept")
+    .SetParent<Header> ()
+    .SetGroupName("Nr")
+    .AddConstructor<NgcN2APRegistrationAccept> ()
+  ;
+  return tid;
+}
+
+TypeId
+NgcN2APRegistrationAccept::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+NgcN2APRegistrationAccept::GetSerializedSize (void) const
+{
+  return m_headerLength;
+}
+
+void
+NgcN2APRegistrationAccept::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteU64 (m_amfUeN2Id);         // amfUeN2Id
+  i.WriteU8 (0);                    // criticality = REJECT
+
+  i.WriteHtonU16 (m_enbUeN2Id);     // m_enbUeN2Id
+  i.WriteU8 (0);                    // criticality = REJECT
+
+  i.WriteHtonU16 (m_ecgi);          // E-UTRAN CGI, it should have a different size
+  i.WriteU8 (1 << 6);               // criticality = IGNORE
+
+  i.WriteU64 (m_guti);              // 5G-GUTI, in the NAS PDU in the standard
+  i.WriteU8 (0);                    // criticality = REJECT
+}
+
+uint32_t
+NgcN2APRegistrationAccept::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  m_headerLength = 0;
+  m_numberOfIes = 0;
+
+  m_amfUeN2Id = i.ReadU64 ();
+  i.ReadU8 ();
+  m_headerLength += 9;
+  m_numberOfIes++;
+
+  m_enbUeN2Id = i.ReadNtohU16 ();
+  i.ReadU8 ();
+  m_headerLength += 3;
+  m_numberOfIes++;
+
+  m_ecgi = i.ReadNtohU16 ();
+  i.ReadU8 ();
+  m_headerLength += 3;
+  m_numberOfIes++;
+
+  m_guti = i.ReadU64 ();
+  i.ReadU8 ();
+  m_headerLength += 9;
+  m_numberOfIes++;
+
+  return GetSerializedSize ();
+}
+
+void
+NgcN2APRegistrationAccept::Print (std::ostream &os) const
+{
+  os << "AmfUeN2apId = " << m_amfUeN2Id;
+  os << " EnbUeN2Id = " << m_enbUeN2Id;
+  os << " ECGI = " << m_ecgi;
+  os << " 5G-GUTI = " << m_guti;
+}
+
+uint64_t
+NgcN2APRegistrationAccept::GetAmfUeN2Id () const
+{
+  return m_amfUeN2Id;
+}
+
+void
+NgcN2APRegistrationAccept::SetAmfUeN2Id (uint64_t amfUeN2Id)
+{
+  m_amfUeN2Id = amfUeN2Id;
+}
+
+uint16_t
+NgcN2APRegistrationAccept::GetEnbUeN2Id () const
+{
+  return m_enbUeN2Id;
+}
+
+void
+NgcN2APRegistrationAccept::SetEnbUeN2Id (uint16_t enbUeN2Id)
+{
+  m_enbUeN2Id = enbUeN2Id;
+}
+
+uint16_t
+NgcN2APRegistrationAccept::GetEcgi () const
+{
+  return m_ecgi;
+}
+
+void
+NgcN2APRegistrationAccept::SetEcgi (uint16_t ecgi)
+{
+  m_ecgi = ecgi;
+}
+
+uint64_t
+NgcN2APRegistrationAccept::GetGuti () const
+{
+  return m_guti;
+}
+
+void
+NgcN2APRegistrationAccept::SetGuti (uint64_t guti)
+{
+  m_guti = guti;
+}
+
+uint32_t
+NgcN2APRegistrationAccept::GetLengthOfIes () const
+{
+  return m_headerLength;
+}
+
+uint32_t
+NgcN2APRegistrationAccept::GetNumberOfIes () const
+{
+  return m_numberOfIes;
+}
+
+/////////////////////////////////////////////////////////////////////
+
+NS_OBJECT_ENSURE_REGISTERED (NgcN2APRegistrationReject);
+
+NgcN2APRegistrationReject::NgcN2APRegistrationReject ()
+  : m_numberOfIes (1 + 1 + 1 + 1 + 1),
+    m_headerLength (9 + 3 + 3 + 2 + 5),
+    m_enbUeN2Id (0xfffa),
+    m_ecgi (0xfffa),
+    m_amfUeN2Id (0xfffffffa),
+    m_cause (0),
+    m_t3346 (0)
+{
+}
+
+NgcN2APRegistrationReject::~NgcN2APRegistrationReject ()
+{
+  m_numberOfIes = 0;
+  m_headerLength = 0;
+  m_enbUeN2Id = 0xfffb;
+  m_ecgi = 0xfffb;
+  m_amfUeN2Id = 0xfffffffb;
+  m_cause = 0;
+  m_t3346 = 0;
+}
+
+TypeId
+NgcN2APRegistrationReject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NgcN2APRegistrationReject")
+    .SetParent<Header> ()
+    .SetGroupName("Nr")
+    .AddConstructor<NgcN2APRegistrationReject> ()
+  ;
+  return tid;
+}
+
+TypeId
+NgcN2APRegistrationReject::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+NgcN2APRegistrationReject::GetSerializedSize (void) const
+{
+  return m_headerLength;
+}
+
+void
+NgcN2APRegistrationReject::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+
+  i.WriteU64 (m_amfUeN2Id);         // amfUeN2Id
+  i.WriteU8 (0);                    // criticality = REJECT
+
+  i.WriteHtonU16 (m_enbUeN2Id);     // m_enbUeN2Id
+  i.WriteU8 (0);                    // criticality = REJECT
+
+  i.WriteHtonU16 (m_ecgi);          // E-UTRAN CGI, it should have a different size
+  i.WriteU8 (1 << 6);               // criticality = IGNORE
+
+  i.WriteU8 (m_cause);              // 5GMM cause, in the NAS PDU in the standard
+  i.WriteU8 (0);                    // criticality = REJECT
+
+  i.WriteHtonU32 (m_t3346);         // T3346 value, a GPRS timer 2 in the standard
+  i.WriteU8 (1 << 6);               // criticality = IGNORE
+}
+
+uint32_t
+NgcN2APRegistrationReject::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+
+  m_headerLength = 0;
+  m_numberOfIes = 0;
+
+  m_amfUeN2Id = i.ReadU64 ();
+  i.ReadU8 ();
+  m_headerLength += 9;
+  m_numberOfIes++;
+
+  m_enbUeN2Id = i.ReadNtohU16 ();
+  i.ReadU8 ();
+  m_headerLength += 3;
+  m_numberOfIes++;
+
+  m_ecgi = i.ReadNtohU16 ();
+  i.ReadU8 ();
+  m_headerLength += 3;
+  m_numberOfIes++;
+
+  m_cause = i.ReadU8 ();
+  i.ReadU8 ();
+  m_headerLength += 2;
+  m_numberOfIes++;
+
+  m_t3346 = i.ReadNtohU32 ();
+  i.ReadU8 ();
+  m_headerLength += 5;
+  m_numberOfIes++;
+
+  return GetSerializedSize ();
+}
+
+void
+NgcN2APRegistrationReject::Print (std::ostream &os) const
+{
+  os << "AmfUeN2apId = " << m_amfUeN2Id;
+  os << " EnbUeN2Id = " << m_enbUeN2Id;
+  os << " ECGI = " << m_ecgi;
+  os << " 5GMM cause = " << (uint32_t) m_cause;
+  os << " T3346 = " << m_t3346 << " ms";
+}
+
+uint64_t
+NgcN2APRegistrationReject::GetAmfUeN2Id () const
+{
+  return m_amfUeN2Id;
+}
+
+void
+NgcN2APRegistrationReject::SetAmfUeN2Id (uint64_t amfUeN2Id)
+{
+  m_amfUeN2Id = amfUeN2Id;
+}
+
+uint16_t
+NgcN2APRegistrationReject::GetEnbUeN2Id () const
+{
+  return m_enbUeN2Id;
+}
+
+void
+NgcN2APRegistrationReject::SetEnbUeN2Id (uint16_t enbUeN2Id)
+{
+  m_enbUeN2Id = enbUeN2Id;
+}
+
+uint16_t
+NgcN2APRegistrationReject::GetEcgi () const
+{
+  return m_ecgi;
+}
+
+void
+NgcN2APRegistrationReject::SetEcgi (uint16_t ecgi)
+{
+  m_ecgi = ecgi;
+}
+
+uint8_t
+NgcN2APRegistrationReject::GetCause () const
+{
+  return m_cause;
+}
+
+void
+NgcN2APRegistrationReject::SetCause (uint8_t cause)
+{
+  m_cause = cause;
+}
+
+uint32_t
+NgcN2APRegistrationReject::GetT3346 () const
+{
+  return m_t3346;
+}
+
+void
+NgcN2APRegistrationReject::SetT3346 (uint32_t t3346)
+{
+  m_t3346 = t3346;
+}
+
+uint32_t
+NgcN2APRegistrationReject::GetLengthOfIes () const
+{
+  return m_headerLength;
+}
+
+uint32_t
+NgcN2APRegistrationReject::GetNumberOfIes () const
+{
+  return m_numberOfIes;
+}
+
+/////////////////////////////////////////////////////////////////////
+
 }; // end of namespace ns3
@@ -62,7 +62,8 @@ public:
 	IdentityRequest = 77,
 	IdentityResponse = 78,
 	RegistrationAccept = 79,
-	RegistrationComplete = 80
+	RegistrationComplete = 80,
+	RegistrationReject = 81
   };
 
 
@@ -367,11 +368,11 @@ private:
   uint16_t          m_ecgi;
   uint64_t          m_amfUeN2Id;
 };
-class NgcN2APRegistrationAccept : public Header
+class NgcN2APRegistrationComplete : public Header
 {
 public:
-  NgcN2APRegistrationAccept ();
-  virtual ~NgcN2APRegistrationAccept ();
+  NgcN2APRegistrationComplete ();
+  virtual ~NgcN2APRegistrationComplete ();
 
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
@@ -404,11 +405,17 @@ private:
   uint64_t          m_amfUeN2Id;
   uint64_t			m_guti;
 };
-class NgcN2APRegistrationComplete : public Header
+*/
+
+/**
+ * N2AP Registration Accept, which carries the 5G-GUTI allocated to the
+ * UE by its AMF
+ */
+class NgcN2APRegistrationAccept : public Header
 {
 public:
-  NgcN2APRegistrationComplete ();
-  virtual ~NgcN2APRegistrationComplete ();
+  NgcN2APRegistrationAccept ();
+  virtual ~NgcN2APRegistrationAccept ();
 
   static TypeId GetTypeId (void);
   virtual TypeId GetInstanceTypeId (void) const;
@@ -427,7 +434,7 @@ public:
   uint16_t GetEcgi () const;
   void SetEcgi (uint16_t ecgi);
 
-  uint64_t GetGuti() const;
+  uint64_t GetGuti () const;
   void SetGuti (uint64_t guti);
 
   uint32_t GetLengthOfIes () const;
@@ -439,9 +446,57 @@ private:
   uint16_t          m_enbUeN2Id;
   uint16_t          m_ecgi;
   uint64_t          m_amfUeN2Id;
-  uint64_t			m_guti;
+  uint64_t          m_guti;
+};
+
+/**
+ * N2AP Registration Reject, which carries the 5GMM cause and the T3346
+ * back-off timer of an AMF in overload
+ */
+class NgcN2APRegistrationReject : public Header
+{
+public:
+  NgcN2APRegistrationReject ();
+  virtual ~NgcN2APRegistrationReject ();
+
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+
+  uint64_t GetAmfUeN2Id () const;
+  void SetAmfUeN2Id (uint64_t amfUeN2Id);
+
+  uint16_t GetEnbUeN2Id () const;
+  void SetEnbUeN2Id (uint16_t enbUeN2Id);
+
+  uint16_t GetEcgi () const;
+  void SetEcgi (uint16_t ecgi);
+
+  uint8_t GetCause () const;
+  void SetCause (uint8_t cause);
+
+  /**
+   * \return the T3346 value, in ms
+   */
+  uint32_t GetT3346 () const;
+  void SetT3346 (uint32_t t3346);
+
+  uint32_t GetLengthOfIes () const;
+  uint32_t GetNumberOfIes () const;
+
+private:
+  uint32_t          m_numberOfIes;
+  uint32_t          m_headerLength;
+  uint16_t          m_enbUeN2Id;
+  uint16_t          m_ecgi;
+  uint64_t          m_amfUeN2Id;
+  uint8_t           m_cause;
+  uint32_t          m_t3346;
 };
-*/
 
 
 }
@@ -26,4 +26,16 @@ NgcN2apSap::~NgcN2apSap ()
 {
 }
 
+uint64_t
+NgcN2apSap::MakeGuti (uint16_t amfId, uint32_t tmsi)
+{
+  return (static_cast<uint64_t> (amfId) << 32) | tmsi;
+}
+
+uint16_t
+NgcN2apSap::GetGutiAmfId (uint64_t guti)
+{
+  return (guti >> 32) & 0xffff;
+}
+
 } // namespace ns3
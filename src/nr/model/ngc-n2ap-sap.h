@@ -28,6 +28,7 @@
 #include <ns3/object.h>
 #include <ns3/eps-bearer.h>
 #include <ns3/ngc-tft.h>
+#include <ns3/nstime.h>
 #include <list>
 
 
@@ -38,6 +39,31 @@ class NgcN2apSap
 public:
   virtual ~NgcN2apSap ();
 
+  /**
+   * Build a 5G-GUTI, see 3GPP TS 23.003 section 2.10. The GUAMI is
+   * reduced here to the identifier of the AMF in its set, which takes
+   * bits 32 to 47, and the 5G-TMSI takes the 32 low bits.
+   *
+   * \param amfId the identifier of the AMF which allocated the GUTI
+   * \param tmsi the 5G-TMSI allocated by the AMF
+   * \return the 5G-GUTI
+   */
+  static uint64_t MakeGuti (uint16_t amfId, uint32_t tmsi);
+
+  /**
+   * \param guti a 5G-GUTI built by MakeGuti()
+   * \return the identifier of the AMF which allocated the GUTI
+   */
+  static uint16_t GetGutiAmfId (uint64_t guti);
+
+  /**
+   * 5GMM causes of a Registration Reject, see 3GPP TS 24.501 9.11.3.2
+   */
+  enum FiveGmmCause
+  {
+    CONGESTION = 22
+  };
+
   // useful structures as defined in 3GPP ts 36.413 
 
   /**
@@ -161,7 +187,11 @@ class NgcN2apSapEnbProvider : public NgcN2apSap
 {
 public: 
    
-  virtual void SendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t stmsi, uint16_t ecgi) = 0;
+  /**
+   * \param amfId the AMF selected by the eNB for the UE, or 0 for the
+   * AMF the N2-AP endpoint was created with
+   */
+  virtual void SendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t stmsi, uint16_t ecgi, uint16_t amfId) = 0;
 
   virtual void SendErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<ErabToBeReleasedIndication> erabToBeReleaseIndication ) = 0;
 
@@ -169,7 +199,11 @@ public:
                                             uint16_t enbUeN2Id,
                                             std::list<ErabSetupItem> erabSetupList) = 0;
 
-  virtual void SendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList) = 0;
+  /**
+   * \param amfId the AMF serving the UE, or 0 for the AMF the N2-AP
+   * endpoint was created with
+   */
+  virtual void SendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList, uint16_t amfId) = 0;
 
   // jhlim
   virtual void SendIdentityResponse (uint64_t amfUeN2Id,
@@ -211,6 +245,19 @@ public:
   								   uint16_t enbUeN2Id,
 								   uint64_t guti) = 0;
 
+  /**
+   * Registration Reject, carried in a DOWNLINK NAS TRANSPORT message
+   *
+   * \param amfUeN2Id the AMF UE N2 id
+   * \param enbUeN2Id the eNB UE N2 id
+   * \param cause the 5GMM cause
+   * \param t3346 the back-off time of the UE, zero for none
+   */
+  virtual void RegistrationReject (uint64_t amfUeN2Id,
+                                   uint16_t enbUeN2Id,
+                                   uint8_t cause,
+                                   Time t3346) = 0;
+
   /**
    * PATH SWITCH REQUEST ACKNOWLEDGE message, see 3GPP TS 36.413 9.1.5.9
    * 
@@ -248,6 +295,11 @@ public:
   								uint16_t enbUeN2Id,
 								uint16_t cellId,
 								uint64_t guti) = 0;
+  virtual void SendRegistrationReject (uint64_t amfUeN2Id,
+                                       uint16_t enbUeN2Id,
+                                       uint16_t cellId,
+                                       uint8_t cause,
+                                       Time t3346) = 0;
 };
 
 
@@ -298,7 +350,6 @@ MemberNgcN2apSapAmf<C>::MemberNgcN2apSapAmf ()
 template <class C>
 void MemberNgcN2apSapAmf<C>::RegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t ecgi)
 {
-  std::cout<<"RegistrationRequest(1,2,3,4) is called" << std::endl;
   m_owner->DoRegistrationRequest(amfUeN2Id, enbUeN2Id, imsi, ecgi);
 }
 
@@ -346,11 +397,11 @@ public:
   MemberNgcN2apSapEnbProvider (C* owner);
 
   // inherited from MemberNgcN2apSapEnbProvider
-  virtual void SendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t ecgi);
+  virtual void SendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t ecgi, uint16_t amfId);
   virtual void SendErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<ErabToBeReleasedIndication> erabToBeReleaseIndication );
 
   virtual void SendInitialContextSetupResponse (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<ErabSetupItem> erabSetupList);
-  virtual void SendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList);
+  virtual void SendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList, uint16_t amfId);
  //jhlim
   virtual void SendIdentityResponse (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
   virtual void SendRegistrationComplete (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
@@ -372,9 +423,9 @@ MemberNgcN2apSapEnbProvider<C>::MemberNgcN2apSapEnbProvider ()
 }
 
 template <class C>
-void MemberNgcN2apSapEnbProvider<C>::SendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t ecgi)
+void MemberNgcN2apSapEnbProvider<C>::SendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t imsi, uint16_t ecgi, uint16_t amfId)
 {
-  m_owner->DoSendRegistrationRequest (amfUeN2Id, enbUeN2Id, imsi, ecgi);
+  m_owner->DoSendRegistrationRequest (amfUeN2Id, enbUeN2Id, imsi, ecgi, amfId);
 }
 
 template <class C>
@@ -401,9 +452,9 @@ void MemberNgcN2apSapEnbProvider<C>::SendRegistrationComplete (uint64_t amfUeN2I
 }
 
 template <class C>
-void MemberNgcN2apSapEnbProvider<C>::SendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
+void MemberNgcN2apSapEnbProvider<C>::SendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList, uint16_t amfId)
 {
-  m_owner->DoSendPathSwitchRequest (enbUeN2Id, amfUeN2Id, cgi, erabToBeSwitchedInDownlinkList);
+  m_owner->DoSendPathSwitchRequest (enbUeN2Id, amfUeN2Id, cgi, erabToBeSwitchedInDownlinkList, amfId);
 }
 
 
@@ -425,6 +476,7 @@ public:
   // jhlim
   virtual void IdentityRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id);
   virtual void RegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t guti);
+  virtual void RegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint8_t cause, Time t3346);
 
 private:
   MemberNgcN2apSapEnb ();
@@ -459,6 +511,11 @@ void MemberNgcN2apSapEnb<C>::RegistrationAccept (uint64_t amfUeN2Id, uint16_t en
   m_owner->DoRegistrationAccept (amfUeN2Id, enbUeN2Id, guti);
 }
 template <class C>
+void MemberNgcN2apSapEnb<C>::RegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint8_t cause, Time t3346)
+{
+  m_owner->DoRegistrationReject (amfUeN2Id, enbUeN2Id, cause, t3346);
+}
+template <class C>
 void MemberNgcN2apSapEnb<C>::PathSwitchRequestAcknowledge (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<ErabSwitchedInUplinkItem> erabToBeSwitchedInUplinkList)
 {
   m_owner->DoPathSwitchRequestAcknowledge (enbUeN2Id, amfUeN2Id, cgi, erabToBeSwitchedInUplinkList);
@@ -482,6 +539,7 @@ public:
   // jhlim
   virtual void SendIdentityRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint16_t cellId, std::string identityRequest);
   virtual void SendRegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint16_t cellId, uint64_t guti);
+  virtual void SendRegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint16_t cellId, uint8_t cause, Time t3346);
   
 
 private:
@@ -514,7 +572,12 @@ void MemberNgcN2apSapAmfProvider<C>::SendIdentityRequest (uint64_t amfUeN2Id, ui
 template <class C>
 void MemberNgcN2apSapAmfProvider<C>::SendRegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint16_t cellId, uint64_t guti)
 {
-  m_owner->DoSendIdentityRequest (amfUeN2Id, enbUeN2Id, cellId);
+  m_owner->DoSendRegistrationAccept (amfUeN2Id, enbUeN2Id, cellId, guti);
+}
+template <class C>
+void MemberNgcN2apSapAmfProvider<C>::SendRegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint16_t cellId, uint8_t cause, Time t3346)
+{
+  m_owner->DoSendRegistrationReject (amfUeN2Id, enbUeN2Id, cellId, cause, t3346);
 }
 template <class C>
 void MemberNgcN2apSapAmfProvider<C>::SendPathSwitchRequestAcknowledge (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, std::list<ErabSwitchedInUplinkItem> erabToBeSwitchedInUplinkList)
@@ -100,6 +100,7 @@ NgcN2apEnb::DoDispose (void)
 
   m_n2apInterfaceSockets.clear ();
   m_n2apInterfaceCellIds.clear ();
+  m_amfIdByAmfUeN2Id.clear ();
   delete m_n2apSapProvider;
 }
 
@@ -138,10 +139,25 @@ NgcN2apEnb::AddN2apInterface (uint16_t enbId, Ipv4Address enbAddress,
 
   NS_ASSERT_MSG (m_n2apInterfaceSockets.find (amfId) == m_n2apInterfaceSockets.end (),
                  "Mapping for amfId = " << amfId << " is already known");
+  if (m_n2apInterfaceSockets.empty ())
+    {
+      m_amfId = amfId;
+    }
   m_n2apInterfaceSockets [amfId] = Create<N2apIfaceInfo> (amfAddress, localN2apSocket);
+}
 
-  // TODO m_amfId is initialized once since one amf is connected to this enb interface, consider when extending
-  m_amfId = amfId;
+Ptr<N2apIfaceInfo>
+NgcN2apEnb::GetAmfInterface (uint64_t amfUeN2Id)
+{
+  uint16_t amfId = m_amfId;
+  std::map<uint64_t, uint16_t>::const_iterator it = m_amfIdByAmfUeN2Id.find (amfUeN2Id);
+  if (it != m_amfIdByAmfUeN2Id.end ())
+    {
+      amfId = it->second;
+    }
+  std::map<uint16_t, Ptr<N2apIfaceInfo> >::const_iterator ifaceIt = m_n2apInterfaceSockets.find (amfId);
+  NS_ASSERT_MSG (ifaceIt != m_n2apInterfaceSockets.end (), "no N2-AP interface to AMF " << amfId);
+  return ifaceIt->second;
 }
 
 
@@ -216,7 +232,7 @@ NgcN2apEnb::RecvFromN2apSocket (Ptr<Socket> socket)
   else if (procedureCode == NgcN2APHeader::RegistrationAccept) /* jhlim: for signal 11. */
   {
 	NS_LOG_LOGIC ("Recv N2ap message: REGISTRATION ACCEPT ");
-	NgcN2APInitialContextSetupRequestHeader reqHeader;
+	NgcN2APRegistrationAccept reqHeader;
 	packet->RemoveHeader(reqHeader);
 
 	NS_LOG_INFO ("N2ap Registration Accept " << reqHeader);
@@ -231,6 +247,17 @@ NgcN2apEnb::RecvFromN2apSocket (Ptr<Socket> socket)
 
 	m_n2apSapUser->RegistrationAccept(amfUeN2apId, enbUeN2apId, guti);
   }
+  else if (procedureCode == NgcN2APHeader::RegistrationReject)
+  {
+    NS_LOG_LOGIC ("Recv N2ap message: REGISTRATION REJECT ");
+    NgcN2APRegistrationReject rejHeader;
+    packet->RemoveHeader (rejHeader);
+
+    NS_LOG_INFO ("N2ap Registration Reject " << rejHeader);
+
+    m_n2apSapUser->RegistrationReject (rejHeader.GetAmfUeN2Id (), rejHeader.GetEnbUeN2Id (),
+                                       rejHeader.GetCause (), MilliSeconds (rejHeader.GetT3346 ()));
+  }
   else
   {
     NS_ASSERT_MSG (false, "ProcedureCode NOT SUPPORTED!!!");
@@ -241,7 +268,7 @@ NgcN2apEnb::RecvFromN2apSocket (Ptr<Socket> socket)
 // Implementation of the N2ap SAP Provider
 //
 void
-NgcN2apEnb::DoSendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t stmsi, uint16_t ecgi) 
+NgcN2apEnb::DoSendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t stmsi, uint16_t ecgi, uint16_t amfId) 
 {
   NS_LOG_FUNCTION (this);
 
@@ -249,10 +276,13 @@ NgcN2apEnb::DoSendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, u
   NS_LOG_LOGIC("enbUeN2apId = " << enbUeN2Id);
   NS_LOG_LOGIC("stmsi = " << stmsi);
   NS_LOG_LOGIC("ecgi = " << ecgi);
+  NS_LOG_LOGIC("amfId = " << amfId);
 
-  // TODO check if an assert is needed
-
-  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [m_amfId]; // in case of multiple amf, extend the call
+  if (amfId != 0)
+    {
+      m_amfIdByAmfUeN2Id[amfUeN2Id] = amfId;
+    }
+  Ptr<N2apIfaceInfo> socketInfo = GetAmfInterface (amfUeN2Id);
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address amfIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -281,7 +311,6 @@ NgcN2apEnb::DoSendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, u
   NS_LOG_INFO ("packetLen = " << packet->GetSize ());
 
   // Send the N2ap message through the socket
-  std::cout << "Sends packet to " <<amfIpAddr << ":" <<m_n2apUdpPort << std::endl; // jhlim
   sourceSocket->SendTo (packet, 0, InetSocketAddress (amfIpAddr, m_n2apUdpPort));
 }
 
@@ -293,9 +322,7 @@ NgcN2apEnb::DoSendErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id,
   NS_LOG_LOGIC("amfUeN2apId = " << amfUeN2Id);
   NS_LOG_LOGIC("enbUeN2apId = " << enbUeN2Id);
 
-  // TODO check if an assert is needed
-
-  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [m_amfId]; // in case of multiple amf, extend the call
+  Ptr<N2apIfaceInfo> socketInfo = GetAmfInterface (amfUeN2Id);
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address amfIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -336,9 +363,7 @@ NgcN2apEnb::DoSendInitialContextSetupResponse (uint64_t amfUeN2Id,
   NS_LOG_LOGIC("amfUeN2apId = " << amfUeN2Id);
   NS_LOG_LOGIC("enbUeN2apId = " << enbUeN2Id);
 
-  // TODO check if an assert is needed
-
-  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [m_amfId]; // in case of multiple amf, extend the call
+  Ptr<N2apIfaceInfo> socketInfo = GetAmfInterface (amfUeN2Id);
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address amfIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -379,9 +404,7 @@ NgcN2apEnb::DoSendIdentityResponse (uint64_t amfUeN2Id,
   NS_LOG_LOGIC("amfUeN2apId = " << amfUeN2Id);
   NS_LOG_LOGIC("enbUeN2apId = " << enbUeN2Id);
 
-  // TODO check if an assert is needed
-
-  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [m_amfId]; // in case of multiple amf, extend the call
+  Ptr<N2apIfaceInfo> socketInfo = GetAmfInterface (amfUeN2Id);
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address amfIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -419,9 +442,7 @@ NgcN2apEnb::DoSendRegistrationComplete (uint64_t amfUeN2Id,
   NS_LOG_LOGIC("amfUeN2apId = " << amfUeN2Id);
   NS_LOG_LOGIC("enbUeN2apId = " << enbUeN2Id);
 
-  // TODO check if an assert is needed
-
-  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [m_amfId]; // in case of multiple amf, extend the call
+  Ptr<N2apIfaceInfo> socketInfo = GetAmfInterface (amfUeN2Id);
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address amfIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -453,17 +474,20 @@ NgcN2apEnb::DoSendRegistrationComplete (uint64_t amfUeN2Id,
 
 void 
 NgcN2apEnb::DoSendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, 
-            std::list<NgcN2apSap::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
+            std::list<NgcN2apSap::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList, uint16_t amfId)
 {
   NS_LOG_FUNCTION (this);
 
   NS_LOG_LOGIC("amfUeN2apId = " << amfUeN2Id);
   NS_LOG_LOGIC("enbUeN2apId = " << enbUeN2Id);
   NS_LOG_LOGIC("ecgi = " << gci);
+  NS_LOG_LOGIC("amfId = " << amfId);
 
-  // TODO check if an assert is needed
-
-  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [m_amfId]; // in case of multiple amf, extend the call
+  if (amfId != 0)
+    {
+      m_amfIdByAmfUeN2Id[amfUeN2Id] = amfId;
+    }
+  Ptr<N2apIfaceInfo> socketInfo = GetAmfInterface (amfUeN2Id);
   Ptr<Socket> sourceSocket = socketInfo->m_localCtrlPlaneSocket;
   Ipv4Address amfIpAddr = socketInfo->m_remoteIpAddr;
 
@@ -635,6 +659,25 @@ NgcN2apAmf::RecvFromN2apSocket (Ptr<Socket> socket)
 
     m_n2apSapUser->ErabReleaseIndication (amfUeN2Id, enbUeN2Id, erabToBeReleaseIndication);
   }
+  else if (procedureCode == NgcN2APHeader::IdentityResponse)
+  {
+    NS_LOG_LOGIC ("Recv N2ap message: IDENTITY RESPONSE " << Simulator::Now ().GetSeconds());
+    // the eNB sends the IEs of an Initial Context Setup Response
+    NgcN2APInitialContextSetupResponseHeader irHeader;
+    packet->RemoveHeader(irHeader);
+    NS_LOG_INFO ("N2ap Identity Response header " << irHeader);
+
+    m_n2apSapUser->IdentityResponse (irHeader.GetAmfUeN2Id (), irHeader.GetEnbUeN2Id ());
+  }
+  else if (procedureCode == NgcN2APHeader::RegistrationComplete)
+  {
+    NS_LOG_LOGIC ("Recv N2ap message: REGISTRATION COMPLETE " << Simulator::Now ().GetSeconds());
+    NgcN2APInitialContextSetupResponseHeader rcHeader;
+    packet->RemoveHeader(rcHeader);
+    NS_LOG_INFO ("N2ap Registration Complete header " << rcHeader);
+
+    m_n2apSapUser->RegistrationComplete (rcHeader.GetAmfUeN2Id (), rcHeader.GetEnbUeN2Id ());
+  }
   else
   {
     NS_ASSERT_MSG (false, "ProcedureCode NOT SUPPORTED!!!");
@@ -746,10 +789,12 @@ NgcN2apAmf::DoSendRegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id, ui
 
   NS_LOG_INFO ("Send N2ap message: REGISTRATION ACCEPT " << Simulator::Now ().GetSeconds());
 
-  NgcN2APInitialContextSetupRequestHeader reqHeader; // fix to RegistraionAcceptHeader
+  NgcN2APRegistrationAccept reqHeader;
   
   reqHeader.SetAmfUeN2Id(amfUeN2Id);
   reqHeader.SetEnbUeN2Id(enbUeN2Id);
+  reqHeader.SetEcgi(cellId);
+  reqHeader.SetGuti(guti);
   NS_LOG_INFO ("N2AP Registration Accept header " << reqHeader);
 
   NgcN2APHeader n2apHeader;
@@ -766,6 +811,39 @@ NgcN2apAmf::DoSendRegistrationAccept (uint64_t amfUeN2Id, uint16_t enbUeN2Id, ui
   // Send the N2ap message through the socket
   m_localN2APSocket->SendTo (packet, 0, InetSocketAddress (enbIpAddr, m_n2apUdpPort));
 }
+
+void
+NgcN2apAmf::DoSendRegistrationReject (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint16_t cellId, uint8_t cause, Time t3346)
+{
+  NS_LOG_FUNCTION (this << amfUeN2Id << enbUeN2Id << cellId << (uint32_t) cause << t3346);
+
+  NS_ASSERT_MSG (m_n2apInterfaceSockets.find (cellId) != m_n2apInterfaceSockets.end (),
+               "Missing infos for cellId = " << cellId);
+
+  Ptr<N2apIfaceInfo> socketInfo = m_n2apInterfaceSockets [cellId];
+  Ipv4Address enbIpAddr = socketInfo->m_remoteIpAddr;
+
+  NS_LOG_INFO ("Send N2ap message: REGISTRATION REJECT " << Simulator::Now ().GetSeconds());
+
+  NgcN2APRegistrationReject rejHeader;
+  rejHeader.SetAmfUeN2Id (amfUeN2Id);
+  rejHeader.SetEnbUeN2Id (enbUeN2Id);
+  rejHeader.SetEcgi (cellId);
+  rejHeader.SetCause (cause);
+  rejHeader.SetT3346 (t3346.GetMilliSeconds ());
+  NS_LOG_INFO ("N2AP Registration Reject header " << rejHeader);
+
+  NgcN2APHeader n2apHeader;
+  n2apHeader.SetProcedureCode (NgcN2APHeader::RegistrationReject);
+  n2apHeader.SetLengthOfIes (rejHeader.GetLengthOfIes ());
+  n2apHeader.SetNumberOfIes (rejHeader.GetNumberOfIes ());
+
+  Ptr<Packet> packet = Create <Packet> ();
+  packet->AddHeader (rejHeader);
+  packet->AddHeader (n2apHeader);
+
+  m_localN2APSocket->SendTo (packet, 0, InetSocketAddress (enbIpAddr, m_n2apUdpPort));
+}
   
 void 
 NgcN2apAmf::DoSendPathSwitchRequestAcknowledge (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t cgi, 
@@ -121,13 +121,12 @@ public:
 protected:
   // Interface provided by NgcN2apSapEnbProvider
   // jhlim
-  virtual void DoSendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t stmsi, uint16_t ecgi);
+  virtual void DoSendRegistrationRequest (uint64_t amfUeN2Id, uint16_t enbUeN2Id, uint64_t stmsi, uint16_t ecgi, uint16_t amfId);
   virtual void DoSendErabReleaseIndication (uint64_t amfUeN2Id, uint16_t enbUeN2Id, std::list<NgcN2apSap::ErabToBeReleasedIndication> erabToBeReleaseIndication );
   virtual void DoSendInitialContextSetupResponse (uint64_t amfUeN2Id,
                                                   uint16_t enbUeN2Id,
                                                   std::list<NgcN2apSap::ErabSetupItem> erabSetupList);
-  virtual void DoSendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<NgcN2apSap::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList)
-  ;
+  virtual void DoSendPathSwitchRequest (uint64_t enbUeN2Id, uint64_t amfUeN2Id, uint16_t gci, std::list<NgcN2apSap::ErabSwitchedInDownlinkItem> erabToBeSwitchedInDownlinkList, uint16_t amfId);
 
   // jhlim
   virtual void DoSendIdentityResponse (uint64_t amfUeN2Id,
@@ -140,6 +139,12 @@ protected:
 
 private:
 
+  /**
+   * \param amfUeN2Id the UE identifier on the AMF side
+   * \return the interface to the AMF serving the UE
+   */
+  Ptr<N2apIfaceInfo> GetAmfInterface (uint64_t amfUeN2Id);
+
   /**
    * Map the amfId to the corresponding (sourceSocket, remoteIpAddr) to be used
    * to send the N2ap message
@@ -152,13 +157,20 @@ private:
    */
   std::map < Ptr<Socket>, Ptr<N2apConnectionInfo> > m_n2apInterfaceCellIds;
 
+  /**
+   * Map telling for each amfUeN2Id the AMF serving the UE, as given by
+   * the last Registration Request or Path Switch Request of the UE
+   */
+  std::map < uint64_t, uint16_t > m_amfIdByAmfUeN2Id;
+
   /**
    * UDP port to be used for the N2ap interfaces: N2ap
    */
   uint16_t m_n2apUdpPort;
 
   /**
-   * Amf ID, stored as a private variable until more than one AMF will be implemented
+   * ID of the first AMF connected to this eNB, which serves the UEs
+   * for which no other AMF was selected
    */
   uint16_t m_amfId; 
 
@@ -236,6 +248,11 @@ protected:
   								uint16_t enbUeN2Id, 
 								uint16_t cellId,
 								uint64_t guti);
+  virtual void DoSendRegistrationReject (uint64_t amfUeN2Id,
+                                         uint16_t enbUeN2Id,
+                                         uint16_t cellId,
+                                         uint8_t cause,
+                                         Time t3346);
 
   NgcN2apSapAmf* m_n2apSapUser;
   NgcN2apSapAmfProvider* m_n2apSapProvider;
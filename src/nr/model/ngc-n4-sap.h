@@ -0,0 +1,274 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NGC_N4_SAP_H
+#define NGC_N4_SAP_H
+
+#include <ns3/ipv4-address.h>
+#include <ns3/ptr.h>
+#include <ns3/ngc-tft.h>
+#include <list>
+
+namespace ns3 {
+
+/**
+ * \ingroup nr
+ *
+ * Base class of the N4 Service Access Point (SAP), through which the SMF
+ * programs the packet forwarding of the UPFs. The PFCP sessions of
+ * 3GPP TS 29.244 are reduced to what the UPF needs to forward the
+ * packets of a UE: its address, the address of its eNB and the TEID and
+ * TFT of each of its bearers.
+ */
+class NgcN4Sap
+{
+public:
+
+  virtual ~NgcN4Sap ();
+
+  struct PfcpMessage
+  {
+    uint64_t seid; /**< Session Endpoint IDentifier, the IMSI of the UE */
+  };
+
+  /**
+   * Forwarding rule of a bearer of a session, standing for the PDR and
+   * FAR of TS 29.244
+   */
+  struct BearerContext
+  {
+    uint8_t epsBearerId;
+    uint32_t teid;
+    Ptr<NgcTft> tft;
+  };
+
+  /**
+   * Cause of a response, see TS 29.244 8.2.1
+   */
+  enum Cause {
+    REQUEST_ACCEPTED = 1,
+    SESSION_CONTEXT_NOT_FOUND = 65
+  };
+
+};
+
+/**
+ * \ingroup nr
+ *
+ * UPF side of the N4 SAP, provides the UPF methods to be called when an
+ * N4 message is received by the UPF.
+ */
+class NgcN4SapUpf : public NgcN4Sap
+{
+public:
+
+  /**
+   * Session Establishment Request message, see TS 29.244 7.5.2
+   */
+  struct SessionEstablishmentRequestMessage : public PfcpMessage
+  {
+    Ipv4Address ueAddr;
+    Ipv4Address enbAddr;
+    std::list<BearerContext> bearerContextsToBeCreated;
+  };
+
+  /**
+   * send a Session Establishment Request message
+   *
+   * \param msg the message
+   */
+  virtual void SessionEstablishmentRequest (SessionEstablishmentRequestMessage msg) = 0;
+
+  /**
+   * Session Modification Request message, see TS 29.244 7.5.4
+   */
+  struct SessionModificationRequestMessage : public PfcpMessage
+  {
+    Ipv4Address enbAddr; /**< new eNB address, Ipv4Address::GetAny () to keep the current one */
+    std::list<uint8_t> bearersToBeRemoved;
+  };
+
+  /**
+   * send a Session Modification Request message
+   *
+   * \param msg the message
+   */
+  virtual void SessionModificationRequest (SessionModificationRequestMessage msg) = 0;
+
+  /**
+   * Session Deletion Request message, see TS 29.244 7.5.6
+   */
+  struct SessionDeletionRequestMessage : public PfcpMessage
+  {
+  };
+
+  /**
+   * send a Session Deletion Request message
+   *
+   * \param msg the message
+   */
+  virtual void SessionDeletionRequest (SessionDeletionRequestMessage msg) = 0;
+
+};
+
+/**
+ * \ingroup nr
+ *
+ * SMF side of the N4 SAP, provides the SMF methods to be called when an
+ * N4 message is received by the SMF.
+ */
+class NgcN4SapSmf : public NgcN4Sap
+{
+public:
+
+  /**
+   * Session Establishment, Modification and Deletion Response messages,
+   * see TS 29.244 7.5.3, 7.5.5 and 7.5.7
+   */
+  struct SessionResponseMessage : public PfcpMessage
+  {
+    uint32_t upfId; /**< the UPF which sends the response */
+    Cause cause;
+  };
+
+  /**
+   * send a Session Establishment Response message
+   *
+   * \param msg the message
+   */
+  virtual void SessionEstablishmentResponse (SessionResponseMessage msg) = 0;
+
+  /**
+   * send a Session Modification Response message
+   *
+   * \param msg the message
+   */
+  virtual void SessionModificationResponse (SessionResponseMessage msg) = 0;
+
+  /**
+   * send a Session Deletion Response message
+   *
+   * \param msg the message
+   */
+  virtual void SessionDeletionResponse (SessionResponseMessage msg) = 0;
+
+};
+
+
+
+/**
+ * Template for the implementation of the NgcN4SapUpf as a member
+ * of an owner class of type C to which all methods are forwarded
+ */
+template <class C>
+class MemberNgcN4SapUpf : public NgcN4SapUpf
+{
+public:
+  MemberNgcN4SapUpf (C* owner);
+
+  // inherited from NgcN4SapUpf
+  virtual void SessionEstablishmentRequest (SessionEstablishmentRequestMessage msg);
+  virtual void SessionModificationRequest (SessionModificationRequestMessage msg);
+  virtual void SessionDeletionRequest (SessionDeletionRequestMessage msg);
+
+private:
+  MemberNgcN4SapUpf ();
+  C* m_owner;
+};
+
+template <class C>
+MemberNgcN4SapUpf<C>::MemberNgcN4SapUpf (C* owner)
+  : m_owner (owner)
+{
+}
+
+template <class C>
+MemberNgcN4SapUpf<C>::MemberNgcN4SapUpf ()
+{
+}
+
+template <class C>
+void MemberNgcN4SapUpf<C>::SessionEstablishmentRequest (SessionEstablishmentRequestMessage msg)
+{
+  m_owner->DoSessionEstablishmentRequest (msg);
+}
+
+template <class C>
+void MemberNgcN4SapUpf<C>::SessionModificationRequest (SessionModificationRequestMessage msg)
+{
+  m_owner->DoSessionModificationRequest (msg);
+}
+
+template <class C>
+void MemberNgcN4SapUpf<C>::SessionDeletionRequest (SessionDeletionRequestMessage msg)
+{
+  m_owner->DoSessionDeletionRequest (msg);
+}
+
+
+
+/**
+ * Template for the implementation of the NgcN4SapSmf as a member
+ * of an owner class of type C to which all methods are forwarded
+ */
+template <class C>
+class MemberNgcN4SapSmf : public NgcN4SapSmf
+{
+public:
+  MemberNgcN4SapSmf (C* owner);
+
+  // inherited from NgcN4SapSmf
+  virtual void SessionEstablishmentResponse (SessionResponseMessage msg);
+  virtual void SessionModificationResponse (SessionResponseMessage msg);
+  virtual void SessionDeletionResponse (SessionResponseMessage msg);
+
+private:
+  MemberNgcN4SapSmf ();
+  C* m_owner;
+};
+
+template <class C>
+MemberNgcN4SapSmf<C>::MemberNgcN4SapSmf (C* owner)
+  : m_owner (owner)
+{
+}
+
+template <class C>
+MemberNgcN4SapSmf<C>::MemberNgcN4SapSmf ()
+{
+}
+
+template <class C>
+void MemberNgcN4SapSmf<C>::SessionEstablishmentResponse (SessionResponseMessage msg)
+{
+  m_owner->DoSessionEstablishmentResponse (msg);
+}
+
+template <class C>
+void MemberNgcN4SapSmf<C>::SessionModificationResponse (SessionResponseMessage msg)
+{
+  m_owner->DoSessionModificationResponse (msg);
+}
+
+template <class C>
+void MemberNgcN4SapSmf<C>::SessionDeletionResponse (SessionResponseMessage msg)
+{
+  m_owner->DoSessionDeletionResponse (msg);
+}
+
+} //namespace ns3
+
+#endif /* NGC_N4_SAP_H */
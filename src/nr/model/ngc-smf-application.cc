@@ -0,0 +1,562 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ngc-smf-application.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/enum.h"
+#include "ns3/hash.h"
+#include "ns3/simulator.h"
+#include "ns3/make-event.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NgcSmfApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (NgcSmfApplication);
+
+/** UPF identifier of a UE without session, or of a cell without local UPF */
+static const uint32_t NO_UPF = 0xFFFFFFFF;
+
+TypeId
+NgcSmfApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NgcSmfApplication")
+    .SetParent<Application> ()
+    .SetGroupName("Nr")
+    .AddAttribute ("UpfSelection",
+                   "How the SMF picks the UPF of a new session",
+                   EnumValue (NgcSmfApplication::HASH),
+                   MakeEnumAccessor (&NgcSmfApplication::m_upfSelection),
+                   MakeEnumChecker (NgcSmfApplication::HASH, "Hash",
+                                    NgcSmfApplication::LEAST_LOADED, "LeastLoaded",
+                                    NgcSmfApplication::LOCALITY, "Locality"))
+    .AddAttribute ("N4Delay",
+                   "The one way delay of the N4 messages between the SMF and the UPFs",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&NgcSmfApplication::m_n4Delay),
+                   MakeTimeChecker ())
+    .AddTraceSource ("SessionEstablished",
+                     "A UPF has established the session of a UE",
+                     MakeTraceSourceAccessor (&NgcSmfApplication::m_sessionEstablishedTrace),
+                     "ns3::NgcSmfApplication::SessionEstablishedTracedCallback")
+    .AddTraceSource ("RxMessage",
+                     "A N11 message about a UE arrives at the SMF",
+                     MakeTraceSourceAccessor (&NgcSmfApplication::m_rxMessageTrace),
+                     "ns3::NgcSmfApplication::MessageTracedCallback")
+    .AddTraceSource ("ProcessedMessage",
+                     "The SMF has processed a N11 message about a UE",
+                     MakeTraceSourceAccessor (&NgcSmfApplication::m_processedMessageTrace),
+                     "ns3::NgcSmfApplication::ProcessedMessageTracedCallback")
+  ;
+  return tid;
+}
+
+NgcSmfApplication::NgcSmfApplication ()
+  : m_teidCount (0),
+    m_n11SapAmf (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_n11SapSmf = new MemberNgcN11SapSmf<NgcSmfApplication> (this);
+  m_n4SapSmf = new MemberNgcN4SapSmf<NgcSmfApplication> (this);
+  m_queue = CreateObject<NfQueue> ();
+}
+
+NgcSmfApplication::~NgcSmfApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+NgcSmfApplication::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  delete (m_n11SapSmf);
+  m_n11SapSmf = 0;
+  delete (m_n4SapSmf);
+  m_n4SapSmf = 0;
+  m_upfs.clear ();
+  m_ueInfoByImsiMap.clear ();
+  m_n11SapAmfByAmfId.clear ();
+  m_queue = 0;
+  Application::DoDispose ();
+}
+
+void
+NgcSmfApplication::SetN11SapAmf (NgcN11SapAmf * s)
+{
+  m_n11SapAmf = s;
+}
+
+void
+NgcSmfApplication::AddAmf (uint16_t amfId, NgcN11SapAmf * s)
+{
+  NS_LOG_FUNCTION (this << amfId << s);
+  m_n11SapAmfByAmfId[amfId] = s;
+}
+
+NgcN11SapAmf*
+NgcSmfApplication::GetN11SapAmf (uint16_t amfId) const
+{
+  std::map<uint16_t, NgcN11SapAmf*>::const_iterator it = m_n11SapAmfByAmfId.find (amfId);
+  if (it == m_n11SapAmfByAmfId.end ())
+    {
+      return m_n11SapAmf;
+    }
+  return it->second;
+}
+
+NgcN11SapSmf*
+NgcSmfApplication::GetN11SapSmf ()
+{
+  return m_n11SapSmf;
+}
+
+NgcN4SapSmf*
+NgcSmfApplication::GetN4SapSmf ()
+{
+  return m_n4SapSmf;
+}
+
+uint32_t
+NgcSmfApplication::AddUpf (NgcN4SapUpf * s)
+{
+  NS_LOG_FUNCTION (this << s);
+  UpfInfo upf;
+  upf.n4SapUpf = s;
+  upf.nSessions = 0;
+  m_upfs.push_back (upf);
+  return m_upfs.size () - 1;
+}
+
+uint32_t
+NgcSmfApplication::GetNUpfs () const
+{
+  return m_upfs.size ();
+}
+
+uint32_t
+NgcSmfApplication::GetNSessions (uint32_t upfId) const
+{
+  NS_ASSERT (upfId < m_upfs.size ());
+  return m_upfs[upfId].nSessions;
+}
+
+void
+NgcSmfApplication::AddEnb (uint16_t cellId, uint32_t upfId, Ipv4Address enbAddr, Ipv4Address upfAddr)
+{
+  NS_LOG_FUNCTION (this << cellId << upfId << enbAddr << upfAddr);
+  NS_ASSERT (upfId < m_upfs.size ());
+  std::map<uint16_t, EnbInfo>::iterator it = m_enbInfoByCellId.find (cellId);
+  if (it == m_enbInfoByCellId.end ())
+    {
+      EnbInfo enbInfo;
+      enbInfo.localUpfId = NO_UPF;
+      it = m_enbInfoByCellId.insert (std::make_pair (cellId, enbInfo)).first;
+    }
+  N3Link link;
+  link.enbAddr = enbAddr;
+  link.upfAddr = upfAddr;
+  it->second.n3LinkByUpfId[upfId] = link;
+}
+
+void
+NgcSmfApplication::SetLocalUpf (uint16_t cellId, uint32_t upfId)
+{
+  NS_LOG_FUNCTION (this << cellId << upfId);
+  std::map<uint16_t, EnbInfo>::iterator it = m_enbInfoByCellId.find (cellId);
+  NS_ASSERT_MSG (it != m_enbInfoByCellId.end (), "unknown CellId " << cellId);
+  NS_ASSERT_MSG (it->second.n3LinkByUpfId.find (upfId) != it->second.n3LinkByUpfId.end (),
+                 "no N3 link between cell " << cellId << " and UPF " << upfId);
+  it->second.localUpfId = upfId;
+}
+
+void
+NgcSmfApplication::AddUe (uint64_t imsi)
+{
+  NS_LOG_FUNCTION (this << imsi);
+  Ptr<UeInfo> ueInfo = Create<UeInfo> ();
+  ueInfo->cellId = 0;
+  ueInfo->upfId = NO_UPF;
+  ueInfo->amfId = 0;
+  ueInfo->modifyBearerPending = false;
+  m_ueInfoByImsiMap[imsi] = ueInfo;
+}
+
+void
+NgcSmfApplication::SetUeAddress (uint64_t imsi, Ipv4Address ueAddr)
+{
+  NS_LOG_FUNCTION (this << imsi << ueAddr);
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+  ueit->second->ueAddr = ueAddr;
+}
+
+const NgcSmfApplication::N3Link &
+NgcSmfApplication::GetN3Link (uint16_t cellId, uint32_t upfId) const
+{
+  std::map<uint16_t, EnbInfo>::const_iterator enbit = m_enbInfoByCellId.find (cellId);
+  NS_ASSERT_MSG (enbit != m_enbInfoByCellId.end (), "unknown CellId " << cellId);
+  std::map<uint32_t, N3Link>::const_iterator linkit = enbit->second.n3LinkByUpfId.find (upfId);
+  NS_ABORT_MSG_IF (linkit == enbit->second.n3LinkByUpfId.end (),
+                   "no N3 link between cell " << cellId << " and UPF " << upfId);
+  return linkit->second;
+}
+
+uint32_t
+NgcSmfApplication::SelectUpf (uint64_t imsi, uint16_t cellId) const
+{
+  NS_ASSERT_MSG (!m_upfs.empty (), "the SMF has no UPF");
+  uint32_t hashed = Hash32 (reinterpret_cast<const char *> (&imsi), sizeof (imsi)) % m_upfs.size ();
+  switch (m_upfSelection)
+    {
+    case LEAST_LOADED:
+      {
+        uint32_t best = 0;
+        for (uint32_t i = 1; i < m_upfs.size (); ++i)
+          {
+            if (m_upfs[i].nSessions < m_upfs[best].nSessions)
+              {
+                best = i;
+              }
+          }
+        return best;
+      }
+    case LOCALITY:
+      {
+        std::map<uint16_t, EnbInfo>::const_iterator enbit = m_enbInfoByCellId.find (cellId);
+        if (enbit != m_enbInfoByCellId.end () && enbit->second.localUpfId != NO_UPF)
+          {
+            return enbit->second.localUpfId;
+          }
+        return hashed;
+      }
+    case HASH:
+    default:
+      return hashed;
+    }
+}
+
+Ptr<NfQueue>
+NgcSmfApplication::GetQueue () const
+{
+  return m_queue;
+}
+
+void
+NgcSmfApplication::Receive (uint64_t imsi, std::string message, bool initial, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << imsi << message);
+  m_rxMessageTrace (imsi, message);
+  Ptr<EventImpl> processing (event, false);
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+  ueit->second->requestTime = Simulator::Now ();
+  if (m_queue->IsInstantaneous ())
+    {
+      processing->Invoke ();
+      return;
+    }
+  Time delay;
+  if (!m_queue->Enqueue (message, initial, delay))
+    {
+      // there is no reject on N11: the request is dropped, and the AMF
+      // never hears back about it
+      m_processedMessageTrace (imsi, message, Seconds (0));
+      return;
+    }
+  Simulator::Schedule (delay, processing);
+}
+
+void
+NgcSmfApplication::DoCreateSessionRequest (NgcN11SapSmf::CreateSessionRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.imsi);
+  Receive (req.imsi, "CreateSessionRequest", true,
+           MakeEvent (&NgcSmfApplication::ProcessCreateSessionRequest, this, req));
+}
+
+void
+NgcSmfApplication::ProcessCreateSessionRequest (NgcN11SapSmf::CreateSessionRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.imsi);
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (req.imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << req.imsi);
+  Ptr<UeInfo> ueInfo = ueit->second;
+  ueInfo->cellId = req.uli.gci;
+  ueInfo->amfId = req.amfId;
+  if (ueInfo->upfId == NO_UPF)
+    {
+      ueInfo->upfId = SelectUpf (req.imsi, ueInfo->cellId);
+      m_upfs[ueInfo->upfId].nSessions++;
+      NS_LOG_INFO ("IMSI " << req.imsi << " in cell " << ueInfo->cellId << " gets UPF " << ueInfo->upfId);
+    }
+  const N3Link &link = GetN3Link (ueInfo->cellId, ueInfo->upfId);
+
+  NgcN11SapAmf::CreateSessionResponseMessage res;
+  res.teid = req.imsi; // trick to avoid the need for allocating TEIDs on the N11 interface
+
+  NgcN4SapUpf::SessionEstablishmentRequestMessage n4req;
+  n4req.seid = req.imsi;
+  n4req.ueAddr = ueInfo->ueAddr;
+  n4req.enbAddr = link.enbAddr;
+
+  for (std::list<NgcN11SapSmf::BearerContextToBeCreated>::iterator bit = req.bearerContextsToBeCreated.begin ();
+       bit != req.bearerContextsToBeCreated.end ();
+       ++bit)
+    {
+      // simple sanity check. If you ever need more than 4M teids
+      // throughout your simulation, you'll need to implement a smarter teid
+      // management algorithm.
+      NS_ABORT_IF (m_teidCount == 0xFFFFFFFF);
+      uint32_t teid = ++m_teidCount;
+
+      NgcN4Sap::BearerContext bearer;
+      bearer.epsBearerId = bit->epsBearerId;
+      bearer.teid = teid;
+      bearer.tft = bit->tft;
+      ueInfo->bearers.push_back (bearer);
+      n4req.bearerContextsToBeCreated.push_back (bearer);
+
+      NgcN11SapAmf::BearerContextCreated bearerContext;
+      bearerContext.smfFteid.teid = teid;
+      bearerContext.smfFteid.address = link.upfAddr;
+      bearerContext.epsBearerId = bit->epsBearerId;
+      bearerContext.bearerLevelQos = bit->bearerLevelQos;
+      bearerContext.tft = bit->tft;
+      res.bearerContextsCreated.push_back (bearerContext);
+    }
+  // the response goes to the AMF once the UPF has the session
+  ueInfo->pendingCreateSessionResponse = res;
+  SendSessionEstablishmentRequest (ueInfo->upfId, n4req);
+}
+
+void
+NgcSmfApplication::DoModifyBearerRequest (NgcN11SapSmf::ModifyBearerRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.teid);
+  uint64_t imsi = req.teid; // trick to avoid the need for allocating TEIDs on the N11 interface
+  Receive (imsi, "ModifyBearerRequest", false,
+           MakeEvent (&NgcSmfApplication::ProcessModifyBearerRequest, this, req));
+}
+
+void
+NgcSmfApplication::ProcessModifyBearerRequest (NgcN11SapSmf::ModifyBearerRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.teid);
+  uint64_t imsi = req.teid;
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+  Ptr<UeInfo> ueInfo = ueit->second;
+  ueInfo->cellId = req.uli.gci;
+  ueInfo->amfId = req.amfId;
+  NS_ASSERT_MSG (ueInfo->upfId != NO_UPF, "no session for IMSI " << imsi);
+  // no actual bearer modification: for now we just support the minimum
+  // needed for path switch request (handover), the UE keeps its UPF
+  NgcN4SapUpf::SessionModificationRequestMessage n4req;
+  n4req.seid = imsi;
+  n4req.enbAddr = GetN3Link (ueInfo->cellId, ueInfo->upfId).enbAddr;
+  ueInfo->modifyBearerPending = true;
+  SendSessionModificationRequest (ueInfo->upfId, n4req);
+}
+
+void
+NgcSmfApplication::DoDeleteBearerCommand (NgcN11SapSmf::DeleteBearerCommandMessage req)
+{
+  NS_LOG_FUNCTION (this << req.teid);
+  uint64_t imsi = req.teid; // trick to avoid the need for allocating TEIDs on the N11 interface
+  Receive (imsi, "DeleteBearerCommand", false,
+           MakeEvent (&NgcSmfApplication::ProcessDeleteBearerCommand, this, req));
+}
+
+void
+NgcSmfApplication::ProcessDeleteBearerCommand (NgcN11SapSmf::DeleteBearerCommandMessage req)
+{
+  NS_LOG_FUNCTION (this << req.teid);
+  uint64_t imsi = req.teid;
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+
+  NgcN11SapAmf::DeleteBearerRequestMessage res;
+  res.teid = imsi;
+
+  for (std::list<NgcN11SapSmf::BearerContextToBeRemoved>::iterator bit = req.bearerContextsToBeRemoved.begin ();
+       bit != req.bearerContextsToBeRemoved.end ();
+       ++bit)
+    {
+      NgcN11SapAmf::BearerContextRemoved bearerContext;
+      bearerContext.epsBearerId = bit->epsBearerId;
+      res.bearerContextsRemoved.push_back (bearerContext);
+    }
+  m_processedMessageTrace (imsi, "DeleteBearerCommand", Simulator::Now () - ueit->second->requestTime);
+  //schedules Delete Bearer Request towards AMF
+  GetN11SapAmf (req.amfId)->DeleteBearerRequest (res);
+}
+
+void
+NgcSmfApplication::DoDeleteBearerResponse (NgcN11SapSmf::DeleteBearerResponseMessage req)
+{
+  NS_LOG_FUNCTION (this << req.teid);
+  uint64_t imsi = req.teid; // trick to avoid the need for allocating TEIDs on the N11 interface
+  Receive (imsi, "DeleteBearerResponse", false,
+           MakeEvent (&NgcSmfApplication::ProcessDeleteBearerResponse, this, req));
+}
+
+void
+NgcSmfApplication::ProcessDeleteBearerResponse (NgcN11SapSmf::DeleteBearerResponseMessage req)
+{
+  NS_LOG_FUNCTION (this << req.teid);
+  uint64_t imsi = req.teid;
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+  Ptr<UeInfo> ueInfo = ueit->second;
+
+  NgcN4SapUpf::SessionModificationRequestMessage n4req;
+  n4req.seid = imsi;
+  n4req.enbAddr = Ipv4Address::GetAny ();
+  for (std::list<NgcN11SapSmf::BearerContextRemovedSmfUpf>::iterator bit = req.bearerContextsRemoved.begin ();
+       bit != req.bearerContextsRemoved.end ();
+       ++bit)
+    {
+      n4req.bearersToBeRemoved.push_back (bit->epsBearerId);
+      for (std::list<NgcN4Sap::BearerContext>::iterator it = ueInfo->bearers.begin (); it != ueInfo->bearers.end (); ++it)
+        {
+          if (it->epsBearerId == bit->epsBearerId)
+            {
+              ueInfo->bearers.erase (it);
+              break;
+            }
+        }
+    }
+  if (ueInfo->upfId != NO_UPF)
+    {
+      SendSessionModificationRequest (ueInfo->upfId, n4req);
+    }
+  else
+    {
+      m_processedMessageTrace (imsi, "DeleteBearerResponse", Simulator::Now () - ueInfo->requestTime);
+    }
+}
+
+void
+NgcSmfApplication::SendSessionEstablishmentRequest (uint32_t upfId, NgcN4SapUpf::SessionEstablishmentRequestMessage msg)
+{
+  NS_LOG_FUNCTION (this << upfId << msg.seid);
+  if (m_n4Delay.IsZero ())
+    {
+      m_upfs[upfId].n4SapUpf->SessionEstablishmentRequest (msg);
+    }
+  else
+    {
+      Simulator::Schedule (m_n4Delay, &NgcN4SapUpf::SessionEstablishmentRequest, m_upfs[upfId].n4SapUpf, msg);
+    }
+}
+
+void
+NgcSmfApplication::SendSessionModificationRequest (uint32_t upfId, NgcN4SapUpf::SessionModificationRequestMessage msg)
+{
+  NS_LOG_FUNCTION (this << upfId << msg.seid);
+  if (m_n4Delay.IsZero ())
+    {
+      m_upfs[upfId].n4SapUpf->SessionModificationRequest (msg);
+    }
+  else
+    {
+      Simulator::Schedule (m_n4Delay, &NgcN4SapUpf::SessionModificationRequest, m_upfs[upfId].n4SapUpf, msg);
+    }
+}
+
+void
+NgcSmfApplication::DoSessionEstablishmentResponse (NgcN4SapSmf::SessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.seid << msg.upfId);
+  if (m_n4Delay.IsZero ())
+    {
+      RecvSessionEstablishmentResponse (msg);
+    }
+  else
+    {
+      Simulator::Schedule (m_n4Delay, &NgcSmfApplication::RecvSessionEstablishmentResponse, this, msg);
+    }
+}
+
+void
+NgcSmfApplication::RecvSessionEstablishmentResponse (NgcN4SapSmf::SessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.seid << msg.upfId);
+  NS_ASSERT (msg.cause == NgcN4Sap::REQUEST_ACCEPTED);
+  uint64_t imsi = msg.seid;
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+  m_sessionEstablishedTrace (imsi, ueit->second->ueAddr, msg.upfId);
+  m_processedMessageTrace (imsi, "CreateSessionRequest", Simulator::Now () - ueit->second->requestTime);
+  GetN11SapAmf (ueit->second->amfId)->CreateSessionResponse (ueit->second->pendingCreateSessionResponse);
+}
+
+void
+NgcSmfApplication::DoSessionModificationResponse (NgcN4SapSmf::SessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.seid << msg.upfId);
+  if (m_n4Delay.IsZero ())
+    {
+      RecvSessionModificationResponse (msg);
+    }
+  else
+    {
+      Simulator::Schedule (m_n4Delay, &NgcSmfApplication::RecvSessionModificationResponse, this, msg);
+    }
+}
+
+void
+NgcSmfApplication::RecvSessionModificationResponse (NgcN4SapSmf::SessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.seid << msg.upfId);
+  uint64_t imsi = msg.seid;
+  std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
+  NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi);
+  if (!ueit->second->modifyBearerPending)
+    {
+      // removal of bearers, nothing to answer to the AMF
+      m_processedMessageTrace (imsi, "DeleteBearerResponse", Simulator::Now () - ueit->second->requestTime);
+      return;
+    }
+  ueit->second->modifyBearerPending = false;
+  m_processedMessageTrace (imsi, "ModifyBearerRequest", Simulator::Now () - ueit->second->requestTime);
+  NgcN11SapAmf::ModifyBearerResponseMessage res;
+  res.teid = imsi; // trick to avoid the need for allocating TEIDs on the N11 interface
+  if (msg.cause == NgcN4Sap::REQUEST_ACCEPTED)
+    {
+      res.cause = NgcN11SapAmf::ModifyBearerResponseMessage::REQUEST_ACCEPTED;
+    }
+  else
+    {
+      res.cause = NgcN11SapAmf::ModifyBearerResponseMessage::CONTEXT_NOT_FOUND;
+    }
+  GetN11SapAmf (ueit->second->amfId)->ModifyBearerResponse (res);
+}
+
+void
+NgcSmfApplication::DoSessionDeletionResponse (NgcN4SapSmf::SessionResponseMessage msg)
+{
+  NS_LOG_FUNCTION (this << msg.seid << msg.upfId);
+  if (msg.cause == NgcN4Sap::REQUEST_ACCEPTED)
+    {
+      NS_ASSERT (msg.upfId < m_upfs.size () && m_upfs[msg.upfId].nSessions > 0);
+      m_upfs[msg.upfId].nSessions--;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,358 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NGC_SMF_APPLICATION_H
+#define NGC_SMF_APPLICATION_H
+
+#include <ns3/ipv4-address.h>
+#include <ns3/traced-callback.h>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <ns3/application.h>
+#include <ns3/event-impl.h>
+#include <ns3/nf-queue.h>
+#include <ns3/ngc-tft.h>
+#include <ns3/ngc-n11-sap.h>
+#include <ns3/ngc-n4-sap.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup nr
+ *
+ * This application implements the SMF: it handles the sessions requested
+ * by the AMF over the N11 SAP, picks for each of them one UPF of its pool
+ * and programs it over the N4 SAP. A UE keeps the UPF of its session,
+ * which anchors its user plane, across handovers.
+ *
+ * The UPF of a new session is picked according to the "UpfSelection"
+ * attribute:
+ *  - HASH: a hash of the IMSI, which spreads the UEs evenly and always
+ *    gives the same UPF to a UE;
+ *  - LEAST_LOADED: the UPF with the fewest sessions;
+ *  - LOCALITY: the UPF local to the cell of the UE, as set by
+ *    SetLocalUpf(), or the HASH one if the cell has none.
+ */
+class NgcSmfApplication : public Application
+{
+  friend class MemberNgcN11SapSmf<NgcSmfApplication>;
+  friend class MemberNgcN4SapSmf<NgcSmfApplication>;
+
+public:
+
+  /** UPF selection policies */
+  enum UpfSelection
+  {
+    HASH,
+    LEAST_LOADED,
+    LOCALITY
+  };
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  NgcSmfApplication ();
+
+  /**
+   * Destructor
+   */
+  virtual ~NgcSmfApplication (void);
+
+  /**
+   * Set the AMF side of the N11 SAP
+   *
+   * \param s the AMF side of the N11 SAP
+   */
+  void SetN11SapAmf (NgcN11SapAmf * s);
+
+  /**
+   * Add an AMF of the AMF set: the SMF answers the requests of a UE
+   * to the AMF which sent them, or to the AMF set by SetN11SapAmf() if
+   * the AMF was not added
+   *
+   * \param amfId the identifier of the AMF in its set
+   * \param s the AMF side of the N11 SAP of the AMF
+   */
+  void AddAmf (uint16_t amfId, NgcN11SapAmf * s);
+
+  /**
+   * \return the SMF side of the N11 SAP
+   */
+  NgcN11SapSmf* GetN11SapSmf ();
+
+  /**
+   * \return the SMF side of the N4 SAP
+   */
+  NgcN4SapSmf* GetN4SapSmf ();
+
+  /**
+   * Add a UPF to the pool of the SMF
+   *
+   * \param s the UPF side of the N4 SAP of the UPF
+   * \return the identifier of the UPF in the pool
+   */
+  uint32_t AddUpf (NgcN4SapUpf * s);
+
+  /**
+   * \return the number of UPFs in the pool
+   */
+  uint32_t GetNUpfs () const;
+
+  /**
+   * \param upfId the identifier of a UPF
+   * \return the number of sessions of the UPF
+   */
+  uint32_t GetNSessions (uint32_t upfId) const;
+
+  /**
+   * Let the SMF be aware of the N3 link between an eNB and a UPF
+   *
+   * \param cellId the cell identifier
+   * \param upfId the identifier of the UPF
+   * \param enbAddr the N3 address of the eNB
+   * \param upfAddr the N3 address of the UPF
+   */
+  void AddEnb (uint16_t cellId, uint32_t upfId, Ipv4Address enbAddr, Ipv4Address upfAddr);
+
+  /**
+   * Set the UPF which the LOCALITY selection gives to the UEs of a cell
+   *
+   * \param cellId the cell identifier
+   * \param upfId the identifier of the UPF
+   */
+  void SetLocalUpf (uint16_t cellId, uint32_t upfId);
+
+  /**
+   * Let the SMF be aware of a new UE
+   *
+   * \param imsi the unique identifier of the UE
+   */
+  void AddUe (uint64_t imsi);
+
+  /**
+   * set the address of a previously added UE
+   *
+   * \param imsi the unique identifier of the UE
+   * \param ueAddr the IPv4 address of the UE
+   */
+  void SetUeAddress (uint64_t imsi, Ipv4Address ueAddr);
+
+  /**
+   * \return the processing queue of the SMF, which sets the service time
+   * of each N11 message and the number of workers
+   */
+  Ptr<NfQueue> GetQueue () const;
+
+  /**
+   * TracedCallback signature for the establishment of a session.
+   *
+   * \param [in] imsi the IMSI of the UE
+   * \param [in] ueAddr the address of the UE
+   * \param [in] upfId the UPF of the session
+   */
+  typedef void (* SessionEstablishedTracedCallback)
+    (uint64_t imsi, Ipv4Address ueAddr, uint32_t upfId);
+
+  /**
+   * TracedCallback signature for the arrival of a N11 message about a UE.
+   *
+   * \param [in] imsi the IMSI of the UE
+   * \param [in] message the name of the message
+   */
+  typedef void (* MessageTracedCallback)
+    (uint64_t imsi, std::string message);
+
+  /**
+   * TracedCallback signature for the end of the processing of a N11
+   * message about a UE.
+   *
+   * \param [in] imsi the IMSI of the UE
+   * \param [in] message the name of the message
+   * \param [in] delay the time the message spent in the SMF, including
+   *             the queueing and the N4 exchange with the UPF, zero if
+   *             the SMF refused it because of overload
+   */
+  typedef void (* ProcessedMessageTracedCallback)
+    (uint64_t imsi, std::string message, Time delay);
+
+private:
+
+  // N11 SAP SMF methods
+  void DoCreateSessionRequest (NgcN11SapSmf::CreateSessionRequestMessage msg);
+  void DoModifyBearerRequest (NgcN11SapSmf::ModifyBearerRequestMessage msg);
+  void DoDeleteBearerCommand (NgcN11SapSmf::DeleteBearerCommandMessage req);
+  void DoDeleteBearerResponse (NgcN11SapSmf::DeleteBearerResponseMessage req);
+
+  // processing of the N11 messages once served
+  void ProcessCreateSessionRequest (NgcN11SapSmf::CreateSessionRequestMessage msg);
+  void ProcessModifyBearerRequest (NgcN11SapSmf::ModifyBearerRequestMessage msg);
+  void ProcessDeleteBearerCommand (NgcN11SapSmf::DeleteBearerCommandMessage req);
+  void ProcessDeleteBearerResponse (NgcN11SapSmf::DeleteBearerResponseMessage req);
+
+  /**
+   * Queue a N11 message about a UE for processing
+   *
+   * \param imsi the IMSI of the UE
+   * \param message the name of the message
+   * \param initial whether the message starts a procedure, in which case
+   *                it is dropped when the SMF is overloaded
+   * \param event the processing of the message
+   */
+  void Receive (uint64_t imsi, std::string message, bool initial, EventImpl *event);
+
+  // N4 SAP SMF methods
+  void DoSessionEstablishmentResponse (NgcN4SapSmf::SessionResponseMessage msg);
+  void DoSessionModificationResponse (NgcN4SapSmf::SessionResponseMessage msg);
+  void DoSessionDeletionResponse (NgcN4SapSmf::SessionResponseMessage msg);
+
+  // N4 messages, sent after the N4 delay
+  void SendSessionEstablishmentRequest (uint32_t upfId, NgcN4SapUpf::SessionEstablishmentRequestMessage msg);
+  void SendSessionModificationRequest (uint32_t upfId, NgcN4SapUpf::SessionModificationRequestMessage msg);
+  void RecvSessionEstablishmentResponse (NgcN4SapSmf::SessionResponseMessage msg);
+  void RecvSessionModificationResponse (NgcN4SapSmf::SessionResponseMessage msg);
+
+  /**
+   * Pick the UPF of a new session
+   *
+   * \param imsi the IMSI of the UE
+   * \param cellId the cell of the UE
+   * \return the identifier of the UPF
+   */
+  uint32_t SelectUpf (uint64_t imsi, uint16_t cellId) const;
+
+  /**
+   * \param amfId the identifier of an AMF in its set
+   * \return the AMF side of the N11 SAP of the AMF
+   */
+  NgcN11SapAmf* GetN11SapAmf (uint16_t amfId) const;
+
+  /**
+   * addresses of the N3 link between an eNB and a UPF
+   */
+  struct N3Link
+  {
+    Ipv4Address enbAddr;
+    Ipv4Address upfAddr;
+  };
+
+  /**
+   * store info for each eNB known by this SMF
+   */
+  struct EnbInfo
+  {
+    std::map<uint32_t, N3Link> n3LinkByUpfId;
+    uint32_t localUpfId;
+  };
+
+  /**
+   * store info for each UE connected to this SMF
+   */
+  struct UeInfo : public SimpleRefCount<UeInfo>
+  {
+    Ipv4Address ueAddr;
+    uint16_t cellId;
+    uint32_t upfId;
+    uint16_t amfId;
+    std::list<NgcN4Sap::BearerContext> bearers;
+    NgcN11SapAmf::CreateSessionResponseMessage pendingCreateSessionResponse;
+    bool modifyBearerPending;
+    Time requestTime; ///< arrival time of the request being processed
+  };
+
+  /**
+   * \param cellId the cell identifier
+   * \param upfId the identifier of the UPF
+   * \return the N3 link between the eNB of the cell and the UPF
+   */
+  const N3Link & GetN3Link (uint16_t cellId, uint32_t upfId) const;
+
+  /**
+   * a UPF of the pool
+   */
+  struct UpfInfo
+  {
+    NgcN4SapUpf* n4SapUpf;
+    uint32_t nSessions;
+  };
+
+  std::vector<UpfInfo> m_upfs;
+
+  std::map<uint16_t, EnbInfo> m_enbInfoByCellId;
+
+  /**
+   * Map telling for each IMSI the corresponding UE info
+   */
+  std::map<uint64_t, Ptr<UeInfo> > m_ueInfoByImsiMap;
+
+  uint32_t m_teidCount;
+
+  /**
+   * UPF selection policy
+   */
+  UpfSelection m_upfSelection;
+
+  /**
+   * one way delay of the N4 messages
+   */
+  Time m_n4Delay;
+
+  /**
+   * processing queue of the N11 messages
+   */
+  Ptr<NfQueue> m_queue;
+
+  /**
+   * AMF side of the N11 SAP
+   */
+  NgcN11SapAmf* m_n11SapAmf;
+
+  /**
+   * AMF side of the N11 SAP of each AMF of the AMF set
+   */
+  std::map<uint16_t, NgcN11SapAmf*> m_n11SapAmfByAmfId;
+
+  /**
+   * SMF side of the N11 SAP
+   */
+  NgcN11SapSmf* m_n11SapSmf;
+
+  /**
+   * SMF side of the N4 SAP
+   */
+  NgcN4SapSmf* m_n4SapSmf;
+
+  /**
+   * fired when a UPF has established a session
+   */
+  TracedCallback<uint64_t, Ipv4Address, uint32_t> m_sessionEstablishedTrace;
+
+  /**
+   * fired when a N11 message about a UE arrives at the SMF
+   */
+  TracedCallback<uint64_t, std::string> m_rxMessageTrace;
+
+  /**
+   * fired when the SMF has processed a N11 message about a UE
+   */
+  TracedCallback<uint64_t, std::string, Time> m_processedMessageTrace;
+};
+
+} //namespace ns3
+
+#endif /* NGC_SMF_APPLICATION_H */
@@ -113,22 +113,22 @@ void
 NgcSmfUpfApplication::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_n2uSocket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
-  m_n2uSocket = 0;
+  m_n2uTunnel->Dispose ();
+  m_n2uTunnel = 0;
   delete (m_n11SapSmf);
 }
 
   
 
 NgcSmfUpfApplication::NgcSmfUpfApplication (const Ptr<VirtualNetDevice> tunDevice, const Ptr<Socket> n2uSocket)
-  : m_n2uSocket (n2uSocket),
-    m_tunDevice (tunDevice),
-    m_gtpuUdpPort (2152), // fixed by the standard
+  : m_tunDevice (tunDevice),
     m_teidCount (0),
     m_n11SapAmf (0)
 {
   NS_LOG_FUNCTION (this << tunDevice << n2uSocket);
-  m_n2uSocket->SetRecvCallback (MakeCallback (&NgcSmfUpfApplication::RecvFromN2uSocket, this));
+  m_n2uTunnel = CreateObject<UdpTunnelEndpoint> ();
+  m_n2uTunnel->SetSocket (n2uSocket);
+  m_n2uTunnel->SetRecvCallback (MakeCallback (&NgcSmfUpfApplication::RecvFromN2uTunnel, this));
   m_n11SapSmf = new MemberNgcN11SapSmf<NgcSmfUpfApplication> (this);
 }
 
@@ -145,29 +145,28 @@ NgcSmfUpfApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
   NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
 
   // get IP address of UE
-  Ptr<Packet> pCopy = packet->Copy ();
   Ipv4Header ipv4Header;
-  pCopy->RemoveHeader (ipv4Header);
+  packet->PeekHeader (ipv4Header);
   Ipv4Address ueAddr =  ipv4Header.GetDestination ();
   NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
 
   // find corresponding UeInfo address
-  std::map<Ipv4Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap.find (ueAddr);
-  if (it == m_ueInfoByAddrMap.end ())
+  Ptr<UeInfo> *ueInfo = m_ueInfoByAddrMap.Find (ueAddr.Get ());
+  if (ueInfo == 0)
     {        
       NS_LOG_WARN ("unknown UE address " << ueAddr);
     }
   else
     {
-      Ipv4Address enbAddr = it->second->GetEnbAddr ();      
-      uint32_t teid = it->second->Classify (packet);   
+      Ipv4Address enbAddr = (*ueInfo)->GetEnbAddr ();
+      uint32_t teid = (*ueInfo)->Classify (packet);
       if (teid == 0)
         {
           NS_LOG_WARN ("no matching bearer for this packet");                   
         }
       else
         {
-          SendToN2uSocket (packet, enbAddr, teid);
+          SendToN2uTunnel (packet, enbAddr, teid);
         }
     }
   // there is no reason why we should notify the TUN
@@ -178,11 +177,9 @@ NgcSmfUpfApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
 }
 
 void 
-NgcSmfUpfApplication::RecvFromN2uSocket (Ptr<Socket> socket)
+NgcSmfUpfApplication::RecvFromN2uTunnel (Ptr<Packet> packet)
 {
-  NS_LOG_FUNCTION (this << socket);  
-  NS_ASSERT (socket == m_n2uSocket);
-  Ptr<Packet> packet = socket->Recv ();
+  NS_LOG_FUNCTION (this << packet);
   NrGtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
   uint32_t teid = gtpu.GetTeid ();
@@ -204,18 +201,15 @@ NgcSmfUpfApplication::SendToTunDevice (Ptr<Packet> packet, uint32_t teid)
 }
 
 void 
-NgcSmfUpfApplication::SendToN2uSocket (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid)
+NgcSmfUpfApplication::SendToN2uTunnel (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid)
 {
   NS_LOG_FUNCTION (this << packet << enbAddr << teid);
-
   NrGtpuHeader gtpu;
   gtpu.SetTeid (teid);
   // From 3GPP TS 29.281 v10.0.0 Section 5.1
   // Length of the payload + the non obligatory GTP-U header
-  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);  
-  packet->AddHeader (gtpu);
-  uint32_t flags = 0;
-  m_n2uSocket->SendTo (packet, flags, InetSocketAddress (enbAddr, m_gtpuUdpPort));
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  m_n2uTunnel->Send (packet, gtpu, enbAddr);
 }
 
 
@@ -255,7 +249,7 @@ NgcSmfUpfApplication::SetUeAddress (uint64_t imsi, Ipv4Address ueAddr)
   NS_LOG_FUNCTION (this << imsi << ueAddr);
   std::map<uint64_t, Ptr<UeInfo> >::iterator ueit = m_ueInfoByImsiMap.find (imsi);
   NS_ASSERT_MSG (ueit != m_ueInfoByImsiMap.end (), "unknown IMSI " << imsi); 
-  m_ueInfoByAddrMap[ueAddr] = ueit->second;
+  m_ueInfoByAddrMap[ueAddr.Get ()] = ueit->second;
   ueit->second->SetUeAddr (ueAddr);
 }
 
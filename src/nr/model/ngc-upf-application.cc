@@ -0,0 +1,236 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ngc-upf-application.h"
+#include "ns3/log.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ngc-gtpu-header.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NgcUpfApplication");
+
+TypeId
+NgcUpfApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NgcUpfApplication")
+    .SetParent<Application> ()
+    .SetGroupName("Nr");
+  return tid;
+}
+
+void
+NgcUpfApplication::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_n3Tunnel->Dispose ();
+  m_n3Tunnel = 0;
+  m_tunDevice = 0;
+  m_sessionByUeAddrMap.Clear ();
+  m_sessionBySeidMap.clear ();
+  delete (m_n4SapUpf);
+  m_n4SapUpf = 0;
+  Application::DoDispose ();
+}
+
+NgcUpfApplication::NgcUpfApplication (const Ptr<VirtualNetDevice> tunDevice, const Ptr<Socket> n3Socket, uint32_t upfId)
+  : m_tunDevice (tunDevice),
+    m_upfId (upfId),
+    m_n4SapSmf (0)
+{
+  NS_LOG_FUNCTION (this << tunDevice << n3Socket << upfId);
+  m_n3Tunnel = CreateObject<UdpTunnelEndpoint> ();
+  m_n3Tunnel->SetSocket (n3Socket);
+  m_n3Tunnel->SetRecvCallback (MakeCallback (&NgcUpfApplication::RecvFromN3Tunnel, this));
+  m_n4SapUpf = new MemberNgcN4SapUpf<NgcUpfApplication> (this);
+}
+
+NgcUpfApplication::~NgcUpfApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+NgcUpfApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber)
+{
+  NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
+
+  // get IP address of UE
+  Ipv4Header ipv4Header;
+  packet->PeekHeader (ipv4Header);
+  Ipv4Address ueAddr = ipv4Header.GetDestination ();
+  NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
+
+  Ptr<SessionInfo> *session = m_sessionByUeAddrMap.Find (ueAddr.Get ());
+  if (session == 0)
+    {
+      NS_LOG_WARN ("no session for UE address " << ueAddr << " in UPF " << m_upfId);
+    }
+  else
+    {
+      // we hardcode DOWNLINK direction since the UPF is expected to
+      // classify only downlink packets (uplink packets will go to the
+      // internet without any classification).
+      uint32_t teid = (*session)->tftClassifier.Classify (packet, NgcTft::DOWNLINK);
+      if (teid == 0)
+        {
+          NS_LOG_WARN ("no matching bearer for this packet");
+        }
+      else
+        {
+          SendToN3Tunnel (packet, (*session)->enbAddr, teid);
+        }
+    }
+  // there is no reason why we should notify the TUN
+  // VirtualNetDevice that he failed to send the packet: if we receive
+  // any bogus packet, it will just be silently discarded.
+  return true;
+}
+
+void
+NgcUpfApplication::RecvFromN3Tunnel (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  NrGtpuHeader gtpu;
+  packet->RemoveHeader (gtpu);
+  SendToTunDevice (packet);
+}
+
+void
+NgcUpfApplication::SendToTunDevice (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  NS_LOG_LOGIC (" packet size: " << packet->GetSize () << " bytes");
+  m_tunDevice->Receive (packet, 0x0800, m_tunDevice->GetAddress (), m_tunDevice->GetAddress (), NetDevice::PACKET_HOST);
+}
+
+void
+NgcUpfApplication::SendToN3Tunnel (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid)
+{
+  NS_LOG_FUNCTION (this << packet << enbAddr << teid);
+  NrGtpuHeader gtpu;
+  gtpu.SetTeid (teid);
+  // From 3GPP TS 29.281 v10.0.0 Section 5.1
+  // Length of the payload + the non obligatory GTP-U header
+  gtpu.SetLength (packet->GetSize () + gtpu.GetSerializedSize () - 8);
+  m_n3Tunnel->Send (packet, gtpu, enbAddr);
+}
+
+void
+NgcUpfApplication::SetN4SapSmf (NgcN4SapSmf * s)
+{
+  m_n4SapSmf = s;
+}
+
+NgcN4SapUpf*
+NgcUpfApplication::GetN4SapUpf ()
+{
+  return m_n4SapUpf;
+}
+
+uint32_t
+NgcUpfApplication::GetUpfId () const
+{
+  return m_upfId;
+}
+
+uint32_t
+NgcUpfApplication::GetNSessions () const
+{
+  return m_sessionBySeidMap.size ();
+}
+
+void
+NgcUpfApplication::DoSessionEstablishmentRequest (NgcN4SapUpf::SessionEstablishmentRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.seid << req.ueAddr << req.enbAddr);
+  Ptr<SessionInfo> session = Create<SessionInfo> ();
+  session->ueAddr = req.ueAddr;
+  session->enbAddr = req.enbAddr;
+  for (std::list<NgcN4Sap::BearerContext>::iterator bit = req.bearerContextsToBeCreated.begin ();
+       bit != req.bearerContextsToBeCreated.end ();
+       ++bit)
+    {
+      session->teidByBearerId[bit->epsBearerId] = bit->teid;
+      session->tftClassifier.Add (bit->tft, bit->teid);
+    }
+  m_sessionBySeidMap[req.seid] = session;
+  m_sessionByUeAddrMap[req.ueAddr.Get ()] = session;
+
+  NgcN4SapSmf::SessionResponseMessage res;
+  res.seid = req.seid;
+  res.upfId = m_upfId;
+  res.cause = NgcN4Sap::REQUEST_ACCEPTED;
+  m_n4SapSmf->SessionEstablishmentResponse (res);
+}
+
+void
+NgcUpfApplication::DoSessionModificationRequest (NgcN4SapUpf::SessionModificationRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.seid << req.enbAddr);
+  NgcN4SapSmf::SessionResponseMessage res;
+  res.seid = req.seid;
+  res.upfId = m_upfId;
+  std::map<uint64_t, Ptr<SessionInfo> >::iterator it = m_sessionBySeidMap.find (req.seid);
+  if (it == m_sessionBySeidMap.end ())
+    {
+      res.cause = NgcN4Sap::SESSION_CONTEXT_NOT_FOUND;
+    }
+  else
+    {
+      if (req.enbAddr != Ipv4Address::GetAny ())
+        {
+          it->second->enbAddr = req.enbAddr;
+        }
+      for (std::list<uint8_t>::iterator bit = req.bearersToBeRemoved.begin ();
+           bit != req.bearersToBeRemoved.end ();
+           ++bit)
+        {
+          std::map<uint8_t, uint32_t>::iterator teidIt = it->second->teidByBearerId.find (*bit);
+          if (teidIt != it->second->teidByBearerId.end ())
+            {
+              it->second->tftClassifier.Delete (teidIt->second);
+              it->second->teidByBearerId.erase (teidIt);
+            }
+        }
+      res.cause = NgcN4Sap::REQUEST_ACCEPTED;
+    }
+  m_n4SapSmf->SessionModificationResponse (res);
+}
+
+void
+NgcUpfApplication::DoSessionDeletionRequest (NgcN4SapUpf::SessionDeletionRequestMessage req)
+{
+  NS_LOG_FUNCTION (this << req.seid);
+  NgcN4SapSmf::SessionResponseMessage res;
+  res.seid = req.seid;
+  res.upfId = m_upfId;
+  std::map<uint64_t, Ptr<SessionInfo> >::iterator it = m_sessionBySeidMap.find (req.seid);
+  if (it == m_sessionBySeidMap.end ())
+    {
+      res.cause = NgcN4Sap::SESSION_CONTEXT_NOT_FOUND;
+    }
+  else
+    {
+      m_sessionByUeAddrMap.Erase (it->second->ueAddr.Get ());
+      m_sessionBySeidMap.erase (it);
+      res.cause = NgcN4Sap::REQUEST_ACCEPTED;
+    }
+  m_n4SapSmf->SessionDeletionResponse (res);
+}
+
+} // namespace ns3
@@ -0,0 +1,188 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NGC_UPF_APPLICATION_H
+#define NGC_UPF_APPLICATION_H
+
+#include <ns3/address.h>
+#include <ns3/socket.h>
+#include <ns3/virtual-net-device.h>
+#include <ns3/ptr.h>
+#include <ns3/ngc-tft.h>
+#include <ns3/ngc-tft-classifier.h>
+#include <ns3/application.h>
+#include <ns3/ngc-n4-sap.h>
+#include <ns3/flat-hash-map.h>
+#include <ns3/udp-tunnel-endpoint.h>
+#include <map>
+
+namespace ns3 {
+
+/**
+ * \ingroup nr
+ *
+ * This application implements the user plane of a UPF: it tunnels the
+ * packets of the UEs between its N6 interface, a TUN VirtualNetDevice,
+ * and the eNBs over GTP-U/UDP/IP on its N3 interface. It holds no
+ * control state of its own: the SMF establishes, modifies and deletes
+ * the sessions of the UEs through the N4 SAP, so that several UPFs can
+ * serve the sessions of one SMF.
+ */
+class NgcUpfApplication : public Application
+{
+  friend class MemberNgcN4SapUpf<NgcUpfApplication>;
+
+public:
+
+  // inherited from Object
+  static TypeId GetTypeId (void);
+  virtual void DoDispose ();
+
+  /**
+   * Constructor that binds the tap device to the callback methods.
+   *
+   * \param tunDevice TUN VirtualNetDevice used to tunnel IP packets from
+   * the N6 interface of the UPF over GTP-U/UDP/IP on the N3 interface
+   * \param n3Socket socket used to send GTP-U packets to the eNBs
+   * \param upfId the identifier of the UPF in the pool of its SMF
+   */
+  NgcUpfApplication (const Ptr<VirtualNetDevice> tunDevice, const Ptr<Socket> n3Socket, uint32_t upfId);
+
+  /**
+   * Destructor
+   */
+  virtual ~NgcUpfApplication (void);
+
+  /**
+   * Method to be assigned to the callback of the N6 TUN VirtualNetDevice.
+   * It is called when the UPF receives a data packet from the internet
+   * (including IP headers) that is to be sent to the UE via its
+   * associated eNB, tunneling IP over GTP-U/UDP/IP.
+   *
+   * \param packet
+   * \param source
+   * \param dest
+   * \param protocolNumber
+   * \return true always
+   */
+  bool RecvFromTunDevice (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+
+  /**
+   * Method to be assigned to the recv callback of the N3 tunnel
+   * endpoint. It is called when the UPF receives a data packet from the
+   * eNB that is to be forwarded to the internet.
+   *
+   * \param packet the packet, starting with its GTP-U header
+   */
+  void RecvFromN3Tunnel (Ptr<Packet> packet);
+
+  /**
+   * Set the SMF side of the N4 SAP
+   *
+   * \param s the SMF side of the N4 SAP
+   */
+  void SetN4SapSmf (NgcN4SapSmf * s);
+
+  /**
+   * \return the UPF side of the N4 SAP
+   */
+  NgcN4SapUpf* GetN4SapUpf ();
+
+  /**
+   * \return the identifier of the UPF in the pool of its SMF
+   */
+  uint32_t GetUpfId () const;
+
+  /**
+   * \return the number of sessions established in this UPF
+   */
+  uint32_t GetNSessions () const;
+
+private:
+
+  // N4 SAP UPF methods
+  void DoSessionEstablishmentRequest (NgcN4SapUpf::SessionEstablishmentRequestMessage msg);
+  void DoSessionModificationRequest (NgcN4SapUpf::SessionModificationRequestMessage msg);
+  void DoSessionDeletionRequest (NgcN4SapUpf::SessionDeletionRequestMessage msg);
+
+  /**
+   * Send a packet to the internet via the N6 interface of the UPF
+   *
+   * \param packet
+   */
+  void SendToTunDevice (Ptr<Packet> packet);
+
+  /**
+   * Send a packet to an eNB via the N3 interface
+   *
+   * \param packet packet to be sent
+   * \param enbAddr the address of the eNB
+   * \param teid the Tunnel Enpoint IDentifier
+   */
+  void SendToN3Tunnel (Ptr<Packet> packet, Ipv4Address enbAddr, uint32_t teid);
+
+  /**
+   * forwarding state of a session
+   */
+  struct SessionInfo : public SimpleRefCount<SessionInfo>
+  {
+    Ipv4Address ueAddr;
+    Ipv4Address enbAddr;
+    NgcTftClassifier tftClassifier;
+    std::map<uint8_t, uint32_t> teidByBearerId;
+  };
+
+  /**
+   * GTP-U tunnel endpoint to send and receive the packets to and from the N3 interface
+   */
+  Ptr<UdpTunnelEndpoint> m_n3Tunnel;
+
+  /**
+   * TUN VirtualNetDevice used for tunneling/detunneling IP packets
+   * from/to the internet over GTP-U/UDP/IP on the N3 interface
+   */
+  Ptr<VirtualNetDevice> m_tunDevice;
+
+  /**
+   * identifier of the UPF in the pool of its SMF
+   */
+  uint32_t m_upfId;
+
+  /**
+   * Map telling for each UE address, as a 32 bit integer, the
+   * corresponding session
+   */
+  FlatHashMap<Ptr<SessionInfo> > m_sessionByUeAddrMap;
+
+  /**
+   * Map telling for each SEID the corresponding session
+   */
+  std::map<uint64_t, Ptr<SessionInfo> > m_sessionBySeidMap;
+
+  /**
+   * SMF side of the N4 SAP
+   */
+  NgcN4SapSmf* m_n4SapSmf;
+
+  /**
+   * UPF side of the N4 SAP
+   */
+  NgcN4SapUpf* m_n4SapUpf;
+};
+
+} //namespace ns3
+
+#endif /* NGC_UPF_APPLICATION_H */
@@ -23,6 +23,7 @@
  */
 
 #include "ngc-x2-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -47,10 +48,10 @@ NgcX2Tag::NgcX2Tag (Time senderTimestamp)
 TypeId
 NgcX2Tag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::NgcX2Tag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::NgcX2Tag")
     .SetParent<Tag> ()
     .SetGroupName("Nr")
-    .AddConstructor<NgcX2Tag> ();
+    .AddConstructor<NgcX2Tag> ());
   return tid;
 }
 
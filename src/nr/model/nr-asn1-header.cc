@@ -23,12 +23,42 @@
 
 #include <stdio.h>
 #include <sstream>
-#include <cmath>
+#include <vector>
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("NrAsn1Header");
 
+/**
+ * Scratch buffer of the bit writer. It is shared by the headers of a
+ * thread, since a PreSerialize never starts another one, and keeps its
+ * capacity, so that encoding a message does not allocate once the largest
+ * message was seen. Each thread has its own buffer, so that the cells run
+ * in parallel by CellParallelSimulatorImpl do not overwrite each other.
+ */
+static std::vector<uint8_t> &
+GetSerializationScratch (void)
+{
+  static thread_local std::vector<uint8_t> scratch;
+  return scratch;
+}
+
+/**
+ * \param range number of values of a constrained whole number
+ * \return the number of bits of its encoding, i.e., ceil (log2 (range))
+ */
+static uint8_t
+GetRequiredBits (int range)
+{
+  uint8_t bits = 0;
+  while (bits < 31 && (1 << bits) < range)
+    {
+      bits++;
+    }
+  return bits;
+}
+
 NS_OBJECT_ENSURE_REGISTERED (NrAsn1Header);
 
 TypeId
@@ -49,9 +79,11 @@ NrAsn1Header::GetInstanceTypeId (void) const
 
 NrAsn1Header::NrAsn1Header ()
 {
-  m_serializationPendingBits = 0x00;
+  m_serializationPendingBits = 0;
   m_numSerializationPendingBits = 0;
   m_isDataSerialized = false;
+  m_isDataDeserializing = false;
+  m_numDeserializedOctets = 0;
 }
 
 NrAsn1Header::~NrAsn1Header ()
@@ -61,8 +93,13 @@ NrAsn1Header::~NrAsn1Header ()
 uint32_t
 NrAsn1Header::GetSerializedSize (void) const
 {
+  if (m_isDataDeserializing)
+    {
+      FinalizeDeserialization ();
+    }
   if (!m_isDataSerialized)
     {
+      StartSerialization ();
       PreSerialize ();
     }
   return m_serializationResult.GetSize ();
@@ -70,102 +107,151 @@ NrAsn1Header::GetSerializedSize (void) const
 
 void NrAsn1Header::Serialize (Buffer::Iterator bIterator) const
 {
+  if (m_isDataDeserializing)
+    {
+      FinalizeDeserialization ();
+    }
   if (!m_isDataSerialized)
     {
+      StartSerialization ();
       PreSerialize ();
     }
   bIterator.Write (m_serializationResult.Begin (),m_serializationResult.End ());
 }
 
-void NrAsn1Header::WriteOctet (uint8_t octet) const
+void NrAsn1Header::StartSerialization (void) const
 {
-  m_serializationResult.AddAtEnd (1);
-  Buffer::Iterator bIterator = m_serializationResult.End ();
-  bIterator.Prev ();
-  bIterator.WriteU8 (octet);
+  GetSerializationScratch ().clear ();
+  m_serializationPendingBits = 0;
+  m_numSerializationPendingBits = 0;
 }
 
-template <int N>
-void NrAsn1Header::SerializeBitset (std::bitset<N> data) const
+void NrAsn1Header::FinalizeDeserialization (void) const
 {
+  // The octet holding the last bits read is part of the message
+  uint32_t numOctets = m_numDeserializedOctets - m_numSerializationPendingBits / 8;
+  Buffer::Iterator end = m_deserializationStart;
+  end.Next (numOctets);
+  m_serializationResult = Buffer ();
+  m_serializationResult.AddAtEnd (numOctets);
+  m_serializationResult.Begin ().Write (m_deserializationStart, end);
+  m_serializationPendingBits = 0;
+  m_numSerializationPendingBits = 0;
+  m_isDataDeserializing = false;
+  m_isDataSerialized = true;
+}
 
-  size_t dataSize = data.size ();
-  uint8_t pendingBits = dataSize;
-  uint8_t mask = 1;
-  int j;
+void NrAsn1Header::WriteOctet (uint8_t octet) const
+{
+  WriteBits (octet, 8);
+}
 
-  // No extension marker (Clause 16.7 ITU-T X.691),
-  // as 3GPP TS 36.331 does not use it in its IE's.
+void NrAsn1Header::WriteBits (uint64_t value, uint8_t numBits) const
+{
+  NS_ASSERT (numBits <= 64);
+  if (numBits == 0)
+    {
+      return;
+    }
+  if (numBits < 64)
+    {
+      value &= (((uint64_t) 1) << numBits) - 1;
+    }
 
-  // Clause 16.8 ITU-T X.691
-  if (dataSize == 0)
+  uint8_t freeBits = 64 - m_numSerializationPendingBits;
+  if (numBits < freeBits)
     {
+      m_serializationPendingBits |= value << (freeBits - numBits);
+      m_numSerializationPendingBits += numBits;
       return;
     }
 
-  // Clause 16.9 ITU-T X.691
-  // Clause 16.10 ITU-T X.691
-  if (dataSize <= 65536)
+  // Complete the pending word and flush it
+  uint8_t remainingBits = numBits - freeBits;
+  uint64_t word = m_serializationPendingBits | (value >> remainingBits);
+  std::vector<uint8_t> &scratch = GetSerializationScratch ();
+  for (int shift = 56; shift >= 0; shift -= 8)
     {
-      // If there are bits pending to be processed,
-      // append first bits in data to complete an octet.
-      if (m_numSerializationPendingBits > 0)
-        {
-          mask = 0x80 >> m_numSerializationPendingBits;
-          while (pendingBits > 0 && m_numSerializationPendingBits < 8)
-            {
-              m_serializationPendingBits |= (data[pendingBits - 1]) ? mask : 0;
-              pendingBits--;
-              m_numSerializationPendingBits++;
-              mask = (mask >> 1) & (~mask);
-            }
+      scratch.push_back ((uint8_t) (word >> shift));
+    }
+  m_serializationPendingBits = (remainingBits > 0) ? value << (64 - remainingBits) : 0;
+  m_numSerializationPendingBits = remainingBits;
+}
 
-          if (m_numSerializationPendingBits >= 8)
+uint64_t NrAsn1Header::ReadBits (uint8_t numBits, Buffer::Iterator &bIterator)
+{
+  NS_ASSERT (numBits <= 64);
+  uint64_t value = 0;
+  while (numBits > 0)
+    {
+      if (m_numSerializationPendingBits == 0)
+        {
+          if (!m_isDataDeserializing)
             {
-              WriteOctet (m_serializationPendingBits);
-              m_numSerializationPendingBits = 0;
-              m_serializationPendingBits = 0;
+              m_isDataDeserializing = true;
+              m_deserializationStart = bIterator;
+              m_numDeserializedOctets = 0;
             }
-        }
-
-      while (pendingBits > 0)
-        {
-          mask = 1;
-          j = 8;
-
-          // If there are less than 8 remaining bits,
-          // store it to m_serializationPendingBits.
-          if (pendingBits < 8)
+          uint32_t available = bIterator.GetRemainingSize ();
+          NS_ASSERT_MSG (available > 0, "ASN.1 message truncated");
+          if (available >= 8)
             {
-              mask = 0x80;
-              m_numSerializationPendingBits = pendingBits;
-              while (pendingBits > 0)
-                {
-                  m_serializationPendingBits |= (data[pendingBits - 1]) ? mask : 0;
-                  mask = (mask >> 1) & (~mask);
-                  pendingBits--;
-                }
+              m_serializationPendingBits = bIterator.ReadNtohU64 ();
+              m_numSerializationPendingBits = 64;
             }
-
-          // Write the data to buffer
           else
             {
-              uint8_t octetToWrite = 0;
-              for (; j > 0; j--)
+              m_serializationPendingBits = 0;
+              for (uint32_t i = 0; i < available; i++)
                 {
-                  octetToWrite |= (data[pendingBits - j]) ? mask : 0;
-                  mask = (mask << 1) & (~mask);
+                  m_serializationPendingBits |= ((uint64_t) bIterator.ReadU8 ()) << (56 - 8 * i);
                 }
-              WriteOctet (octetToWrite);
-              pendingBits -= 8;
+              m_numSerializationPendingBits = 8 * available;
             }
+          m_numDeserializedOctets += m_numSerializationPendingBits / 8;
         }
+
+      uint8_t n = std::min (numBits, m_numSerializationPendingBits);
+      value = (n < 64) ? (value << n) : 0;
+      value |= m_serializationPendingBits >> (64 - n);
+      m_serializationPendingBits = (n < 64) ? (m_serializationPendingBits << n) : 0;
+      m_numSerializationPendingBits -= n;
+      numBits -= n;
+    }
+  return value;
+}
+
+template <int N>
+void NrAsn1Header::SerializeBitset (std::bitset<N> data) const
+{
+  // No extension marker (Clause 16.7 ITU-T X.691),
+  // as 3GPP TS 36.331 does not use it in its IE's.
+
+  // Clause 16.8 ITU-T X.691
+  if (N == 0)
+    {
+      return;
     }
 
   // Clause 16.11 ITU-T X.691
-  else
+  if (N > 65536)
     {
       printf ("FRAGMENTATION NEEDED!\n");
+      return;
+    }
+
+  // Clause 16.9 ITU-T X.691
+  // Clause 16.10 ITU-T X.691
+  if (N <= 64)
+    {
+      WriteBits (data.to_ullong (), N);
+    }
+  else
+    {
+      for (int i = N; i > 0; i--)
+        {
+          WriteBits (data[i - 1], 1);
+        }
     }
 }
 
@@ -336,76 +422,13 @@ void NrAsn1Header::SerializeInteger (int n, int nmin, int nmax) const
     }
 
   // Clause 11.5.6 ITU-T X.691
-  int requiredBits = std::ceil (std::log (range) / std::log (2.0));
-
-  switch (requiredBits)
+  uint8_t requiredBits = GetRequiredBits (range);
+  if (requiredBits > 20)
     {
-    case 1:
-      SerializeBitset<1> (std::bitset<1> (n));
-      break;
-    case 2:
-      SerializeBitset<2> (std::bitset<2> (n));
-      break;
-    case 3:
-      SerializeBitset<3> (std::bitset<3> (n));
-      break;
-    case 4:
-      SerializeBitset<4> (std::bitset<4> (n));
-      break;
-    case 5:
-      SerializeBitset<5> (std::bitset<5> (n));
-      break;
-    case 6:
-      SerializeBitset<6> (std::bitset<6> (n));
-      break;
-    case 7:
-      SerializeBitset<7> (std::bitset<7> (n));
-      break;
-    case 8:
-      SerializeBitset<8> (std::bitset<8> (n));
-      break;
-    case 9:
-      SerializeBitset<9> (std::bitset<9> (n));
-      break;
-    case 10:
-      SerializeBitset<10> (std::bitset<10> (n));
-      break;
-    case 11:
-      SerializeBitset<11> (std::bitset<11> (n));
-      break;
-    case 12:
-      SerializeBitset<12> (std::bitset<12> (n));
-      break;
-    case 13:
-      SerializeBitset<13> (std::bitset<13> (n));
-      break;
-    case 14:
-      SerializeBitset<14> (std::bitset<14> (n));
-      break;
-    case 15:
-      SerializeBitset<15> (std::bitset<15> (n));
-      break;
-    case 16:
-      SerializeBitset<16> (std::bitset<16> (n));
-      break;
-    case 17:
-      SerializeBitset<17> (std::bitset<17> (n));
-      break;
-    case 18:
-      SerializeBitset<18> (std::bitset<18> (n));
-      break;
-    case 19:
-      SerializeBitset<19> (std::bitset<19> (n));
-      break;
-    case 20:
-      SerializeBitset<20> (std::bitset<20> (n));
-      break;
-    default:
-      {
-        std::cout << "SerializeInteger " << requiredBits << " Out of range!!" << std::endl;
-        exit (1);
-      }
+      std::cout << "SerializeInteger " << (int) requiredBits << " Out of range!!" << std::endl;
+      exit (1);
     }
+  WriteBits (n, requiredBits);
 }
 
 void NrAsn1Header::SerializeNull () const
@@ -416,10 +439,24 @@ void NrAsn1Header::SerializeNull () const
 
 void NrAsn1Header::FinalizeSerialization () const
 {
-  if (m_numSerializationPendingBits > 0)
+  std::vector<uint8_t> &scratch = GetSerializationScratch ();
+
+  // Flush the pending bits, padding the last octet with zeros
+  for (int shift = 56; m_numSerializationPendingBits > 0; shift -= 8)
+    {
+      scratch.push_back ((uint8_t) (m_serializationPendingBits >> shift));
+      m_numSerializationPendingBits = (m_numSerializationPendingBits > 8) ? m_numSerializationPendingBits - 8 : 0;
+    }
+  m_serializationPendingBits = 0;
+
+  // Single copy of the encoding to the result
+  if (!scratch.empty ())
     {
-      m_numSerializationPendingBits = 0;
-      SerializeBitset<8> (std::bitset<8> (m_serializationPendingBits));
+      m_serializationResult.AddAtEnd (scratch.size ());
+      Buffer::Iterator bIterator = m_serializationResult.End ();
+      bIterator.Prev (scratch.size ());
+      bIterator.Write (&scratch[0], scratch.size ());
+      scratch.clear ();
     }
   m_isDataSerialized = true;
 }
@@ -427,53 +464,17 @@ void NrAsn1Header::FinalizeSerialization () const
 template <int N>
 Buffer::Iterator NrAsn1Header::DeserializeBitset (std::bitset<N> *data, Buffer::Iterator bIterator)
 {
-
-  int bitsToRead = N;
-  uint8_t mask;
-
-  // Read bits from pending bits
-  if (m_numSerializationPendingBits > 0)
+  if (N <= 64)
     {
-      while (bitsToRead > 0 && m_numSerializationPendingBits > 0)
-        {
-          data->set (bitsToRead - 1,(m_serializationPendingBits & 0x80) ? 1 : 0);
-          bitsToRead--;
-          m_numSerializationPendingBits--;
-          m_serializationPendingBits = m_serializationPendingBits << 1;
-        }
+      *data = std::bitset<N> (ReadBits (N, bIterator));
     }
-
-  // Read bits from buffer
-  while (bitsToRead > 0)
+  else
     {
-      uint8_t octet = bIterator.ReadU8 ();
-      // If 8 bits can be allocated to the bitset, set the bits
-      if (bitsToRead >= 8)
-        {
-          mask = 0x80;
-          for (int j = 0; j < 8; j++)
-            {
-              data->set (bitsToRead - 1,(octet & mask) ? 1 : 0);
-              bitsToRead--;
-              mask = mask >> 1;
-            }
-        }
-
-      // Otherwise, we'll have to save the remaining bits
-      else
+      for (int i = N; i > 0; i--)
         {
-          mask = 0x80;
-          m_numSerializationPendingBits = 8 - bitsToRead;
-          m_serializationPendingBits = octet << bitsToRead;
-          while (bitsToRead > 0)
-            {
-              data->set (bitsToRead - 1,(octet & mask) ? 1 : 0);
-              bitsToRead--;
-              mask = mask >> 1;
-            }
+          data->set (i - 1, ReadBits (1, bIterator) != 0);
         }
     }
-
   return bIterator;
 }
 
@@ -548,117 +549,13 @@ Buffer::Iterator NrAsn1Header::DeserializeInteger (int *n, int nmin, int nmax, B
       return bIterator;
     }
 
-  int requiredBits = std::ceil (std::log (range) / std::log (2.0));
-
-  std::bitset<1> bitsRead1;
-  std::bitset<2> bitsRead2;
-  std::bitset<3> bitsRead3;
-  std::bitset<4> bitsRead4;
-  std::bitset<5> bitsRead5;
-  std::bitset<6> bitsRead6;
-  std::bitset<7> bitsRead7;
-  std::bitset<8> bitsRead8;
-  std::bitset<9> bitsRead9;
-  std::bitset<10> bitsRead10;
-  std::bitset<11> bitsRead11;
-  std::bitset<12> bitsRead12;
-  std::bitset<13> bitsRead13;
-  std::bitset<14> bitsRead14;
-  std::bitset<15> bitsRead15;
-  std::bitset<16> bitsRead16;
-  std::bitset<17> bitsRead17;
-  std::bitset<18> bitsRead18;
-  std::bitset<19> bitsRead19;
-  std::bitset<20> bitsRead20;
-
-  switch (requiredBits)
+  uint8_t requiredBits = GetRequiredBits (range);
+  if (requiredBits > 20)
     {
-    case 1:
-      bIterator = DeserializeBitset<1> (&bitsRead1,bIterator);
-      *n = (int)bitsRead1.to_ulong ();
-      break;
-    case 2: 
-      bIterator = DeserializeBitset<2> (&bitsRead2,bIterator);
-      *n = (int)bitsRead2.to_ulong ();
-      break;
-    case 3: 
-      bIterator = DeserializeBitset<3> (&bitsRead3,bIterator);
-      *n = (int)bitsRead3.to_ulong ();
-      break;
-    case 4: 
-      bIterator = DeserializeBitset<4> (&bitsRead4,bIterator);
-      *n = (int)bitsRead4.to_ulong ();
-      break;
-    case 5:
-      bIterator = DeserializeBitset<5> (&bitsRead5,bIterator);
-      *n = (int)bitsRead5.to_ulong ();
-      break;
-    case 6:
-      bIterator = DeserializeBitset<6> (&bitsRead6,bIterator);
-      *n = (int)bitsRead6.to_ulong ();
-      break;
-    case 7:
-      bIterator = DeserializeBitset<7> (&bitsRead7,bIterator);
-      *n = (int)bitsRead7.to_ulong ();
-      break;
-    case 8:
-      bIterator = DeserializeBitset<8> (&bitsRead8,bIterator);
-      *n = (int)bitsRead8.to_ulong ();
-      break;
-    case 9:
-      bIterator = DeserializeBitset<9> (&bitsRead9,bIterator);
-      *n = (int)bitsRead9.to_ulong ();
-      break;
-    case 10:
-      bIterator = DeserializeBitset<10> (&bitsRead10,bIterator);
-      *n = (int)bitsRead10.to_ulong ();
-      break;
-    case 11:
-      bIterator = DeserializeBitset<11> (&bitsRead11,bIterator);
-      *n = (int)bitsRead11.to_ulong ();
-      break;
-    case 12:
-      bIterator = DeserializeBitset<12> (&bitsRead12,bIterator);
-      *n = (int)bitsRead12.to_ulong ();
-      break;
-    case 13:
-      bIterator = DeserializeBitset<13> (&bitsRead13,bIterator);
-      *n = (int)bitsRead13.to_ulong ();
-      break;
-    case 14:
-      bIterator = DeserializeBitset<14> (&bitsRead14,bIterator);
-      *n = (int)bitsRead14.to_ulong ();
-      break;
-    case 15:
-      bIterator = DeserializeBitset<15> (&bitsRead15,bIterator);
-      *n = (int)bitsRead15.to_ulong ();
-      break;
-    case 16:
-      bIterator = DeserializeBitset<16> (&bitsRead16,bIterator);
-      *n = (int)bitsRead16.to_ulong ();
-      break;
-    case 17:
-      bIterator = DeserializeBitset<17> (&bitsRead17,bIterator);
-      *n = (int)bitsRead17.to_ulong ();
-      break;
-    case 18:
-      bIterator = DeserializeBitset<18> (&bitsRead18,bIterator);
-      *n = (int)bitsRead18.to_ulong ();
-      break;
-    case 19:
-      bIterator = DeserializeBitset<19> (&bitsRead19,bIterator);
-      *n = (int)bitsRead19.to_ulong ();
-      break;
-    case 20:
-      bIterator = DeserializeBitset<20> (&bitsRead20,bIterator);
-      *n = (int)bitsRead20.to_ulong ();
-      break;
-    default:
-      {
-        std::cout << "SerializeInteger Out of range!!" << std::endl;
-        exit (1);
-      }
+      std::cout << "SerializeInteger Out of range!!" << std::endl;
+      exit (1);
     }
+  *n = (int) ReadBits (requiredBits, bIterator);
 
   *n += nmin;
 
@@ -2073,6 +2073,7 @@ UeManager::RecvRrcConnectionReconfigurationCompleted (NrRrcSap::RrcConnectionRec
             NgcEnbN2SapProvider::BearerToBeSwitched b;
             b.epsBearerId = it->second->m_epsBearerIdentity;
             b.teid =  it->second->m_gtpTeid;
+            b.transportLayerAddress = it->second->m_transportLayerAddress;
             params.bearersToBeSwitched.push_back (b);
           }
             m_rrc->m_n2SapProvider->PathSwitchRequest (params);
@@ -5183,6 +5184,15 @@ NrEnbRrc::DoRegistrationAccept (NgcEnbN2SapUser::RegistrationAcceptParameters pa
   Ptr<UeManager> ueManager = GetUeManager (params.rnti);
   ueManager->RegistrationAccept (params);
 }
+void
+NrEnbRrc::DoRegistrationReject (NgcEnbN2SapUser::RegistrationRejectParameters params)
+{
+  NS_LOG_FUNCTION (this << params.rnti << (uint32_t) params.cause << params.t3346);
+  // the NAS of the UE has no back-off: the UE stays connected and
+  // deregistered until it registers again
+  NS_LOG_WARN ("registration of RNTI " << params.rnti << " rejected with 5GMM cause "
+               << (uint32_t) params.cause);
+}
 void 
 NrEnbRrc::DoPathSwitchRequestAcknowledge (NgcEnbN2SapUser::PathSwitchRequestAcknowledgeParameters params)
 {
@@ -1133,6 +1133,7 @@ private:
   void DoIdentityRequest (NgcEnbN2SapUser::IdentityRequestParameters params);
   void DoRecvRrcIdentityResponse (uint16_t rnti, NrRrcSap::RrcIdentityResponse msg);
   void DoRegistrationAccept (NgcEnbN2SapUser::RegistrationAcceptParameters params);
+  void DoRegistrationReject (NgcEnbN2SapUser::RegistrationRejectParameters params);
   void DoRecvRrcRegistrationComplete (uint16_t rnti, NrRrcSap::RrcRegistrationComplete msg);
   
 
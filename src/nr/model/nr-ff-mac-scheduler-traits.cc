@@ -0,0 +1,87 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/nr-ff-mac-scheduler-traits.h>
+#include <ns3/nr-common.h>
+#include <ns3/nr-vendor-specific-parameters.h>
+
+namespace ns3 {
+
+NrFfMacSchedulerTraits::Scheduler::Scheduler ()
+  : m_ffrSapProvider (0)
+{
+  m_ffrSapUser = new MemberNrFfrSapUser<Scheduler> (this);
+}
+
+NrFfMacSchedulerTraits::Scheduler::~Scheduler ()
+{
+}
+
+void
+NrFfMacSchedulerTraits::Scheduler::DoDispose ()
+{
+  delete m_ffrSapUser;
+  m_ffrSapUser = 0;
+  NrFfMacScheduler::DoDispose ();
+}
+
+void
+NrFfMacSchedulerTraits::Scheduler::SetNrFfrSapProvider (NrFfrSapProvider* s)
+{
+  m_ffrSapProvider = s;
+}
+
+NrFfrSapUser*
+NrFfMacSchedulerTraits::Scheduler::GetNrFfrSapUser ()
+{
+  return m_ffrSapUser;
+}
+
+uint8_t
+NrFfMacSchedulerTraits::TxMode2LayerNum (uint8_t txMode)
+{
+  return NrTransmissionModesLayers::TxMode2LayerNum (txMode);
+}
+
+uint32_t
+NrFfMacSchedulerTraits::BsrId2BufferSize (uint8_t bsrId)
+{
+  return NrBufferSizeLevelBsr::BsrId2BufferSize (bsrId);
+}
+
+double
+NrFfMacSchedulerTraits::FpS11dot3toDouble (uint16_t val)
+{
+  return NrFfConverter::fpS11dot3toDouble (val);
+}
+
+uint16_t
+NrFfMacSchedulerTraits::GetSrsCqiRnti (const FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+  uint16_t rnti = 0;
+  NS_ASSERT (params.m_vendorSpecificList.size () > 0);
+  for (uint16_t i = 0; i < params.m_vendorSpecificList.size (); i++)
+    {
+      if (params.m_vendorSpecificList.at (i).m_type == SRS_CQI_RNTI_VSP)
+        {
+          Ptr<SrsCqiRntiVsp> vsp = DynamicCast<SrsCqiRntiVsp> (params.m_vendorSpecificList.at (i).m_value);
+          rnti = vsp->GetRnti ();
+        }
+    }
+  return rnti;
+}
+
+} // namespace ns3
@@ -0,0 +1,85 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NR_FF_MAC_SCHEDULER_TRAITS_H
+#define NR_FF_MAC_SCHEDULER_TRAITS_H
+
+#include <ns3/nr-ff-mac-scheduler.h>
+#include <ns3/ff-mac-sched-sap.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-ffr-sap.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup ff-api
+ *
+ * The types and conversions of the nr module used by
+ * FfMacSchedulerEngine. The nr schedulers derive from NrFfMacScheduler, use
+ * the NrAmc and reach the FFR algorithm through the NrFfrSap.
+ */
+struct NrFfMacSchedulerTraits
+{
+  typedef NrAmc Amc;                        ///< AMC module
+  typedef NrFfrSapProvider FfrSapProvider;  ///< provider part of the FFR SAP
+
+  /**
+   * NrFfMacScheduler owning the user part of the NrFfrSap
+   */
+  class Scheduler : public NrFfMacScheduler
+  {
+  public:
+    Scheduler ();
+    virtual ~Scheduler ();
+
+    // inherited from NrFfMacScheduler
+    virtual void DoDispose (void);
+    virtual void SetNrFfrSapProvider (NrFfrSapProvider* s);
+    virtual NrFfrSapUser* GetNrFfrSapUser ();
+
+  protected:
+    NrFfrSapProvider* m_ffrSapProvider; ///< FFR SAP provider
+    NrFfrSapUser* m_ffrSapUser;         ///< FFR SAP user
+  };
+
+  /**
+   * \param txMode the transmission mode
+   * \return the number of layers of the transmission mode
+   */
+  static uint8_t TxMode2LayerNum (uint8_t txMode);
+
+  /**
+   * \param bsrId the BSR index
+   * \return the buffer size, in bytes
+   */
+  static uint32_t BsrId2BufferSize (uint8_t bsrId);
+
+  /**
+   * \param val the SINR in fixed point notation Sxxxxxxxxxxx.xxx
+   * \return the SINR
+   */
+  static double FpS11dot3toDouble (uint16_t val);
+
+  /**
+   * \param params an SRS based UL CQI report
+   * \return the RNTI carried by the vendor specific parameters of the report
+   */
+  static uint16_t GetSrsCqiRnti (const FfMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+};
+
+} // namespace ns3
+
+#endif /* NR_FF_MAC_SCHEDULER_TRAITS_H */
@@ -20,6 +20,7 @@
 
 
 #include "nr-radio-bearer-tag.h"
+#include "ns3/packet-tag-list.h"
 #include "ns3/tag.h"
 #include "ns3/uinteger.h"
 
@@ -30,7 +31,7 @@ NS_OBJECT_ENSURE_REGISTERED (NrRadioBearerTag);
 TypeId
 NrRadioBearerTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::NrRadioBearerTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::NrRadioBearerTag")
     .SetParent<Tag> ()
     .SetGroupName("Nr")
     .AddConstructor<NrRadioBearerTag> ()
@@ -42,7 +43,7 @@ NrRadioBearerTag::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&NrRadioBearerTag::GetLcid),
                    MakeUintegerChecker<uint8_t> ())
-  ;
+  );
   return tid;
 }
 
@@ -19,6 +19,7 @@
  */
 
 #include "ns3/nr-rlc-sdu-status-tag.h"
+#include "ns3/packet-tag-list.h"
 
 namespace ns3 {
 
@@ -43,11 +44,11 @@ NrRlcSduStatusTag::GetStatus (void) const
 TypeId
 NrRlcSduStatusTag::GetTypeId (void)
 {
-  static TypeId tid = TypeId ("ns3::NrRlcSduStatusTag")
+  static TypeId tid = PacketTagList::RegisterSlot (TypeId ("ns3::NrRlcSduStatusTag")
     .SetParent<Tag> ()
     .SetGroupName("Nr")
     .AddConstructor<NrRlcSduStatusTag> ()
-  ;
+  );
   return tid;
 }
 TypeId
@@ -20,6 +20,8 @@
 
 #include <ns3/object.h>
 #include <ns3/simulator.h>
+#include <ns3/cell-parallel-batch.h>
+#include <ns3/make-event.h>
 #include <ns3/log.h>
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
@@ -262,6 +264,13 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
 
+  if (CellParallelBatch::IsRunning ())
+    {
+      // the channel and the receivers are shared by the cells: propagate
+      // the signal once the parallel events of the cells completed
+      CellParallelBatch::ScheduleAtBarrier (MakeEvent (&MultiModelSpectrumChannel::StartTx, this, txParams));
+      return;
+    }
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
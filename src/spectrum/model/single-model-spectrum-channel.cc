@@ -20,6 +20,8 @@
 
 #include <ns3/object.h>
 #include <ns3/simulator.h>
+#include <ns3/cell-parallel-batch.h>
+#include <ns3/make-event.h>
 #include <ns3/log.h>
 #include <ns3/packet.h>
 #include <ns3/packet-burst.h>
@@ -117,6 +119,14 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
   NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
 
+  if (CellParallelBatch::IsRunning ())
+    {
+      // the channel and the receivers are shared by the cells: propagate
+      // the signal once the parallel events of the cells completed
+      CellParallelBatch::ScheduleAtBarrier (MakeEvent (&SingleModelSpectrumChannel::StartTx, this, txParams));
+      return;
+    }
+
   // just a sanity check routine. We might want to remove it to save some computational load -- one "if" statement  ;-)
   if (m_spectrumModel == 0)
     {
@@ -145,6 +145,9 @@ Bench::Cb (void)
 }
 
 
+/// Delays read from the event file, in ns, kept to replay them on every scheduler
+std::vector<double> g_nsValues;
+
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
 {
@@ -155,105 +158,66 @@ GetRandomStream (std::string filename)
       LOGME ("using default exponential distribution");
       Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
       erv->SetAttribute ("Mean", DoubleValue (100));
+      // the same sequence for every scheduler
+      erv->SetStream (1);
       stream = erv;
     }
   else
     {
-      std::istream *input;
-
-      if (filename == "-")
-        {
-          LOGME ("using event distribution from stdin");
-          input = &std::cin;
-        }
-      else
+      if (g_nsValues.empty ())
         {
-          LOGME ("using event distribution from " << filename);
-          input = new std::ifstream (filename.c_str ());
-        }
-
-      double value;
-      std::vector<double> nsValues;
+          std::istream *input;
 
-      while (!input->eof ())
-        {
-          if (*input >> value)
+          if (filename == "-")
             {
-              uint64_t ns = (uint64_t) (value * 1000000000);
-              nsValues.push_back (ns);
+              LOGME ("using event distribution from stdin");
+              input = &std::cin;
             }
           else
             {
-              input->clear ();
-              std::string line;
-              *input >> line;
+              LOGME ("using event distribution from " << filename);
+              input = new std::ifstream (filename.c_str ());
             }
+
+          double value;
+
+          while (!input->eof ())
+            {
+              if (*input >> value)
+                {
+                  uint64_t ns = (uint64_t) (value * 1000000000 + 0.5);
+                  g_nsValues.push_back (ns);
+                }
+              else
+                {
+                  input->clear ();
+                  std::string line;
+                  *input >> line;
+                }
+            }
+          LOGME ("found " << g_nsValues.size () << " entries");
         }
-      LOGME ("found " << nsValues.size () << " entries");
       Ptr<DeterministicRandomVariable> drv = CreateObject<DeterministicRandomVariable> ();
-      drv->SetValueArray (&nsValues[0], nsValues.size ());
+      drv->SetValueArray (&g_nsValues[0], g_nsValues.size ());
       stream = drv;
     }
 
   return stream;
 }
 
-
-
-int main (int argc, char *argv[])
+/**
+ * Run the benchmark with a scheduler
+ * \param factory the scheduler factory
+ * \param pop the event population size
+ * \param total the total number of events to run
+ * \param runs the number of runs
+ * \param filename the file of relative event times
+ */
+void
+RunScheduler (ObjectFactory factory, uint32_t pop, uint32_t total, uint32_t runs, std::string filename)
 {
-
-  bool schedCal  = false;
-  bool schedHeap = false;
-  bool schedList = false;
-  bool schedMap  = true;
-
-  uint32_t pop   =  100000;
-  uint32_t total = 1000000;
-  uint32_t runs  =       1;
-  std::string filename = "";
-
-  CommandLine cmd;
-  cmd.Usage ("Benchmark the simulator scheduler.\n"
-             "\n"
-             "Event intervals are taken from one of:\n"
-             "  an exponential distribution, with mean 100 ns,\n"
-             "  an ascii file, given by the --file=\"<filename>\" argument,\n"
-             "  or standard input, by the argument --file=\"-\"\n"
-             "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
-  cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
-  cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
-  cmd.AddValue ("list",  "use ListSheduler",              schedList);
-  cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
-  cmd.AddValue ("debug", "enable debugging output",       g_debug);
-  cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
-  cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
-  cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
-  cmd.AddValue ("file",  "file of relative event times",  filename);
-  cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
-  cmd.Parse (argc, argv);
-  g_me = cmd.GetName () + ": ";
-  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
-
-  ObjectFactory factory ("ns3::MapScheduler");
-  if (schedCal)
-    {
-      factory.SetTypeId ("ns3::CalendarScheduler");
-    }
-  if (schedHeap)
-    {
-      factory.SetTypeId ("ns3::HeapScheduler");
-    }
-  if (schedList)
-    {
-      factory.SetTypeId ("ns3::ListScheduler");
-    }
   Simulator::SetScheduler (factory);
 
-  LOGME (std::setprecision (g_fwidth - 6));
-  DEB ("debugging is ON");
-
   LOGME ("scheduler: " << factory.GetTypeId ().GetName ());
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
@@ -261,6 +225,7 @@ int main (int argc, char *argv[])
 
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
+  EventImpl::AllocationStats start = EventImpl::GetAllocationStats ();
 
   // table header
   LOG ("");
@@ -302,5 +267,97 @@ int main (int argc, char *argv[])
   LOG ("");
   Simulator::Destroy ();
   delete bench;
+
+  EventImpl::AllocationStats end = EventImpl::GetAllocationStats ();
+  LOGME ("events allocated: " << end.m_allocated - start.m_allocated <<
+         ", from the freelists: " << end.m_recycled - start.m_recycled);
+  LOG ("");
+}
+
+
+int main (int argc, char *argv[])
+{
+
+  bool schedCal  = false;
+  bool schedHeap = false;
+  bool schedList = false;
+  bool schedMap  = true;
+  bool schedWheel = false;
+  bool schedAll  = false;
+
+  uint32_t pop   =  100000;
+  uint32_t total = 1000000;
+  uint32_t runs  =       1;
+  std::string filename = "";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the simulator scheduler.\n"
+             "\n"
+             "Event intervals are taken from one of:\n"
+             "  an exponential distribution, with mean 100 ns,\n"
+             "  an ascii file, given by the --file=\"<filename>\" argument,\n"
+             "  or standard input, by the argument --file=\"-\"\n"
+             "In the case of either --file form, the input is expected\n"
+             "to be ascii, giving the relative event times in s.\n"
+             "\n"
+             "The event times of a simulation are captured with e.g.\n"
+             "  ./waf --run \"mc-twoenbs --SchedulerType=ns3::TimingWheelScheduler\n"
+             "    --ns3::TimingWheelScheduler::DelayTraceFile=mc-twoenbs.txt\"");
+  cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
+  cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("list",  "use ListSheduler",              schedList);
+  cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("wheel", "use TimingWheelScheduler",      schedWheel);
+  cmd.AddValue ("all",   "run every scheduler in turn",   schedAll);
+  cmd.AddValue ("debug", "enable debugging output",       g_debug);
+  cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
+  cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
+  cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
+  cmd.AddValue ("file",  "file of relative event times",  filename);
+  cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  std::vector<std::string> schedulers;
+  if (schedAll)
+    {
+      schedulers.push_back ("ns3::MapScheduler");
+      schedulers.push_back ("ns3::HeapScheduler");
+      schedulers.push_back ("ns3::CalendarScheduler");
+      schedulers.push_back ("ns3::TimingWheelScheduler");
+      if (schedList)
+        {
+          schedulers.push_back ("ns3::ListScheduler");
+        }
+    }
+  else if (schedCal)
+    {
+      schedulers.push_back ("ns3::CalendarScheduler");
+    }
+  else if (schedHeap)
+    {
+      schedulers.push_back ("ns3::HeapScheduler");
+    }
+  else if (schedList)
+    {
+      schedulers.push_back ("ns3::ListScheduler");
+    }
+  else if (schedWheel)
+    {
+      schedulers.push_back ("ns3::TimingWheelScheduler");
+    }
+  else
+    {
+      schedulers.push_back ("ns3::MapScheduler");
+    }
+
+  for (uint32_t i = 0; i < schedulers.size (); i++)
+    {
+      RunScheduler (ObjectFactory (schedulers[i]), pop, total, runs, filename);
+    }
   return 0;
 }
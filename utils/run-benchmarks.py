@@ -0,0 +1,309 @@
+#!/usr/bin/env python
+#
+# Runs the benchmark scenarios of the simulator and reports, for each of
+# them, the wall clock time, the executed events per second, the peak
+# resident set size and, when perf is available, the share of the samples
+# spent in each ns-3 module, as a JSON document.
+#
+# The scenarios run with fixed seeds, so that two reports of the same
+# build only differ by the host noise.  Build with the 'perf' profile,
+# which optimizes like 'optimized' but keeps the symbols and the frame
+# pointers, and with the examples:
+#
+#   ./waf configure -d perf --enable-examples
+#   ./waf build
+#   ./utils/run-benchmarks.py run -o perf-new.json
+#
+# and compare two reports, e.g. of the last release and of the new one:
+#
+#   ./utils/run-benchmarks.py compare perf-old.json perf-new.json --threshold 5
+#
+# which exits with a non zero status if a scenario got slower than the
+# threshold, in percent of events per second or of peak memory.
+
+import ast
+import json
+import optparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+# name: (program directory relative to the build directory, program,
+#        arguments)
+SCENARIOS = [
+    ('lena-profiling-small', 'src/nr/examples', 'lena-profiling',
+     ['--nEnb=1', '--nUe=1', '--nFloors=0', '--simTime=5']),
+    ('lena-profiling-medium', 'src/nr/examples', 'lena-profiling',
+     ['--nEnb=4', '--nUe=10', '--nFloors=1', '--simTime=5']),
+    ('lena-profiling-large', 'src/nr/examples', 'lena-profiling',
+     ['--nEnb=8', '--nUe=20', '--nFloors=3', '--simTime=5']),
+    ('mc-twoenbs', 'src/mmwave/examples', 'mc-twoenbs',
+     []),
+    ('mmwave-simple-epc-3gpp', 'src/mmwave/examples', 'mmwave-simple-epc',
+     ['--numEnb=1', '--numUe=2', '--simTime=1', '--rlcAm=1',
+      '--ns3::MmWaveHelper::ChannelModel=ns3::MmWave3gppChannel',
+      '--ns3::MmWaveHelper::PathlossModel=ns3::MmWave3gppPropagationLossModel']),
+    ('ngc-n3-throughput', 'src/nr/examples', 'ngc-n3-throughput',
+     ['--numUes=10000', '--numEnbs=10', '--rate=100000', '--trafficTime=1']),
+    ('virt-5gc-1to2-heavy', 'scratch', 'virt-5gc-1to2-heavy',
+     ['--numberOfNodes=2', '--simTime=1']),
+    ('ofswitch13-qos-controller', 'scratch/ofswitch13-qos-controller', 'ofswitch13-qos-controller',
+     ['--clients=4', '--simTime=10']),
+]
+
+SEED = 1
+RUN = 1
+
+
+def read_build_config(build_dir):
+    """Read the variables of the waf configuration of the build directory."""
+    config = {}
+    cache = os.path.join(build_dir, 'c4che', '_cache.py')
+    if not os.path.exists(cache):
+        sys.exit('%s not found, configure the build first' % cache)
+    for line in open(cache):
+        name, sep, value = line.partition(' = ')
+        if not sep:
+            continue
+        try:
+            config[name.strip()] = ast.literal_eval(value.strip())
+        except (ValueError, SyntaxError):
+            pass
+    return config
+
+
+def program_path(build_dir, config, directory, program):
+    """Path of a program, named as the wscripts name it."""
+    if directory.startswith('scratch'):
+        name = program
+    else:
+        name = '%s%s-%s%s' % (config['APPNAME'], config['VERSION'],
+                              program, config['BUILD_SUFFIX'])
+    return os.path.join(build_dir, directory, name)
+
+
+def module_of_dso(dso, config):
+    """Map a shared object of the perf report to an ns-3 module name."""
+    prefix = 'lib%s%s-' % (config['APPNAME'], config['VERSION'])
+    suffix = '%s.so' % config['BUILD_SUFFIX']
+    base = os.path.basename(dso)
+    if base.startswith(prefix) and base.endswith(suffix):
+        return base[len(prefix):len(base) - len(suffix)]
+    if base.startswith('[') or base.startswith('libc') or base.startswith('libstdc++') \
+            or base.startswith('libm') or base.startswith('libpthread'):
+        return 'system'
+    return 'other'
+
+
+def perf_available():
+    try:
+        subprocess.check_call(['perf', '--version'],
+                              stdout=open(os.devnull, 'w'), stderr=subprocess.STDOUT)
+        return True
+    except (OSError, subprocess.CalledProcessError):
+        return False
+
+
+def hotspots(perf_data, config):
+    """Share of the perf samples per ns-3 module, in percent."""
+    try:
+        output = subprocess.check_output(['perf', 'report', '-i', perf_data,
+                                          '--sort', 'dso', '--stdio'],
+                                         stderr=open(os.devnull, 'w'))
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    modules = {}
+    for line in output.decode('utf-8', 'replace').splitlines():
+        m = re.match(r'\s*([0-9.]+)%\s+(\S+)', line)
+        if m is None:
+            continue
+        module = module_of_dso(m.group(2), config)
+        modules[module] = round(modules.get(module, 0.0) + float(m.group(1)), 2)
+    return modules
+
+
+def run_once(build_dir, config, path, args, use_perf, timeout):
+    """Run a scenario once and return its metrics, or an error string."""
+    env = dict(os.environ)
+    env['LD_LIBRARY_PATH'] = os.path.abspath(build_dir) + \
+        (':' + env['LD_LIBRARY_PATH'] if env.get('LD_LIBRARY_PATH') else '')
+    fd, report = tempfile.mkstemp(suffix='.json', prefix='ns3-perf-')
+    os.close(fd)
+    env['NS_GLOBAL_VALUE'] = 'RngSeed=%d;RngRun=%d;PerfReportFile=%s' % (SEED, RUN, report)
+    command = [path] + args
+    perf_data = None
+    if use_perf:
+        fd, perf_data = tempfile.mkstemp(suffix='.data', prefix='ns3-perf-')
+        os.close(fd)
+        command = ['perf', 'record', '-q', '-g', '-o', perf_data, '--'] + command
+
+    log = tempfile.TemporaryFile()
+    start = time.time()
+    process = subprocess.Popen(command, env=env, stdout=log, stderr=subprocess.STDOUT)
+    status = None
+    while status is None:
+        pid, status, rusage = os.wait4(process.pid, os.WNOHANG)
+        if pid == 0:
+            status = None
+            if timeout and time.time() - start > timeout:
+                process.kill()
+            time.sleep(0.05)
+    elapsed = time.time() - start
+
+    try:
+        if status != 0:
+            log.seek(0)
+            tail = log.read().decode('utf-8', 'replace').splitlines()[-5:]
+            if os.WIFSIGNALED(status):
+                reason = 'signal %d' % os.WTERMSIG(status)
+            else:
+                reason = 'exit status %d' % os.WEXITSTATUS(status)
+            return '%s: %s' % (reason, ' | '.join(tail))
+        try:
+            metrics = json.load(open(report))
+        except (IOError, ValueError):
+            return 'no performance report, Simulator::Destroy was not called'
+        metrics['processSeconds'] = round(elapsed, 3)
+        # ru_maxrss is in KiB on Linux
+        metrics['peakRssKiB'] = rusage.ru_maxrss
+        if perf_data is not None:
+            metrics['hotspots'] = hotspots(perf_data, config)
+        return metrics
+    finally:
+        os.remove(report)
+        if perf_data is not None and os.path.exists(perf_data):
+            os.remove(perf_data)
+
+
+def run(options, names):
+    config = read_build_config(options.build_dir)
+    if config.get('BUILD_PROFILE') not in ('perf', 'optimized', 'release'):
+        sys.stderr.write('warning: benchmarking a %s build\n' % config.get('BUILD_PROFILE'))
+    use_perf = not options.no_perf and perf_available()
+    results = {
+        'build': {
+            'profile': config.get('BUILD_PROFILE'),
+            'version': config.get('VERSION'),
+            'compiler': ' '.join(config.get('CXX', [])),
+            'cxxflags': config.get('CXXFLAGS', []),
+            'host': os.uname()[1],
+        },
+        'seed': SEED,
+        'run': RUN,
+        'repeat': options.repeat,
+        'date': time.strftime('%Y-%m-%dT%H:%M:%S'),
+        'scenarios': {},
+    }
+    for name, directory, program, args in SCENARIOS:
+        if names and name not in names:
+            continue
+        path = program_path(options.build_dir, config, directory, program)
+        if not os.path.exists(path):
+            sys.stderr.write('%s: %s not built\n' % (name, path))
+            results['scenarios'][name] = {'status': 'missing', 'program': path}
+            continue
+        best = None
+        error = None
+        hot = None
+        for i in range(options.repeat):
+            sys.stderr.write('%s: run %d/%d\n' % (name, i + 1, options.repeat))
+            # only the first run is sampled, perf slows the run down
+            metrics = run_once(options.build_dir, config, path, args,
+                               use_perf and i == 0, options.timeout)
+            if not isinstance(metrics, dict):
+                error = metrics
+                break
+            hot = metrics.pop('hotspots', hot)
+            # the fastest run is the least disturbed by the host
+            if best is None or metrics['wallClockSeconds'] < best['wallClockSeconds']:
+                best = metrics
+        if error is not None:
+            sys.stderr.write('%s: failed, %s\n' % (name, error))
+            results['scenarios'][name] = {'status': 'failed', 'error': error}
+            continue
+        if hot is not None:
+            best['hotspots'] = hot
+        best['status'] = 'ok'
+        best['arguments'] = args
+        results['scenarios'][name] = best
+
+    output = json.dumps(results, indent=2, sort_keys=True)
+    if options.output:
+        open(options.output, 'w').write(output + '\n')
+    else:
+        print(output)
+    return 0
+
+
+def compare(options, old_file, new_file):
+    old = json.load(open(old_file))
+    new = json.load(open(new_file))
+    regressions = 0
+    print('%-28s %14s %14s %8s %12s %12s %8s' % ('scenario', 'old events/s', 'new events/s', 'delta',
+                                              'old RSS KiB', 'new RSS KiB', 'delta'))
+    for name in sorted(set(old['scenarios']) | set(new['scenarios'])):
+        a = old['scenarios'].get(name, {'status': 'missing'})
+        b = new['scenarios'].get(name, {'status': 'missing'})
+        if a['status'] != 'ok' or b['status'] != 'ok':
+            print('%-28s %s -> %s' % (name, a['status'], b['status']))
+            if a['status'] == 'ok':
+                regressions += 1
+            continue
+        if a['events'] != b['events']:
+            print('%-28s warning: %d events before, %d now, the scenario changed'
+                  % (name, a['events'], b['events']))
+        speed = 100.0 * (b['eventsPerSecond'] - a['eventsPerSecond']) / max(a['eventsPerSecond'], 1e-9)
+        memory = 100.0 * (b['peakRssKiB'] - a['peakRssKiB']) / max(a['peakRssKiB'], 1)
+        flag = ''
+        if speed < -options.threshold or memory > options.threshold:
+            flag = '  REGRESSION'
+            regressions += 1
+        print('%-28s %14.0f %14.0f %+7.1f%% %12d %12d %+7.1f%%%s'
+              % (name, a['eventsPerSecond'], b['eventsPerSecond'], speed,
+                 a['peakRssKiB'], b['peakRssKiB'], memory, flag))
+    if regressions:
+        print('%d regression(s) beyond %.1f%%' % (regressions, options.threshold))
+        return 1
+    return 0
+
+
+def main(argv):
+    parser = optparse.OptionParser(
+        usage='%prog run [options] [scenario...]\n'
+              '       %prog compare [options] OLD.json NEW.json\n'
+              '       %prog list')
+    parser.add_option('-b', '--build-dir', default='build',
+                      help='build directory [default: %default]')
+    parser.add_option('-o', '--output', default=None,
+                      help='file to write the JSON report to, instead of the standard output')
+    parser.add_option('-r', '--repeat', type='int', default=3,
+                      help='runs per scenario, the fastest is kept [default: %default]')
+    parser.add_option('--timeout', type='float', default=3600,
+                      help='seconds after which a run is killed [default: %default]')
+    parser.add_option('--no-perf', action='store_true', default=False,
+                      help='do not sample the module hotspots with perf')
+    parser.add_option('-t', '--threshold', type='float', default=5.0,
+                      help='regression threshold of compare, in percent [default: %default]')
+    options, args = parser.parse_args(argv[1:])
+    if not args:
+        parser.error('missing command')
+    if args[0] == 'list':
+        for name, directory, program, arguments in SCENARIOS:
+            print('%-28s %s %s' % (name, program, ' '.join(arguments)))
+        return 0
+    if args[0] == 'run':
+        if options.repeat < 1:
+            parser.error('--repeat must be at least 1')
+        return run(options, args[1:])
+    if args[0] == 'compare':
+        if len(args) != 3:
+            parser.error('compare takes two reports')
+        return compare(options, args[1], args[2])
+    parser.error('unknown command %s' % args[0])
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))